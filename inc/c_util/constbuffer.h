@@ -14,6 +14,7 @@
 #endif
 
 #include "c_util/buffer_.h"
+#include "c_util/memory_mapped_file.h"
 
 #include "umock_c/umock_c_prod.h"
 
@@ -28,6 +29,9 @@ typedef struct CONSTBUFFER_HANDLE_DATA_TAG* CONSTBUFFER_HANDLE;
 /*this is the writable handle*/
 typedef struct CONSTBUFFER_WRITABLE_HANDLE_DATA_TAG* CONSTBUFFER_WRITABLE_HANDLE;
 
+/*this is the handle of a pool that recycles the memory of writable handles*/
+typedef struct CONSTBUFFER_POOL_HANDLE_DATA_TAG* CONSTBUFFER_POOL_HANDLE;
+
 /*this is what is returned when the content of the buffer needs access*/
 typedef struct CONSTBUFFER_TAG
 {
@@ -56,6 +60,15 @@ MU_DEFINE_ENUM(CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT, CONSTBUFFER_TO_FIXED_SIZ
 
 MU_DEFINE_ENUM(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_VALUES)
 
+/*counters of a CONSTBUFFER_POOL_HANDLE. hits + misses is the number of writable handles requested from the pool*/
+typedef struct CONSTBUFFER_POOL_STATISTICS_TAG
+{
+    uint64_t hits;              /*number of writable handles that reused retained memory*/
+    uint64_t misses;            /*number of writable handles that needed a fresh allocation*/
+    uint64_t retained_buffers;  /*number of buffers currently kept by the pool for reuse*/
+    uint64_t retained_bytes;    /*number of payload bytes currently kept by the pool for reuse*/
+} CONSTBUFFER_POOL_STATISTICS;
+
 /*this creates a new constbuffer from a memory area*/
 MOCKABLE_FUNCTION(, CONSTBUFFER_HANDLE, CONSTBUFFER_Create, const unsigned char*, source, uint32_t, size);
 
@@ -66,26 +79,58 @@ MOCKABLE_FUNCTION(, CONSTBUFFER_HANDLE, CONSTBUFFER_CreateWithMoveMemory, unsign
 
 MOCKABLE_FUNCTION(, CONSTBUFFER_HANDLE, CONSTBUFFER_CreateWithCustomFree, const unsigned char*, source, uint32_t, size, CONSTBUFFER_CUSTOM_FREE_FUNC, customFreeFunc, void*, customFreeFuncContext);
 
+MOCKABLE_FUNCTION(, CONSTBUFFER_HANDLE, CONSTBUFFER_CreateFromMappedFile, const char*, file_name, uint64_t, offset, uint32_t, size, MEMORY_MAPPED_FILE_ACCESS_HINT, hint);
+
 MOCKABLE_FUNCTION(, CONSTBUFFER_HANDLE, CONSTBUFFER_CreateFromOffsetAndSize, CONSTBUFFER_HANDLE, handle, uint32_t, offset, uint32_t, size);
 
 MOCKABLE_FUNCTION(, CONSTBUFFER_HANDLE, CONSTBUFFER_CreateFromOffsetAndSizeWithCopy, CONSTBUFFER_HANDLE, handle, uint32_t, offset, uint32_t, size);
 
 MOCKABLE_FUNCTION(, void, CONSTBUFFER_IncRef, CONSTBUFFER_HANDLE, constbufferHandle);
 
+/*increments the ref count only if it has not reached 0 yet, for caches that keep a handle without holding a reference to it*/
+MOCKABLE_FUNCTION(, bool, CONSTBUFFER_TryIncRef, CONSTBUFFER_HANDLE, constbufferHandle);
+
 MOCKABLE_FUNCTION(, void, CONSTBUFFER_DecRef, CONSTBUFFER_HANDLE, constbufferHandle);
 
 MOCKABLE_FUNCTION(, const CONSTBUFFER*, CONSTBUFFER_GetContent, CONSTBUFFER_HANDLE, constbufferHandle);
 
 MOCKABLE_FUNCTION(, bool, CONSTBUFFER_HANDLE_contain_same, CONSTBUFFER_HANDLE, left, CONSTBUFFER_HANDLE, right);
 
+/*64-bit fingerprint of the content: hash_compute_hash_64 of the bytes. When CONSTBUFFER_FINGERPRINT_CACHE is defined it is computed
+on the first call and cached in the handle, afterwards CONSTBUFFER_HANDLE_contain_same tells apart two handles with known and different fingerprints without reading their bytes*/
+MOCKABLE_FUNCTION(, int, CONSTBUFFER_GetFingerprint, CONSTBUFFER_HANDLE, constbufferHandle, uint64_t*, fingerprint);
+
 MOCKABLE_FUNCTION(, uint32_t, CONSTBUFFER_get_serialization_size, CONSTBUFFER_HANDLE, source);
 
 MOCKABLE_FUNCTION(, unsigned char*, CONSTBUFFER_to_buffer, CONSTBUFFER_HANDLE, source, CONSTBUFFER_to_buffer_alloc, alloc, void*, alloc_context, uint32_t*, serialized_size);
 
 MOCKABLE_FUNCTION(, CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT, CONSTBUFFER_to_fixed_size_buffer, CONSTBUFFER_HANDLE, source, unsigned char*, destination, uint32_t, destination_size, uint32_t*, serialized_size);
 
+/*these produce version 2 of the serialization, which also carries the CRC32C of the content. CONSTBUFFER_from_buffer reads both versions*/
+MOCKABLE_FUNCTION(, uint32_t, CONSTBUFFER_get_serialization_size_v2, CONSTBUFFER_HANDLE, source);
+
+MOCKABLE_FUNCTION(, unsigned char*, CONSTBUFFER_to_buffer_v2, CONSTBUFFER_HANDLE, source, CONSTBUFFER_to_buffer_alloc, alloc, void*, alloc_context, uint32_t*, serialized_size);
+
+MOCKABLE_FUNCTION(, CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT, CONSTBUFFER_to_fixed_size_buffer_v2, CONSTBUFFER_HANDLE, source, unsigned char*, destination, uint32_t, destination_size, uint32_t*, serialized_size);
+
 MOCKABLE_FUNCTION(, CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_from_buffer, const unsigned char*, source, uint32_t, size, uint32_t*, consumed, CONSTBUFFER_HANDLE*, destination);
 
+/*these deserialize without copying: the produced handles point into source's content and keep source alive*/
+MOCKABLE_FUNCTION(, CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_from_buffer_view, CONSTBUFFER_HANDLE, source, uint32_t, offset, uint32_t*, consumed, CONSTBUFFER_HANDLE*, destination);
+
+MOCKABLE_FUNCTION(, CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_from_buffer_view_bulk, CONSTBUFFER_HANDLE, source, uint32_t, offset, uint32_t, count, uint32_t*, consumed, CONSTBUFFER_HANDLE*, destinations);
+
+/*the content of the produced const buffer is the content of source compressed with lz_codec, preceded by a header (see constbuffer_format.h). CONSTBUFFER_Decompress gives back the original content*/
+MOCKABLE_FUNCTION(, CONSTBUFFER_HANDLE, CONSTBUFFER_CreateCompressed, CONSTBUFFER_HANDLE, source);
+
+MOCKABLE_FUNCTION(, CONSTBUFFER_HANDLE, CONSTBUFFER_Decompress, CONSTBUFFER_HANDLE, compressed);
+
+#define CONSTBUFFER_SHARED_HOT_MAX_SLOT_COUNT 1024
+
+/*the produced const buffer has the content of source (no bytes are copied). Its ref count is spread over slot_count slots (one cache line each, picked by the id of the calling thread),
+for buffers that are CONSTBUFFER_IncRef/CONSTBUFFER_DecRef'd by many threads at once*/
+MOCKABLE_FUNCTION(, CONSTBUFFER_HANDLE, CONSTBUFFER_CreateSharedHot, CONSTBUFFER_HANDLE, source, uint32_t, slot_count);
+
 MOCKABLE_FUNCTION(, CONSTBUFFER_WRITABLE_HANDLE, CONSTBUFFER_CreateWritableHandle, uint32_t, size);
 
 MOCKABLE_FUNCTION(, unsigned char*, CONSTBUFFER_GetWritableBuffer, CONSTBUFFER_WRITABLE_HANDLE, constbufferWritableHandle);
@@ -98,6 +143,16 @@ MOCKABLE_FUNCTION(, void, CONSTBUFFER_WritableHandleDecRef, CONSTBUFFER_WRITABLE
 
 MOCKABLE_FUNCTION(, uint32_t, CONSTBUFFER_GetWritableBufferSize, CONSTBUFFER_WRITABLE_HANDLE, constbufferWritableHandle);
 
+MOCKABLE_FUNCTION(, CONSTBUFFER_POOL_HANDLE, CONSTBUFFER_POOL_Create, uint32_t, max_buffer_size, uint32_t, max_retained_per_class);
+
+MOCKABLE_FUNCTION(, void, CONSTBUFFER_POOL_Destroy, CONSTBUFFER_POOL_HANDLE, pool);
+
+MOCKABLE_FUNCTION(, CONSTBUFFER_WRITABLE_HANDLE, CONSTBUFFER_POOL_CreateWritableHandle, CONSTBUFFER_POOL_HANDLE, pool, uint32_t, size);
+
+MOCKABLE_FUNCTION(, int, CONSTBUFFER_POOL_GetStatistics, CONSTBUFFER_POOL_HANDLE, pool, CONSTBUFFER_POOL_STATISTICS*, statistics);
+
+MOCKABLE_FUNCTION(, void, CONSTBUFFER_POOL_Trim, CONSTBUFFER_POOL_HANDLE, pool);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,68 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef CONSTBUFFER_ACCOUNTING_H
+#define CONSTBUFFER_ACCOUNTING_H
+
+#ifdef __cplusplus
+#include <cstdint>
+#else
+#include <stdint.h>
+#include <stdbool.h>
+#endif
+
+#include "macro_utils/macro_utils.h"
+
+#include "umock_c/umock_c_prod.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*live-allocation accounting of CONSTBUFFER_HANDLEs and CONSTBUFFER_ARRAY_HANDLEs. It is compiled in only when CONSTBUFFER_ACCOUNTING is defined
+(cmake option use_constbuffer_accounting), otherwise the hooks in constbuffer.c and constbuffer_array.c expand to nothing and the snapshot is empty*/
+
+#define CONSTBUFFER_ACCOUNTING_TYPE_VALUES \
+    CONSTBUFFER_ACCOUNTING_TYPE_COPIED, \
+    CONSTBUFFER_ACCOUNTING_TYPE_MEMORY_MOVED, \
+    CONSTBUFFER_ACCOUNTING_TYPE_WITH_CUSTOM_FREE, \
+    CONSTBUFFER_ACCOUNTING_TYPE_FROM_OFFSET_AND_SIZE, \
+    CONSTBUFFER_ACCOUNTING_TYPE_POOLED, \
+    CONSTBUFFER_ACCOUNTING_TYPE_MAPPED_FILE, \
+    CONSTBUFFER_ACCOUNTING_TYPE_FROM_BUFFER_VIEW, \
+    CONSTBUFFER_ACCOUNTING_TYPE_SHARED_HOT, \
+    CONSTBUFFER_ACCOUNTING_TYPE_ARRAY
+
+MU_DEFINE_ENUM_WITHOUT_INVALID(CONSTBUFFER_ACCOUNTING_TYPE, CONSTBUFFER_ACCOUNTING_TYPE_VALUES)
+
+#define CONSTBUFFER_ACCOUNTING_TYPE_COUNT MU_COUNT_ARG(CONSTBUFFER_ACCOUNTING_TYPE_VALUES)
+
+/*bucket 0 counts the empty buffers, bucket i (1..32) counts the buffers with a size in [2^(i-1), 2^i)*/
+#define CONSTBUFFER_ACCOUNTING_HISTOGRAM_BUCKET_COUNT 33
+
+typedef struct CONSTBUFFER_ACCOUNTING_COUNTERS_TAG
+{
+    int64_t live_handles;
+    int64_t live_bytes; /*content size for CONSTBUFFER_HANDLEs, size of the handle allocation for CONSTBUFFER_ARRAY_HANDLEs*/
+} CONSTBUFFER_ACCOUNTING_COUNTERS;
+
+typedef struct CONSTBUFFER_ACCOUNTING_SNAPSHOT_TAG
+{
+    bool is_enabled; /*false when the accounting is compiled out, all the counters are then 0*/
+    CONSTBUFFER_ACCOUNTING_COUNTERS by_type[CONSTBUFFER_ACCOUNTING_TYPE_COUNT]; /*indexed by CONSTBUFFER_ACCOUNTING_TYPE*/
+    int64_t size_histogram[CONSTBUFFER_ACCOUNTING_HISTOGRAM_BUCKET_COUNT]; /*live CONSTBUFFER_HANDLEs (all types) by log2 of their content size*/
+} CONSTBUFFER_ACCOUNTING_SNAPSHOT;
+
+#ifdef CONSTBUFFER_ACCOUNTING
+/*called by constbuffer.c and constbuffer_array.c when a handle is created/freed. Not mockable, they are part of the create/free paths*/
+void constbuffer_accounting_add(CONSTBUFFER_ACCOUNTING_TYPE type, uint64_t size);
+void constbuffer_accounting_remove(CONSTBUFFER_ACCOUNTING_TYPE type, uint64_t size);
+#endif
+
+MOCKABLE_FUNCTION(, int, constbuffer_accounting_get_snapshot, CONSTBUFFER_ACCOUNTING_SNAPSHOT*, snapshot);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONSTBUFFER_ACCOUNTING_H */
@@ -10,6 +10,8 @@
 #include <stdbool.h>
 #endif
 
+#include "macro_utils/macro_utils.h"
+
 #include "c_util/constbuffer.h"
 
 #include "umock_c/umock_c_prod.h"
@@ -20,6 +22,21 @@ extern "C" {
 
 typedef struct CONSTBUFFER_ARRAY_HANDLE_DATA_TAG* CONSTBUFFER_ARRAY_HANDLE;
 
+#define CONSTBUFFER_ARRAY_FIND_RESULT_VALUES \
+    CONSTBUFFER_ARRAY_FIND_RESULT_OK, \
+    CONSTBUFFER_ARRAY_FIND_RESULT_NOT_FOUND, \
+    CONSTBUFFER_ARRAY_FIND_RESULT_INVALID_ARG
+
+MU_DEFINE_ENUM(CONSTBUFFER_ARRAY_FIND_RESULT, CONSTBUFFER_ARRAY_FIND_RESULT_VALUES)
+
+/*where a match found by constbuffer_array_find/constbuffer_array_find_byte starts*/
+typedef struct CONSTBUFFER_ARRAY_POSITION_TAG
+{
+    uint64_t offset;        /*number of bytes of the array before the match (the offset of constbuffer_array_copy_to)*/
+    uint32_t buffer_index;  /*buffer where the match starts (the start_buffer_index of constbuffer_array_create_from_buffer_offset_and_count)*/
+    uint32_t buffer_offset; /*offset of the match in that buffer (the start_buffer_offset of constbuffer_array_create_from_buffer_offset_and_count)*/
+} CONSTBUFFER_ARRAY_POSITION;
+
 /*create*/
 MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_create, const CONSTBUFFER_HANDLE*, buffers, uint32_t, buffer_count);
 MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_create_with_move_buffers, CONSTBUFFER_HANDLE*, buffers, uint32_t, buffer_count);
@@ -30,6 +47,10 @@ MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_create_from_arra
 
 MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_remove_empty_buffers, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_handle);
 
+/*compression: every buffer is compressed on its own, so a single one can be decompressed with CONSTBUFFER_Decompress(constbuffer_array_get_buffer(...))*/
+MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_create_compressed, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_handle);
+MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_create_decompressed, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_handle);
+
 MOCKABLE_FUNCTION(, void, constbuffer_array_inc_ref, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_handle);
 MOCKABLE_FUNCTION(, void, constbuffer_array_dec_ref, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_handle);
 
@@ -45,16 +66,46 @@ MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_add_back, CONSTB
 /*remove back*/
 MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_remove_back, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_handle, CONSTBUFFER_HANDLE*, constbuffer_handle);
 
+/*add/remove at both ends without copying the whole array: the result shares a storage with constbuffer_array_handle (or references its buffers) when possible.
+add is amortized O(1) when the previous arrays are released (an add next to a slot freed by a remove copies while the array the handle was removed from is alive),
+remove is O(1). Meant for arrays that are used as queues*/
+MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_add_front_shared, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_handle, CONSTBUFFER_HANDLE, constbuffer_handle);
+MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_remove_front_shared, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_handle, CONSTBUFFER_HANDLE*, constbuffer_handle);
+MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_add_back_shared, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_handle, CONSTBUFFER_HANDLE, constbuffer_handle);
+MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_remove_back_shared, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_handle, CONSTBUFFER_HANDLE*, constbuffer_handle);
+
 /* getters */
 MOCKABLE_FUNCTION(, int, constbuffer_array_get_buffer_count, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_handle, uint32_t*, buffer_count);
 MOCKABLE_FUNCTION(, CONSTBUFFER_HANDLE, constbuffer_array_get_buffer, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_handle, uint32_t, buffer_index);
 MOCKABLE_FUNCTION(, const CONSTBUFFER*, constbuffer_array_get_buffer_content, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_handle, uint32_t, buffer_index);
 MOCKABLE_FUNCTION(, int, constbuffer_array_get_all_buffers_size, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_handle, uint32_t*, all_buffers_size);
+MOCKABLE_FUNCTION(, int, constbuffer_array_get_all_buffers_size_64, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_handle, uint64_t*, all_buffers_size);
 MOCKABLE_FUNCTION(, const CONSTBUFFER_HANDLE*, constbuffer_array_get_const_buffer_handle_array, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_handle);
 
+/*copy out: the buffers are seen as one contiguous buffer. constbuffer_array_flatten returns the only buffer (no copy) when the array has exactly one*/
+MOCKABLE_FUNCTION(, int, constbuffer_array_copy_to, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_handle, uint64_t, offset, uint64_t, length, unsigned char*, destination);
+MOCKABLE_FUNCTION(, CONSTBUFFER_HANDLE, constbuffer_array_flatten, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_handle);
+
 /*compare*/
 MOCKABLE_FUNCTION(, bool, CONSTBUFFER_ARRAY_HANDLE_contain_same, CONSTBUFFER_ARRAY_HANDLE, left, CONSTBUFFER_ARRAY_HANDLE, right);
 
+/*compares the bytes regardless of how they are split in buffers (CONSTBUFFER_ARRAY_HANDLE_contain_same compares buffer by buffer). Arrays that are compared
+often can call constbuffer_array_get_fingerprint once, after that the comparison of two arrays with different fingerprints does not read their bytes*/
+MOCKABLE_FUNCTION(, bool, constbuffer_array_content_equal, CONSTBUFFER_ARRAY_HANDLE, left, CONSTBUFFER_ARRAY_HANDLE, right);
+
+/*64-bit fingerprint of the bytes of all buffers: constbuffer_array_compute_hash with seed 0 (hash_compute_hash_64 of the flattened bytes). The same for any split of
+the same bytes and the same as CONSTBUFFER_GetFingerprint of a buffer with these bytes. Computed on the first call and cached in the array*/
+MOCKABLE_FUNCTION(, int, constbuffer_array_get_fingerprint, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_handle, uint64_t*, fingerprint);
+
+/*64-bit hash (hash_compute_hash_seeded) of the bytes of all buffers, computed with hash_init/hash_update/hash_final without flattening the array. The same for
+any split of the same bytes. Not cached: the seed is chosen by the caller*/
+MOCKABLE_FUNCTION(, int, constbuffer_array_compute_hash, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_handle, uint64_t, seed, uint64_t*, hash);
+
+/*search: the buffers are seen as one contiguous buffer, so a match can start in one buffer and end in another. The first match that starts at or after
+start_offset is returned, a scanner that wants the next one calls again with start_offset = position.offset + 1*/
+MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_FIND_RESULT, constbuffer_array_find, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_handle, const unsigned char*, pattern, uint32_t, pattern_length, uint64_t, start_offset, CONSTBUFFER_ARRAY_POSITION*, position);
+MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_FIND_RESULT, constbuffer_array_find_byte, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_handle, unsigned char, value, uint64_t, start_offset, CONSTBUFFER_ARRAY_POSITION*, position);
+
 #ifdef __cplusplus
 }
 #endif
@@ -6,9 +6,12 @@
 #ifdef __cplusplus
 #include <cstdint>
 #else
+#include <stdbool.h>
 #include <stdint.h>
 #endif
 
+#include "macro_utils/macro_utils.h"
+
 #include "c_util/constbuffer_array.h"
 #include "umock_c/umock_c_prod.h"
 
@@ -19,6 +22,51 @@ extern "C" {
 MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_batcher_nv_batch, CONSTBUFFER_ARRAY_HANDLE*, payloads, uint32_t, count);
 MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE*, constbuffer_array_batcher_nv_unbatch, CONSTBUFFER_ARRAY_HANDLE, batch, uint32_t*, payload_count);
 
+/*builds a batch (same layout as constbuffer_array_batcher_nv_batch) one payload at a time, as payloads arrive. The header and the size of the batch are
+kept up to date on every append, the buffers of the payloads are referenced once and moved as they are in the batch when it is sealed. A builder is used by
+one thread at a time*/
+typedef struct CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_TAG* CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_HANDLE;
+
+#define CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_RESULT_VALUES \
+    CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_OK, \
+    CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_FULL, \
+    CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_INVALID_ARGS, \
+    CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_ERROR
+
+MU_DEFINE_ENUM(CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_RESULT, CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_RESULT_VALUES)
+
+/*max_batch_size counts the bytes of the header and of all the payloads. Pass UINT32_MAX/UINT64_MAX for no limit*/
+MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_HANDLE, constbuffer_array_batcher_nv_builder_create, uint32_t, max_payload_count, uint64_t, max_batch_size);
+MOCKABLE_FUNCTION(, void, constbuffer_array_batcher_nv_builder_destroy, CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_HANDLE, builder);
+
+/*returns CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_FULL (and leaves the builder unchanged) when payload would take the batch over its limits. An empty
+builder accepts any payload, so that a payload bigger than max_batch_size ends up alone in its batch*/
+MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_RESULT, constbuffer_array_batcher_nv_builder_append, CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_HANDLE, builder, CONSTBUFFER_ARRAY_HANDLE, payload);
+MOCKABLE_FUNCTION(, int, constbuffer_array_batcher_nv_builder_can_append, CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_HANDLE, builder, CONSTBUFFER_ARRAY_HANDLE, payload, bool*, fits);
+
+/*batch_size is the size the batch would have if sealed now (header included)*/
+MOCKABLE_FUNCTION(, int, constbuffer_array_batcher_nv_builder_get_size, CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_HANDLE, builder, uint32_t*, payload_count, uint64_t*, batch_size);
+
+/*on success the builder is consumed (it must not be used or destroyed afterwards), on failure it is left as is*/
+MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_batcher_nv_builder_seal, CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_HANDLE, builder);
+
+/*random access to the payloads of a batch: the header is parsed (and checked) once when the view is created, after that a payload is found in O(1) and
+its buffers can be read without creating anything. A view holds a reference on the batch and can be used by several threads at the same time*/
+typedef struct CONSTBUFFER_ARRAY_BATCHER_NV_VIEW_TAG* CONSTBUFFER_ARRAY_BATCHER_NV_VIEW_HANDLE;
+
+MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_BATCHER_NV_VIEW_HANDLE, constbuffer_array_batcher_nv_view_create, CONSTBUFFER_ARRAY_HANDLE, batch);
+MOCKABLE_FUNCTION(, void, constbuffer_array_batcher_nv_view_destroy, CONSTBUFFER_ARRAY_BATCHER_NV_VIEW_HANDLE, view);
+
+MOCKABLE_FUNCTION(, int, constbuffer_array_batcher_nv_view_get_payload_count, CONSTBUFFER_ARRAY_BATCHER_NV_VIEW_HANDLE, view, uint32_t*, payload_count);
+MOCKABLE_FUNCTION(, int, constbuffer_array_batcher_nv_view_get_payload_buffer_count, CONSTBUFFER_ARRAY_BATCHER_NV_VIEW_HANDLE, view, uint32_t, payload_index, uint32_t*, buffer_count);
+MOCKABLE_FUNCTION(, const CONSTBUFFER*, constbuffer_array_batcher_nv_view_get_payload_buffer_content, CONSTBUFFER_ARRAY_BATCHER_NV_VIEW_HANDLE, view, uint32_t, payload_index, uint32_t, buffer_index);
+
+/*the payload shares the buffers of the batch (no handles are copied)*/
+MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_batcher_nv_view_get_payload, CONSTBUFFER_ARRAY_BATCHER_NV_VIEW_HANDLE, view, uint32_t, payload_index);
+
+/*same result as constbuffer_array_batcher_nv_unbatch*/
+MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE*, constbuffer_array_batcher_nv_view_get_all_payloads, CONSTBUFFER_ARRAY_BATCHER_NV_VIEW_HANDLE, view, uint32_t*, payload_count);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,72 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_H
+#define CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_H
+
+#ifdef __cplusplus
+#include <cstdbool>
+#include <cstdint>
+#else
+#include <stdbool.h>
+#include <stdint.h>
+#endif
+
+#include "macro_utils/macro_utils.h"
+
+#include "c_pal/thandle.h"
+#include "c_pal/threadpool.h"
+
+#include "c_util/async_op.h"
+#include "c_util/constbuffer_array.h"
+
+#include "umock_c/umock_c_prod.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT_VALUES \
+    CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT_OK, \
+    CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT_INVALID_ARGS, \
+    CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT_ERROR
+
+MU_DEFINE_ENUM(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT, CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT_VALUES);
+
+#define CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_CALLBACK_RESULT_VALUES \
+    CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_CALLBACK_RESULT_OK, \
+    CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_CALLBACK_RESULT_ERROR, \
+    CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_CALLBACK_RESULT_CANCELLED, \
+    CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_CALLBACK_RESULT_ABANDONED
+
+MU_DEFINE_ENUM(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_CALLBACK_RESULT, CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_CALLBACK_RESULT_VALUES);
+
+/*called once for every submitted payload, when the batch that contains it has been sent (or when the payload did not make it in a batch)*/
+typedef void(*ON_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_PAYLOAD_COMPLETE)(void* context, CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_CALLBACK_RESULT result);
+
+/*the user calls this (exactly once, from any thread) when a batch handed to CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_SEND_BATCH has been delivered*/
+typedef void(*ON_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_BATCH_SENT)(void* context, bool succeeded);
+
+/*sends a batch (with the layout of constbuffer_array_batcher_nv_batch). The batch has to be referenced if it is needed after the function returns.
+A non-zero return means the batch was not taken and on_batch_sent is not going to be called*/
+typedef int(*CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_SEND_BATCH)(void* context, CONSTBUFFER_ARRAY_HANDLE batch, ON_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_BATCH_SENT on_batch_sent, void* on_batch_sent_context);
+
+typedef struct CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_TAG CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC;
+
+THANDLE_TYPE_DECLARE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC);
+
+/*payloads submitted from any number of threads are gathered and sent in batches of at most max_payload_count payloads and max_batch_size bytes (header included).
+No payload waits more than max_delay_ms for its batch to be sent. close has to be called before the last reference is released*/
+MOCKABLE_FUNCTION(, THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC), constbuffer_array_batcher_nv_async_create, THANDLE(THREADPOOL), threadpool, uint32_t, max_payload_count, uint64_t, max_batch_size, uint32_t, max_delay_ms, CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_SEND_BATCH, send_batch, void*, send_batch_context);
+MOCKABLE_FUNCTION(, int, constbuffer_array_batcher_nv_async_open, THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC), batcher);
+MOCKABLE_FUNCTION(, void, constbuffer_array_batcher_nv_async_close, THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC), batcher);
+
+MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT, constbuffer_array_batcher_nv_async_submit, THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC), batcher, CONSTBUFFER_ARRAY_HANDLE, payload, ON_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_PAYLOAD_COMPLETE, on_payload_complete, void*, context, THANDLE(ASYNC_OP)*, out_op);
+
+/*sends the payloads gathered so far without waiting for any of the limits*/
+MOCKABLE_FUNCTION(, int, constbuffer_array_batcher_nv_async_flush, THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC), batcher);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_H */
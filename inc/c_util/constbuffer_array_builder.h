@@ -0,0 +1,44 @@
+// Copyright (C) Microsoft Corporation. All rights reserved.
+
+#ifndef CONSTBUFFER_ARRAY_BUILDER_H
+#define CONSTBUFFER_ARRAY_BUILDER_H
+
+#ifdef __cplusplus
+#include <cstdint>
+#else
+#include <stdint.h>
+#endif
+
+#include "c_util/constbuffer.h"
+#include "c_util/constbuffer_array.h"
+#include "umock_c/umock_c_prod.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*accumulates CONSTBUFFER_HANDLEs in a growable array (appends are amortized O(1)) and then moves that array in a CONSTBUFFER_ARRAY_HANDLE, instead
+of producing a new CONSTBUFFER_ARRAY_HANDLE (and copying all the handles) for every constbuffer_array_add_back. A builder is used by one thread at a time*/
+typedef struct CONSTBUFFER_ARRAY_BUILDER_TAG* CONSTBUFFER_ARRAY_BUILDER_HANDLE;
+
+/*capacity used when constbuffer_array_builder_create is called with initial_capacity 0*/
+#define CONSTBUFFER_ARRAY_BUILDER_DEFAULT_CAPACITY 16
+
+MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_BUILDER_HANDLE, constbuffer_array_builder_create, uint32_t, initial_capacity);
+MOCKABLE_FUNCTION(, void, constbuffer_array_builder_destroy, CONSTBUFFER_ARRAY_BUILDER_HANDLE, builder);
+
+/*takes a new reference on buffer*/
+MOCKABLE_FUNCTION(, int, constbuffer_array_builder_append, CONSTBUFFER_ARRAY_BUILDER_HANDLE, builder, CONSTBUFFER_HANDLE, buffer);
+/*takes over the caller's reference on buffer (on success only)*/
+MOCKABLE_FUNCTION(, int, constbuffer_array_builder_append_move, CONSTBUFFER_ARRAY_BUILDER_HANDLE, builder, CONSTBUFFER_HANDLE, buffer);
+
+MOCKABLE_FUNCTION(, int, constbuffer_array_builder_get_buffer_count, CONSTBUFFER_ARRAY_BUILDER_HANDLE, builder, uint32_t*, buffer_count);
+
+/*on success the builder is consumed (it must not be used or destroyed afterwards), on failure it is left as is*/
+MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_builder_seal, CONSTBUFFER_ARRAY_BUILDER_HANDLE, builder);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONSTBUFFER_ARRAY_BUILDER_H */
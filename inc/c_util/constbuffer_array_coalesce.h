@@ -0,0 +1,30 @@
+// Copyright (C) Microsoft Corporation. All rights reserved.
+
+#ifndef CONSTBUFFER_ARRAY_COALESCE_H
+#define CONSTBUFFER_ARRAY_COALESCE_H
+
+#ifdef __cplusplus
+#include <cstdint>
+#else
+#include <stdint.h>
+#endif
+
+#include "macro_utils/macro_utils.h"
+
+#include "c_util/constbuffer_array.h"
+
+#include "umock_c/umock_c_prod.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*the inverse of constbuffer_array_splitter_split: runs of adjacent buffers smaller than min_segment_size are copied into buffers of at most
+max_segment_size bytes, every other buffer is kept as-is (zero-copy). Empty buffers are dropped. When there is nothing to merge the
+original array is returned with its reference count incremented*/
+MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_coalesce, CONSTBUFFER_ARRAY_HANDLE, buffers, uint32_t, min_segment_size, uint32_t, max_segment_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CONSTBUFFER_ARRAY_COALESCE_H
@@ -0,0 +1,49 @@
+// Copyright (C) Microsoft Corporation. All rights reserved.
+
+#ifndef CONSTBUFFER_ARRAY_READER_H
+#define CONSTBUFFER_ARRAY_READER_H
+
+#ifdef __cplusplus
+#include <cstdint>
+#else
+#include <stdint.h>
+#endif
+
+#include "c_util/constbuffer_array.h"
+#include "c_util/uuid_string.h"
+#include "umock_c/umock_c_prod.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*a cursor over the bytes of a CONSTBUFFER_ARRAY_HANDLE (all the buffers, one after the other). Values are read with the same encoding as memory_data
+(MSB first) and can straddle buffers, so records do not need to be flattened before being parsed. A reader is used by one thread at a time*/
+typedef struct CONSTBUFFER_ARRAY_READER_TAG* CONSTBUFFER_ARRAY_READER_HANDLE;
+
+/*takes a reference on array, the reader starts at the first byte of array*/
+MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_READER_HANDLE, constbuffer_array_reader_create, CONSTBUFFER_ARRAY_HANDLE, array);
+MOCKABLE_FUNCTION(, void, constbuffer_array_reader_destroy, CONSTBUFFER_ARRAY_READER_HANDLE, reader);
+
+MOCKABLE_FUNCTION(, int, constbuffer_array_reader_get_remaining, CONSTBUFFER_ARRAY_READER_HANDLE, reader, uint64_t*, remaining);
+
+/*all the reads fail and leave the reader unchanged when fewer bytes than needed remain*/
+MOCKABLE_FUNCTION(, int, constbuffer_array_reader_read_uint8, CONSTBUFFER_ARRAY_READER_HANDLE, reader, uint8_t*, value);
+MOCKABLE_FUNCTION(, int, constbuffer_array_reader_read_uint16, CONSTBUFFER_ARRAY_READER_HANDLE, reader, uint16_t*, value);
+MOCKABLE_FUNCTION(, int, constbuffer_array_reader_read_uint32, CONSTBUFFER_ARRAY_READER_HANDLE, reader, uint32_t*, value);
+MOCKABLE_FUNCTION(, int, constbuffer_array_reader_read_uint64, CONSTBUFFER_ARRAY_READER_HANDLE, reader, uint64_t*, value);
+MOCKABLE_FUNCTION(, int, constbuffer_array_reader_read_uuid, CONSTBUFFER_ARRAY_READER_HANDLE, reader, UUID_T*, value);
+
+MOCKABLE_FUNCTION(, int, constbuffer_array_reader_skip, CONSTBUFFER_ARRAY_READER_HANDLE, reader, uint64_t, size);
+
+/*copies the next size bytes in destination without moving the reader*/
+MOCKABLE_FUNCTION(, int, constbuffer_array_reader_peek, CONSTBUFFER_ARRAY_READER_HANDLE, reader, uint32_t, size, unsigned char*, destination);
+
+/*returns the next size bytes as a CONSTBUFFER_ARRAY_HANDLE that shares the buffers of the array (no bytes are copied) and moves the reader past them*/
+MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_reader_read_array, CONSTBUFFER_ARRAY_READER_HANDLE, reader, uint64_t, size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONSTBUFFER_ARRAY_READER_H */
@@ -11,6 +11,8 @@
 
 #include "macro_utils/macro_utils.h"
 
+#include "c_util/constbuffer.h"
+#include "c_util/constbuffer_array.h"
 #include "c_util/constbuffer_array_tarray.h"
 
 #include "umock_c/umock_c_prod.h"
@@ -18,8 +20,78 @@
 extern "C" {
 #endif
 
+/*a chunk of at most max_buffer_size bytes of the split array, described without allocating anything. The fields are the arguments
+constbuffer_array_create_from_buffer_offset_and_count takes to produce the chunk as a CONSTBUFFER_ARRAY_HANDLE*/
+typedef struct CONSTBUFFER_ARRAY_SPLITTER_CHUNK_TAG
+{
+    uint32_t start_buffer_index; /*index of the first buffer of the chunk in the split array*/
+    uint32_t buffer_count; /*number of buffers of the split array the chunk spans*/
+    uint32_t start_buffer_offset; /*offset of the chunk in its first buffer*/
+    uint32_t end_buffer_size; /*number of bytes of the chunk in its last buffer (counted from start_buffer_offset when buffer_count is 1)*/
+    uint32_t size; /*number of bytes in the chunk*/
+} CONSTBUFFER_ARRAY_SPLITTER_CHUNK;
+
+/*the bytes a chunk has in one of the buffers of the split array*/
+typedef struct CONSTBUFFER_ARRAY_SPLITTER_SPAN_TAG
+{
+    const CONSTBUFFER* buffer; /*content of the buffer of the split array*/
+    uint32_t offset;
+    uint32_t size;
+} CONSTBUFFER_ARRAY_SPLITTER_SPAN;
+
+/*walks the chunks of an array one at a time. It is owned by the caller (usually on the stack), does not allocate and does not take a
+reference on the array, which has to outlive it*/
+typedef struct CONSTBUFFER_ARRAY_SPLITTER_ITERATOR_TAG
+{
+    CONSTBUFFER_ARRAY_HANDLE buffers;
+    uint32_t max_buffer_size;
+    uint32_t buffer_index;
+    uint32_t buffer_offset;
+    const CONSTBUFFER* buffer; /*content of the buffer_index-th buffer, when remaining_size is not 0*/
+    uint64_t remaining_size;
+} CONSTBUFFER_ARRAY_SPLITTER_ITERATOR;
+
+#define CONSTBUFFER_ARRAY_SPLITTER_NEXT_RESULT_VALUES \
+    CONSTBUFFER_ARRAY_SPLITTER_NEXT_OK, \
+    CONSTBUFFER_ARRAY_SPLITTER_NEXT_END, \
+    CONSTBUFFER_ARRAY_SPLITTER_NEXT_INVALID_ARG
+
+MU_DEFINE_ENUM(CONSTBUFFER_ARRAY_SPLITTER_NEXT_RESULT, CONSTBUFFER_ARRAY_SPLITTER_NEXT_RESULT_VALUES)
+
+/*walks the content-defined chunks of an array (FastCDC): the cut points are picked by a rolling gear hash over the bytes, so inserting or removing
+bytes only changes the chunks around the edit. Same ownership rules as CONSTBUFFER_ARRAY_SPLITTER_ITERATOR*/
+typedef struct CONSTBUFFER_ARRAY_SPLITTER_CDC_ITERATOR_TAG
+{
+    CONSTBUFFER_ARRAY_HANDLE buffers;
+    uint32_t min_chunk_size;
+    uint32_t avg_chunk_size;
+    uint32_t max_chunk_size;
+    uint64_t mask_small; /*cut point mask used before avg_chunk_size bytes (harder to match)*/
+    uint64_t mask_large; /*cut point mask used after avg_chunk_size bytes (easier to match)*/
+    uint32_t buffer_index;
+    uint32_t buffer_offset;
+    const CONSTBUFFER* buffer; /*content of the buffer_index-th buffer, when remaining_size is not 0*/
+    uint64_t remaining_size;
+} CONSTBUFFER_ARRAY_SPLITTER_CDC_ITERATOR;
+
 MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_splitter_split, CONSTBUFFER_ARRAY_HANDLE, buffers, uint32_t, max_buffer_size);
 MOCKABLE_FUNCTION(, TARRAY(CONSTBUFFER_ARRAY_HANDLE), constbuffer_array_splitter_split_to_array_of_array, CONSTBUFFER_ARRAY_HANDLE, buffers, uint32_t, max_buffer_size, uint32_t*, split_buffer_arrays_count);
+
+MOCKABLE_FUNCTION(, int, constbuffer_array_splitter_iterator_init, CONSTBUFFER_ARRAY_SPLITTER_ITERATOR*, iterator, CONSTBUFFER_ARRAY_HANDLE, buffers, uint32_t, max_buffer_size);
+MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_SPLITTER_NEXT_RESULT, constbuffer_array_splitter_iterator_next, CONSTBUFFER_ARRAY_SPLITTER_ITERATOR*, iterator, CONSTBUFFER_ARRAY_SPLITTER_CHUNK*, chunk);
+MOCKABLE_FUNCTION(, int, constbuffer_array_splitter_chunk_get_span, CONSTBUFFER_ARRAY_HANDLE, buffers, const CONSTBUFFER_ARRAY_SPLITTER_CHUNK*, chunk, uint32_t, span_index, CONSTBUFFER_ARRAY_SPLITTER_SPAN*, span);
+
+/*all the chunks in one allocation (released with free), chunk_count receives their number*/
+MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_SPLITTER_CHUNK*, constbuffer_array_splitter_split_to_chunks, CONSTBUFFER_ARRAY_HANDLE, buffers, uint32_t, max_buffer_size, uint32_t*, chunk_count);
+
+/*content-defined chunking: chunks have at least min_chunk_size bytes (except the last one), at most max_chunk_size bytes and about avg_chunk_size bytes on average.
+fingerprint receives the CRC-32C of the bytes of the chunk*/
+MOCKABLE_FUNCTION(, int, constbuffer_array_splitter_cdc_iterator_init, CONSTBUFFER_ARRAY_SPLITTER_CDC_ITERATOR*, iterator, CONSTBUFFER_ARRAY_HANDLE, buffers, uint32_t, min_chunk_size, uint32_t, avg_chunk_size, uint32_t, max_chunk_size);
+MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_SPLITTER_NEXT_RESULT, constbuffer_array_splitter_cdc_iterator_next, CONSTBUFFER_ARRAY_SPLITTER_CDC_ITERATOR*, iterator, CONSTBUFFER_ARRAY_SPLITTER_CHUNK*, chunk, uint32_t*, fingerprint);
+
+/*one buffer per content-defined chunk: a chunk that lies in a single buffer of buffers refers to it (no copy), a chunk that spans buffers is copied.
+fingerprints receives the CRC-32C of every chunk in one allocation (released with free)*/
+MOCKABLE_FUNCTION(, CONSTBUFFER_ARRAY_HANDLE, constbuffer_array_splitter_split_content_defined, CONSTBUFFER_ARRAY_HANDLE, buffers, uint32_t, min_chunk_size, uint32_t, avg_chunk_size, uint32_t, max_chunk_size, uint32_t**, fingerprints);
 #ifdef __cplusplus
 }
 #endif
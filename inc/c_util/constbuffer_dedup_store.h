@@ -0,0 +1,48 @@
+// Copyright (C) Microsoft Corporation. All rights reserved.
+
+#ifndef CONSTBUFFER_DEDUP_STORE_H
+#define CONSTBUFFER_DEDUP_STORE_H
+
+#ifdef __cplusplus
+#include <cstdint>
+#else
+#include <stdint.h>
+#endif
+
+#include "c_util/constbuffer.h"
+#include "umock_c/umock_c_prod.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*a thread-safe store of const buffers keyed by their content: interning a buffer returns the handle that the store already has for the same bytes
+(if any), so that caches that get the same payload many times keep it in memory only once. The store does not keep the interned handles alive,
+an entry goes away when the last reference to its interned handle is released*/
+typedef struct CONSTBUFFER_DEDUP_STORE_TAG* CONSTBUFFER_DEDUP_STORE_HANDLE;
+
+typedef struct CONSTBUFFER_DEDUP_STORE_STATISTICS_TAG
+{
+    uint64_t intern_count;  /*number of buffers interned*/
+    uint64_t hit_count;     /*number of buffers interned that had the content of a buffer already in the store*/
+    uint64_t saved_bytes;   /*number of content bytes of the buffers interned that had the content of a buffer already in the store*/
+    uint64_t entry_count;   /*number of different contents currently in the store*/
+    uint64_t stored_bytes;  /*number of content bytes currently in the store*/
+} CONSTBUFFER_DEDUP_STORE_STATISTICS;
+
+MOCKABLE_FUNCTION(, CONSTBUFFER_DEDUP_STORE_HANDLE, constbuffer_dedup_store_create);
+
+/*the interned handles that are still alive keep working after the store is destroyed*/
+MOCKABLE_FUNCTION(, void, constbuffer_dedup_store_destroy, CONSTBUFFER_DEDUP_STORE_HANDLE, store);
+
+/*returns a new reference to the handle of the store that has the content of buffer (the caller keeps its reference to buffer and
+CONSTBUFFER_DecRef's the returned handle when done)*/
+MOCKABLE_FUNCTION(, CONSTBUFFER_HANDLE, constbuffer_dedup_store_intern, CONSTBUFFER_DEDUP_STORE_HANDLE, store, CONSTBUFFER_HANDLE, buffer);
+
+MOCKABLE_FUNCTION(, int, constbuffer_dedup_store_get_statistics, CONSTBUFFER_DEDUP_STORE_HANDLE, store, CONSTBUFFER_DEDUP_STORE_STATISTICS*, statistics);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CONSTBUFFER_DEDUP_STORE_H
@@ -18,4 +18,29 @@
 
 #define CONSTBUFFER_MIN_SERIALIZATION_SIZE CONSTBUFFER_CONTENT_OFFSET
 
+/*version 2 has the same version and size fields followed by the CRC32C of the content and then the content*/
+#define CONSTBUFFER_CRC32C_OFFSET (CONSTBUFFER_SIZE_OFFSET + CONSTBUFFER_SIZE_SIZE)
+/*Codes_SRS_CONSTBUFFER_12_055: [ CONSTBUFFER_CRC32C_SIZE shall be sizeof(uint32_t) (4 bytes). ]*/
+#define CONSTBUFFER_CRC32C_SIZE (sizeof(uint32_t))
+
+#define CONSTBUFFER_V2_CONTENT_OFFSET (CONSTBUFFER_CRC32C_OFFSET + CONSTBUFFER_CRC32C_SIZE)
+
+#define CONSTBUFFER_V2_MIN_SERIALIZATION_SIZE CONSTBUFFER_V2_CONTENT_OFFSET
+
+/*the content of a const buffer produced by CONSTBUFFER_CreateCompressed is the compression method, the size of the uncompressed content and then the payload*/
+#define CONSTBUFFER_COMPRESSION_METHOD_OFFSET 0
+#define CONSTBUFFER_COMPRESSION_METHOD_SIZE (sizeof(uint8_t))
+
+#define CONSTBUFFER_UNCOMPRESSED_SIZE_OFFSET (CONSTBUFFER_COMPRESSION_METHOD_OFFSET + CONSTBUFFER_COMPRESSION_METHOD_SIZE)
+#define CONSTBUFFER_UNCOMPRESSED_SIZE_SIZE (sizeof(uint32_t))
+
+#define CONSTBUFFER_COMPRESSED_PAYLOAD_OFFSET (CONSTBUFFER_UNCOMPRESSED_SIZE_OFFSET + CONSTBUFFER_UNCOMPRESSED_SIZE_SIZE)
+
+#define CONSTBUFFER_COMPRESSION_HEADER_SIZE CONSTBUFFER_COMPRESSED_PAYLOAD_OFFSET
+
+/*the payload is the uncompressed content (used when compressing would not make it smaller)*/
+#define CONSTBUFFER_COMPRESSION_METHOD_STORED 0
+/*the payload is the content compressed by lz_codec*/
+#define CONSTBUFFER_COMPRESSION_METHOD_LZ 1
+
 #endif  /* CONSTBUFFER_FORMAT_H */
@@ -4,7 +4,9 @@
 #ifndef CONSTBUFFER_VERSION_H
 #define CONSTBUFFER_VERSION_H
 
-/*this header only exists to provide the current serialization format of CONSTBUFFER*/
+/*this header only exists to provide the serialization formats of CONSTBUFFER*/
 #define CONSTBUFFER_VERSION_V1 1
+/*same as V1 plus the CRC32C of the content*/
+#define CONSTBUFFER_VERSION_V2 2
 
 #endif  /* CONSTBUFFER_VERSION_H */
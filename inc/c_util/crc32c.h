@@ -0,0 +1,32 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef CRC32C_H
+#define CRC32C_H
+
+#ifdef __cplusplus
+#include <cstdint>
+#include <cstddef>
+#else
+#include <stdint.h>
+#include <stddef.h>
+#endif
+
+#include "umock_c/umock_c_prod.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*CRC-32C (Castagnoli) as used by iSCSI/SCTP/ext4. crc is the value returned by a previous call over the preceding bytes, 0 for the first call.
+The CRC instructions of the CPU (SSE4.2 on x64, CRC32 extension on ARM64) are used when available, otherwise slicing-by-8 tables.*/
+MOCKABLE_FUNCTION(, uint32_t, crc32c_compute, uint32_t, crc, const void*, buffer, size_t, size);
+
+/*copies size bytes from source to destination and returns the CRC-32C of the copied bytes, reading each byte only once*/
+MOCKABLE_FUNCTION(, uint32_t, crc32c_copy, uint32_t, crc, void*, destination, const void*, source, size_t, size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CRC32C_H */
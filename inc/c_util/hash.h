@@ -17,8 +17,41 @@
 extern "C" {
 #endif
 
+/*32-bit MurmurHash2 with seed 0, for lengths from 1 to INT_MAX - 1*/
 MOCKABLE_FUNCTION(, int, hash_compute_hash, const void*, buffer, size_t, length, uint32_t*, hash);
 
+/*hashes[i] is the value hash_compute_hash computes for keys[i]/lengths[i]. The arguments are checked once for the batch and the keys are hashed several at a time*/
+MOCKABLE_FUNCTION(, int, hash_compute_hash_batch, const void* const*, keys, const size_t*, lengths, size_t, count, uint32_t*, hashes);
+
+/*64-bit hash of any length (0 included). Its values do not depend on the CPU (the vector instructions are picked at runtime) and can be persisted*/
+MOCKABLE_FUNCTION(, int, hash_compute_hash_64, const void*, buffer, size_t, length, uint64_t*, hash);
+MOCKABLE_FUNCTION(, int, hash_compute_hash_seeded, const void*, buffer, size_t, length, uint64_t, seed, uint64_t*, hash);
+
+#define HASH_STATE_ACCUMULATOR_COUNT 8
+#define HASH_STATE_SECRET_COUNT 24
+#define HASH_STATE_STRIPE_SIZE 64
+#define HASH_STATE_BUFFER_SIZE 256
+
+/*state of a 64-bit hash computed over input that arrives in pieces. The fields are private to hash_init/hash_update/hash_final, the struct is
+public so that it can live on the stack*/
+typedef struct HASH_STATE_TAG
+{
+    uint64_t accumulators[HASH_STATE_ACCUMULATOR_COUNT];
+    uint64_t secret[HASH_STATE_SECRET_COUNT];
+    uint64_t seed;
+    uint64_t total_length;
+    uint64_t stripe_count;                                  /*stripes accumulated so far*/
+    size_t buffered_size;
+    unsigned char buffer[HASH_STATE_BUFFER_SIZE];           /*input not accumulated yet*/
+    unsigned char last_stripe[HASH_STATE_STRIPE_SIZE];      /*the last bytes accumulated, the final stripe can overlap them*/
+} HASH_STATE;
+
+/*hash_final returns the value that hash_compute_hash_seeded returns for all the bytes passed to hash_update (in order), however they were split.
+hash_final does not change the state, more bytes can be added after it*/
+MOCKABLE_FUNCTION(, int, hash_init, HASH_STATE*, state, uint64_t, seed);
+MOCKABLE_FUNCTION(, int, hash_update, HASH_STATE*, state, const void*, buffer, size_t, length);
+MOCKABLE_FUNCTION(, int, hash_final, const HASH_STATE*, state, uint64_t*, hash);
+
 #ifdef __cplusplus
 }
 #endif
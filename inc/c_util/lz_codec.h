@@ -0,0 +1,37 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef LZ_CODEC_H
+#define LZ_CODEC_H
+
+#ifdef __cplusplus
+#include <cstdint>
+#else
+#include <stdint.h>
+#endif
+
+#include "umock_c/umock_c_prod.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*LZ77 byte oriented block codec (the sequences are laid out as in the LZ4 block format). No entropy stage: it trades some ratio for speed,
+compression is a single greedy pass over a hash table and decompression is mostly memcpy.*/
+
+/*the biggest source_size for which lz_codec_compress_bound does not overflow*/
+#define LZ_CODEC_MAX_INPUT_SIZE ((uint32_t)0xFEFFFFF0)
+
+/*number of bytes that is always enough to compress source_size bytes, 0 if source_size exceeds LZ_CODEC_MAX_INPUT_SIZE*/
+MOCKABLE_FUNCTION(, uint32_t, lz_codec_compress_bound, uint32_t, source_size);
+
+MOCKABLE_FUNCTION(, int, lz_codec_compress, const unsigned char*, source, uint32_t, source_size, unsigned char*, destination, uint32_t, destination_size, uint32_t*, compressed_size);
+
+/*destination_size is the exact number of bytes that were compressed (the codec does not store it)*/
+MOCKABLE_FUNCTION(, int, lz_codec_decompress, const unsigned char*, source, uint32_t, source_size, unsigned char*, destination, uint32_t, destination_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LZ_CODEC_H */
@@ -0,0 +1,50 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef MEMORY_MAPPED_FILE_H
+#define MEMORY_MAPPED_FILE_H
+
+#ifdef __cplusplus
+#include <cstdint>
+#include <cstddef>
+#else
+#include <stddef.h>
+#include <stdint.h>
+#endif
+
+#include "macro_utils/macro_utils.h"
+
+#include "umock_c/umock_c_prod.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*hints passed to the OS about how the mapped bytes are going to be read*/
+#define MEMORY_MAPPED_FILE_ACCESS_HINT_VALUES \
+    MEMORY_MAPPED_FILE_ACCESS_HINT_NORMAL, \
+    MEMORY_MAPPED_FILE_ACCESS_HINT_SEQUENTIAL, \
+    MEMORY_MAPPED_FILE_ACCESS_HINT_RANDOM, \
+    MEMORY_MAPPED_FILE_ACCESS_HINT_WILLNEED
+
+MU_DEFINE_ENUM(MEMORY_MAPPED_FILE_ACCESS_HINT, MEMORY_MAPPED_FILE_ACCESS_HINT_VALUES)
+
+/*a read-only view of a range of a file. The view does not keep the file open, only the mapping.*/
+typedef struct MEMORY_MAPPED_FILE_VIEW_TAG
+{
+    void* mapping_base;             /*address returned by the OS (aligned to the OS granularity), NULL for an empty view*/
+    size_t mapping_size;            /*number of bytes mapped starting at mapping_base*/
+    const unsigned char* content;   /*first byte of the requested range*/
+    uint32_t content_size;          /*number of bytes of the requested range*/
+} MEMORY_MAPPED_FILE_VIEW;
+
+MOCKABLE_FUNCTION(, int, memory_mapped_file_map, const char*, file_name, uint64_t, offset, uint32_t, size, MEMORY_MAPPED_FILE_ACCESS_HINT, hint, MEMORY_MAPPED_FILE_VIEW*, view);
+
+MOCKABLE_FUNCTION(, void, memory_mapped_file_unmap, MEMORY_MAPPED_FILE_VIEW*, view);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MEMORY_MAPPED_FILE_H */
@@ -12,10 +12,16 @@
 #include "c_pal/gballoc_hl.h"
 #include "c_pal/gballoc_hl_redirect.h"
 #include "c_pal/interlocked.h"
+#include "c_pal/threadapi.h"
 
+#include "c_util/crc32c.h"
+#include "c_util/hash.h"
+#include "c_util/lz_codec.h"
 #include "c_util/memory_data.h"
+#include "c_util/memory_mapped_file.h"
 #include "c_util/constbuffer_format.h"
 #include "c_util/constbuffer_version.h"
+#include "c_util/constbuffer_accounting.h"
 #include "c_util/constbuffer.h"
 
 // in order to optimize memory usage, the const buffer structure cintains a discriminator that tells what kind of const buffer it is (copied, with cusom free, etc.).
@@ -24,17 +30,64 @@
     CONSTBUFFER_TYPE_COPIED, \
     CONSTBUFFER_TYPE_MEMORY_MOVED, \
     CONSTBUFFER_TYPE_WITH_CUSTOM_FREE, \
-    CONSTBUFFER_TYPE_FROM_OFFSET_AND_SIZE
+    CONSTBUFFER_TYPE_FROM_OFFSET_AND_SIZE, \
+    CONSTBUFFER_TYPE_POOLED, \
+    CONSTBUFFER_TYPE_MAPPED_FILE, \
+    CONSTBUFFER_TYPE_FROM_BUFFER_VIEW, \
+    CONSTBUFFER_TYPE_SHARED_HOT
 
 MU_DEFINE_ENUM(CONSTBUFFER_TYPE, CONSTBUFFER_TYPE_VALUES)
 
+#ifdef CONSTBUFFER_ACCOUNTING
+static CONSTBUFFER_ACCOUNTING_TYPE constbuffer_get_accounting_type(CONSTBUFFER_TYPE buffer_type)
+{
+    CONSTBUFFER_ACCOUNTING_TYPE result;
+    switch (buffer_type)
+    {
+        case CONSTBUFFER_TYPE_MEMORY_MOVED: result = CONSTBUFFER_ACCOUNTING_TYPE_MEMORY_MOVED; break;
+        case CONSTBUFFER_TYPE_WITH_CUSTOM_FREE: result = CONSTBUFFER_ACCOUNTING_TYPE_WITH_CUSTOM_FREE; break;
+        case CONSTBUFFER_TYPE_FROM_OFFSET_AND_SIZE: result = CONSTBUFFER_ACCOUNTING_TYPE_FROM_OFFSET_AND_SIZE; break;
+        case CONSTBUFFER_TYPE_POOLED: result = CONSTBUFFER_ACCOUNTING_TYPE_POOLED; break;
+        case CONSTBUFFER_TYPE_MAPPED_FILE: result = CONSTBUFFER_ACCOUNTING_TYPE_MAPPED_FILE; break;
+        case CONSTBUFFER_TYPE_FROM_BUFFER_VIEW: result = CONSTBUFFER_ACCOUNTING_TYPE_FROM_BUFFER_VIEW; break;
+        case CONSTBUFFER_TYPE_SHARED_HOT: result = CONSTBUFFER_ACCOUNTING_TYPE_SHARED_HOT; break;
+        default: result = CONSTBUFFER_ACCOUNTING_TYPE_COPIED; break;
+    }
+    return result;
+}
+
+/*a handle is accounted once it is fully built (buffer_type and alias.size are set) and until its last reference is released*/
+#define CONSTBUFFER_ACCOUNT_CREATED(handle) constbuffer_accounting_add(constbuffer_get_accounting_type((handle)->buffer_type), (handle)->alias.size)
+#define CONSTBUFFER_ACCOUNT_FREED(handle) constbuffer_accounting_remove(constbuffer_get_accounting_type((handle)->buffer_type), (handle)->alias.size)
+#else
+#define CONSTBUFFER_ACCOUNT_CREATED(handle) ((void)0)
+#define CONSTBUFFER_ACCOUNT_FREED(handle) ((void)0)
+#endif
+
 MU_DEFINE_ENUM_STRINGS(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_VALUES);
 
+#ifdef CONSTBUFFER_FINGERPRINT_CACHE
+/*the cache costs every handle 8 bytes and an interlocked store at creation, so it is only compiled in when CONSTBUFFER_FINGERPRINT_CACHE is defined*/
+
+/*an empty content has fingerprint 0 too, it is computed again on every call (which does not read any byte)*/
+#define CONSTBUFFER_FINGERPRINT_UNKNOWN 0
+
+#define CONSTBUFFER_COMMON_FIELDS \
+        CONSTBUFFER, alias,                                                                                                                                                                                \
+        CONSTBUFFER_TYPE,  buffer_type,                                                                                                                                                                    \
+        volatile_atomic int32_t, count,                                                                                                                                                                    \
+        volatile_atomic int64_t, fingerprint /*CONSTBUFFER_FINGERPRINT_UNKNOWN until CONSTBUFFER_GetFingerprint computes it, the content never changes once it is a CONSTBUFFER_HANDLE*/                   \
+
+#define CONSTBUFFER_FINGERPRINT_INIT(handle) (void)interlocked_exchange_64(&(handle)->fingerprint, CONSTBUFFER_FINGERPRINT_UNKNOWN)
+#else
 #define CONSTBUFFER_COMMON_FIELDS \
         CONSTBUFFER, alias,                                                                                                                                                                                \
         CONSTBUFFER_TYPE,  buffer_type,                                                                                                                                                                    \
         volatile_atomic int32_t, count                                                                                                                                                                     \
 
+#define CONSTBUFFER_FINGERPRINT_INIT(handle) ((void)0)
+#endif
+
 MU_DEFINE_ENUM_STRINGS(CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT, CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_VALUES);
 
 #define CONSTBUFFER_HANDLE_DATA_FIELDS                                                                                                                                                                     \
@@ -64,10 +117,315 @@ MU_DEFINE_STRUCT(CONSTBUFFER_HANDLE_WITH_CUSTOM_FREE_DATA, CONSTBUFFER_HANDLE_WI
 
 MU_DEFINE_STRUCT(CONSTBUFFER_HANDLE_FROM_OFFSET_AND_SIZE_DATA, CONSTBUFFER_HANDLE_FROM_OFFSET_AND_SIZE_DATA_FIELDS)
 
+/*CONSTBUFFER_from_buffer_view_bulk allocates all the views in one block. The block starts like a CONSTBUFFER_TYPE_FROM_OFFSET_AND_SIZE handle
+(that holds the only reference to the source) and its count is the number of views that are still alive. The views are CONSTBUFFER_TYPE_FROM_BUFFER_VIEW
+handles whose originalHandle is the block. When the last view goes away, the block releases the source and frees itself (and with it all the views)*/
+#define CONSTBUFFER_HANDLE_FROM_BUFFER_BULK_DATA_FIELDS                                                                                                                                                    \
+        CONSTBUFFER_HANDLE_FROM_OFFSET_AND_SIZE_DATA_FIELDS,                                                                                                                                               \
+        CONSTBUFFER_HANDLE_FROM_OFFSET_AND_SIZE_DATA, views[]
+
+MU_DEFINE_STRUCT(CONSTBUFFER_HANDLE_FROM_BUFFER_BULK_DATA, CONSTBUFFER_HANDLE_FROM_BUFFER_BULK_DATA_FIELDS)
+
+#define CONSTBUFFER_HANDLE_POOLED_DATA_FIELDS                                                                                                                                                              \
+        CONSTBUFFER_COMMON_FIELDS,                                                                                                                                                                         \
+        CONSTBUFFER_POOL_HANDLE, pool, /*the pool where the memory goes back when the ref count reaches 0*/                                                                                                \
+        uint32_t, size_class, /*index of the size class, storage has (CONSTBUFFER_POOL_MIN_CLASS_SIZE << size_class) bytes*/                                                                              \
+        unsigned char, storage[]
+
+MU_DEFINE_STRUCT(CONSTBUFFER_HANDLE_POOLED_DATA, CONSTBUFFER_HANDLE_POOLED_DATA_FIELDS)
+
+#define CONSTBUFFER_HANDLE_MAPPED_FILE_DATA_FIELDS                                                                                                                                                         \
+        CONSTBUFFER_COMMON_FIELDS,                                                                                                                                                                         \
+        MEMORY_MAPPED_FILE_VIEW, view /*the mapping is released when the ref count reaches 0*/                                                                                                             \
+
+MU_DEFINE_STRUCT(CONSTBUFFER_HANDLE_MAPPED_FILE_DATA, CONSTBUFFER_HANDLE_MAPPED_FILE_DATA_FIELDS)
+
+/*a CONSTBUFFER_TYPE_SHARED_HOT handle counts the references taken and released by CONSTBUFFER_IncRef/CONSTBUFFER_DecRef in slots picked by the id of the
+calling thread, each slot in its own cache line, so threads that IncRef/DecRef the same handle do not contend on the same cache line. count holds the references
+that are not in any slot (the one given by CONSTBUFFER_CreateSharedHot to start with). A slot never goes below 0: a DecRef that finds its slot at 0 decrements
+count instead. When count reaches 0 the slots are closed and merged in count, from then on all the references are counted in count and the handle is freed when
+count reaches 0 again*/
+#define CONSTBUFFER_SHARED_HOT_SLOT_CLOSED (-1)
+/*keeps count away from 0 while the slots are being merged*/
+#define CONSTBUFFER_SHARED_HOT_MERGE_BIAS (INT32_MAX / 2)
+#define CONSTBUFFER_CACHE_LINE_SIZE 64
+
+typedef struct CONSTBUFFER_SHARED_HOT_SLOT_TAG
+{
+    volatile_atomic int32_t count;
+    unsigned char padding[CONSTBUFFER_CACHE_LINE_SIZE - sizeof(int32_t)];
+} CONSTBUFFER_SHARED_HOT_SLOT;
+
+#define CONSTBUFFER_HANDLE_SHARED_HOT_DATA_FIELDS                                                                                                                                                          \
+        CONSTBUFFER_COMMON_FIELDS,                                                                                                                                                                         \
+        CONSTBUFFER_HANDLE, originalHandle, /*the handle passed to CONSTBUFFER_CreateSharedHot, released when the ref count reaches 0*/                                                                    \
+        volatile_atomic int32_t, is_merged, /*1 after the slots have been merged in count*/                                                                                                               \
+        uint32_t, slot_count,                                                                                                                                                                              \
+        CONSTBUFFER_SHARED_HOT_SLOT, slots[]
+
+MU_DEFINE_STRUCT(CONSTBUFFER_HANDLE_SHARED_HOT_DATA, CONSTBUFFER_HANDLE_SHARED_HOT_DATA_FIELDS)
+
 MU_DEFINE_STRUCT(CONSTBUFFER_HANDLE_DATA, CONSTBUFFER_HANDLE_DATA_FIELDS)
 
 MU_DEFINE_STRUCT(CONSTBUFFER_WRITABLE_HANDLE_DATA, CONSTBUFFER_HANDLE_COPIED_DATA_FIELDS)
 
+/*the smallest size class of a pool is 64 bytes, every next class doubles the size*/
+#define CONSTBUFFER_POOL_MIN_CLASS_SIZE_LOG2 6
+#define CONSTBUFFER_POOL_MIN_CLASS_SIZE ((uint32_t)1 << CONSTBUFFER_POOL_MIN_CLASS_SIZE_LOG2)
+/*the biggest size class is 2^31 bytes*/
+#define CONSTBUFFER_POOL_MAX_BUFFER_SIZE ((uint32_t)1 << 31)
+
+/*the size classes go from 64 bytes (2^6) to 2^31 bytes*/
+#define CONSTBUFFER_POOL_MAX_CLASS_COUNT (31 - CONSTBUFFER_POOL_MIN_CLASS_SIZE_LOG2 + 1)
+
+/*every size class has max_retained_per_class slots. A slot is in one of 2 lock-free stacks of its class: the stack of the slots that hold a retained buffer
+or the stack of the free slots, so taking and returning a buffer is a pop and a push (O(1), whatever max_retained_per_class is).
+The head of a stack is a 64-bit value: the low 32 bits are the index of the top slot + 1 (0 for an empty stack), the high 32 bits are a tag that
+changes with every push and pop, so that a pop whose top slot was popped and pushed again in the meantime fails its compare exchange (ABA).
+The slots are never freed while the pool is alive, so reading the next of a slot that another thread just popped is harmless*/
+#define CONSTBUFFER_POOL_STACK_EMPTY 0
+
+typedef struct CONSTBUFFER_POOL_SLOT_TAG
+{
+    void* volatile_atomic buffer; /*the retained CONSTBUFFER_HANDLE_POOLED_DATA, NULL when the slot is free*/
+    volatile_atomic int32_t next; /*index + 1 of the slot under this one in its stack*/
+} CONSTBUFFER_POOL_SLOT;
+
+typedef struct CONSTBUFFER_POOL_CLASS_TAG
+{
+    volatile_atomic int64_t retained_head;
+    volatile_atomic int64_t free_head;
+} CONSTBUFFER_POOL_CLASS;
+
+typedef struct CONSTBUFFER_POOL_HANDLE_DATA_TAG
+{
+    volatile_atomic int32_t ref_count; /*1 for the owner of the pool + 1 for every pooled buffer that is in use*/
+    volatile_atomic int32_t is_destroyed;
+    uint32_t max_buffer_size; /*size of the biggest size class*/
+    uint32_t class_count;
+    uint32_t max_retained_per_class;
+    volatile_atomic int64_t hits;
+    volatile_atomic int64_t misses;
+    volatile_atomic int64_t retained_buffers;
+    volatile_atomic int64_t retained_bytes;
+    CONSTBUFFER_POOL_CLASS classes[CONSTBUFFER_POOL_MAX_CLASS_COUNT];
+    CONSTBUFFER_POOL_SLOT slots[]; /*class_count * max_retained_per_class slots, the slots of a size class are next to each other*/
+} CONSTBUFFER_POOL_HANDLE_DATA;
+
+static uint32_t constbuffer_pool_get_size_class(uint32_t size)
+{
+    /*returns the index of the smallest size class that can hold size bytes*/
+    uint32_t result = 0;
+    while ((CONSTBUFFER_POOL_MIN_CLASS_SIZE << result) < size)
+    {
+        result++;
+    }
+    return result;
+}
+
+static int64_t constbuffer_pool_make_head(int64_t previous_head, uint32_t top)
+{
+    return (int64_t)(((((uint64_t)previous_head >> 32) + 1) << 32) | top);
+}
+
+/*returns the index + 1 of the slot that was on top of the stack, CONSTBUFFER_POOL_STACK_EMPTY if the stack is empty*/
+static uint32_t constbuffer_pool_pop(CONSTBUFFER_POOL_HANDLE pool, volatile_atomic int64_t* head)
+{
+    uint32_t result;
+    int64_t current = interlocked_add_64(head, 0);
+    while (1)
+    {
+        result = (uint32_t)((uint64_t)current & UINT32_MAX);
+        if (result == CONSTBUFFER_POOL_STACK_EMPTY)
+        {
+            break;
+        }
+        else
+        {
+            uint32_t next = (uint32_t)interlocked_add(&pool->slots[result - 1].next, 0);
+            int64_t previous = interlocked_compare_exchange_64(head, constbuffer_pool_make_head(current, next), current);
+            if (previous == current)
+            {
+                break;
+            }
+            current = previous;
+        }
+    }
+    return result;
+}
+
+static void constbuffer_pool_push(CONSTBUFFER_POOL_HANDLE pool, volatile_atomic int64_t* head, uint32_t top)
+{
+    int64_t current = interlocked_add_64(head, 0);
+    while (1)
+    {
+        (void)interlocked_exchange(&pool->slots[top - 1].next, (int32_t)((uint64_t)current & UINT32_MAX));
+        int64_t previous = interlocked_compare_exchange_64(head, constbuffer_pool_make_head(current, top), current);
+        if (previous == current)
+        {
+            break;
+        }
+        current = previous;
+    }
+}
+
+/*takes a retained buffer of the size class out of its slot, NULL if the size class has none*/
+static CONSTBUFFER_HANDLE_POOLED_DATA* constbuffer_pool_take_retained(CONSTBUFFER_POOL_HANDLE pool, uint32_t size_class)
+{
+    CONSTBUFFER_HANDLE_POOLED_DATA* result;
+    CONSTBUFFER_POOL_CLASS* pool_class = &pool->classes[size_class];
+    uint32_t slot = constbuffer_pool_pop(pool, &pool_class->retained_head);
+    if (slot == CONSTBUFFER_POOL_STACK_EMPTY)
+    {
+        result = NULL;
+    }
+    else
+    {
+        result = interlocked_exchange_pointer(&pool->slots[slot - 1].buffer, NULL);
+        constbuffer_pool_push(pool, &pool_class->free_head, slot);
+        (void)interlocked_add_64(&pool->retained_buffers, -1);
+        (void)interlocked_add_64(&pool->retained_bytes, -(int64_t)(CONSTBUFFER_POOL_MIN_CLASS_SIZE << size_class));
+    }
+    return result;
+}
+
+static void constbuffer_pool_free_retained(CONSTBUFFER_POOL_HANDLE pool)
+{
+    for (uint32_t i = 0; i < pool->class_count; i++)
+    {
+        CONSTBUFFER_HANDLE_POOLED_DATA* retained;
+        while ((retained = constbuffer_pool_take_retained(pool, i)) != NULL)
+        {
+            free(retained);
+        }
+    }
+}
+
+static void constbuffer_pool_dec_ref(CONSTBUFFER_POOL_HANDLE pool)
+{
+    if (interlocked_decrement(&pool->ref_count) == 0)
+    {
+        /*a buffer might have been returned while CONSTBUFFER_POOL_Destroy was trimming, so trim again before freeing the slots*/
+        constbuffer_pool_free_retained(pool);
+        free(pool);
+    }
+}
+
+/*called when the ref count of a CONSTBUFFER_TYPE_POOLED buffer reaches 0*/
+static void constbuffer_pool_return(CONSTBUFFER_HANDLE_POOLED_DATA* pooled)
+{
+    CONSTBUFFER_POOL_HANDLE pool = pooled->pool;
+    bool is_retained = false;
+
+    if (interlocked_add(&pool->is_destroyed, 0) == 0)
+    {
+        /*Codes_SRS_CONSTBUFFER_12_023: [ If the refcount of a buffer created by CONSTBUFFER_POOL_CreateWritableHandle reaches zero and the pool has a free slot in the buffer's size class, then the buffer shall be stored in the slot instead of being freed. ]*/
+        CONSTBUFFER_POOL_CLASS* pool_class = &pool->classes[pooled->size_class];
+        uint32_t slot = constbuffer_pool_pop(pool, &pool_class->free_head);
+        if (slot != CONSTBUFFER_POOL_STACK_EMPTY)
+        {
+            /*counters are increased before the buffer can be taken so that a concurrent take never makes them go below 0*/
+            (void)interlocked_add_64(&pool->retained_buffers, 1);
+            (void)interlocked_add_64(&pool->retained_bytes, (int64_t)(CONSTBUFFER_POOL_MIN_CLASS_SIZE << pooled->size_class));
+            (void)interlocked_exchange_pointer(&pool->slots[slot - 1].buffer, pooled);
+            constbuffer_pool_push(pool, &pool_class->retained_head, slot);
+            is_retained = true;
+        }
+    }
+
+    if (!is_retained)
+    {
+        /*Codes_SRS_CONSTBUFFER_12_024: [ Otherwise the buffer shall be freed. ]*/
+        free(pooled);
+    }
+
+    /*Codes_SRS_CONSTBUFFER_12_025: [ The reference that the buffer holds on the pool shall be released. ]*/
+    constbuffer_pool_dec_ref(pool);
+}
+
+static volatile_atomic int32_t* constbuffer_shared_hot_get_slot(CONSTBUFFER_HANDLE_SHARED_HOT_DATA* shared_hot)
+{
+    /*multiplicative hashing spreads consecutive thread ids over the slots*/
+    uint32_t hash = ThreadAPI_GetCurrentId() * 2654435769U;
+    return &shared_hot->slots[((uint64_t)hash * shared_hot->slot_count) >> 32].count;
+}
+
+static void constbuffer_shared_hot_inc_ref(CONSTBUFFER_HANDLE_SHARED_HOT_DATA* shared_hot)
+{
+    volatile_atomic int32_t* slot = constbuffer_shared_hot_get_slot(shared_hot);
+    int32_t current = interlocked_add(slot, 0);
+    while (current != CONSTBUFFER_SHARED_HOT_SLOT_CLOSED)
+    {
+        int32_t previous = interlocked_compare_exchange(slot, current + 1, current);
+        if (previous == current)
+        {
+            break;
+        }
+        current = previous;
+    }
+
+    if (current == CONSTBUFFER_SHARED_HOT_SLOT_CLOSED)
+    {
+        (void)interlocked_increment(&shared_hot->count);
+    }
+}
+
+/*returns true when the last reference was released*/
+static bool constbuffer_shared_hot_dec_ref(CONSTBUFFER_HANDLE_SHARED_HOT_DATA* shared_hot)
+{
+    bool result;
+    volatile_atomic int32_t* slot = constbuffer_shared_hot_get_slot(shared_hot);
+    int32_t current = interlocked_add(slot, 0);
+    while (current > 0)
+    {
+        int32_t previous = interlocked_compare_exchange(slot, current - 1, current);
+        if (previous == current)
+        {
+            break;
+        }
+        current = previous;
+    }
+
+    if (current > 0)
+    {
+        /*the reference was given back to the slot*/
+        result = false;
+    }
+    else if (interlocked_decrement(&shared_hot->count) != 0)
+    {
+        result = false;
+    }
+    else if (interlocked_add(&shared_hot->is_merged, 0) != 0)
+    {
+        result = true;
+    }
+    else
+    {
+        /*count reached 0 for the first time (nothing increments count while the slots are open, so only one thread gets here), the slots might still hold references*/
+        int32_t merged = 0;
+        (void)interlocked_add(&shared_hot->count, CONSTBUFFER_SHARED_HOT_MERGE_BIAS);
+        for (uint32_t i = 0; i < shared_hot->slot_count; i++)
+        {
+            merged += interlocked_exchange(&shared_hot->slots[i].count, CONSTBUFFER_SHARED_HOT_SLOT_CLOSED);
+        }
+        (void)interlocked_exchange(&shared_hot->is_merged, 1);
+        result = (interlocked_add(&shared_hot->count, merged - CONSTBUFFER_SHARED_HOT_MERGE_BIAS) == 0);
+    }
+    return result;
+}
+
+static void constbuffer_inc_ref(CONSTBUFFER_HANDLE constbufferHandle)
+{
+    if (constbufferHandle->buffer_type == CONSTBUFFER_TYPE_SHARED_HOT)
+    {
+        constbuffer_shared_hot_inc_ref((CONSTBUFFER_HANDLE_SHARED_HOT_DATA*)constbufferHandle);
+    }
+    else
+    {
+        (void)interlocked_increment(&constbufferHandle->count);
+    }
+}
+
 static CONSTBUFFER_HANDLE CONSTBUFFER_Create_Internal(const unsigned char* source, uint32_t size)
 {
     CONSTBUFFER_HANDLE_COPIED_DATA* result;
@@ -87,6 +445,7 @@ static CONSTBUFFER_HANDLE CONSTBUFFER_Create_Internal(const unsigned char* sourc
     else
     {
         (void)interlocked_exchange(&result->count, 1);
+        CONSTBUFFER_FINGERPRINT_INIT(result);
 
         /*Codes_SRS_CONSTBUFFER_02_002: [Otherwise, CONSTBUFFER_Create shall create a copy of the memory area pointed to by source having size bytes.]*/
         result->alias.size = size;
@@ -107,6 +466,30 @@ static CONSTBUFFER_HANDLE CONSTBUFFER_Create_Internal(const unsigned char* sourc
         }
 
         result->buffer_type = CONSTBUFFER_TYPE_COPIED;
+        /*Codes_SRS_CONSTBUFFER_12_111: [ If CONSTBUFFER_ACCOUNTING is defined then every function that produces a CONSTBUFFER_HANDLE or a CONSTBUFFER_WRITABLE_HANDLE shall call constbuffer_accounting_add with the type of the handle and its size. ]*/
+        CONSTBUFFER_ACCOUNT_CREATED(result);
+    }
+    return (CONSTBUFFER_HANDLE)result;
+}
+
+/*same as CONSTBUFFER_Create_Internal, except the copy also produces the CRC32C of the bytes*/
+static CONSTBUFFER_HANDLE constbuffer_create_with_crc32c(const unsigned char* source, uint32_t size, uint32_t* crc)
+{
+    CONSTBUFFER_HANDLE_COPIED_DATA* result = malloc_flex(sizeof(CONSTBUFFER_HANDLE_COPIED_DATA), size, sizeof(unsigned char));
+    if (result == NULL)
+    {
+        LogError("failure in malloc_flex(sizeof(CONSTBUFFER_HANDLE_COPIED_DATA)=%zu, size=%" PRIu32 ", sizeof(unsigned char)=%zu",
+            sizeof(CONSTBUFFER_HANDLE_COPIED_DATA), size, sizeof(unsigned char));
+        /*return as is*/
+    }
+    else
+    {
+        (void)interlocked_exchange(&result->count, 1);
+        CONSTBUFFER_FINGERPRINT_INIT(result);
+        result->alias.size = size;
+        result->alias.buffer = (size == 0) ? NULL : result->storage;
+        *crc = crc32c_copy(0, result->storage, source, size);
+        result->buffer_type = CONSTBUFFER_TYPE_COPIED;
     }
     return (CONSTBUFFER_HANDLE)result;
 }
@@ -177,6 +560,8 @@ CONSTBUFFER_HANDLE CONSTBUFFER_CreateWithMoveMemory(unsigned char* source, uint3
 
             /* Codes_SRS_CONSTBUFFER_01_003: [ The non-NULL handle returned by CONSTBUFFER_CreateWithMoveMemory shall have its ref count set to "1". ]*/
             (void)interlocked_exchange(&result->count, 1);
+            CONSTBUFFER_FINGERPRINT_INIT(result);
+            CONSTBUFFER_ACCOUNT_CREATED(result);
         }
     }
 
@@ -222,6 +607,56 @@ CONSTBUFFER_HANDLE CONSTBUFFER_CreateWithCustomFree(const unsigned char* source,
 
             /* Codes_SRS_CONSTBUFFER_01_010: [ The non-NULL handle returned by CONSTBUFFER_CreateWithCustomFree shall have its ref count set to 1. ]*/
             (void)interlocked_exchange(&result->count, 1);
+            CONSTBUFFER_FINGERPRINT_INIT(result);
+            CONSTBUFFER_ACCOUNT_CREATED(result);
+        }
+    }
+
+    return (CONSTBUFFER_HANDLE)result;
+}
+
+CONSTBUFFER_HANDLE CONSTBUFFER_CreateFromMappedFile(const char* file_name, uint64_t offset, uint32_t size, MEMORY_MAPPED_FILE_ACCESS_HINT hint)
+{
+    CONSTBUFFER_HANDLE_MAPPED_FILE_DATA* result;
+
+    /*Codes_SRS_CONSTBUFFER_12_028: [ If file_name is NULL then CONSTBUFFER_CreateFromMappedFile shall fail and return NULL. ]*/
+    if (file_name == NULL)
+    {
+        LogError("Invalid arguments: const char* file_name=%s, uint64_t offset=%" PRIu64 ", uint32_t size=%" PRIu32 ", MEMORY_MAPPED_FILE_ACCESS_HINT hint=%" PRI_MU_ENUM "",
+            MU_P_OR_NULL(file_name), offset, size, MU_ENUM_VALUE(MEMORY_MAPPED_FILE_ACCESS_HINT, hint));
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_12_029: [ CONSTBUFFER_CreateFromMappedFile shall allocate memory for the CONSTBUFFER_HANDLE. ]*/
+        result = malloc(sizeof(CONSTBUFFER_HANDLE_MAPPED_FILE_DATA));
+        if (result == NULL)
+        {
+            /*Codes_SRS_CONSTBUFFER_12_032: [ If there are any failures then CONSTBUFFER_CreateFromMappedFile shall fail and return NULL. ]*/
+            LogError("failure in malloc(sizeof(CONSTBUFFER_HANDLE_MAPPED_FILE_DATA)=%zu)", sizeof(CONSTBUFFER_HANDLE_MAPPED_FILE_DATA));
+            /*return as is*/
+        }
+        else
+        {
+            /*Codes_SRS_CONSTBUFFER_12_030: [ CONSTBUFFER_CreateFromMappedFile shall call memory_mapped_file_map to map size bytes of file_name starting at offset with hint. ]*/
+            if (memory_mapped_file_map(file_name, offset, size, hint, &result->view) != 0)
+            {
+                /*Codes_SRS_CONSTBUFFER_12_032: [ If there are any failures then CONSTBUFFER_CreateFromMappedFile shall fail and return NULL. ]*/
+                LogError("failure in memory_mapped_file_map(file_name=%s, offset=%" PRIu64 ", size=%" PRIu32 ", hint=%" PRI_MU_ENUM ", &result->view=%p)",
+                    file_name, offset, size, MU_ENUM_VALUE(MEMORY_MAPPED_FILE_ACCESS_HINT, hint), &result->view);
+                free(result);
+                result = NULL;
+            }
+            else
+            {
+                /*Codes_SRS_CONSTBUFFER_12_031: [ CONSTBUFFER_CreateFromMappedFile shall set the content of the const buffer to the mapped bytes, set the ref count to 1, succeed and return a non-NULL value. ]*/
+                result->alias.buffer = result->view.content;
+                result->alias.size = result->view.content_size;
+                result->buffer_type = CONSTBUFFER_TYPE_MAPPED_FILE;
+                (void)interlocked_exchange(&result->count, 1);
+                CONSTBUFFER_FINGERPRINT_INIT(result);
+                CONSTBUFFER_ACCOUNT_CREATED(result);
+            }
         }
     }
 
@@ -250,7 +685,7 @@ CONSTBUFFER_HANDLE CONSTBUFFER_CreateFromOffsetAndSize(CONSTBUFFER_HANDLE handle
     /*Codes_SRS_CONSTBUFFER_28_001: [ If offset is 0 and size is equal to handle's size then CONSTBUFFER_CreateFromOffsetAndSize shall increment the reference count of handle and return handle. ]*/
     else if (offset == 0 && size == handle->alias.size)
     {
-        (void)interlocked_increment(&handle->count);
+        constbuffer_inc_ref(handle);
         result = (void*)handle;
     }
     else
@@ -270,11 +705,13 @@ CONSTBUFFER_HANDLE CONSTBUFFER_CreateFromOffsetAndSize(CONSTBUFFER_HANDLE handle
             result->alias.size = size;
 
             /*Codes_SRS_CONSTBUFFER_02_030: [ CONSTBUFFER_CreateFromOffsetAndSize shall increment the reference count of handle. ]*/
-            (void)interlocked_increment(&handle->count);
+            constbuffer_inc_ref(handle);
             result->originalHandle = handle;
 
             /*Codes_SRS_CONSTBUFFER_02_029: [ CONSTBUFFER_CreateFromOffsetAndSize shall set the ref count of the newly created CONSTBUFFER_HANDLE to the initial value. ]*/
             (void)interlocked_exchange(&result->count, 1);
+            CONSTBUFFER_FINGERPRINT_INIT(result);
+            CONSTBUFFER_ACCOUNT_CREATED(result);
 
             /*Codes_SRS_CONSTBUFFER_02_031: [ CONSTBUFFER_CreateFromOffsetAndSize shall succeed and return a non-NULL value. ]*/
         }
@@ -328,8 +765,52 @@ void CONSTBUFFER_IncRef(CONSTBUFFER_HANDLE constbufferHandle)
     else
     {
         /*Codes_SRS_CONSTBUFFER_02_014: [Otherwise, CONSTBUFFER_IncRef shall increment the reference count.]*/
-        (void)interlocked_increment(&constbufferHandle->count);
+        /*Codes_SRS_CONSTBUFFER_12_107: [ If constbufferHandle was created by CONSTBUFFER_CreateSharedHot then CONSTBUFFER_IncRef shall increment the reference count in the slot picked by the id of the calling thread. ]*/
+        constbuffer_inc_ref(constbufferHandle);
+    }
+}
+
+bool CONSTBUFFER_TryIncRef(CONSTBUFFER_HANDLE constbufferHandle)
+{
+    bool result;
+    if (constbufferHandle == NULL)
+    {
+        /*Codes_SRS_CONSTBUFFER_12_113: [ If constbufferHandle is NULL then CONSTBUFFER_TryIncRef shall fail and return false. ]*/
+        LogError("Invalid arguments: CONSTBUFFER_HANDLE constbufferHandle: %p", constbufferHandle);
+        result = false;
+    }
+    else if (constbufferHandle->buffer_type == CONSTBUFFER_TYPE_SHARED_HOT)
+    {
+        /*Codes_SRS_CONSTBUFFER_12_114: [ If constbufferHandle was created by CONSTBUFFER_CreateSharedHot then CONSTBUFFER_TryIncRef shall fail and return false. ]*/
+        /*count alone does not tell whether a shared hot handle is alive while its slots are open*/
+        LogError("CONSTBUFFER_TryIncRef is not supported for a handle created by CONSTBUFFER_CreateSharedHot, constbufferHandle=%p", constbufferHandle);
+        result = false;
+    }
+    else
+    {
+        int32_t current = interlocked_add(&constbufferHandle->count, 0);
+        for (;;)
+        {
+            if (current == 0)
+            {
+                /*Codes_SRS_CONSTBUFFER_12_115: [ If the reference count of constbufferHandle is 0 then CONSTBUFFER_TryIncRef shall return false. ]*/
+                result = false;
+                break;
+            }
+            else
+            {
+                /*Codes_SRS_CONSTBUFFER_12_116: [ Otherwise, CONSTBUFFER_TryIncRef shall increment the reference count (only if it is still not 0, atomically) and return true. ]*/
+                int32_t previous = interlocked_compare_exchange(&constbufferHandle->count, current + 1, current);
+                if (previous == current)
+                {
+                    result = true;
+                    break;
+                }
+                current = previous;
+            }
+        }
     }
+    return result;
 }
 
 const CONSTBUFFER* CONSTBUFFER_GetContent(CONSTBUFFER_HANDLE constbufferHandle)
@@ -351,28 +832,76 @@ const CONSTBUFFER* CONSTBUFFER_GetContent(CONSTBUFFER_HANDLE constbufferHandle)
 
 static void CONSTBUFFER_DecRef_internal(CONSTBUFFER_HANDLE constbufferHandle)
 {
-    /*Codes_SRS_CONSTBUFFER_02_016: [Otherwise, CONSTBUFFER_DecRef shall decrement the refcount on the constbufferHandle handle.]*/
-    if (interlocked_decrement(&constbufferHandle->count) == 0)
+    bool is_last_reference;
+    if (constbufferHandle->buffer_type == CONSTBUFFER_TYPE_SHARED_HOT)
     {
-        if (constbufferHandle->buffer_type == CONSTBUFFER_TYPE_MEMORY_MOVED)
+        /*Codes_SRS_CONSTBUFFER_12_108: [ If constbufferHandle was created by CONSTBUFFER_CreateSharedHot then CONSTBUFFER_DecRef shall decrement the reference count in the slot picked by the id of the calling thread if that slot is greater than 0, otherwise the reference count not held in slots. ]*/
+        /*Codes_SRS_CONSTBUFFER_12_109: [ When the reference count not held in slots reaches 0 for the first time, CONSTBUFFER_DecRef shall close the slots and add their reference counts to it. ]*/
+        is_last_reference = constbuffer_shared_hot_dec_ref((CONSTBUFFER_HANDLE_SHARED_HOT_DATA*)constbufferHandle);
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_02_016: [Otherwise, CONSTBUFFER_DecRef shall decrement the refcount on the constbufferHandle handle.]*/
+        is_last_reference = (interlocked_decrement(&constbufferHandle->count) == 0);
+    }
+
+    if (is_last_reference)
+    {
+        /*a CONSTBUFFER_TYPE_FROM_BUFFER_VIEW handle lives in the memory of its block, so it cannot be read anymore after the block is released*/
+        CONSTBUFFER_TYPE buffer_type = constbufferHandle->buffer_type;
+
+        /*Codes_SRS_CONSTBUFFER_12_112: [ If CONSTBUFFER_ACCOUNTING is defined then CONSTBUFFER_DecRef and CONSTBUFFER_WritableHandleDecRef shall call constbuffer_accounting_remove with the type of the handle and its size when the ref count reaches 0. ]*/
+        CONSTBUFFER_ACCOUNT_FREED(constbufferHandle);
+
+        if (buffer_type == CONSTBUFFER_TYPE_MEMORY_MOVED)
         {
             free((void*)constbufferHandle->alias.buffer);
         }
-        else if (constbufferHandle->buffer_type == CONSTBUFFER_TYPE_WITH_CUSTOM_FREE)
+        else if (buffer_type == CONSTBUFFER_TYPE_WITH_CUSTOM_FREE)
         {
             CONSTBUFFER_HANDLE_WITH_CUSTOM_FREE_DATA* handleData = (CONSTBUFFER_HANDLE_WITH_CUSTOM_FREE_DATA*)constbufferHandle;
             /* Codes_SRS_CONSTBUFFER_01_012: [ If the buffer was created by calling CONSTBUFFER_CreateWithCustomFree, the customFreeFunc function shall be called to free the memory, while passed customFreeFuncContext as argument. ]*/
             handleData->custom_free_func(handleData->custom_free_func_context);
         }
+        else if (buffer_type == CONSTBUFFER_TYPE_MAPPED_FILE)
+        {
+            CONSTBUFFER_HANDLE_MAPPED_FILE_DATA* handleData = (CONSTBUFFER_HANDLE_MAPPED_FILE_DATA*)constbufferHandle;
+            /*Codes_SRS_CONSTBUFFER_12_033: [ If the buffer was created by calling CONSTBUFFER_CreateFromMappedFile, CONSTBUFFER_DecRef shall call memory_mapped_file_unmap. ]*/
+            memory_mapped_file_unmap(&handleData->view);
+        }
         /*Codes_SRS_CONSTBUFFER_02_024: [ If the constbufferHandle was created by calling CONSTBUFFER_CreateFromOffsetAndSize then CONSTBUFFER_DecRef shall decrement the ref count of the original handle passed to CONSTBUFFER_CreateFromOffsetAndSize. ]*/
-        else if (constbufferHandle->buffer_type == CONSTBUFFER_TYPE_FROM_OFFSET_AND_SIZE)
+        else if (buffer_type == CONSTBUFFER_TYPE_FROM_OFFSET_AND_SIZE)
+        {
+            CONSTBUFFER_HANDLE_FROM_OFFSET_AND_SIZE_DATA* handleData = (CONSTBUFFER_HANDLE_FROM_OFFSET_AND_SIZE_DATA*)constbufferHandle;
+            CONSTBUFFER_DecRef_internal(handleData->originalHandle);
+        }
+        else if (buffer_type == CONSTBUFFER_TYPE_FROM_BUFFER_VIEW)
         {
             CONSTBUFFER_HANDLE_FROM_OFFSET_AND_SIZE_DATA* handleData = (CONSTBUFFER_HANDLE_FROM_OFFSET_AND_SIZE_DATA*)constbufferHandle;
+            /*Codes_SRS_CONSTBUFFER_12_053: [ If the constbufferHandle was created by calling CONSTBUFFER_from_buffer_view_bulk then CONSTBUFFER_DecRef shall decrement the number of views alive in the block that holds constbufferHandle. ]*/
+            /*Codes_SRS_CONSTBUFFER_12_054: [ When the last view of a block is released, CONSTBUFFER_DecRef shall decrement the ref count of the source passed to CONSTBUFFER_from_buffer_view_bulk and free the block. ]*/
+            CONSTBUFFER_DecRef_internal(handleData->originalHandle);
+        }
+        else if (buffer_type == CONSTBUFFER_TYPE_SHARED_HOT)
+        {
+            CONSTBUFFER_HANDLE_SHARED_HOT_DATA* handleData = (CONSTBUFFER_HANDLE_SHARED_HOT_DATA*)constbufferHandle;
+            /*Codes_SRS_CONSTBUFFER_12_110: [ When the last reference of a handle created by CONSTBUFFER_CreateSharedHot is released, CONSTBUFFER_DecRef shall decrement the ref count of the source passed to CONSTBUFFER_CreateSharedHot. ]*/
             CONSTBUFFER_DecRef_internal(handleData->originalHandle);
         }
 
-        /*Codes_SRS_CONSTBUFFER_02_017: [If the refcount reaches zero, then CONSTBUFFER_DecRef shall deallocate all resources used by the CONSTBUFFER_HANDLE.]*/
-        free(constbufferHandle);
+        if (buffer_type == CONSTBUFFER_TYPE_POOLED)
+        {
+            constbuffer_pool_return((CONSTBUFFER_HANDLE_POOLED_DATA*)constbufferHandle);
+        }
+        else if (buffer_type == CONSTBUFFER_TYPE_FROM_BUFFER_VIEW)
+        {
+            /*the memory of the view belongs to its block*/
+        }
+        else
+        {
+            /*Codes_SRS_CONSTBUFFER_02_017: [If the refcount reaches zero, then CONSTBUFFER_DecRef shall deallocate all resources used by the CONSTBUFFER_HANDLE.]*/
+            free(constbufferHandle);
+        }
     }
 }
 
@@ -422,6 +951,20 @@ bool CONSTBUFFER_HANDLE_contain_same(CONSTBUFFER_HANDLE left, CONSTBUFFER_HANDLE
             }
             else
             {
+#ifdef CONSTBUFFER_FINGERPRINT_CACHE
+                int64_t left_fingerprint = interlocked_add_64(&left->fingerprint, 0);
+                int64_t right_fingerprint = interlocked_add_64(&right->fingerprint, 0);
+                if (
+                    (left_fingerprint != CONSTBUFFER_FINGERPRINT_UNKNOWN) &&
+                    (right_fingerprint != CONSTBUFFER_FINGERPRINT_UNKNOWN) &&
+                    (left_fingerprint != right_fingerprint)
+                    )
+                {
+                    /*Codes_SRS_CONSTBUFFER_12_117: [ If CONSTBUFFER_FINGERPRINT_CACHE is defined and the fingerprints of left and right are both known (computed by CONSTBUFFER_GetFingerprint) and are different then CONSTBUFFER_HANDLE_contain_same shall return false without comparing the bytes. ]*/
+                    result = false;
+                }
+                else
+#endif
                 if (memcmp(left->alias.buffer, right->alias.buffer, left->alias.size) != 0)
                 {
                     /*Codes_SRS_CONSTBUFFER_02_022: [ If left's buffer is contains different bytes than rights's buffer then CONSTBUFFER_HANDLE_contain_same shall return false. ]*/
@@ -438,33 +981,109 @@ bool CONSTBUFFER_HANDLE_contain_same(CONSTBUFFER_HANDLE left, CONSTBUFFER_HANDLE
     return result;
 }
 
-uint32_t CONSTBUFFER_get_serialization_size(CONSTBUFFER_HANDLE source)
+int CONSTBUFFER_GetFingerprint(CONSTBUFFER_HANDLE constbufferHandle, uint64_t* fingerprint)
 {
-    uint32_t result;
-    /*Codes_SRS_CONSTBUFFER_02_041: [ If source is NULL then CONSTBUFFER_get_serialization_size shall fail and return 0. ]*/
-    if (source == NULL)
+    int result;
+    if (
+        /*Codes_SRS_CONSTBUFFER_12_118: [ If constbufferHandle is NULL then CONSTBUFFER_GetFingerprint shall fail and return a non-zero value. ]*/
+        (constbufferHandle == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_12_119: [ If fingerprint is NULL then CONSTBUFFER_GetFingerprint shall fail and return a non-zero value. ]*/
+        (fingerprint == NULL)
+        )
     {
-        LogError("invalid argument CONSTBUFFER_HANDLE source=%p", source);
-        result = 0;
+        LogError("Invalid arguments: CONSTBUFFER_HANDLE constbufferHandle=%p, uint64_t* fingerprint=%p", constbufferHandle, fingerprint);
+        result = MU_FAILURE;
     }
     else
     {
-        /*Codes_SRS_CONSTBUFFER_02_042: [ If sizeof(uint8_t) + sizeof(uint32_t) + source's size exceed UINT32_MAX then CONSTBUFFER_get_serialization_size shall fail and return 0. ]*/
-        if (source->alias.size > UINT32_MAX - CONSTBUFFER_VERSION_SIZE - CONSTBUFFER_SIZE_SIZE)
+#ifdef CONSTBUFFER_FINGERPRINT_CACHE
+        int64_t cached_fingerprint = interlocked_add_64(&constbufferHandle->fingerprint, 0);
+        if (cached_fingerprint != CONSTBUFFER_FINGERPRINT_UNKNOWN)
         {
-            LogError("serialization size exceeds UINT32_MAX=%" PRIu32 ". It is the sum of sizeof(uint8_t)=%zu + sizeof(uint32_t)=%zu + source->alias.size=%" PRIu32 "",
-                UINT32_MAX, CONSTBUFFER_VERSION_SIZE, CONSTBUFFER_SIZE_SIZE, source->alias.size);
+            /*Codes_SRS_CONSTBUFFER_12_120: [ If CONSTBUFFER_FINGERPRINT_CACHE is defined and the fingerprint of constbufferHandle is already known then CONSTBUFFER_GetFingerprint shall write it in fingerprint and return 0. ]*/
+            *fingerprint = (uint64_t)cached_fingerprint;
             result = 0;
         }
         else
+#endif
         {
-            /*Codes_SRS_CONSTBUFFER_02_043: [ Otherwise CONSTBUFFER_get_serialization_size shall succeed and return sizeof(uint8_t) + sizeof(uint32_t) + source's size. ]*/
-            result = CONSTBUFFER_VERSION_SIZE + CONSTBUFFER_SIZE_SIZE + (uint32_t)source->alias.size;
+            uint64_t computed_fingerprint;
+
+            /*Codes_SRS_CONSTBUFFER_12_121: [ Otherwise CONSTBUFFER_GetFingerprint shall compute the fingerprint by calling hash_compute_hash_64 with the content. ]*/
+            if (hash_compute_hash_64(constbufferHandle->alias.buffer, constbufferHandle->alias.size, &computed_fingerprint) != 0)
+            {
+                /*Codes_SRS_CONSTBUFFER_12_124: [ If hash_compute_hash_64 fails then CONSTBUFFER_GetFingerprint shall fail and return a non-zero value. ]*/
+                LogError("failure in hash_compute_hash_64(constbufferHandle->alias.buffer=%p, constbufferHandle->alias.size=%" PRIu32 ", &computed_fingerprint=%p)",
+                    constbufferHandle->alias.buffer, constbufferHandle->alias.size, &computed_fingerprint);
+                result = MU_FAILURE;
+            }
+            else
+            {
+#ifdef CONSTBUFFER_FINGERPRINT_CACHE
+                /*Codes_SRS_CONSTBUFFER_12_122: [ If CONSTBUFFER_FINGERPRINT_CACHE is defined then CONSTBUFFER_GetFingerprint shall store the fingerprint in constbufferHandle (so that subsequent calls and CONSTBUFFER_HANDLE_contain_same do not read the content again). ]*/
+                (void)interlocked_exchange_64(&constbufferHandle->fingerprint, (int64_t)computed_fingerprint);
+#endif
+
+                /*Codes_SRS_CONSTBUFFER_12_123: [ CONSTBUFFER_GetFingerprint shall write the fingerprint in fingerprint and return 0. ]*/
+                *fingerprint = computed_fingerprint;
+                result = 0;
+            }
         }
     }
     return result;
 }
 
+uint32_t CONSTBUFFER_get_serialization_size(CONSTBUFFER_HANDLE source)
+{
+    uint32_t result;
+    /*Codes_SRS_CONSTBUFFER_02_041: [ If source is NULL then CONSTBUFFER_get_serialization_size shall fail and return 0. ]*/
+    if (source == NULL)
+    {
+        LogError("invalid argument CONSTBUFFER_HANDLE source=%p", source);
+        result = 0;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_02_042: [ If sizeof(uint8_t) + sizeof(uint32_t) + source's size exceed UINT32_MAX then CONSTBUFFER_get_serialization_size shall fail and return 0. ]*/
+        if (source->alias.size > UINT32_MAX - CONSTBUFFER_VERSION_SIZE - CONSTBUFFER_SIZE_SIZE)
+        {
+            LogError("serialization size exceeds UINT32_MAX=%" PRIu32 ". It is the sum of sizeof(uint8_t)=%zu + sizeof(uint32_t)=%zu + source->alias.size=%" PRIu32 "",
+                UINT32_MAX, CONSTBUFFER_VERSION_SIZE, CONSTBUFFER_SIZE_SIZE, source->alias.size);
+            result = 0;
+        }
+        else
+        {
+            /*Codes_SRS_CONSTBUFFER_02_043: [ Otherwise CONSTBUFFER_get_serialization_size shall succeed and return sizeof(uint8_t) + sizeof(uint32_t) + source's size. ]*/
+            result = CONSTBUFFER_VERSION_SIZE + CONSTBUFFER_SIZE_SIZE + (uint32_t)source->alias.size;
+        }
+    }
+    return result;
+}
+
+uint32_t CONSTBUFFER_get_serialization_size_v2(CONSTBUFFER_HANDLE source)
+{
+    uint32_t result;
+    if (source == NULL)
+    {
+        /*Codes_SRS_CONSTBUFFER_12_076: [ If source is NULL then CONSTBUFFER_get_serialization_size_v2 shall fail and return 0. ]*/
+        LogError("invalid argument CONSTBUFFER_HANDLE source=%p", source);
+        result = 0;
+    }
+    else if (source->alias.size > UINT32_MAX - CONSTBUFFER_V2_CONTENT_OFFSET)
+    {
+        /*Codes_SRS_CONSTBUFFER_12_077: [ If sizeof(uint8_t) + sizeof(uint32_t) + sizeof(uint32_t) + source's size exceed UINT32_MAX then CONSTBUFFER_get_serialization_size_v2 shall fail and return 0. ]*/
+        LogError("serialization size exceeds UINT32_MAX=%" PRIu32 ". It is the sum of CONSTBUFFER_V2_CONTENT_OFFSET=%zu + source->alias.size=%" PRIu32 "",
+            UINT32_MAX, CONSTBUFFER_V2_CONTENT_OFFSET, source->alias.size);
+        result = 0;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_12_078: [ Otherwise CONSTBUFFER_get_serialization_size_v2 shall succeed and return sizeof(uint8_t) + sizeof(uint32_t) + sizeof(uint32_t) + source's size. ]*/
+        result = (uint32_t)CONSTBUFFER_V2_CONTENT_OFFSET + source->alias.size;
+    }
+    return result;
+}
+
 static void* calls_malloc(size_t size, void* context)
 {
     (void)context;
@@ -532,6 +1151,69 @@ unsigned char* CONSTBUFFER_to_buffer(CONSTBUFFER_HANDLE source, CONSTBUFFER_to_b
     return result;
 }
 
+unsigned char* CONSTBUFFER_to_buffer_v2(CONSTBUFFER_HANDLE source, CONSTBUFFER_to_buffer_alloc alloc, void* alloc_context, uint32_t* serialized_size)
+{
+    unsigned char* result;
+    if (
+        /*Codes_SRS_CONSTBUFFER_12_056: [ If source is NULL then CONSTBUFFER_to_buffer_v2 shall fail and return NULL. ]*/
+        (source == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_12_057: [ If serialized_size is NULL then CONSTBUFFER_to_buffer_v2 shall fail and return NULL. ]*/
+        (serialized_size == NULL)
+        )
+    {
+        LogError("invalid arguments CONSTBUFFER_HANDLE source=%p, CONSTBUFFER_to_buffer_alloc alloc=%p, uint32_t* serialized_size=%p",
+            source, alloc, serialized_size);
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_12_058: [ If alloc is NULL then CONSTBUFFER_to_buffer_v2 shall use malloc as provided by gballoc_hl_redirect.h. ]*/
+        if (alloc == NULL)
+        {
+            alloc = &calls_malloc;
+        }
+
+        if (UINT32_MAX - CONSTBUFFER_V2_CONTENT_OFFSET < source->alias.size)
+        {
+            /*Codes_SRS_CONSTBUFFER_12_065: [ If there are any failures then CONSTBUFFER_to_buffer_v2 shall fail and return NULL. ]*/
+            LogError("serialization size exceeds UINT32_MAX=%" PRIu32 ". Serialization size is the sum of CONSTBUFFER_V2_CONTENT_OFFSET=%zu + source->alias.size=%" PRIu32 "",
+                UINT32_MAX, CONSTBUFFER_V2_CONTENT_OFFSET, source->alias.size);
+            result = NULL;
+        }
+        else
+        {
+            /*Codes_SRS_CONSTBUFFER_12_059: [ CONSTBUFFER_to_buffer_v2 shall allocate memory using alloc for holding the complete serialization. ]*/
+            result = alloc(CONSTBUFFER_V2_CONTENT_OFFSET + source->alias.size, alloc_context);
+            if (result == NULL)
+            {
+                /*Codes_SRS_CONSTBUFFER_12_065: [ If there are any failures then CONSTBUFFER_to_buffer_v2 shall fail and return NULL. ]*/
+                LogError("failure in alloc=%p, (CONSTBUFFER_V2_CONTENT_OFFSET=%zu + source->alias.size=%" PRIu32 " alloc_context=%p);",
+                    alloc, CONSTBUFFER_V2_CONTENT_OFFSET, source->alias.size, alloc_context);
+                /*return as is*/
+            }
+            else
+            {
+                /*Codes_SRS_CONSTBUFFER_12_060: [ CONSTBUFFER_to_buffer_v2 shall write at offset 0 of the allocated memory the version of the serialization (2). ]*/
+                write_uint8_t(result + CONSTBUFFER_VERSION_OFFSET, CONSTBUFFER_VERSION_V2);
+
+                /*Codes_SRS_CONSTBUFFER_12_061: [ CONSTBUFFER_to_buffer_v2 shall write at offsets 1-4 of the allocated memory the value of source->alias.size in network byte order. ]*/
+                write_uint32_t(result + CONSTBUFFER_SIZE_OFFSET, source->alias.size);
+
+                /*Codes_SRS_CONSTBUFFER_12_062: [ CONSTBUFFER_to_buffer_v2 shall call crc32c_copy to write starting at offset 9 of the allocated memory the bytes of source->alias.buffer and compute their CRC32C in the same pass. ]*/
+                uint32_t crc = crc32c_copy(0, result + CONSTBUFFER_V2_CONTENT_OFFSET, source->alias.buffer, source->alias.size);
+
+                /*Codes_SRS_CONSTBUFFER_12_063: [ CONSTBUFFER_to_buffer_v2 shall write at offsets 5-8 of the allocated memory the CRC32C in network byte order. ]*/
+                write_uint32_t(result + CONSTBUFFER_CRC32C_OFFSET, crc);
+
+                /*Codes_SRS_CONSTBUFFER_12_064: [ CONSTBUFFER_to_buffer_v2 shall succeed, write in serialized_size the size of the serialization and return the allocated memory. ]*/
+                *serialized_size = (uint32_t)CONSTBUFFER_V2_CONTENT_OFFSET + source->alias.size;
+                /*return as is*/
+            }
+        }
+    }
+    return result;
+}
+
 CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT CONSTBUFFER_to_fixed_size_buffer(CONSTBUFFER_HANDLE source, unsigned char* destination, uint32_t destination_size, uint32_t* serialized_size)
 {
     CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT result;
@@ -587,6 +1269,59 @@ CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT CONSTBUFFER_to_fixed_size_buffer(CONSTBU
     return result;
 }
 
+CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT CONSTBUFFER_to_fixed_size_buffer_v2(CONSTBUFFER_HANDLE source, unsigned char* destination, uint32_t destination_size, uint32_t* serialized_size)
+{
+    CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT result;
+
+    if (
+        /*Codes_SRS_CONSTBUFFER_12_066: [ If source is NULL then CONSTBUFFER_to_fixed_size_buffer_v2 shall fail and return CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INVALID_ARG. ]*/
+        (source == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_12_067: [ If destination is NULL then CONSTBUFFER_to_fixed_size_buffer_v2 shall fail and return CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INVALID_ARG. ]*/
+        (destination == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_12_068: [ If serialized_size is NULL then CONSTBUFFER_to_fixed_size_buffer_v2 shall fail and return CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INVALID_ARG. ]*/
+        (serialized_size == NULL)
+        )
+    {
+        LogError("invalid arguments CONSTBUFFER_HANDLE source=%p, unsigned char* destination=%p, uint32_t destination_size=%" PRIu32 ", uint32_t* serialized_size=%p",
+            source, destination, destination_size, serialized_size);
+        result = CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INVALID_ARG;
+    }
+    else if (UINT32_MAX - CONSTBUFFER_V2_CONTENT_OFFSET < source->alias.size)
+    {
+        /*Codes_SRS_CONSTBUFFER_12_075: [ If there are any failures then CONSTBUFFER_to_fixed_size_buffer_v2 shall fail and return CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_ERROR. ]*/
+        LogError("overflow in computation of output parameter serialized_size");
+        result = CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_ERROR;
+    }
+    else
+    {
+        *serialized_size = (uint32_t)CONSTBUFFER_V2_CONTENT_OFFSET + source->alias.size;
+        if (destination_size < *serialized_size)
+        {
+            /*Codes_SRS_CONSTBUFFER_12_069: [ If the size of serialization exceeds destination_size then CONSTBUFFER_to_fixed_size_buffer_v2 shall fail, write in serialized_size how much it would need and return CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INSUFFICIENT_BUFFER. ]*/
+            LogError("destination=%p does not contain enough bytes for the complete serialization. It only has %" PRIu32 " bytes and there are needed %" PRIu32 " bytes", destination, destination_size, *serialized_size);
+            result = CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INSUFFICIENT_BUFFER;
+        }
+        else
+        {
+            /*Codes_SRS_CONSTBUFFER_12_070: [ CONSTBUFFER_to_fixed_size_buffer_v2 shall write at offset 0 of destination the version of serialization (2). ]*/
+            write_uint8_t(destination + CONSTBUFFER_VERSION_OFFSET, CONSTBUFFER_VERSION_V2);
+
+            /*Codes_SRS_CONSTBUFFER_12_071: [ CONSTBUFFER_to_fixed_size_buffer_v2 shall write at offset 1 of destination the value of source->alias.size in network byte order. ]*/
+            write_uint32_t(destination + CONSTBUFFER_SIZE_OFFSET, source->alias.size);
+
+            /*Codes_SRS_CONSTBUFFER_12_072: [ CONSTBUFFER_to_fixed_size_buffer_v2 shall call crc32c_copy to copy all the bytes of source->alias.buffer in destination starting at offset 9 and compute their CRC32C in the same pass. ]*/
+            uint32_t crc = crc32c_copy(0, destination + CONSTBUFFER_V2_CONTENT_OFFSET, source->alias.buffer, source->alias.size);
+
+            /*Codes_SRS_CONSTBUFFER_12_073: [ CONSTBUFFER_to_fixed_size_buffer_v2 shall write at offset 5 of destination the CRC32C in network byte order. ]*/
+            write_uint32_t(destination + CONSTBUFFER_CRC32C_OFFSET, crc);
+
+            /*Codes_SRS_CONSTBUFFER_12_074: [ CONSTBUFFER_to_fixed_size_buffer_v2 shall succeed, write in serialized_size how much it used and return CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_OK. ]*/
+            result = CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_OK;
+        }
+    }
+    return result;
+}
+
 CONSTBUFFER_FROM_BUFFER_RESULT CONSTBUFFER_from_buffer(const unsigned char* source, uint32_t size, uint32_t* consumed, CONSTBUFFER_HANDLE* destination)
 {
     CONSTBUFFER_FROM_BUFFER_RESULT result;
@@ -615,18 +1350,23 @@ CONSTBUFFER_FROM_BUFFER_RESULT CONSTBUFFER_from_buffer(const unsigned char* sour
         {
             uint8_t version;
             read_uint8_t(source + CONSTBUFFER_VERSION_OFFSET, &version);
-            if (version != CONSTBUFFER_VERSION_V1)
+            if (
+                (version != CONSTBUFFER_VERSION_V1) &&
+                (version != CONSTBUFFER_VERSION_V2)
+                )
             {
-                /*Codes_SRS_CONSTBUFFER_02_067: [ If source byte at offset 0 is not 1 (current version) then CONSTBUFFER_from_buffer shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
-                LogError("different version (%" PRIu8 ") detected. This module only knows about version %" PRIu8 "", version, CONSTBUFFER_VERSION_V1);
+                /*Codes_SRS_CONSTBUFFER_02_067: [ If source byte at offset 0 is not 1 or 2 (the known versions) then CONSTBUFFER_from_buffer shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
+                LogError("different version (%" PRIu8 ") detected. This module only knows about versions %" PRIu8 " and %" PRIu8 "", version, CONSTBUFFER_VERSION_V1, CONSTBUFFER_VERSION_V2);
                 result = CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA;
             }
             else
             {
+                uint32_t header_size = (version == CONSTBUFFER_VERSION_V1) ? (uint32_t)CONSTBUFFER_CONTENT_OFFSET : (uint32_t)CONSTBUFFER_V2_CONTENT_OFFSET;
                 /*Codes_SRS_CONSTBUFFER_02_068: [ If source's size is less than sizeof(uint8_t) + sizeof(uint32_t) then CONSTBUFFER_from_buffer shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
-                if (size < CONSTBUFFER_VERSION_SIZE + CONSTBUFFER_SIZE_SIZE)
+                /*Codes_SRS_CONSTBUFFER_12_079: [ If the version is 2 and source's size is less than sizeof(uint8_t) + sizeof(uint32_t) + sizeof(uint32_t) then CONSTBUFFER_from_buffer shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
+                if (size < header_size)
                 {
-                    LogError("cannot deserialize when the numbe of serialized bytes cannot be determined. size=%" PRIu32 "", size);
+                    LogError("cannot deserialize when the number of serialized bytes cannot be determined. size=%" PRIu32 ", version=%" PRIu8 "", size, version);
                     result = CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA;
                 }
                 else
@@ -635,13 +1375,14 @@ CONSTBUFFER_FROM_BUFFER_RESULT CONSTBUFFER_from_buffer(const unsigned char* sour
                     uint32_t content_size;
                     read_uint32_t(source + CONSTBUFFER_SIZE_OFFSET, &content_size);
                     /*Codes_SRS_CONSTBUFFER_02_070: [ If source's size is less than sizeof(uint8_t) + sizeof(uint32_t) + number of content bytes then CONSTBUFFER_from_buffer shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
-                    if (size - (CONSTBUFFER_VERSION_SIZE + CONSTBUFFER_SIZE_SIZE) < content_size)
+                    /*Codes_SRS_CONSTBUFFER_12_081: [ If the version is 2 and source's size is less than sizeof(uint8_t) + sizeof(uint32_t) + sizeof(uint32_t) + number of content bytes then CONSTBUFFER_from_buffer shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
+                    if (size - header_size < content_size)
                     {
-                        LogError("in the buffer at source=%p of size=%" PRIu32 " there are not enough bytes remaining after version and size to construct content from. Serialized content size was computed as %" PRIu32 " but there are only %" PRIu32 " bytes available",
-                            source, size, content_size, (uint32_t)(size - CONSTBUFFER_VERSION_SIZE + CONSTBUFFER_SIZE_SIZE));
+                        LogError("in the buffer at source=%p of size=%" PRIu32 " there are not enough bytes remaining after the header (%" PRIu32 " bytes) to construct content from. Serialized content size was computed as %" PRIu32 " but there are only %" PRIu32 " bytes available",
+                            source, size, header_size, content_size, size - header_size);
                         result = CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA;
                     }
-                    else
+                    else if (version == CONSTBUFFER_VERSION_V1)
                     {
                         /*Codes_SRS_CONSTBUFFER_02_071: [ CONSTBUFFER_from_buffer shall create a CONSTBUFFER_HANDLE from the bytes at offset 5 of source. ]*/
                         *destination = CONSTBUFFER_Create_Internal(source + CONSTBUFFER_CONTENT_OFFSET, content_size);
@@ -659,6 +1400,39 @@ CONSTBUFFER_FROM_BUFFER_RESULT CONSTBUFFER_from_buffer(const unsigned char* sour
                             result = CONSTBUFFER_FROM_BUFFER_RESULT_OK;
                         }
                     }
+                    else
+                    {
+                        /*Codes_SRS_CONSTBUFFER_12_080: [ If the version is 2 then CONSTBUFFER_from_buffer shall read the CRC32C of the content from offset 5 of source. ]*/
+                        uint32_t expected_crc;
+                        read_uint32_t(source + CONSTBUFFER_CRC32C_OFFSET, &expected_crc);
+
+                        /*Codes_SRS_CONSTBUFFER_12_082: [ If the version is 2 then CONSTBUFFER_from_buffer shall create a CONSTBUFFER_HANDLE from the bytes at offset 9 of source, computing their CRC32C with crc32c_copy in the same pass as the copy. ]*/
+                        uint32_t crc;
+                        CONSTBUFFER_HANDLE temp = constbuffer_create_with_crc32c(source + CONSTBUFFER_V2_CONTENT_OFFSET, content_size, &crc);
+                        if (temp == NULL)
+                        {
+                            /*Codes_SRS_CONSTBUFFER_02_073: [ If there are any failures then shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_ERROR. ]*/
+                            LogError("failure in constbuffer_create_with_crc32c(source=%p + CONSTBUFFER_V2_CONTENT_OFFSET=%zu, content_size=%" PRIu32 ", &crc=%p)",
+                                source, CONSTBUFFER_V2_CONTENT_OFFSET, content_size, &crc);
+                            result = CONSTBUFFER_FROM_BUFFER_RESULT_ERROR;
+                        }
+                        else if (crc != expected_crc)
+                        {
+                            /*Codes_SRS_CONSTBUFFER_12_083: [ If the version is 2 and the computed CRC32C is different than the serialized CRC32C then CONSTBUFFER_from_buffer shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
+                            LogError("CRC32C mismatch in the buffer at source=%p: serialized 0x%08" PRIX32 ", computed 0x%08" PRIX32 " over %" PRIu32 " bytes",
+                                source, expected_crc, crc, content_size);
+                            free(temp);
+                            result = CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA;
+                        }
+                        else
+                        {
+                            /*Codes_SRS_CONSTBUFFER_02_072: [ CONSTBUFFER_from_buffer shall succeed, write in consumed the total number of consumed bytes from source, write in destination the constructed CONSTBUFFER_HANDLE and return CONSTBUFFER_FROM_BUFFER_RESULT_OK. ]*/
+                            CONSTBUFFER_ACCOUNT_CREATED(temp);
+                            *destination = temp;
+                            *consumed = header_size + content_size;
+                            result = CONSTBUFFER_FROM_BUFFER_RESULT_OK;
+                        }
+                    }
                 }
             }
         }
@@ -666,6 +1440,470 @@ CONSTBUFFER_FROM_BUFFER_RESULT CONSTBUFFER_from_buffer(const unsigned char* sour
     return result;
 }
 
+/*validates the serialized const buffer that starts at source (version, size, CRC32C for version 2, content) and produces the size of its header and the number of content bytes*/
+static CONSTBUFFER_FROM_BUFFER_RESULT constbuffer_read_serialized_header(const unsigned char* source, uint32_t size, uint32_t* header_size, uint32_t* content_size)
+{
+    CONSTBUFFER_FROM_BUFFER_RESULT result;
+    uint8_t version;
+    read_uint8_t(source + CONSTBUFFER_VERSION_OFFSET, &version);
+    if (
+        (version != CONSTBUFFER_VERSION_V1) &&
+        (version != CONSTBUFFER_VERSION_V2)
+        )
+    {
+        LogError("different version (%" PRIu8 ") detected. This module only knows about versions %" PRIu8 " and %" PRIu8 "", version, CONSTBUFFER_VERSION_V1, CONSTBUFFER_VERSION_V2);
+        result = CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA;
+    }
+    else
+    {
+        *header_size = (version == CONSTBUFFER_VERSION_V1) ? (uint32_t)CONSTBUFFER_CONTENT_OFFSET : (uint32_t)CONSTBUFFER_V2_CONTENT_OFFSET;
+        if (size < *header_size)
+        {
+            LogError("cannot deserialize when the number of serialized bytes cannot be determined. size=%" PRIu32 ", version=%" PRIu8 "", size, version);
+            result = CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA;
+        }
+        else
+        {
+            read_uint32_t(source + CONSTBUFFER_SIZE_OFFSET, content_size);
+            if (size - *header_size < *content_size)
+            {
+                LogError("in the buffer at source=%p of size=%" PRIu32 " there are not enough bytes remaining after the header to construct content from. Serialized content size was computed as %" PRIu32 "",
+                    source, size, *content_size);
+                result = CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA;
+            }
+            else if (version == CONSTBUFFER_VERSION_V1)
+            {
+                result = CONSTBUFFER_FROM_BUFFER_RESULT_OK;
+            }
+            else
+            {
+                /*nothing is copied here, so checking the CRC32C is a pass of its own*/
+                uint32_t expected_crc;
+                read_uint32_t(source + CONSTBUFFER_CRC32C_OFFSET, &expected_crc);
+                uint32_t crc = crc32c_compute(0, source + CONSTBUFFER_V2_CONTENT_OFFSET, *content_size);
+                if (crc != expected_crc)
+                {
+                    LogError("CRC32C mismatch in the buffer at source=%p: serialized 0x%08" PRIX32 ", computed 0x%08" PRIX32 " over %" PRIu32 " bytes",
+                        source, expected_crc, crc, *content_size);
+                    result = CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA;
+                }
+                else
+                {
+                    result = CONSTBUFFER_FROM_BUFFER_RESULT_OK;
+                }
+            }
+        }
+    }
+    return result;
+}
+
+CONSTBUFFER_FROM_BUFFER_RESULT CONSTBUFFER_from_buffer_view(CONSTBUFFER_HANDLE source, uint32_t offset, uint32_t* consumed, CONSTBUFFER_HANDLE* destination)
+{
+    CONSTBUFFER_FROM_BUFFER_RESULT result;
+    if (
+        /*Codes_SRS_CONSTBUFFER_12_034: [ If source is NULL then CONSTBUFFER_from_buffer_view shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
+        (source == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_12_035: [ If consumed is NULL then CONSTBUFFER_from_buffer_view shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
+        (consumed == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_12_036: [ If destination is NULL then CONSTBUFFER_from_buffer_view shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
+        (destination == NULL)
+        )
+    {
+        LogError("invalid arguments CONSTBUFFER_HANDLE source=%p, uint32_t offset=%" PRIu32 ", uint32_t* consumed=%p, CONSTBUFFER_HANDLE* destination=%p",
+            source, offset, consumed, destination);
+        result = CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG;
+    }
+    else if (offset >= source->alias.size)
+    {
+        /*Codes_SRS_CONSTBUFFER_12_037: [ If offset is greater than or equal to the size of source then CONSTBUFFER_from_buffer_view shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
+        LogError("cannot deserialize from offset=%" PRIu32 " of source=%p which has size=%" PRIu32 "", offset, source, source->alias.size);
+        result = CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG;
+    }
+    else
+    {
+        uint32_t header_size;
+        uint32_t content_size;
+        const unsigned char* serialized = source->alias.buffer + offset;
+        /*Codes_SRS_CONSTBUFFER_12_038: [ If the bytes of source starting at offset are not a valid serialized const buffer (unknown version, not enough bytes for the header or for the content, CRC32C mismatch for version 2) then CONSTBUFFER_from_buffer_view shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
+        result = constbuffer_read_serialized_header(serialized, source->alias.size - offset, &header_size, &content_size);
+        if (result != CONSTBUFFER_FROM_BUFFER_RESULT_OK)
+        {
+            LogError("failure in constbuffer_read_serialized_header(serialized=%p, size=%" PRIu32 ", &header_size=%p, &content_size=%p)",
+                serialized, source->alias.size - offset, &header_size, &content_size);
+            /*return as is*/
+        }
+        else
+        {
+            /*Codes_SRS_CONSTBUFFER_12_039: [ CONSTBUFFER_from_buffer_view shall allocate a CONSTBUFFER_HANDLE whose content is the serialized content inside source (no bytes are copied) and shall increment the reference count of source. ]*/
+            CONSTBUFFER_HANDLE_FROM_OFFSET_AND_SIZE_DATA* view = malloc(sizeof(CONSTBUFFER_HANDLE_FROM_OFFSET_AND_SIZE_DATA));
+            if (view == NULL)
+            {
+                /*Codes_SRS_CONSTBUFFER_12_041: [ If there are any failures then CONSTBUFFER_from_buffer_view shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_ERROR. ]*/
+                LogError("failure in malloc(sizeof(CONSTBUFFER_HANDLE_FROM_OFFSET_AND_SIZE_DATA)=%zu)", sizeof(CONSTBUFFER_HANDLE_FROM_OFFSET_AND_SIZE_DATA));
+                result = CONSTBUFFER_FROM_BUFFER_RESULT_ERROR;
+            }
+            else
+            {
+                view->buffer_type = CONSTBUFFER_TYPE_FROM_OFFSET_AND_SIZE;
+                view->alias.buffer = serialized + header_size;
+                view->alias.size = content_size;
+                constbuffer_inc_ref(source);
+                view->originalHandle = source;
+                (void)interlocked_exchange(&view->count, 1);
+                CONSTBUFFER_FINGERPRINT_INIT(view);
+                CONSTBUFFER_ACCOUNT_CREATED(view);
+
+                /*Codes_SRS_CONSTBUFFER_12_040: [ CONSTBUFFER_from_buffer_view shall succeed, write in consumed the total number of consumed bytes from source starting at offset, write in destination the constructed CONSTBUFFER_HANDLE and return CONSTBUFFER_FROM_BUFFER_RESULT_OK. ]*/
+                *destination = (CONSTBUFFER_HANDLE)view;
+                *consumed = header_size + content_size;
+            }
+        }
+    }
+    return result;
+}
+
+CONSTBUFFER_FROM_BUFFER_RESULT CONSTBUFFER_from_buffer_view_bulk(CONSTBUFFER_HANDLE source, uint32_t offset, uint32_t count, uint32_t* consumed, CONSTBUFFER_HANDLE* destinations)
+{
+    CONSTBUFFER_FROM_BUFFER_RESULT result;
+    if (
+        /*Codes_SRS_CONSTBUFFER_12_042: [ If source is NULL then CONSTBUFFER_from_buffer_view_bulk shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
+        (source == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_12_043: [ If count is 0 then CONSTBUFFER_from_buffer_view_bulk shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
+        (count == 0) ||
+        /*Codes_SRS_CONSTBUFFER_12_044: [ If consumed is NULL then CONSTBUFFER_from_buffer_view_bulk shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
+        (consumed == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_12_045: [ If destinations is NULL then CONSTBUFFER_from_buffer_view_bulk shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
+        (destinations == NULL)
+        )
+    {
+        LogError("invalid arguments CONSTBUFFER_HANDLE source=%p, uint32_t offset=%" PRIu32 ", uint32_t count=%" PRIu32 ", uint32_t* consumed=%p, CONSTBUFFER_HANDLE* destinations=%p",
+            source, offset, count, consumed, destinations);
+        result = CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG;
+    }
+    else if (offset >= source->alias.size)
+    {
+        /*Codes_SRS_CONSTBUFFER_12_046: [ If offset is greater than or equal to the size of source then CONSTBUFFER_from_buffer_view_bulk shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
+        LogError("cannot deserialize from offset=%" PRIu32 " of source=%p which has size=%" PRIu32 "", offset, source, source->alias.size);
+        result = CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_12_047: [ CONSTBUFFER_from_buffer_view_bulk shall validate count serialized const buffers that follow each other in source starting at offset. If any of them is not valid then CONSTBUFFER_from_buffer_view_bulk shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
+        uint32_t position = offset;
+        uint32_t i;
+        result = CONSTBUFFER_FROM_BUFFER_RESULT_OK;
+        for (i = 0; i < count; i++)
+        {
+            uint32_t header_size;
+            uint32_t content_size;
+            if (position >= source->alias.size)
+            {
+                LogError("source=%p of size=%" PRIu32 " ends after %" PRIu32 " of %" PRIu32 " serialized const buffers", source, source->alias.size, i, count);
+                result = CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA;
+                break;
+            }
+
+            result = constbuffer_read_serialized_header(source->alias.buffer + position, source->alias.size - position, &header_size, &content_size);
+            if (result != CONSTBUFFER_FROM_BUFFER_RESULT_OK)
+            {
+                LogError("serialized const buffer %" PRIu32 " of %" PRIu32 " at position=%" PRIu32 " in source=%p is not valid", i, count, position, source);
+                break;
+            }
+
+            position += header_size + content_size;
+        }
+
+        if (result != CONSTBUFFER_FROM_BUFFER_RESULT_OK)
+        {
+            /*return as is*/
+        }
+        else
+        {
+            /*Codes_SRS_CONSTBUFFER_12_048: [ CONSTBUFFER_from_buffer_view_bulk shall allocate one block of memory for all the count views. ]*/
+            CONSTBUFFER_HANDLE_FROM_BUFFER_BULK_DATA* block = malloc_flex(sizeof(CONSTBUFFER_HANDLE_FROM_BUFFER_BULK_DATA), count, sizeof(CONSTBUFFER_HANDLE_FROM_OFFSET_AND_SIZE_DATA));
+            if (block == NULL)
+            {
+                /*Codes_SRS_CONSTBUFFER_12_052: [ If there are any failures then CONSTBUFFER_from_buffer_view_bulk shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_ERROR. ]*/
+                LogError("failure in malloc_flex(sizeof(CONSTBUFFER_HANDLE_FROM_BUFFER_BULK_DATA)=%zu, count=%" PRIu32 ", sizeof(CONSTBUFFER_HANDLE_FROM_OFFSET_AND_SIZE_DATA)=%zu)",
+                    sizeof(CONSTBUFFER_HANDLE_FROM_BUFFER_BULK_DATA), count, sizeof(CONSTBUFFER_HANDLE_FROM_OFFSET_AND_SIZE_DATA));
+                result = CONSTBUFFER_FROM_BUFFER_RESULT_ERROR;
+            }
+            else
+            {
+                block->buffer_type = CONSTBUFFER_TYPE_FROM_OFFSET_AND_SIZE;
+                block->alias.buffer = source->alias.buffer + offset;
+                block->alias.size = position - offset;
+                /*Codes_SRS_CONSTBUFFER_12_049: [ CONSTBUFFER_from_buffer_view_bulk shall increment the reference count of source once for all the views. ]*/
+                constbuffer_inc_ref(source);
+                block->originalHandle = source;
+                (void)interlocked_exchange(&block->count, (int32_t)count);
+                CONSTBUFFER_FINGERPRINT_INIT(block);
+                /*the block is a live handle too (until its last view is released)*/
+                CONSTBUFFER_ACCOUNT_CREATED(block);
+
+                /*Codes_SRS_CONSTBUFFER_12_050: [ CONSTBUFFER_from_buffer_view_bulk shall write in destinations[i] a CONSTBUFFER_HANDLE (with the ref count set to 1) whose content is the content of the i-th serialized const buffer inside source (no bytes are copied). ]*/
+                position = offset;
+                for (i = 0; i < count; i++)
+                {
+                    /*all the headers were validated above, only the sizes are needed now*/
+                    uint8_t version;
+                    uint32_t content_size;
+                    read_uint8_t(source->alias.buffer + position + CONSTBUFFER_VERSION_OFFSET, &version);
+                    read_uint32_t(source->alias.buffer + position + CONSTBUFFER_SIZE_OFFSET, &content_size);
+                    uint32_t header_size = (version == CONSTBUFFER_VERSION_V1) ? (uint32_t)CONSTBUFFER_CONTENT_OFFSET : (uint32_t)CONSTBUFFER_V2_CONTENT_OFFSET;
+
+                    CONSTBUFFER_HANDLE_FROM_OFFSET_AND_SIZE_DATA* view = &block->views[i];
+                    view->buffer_type = CONSTBUFFER_TYPE_FROM_BUFFER_VIEW;
+                    view->alias.buffer = source->alias.buffer + position + header_size;
+                    view->alias.size = content_size;
+                    view->originalHandle = (CONSTBUFFER_HANDLE)block;
+                    (void)interlocked_exchange(&view->count, 1);
+                    CONSTBUFFER_FINGERPRINT_INIT(view);
+                    CONSTBUFFER_ACCOUNT_CREATED(view);
+                    destinations[i] = (CONSTBUFFER_HANDLE)view;
+
+                    position += header_size + content_size;
+                }
+
+                /*Codes_SRS_CONSTBUFFER_12_051: [ CONSTBUFFER_from_buffer_view_bulk shall succeed, write in consumed the total number of consumed bytes from source starting at offset and return CONSTBUFFER_FROM_BUFFER_RESULT_OK. ]*/
+                *consumed = position - offset;
+            }
+        }
+    }
+    return result;
+}
+
+CONSTBUFFER_HANDLE CONSTBUFFER_CreateCompressed(CONSTBUFFER_HANDLE source)
+{
+    CONSTBUFFER_HANDLE_COPIED_DATA* result;
+    if (source == NULL)
+    {
+        /*Codes_SRS_CONSTBUFFER_12_084: [ If source is NULL then CONSTBUFFER_CreateCompressed shall fail and return NULL. ]*/
+        LogError("invalid argument CONSTBUFFER_HANDLE source=%p", source);
+        result = NULL;
+    }
+    else
+    {
+        uint32_t bound = lz_codec_compress_bound(source->alias.size);
+        if (
+            (bound == 0) ||
+            (bound > UINT32_MAX - CONSTBUFFER_COMPRESSION_HEADER_SIZE)
+            )
+        {
+            /*Codes_SRS_CONSTBUFFER_12_085: [ If CONSTBUFFER_COMPRESSION_HEADER_SIZE + lz_codec_compress_bound(size of source) exceeds UINT32_MAX then CONSTBUFFER_CreateCompressed shall fail and return NULL. ]*/
+            LogError("cannot compress source->alias.size=%" PRIu32 " bytes, lz_codec_compress_bound returned %" PRIu32 "", source->alias.size, bound);
+            result = NULL;
+        }
+        else
+        {
+            /*Codes_SRS_CONSTBUFFER_12_086: [ CONSTBUFFER_CreateCompressed shall allocate memory for the CONSTBUFFER_HANDLE and CONSTBUFFER_COMPRESSION_HEADER_SIZE + lz_codec_compress_bound(size of source) bytes. ]*/
+            result = malloc_flex(sizeof(CONSTBUFFER_HANDLE_COPIED_DATA), CONSTBUFFER_COMPRESSION_HEADER_SIZE + bound, sizeof(unsigned char));
+            if (result == NULL)
+            {
+                /*Codes_SRS_CONSTBUFFER_12_092: [ If there are any failures then CONSTBUFFER_CreateCompressed shall fail and return NULL. ]*/
+                LogError("failure in malloc_flex(sizeof(CONSTBUFFER_HANDLE_COPIED_DATA)=%zu, CONSTBUFFER_COMPRESSION_HEADER_SIZE=%zu + bound=%" PRIu32 ", sizeof(unsigned char)=%zu)",
+                    sizeof(CONSTBUFFER_HANDLE_COPIED_DATA), CONSTBUFFER_COMPRESSION_HEADER_SIZE, bound, sizeof(unsigned char));
+                /*return as is*/
+            }
+            else
+            {
+                uint32_t payload_size;
+                uint8_t method;
+
+                /*Codes_SRS_CONSTBUFFER_12_087: [ CONSTBUFFER_CreateCompressed shall call lz_codec_compress to compress the content of source after the header. ]*/
+                if (lz_codec_compress(source->alias.buffer, source->alias.size, result->storage + CONSTBUFFER_COMPRESSED_PAYLOAD_OFFSET, bound, &payload_size) != 0)
+                {
+                    /*Codes_SRS_CONSTBUFFER_12_092: [ If there are any failures then CONSTBUFFER_CreateCompressed shall fail and return NULL. ]*/
+                    LogError("failure in lz_codec_compress(source->alias.buffer=%p, source->alias.size=%" PRIu32 ", result->storage + CONSTBUFFER_COMPRESSED_PAYLOAD_OFFSET=%p, bound=%" PRIu32 ", &payload_size=%p)",
+                        source->alias.buffer, source->alias.size, result->storage + CONSTBUFFER_COMPRESSED_PAYLOAD_OFFSET, bound, &payload_size);
+                    free(result);
+                    result = NULL;
+                }
+                else
+                {
+                    CONSTBUFFER_HANDLE_COPIED_DATA* shrunk;
+
+                    if (payload_size >= source->alias.size)
+                    {
+                        /*Codes_SRS_CONSTBUFFER_12_088: [ If the compressed content is not smaller than the content of source then CONSTBUFFER_CreateCompressed shall copy the content of source after the header instead and use CONSTBUFFER_COMPRESSION_METHOD_STORED as compression method. ]*/
+                        (void)memcpy(result->storage + CONSTBUFFER_COMPRESSED_PAYLOAD_OFFSET, source->alias.buffer, source->alias.size);
+                        payload_size = source->alias.size;
+                        method = CONSTBUFFER_COMPRESSION_METHOD_STORED;
+                    }
+                    else
+                    {
+                        method = CONSTBUFFER_COMPRESSION_METHOD_LZ;
+                    }
+
+                    /*Codes_SRS_CONSTBUFFER_12_089: [ CONSTBUFFER_CreateCompressed shall write at offset 0 the compression method and at offsets 1-4 the size of the content of source in network byte order. ]*/
+                    write_uint8_t(result->storage + CONSTBUFFER_COMPRESSION_METHOD_OFFSET, method);
+                    write_uint32_t(result->storage + CONSTBUFFER_UNCOMPRESSED_SIZE_OFFSET, source->alias.size);
+
+                    /*Codes_SRS_CONSTBUFFER_12_090: [ CONSTBUFFER_CreateCompressed shall call realloc_flex to give back the memory that was not used. If realloc_flex fails then CONSTBUFFER_CreateCompressed shall keep the memory allocated initially. ]*/
+                    shrunk = realloc_flex(result, sizeof(CONSTBUFFER_HANDLE_COPIED_DATA), CONSTBUFFER_COMPRESSION_HEADER_SIZE + payload_size, sizeof(unsigned char));
+                    if (shrunk == NULL)
+                    {
+                        LogWarning("failure in realloc_flex(result=%p, sizeof(CONSTBUFFER_HANDLE_COPIED_DATA)=%zu, CONSTBUFFER_COMPRESSION_HEADER_SIZE=%zu + payload_size=%" PRIu32 ", sizeof(unsigned char)=%zu), keeping bound=%" PRIu32 " bytes",
+                            result, sizeof(CONSTBUFFER_HANDLE_COPIED_DATA), CONSTBUFFER_COMPRESSION_HEADER_SIZE, payload_size, sizeof(unsigned char), bound);
+                    }
+                    else
+                    {
+                        result = shrunk;
+                    }
+
+                    /*Codes_SRS_CONSTBUFFER_12_091: [ CONSTBUFFER_CreateCompressed shall set the ref count of the produced CONSTBUFFER_HANDLE to 1, succeed and return it. ]*/
+                    (void)interlocked_exchange(&result->count, 1);
+                    CONSTBUFFER_FINGERPRINT_INIT(result);
+                    result->alias.buffer = result->storage;
+                    result->alias.size = (uint32_t)CONSTBUFFER_COMPRESSION_HEADER_SIZE + payload_size;
+                    result->buffer_type = CONSTBUFFER_TYPE_COPIED;
+                    CONSTBUFFER_ACCOUNT_CREATED(result);
+                }
+            }
+        }
+    }
+    return (CONSTBUFFER_HANDLE)result;
+}
+
+CONSTBUFFER_HANDLE CONSTBUFFER_Decompress(CONSTBUFFER_HANDLE compressed)
+{
+    CONSTBUFFER_HANDLE result;
+    if (
+        /*Codes_SRS_CONSTBUFFER_12_093: [ If compressed is NULL then CONSTBUFFER_Decompress shall fail and return NULL. ]*/
+        (compressed == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_12_094: [ If the size of compressed is less than CONSTBUFFER_COMPRESSION_HEADER_SIZE then CONSTBUFFER_Decompress shall fail and return NULL. ]*/
+        (compressed->alias.size < CONSTBUFFER_COMPRESSION_HEADER_SIZE)
+        )
+    {
+        LogError("invalid argument CONSTBUFFER_HANDLE compressed=%p, compressed->alias.size=%" PRIu32 "", compressed, (compressed == NULL) ? 0 : compressed->alias.size);
+        result = NULL;
+    }
+    else
+    {
+        uint8_t method;
+        uint32_t uncompressed_size;
+        uint32_t payload_size = compressed->alias.size - (uint32_t)CONSTBUFFER_COMPRESSION_HEADER_SIZE;
+        read_uint8_t(compressed->alias.buffer + CONSTBUFFER_COMPRESSION_METHOD_OFFSET, &method);
+        read_uint32_t(compressed->alias.buffer + CONSTBUFFER_UNCOMPRESSED_SIZE_OFFSET, &uncompressed_size);
+
+        switch (method)
+        {
+            case CONSTBUFFER_COMPRESSION_METHOD_STORED:
+            {
+                if (payload_size != uncompressed_size)
+                {
+                    /*Codes_SRS_CONSTBUFFER_12_095: [ If the compression method is CONSTBUFFER_COMPRESSION_METHOD_STORED and the size of the payload is not the uncompressed size then CONSTBUFFER_Decompress shall fail and return NULL. ]*/
+                    LogError("stored payload_size=%" PRIu32 " is not uncompressed_size=%" PRIu32 "", payload_size, uncompressed_size);
+                    result = NULL;
+                }
+                else
+                {
+                    /*Codes_SRS_CONSTBUFFER_12_096: [ If the compression method is CONSTBUFFER_COMPRESSION_METHOD_STORED then CONSTBUFFER_Decompress shall call CONSTBUFFER_CreateFromOffsetAndSize to produce a CONSTBUFFER_HANDLE that points to the payload of compressed (no bytes are copied). ]*/
+                    result = CONSTBUFFER_CreateFromOffsetAndSize(compressed, CONSTBUFFER_COMPRESSED_PAYLOAD_OFFSET, payload_size);
+                    if (result == NULL)
+                    {
+                        /*Codes_SRS_CONSTBUFFER_12_100: [ If there are any failures then CONSTBUFFER_Decompress shall fail and return NULL. ]*/
+                        LogError("failure in CONSTBUFFER_CreateFromOffsetAndSize(compressed=%p, CONSTBUFFER_COMPRESSED_PAYLOAD_OFFSET=%zu, payload_size=%" PRIu32 ")",
+                            compressed, CONSTBUFFER_COMPRESSED_PAYLOAD_OFFSET, payload_size);
+                        /*return as is*/
+                    }
+                }
+                break;
+            }
+            case CONSTBUFFER_COMPRESSION_METHOD_LZ:
+            {
+                /*Codes_SRS_CONSTBUFFER_12_097: [ If the compression method is CONSTBUFFER_COMPRESSION_METHOD_LZ then CONSTBUFFER_Decompress shall allocate memory for the CONSTBUFFER_HANDLE and the uncompressed size bytes. ]*/
+                CONSTBUFFER_HANDLE_COPIED_DATA* decompressed = malloc_flex(sizeof(CONSTBUFFER_HANDLE_COPIED_DATA), uncompressed_size, sizeof(unsigned char));
+                if (decompressed == NULL)
+                {
+                    /*Codes_SRS_CONSTBUFFER_12_100: [ If there are any failures then CONSTBUFFER_Decompress shall fail and return NULL. ]*/
+                    LogError("failure in malloc_flex(sizeof(CONSTBUFFER_HANDLE_COPIED_DATA)=%zu, uncompressed_size=%" PRIu32 ", sizeof(unsigned char)=%zu)",
+                        sizeof(CONSTBUFFER_HANDLE_COPIED_DATA), uncompressed_size, sizeof(unsigned char));
+                    result = NULL;
+                }
+                /*Codes_SRS_CONSTBUFFER_12_098: [ CONSTBUFFER_Decompress shall call lz_codec_decompress to decompress the payload. ]*/
+                else if (lz_codec_decompress(compressed->alias.buffer + CONSTBUFFER_COMPRESSED_PAYLOAD_OFFSET, payload_size, decompressed->storage, uncompressed_size) != 0)
+                {
+                    /*Codes_SRS_CONSTBUFFER_12_100: [ If there are any failures then CONSTBUFFER_Decompress shall fail and return NULL. ]*/
+                    LogError("failure in lz_codec_decompress(compressed->alias.buffer + CONSTBUFFER_COMPRESSED_PAYLOAD_OFFSET=%p, payload_size=%" PRIu32 ", decompressed->storage=%p, uncompressed_size=%" PRIu32 ")",
+                        compressed->alias.buffer + CONSTBUFFER_COMPRESSED_PAYLOAD_OFFSET, payload_size, decompressed->storage, uncompressed_size);
+                    free(decompressed);
+                    result = NULL;
+                }
+                else
+                {
+                    /*Codes_SRS_CONSTBUFFER_12_099: [ CONSTBUFFER_Decompress shall set the ref count of the produced CONSTBUFFER_HANDLE to 1, succeed and return it. ]*/
+                    (void)interlocked_exchange(&decompressed->count, 1);
+                    CONSTBUFFER_FINGERPRINT_INIT(decompressed);
+                    decompressed->alias.buffer = (uncompressed_size == 0) ? NULL : decompressed->storage;
+                    decompressed->alias.size = uncompressed_size;
+                    decompressed->buffer_type = CONSTBUFFER_TYPE_COPIED;
+                    CONSTBUFFER_ACCOUNT_CREATED(decompressed);
+                    result = (CONSTBUFFER_HANDLE)decompressed;
+                }
+                break;
+            }
+            default:
+            {
+                /*Codes_SRS_CONSTBUFFER_12_101: [ If the compression method is unknown then CONSTBUFFER_Decompress shall fail and return NULL. ]*/
+                LogError("unknown compression method=%" PRIu8 "", method);
+                result = NULL;
+                break;
+            }
+        }
+    }
+    return result;
+}
+
+CONSTBUFFER_HANDLE CONSTBUFFER_CreateSharedHot(CONSTBUFFER_HANDLE source, uint32_t slot_count)
+{
+    CONSTBUFFER_HANDLE_SHARED_HOT_DATA* result;
+
+    if (
+        /*Codes_SRS_CONSTBUFFER_12_102: [ If source is NULL then CONSTBUFFER_CreateSharedHot shall fail and return NULL. ]*/
+        (source == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_12_103: [ If slot_count is 0 or greater than CONSTBUFFER_SHARED_HOT_MAX_SLOT_COUNT then CONSTBUFFER_CreateSharedHot shall fail and return NULL. ]*/
+        (slot_count == 0) ||
+        (slot_count > CONSTBUFFER_SHARED_HOT_MAX_SLOT_COUNT)
+        )
+    {
+        LogError("Invalid arguments: CONSTBUFFER_HANDLE source=%p, uint32_t slot_count=%" PRIu32 "",
+            source, slot_count);
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_12_104: [ CONSTBUFFER_CreateSharedHot shall allocate memory for the CONSTBUFFER_HANDLE and slot_count reference count slots, each in its own cache line. ]*/
+        result = malloc_flex(sizeof(CONSTBUFFER_HANDLE_SHARED_HOT_DATA), slot_count, sizeof(CONSTBUFFER_SHARED_HOT_SLOT));
+        if (result == NULL)
+        {
+            /*Codes_SRS_CONSTBUFFER_12_106: [ If there are any failures then CONSTBUFFER_CreateSharedHot shall fail and return NULL. ]*/
+            LogError("failure in malloc_flex(sizeof(CONSTBUFFER_HANDLE_SHARED_HOT_DATA)=%zu, slot_count=%" PRIu32 ", sizeof(CONSTBUFFER_SHARED_HOT_SLOT)=%zu)",
+                sizeof(CONSTBUFFER_HANDLE_SHARED_HOT_DATA), slot_count, sizeof(CONSTBUFFER_SHARED_HOT_SLOT));
+            /*return as is*/
+        }
+        else
+        {
+            for (uint32_t i = 0; i < slot_count; i++)
+            {
+                (void)interlocked_exchange(&result->slots[i].count, 0);
+            }
+            (void)interlocked_exchange(&result->is_merged, 0);
+            result->slot_count = slot_count;
+
+            /*Codes_SRS_CONSTBUFFER_12_105: [ CONSTBUFFER_CreateSharedHot shall increment the reference count of source and produce a CONSTBUFFER_HANDLE with the same content as source (no bytes are copied), with the ref count set to 1. ]*/
+            constbuffer_inc_ref(source);
+            result->originalHandle = source;
+            result->alias = source->alias;
+            result->buffer_type = CONSTBUFFER_TYPE_SHARED_HOT;
+            (void)interlocked_exchange(&result->count, 1);
+            CONSTBUFFER_FINGERPRINT_INIT(result);
+            CONSTBUFFER_ACCOUNT_CREATED(result);
+        }
+    }
+    return (CONSTBUFFER_HANDLE)result;
+}
+
 CONSTBUFFER_WRITABLE_HANDLE CONSTBUFFER_CreateWritableHandle(uint32_t size)
 {
     CONSTBUFFER_WRITABLE_HANDLE result;
@@ -692,9 +1930,11 @@ CONSTBUFFER_WRITABLE_HANDLE CONSTBUFFER_CreateWritableHandle(uint32_t size)
             /*Codes_SRS_CONSTBUFFER_51_005: [ CONSTBUFFER_CreateWritableHandle shall succeed and return a non-NULL CONSTBUFFER_WRITABLE_HANDLE. ]*/
             /*Codes_SRS_CONSTBUFFER_51_004: [ CONSTBUFFER_CreateWritableHandle shall set the ref count of the newly created CONSTBUFFER_WRITABLE_HANDLE to 1. ]*/
             (void)interlocked_exchange(&result->count, 1);
+            CONSTBUFFER_FINGERPRINT_INIT(result);
             result->buffer_type = CONSTBUFFER_TYPE_COPIED;
             result->alias.size = size;
             result->alias.buffer = result->storage;
+            CONSTBUFFER_ACCOUNT_CREATED(result);
         }
     }
     return result;
@@ -713,7 +1953,7 @@ unsigned char* CONSTBUFFER_GetWritableBuffer(CONSTBUFFER_WRITABLE_HANDLE constbu
     else
     {
         /*Codes_SRS_CONSTBUFFER_51_007: [ CONSTBUFFER_GetWritableBuffer shall succeed and returns a pointer to the non-CONST buffer of constbufferWritableHandle. ]*/
-        buffer = constbufferWritableHandle->storage;
+        buffer = (unsigned char*)constbufferWritableHandle->alias.buffer;
     }
     return buffer;
 }
@@ -761,8 +2001,17 @@ void CONSTBUFFER_WritableHandleDecRef(CONSTBUFFER_WRITABLE_HANDLE constbufferWri
         /*Codes_SRS_CONSTBUFFER_51_013: [ Otherwise, CONSTBUFFER_WritableHandleDecRef shall decrement the refcount of constbufferWritableHandle. ]*/
         if (interlocked_decrement(&constbufferWritableHandle->count) == 0)
         {
-            /*Codes_SRS_CONSTBUFFER_51_014: [ If the refcount reaches zero, then CONSTBUFFER_WritableHandleDecRef shall deallocate all resources used by the CONSTBUFFER_HANDLE. ]*/
-            free(constbufferWritableHandle);
+            /*Codes_SRS_CONSTBUFFER_12_112: [ If CONSTBUFFER_ACCOUNTING is defined then CONSTBUFFER_DecRef and CONSTBUFFER_WritableHandleDecRef shall call constbuffer_accounting_remove with the type of the handle and its size when the ref count reaches 0. ]*/
+            CONSTBUFFER_ACCOUNT_FREED(constbufferWritableHandle);
+            if (constbufferWritableHandle->buffer_type == CONSTBUFFER_TYPE_POOLED)
+            {
+                constbuffer_pool_return((CONSTBUFFER_HANDLE_POOLED_DATA*)constbufferWritableHandle);
+            }
+            else
+            {
+                /*Codes_SRS_CONSTBUFFER_51_014: [ If the refcount reaches zero, then CONSTBUFFER_WritableHandleDecRef shall deallocate all resources used by the CONSTBUFFER_HANDLE. ]*/
+                free(constbufferWritableHandle);
+            }
         }
     }
 }
@@ -783,3 +2032,199 @@ uint32_t CONSTBUFFER_GetWritableBufferSize(CONSTBUFFER_WRITABLE_HANDLE constbuff
     }
     return bufferSize;
 }
+
+CONSTBUFFER_POOL_HANDLE CONSTBUFFER_POOL_Create(uint32_t max_buffer_size, uint32_t max_retained_per_class)
+{
+    CONSTBUFFER_POOL_HANDLE result;
+    if (
+        /*Codes_SRS_CONSTBUFFER_12_001: [ If max_buffer_size is 0 or greater than 2^31 then CONSTBUFFER_POOL_Create shall fail and return NULL. ]*/
+        (max_buffer_size == 0) ||
+        (max_buffer_size > CONSTBUFFER_POOL_MAX_BUFFER_SIZE) ||
+        /*Codes_SRS_CONSTBUFFER_12_002: [ If max_retained_per_class is 0 then CONSTBUFFER_POOL_Create shall fail and return NULL. ]*/
+        (max_retained_per_class == 0)
+        )
+    {
+        LogError("invalid arguments uint32_t max_buffer_size=%" PRIu32 ", uint32_t max_retained_per_class=%" PRIu32 "",
+            max_buffer_size, max_retained_per_class);
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_12_003: [ CONSTBUFFER_POOL_Create shall compute the number of power of 2 size classes needed to cover sizes from 64 bytes up to max_buffer_size. ]*/
+        uint32_t class_count = constbuffer_pool_get_size_class(max_buffer_size) + 1;
+
+        if ((uint64_t)class_count * max_retained_per_class >= INT32_MAX)
+        {
+            /*Codes_SRS_CONSTBUFFER_12_006: [ If there are any failures then CONSTBUFFER_POOL_Create shall fail and return NULL. ]*/
+            LogError("too many slots: class_count=%" PRIu32 " * max_retained_per_class=%" PRIu32 " (the index of a slot is an int32_t)", class_count, max_retained_per_class);
+            result = NULL;
+        }
+        else
+        {
+            /*Codes_SRS_CONSTBUFFER_12_004: [ CONSTBUFFER_POOL_Create shall allocate memory for the pool and for max_retained_per_class slots for every size class. ]*/
+            result = malloc_flex(sizeof(CONSTBUFFER_POOL_HANDLE_DATA), (size_t)class_count * max_retained_per_class, sizeof(CONSTBUFFER_POOL_SLOT));
+            if (result == NULL)
+            {
+                /*Codes_SRS_CONSTBUFFER_12_006: [ If there are any failures then CONSTBUFFER_POOL_Create shall fail and return NULL. ]*/
+                LogError("failure in malloc_flex(sizeof(CONSTBUFFER_POOL_HANDLE_DATA)=%zu, class_count=%" PRIu32 " * max_retained_per_class=%" PRIu32 ", sizeof(CONSTBUFFER_POOL_SLOT)=%zu)",
+                    sizeof(CONSTBUFFER_POOL_HANDLE_DATA), class_count, max_retained_per_class, sizeof(CONSTBUFFER_POOL_SLOT));
+                /*return as is*/
+            }
+            else
+            {
+                /*Codes_SRS_CONSTBUFFER_12_005: [ CONSTBUFFER_POOL_Create shall set all slots to empty, all statistics to 0 and succeed and return a non-NULL value. ]*/
+                result->max_buffer_size = CONSTBUFFER_POOL_MIN_CLASS_SIZE << (class_count - 1);
+                result->class_count = class_count;
+                result->max_retained_per_class = max_retained_per_class;
+                for (uint32_t i = 0; i < class_count; i++)
+                {
+                    /*all the slots of the class are in its free stack, in order*/
+                    uint32_t first_slot = i * max_retained_per_class;
+                    for (uint32_t j = 0; j < max_retained_per_class; j++)
+                    {
+                        (void)interlocked_exchange_pointer(&result->slots[first_slot + j].buffer, NULL);
+                        (void)interlocked_exchange(&result->slots[first_slot + j].next, (j + 1 < max_retained_per_class) ? (int32_t)(first_slot + j + 2) : CONSTBUFFER_POOL_STACK_EMPTY);
+                    }
+                    (void)interlocked_exchange_64(&result->classes[i].retained_head, CONSTBUFFER_POOL_STACK_EMPTY);
+                    (void)interlocked_exchange_64(&result->classes[i].free_head, first_slot + 1);
+                }
+                (void)interlocked_exchange_64(&result->hits, 0);
+                (void)interlocked_exchange_64(&result->misses, 0);
+                (void)interlocked_exchange_64(&result->retained_buffers, 0);
+                (void)interlocked_exchange_64(&result->retained_bytes, 0);
+                (void)interlocked_exchange(&result->is_destroyed, 0);
+                (void)interlocked_exchange(&result->ref_count, 1);
+            }
+        }
+    }
+    return result;
+}
+
+void CONSTBUFFER_POOL_Destroy(CONSTBUFFER_POOL_HANDLE pool)
+{
+    if (pool == NULL)
+    {
+        /*Codes_SRS_CONSTBUFFER_12_007: [ If pool is NULL then CONSTBUFFER_POOL_Destroy shall return. ]*/
+        LogError("invalid argument CONSTBUFFER_POOL_HANDLE pool=%p", pool);
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_12_008: [ CONSTBUFFER_POOL_Destroy shall mark the pool as destroyed so that buffers returned afterwards are freed instead of retained. ]*/
+        (void)interlocked_exchange(&pool->is_destroyed, 1);
+
+        /*Codes_SRS_CONSTBUFFER_12_009: [ CONSTBUFFER_POOL_Destroy shall free all the retained buffers. ]*/
+        constbuffer_pool_free_retained(pool);
+
+        /*Codes_SRS_CONSTBUFFER_12_010: [ CONSTBUFFER_POOL_Destroy shall release the reference of the owner. The pool memory shall be freed when all the buffers created from it have been released. ]*/
+        constbuffer_pool_dec_ref(pool);
+    }
+}
+
+CONSTBUFFER_WRITABLE_HANDLE CONSTBUFFER_POOL_CreateWritableHandle(CONSTBUFFER_POOL_HANDLE pool, uint32_t size)
+{
+    CONSTBUFFER_WRITABLE_HANDLE result;
+    if (
+        /*Codes_SRS_CONSTBUFFER_12_011: [ If pool is NULL then CONSTBUFFER_POOL_CreateWritableHandle shall fail and return NULL. ]*/
+        (pool == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_12_012: [ If size is 0 then CONSTBUFFER_POOL_CreateWritableHandle shall fail and return NULL. ]*/
+        (size == 0)
+        )
+    {
+        LogError("invalid arguments CONSTBUFFER_POOL_HANDLE pool=%p, uint32_t size=%" PRIu32 "", pool, size);
+        result = NULL;
+    }
+    else if (size > pool->max_buffer_size)
+    {
+        /*Codes_SRS_CONSTBUFFER_12_013: [ If size is greater than the biggest size class of the pool then CONSTBUFFER_POOL_CreateWritableHandle shall count a miss and return the result of CONSTBUFFER_CreateWritableHandle(size). ]*/
+        (void)interlocked_increment_64(&pool->misses);
+        result = CONSTBUFFER_CreateWritableHandle(size);
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_12_014: [ CONSTBUFFER_POOL_CreateWritableHandle shall compute the size class as the smallest power of 2 that is at least 64 and at least size. ]*/
+        uint32_t size_class = constbuffer_pool_get_size_class(size);
+
+        /*Codes_SRS_CONSTBUFFER_12_015: [ CONSTBUFFER_POOL_CreateWritableHandle shall take a retained buffer from the slots of the size class, if any. ]*/
+        CONSTBUFFER_HANDLE_POOLED_DATA* pooled = constbuffer_pool_take_retained(pool, size_class);
+
+        if (pooled != NULL)
+        {
+            /*Codes_SRS_CONSTBUFFER_12_016: [ If a retained buffer is found then CONSTBUFFER_POOL_CreateWritableHandle shall count a hit. ]*/
+            (void)interlocked_increment_64(&pool->hits);
+        }
+        else
+        {
+            /*Codes_SRS_CONSTBUFFER_12_017: [ Otherwise CONSTBUFFER_POOL_CreateWritableHandle shall count a miss and allocate memory for a buffer of the size class. ]*/
+            (void)interlocked_increment_64(&pool->misses);
+            pooled = malloc_flex(sizeof(CONSTBUFFER_HANDLE_POOLED_DATA), CONSTBUFFER_POOL_MIN_CLASS_SIZE << size_class, sizeof(unsigned char));
+            if (pooled == NULL)
+            {
+                /*Codes_SRS_CONSTBUFFER_12_019: [ If there are any failures then CONSTBUFFER_POOL_CreateWritableHandle shall fail and return NULL. ]*/
+                LogError("failure in malloc_flex(sizeof(CONSTBUFFER_HANDLE_POOLED_DATA)=%zu, CONSTBUFFER_POOL_MIN_CLASS_SIZE << size_class=%" PRIu32 ", sizeof(unsigned char)=%zu)",
+                    sizeof(CONSTBUFFER_HANDLE_POOLED_DATA), CONSTBUFFER_POOL_MIN_CLASS_SIZE << size_class, sizeof(unsigned char));
+            }
+            else
+            {
+                pooled->buffer_type = CONSTBUFFER_TYPE_POOLED;
+                pooled->pool = pool;
+                pooled->size_class = size_class;
+            }
+        }
+
+        if (pooled == NULL)
+        {
+            result = NULL;
+        }
+        else
+        {
+            /*Codes_SRS_CONSTBUFFER_12_018: [ CONSTBUFFER_POOL_CreateWritableHandle shall take a reference on the pool, set the ref count of the writable handle to 1, set its size to size and succeed and return a non-NULL value. ]*/
+            (void)interlocked_increment(&pool->ref_count);
+            pooled->alias.buffer = pooled->storage;
+            pooled->alias.size = size;
+            (void)interlocked_exchange(&pooled->count, 1);
+            CONSTBUFFER_FINGERPRINT_INIT(pooled);
+            CONSTBUFFER_ACCOUNT_CREATED(pooled);
+            result = (CONSTBUFFER_WRITABLE_HANDLE)pooled;
+        }
+    }
+    return result;
+}
+
+int CONSTBUFFER_POOL_GetStatistics(CONSTBUFFER_POOL_HANDLE pool, CONSTBUFFER_POOL_STATISTICS* statistics)
+{
+    int result;
+    if (
+        /*Codes_SRS_CONSTBUFFER_12_020: [ If pool is NULL then CONSTBUFFER_POOL_GetStatistics shall fail and return a non-zero value. ]*/
+        (pool == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_12_021: [ If statistics is NULL then CONSTBUFFER_POOL_GetStatistics shall fail and return a non-zero value. ]*/
+        (statistics == NULL)
+        )
+    {
+        LogError("invalid arguments CONSTBUFFER_POOL_HANDLE pool=%p, CONSTBUFFER_POOL_STATISTICS* statistics=%p", pool, statistics);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_12_022: [ CONSTBUFFER_POOL_GetStatistics shall write in statistics the number of hits, misses, retained buffers and retained bytes of the pool and return 0. ]*/
+        statistics->hits = (uint64_t)interlocked_add_64(&pool->hits, 0);
+        statistics->misses = (uint64_t)interlocked_add_64(&pool->misses, 0);
+        statistics->retained_buffers = (uint64_t)interlocked_add_64(&pool->retained_buffers, 0);
+        statistics->retained_bytes = (uint64_t)interlocked_add_64(&pool->retained_bytes, 0);
+        result = 0;
+    }
+    return result;
+}
+
+void CONSTBUFFER_POOL_Trim(CONSTBUFFER_POOL_HANDLE pool)
+{
+    if (pool == NULL)
+    {
+        /*Codes_SRS_CONSTBUFFER_12_026: [ If pool is NULL then CONSTBUFFER_POOL_Trim shall return. ]*/
+        LogError("invalid argument CONSTBUFFER_POOL_HANDLE pool=%p", pool);
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_12_027: [ CONSTBUFFER_POOL_Trim shall free all the buffers retained by the pool. ]*/
+        constbuffer_pool_free_retained(pool);
+    }
+}
@@ -0,0 +1,128 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdalign.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "macro_utils/macro_utils.h"
+
+#include "c_logging/logger.h"
+
+#include "c_pal/interlocked.h"
+#include "c_pal/threadapi.h"
+
+#include "c_util/constbuffer_accounting.h"
+
+MU_DEFINE_ENUM_STRINGS_WITHOUT_INVALID(CONSTBUFFER_ACCOUNTING_TYPE, CONSTBUFFER_ACCOUNTING_TYPE_VALUES)
+
+#ifdef CONSTBUFFER_ACCOUNTING
+
+/*there is no portable way to ask for the current CPU, so the counters are sharded by the id of the calling thread instead. Each shard is padded to a
+multiple of the cache line size and the array of shards starts on a cache line, so every shard is in its own cache lines and threads that create/free
+buffers at the same time rarely touch the same cache line. A snapshot sums all the shards*/
+#define CONSTBUFFER_ACCOUNTING_SHARD_COUNT 64
+#define CONSTBUFFER_ACCOUNTING_CACHE_LINE_SIZE 64
+
+typedef struct CONSTBUFFER_ACCOUNTING_SHARD_COUNTERS_TAG
+{
+    volatile_atomic int64_t live_handles[CONSTBUFFER_ACCOUNTING_TYPE_COUNT];
+    volatile_atomic int64_t live_bytes[CONSTBUFFER_ACCOUNTING_TYPE_COUNT];
+    volatile_atomic int64_t size_histogram[CONSTBUFFER_ACCOUNTING_HISTOGRAM_BUCKET_COUNT];
+} CONSTBUFFER_ACCOUNTING_SHARD_COUNTERS;
+
+typedef struct CONSTBUFFER_ACCOUNTING_SHARD_TAG
+{
+    CONSTBUFFER_ACCOUNTING_SHARD_COUNTERS counters;
+    unsigned char padding[CONSTBUFFER_ACCOUNTING_CACHE_LINE_SIZE - (sizeof(CONSTBUFFER_ACCOUNTING_SHARD_COUNTERS) % CONSTBUFFER_ACCOUNTING_CACHE_LINE_SIZE)];
+} CONSTBUFFER_ACCOUNTING_SHARD;
+
+MU_STATIC_ASSERT(sizeof(CONSTBUFFER_ACCOUNTING_SHARD) % CONSTBUFFER_ACCOUNTING_CACHE_LINE_SIZE == 0);
+
+/*all 0 at start, there is nothing to initialize*/
+static alignas(CONSTBUFFER_ACCOUNTING_CACHE_LINE_SIZE) CONSTBUFFER_ACCOUNTING_SHARD constbuffer_accounting_shards[CONSTBUFFER_ACCOUNTING_SHARD_COUNT];
+
+static CONSTBUFFER_ACCOUNTING_SHARD_COUNTERS* constbuffer_accounting_get_shard(void)
+{
+    /*multiplicative hashing spreads consecutive thread ids over the shards*/
+    uint32_t hash = ThreadAPI_GetCurrentId() * 2654435769U;
+    return &constbuffer_accounting_shards[((uint64_t)hash * CONSTBUFFER_ACCOUNTING_SHARD_COUNT) >> 32].counters;
+}
+
+/*0 for size 0, otherwise 1 + floor(log2(size))*/
+static uint32_t constbuffer_accounting_get_bucket(uint64_t size)
+{
+    uint32_t result = 0;
+    while ((size != 0) && (result < CONSTBUFFER_ACCOUNTING_HISTOGRAM_BUCKET_COUNT - 1))
+    {
+        size >>= 1;
+        result++;
+    }
+    return result;
+}
+
+static void constbuffer_accounting_update(CONSTBUFFER_ACCOUNTING_TYPE type, uint64_t size, int64_t direction)
+{
+    CONSTBUFFER_ACCOUNTING_SHARD_COUNTERS* shard = constbuffer_accounting_get_shard();
+    (void)interlocked_add_64(&shard->live_handles[type], direction);
+    (void)interlocked_add_64(&shard->live_bytes[type], direction * (int64_t)size);
+    if (type != CONSTBUFFER_ACCOUNTING_TYPE_ARRAY)
+    {
+        (void)interlocked_add_64(&shard->size_histogram[constbuffer_accounting_get_bucket(size)], direction);
+    }
+}
+
+void constbuffer_accounting_add(CONSTBUFFER_ACCOUNTING_TYPE type, uint64_t size)
+{
+    /*Codes_SRS_CONSTBUFFER_ACCOUNTING_12_004: [ constbuffer_accounting_add shall add 1 to the live handles and size to the live bytes of type in the shard picked by the id of the calling thread. ]*/
+    /*Codes_SRS_CONSTBUFFER_ACCOUNTING_12_005: [ If type is not CONSTBUFFER_ACCOUNTING_TYPE_ARRAY then constbuffer_accounting_add shall add 1 to the histogram bucket of size in the same shard. ]*/
+    constbuffer_accounting_update(type, size, 1);
+}
+
+void constbuffer_accounting_remove(CONSTBUFFER_ACCOUNTING_TYPE type, uint64_t size)
+{
+    /*Codes_SRS_CONSTBUFFER_ACCOUNTING_12_006: [ constbuffer_accounting_remove shall subtract 1 from the live handles and size from the live bytes of type in the shard picked by the id of the calling thread. ]*/
+    /*Codes_SRS_CONSTBUFFER_ACCOUNTING_12_007: [ If type is not CONSTBUFFER_ACCOUNTING_TYPE_ARRAY then constbuffer_accounting_remove shall subtract 1 from the histogram bucket of size in the same shard. ]*/
+    constbuffer_accounting_update(type, size, -1);
+}
+
+#endif
+
+int constbuffer_accounting_get_snapshot(CONSTBUFFER_ACCOUNTING_SNAPSHOT* snapshot)
+{
+    int result;
+    if (snapshot == NULL)
+    {
+        /*Codes_SRS_CONSTBUFFER_ACCOUNTING_12_001: [ If snapshot is NULL then constbuffer_accounting_get_snapshot shall fail and return a non-zero value. ]*/
+        LogError("invalid argument CONSTBUFFER_ACCOUNTING_SNAPSHOT* snapshot=%p", snapshot);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        (void)memset(snapshot, 0, sizeof(CONSTBUFFER_ACCOUNTING_SNAPSHOT));
+#ifdef CONSTBUFFER_ACCOUNTING
+        /*Codes_SRS_CONSTBUFFER_ACCOUNTING_12_003: [ constbuffer_accounting_get_snapshot shall set is_enabled to true and write in snapshot the sums of the counters of all the shards. ]*/
+        for (uint32_t i = 0; i < CONSTBUFFER_ACCOUNTING_SHARD_COUNT; i++)
+        {
+            CONSTBUFFER_ACCOUNTING_SHARD_COUNTERS* shard = &constbuffer_accounting_shards[i].counters;
+            for (uint32_t j = 0; j < CONSTBUFFER_ACCOUNTING_TYPE_COUNT; j++)
+            {
+                snapshot->by_type[j].live_handles += interlocked_add_64(&shard->live_handles[j], 0);
+                snapshot->by_type[j].live_bytes += interlocked_add_64(&shard->live_bytes[j], 0);
+            }
+            for (uint32_t j = 0; j < CONSTBUFFER_ACCOUNTING_HISTOGRAM_BUCKET_COUNT; j++)
+            {
+                snapshot->size_histogram[j] += interlocked_add_64(&shard->size_histogram[j], 0);
+            }
+        }
+        snapshot->is_enabled = true;
+#else
+        /*Codes_SRS_CONSTBUFFER_ACCOUNTING_12_002: [ If the accounting is compiled out then constbuffer_accounting_get_snapshot shall set is_enabled to false and all the counters to 0. ]*/
+        snapshot->is_enabled = false;
+#endif
+        /*Codes_SRS_CONSTBUFFER_ACCOUNTING_12_008: [ constbuffer_accounting_get_snapshot shall succeed and return 0. ]*/
+        result = 0;
+    }
+    return result;
+}
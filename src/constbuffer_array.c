@@ -3,6 +3,7 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include <inttypes.h>
+#include <string.h>
 
 #include "macro_utils/macro_utils.h"
 
@@ -10,12 +11,30 @@
 
 #include "c_pal/gballoc_hl.h"
 #include "c_pal/gballoc_hl_redirect.h"
+#include "c_pal/interlocked.h"
 #include "c_pal/refcount.h"
 
 #include "c_util/constbuffer.h"
+#include "c_util/constbuffer_accounting.h"
+#include "c_util/hash.h"
 
 #include "c_util/constbuffer_array.h"
 
+#if defined(_M_X64) || defined(__x86_64__)
+/*SSE2 is part of x64, so the streaming stores and the compare loop need no CPU detection and no special compiler flags*/
+#define CONSTBUFFER_ARRAY_X64
+#include <emmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+/*copies of at least this many bytes write the destination with non-temporal stores: such a destination is too big to be read back from the cache
+and pulling it in would only evict what the caller has there*/
+#define CONSTBUFFER_ARRAY_NON_TEMPORAL_COPY_THRESHOLD (1024 * 1024)
+
+MU_DEFINE_ENUM_STRINGS(CONSTBUFFER_ARRAY_FIND_RESULT, CONSTBUFFER_ARRAY_FIND_RESULT_VALUES);
+
 typedef void(*CONSTBUFFER_ARRAY_CUSTOM_FREE_FUNC)(void* context);
 
 typedef struct CONSTBUFFER_ARRAY_HANDLE_DATA_TAG
@@ -24,11 +43,111 @@ typedef struct CONSTBUFFER_ARRAY_HANDLE_DATA_TAG
     CONSTBUFFER_ARRAY_CUSTOM_FREE_FUNC custom_free;
     void* custom_free_context;
     CONSTBUFFER_HANDLE* buffers;
+    volatile_atomic int64_t all_buffers_size; /*sum of the sizes of all buffers, CONSTBUFFER_ARRAY_ALL_BUFFERS_SIZE_UNKNOWN until computed (or CONSTBUFFER_ARRAY_ALL_BUFFERS_SIZE_TOO_BIG). The array is immutable so once computed it never changes*/
+    volatile_atomic int64_t fingerprint; /*CONSTBUFFER_ARRAY_FINGERPRINT_UNKNOWN until constbuffer_array_get_fingerprint computes it*/
     CONSTBUFFER_HANDLE buffers_memory[];
 } CONSTBUFFER_ARRAY_HANDLE_DATA;
 
+#define CONSTBUFFER_ARRAY_ALL_BUFFERS_SIZE_UNKNOWN (-1)
+
+/*the sum of the sizes of all buffers is known to exceed INT64_MAX (it cannot be stored), constbuffer_array_get_all_buffers_size_64 fails for such an array*/
+#define CONSTBUFFER_ARRAY_ALL_BUFFERS_SIZE_TOO_BIG (-2)
+
+/*an empty array has fingerprint 0 too, it is computed again on every call (which does not read any byte)*/
+#define CONSTBUFFER_ARRAY_FINGERPRINT_UNKNOWN 0
+
 DEFINE_REFCOUNT_TYPE(CONSTBUFFER_ARRAY_HANDLE_DATA);
 
+/*backing store of the arrays produced by the constbuffer_array_*_shared functions. Every such array is a window [start, start + nBuffers) of slots.
+Slots [front, back) hold a handle (and the storage owns a reference on it), the slots outside are free. An array that ends at back (or starts at front)
+can grow in place by claiming the next free slot with a compare-exchange, so only the first array that grows from a given edge writes the slot and all
+the existing arrays keep seeing their own (immutable) window.
+The slots left behind by a remove keep their handle until an array that is the only window of the storage grows over them (nobody else can see them
+then, so the array moves the edge back to itself and releases them) or until the storage is freed*/
+typedef struct CONSTBUFFER_ARRAY_SHARED_STORAGE_TAG
+{
+    uint32_t capacity;
+    volatile_atomic int32_t window_count; /*number of arrays that are a window of the storage, the storage is freed when it reaches 0*/
+    volatile_atomic int64_t front; /*edge: slot index in the low 32 bits, a tag incremented at every move in the high 32 bits (an edge that moved away and back does not compare equal)*/
+    volatile_atomic int64_t back;
+    CONSTBUFFER_HANDLE slots[];
+} CONSTBUFFER_ARRAY_SHARED_STORAGE;
+
+#define CONSTBUFFER_ARRAY_SHARED_EDGE_INDEX(edge) ((int64_t)((uint64_t)(edge) & UINT32_MAX))
+
+/*free slots reserved on each side (on top of the size of the array) when a new storage is created*/
+#define CONSTBUFFER_ARRAY_SHARED_STORAGE_MIN_HEADROOM 2
+
+#ifdef CONSTBUFFER_ACCOUNTING
+static void constbuffer_array_buffer_index_and_count_free(void* context);
+static void constbuffer_array_shared_storage_release(void* context);
+
+/*the handles are counted in the size when the array owns them (in buffers_memory or moved in), not when they are the handles of the original array or of a shared storage*/
+static uint64_t constbuffer_array_get_accounted_size(const CONSTBUFFER_ARRAY_HANDLE_DATA* constbuffer_array_handle)
+{
+    return sizeof(CONSTBUFFER_ARRAY_HANDLE_DATA) +
+        (((constbuffer_array_handle->custom_free == constbuffer_array_buffer_index_and_count_free) || (constbuffer_array_handle->custom_free == constbuffer_array_shared_storage_release)) ? 0 : (uint64_t)constbuffer_array_handle->nBuffers * sizeof(CONSTBUFFER_HANDLE));
+}
+
+/*an array is accounted from the moment its fields are set until it is destroyed (by constbuffer_array_dec_ref or on a failure path)*/
+/*Codes_SRS_CONSTBUFFER_ARRAY_12_011: [ If CONSTBUFFER_ACCOUNTING is defined then every function that produces a CONSTBUFFER_ARRAY_HANDLE shall call constbuffer_accounting_add with CONSTBUFFER_ACCOUNTING_TYPE_ARRAY and the size of the handle. ]*/
+/*Codes_SRS_CONSTBUFFER_ARRAY_12_012: [ If CONSTBUFFER_ACCOUNTING is defined then constbuffer_array_dec_ref shall call constbuffer_accounting_remove with CONSTBUFFER_ACCOUNTING_TYPE_ARRAY and the size of the handle when the reference count reaches 0. ]*/
+#define CONSTBUFFER_ARRAY_ACCOUNT_CREATED(handle) constbuffer_accounting_add(CONSTBUFFER_ACCOUNTING_TYPE_ARRAY, constbuffer_array_get_accounted_size(handle))
+#define CONSTBUFFER_ARRAY_ACCOUNT_FREED(handle) constbuffer_accounting_remove(CONSTBUFFER_ACCOUNTING_TYPE_ARRAY, constbuffer_array_get_accounted_size(handle))
+#else
+#define CONSTBUFFER_ARRAY_ACCOUNT_CREATED(handle) ((void)0)
+#define CONSTBUFFER_ARRAY_ACCOUNT_FREED(handle) ((void)0)
+#endif
+
+/*the total size of an array made of the buffers of an array of total size all_buffers_size and of buffers of total size size*/
+static int64_t constbuffer_array_all_buffers_size_add(int64_t all_buffers_size, int64_t size)
+{
+    int64_t result;
+    if (
+        (all_buffers_size == CONSTBUFFER_ARRAY_ALL_BUFFERS_SIZE_TOO_BIG) ||
+        (size == CONSTBUFFER_ARRAY_ALL_BUFFERS_SIZE_TOO_BIG)
+        )
+    {
+        result = CONSTBUFFER_ARRAY_ALL_BUFFERS_SIZE_TOO_BIG;
+    }
+    else if (
+        (all_buffers_size == CONSTBUFFER_ARRAY_ALL_BUFFERS_SIZE_UNKNOWN) ||
+        (size == CONSTBUFFER_ARRAY_ALL_BUFFERS_SIZE_UNKNOWN)
+        )
+    {
+        result = CONSTBUFFER_ARRAY_ALL_BUFFERS_SIZE_UNKNOWN;
+    }
+    else if (size > INT64_MAX - all_buffers_size)
+    {
+        result = CONSTBUFFER_ARRAY_ALL_BUFFERS_SIZE_TOO_BIG;
+    }
+    else
+    {
+        result = all_buffers_size + size;
+    }
+    return result;
+}
+
+/*the total size of an array made of the buffers of an array of total size all_buffers_size without a buffer of size size. A total that was too big
+might not be anymore, it is computed again when requested*/
+static int64_t constbuffer_array_all_buffers_size_subtract(int64_t all_buffers_size, int64_t size)
+{
+    int64_t result;
+    if (
+        (all_buffers_size == CONSTBUFFER_ARRAY_ALL_BUFFERS_SIZE_TOO_BIG) ||
+        (all_buffers_size == CONSTBUFFER_ARRAY_ALL_BUFFERS_SIZE_UNKNOWN) ||
+        (size > all_buffers_size)
+        )
+    {
+        result = CONSTBUFFER_ARRAY_ALL_BUFFERS_SIZE_UNKNOWN;
+    }
+    else
+    {
+        result = all_buffers_size - size;
+    }
+    return result;
+}
+
 CONSTBUFFER_ARRAY_HANDLE constbuffer_array_create(const CONSTBUFFER_HANDLE* buffers, uint32_t buffer_count)
 {
     CONSTBUFFER_ARRAY_HANDLE result;
@@ -54,17 +173,24 @@ CONSTBUFFER_ARRAY_HANDLE constbuffer_array_create(const CONSTBUFFER_HANDLE* buff
         else
         {
             uint32_t i;
+            int64_t all_buffers_size = 0;
 
             result->buffers = result->buffers_memory;
             result->nBuffers = buffer_count;
+            result->fingerprint = CONSTBUFFER_ARRAY_FINGERPRINT_UNKNOWN;
             result->custom_free = NULL;
+            CONSTBUFFER_ARRAY_ACCOUNT_CREATED(result);
 
             for (i = 0; i < buffer_count; i++)
             {
                 /* Codes_SRS_CONSTBUFFER_ARRAY_01_010: [ constbuffer_array_create shall clone the buffers in buffers and store them. ]*/
                 CONSTBUFFER_IncRef(buffers[i]);
                 result->buffers[i] = buffers[i];
+
+                /*Codes_SRS_CONSTBUFFER_ARRAY_12_078: [ constbuffer_array_create shall store the sum of the sizes of the buffers (obtained by calling CONSTBUFFER_GetContent while cloning them) as the total size of the new array. ]*/
+                all_buffers_size = constbuffer_array_all_buffers_size_add(all_buffers_size, CONSTBUFFER_GetContent(buffers[i])->size);
             }
+            result->all_buffers_size = all_buffers_size;
 
             /* Codes_SRS_CONSTBUFFER_ARRAY_01_011: [ On success constbuffer_array_create shall return a non-NULL handle. ]*/
             goto all_ok;
@@ -94,7 +220,10 @@ CONSTBUFFER_ARRAY_HANDLE constbuffer_array_create_empty(void)
         /*Codes_SRS_CONSTBUFFER_ARRAY_02_041: [ constbuffer_array_create_empty shall succeed and return a non-NULL value. ]*/
         result->custom_free = NULL;
         result->nBuffers = 0;
+        result->all_buffers_size = 0;
+        result->fingerprint = CONSTBUFFER_ARRAY_FINGERPRINT_UNKNOWN;
         result->buffers = result->buffers_memory;
+        CONSTBUFFER_ARRAY_ACCOUNT_CREATED(result);
     }
     return result;
 }
@@ -137,6 +266,9 @@ CONSTBUFFER_ARRAY_HANDLE constbuffer_array_create_with_move_buffers(CONSTBUFFER_
             result->custom_free_context = result;
             result->buffers = buffers;
             result->nBuffers = buffer_count;
+            result->all_buffers_size = CONSTBUFFER_ARRAY_ALL_BUFFERS_SIZE_UNKNOWN;
+            result->fingerprint = CONSTBUFFER_ARRAY_FINGERPRINT_UNKNOWN;
+            CONSTBUFFER_ARRAY_ACCOUNT_CREATED(result);
         }
     }
 
@@ -191,6 +323,16 @@ CONSTBUFFER_ARRAY_HANDLE constbuffer_array_create_from_buffer_index_and_count(CO
             result->custom_free_context = original;
             result->buffers = &(original->buffers[start_buffer_index]);
             result->nBuffers = buffer_count;
+            result->fingerprint = CONSTBUFFER_ARRAY_FINGERPRINT_UNKNOWN;
+            CONSTBUFFER_ARRAY_ACCOUNT_CREATED(result);
+
+            /* Codes_SRS_CONSTBUFFER_ARRAY_12_079: [ constbuffer_array_create_from_buffer_index_and_count shall store the sum of the sizes of the buffer_count buffers starting at start_buffer_index (obtained by calling CONSTBUFFER_GetContent) as the total size of the new array. ]*/
+            int64_t all_buffers_size = 0;
+            for (uint32_t i = 0; i < buffer_count; i++)
+            {
+                all_buffers_size = constbuffer_array_all_buffers_size_add(all_buffers_size, CONSTBUFFER_GetContent(result->buffers[i])->size);
+            }
+            result->all_buffers_size = all_buffers_size;
         }
     }
 
@@ -243,7 +385,10 @@ CONSTBUFFER_ARRAY_HANDLE constbuffer_array_create_from_buffer_offset_and_count(C
             {
                 result->buffers = result->buffers_memory;
                 result->nBuffers = buffer_count;
+                result->all_buffers_size = CONSTBUFFER_ARRAY_ALL_BUFFERS_SIZE_UNKNOWN;
+                result->fingerprint = CONSTBUFFER_ARRAY_FINGERPRINT_UNKNOWN;
                 result->custom_free = NULL;
+                CONSTBUFFER_ARRAY_ACCOUNT_CREATED(result);
 
                 /* Codes_SRS_CONSTBUFFER_ARRAY_07_013: [ If buffer_count is 1, constbuffer_array_create_from_buffer_offset_and_count shall get the only buffer by calling CONSTBUFFER_CreateFromOffsetAndSize with paramter start_buffer_offset and end_buffer_offset. ]*/
                 if (buffer_count == 1)
@@ -258,6 +403,7 @@ CONSTBUFFER_ARRAY_HANDLE constbuffer_array_create_from_buffer_offset_and_count(C
                     else
                     {
                         result->buffers[0] = only_buffer;
+                        result->all_buffers_size = end_buffer_offset;
                         goto all_ok;
                     }
                 }
@@ -287,6 +433,8 @@ CONSTBUFFER_ARRAY_HANDLE constbuffer_array_create_from_buffer_offset_and_count(C
                         }
                         else
                         {
+                            int64_t all_buffers_size = (int64_t)start_buffer_size + end_buffer_offset;
+
                             for (uint32_t i = 0; i < buffer_count; i++)
                             {
                                 if (i == 0)
@@ -302,13 +450,18 @@ CONSTBUFFER_ARRAY_HANDLE constbuffer_array_create_from_buffer_offset_and_count(C
                                     /* Codes_SRS_CONSTBUFFER_ARRAY_07_008: [ constbuffer_array_create_from_buffer_offset_and_count shall copy all of the CONSTBUFFER_HANDLES except first and last buffer from each const buffer array in buffer_arrays to the newly constructed array by calling CONSTBUFFER_IncRef. ]*/
                                     CONSTBUFFER_IncRef(original->buffers[start_buffer_index + i]);
                                     result->buffers[i] = original->buffers[start_buffer_index + i];
+                                    all_buffers_size = constbuffer_array_all_buffers_size_add(all_buffers_size, CONSTBUFFER_GetContent(result->buffers[i])->size);
                                 }
                             }
+
+                            /* Codes_SRS_CONSTBUFFER_ARRAY_12_077: [ constbuffer_array_create_from_buffer_offset_and_count shall store the size of the start buffer plus the sizes of the buffers between the start and end buffers (obtained by calling CONSTBUFFER_GetContent while copying them) plus end_buffer_offset as the total size of the new array. ]*/
+                            result->all_buffers_size = all_buffers_size;
                             goto all_ok;
                         }
                         CONSTBUFFER_DecRef(start_buffer);
                     }
                 }
+                CONSTBUFFER_ARRAY_ACCOUNT_FREED(result);
                 REFCOUNT_TYPE_DESTROY(CONSTBUFFER_ARRAY_HANDLE_DATA, result);
             }
         }
@@ -393,8 +546,11 @@ CONSTBUFFER_ARRAY_HANDLE constbuffer_array_create_from_array_array(const CONSTBU
                     uint32_t source_idx;
 
                     result->nBuffers = total_buffer_count;
+                    result->all_buffers_size = CONSTBUFFER_ARRAY_ALL_BUFFERS_SIZE_UNKNOWN;
+                    result->fingerprint = CONSTBUFFER_ARRAY_FINGERPRINT_UNKNOWN;
                     result->custom_free = NULL;
                     result->buffers = result->buffers_memory;
+                    CONSTBUFFER_ARRAY_ACCOUNT_CREATED(result);
 
                     for (dest_idx = 0, array_idx = 0; array_idx < buffer_array_count; ++array_idx)
                     {
@@ -406,6 +562,14 @@ CONSTBUFFER_ARRAY_HANDLE constbuffer_array_create_from_array_array(const CONSTBU
                         }
                     }
 
+                    /*Codes_SRS_CONSTBUFFER_ARRAY_12_076: [ constbuffer_array_create_from_array_array shall store the sum of the total sizes of all the arrays in buffer_arrays (read with interlocked_add_64) as the total size of the new array. ]*/
+                    int64_t all_buffers_size = 0;
+                    for (array_idx = 0; array_idx < buffer_array_count; ++array_idx)
+                    {
+                        all_buffers_size = constbuffer_array_all_buffers_size_add(all_buffers_size, interlocked_add_64(&buffer_arrays[array_idx]->all_buffers_size, 0));
+                    }
+                    result->all_buffers_size = all_buffers_size;
+
                     /*Codes_SRS_CONSTBUFFER_ARRAY_42_007: [ constbuffer_array_create_from_array_array shall succeed and return a non-NULL value. ]*/
                     goto allOk;
                 }
@@ -454,8 +618,10 @@ CONSTBUFFER_ARRAY_HANDLE constbuffer_array_add_front(CONSTBUFFER_ARRAY_HANDLE co
                 /*Codes_SRS_CONSTBUFFER_ARRAY_02_043: [ constbuffer_array_add_front shall copy constbuffer_handle and all of constbuffer_array_handle existing CONSTBUFFER_HANDLE. ]*/
                 /*Codes_SRS_CONSTBUFFER_ARRAY_02_044: [ constbuffer_array_add_front shall inc_ref all the CONSTBUFFER_HANDLE it had copied. ]*/
                 result->nBuffers = constbuffer_array_handle->nBuffers + 1;
+                result->fingerprint = CONSTBUFFER_ARRAY_FINGERPRINT_UNKNOWN;
                 result->custom_free = NULL;
                 result->buffers = result->buffers_memory;
+                CONSTBUFFER_ARRAY_ACCOUNT_CREATED(result);
                 CONSTBUFFER_IncRef(constbuffer_handle);
                 result->buffers_memory[0] = constbuffer_handle;
                 for (i = 1; i < result->nBuffers; i++)
@@ -464,6 +630,10 @@ CONSTBUFFER_ARRAY_HANDLE constbuffer_array_add_front(CONSTBUFFER_ARRAY_HANDLE co
                     result->buffers[i] = constbuffer_array_handle->buffers[i - 1];
                 }
 
+                /*Codes_SRS_CONSTBUFFER_ARRAY_12_080: [ constbuffer_array_add_front shall store the total size of constbuffer_array_handle (read with interlocked_add_64) plus the size of constbuffer_handle (obtained by calling CONSTBUFFER_GetContent) as the total size of the new array. ]*/
+                int64_t all_buffers_size = interlocked_add_64(&constbuffer_array_handle->all_buffers_size, 0);
+                result->all_buffers_size = constbuffer_array_all_buffers_size_add(all_buffers_size, CONSTBUFFER_GetContent(constbuffer_handle)->size);
+
                 /*Codes_SRS_CONSTBUFFER_ARRAY_02_010: [ constbuffer_array_add_front shall succeed and return a non-NULL value. ]*/
                 goto allOk;
             }
@@ -515,8 +685,10 @@ CONSTBUFFER_ARRAY_HANDLE constbuffer_array_remove_front(CONSTBUFFER_ARRAY_HANDLE
                 /* Codes_SRS_CONSTBUFFER_ARRAY_01_001: [ constbuffer_array_remove_front shall inc_ref the removed buffer. ]*/
                 CONSTBUFFER_IncRef(constbuffer_array_handle->buffers[0]);
                 result->nBuffers = constbuffer_array_handle->nBuffers - 1;
+                result->fingerprint = CONSTBUFFER_ARRAY_FINGERPRINT_UNKNOWN;
                 result->custom_free = NULL;
                 result->buffers = result->buffers_memory;
+                CONSTBUFFER_ARRAY_ACCOUNT_CREATED(result);
 
                 /*Codes_SRS_CONSTBUFFER_ARRAY_02_047: [ constbuffer_array_remove_front shall copy all of constbuffer_array_handle CONSTBUFFER_HANDLEs except the front one. ]*/
                 /*Codes_SRS_CONSTBUFFER_ARRAY_02_048: [ constbuffer_array_remove_front shall inc_ref all the copied CONSTBUFFER_HANDLEs. ]*/
@@ -526,6 +698,10 @@ CONSTBUFFER_ARRAY_HANDLE constbuffer_array_remove_front(CONSTBUFFER_ARRAY_HANDLE
                     result->buffers[i - 1] = constbuffer_array_handle->buffers[i];
                 }
 
+                /*Codes_SRS_CONSTBUFFER_ARRAY_12_081: [ constbuffer_array_remove_front shall store the total size of constbuffer_array_handle (read with interlocked_add_64) minus the size of the front buffer (obtained by calling CONSTBUFFER_GetContent) as the total size of the new array. ]*/
+                int64_t all_buffers_size = interlocked_add_64(&constbuffer_array_handle->all_buffers_size, 0);
+                result->all_buffers_size = constbuffer_array_all_buffers_size_subtract(all_buffers_size, CONSTBUFFER_GetContent(constbuffer_array_handle->buffers[0])->size);
+
                 /*Codes_SRS_CONSTBUFFER_ARRAY_02_049: [ constbuffer_array_remove_front shall succeed, write in constbuffer_handle the front handle and return a non-NULL value. ]*/
                 *constbuffer_handle = constbuffer_array_handle->buffers[0];
                 goto allOk;
@@ -575,8 +751,10 @@ CONSTBUFFER_ARRAY_HANDLE constbuffer_array_add_back(CONSTBUFFER_ARRAY_HANDLE con
                 /*Codes_SRS_CONSTBUFFER_ARRAY_05_004: [ constbuffer_array_add_back shall copy constbuffer_handle and all of constbuffer_array_handle existing CONSTBUFFER_HANDLE. ]*/
                 /*Codes_SRS_CONSTBUFFER_ARRAY_05_005: [ constbuffer_array_add_back shall inc_ref all the CONSTBUFFER_HANDLE it had copied. ]*/
                 result->nBuffers = constbuffer_array_handle->nBuffers + 1;
+                result->fingerprint = CONSTBUFFER_ARRAY_FINGERPRINT_UNKNOWN;
                 result->custom_free = NULL;
                 result->buffers = result->buffers_memory;
+                CONSTBUFFER_ARRAY_ACCOUNT_CREATED(result);
                 for (i = 0; i < result->nBuffers - 1; i++)
                 {
                     CONSTBUFFER_IncRef(constbuffer_array_handle->buffers[i]);
@@ -585,6 +763,10 @@ CONSTBUFFER_ARRAY_HANDLE constbuffer_array_add_back(CONSTBUFFER_ARRAY_HANDLE con
                 CONSTBUFFER_IncRef(constbuffer_handle);
                 result->buffers_memory[result->nBuffers - 1] = constbuffer_handle;
 
+                /*Codes_SRS_CONSTBUFFER_ARRAY_12_082: [ constbuffer_array_add_back shall store the total size of constbuffer_array_handle (read with interlocked_add_64) plus the size of constbuffer_handle (obtained by calling CONSTBUFFER_GetContent) as the total size of the new array. ]*/
+                int64_t all_buffers_size = interlocked_add_64(&constbuffer_array_handle->all_buffers_size, 0);
+                result->all_buffers_size = constbuffer_array_all_buffers_size_add(all_buffers_size, CONSTBUFFER_GetContent(constbuffer_handle)->size);
+
                 /*Codes_SRS_CONSTBUFFER_ARRAY_05_006: [ constbuffer_array_add_back shall succeed and return a non-NULL value. ]*/
                 goto allOk;
             }
@@ -638,8 +820,10 @@ CONSTBUFFER_ARRAY_HANDLE constbuffer_array_remove_back(CONSTBUFFER_ARRAY_HANDLE
                 /*Codes_SRS_CONSTBUFFER_ARRAY_05_014: [ constbuffer_array_remove_back shall write in constbuffer_handle the back handle. ]*/
                 *constbuffer_handle = constbuffer_array_handle->buffers[constbuffer_array_handle->nBuffers - 1];
                 result->nBuffers = constbuffer_array_handle->nBuffers - 1;
+                result->fingerprint = CONSTBUFFER_ARRAY_FINGERPRINT_UNKNOWN;
                 result->custom_free = NULL;
                 result->buffers = result->buffers_memory;
+                CONSTBUFFER_ARRAY_ACCOUNT_CREATED(result);
 
                 /*Codes_SRS_CONSTBUFFER_ARRAY_05_015: [ constbuffer_array_remove_back shall copy all of constbuffer_array_handle CONSTBUFFER_HANDLEs except the back one. ]*/
                 /*Codes_SRS_CONSTBUFFER_ARRAY_05_016: [ constbuffer_array_remove_back shall inc_ref all the copied CONSTBUFFER_HANDLEs. ]*/
@@ -648,6 +832,11 @@ CONSTBUFFER_ARRAY_HANDLE constbuffer_array_remove_back(CONSTBUFFER_ARRAY_HANDLE
                     CONSTBUFFER_IncRef(constbuffer_array_handle->buffers[i]);
                     result->buffers[i] = constbuffer_array_handle->buffers[i];
                 }
+
+                /*Codes_SRS_CONSTBUFFER_ARRAY_12_083: [ constbuffer_array_remove_back shall store the total size of constbuffer_array_handle (read with interlocked_add_64) minus the size of the back buffer (obtained by calling CONSTBUFFER_GetContent) as the total size of the new array. ]*/
+                int64_t all_buffers_size = interlocked_add_64(&constbuffer_array_handle->all_buffers_size, 0);
+                result->all_buffers_size = constbuffer_array_all_buffers_size_subtract(all_buffers_size, CONSTBUFFER_GetContent(*constbuffer_handle)->size);
+
                 /*Codes_SRS_CONSTBUFFER_ARRAY_05_017: [ constbuffer_array_remove_back shall succeed and return a non-NULL value. ]*/
                 goto allOk;
             }
@@ -659,6 +848,322 @@ allOk:;
     return result;
 }
 
+static void constbuffer_array_shared_storage_release(void* context)
+{
+    CONSTBUFFER_ARRAY_SHARED_STORAGE* storage = context;
+    if (interlocked_decrement(&storage->window_count) == 0)
+    {
+        for (int64_t i = CONSTBUFFER_ARRAY_SHARED_EDGE_INDEX(storage->front); i < CONSTBUFFER_ARRAY_SHARED_EDGE_INDEX(storage->back); i++)
+        {
+            CONSTBUFFER_DecRef(storage->slots[i]);
+        }
+        free(storage);
+    }
+}
+
+/*the edge that has index as slot index and the next tag of edge*/
+static int64_t constbuffer_array_shared_storage_move_edge(int64_t edge, int64_t index)
+{
+    return (int64_t)(((((uint64_t)edge >> 32) + 1) << 32) | (uint64_t)index);
+}
+
+/*makes constbuffer_array_handle a window of storage, the caller passes a reference of storage to constbuffer_array_handle*/
+static void constbuffer_array_set_shared_window(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle, CONSTBUFFER_ARRAY_SHARED_STORAGE* storage, int64_t start, uint32_t buffer_count)
+{
+    constbuffer_array_handle->custom_free = constbuffer_array_shared_storage_release;
+    constbuffer_array_handle->custom_free_context = storage;
+    constbuffer_array_handle->buffers = &storage->slots[start];
+    constbuffer_array_handle->nBuffers = buffer_count;
+    constbuffer_array_handle->all_buffers_size = CONSTBUFFER_ARRAY_ALL_BUFFERS_SIZE_UNKNOWN;
+    constbuffer_array_handle->fingerprint = CONSTBUFFER_ARRAY_FINGERPRINT_UNKNOWN;
+}
+
+/*when constbuffer_array_handle is a window that touches the front (or back) of its storage, claims the free slot next to it, stores constbuffer_handle there
+and makes result the window that includes that slot. When constbuffer_array_handle is the only window of its storage, the slots between it and the edge
+hold only removed handles: the edge is moved back next to the window and those handles are released. Returns false when the slot cannot be claimed
+(no storage, no free slot or another array took it)*/
+static bool constbuffer_array_shared_try_add_in_place(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle, CONSTBUFFER_HANDLE constbuffer_handle, bool add_in_front, CONSTBUFFER_ARRAY_HANDLE result)
+{
+    bool added;
+    if (constbuffer_array_handle->custom_free != constbuffer_array_shared_storage_release)
+    {
+        added = false;
+    }
+    else
+    {
+        CONSTBUFFER_ARRAY_SHARED_STORAGE* storage = constbuffer_array_handle->custom_free_context;
+        int64_t start = constbuffer_array_handle->buffers - storage->slots;
+        int64_t slot;
+        /*removed slots are [first_removed, end_removed), they are released when the edge is moved back over them*/
+        int64_t first_removed;
+        int64_t end_removed;
+        /*result is counted before the slot is claimed, so no other array can see itself as the only window while result is being made.
+        2 windows (constbuffer_array_handle and result) means nobody else sees the removed slots*/
+        bool is_only_window = (interlocked_increment(&storage->window_count) == 2);
+        if (add_in_front)
+        {
+            int64_t edge = interlocked_add_64(&storage->front, 0);
+            slot = start - 1;
+            first_removed = CONSTBUFFER_ARRAY_SHARED_EDGE_INDEX(edge);
+            end_removed = start;
+            added = (start > 0) &&
+                ((first_removed == end_removed) || is_only_window) &&
+                (interlocked_compare_exchange_64(&storage->front, constbuffer_array_shared_storage_move_edge(edge, slot), edge) == edge);
+        }
+        else
+        {
+            int64_t edge = interlocked_add_64(&storage->back, 0);
+            slot = start + constbuffer_array_handle->nBuffers;
+            first_removed = slot;
+            end_removed = CONSTBUFFER_ARRAY_SHARED_EDGE_INDEX(edge);
+            added = (slot < storage->capacity) &&
+                ((first_removed == end_removed) || is_only_window) &&
+                (interlocked_compare_exchange_64(&storage->back, constbuffer_array_shared_storage_move_edge(edge, slot + 1), edge) == edge);
+        }
+
+        if (added)
+        {
+            for (int64_t i = first_removed; i < end_removed; i++)
+            {
+                CONSTBUFFER_DecRef(storage->slots[i]);
+            }
+            CONSTBUFFER_IncRef(constbuffer_handle);
+            storage->slots[slot] = constbuffer_handle;
+            constbuffer_array_set_shared_window(result, storage, add_in_front ? slot : start, constbuffer_array_handle->nBuffers + 1);
+        }
+        else
+        {
+            /*never reaches 0, constbuffer_array_handle is a window*/
+            (void)interlocked_decrement(&storage->window_count);
+        }
+    }
+    return added;
+}
+
+/*creates a new storage with the buffers of constbuffer_array_handle and constbuffer_handle (in front or in back) in the middle, and makes result the window over them*/
+static int constbuffer_array_shared_add_with_new_storage(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle, CONSTBUFFER_HANDLE constbuffer_handle, bool add_in_front, CONSTBUFFER_ARRAY_HANDLE result)
+{
+    int res;
+    uint32_t buffer_count = constbuffer_array_handle->nBuffers + 1;
+    /*as many free slots as buffers (split between the 2 sides), so the copy is paid for by the following in place adds*/
+    uint64_t capacity = 2 * (uint64_t)buffer_count + 2 * CONSTBUFFER_ARRAY_SHARED_STORAGE_MIN_HEADROOM;
+    if (capacity > UINT32_MAX)
+    {
+        capacity = UINT32_MAX;
+    }
+
+    CONSTBUFFER_ARRAY_SHARED_STORAGE* storage = malloc_flex(sizeof(CONSTBUFFER_ARRAY_SHARED_STORAGE), (size_t)capacity, sizeof(CONSTBUFFER_HANDLE));
+    if (storage == NULL)
+    {
+        LogError("failure in malloc_flex(sizeof(CONSTBUFFER_ARRAY_SHARED_STORAGE)=%zu, capacity=%" PRIu64 ", sizeof(CONSTBUFFER_HANDLE)=%zu);",
+            sizeof(CONSTBUFFER_ARRAY_SHARED_STORAGE), capacity, sizeof(CONSTBUFFER_HANDLE));
+        res = MU_FAILURE;
+    }
+    else
+    {
+        int64_t start = (int64_t)((capacity - buffer_count) / 2);
+        CONSTBUFFER_HANDLE* destination = &storage->slots[start];
+
+        storage->capacity = (uint32_t)capacity;
+        /*the window takes the only reference of the storage*/
+        (void)interlocked_exchange(&storage->window_count, 1);
+        storage->front = start;
+        storage->back = start + buffer_count;
+
+        if (add_in_front)
+        {
+            CONSTBUFFER_IncRef(constbuffer_handle);
+            *destination = constbuffer_handle;
+            destination++;
+        }
+        for (uint32_t i = 0; i < constbuffer_array_handle->nBuffers; i++)
+        {
+            CONSTBUFFER_IncRef(constbuffer_array_handle->buffers[i]);
+            destination[i] = constbuffer_array_handle->buffers[i];
+        }
+        if (!add_in_front)
+        {
+            CONSTBUFFER_IncRef(constbuffer_handle);
+            destination[constbuffer_array_handle->nBuffers] = constbuffer_handle;
+        }
+
+        constbuffer_array_set_shared_window(result, storage, start, buffer_count);
+        res = 0;
+    }
+    return res;
+}
+
+static CONSTBUFFER_ARRAY_HANDLE constbuffer_array_add_shared(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle, CONSTBUFFER_HANDLE constbuffer_handle, bool add_in_front)
+{
+    CONSTBUFFER_ARRAY_HANDLE result;
+    if (constbuffer_array_handle->nBuffers == UINT32_MAX)
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_12_017: [ If there are any failures then constbuffer_array_add_front_shared and constbuffer_array_add_back_shared shall fail and return NULL. ]*/
+        LogError("cannot add when capacity is at UINT32_MAX=%" PRIu32 ", would overflow", UINT32_MAX);
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_12_014: [ constbuffer_array_add_front_shared and constbuffer_array_add_back_shared shall allocate memory for a new CONSTBUFFER_ARRAY_HANDLE. ]*/
+        result = REFCOUNT_TYPE_CREATE(CONSTBUFFER_ARRAY_HANDLE_DATA); /*implicit 0*/
+        if (result == NULL)
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_12_017: [ If there are any failures then constbuffer_array_add_front_shared and constbuffer_array_add_back_shared shall fail and return NULL. ]*/
+            LogError("failure in REFCOUNT_TYPE_CREATE(CONSTBUFFER_ARRAY_HANDLE_DATA)");
+            /*return as is*/
+        }
+        /*Codes_SRS_CONSTBUFFER_ARRAY_12_015: [ If constbuffer_array_handle was produced by a constbuffer_array_*_shared function and the slot next to its front (for constbuffer_array_add_front_shared) or back (for constbuffer_array_add_back_shared) in the shared storage is free, then constbuffer_array_add_front_shared and constbuffer_array_add_back_shared shall claim the slot with interlocked_compare_exchange_64, inc_ref constbuffer_handle, store it in the slot and return a new handle that shares the storage with constbuffer_array_handle. ]*/
+        /*Codes_SRS_CONSTBUFFER_ARRAY_12_075: [ If constbuffer_array_handle was produced by a constbuffer_array_*_shared function, it is the only array that shares the storage and the slots between its front (for constbuffer_array_add_front_shared) or back (for constbuffer_array_add_back_shared) and the edge of the used slots hold only removed CONSTBUFFER_HANDLEs, then constbuffer_array_add_front_shared and constbuffer_array_add_back_shared shall move the edge next to constbuffer_array_handle with interlocked_compare_exchange_64, dec_ref the removed CONSTBUFFER_HANDLEs, inc_ref constbuffer_handle, store it in the slot next to constbuffer_array_handle and return a new handle that shares the storage with constbuffer_array_handle. ]*/
+        else if (constbuffer_array_shared_try_add_in_place(constbuffer_array_handle, constbuffer_handle, add_in_front, result))
+        {
+            CONSTBUFFER_ARRAY_ACCOUNT_CREATED(result);
+        }
+        /*Codes_SRS_CONSTBUFFER_ARRAY_12_016: [ Otherwise constbuffer_array_add_front_shared and constbuffer_array_add_back_shared shall allocate a new shared storage with free slots on both sides, inc_ref and copy in it constbuffer_handle and all the CONSTBUFFER_HANDLEs of constbuffer_array_handle, and return a new handle over the storage. ]*/
+        else if (constbuffer_array_shared_add_with_new_storage(constbuffer_array_handle, constbuffer_handle, add_in_front, result) != 0)
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_12_017: [ If there are any failures then constbuffer_array_add_front_shared and constbuffer_array_add_back_shared shall fail and return NULL. ]*/
+            LogError("failure in constbuffer_array_shared_add_with_new_storage(constbuffer_array_handle=%p, constbuffer_handle=%p, add_in_front=%d, result=%p)",
+                constbuffer_array_handle, constbuffer_handle, add_in_front, result);
+            REFCOUNT_TYPE_DESTROY(CONSTBUFFER_ARRAY_HANDLE_DATA, result);
+            result = NULL;
+        }
+        else
+        {
+            CONSTBUFFER_ARRAY_ACCOUNT_CREATED(result);
+        }
+    }
+    return result;
+}
+
+static CONSTBUFFER_ARRAY_HANDLE constbuffer_array_remove_shared(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle, CONSTBUFFER_HANDLE* constbuffer_handle, bool remove_from_front)
+{
+    CONSTBUFFER_ARRAY_HANDLE result;
+    if (constbuffer_array_handle->nBuffers == 0)
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_12_019: [ If constbuffer_array_handle is empty then constbuffer_array_remove_front_shared and constbuffer_array_remove_back_shared shall fail and return NULL. ]*/
+        LogError("Cannot remove from an empty CONSTBUFFER_ARRAY_HANDLE");
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_12_020: [ constbuffer_array_remove_front_shared and constbuffer_array_remove_back_shared shall allocate memory for a new CONSTBUFFER_ARRAY_HANDLE. ]*/
+        result = REFCOUNT_TYPE_CREATE(CONSTBUFFER_ARRAY_HANDLE_DATA); /*implicit 0*/
+        if (result == NULL)
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_12_024: [ If there are any failures then constbuffer_array_remove_front_shared and constbuffer_array_remove_back_shared shall fail and return NULL. ]*/
+            LogError("failure in REFCOUNT_TYPE_CREATE(CONSTBUFFER_ARRAY_HANDLE_DATA)");
+            /*return as is*/
+        }
+        else
+        {
+            CONSTBUFFER_HANDLE* remaining = constbuffer_array_handle->buffers + (remove_from_front ? 1 : 0);
+            CONSTBUFFER_HANDLE removed = remove_from_front ? constbuffer_array_handle->buffers[0] : constbuffer_array_handle->buffers[constbuffer_array_handle->nBuffers - 1];
+
+            if (constbuffer_array_handle->custom_free == constbuffer_array_shared_storage_release)
+            {
+                /*Codes_SRS_CONSTBUFFER_ARRAY_12_021: [ If constbuffer_array_handle was produced by a constbuffer_array_*_shared function then the new handle shall share the storage of constbuffer_array_handle without the removed CONSTBUFFER_HANDLE. ]*/
+                CONSTBUFFER_ARRAY_SHARED_STORAGE* storage = constbuffer_array_handle->custom_free_context;
+                (void)interlocked_increment(&storage->window_count);
+                constbuffer_array_set_shared_window(result, storage, remaining - storage->slots, constbuffer_array_handle->nBuffers - 1);
+            }
+            else
+            {
+                /*Codes_SRS_CONSTBUFFER_ARRAY_12_022: [ Otherwise the new handle shall reference the CONSTBUFFER_HANDLEs of constbuffer_array_handle (or of the array constbuffer_array_handle was created from by constbuffer_array_create_from_buffer_index_and_count) without the removed one and increment the reference count of that array. ]*/
+                CONSTBUFFER_ARRAY_HANDLE original = (constbuffer_array_handle->custom_free == constbuffer_array_buffer_index_and_count_free) ? constbuffer_array_handle->custom_free_context : constbuffer_array_handle;
+                INC_REF(CONSTBUFFER_ARRAY_HANDLE_DATA, original);
+                result->custom_free = constbuffer_array_buffer_index_and_count_free;
+                result->custom_free_context = original;
+                result->buffers = remaining;
+                result->nBuffers = constbuffer_array_handle->nBuffers - 1;
+                result->all_buffers_size = CONSTBUFFER_ARRAY_ALL_BUFFERS_SIZE_UNKNOWN;
+                result->fingerprint = CONSTBUFFER_ARRAY_FINGERPRINT_UNKNOWN;
+            }
+            CONSTBUFFER_ARRAY_ACCOUNT_CREATED(result);
+
+            /*Codes_SRS_CONSTBUFFER_ARRAY_12_023: [ constbuffer_array_remove_front_shared and constbuffer_array_remove_back_shared shall inc_ref the removed CONSTBUFFER_HANDLE, write it in constbuffer_handle, succeed and return the new handle. ]*/
+            CONSTBUFFER_IncRef(removed);
+            *constbuffer_handle = removed;
+        }
+    }
+    return result;
+}
+
+CONSTBUFFER_ARRAY_HANDLE constbuffer_array_add_front_shared(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle, CONSTBUFFER_HANDLE constbuffer_handle)
+{
+    CONSTBUFFER_ARRAY_HANDLE result;
+    if (
+        /*Codes_SRS_CONSTBUFFER_ARRAY_12_013: [ If constbuffer_array_handle is NULL or constbuffer_handle is NULL then constbuffer_array_add_front_shared and constbuffer_array_add_back_shared shall fail and return NULL. ]*/
+        (constbuffer_array_handle == NULL) ||
+        (constbuffer_handle == NULL)
+        )
+    {
+        LogError("invalid arguments CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle=%p, CONSTBUFFER_HANDLE constbuffer_handle=%p", constbuffer_array_handle, constbuffer_handle);
+        result = NULL;
+    }
+    else
+    {
+        result = constbuffer_array_add_shared(constbuffer_array_handle, constbuffer_handle, true);
+    }
+    return result;
+}
+
+CONSTBUFFER_ARRAY_HANDLE constbuffer_array_add_back_shared(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle, CONSTBUFFER_HANDLE constbuffer_handle)
+{
+    CONSTBUFFER_ARRAY_HANDLE result;
+    if (
+        /*Codes_SRS_CONSTBUFFER_ARRAY_12_013: [ If constbuffer_array_handle is NULL or constbuffer_handle is NULL then constbuffer_array_add_front_shared and constbuffer_array_add_back_shared shall fail and return NULL. ]*/
+        (constbuffer_array_handle == NULL) ||
+        (constbuffer_handle == NULL)
+        )
+    {
+        LogError("invalid arguments CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle=%p, CONSTBUFFER_HANDLE constbuffer_handle=%p", constbuffer_array_handle, constbuffer_handle);
+        result = NULL;
+    }
+    else
+    {
+        result = constbuffer_array_add_shared(constbuffer_array_handle, constbuffer_handle, false);
+    }
+    return result;
+}
+
+CONSTBUFFER_ARRAY_HANDLE constbuffer_array_remove_front_shared(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle, CONSTBUFFER_HANDLE* constbuffer_handle)
+{
+    CONSTBUFFER_ARRAY_HANDLE result;
+    if (
+        /*Codes_SRS_CONSTBUFFER_ARRAY_12_018: [ If constbuffer_array_handle is NULL or constbuffer_handle is NULL then constbuffer_array_remove_front_shared and constbuffer_array_remove_back_shared shall fail and return NULL. ]*/
+        (constbuffer_array_handle == NULL) ||
+        (constbuffer_handle == NULL)
+        )
+    {
+        LogError("invalid arguments CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle=%p, CONSTBUFFER_HANDLE* constbuffer_handle=%p", constbuffer_array_handle, constbuffer_handle);
+        result = NULL;
+    }
+    else
+    {
+        result = constbuffer_array_remove_shared(constbuffer_array_handle, constbuffer_handle, true);
+    }
+    return result;
+}
+
+CONSTBUFFER_ARRAY_HANDLE constbuffer_array_remove_back_shared(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle, CONSTBUFFER_HANDLE* constbuffer_handle)
+{
+    CONSTBUFFER_ARRAY_HANDLE result;
+    if (
+        /*Codes_SRS_CONSTBUFFER_ARRAY_12_018: [ If constbuffer_array_handle is NULL or constbuffer_handle is NULL then constbuffer_array_remove_front_shared and constbuffer_array_remove_back_shared shall fail and return NULL. ]*/
+        (constbuffer_array_handle == NULL) ||
+        (constbuffer_handle == NULL)
+        )
+    {
+        LogError("invalid arguments CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle=%p, CONSTBUFFER_HANDLE* constbuffer_handle=%p", constbuffer_array_handle, constbuffer_handle);
+        result = NULL;
+    }
+    else
+    {
+        result = constbuffer_array_remove_shared(constbuffer_array_handle, constbuffer_handle, false);
+    }
+    return result;
+}
+
 int constbuffer_array_get_buffer_count(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle, uint32_t* buffer_count)
 {
     int result;
@@ -779,6 +1284,7 @@ void constbuffer_array_dec_ref(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle
                 constbuffer_array_handle->custom_free(constbuffer_array_handle->custom_free_context);
             }
 
+            CONSTBUFFER_ARRAY_ACCOUNT_FREED(constbuffer_array_handle);
             REFCOUNT_TYPE_DESTROY(CONSTBUFFER_ARRAY_HANDLE_DATA, constbuffer_array_handle);
         }
     }
@@ -801,36 +1307,26 @@ int constbuffer_array_get_all_buffers_size(CONSTBUFFER_ARRAY_HANDLE constbuffer_
     }
     else
     {
-        uint32_t i;
-        uint32_t total_size = 0;
+        uint64_t total_size;
 
-        for (i = 0; i < constbuffer_array_handle->nBuffers; i++)
+        /* Codes_SRS_CONSTBUFFER_ARRAY_12_084: [ constbuffer_array_get_all_buffers_size shall obtain the total size of all buffers by calling constbuffer_array_get_all_buffers_size_64. ]*/
+        if (constbuffer_array_get_all_buffers_size_64(constbuffer_array_handle, &total_size) != 0)
         {
-            const CONSTBUFFER* content = CONSTBUFFER_GetContent(constbuffer_array_handle->buffers[i]);
-#if SIZE_MAX > UINT32_MAX
-            if (content->size > UINT32_MAX)
-            {
-                break;
-            }
-#endif
-            if (total_size + (uint32_t)content->size < total_size)
-            {
-                break;
-            }
-
-            total_size += (uint32_t)content->size;
+            /* Codes_SRS_CONSTBUFFER_ARRAY_01_021: [ If constbuffer_array_get_all_buffers_size_64 fails or the total size exceeds UINT32_MAX, constbuffer_array_get_all_buffers_size shall fail and return a non-zero value. ]*/
+            LogError("failure in constbuffer_array_get_all_buffers_size_64(constbuffer_array_handle=%p, &total_size=%p)",
+                constbuffer_array_handle, &total_size);
+            result = MU_FAILURE;
         }
-
-        if (i < constbuffer_array_handle->nBuffers)
+        else if (total_size > UINT32_MAX)
         {
-            /* Codes_SRS_CONSTBUFFER_ARRAY_01_021: [ If summing up the sizes results in an uint32_t overflow, shall fail and return a non-zero value. ]*/
-            LogError("Overflow in computing all buffers size");
+            /* Codes_SRS_CONSTBUFFER_ARRAY_01_021: [ If constbuffer_array_get_all_buffers_size_64 fails or the total size exceeds UINT32_MAX, constbuffer_array_get_all_buffers_size shall fail and return a non-zero value. ]*/
+            LogError("Overflow in computing all buffers size, total_size=%" PRIu64 " exceeds UINT32_MAX", total_size);
             result = MU_FAILURE;
         }
         else
         {
             /* Codes_SRS_CONSTBUFFER_ARRAY_01_022: [ Otherwise constbuffer_array_get_all_buffers_size shall write in all_buffers_size the total size of all buffers in the array and return 0. ]*/
-            *all_buffers_size = total_size;
+            *all_buffers_size = (uint32_t)total_size;
             result = 0;
         }
     }
@@ -838,15 +1334,268 @@ int constbuffer_array_get_all_buffers_size(CONSTBUFFER_ARRAY_HANDLE constbuffer_
     return result;
 }
 
-const CONSTBUFFER_HANDLE* constbuffer_array_get_const_buffer_handle_array(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle)
+int constbuffer_array_get_all_buffers_size_64(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle, uint64_t* all_buffers_size)
 {
-    const CONSTBUFFER_HANDLE* result;
+    int result;
 
-    /* Codes_SRS_CONSTBUFFER_ARRAY_01_026: [ If constbuffer_array_handle is NULL, constbuffer_array_get_const_buffer_handle_array shall fail and return NULL. ]*/
-    if (constbuffer_array_handle == NULL)
+    if (
+        /*Codes_SRS_CONSTBUFFER_ARRAY_12_025: [ If constbuffer_array_handle is NULL, constbuffer_array_get_all_buffers_size_64 shall fail and return a non-zero value. ]*/
+        (constbuffer_array_handle == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_ARRAY_12_026: [ If all_buffers_size is NULL, constbuffer_array_get_all_buffers_size_64 shall fail and return a non-zero value. ]*/
+        (all_buffers_size == NULL)
+        )
     {
-        LogError("CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle=%p", constbuffer_array_handle);
-        result = NULL;
+        LogError("CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle=%p, uint64_t* all_buffers_size=%p",
+            constbuffer_array_handle, all_buffers_size);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_12_027: [ If the total size of constbuffer_array_handle is already known, constbuffer_array_get_all_buffers_size_64 shall write it in all_buffers_size and return 0. ]*/
+        int64_t cached_size = interlocked_add_64(&constbuffer_array_handle->all_buffers_size, 0);
+        if (cached_size == CONSTBUFFER_ARRAY_ALL_BUFFERS_SIZE_TOO_BIG)
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_12_029: [ If the total size of constbuffer_array_handle is known to exceed INT64_MAX or the sum exceeds INT64_MAX then constbuffer_array_get_all_buffers_size_64 shall fail and return a non-zero value. ]*/
+            LogError("Overflow in computing all buffers size, the total size of constbuffer_array_handle=%p exceeds INT64_MAX", constbuffer_array_handle);
+            result = MU_FAILURE;
+        }
+        else if (cached_size != CONSTBUFFER_ARRAY_ALL_BUFFERS_SIZE_UNKNOWN)
+        {
+            *all_buffers_size = (uint64_t)cached_size;
+            result = 0;
+        }
+        else
+        {
+            uint32_t i;
+            uint64_t total_size = 0;
+
+            /*Codes_SRS_CONSTBUFFER_ARRAY_12_028: [ Otherwise constbuffer_array_get_all_buffers_size_64 shall sum the sizes of all buffers in the array. ]*/
+            for (i = 0; i < constbuffer_array_handle->nBuffers; i++)
+            {
+                const CONSTBUFFER* content = CONSTBUFFER_GetContent(constbuffer_array_handle->buffers[i]);
+                if (content->size > INT64_MAX - total_size)
+                {
+                    break;
+                }
+                total_size += content->size;
+            }
+
+            if (i < constbuffer_array_handle->nBuffers)
+            {
+                /*Codes_SRS_CONSTBUFFER_ARRAY_12_029: [ If the total size of constbuffer_array_handle is known to exceed INT64_MAX or the sum exceeds INT64_MAX then constbuffer_array_get_all_buffers_size_64 shall fail and return a non-zero value. ]*/
+                LogError("Overflow in computing all buffers size");
+                result = MU_FAILURE;
+            }
+            else
+            {
+                /*Codes_SRS_CONSTBUFFER_ARRAY_12_030: [ constbuffer_array_get_all_buffers_size_64 shall store the sum in constbuffer_array_handle by calling interlocked_exchange_64 (so that subsequent calls do not walk the buffers again), write it in all_buffers_size and return 0. ]*/
+                (void)interlocked_exchange_64(&constbuffer_array_handle->all_buffers_size, (int64_t)total_size);
+                *all_buffers_size = total_size;
+                result = 0;
+            }
+        }
+    }
+
+    return result;
+}
+
+/*copies size bytes from source to destination, with streaming stores when non_temporal is true (the caller issues the store fence once it is done)*/
+static void constbuffer_array_copy_memory(unsigned char* destination, const unsigned char* source, size_t size, bool non_temporal)
+{
+#if defined(CONSTBUFFER_ARRAY_X64)
+    if (non_temporal && size >= 4 * sizeof(__m128i))
+    {
+        /*streaming stores need a 16 byte aligned destination, the source can stay unaligned*/
+        size_t head = (sizeof(__m128i) - ((uintptr_t)destination & (sizeof(__m128i) - 1))) & (sizeof(__m128i) - 1);
+        (void)memcpy(destination, source, head);
+        destination += head;
+        source += head;
+        size -= head;
+
+        while (size >= 4 * sizeof(__m128i))
+        {
+            __m128i block0 = _mm_loadu_si128((const __m128i*)(source + 0 * sizeof(__m128i)));
+            __m128i block1 = _mm_loadu_si128((const __m128i*)(source + 1 * sizeof(__m128i)));
+            __m128i block2 = _mm_loadu_si128((const __m128i*)(source + 2 * sizeof(__m128i)));
+            __m128i block3 = _mm_loadu_si128((const __m128i*)(source + 3 * sizeof(__m128i)));
+            _mm_stream_si128((__m128i*)(destination + 0 * sizeof(__m128i)), block0);
+            _mm_stream_si128((__m128i*)(destination + 1 * sizeof(__m128i)), block1);
+            _mm_stream_si128((__m128i*)(destination + 2 * sizeof(__m128i)), block2);
+            _mm_stream_si128((__m128i*)(destination + 3 * sizeof(__m128i)), block3);
+            destination += 4 * sizeof(__m128i);
+            source += 4 * sizeof(__m128i);
+            size -= 4 * sizeof(__m128i);
+        }
+    }
+#else
+    (void)non_temporal;
+#endif
+    (void)memcpy(destination, source, size);
+}
+
+/*copies length bytes starting at offset (both already validated against the size of the array) into destination*/
+static void constbuffer_array_copy_range(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle, uint64_t offset, uint64_t length, unsigned char* destination)
+{
+    bool non_temporal = (length >= CONSTBUFFER_ARRAY_NON_TEMPORAL_COPY_THRESHOLD);
+
+    for (uint32_t i = 0; (i < constbuffer_array_handle->nBuffers) && (length > 0); i++)
+    {
+        const CONSTBUFFER* content = CONSTBUFFER_GetContent(constbuffer_array_handle->buffers[i]);
+        if (offset >= content->size)
+        {
+            /*also skips the empty buffers*/
+            offset -= content->size;
+        }
+        else
+        {
+            size_t chunk_size = content->size - (size_t)offset;
+            if (chunk_size > length)
+            {
+                chunk_size = (size_t)length;
+            }
+            constbuffer_array_copy_memory(destination, content->buffer + offset, chunk_size, non_temporal);
+            destination += chunk_size;
+            length -= chunk_size;
+            offset = 0;
+        }
+    }
+
+#if defined(CONSTBUFFER_ARRAY_X64)
+    if (non_temporal)
+    {
+        /*streaming stores are weakly ordered, make them visible before the caller uses destination*/
+        _mm_sfence();
+    }
+#endif
+}
+
+int constbuffer_array_copy_to(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle, uint64_t offset, uint64_t length, unsigned char* destination)
+{
+    int result;
+
+    if (
+        /*Codes_SRS_CONSTBUFFER_ARRAY_12_031: [ If constbuffer_array_handle is NULL then constbuffer_array_copy_to shall fail and return a non-zero value. ]*/
+        (constbuffer_array_handle == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_ARRAY_12_032: [ If destination is NULL and length is not 0 then constbuffer_array_copy_to shall fail and return a non-zero value. ]*/
+        ((destination == NULL) && (length != 0))
+        )
+    {
+        LogError("Invalid arguments: CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle=%p, uint64_t offset=%" PRIu64 ", uint64_t length=%" PRIu64 ", unsigned char* destination=%p",
+            constbuffer_array_handle, offset, length, destination);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        uint64_t all_buffers_size;
+
+        /*Codes_SRS_CONSTBUFFER_ARRAY_12_033: [ constbuffer_array_copy_to shall call constbuffer_array_get_all_buffers_size_64 to get the total size of the buffers in constbuffer_array_handle. ]*/
+        if (constbuffer_array_get_all_buffers_size_64(constbuffer_array_handle, &all_buffers_size) != 0)
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_12_036: [ If there are any failures then constbuffer_array_copy_to shall fail and return a non-zero value. ]*/
+            LogError("failure in constbuffer_array_get_all_buffers_size_64(constbuffer_array_handle=%p, &all_buffers_size=%p)", constbuffer_array_handle, &all_buffers_size);
+            result = MU_FAILURE;
+        }
+        /*Codes_SRS_CONSTBUFFER_ARRAY_12_034: [ If offset + length is greater than the total size of the buffers then constbuffer_array_copy_to shall fail and return a non-zero value. ]*/
+        else if (
+            (offset > all_buffers_size) ||
+            (length > all_buffers_size - offset)
+            )
+        {
+            LogError("cannot copy length=%" PRIu64 " bytes from offset=%" PRIu64 " out of all_buffers_size=%" PRIu64 " bytes", length, offset, all_buffers_size);
+            result = MU_FAILURE;
+        }
+        else
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_12_035: [ constbuffer_array_copy_to shall copy length bytes starting at offset from the buffers (as if they were one contiguous buffer, skipping the empty buffers) in destination, succeed and return 0. ]*/
+            constbuffer_array_copy_range(constbuffer_array_handle, offset, length, destination);
+            result = 0;
+        }
+    }
+
+    return result;
+}
+
+CONSTBUFFER_HANDLE constbuffer_array_flatten(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle)
+{
+    CONSTBUFFER_HANDLE result;
+
+    if (constbuffer_array_handle == NULL)
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_12_037: [ If constbuffer_array_handle is NULL then constbuffer_array_flatten shall fail and return NULL. ]*/
+        LogError("Invalid arguments: CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle=%p", constbuffer_array_handle);
+        result = NULL;
+    }
+    else if (constbuffer_array_handle->nBuffers == 1)
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_12_038: [ If constbuffer_array_handle has exactly one buffer then constbuffer_array_flatten shall increment the reference count of that buffer and return it. ]*/
+        CONSTBUFFER_IncRef(constbuffer_array_handle->buffers[0]);
+        result = constbuffer_array_handle->buffers[0];
+    }
+    else
+    {
+        uint64_t all_buffers_size;
+
+        /*Codes_SRS_CONSTBUFFER_ARRAY_12_039: [ Otherwise constbuffer_array_flatten shall call constbuffer_array_get_all_buffers_size_64 to get the total size of the buffers in constbuffer_array_handle. ]*/
+        if (constbuffer_array_get_all_buffers_size_64(constbuffer_array_handle, &all_buffers_size) != 0)
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_12_044: [ If there are any failures then constbuffer_array_flatten shall fail and return NULL. ]*/
+            LogError("failure in constbuffer_array_get_all_buffers_size_64(constbuffer_array_handle=%p, &all_buffers_size=%p)", constbuffer_array_handle, &all_buffers_size);
+            result = NULL;
+        }
+        else if (all_buffers_size > UINT32_MAX)
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_12_040: [ If the total size is greater than UINT32_MAX then constbuffer_array_flatten shall fail and return NULL. ]*/
+            LogError("all_buffers_size=%" PRIu64 " does not fit in a CONSTBUFFER (at most UINT32_MAX=%" PRIu32 " bytes)", all_buffers_size, UINT32_MAX);
+            result = NULL;
+        }
+        else if (all_buffers_size == 0)
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_12_041: [ If the total size is 0 then constbuffer_array_flatten shall call CONSTBUFFER_Create with NULL and 0 and return the result. ]*/
+            result = CONSTBUFFER_Create(NULL, 0);
+            if (result == NULL)
+            {
+                /*Codes_SRS_CONSTBUFFER_ARRAY_12_044: [ If there are any failures then constbuffer_array_flatten shall fail and return NULL. ]*/
+                LogError("failure in CONSTBUFFER_Create(NULL, 0)");
+            }
+        }
+        else
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_12_042: [ constbuffer_array_flatten shall allocate memory for the total size and copy all the buffers in it (skipping the empty buffers). ]*/
+            unsigned char* memory = malloc((size_t)all_buffers_size);
+            if (memory == NULL)
+            {
+                /*Codes_SRS_CONSTBUFFER_ARRAY_12_044: [ If there are any failures then constbuffer_array_flatten shall fail and return NULL. ]*/
+                LogError("failure in malloc(all_buffers_size=%" PRIu64 ")", all_buffers_size);
+                result = NULL;
+            }
+            else
+            {
+                constbuffer_array_copy_range(constbuffer_array_handle, 0, all_buffers_size, memory);
+
+                /*Codes_SRS_CONSTBUFFER_ARRAY_12_043: [ constbuffer_array_flatten shall call CONSTBUFFER_CreateWithMoveMemory with the memory and return the result. ]*/
+                result = CONSTBUFFER_CreateWithMoveMemory(memory, (uint32_t)all_buffers_size);
+                if (result == NULL)
+                {
+                    /*Codes_SRS_CONSTBUFFER_ARRAY_12_044: [ If there are any failures then constbuffer_array_flatten shall fail and return NULL. ]*/
+                    LogError("failure in CONSTBUFFER_CreateWithMoveMemory(memory=%p, all_buffers_size=%" PRIu64 ")", memory, all_buffers_size);
+                    free(memory);
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
+const CONSTBUFFER_HANDLE* constbuffer_array_get_const_buffer_handle_array(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle)
+{
+    const CONSTBUFFER_HANDLE* result;
+
+    /* Codes_SRS_CONSTBUFFER_ARRAY_01_026: [ If constbuffer_array_handle is NULL, constbuffer_array_get_const_buffer_handle_array shall fail and return NULL. ]*/
+    if (constbuffer_array_handle == NULL)
+    {
+        LogError("CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle=%p", constbuffer_array_handle);
+        result = NULL;
     }
     else
     {
@@ -873,15 +1622,17 @@ CONSTBUFFER_ARRAY_HANDLE constbuffer_array_remove_empty_buffers(CONSTBUFFER_ARRA
         /*Codes_SRS_CONSTBUFFER_ARRAY_88_003: [ constbuffer_array_remove_empty_buffers shall examine each buffer in constbuffer_array_handle to determine if it is empty (size equals 0). ]*/
         
         uint32_t non_empty_count = 0;
+        uint64_t all_buffers_size = 0;
         uint32_t i;
         
-        // Count non-empty buffers
+        // Count non-empty buffers (and sum their sizes, the total of the new array is the same as the total of constbuffer_array_handle)
         for (i = 0; i < constbuffer_array_handle->nBuffers; i++)
         {
             const CONSTBUFFER* buffer_content = CONSTBUFFER_GetContent(constbuffer_array_handle->buffers[i]);
             if (buffer_content->size > 0)
             {
                 non_empty_count++;
+                all_buffers_size += buffer_content->size;
             }
         }
         
@@ -914,7 +1665,10 @@ CONSTBUFFER_ARRAY_HANDLE constbuffer_array_remove_empty_buffers(CONSTBUFFER_ARRA
             {
                 result->buffers = result->buffers_memory;
                 result->nBuffers = non_empty_count;
+                result->all_buffers_size = (int64_t)all_buffers_size;
+                result->fingerprint = CONSTBUFFER_ARRAY_FINGERPRINT_UNKNOWN;
                 result->custom_free = NULL;
+                CONSTBUFFER_ARRAY_ACCOUNT_CREATED(result);
                 
                 /*Codes_SRS_CONSTBUFFER_ARRAY_88_007: [ constbuffer_array_remove_empty_buffers shall copy all non-empty buffers from constbuffer_array_handle to the new const buffer array. ]*/
                 /*Codes_SRS_CONSTBUFFER_ARRAY_88_008: [ constbuffer_array_remove_empty_buffers shall increment the reference count of all copied buffers. ]*/
@@ -937,6 +1691,97 @@ CONSTBUFFER_ARRAY_HANDLE constbuffer_array_remove_empty_buffers(CONSTBUFFER_ARRA
     return result;
 }
 
+/*produces a new array where every buffer is transform(buffer) of the corresponding buffer of constbuffer_array_handle*/
+static CONSTBUFFER_ARRAY_HANDLE constbuffer_array_create_transformed(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle, CONSTBUFFER_HANDLE(*transform)(CONSTBUFFER_HANDLE), const char* transform_name)
+{
+    CONSTBUFFER_ARRAY_HANDLE result;
+
+    result = REFCOUNT_TYPE_CREATE_FLEX(CONSTBUFFER_ARRAY_HANDLE_DATA, constbuffer_array_handle->nBuffers, sizeof(CONSTBUFFER_HANDLE));
+    if (result == NULL)
+    {
+        LogError("failure in REFCOUNT_TYPE_CREATE_FLEX(CONSTBUFFER_ARRAY_HANDLE_DATA, constbuffer_array_handle->nBuffers=%" PRIu32 ", sizeof(CONSTBUFFER_HANDLE)=%zu)",
+            constbuffer_array_handle->nBuffers, sizeof(CONSTBUFFER_HANDLE));
+    }
+    else
+    {
+        uint32_t i;
+
+        result->buffers = result->buffers_memory;
+        result->nBuffers = constbuffer_array_handle->nBuffers;
+        result->all_buffers_size = CONSTBUFFER_ARRAY_ALL_BUFFERS_SIZE_UNKNOWN;
+        result->fingerprint = CONSTBUFFER_ARRAY_FINGERPRINT_UNKNOWN;
+        result->custom_free = NULL;
+        CONSTBUFFER_ARRAY_ACCOUNT_CREATED(result);
+
+        for (i = 0; i < constbuffer_array_handle->nBuffers; i++)
+        {
+            result->buffers[i] = transform(constbuffer_array_handle->buffers[i]);
+            if (result->buffers[i] == NULL)
+            {
+                LogError("failure in %s(constbuffer_array_handle->buffers[%" PRIu32 "]=%p)", transform_name, i, constbuffer_array_handle->buffers[i]);
+                break;
+            }
+        }
+
+        if (i < constbuffer_array_handle->nBuffers)
+        {
+            uint32_t j;
+            for (j = 0; j < i; j++)
+            {
+                CONSTBUFFER_DecRef(result->buffers[j]);
+            }
+            CONSTBUFFER_ARRAY_ACCOUNT_FREED(result);
+            REFCOUNT_TYPE_DESTROY(CONSTBUFFER_ARRAY_HANDLE_DATA, result);
+            result = NULL;
+        }
+    }
+    return result;
+}
+
+CONSTBUFFER_ARRAY_HANDLE constbuffer_array_create_compressed(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle)
+{
+    CONSTBUFFER_ARRAY_HANDLE result;
+
+    if (constbuffer_array_handle == NULL)
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_12_001: [ If constbuffer_array_handle is NULL then constbuffer_array_create_compressed shall fail and return NULL. ]*/
+        LogError("Invalid arguments: CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle=%p", constbuffer_array_handle);
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_12_002: [ constbuffer_array_create_compressed shall allocate memory for a new CONSTBUFFER_ARRAY_HANDLE that can hold as many buffers as constbuffer_array_handle. ]*/
+        /*Codes_SRS_CONSTBUFFER_ARRAY_12_003: [ constbuffer_array_create_compressed shall call CONSTBUFFER_CreateCompressed for each buffer of constbuffer_array_handle and store the result in the new const buffer array. ]*/
+        /*Codes_SRS_CONSTBUFFER_ARRAY_12_005: [ If there are any failures then constbuffer_array_create_compressed shall release the buffers it created, fail and return NULL. ]*/
+        result = constbuffer_array_create_transformed(constbuffer_array_handle, CONSTBUFFER_CreateCompressed, "CONSTBUFFER_CreateCompressed");
+
+        /*Codes_SRS_CONSTBUFFER_ARRAY_12_004: [ constbuffer_array_create_compressed shall succeed and return a non-NULL handle. ]*/
+    }
+    return result;
+}
+
+CONSTBUFFER_ARRAY_HANDLE constbuffer_array_create_decompressed(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle)
+{
+    CONSTBUFFER_ARRAY_HANDLE result;
+
+    if (constbuffer_array_handle == NULL)
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_12_006: [ If constbuffer_array_handle is NULL then constbuffer_array_create_decompressed shall fail and return NULL. ]*/
+        LogError("Invalid arguments: CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle=%p", constbuffer_array_handle);
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_12_007: [ constbuffer_array_create_decompressed shall allocate memory for a new CONSTBUFFER_ARRAY_HANDLE that can hold as many buffers as constbuffer_array_handle. ]*/
+        /*Codes_SRS_CONSTBUFFER_ARRAY_12_008: [ constbuffer_array_create_decompressed shall call CONSTBUFFER_Decompress for each buffer of constbuffer_array_handle and store the result in the new const buffer array. ]*/
+        /*Codes_SRS_CONSTBUFFER_ARRAY_12_010: [ If there are any failures then constbuffer_array_create_decompressed shall release the buffers it created, fail and return NULL. ]*/
+        result = constbuffer_array_create_transformed(constbuffer_array_handle, CONSTBUFFER_Decompress, "CONSTBUFFER_Decompress");
+
+        /*Codes_SRS_CONSTBUFFER_ARRAY_12_009: [ constbuffer_array_create_decompressed shall succeed and return a non-NULL handle. ]*/
+    }
+    return result;
+}
+
 bool CONSTBUFFER_ARRAY_HANDLE_contain_same(CONSTBUFFER_ARRAY_HANDLE left, CONSTBUFFER_ARRAY_HANDLE right)
 {
     bool result;
@@ -994,3 +1839,470 @@ bool CONSTBUFFER_ARRAY_HANDLE_contain_same(CONSTBUFFER_ARRAY_HANDLE left, CONSTB
     }
     return result;
 }
+
+int constbuffer_array_get_fingerprint(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle, uint64_t* fingerprint)
+{
+    int result;
+    if (
+        /*Codes_SRS_CONSTBUFFER_ARRAY_12_045: [ If constbuffer_array_handle is NULL then constbuffer_array_get_fingerprint shall fail and return a non-zero value. ]*/
+        (constbuffer_array_handle == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_ARRAY_12_046: [ If fingerprint is NULL then constbuffer_array_get_fingerprint shall fail and return a non-zero value. ]*/
+        (fingerprint == NULL)
+        )
+    {
+        LogError("Invalid arguments: CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle=%p, uint64_t* fingerprint=%p",
+            constbuffer_array_handle, fingerprint);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        int64_t cached_fingerprint = interlocked_add_64(&constbuffer_array_handle->fingerprint, 0);
+        if (cached_fingerprint != CONSTBUFFER_ARRAY_FINGERPRINT_UNKNOWN)
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_12_047: [ If the fingerprint of constbuffer_array_handle is already known then constbuffer_array_get_fingerprint shall write it in fingerprint and return 0. ]*/
+            *fingerprint = (uint64_t)cached_fingerprint;
+            result = 0;
+        }
+        else
+        {
+            uint64_t computed_fingerprint;
+
+            /*Codes_SRS_CONSTBUFFER_ARRAY_12_048: [ Otherwise constbuffer_array_get_fingerprint shall compute the fingerprint by calling constbuffer_array_compute_hash with seed 0 (the same value as hash_compute_hash_64 of the bytes of all buffers). ]*/
+            if (constbuffer_array_compute_hash(constbuffer_array_handle, 0, &computed_fingerprint) != 0)
+            {
+                /*Codes_SRS_CONSTBUFFER_ARRAY_12_085: [ If constbuffer_array_compute_hash fails then constbuffer_array_get_fingerprint shall fail and return a non-zero value. ]*/
+                LogError("failure in constbuffer_array_compute_hash(constbuffer_array_handle=%p, 0, &computed_fingerprint=%p)", constbuffer_array_handle, &computed_fingerprint);
+                result = MU_FAILURE;
+            }
+            else
+            {
+                /*Codes_SRS_CONSTBUFFER_ARRAY_12_049: [ constbuffer_array_get_fingerprint shall store the fingerprint in constbuffer_array_handle by calling interlocked_exchange_64 (so that subsequent calls and constbuffer_array_content_equal do not read the buffers again), write it in fingerprint and return 0. ]*/
+                (void)interlocked_exchange_64(&constbuffer_array_handle->fingerprint, (int64_t)computed_fingerprint);
+                *fingerprint = computed_fingerprint;
+                result = 0;
+            }
+        }
+    }
+    return result;
+}
+
+int constbuffer_array_compute_hash(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle, uint64_t seed, uint64_t* hash)
+{
+    int result;
+    if (
+        /*Codes_SRS_CONSTBUFFER_ARRAY_12_069: [ If constbuffer_array_handle is NULL then constbuffer_array_compute_hash shall fail and return a non-zero value. ]*/
+        (constbuffer_array_handle == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_ARRAY_12_070: [ If hash is NULL then constbuffer_array_compute_hash shall fail and return a non-zero value. ]*/
+        (hash == NULL)
+        )
+    {
+        LogError("Invalid arguments: CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle=%p, uint64_t seed=%" PRIu64 ", uint64_t* hash=%p",
+            constbuffer_array_handle, seed, hash);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        HASH_STATE state;
+
+        /*Codes_SRS_CONSTBUFFER_ARRAY_12_071: [ constbuffer_array_compute_hash shall call hash_init with seed. ]*/
+        if (hash_init(&state, seed) != 0)
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_12_074: [ If there are any failures then constbuffer_array_compute_hash shall fail and return a non-zero value. ]*/
+            LogError("failure in hash_init(&state, seed=%" PRIu64 ")", seed);
+            result = MU_FAILURE;
+        }
+        else
+        {
+            uint32_t i;
+            for (i = 0; i < constbuffer_array_handle->nBuffers; i++)
+            {
+                /*Codes_SRS_CONSTBUFFER_ARRAY_12_072: [ For each buffer of constbuffer_array_handle constbuffer_array_compute_hash shall call CONSTBUFFER_GetContent and hash_update with the content. ]*/
+                const CONSTBUFFER* content = CONSTBUFFER_GetContent(constbuffer_array_handle->buffers[i]);
+                if (hash_update(&state, content->buffer, content->size) != 0)
+                {
+                    LogError("failure in hash_update(&state, content->buffer=%p, content->size=%" PRIu32 ") for buffer %" PRIu32 "",
+                        content->buffer, content->size, i);
+                    break;
+                }
+            }
+
+            if (i != constbuffer_array_handle->nBuffers)
+            {
+                /*Codes_SRS_CONSTBUFFER_ARRAY_12_074: [ If there are any failures then constbuffer_array_compute_hash shall fail and return a non-zero value. ]*/
+                result = MU_FAILURE;
+            }
+            /*Codes_SRS_CONSTBUFFER_ARRAY_12_073: [ constbuffer_array_compute_hash shall call hash_final to write the hash in hash and return 0. ]*/
+            else if (hash_final(&state, hash) != 0)
+            {
+                /*Codes_SRS_CONSTBUFFER_ARRAY_12_074: [ If there are any failures then constbuffer_array_compute_hash shall fail and return a non-zero value. ]*/
+                LogError("failure in hash_final(&state, hash=%p)", hash);
+                result = MU_FAILURE;
+            }
+            else
+            {
+                result = 0;
+            }
+        }
+    }
+    return result;
+}
+
+/*returns true when the size bytes at left and right are the same*/
+static bool constbuffer_array_memory_equal(const unsigned char* left, const unsigned char* right, size_t size)
+{
+    bool result;
+    if (left == right)
+    {
+        /*the same memory, for example the same buffer in both arrays*/
+        result = true;
+    }
+    else
+    {
+#if defined(CONSTBUFFER_ARRAY_X64)
+        /*the differences of 4 blocks are ORed together so that there is only one branch every 64 bytes, the block that differs is found by memcmp below*/
+        while (size >= 4 * sizeof(__m128i))
+        {
+            __m128i difference0 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(left + 0 * sizeof(__m128i))), _mm_loadu_si128((const __m128i*)(right + 0 * sizeof(__m128i))));
+            __m128i difference1 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(left + 1 * sizeof(__m128i))), _mm_loadu_si128((const __m128i*)(right + 1 * sizeof(__m128i))));
+            __m128i difference2 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(left + 2 * sizeof(__m128i))), _mm_loadu_si128((const __m128i*)(right + 2 * sizeof(__m128i))));
+            __m128i difference3 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(left + 3 * sizeof(__m128i))), _mm_loadu_si128((const __m128i*)(right + 3 * sizeof(__m128i))));
+            __m128i difference = _mm_or_si128(_mm_or_si128(difference0, difference1), _mm_or_si128(difference2, difference3));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi8(difference, _mm_setzero_si128())) != 0xFFFF)
+            {
+                break;
+            }
+            left += 4 * sizeof(__m128i);
+            right += 4 * sizeof(__m128i);
+            size -= 4 * sizeof(__m128i);
+        }
+#endif
+        result = (memcmp(left, right, size) == 0);
+    }
+    return result;
+}
+
+/*compares the size bytes of left and right (which both have size bytes), a chunk at a time where a chunk ends at the end of a buffer of either array*/
+static bool constbuffer_array_bytes_equal(CONSTBUFFER_ARRAY_HANDLE left, CONSTBUFFER_ARRAY_HANDLE right, uint64_t size)
+{
+    bool result = true;
+    uint32_t left_index = 0;
+    uint32_t right_index = 0;
+    const unsigned char* left_bytes = NULL;
+    const unsigned char* right_bytes = NULL;
+    uint32_t left_remaining = 0;
+    uint32_t right_remaining = 0;
+
+    while (size > 0)
+    {
+        /*there are bytes left in both arrays, so these skip the empty buffers without going past the last buffer*/
+        while (left_remaining == 0)
+        {
+            const CONSTBUFFER* content = CONSTBUFFER_GetContent(left->buffers[left_index++]);
+            left_bytes = content->buffer;
+            left_remaining = content->size;
+        }
+        while (right_remaining == 0)
+        {
+            const CONSTBUFFER* content = CONSTBUFFER_GetContent(right->buffers[right_index++]);
+            right_bytes = content->buffer;
+            right_remaining = content->size;
+        }
+
+        uint32_t chunk_size = (left_remaining < right_remaining) ? left_remaining : right_remaining;
+        if (!constbuffer_array_memory_equal(left_bytes, right_bytes, chunk_size))
+        {
+            result = false;
+            break;
+        }
+        left_bytes += chunk_size;
+        left_remaining -= chunk_size;
+        right_bytes += chunk_size;
+        right_remaining -= chunk_size;
+        size -= chunk_size;
+    }
+    return result;
+}
+
+bool constbuffer_array_content_equal(CONSTBUFFER_ARRAY_HANDLE left, CONSTBUFFER_ARRAY_HANDLE right)
+{
+    bool result;
+    if ((left == NULL) || (right == NULL))
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_12_050: [ If left is NULL or right is NULL then constbuffer_array_content_equal shall return true when both are NULL and false otherwise. ]*/
+        result = (left == right);
+    }
+    else if (left == right)
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_12_051: [ If left and right are the same array then constbuffer_array_content_equal shall return true. ]*/
+        result = true;
+    }
+    else
+    {
+        uint64_t left_size;
+        uint64_t right_size;
+
+        /*Codes_SRS_CONSTBUFFER_ARRAY_12_052: [ constbuffer_array_content_equal shall call constbuffer_array_get_all_buffers_size_64 on left and right. ]*/
+        if (
+            (constbuffer_array_get_all_buffers_size_64(left, &left_size) != 0) ||
+            (constbuffer_array_get_all_buffers_size_64(right, &right_size) != 0)
+            )
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_12_053: [ If getting the sizes fails then constbuffer_array_content_equal shall return false. ]*/
+            LogError("failure in constbuffer_array_get_all_buffers_size_64(left=%p, right=%p)", left, right);
+            result = false;
+        }
+        else if (left_size != right_size)
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_12_054: [ If the sizes of left and right are different then constbuffer_array_content_equal shall return false. ]*/
+            result = false;
+        }
+        else
+        {
+            int64_t left_fingerprint = interlocked_add_64(&left->fingerprint, 0);
+            int64_t right_fingerprint = interlocked_add_64(&right->fingerprint, 0);
+            if (
+                (left_fingerprint != CONSTBUFFER_ARRAY_FINGERPRINT_UNKNOWN) &&
+                (right_fingerprint != CONSTBUFFER_ARRAY_FINGERPRINT_UNKNOWN) &&
+                (left_fingerprint != right_fingerprint)
+                )
+            {
+                /*Codes_SRS_CONSTBUFFER_ARRAY_12_055: [ If the fingerprints of left and right are both known (computed by constbuffer_array_get_fingerprint) and are different then constbuffer_array_content_equal shall return false without reading the buffers. ]*/
+                result = false;
+            }
+            else
+            {
+                /*Codes_SRS_CONSTBUFFER_ARRAY_12_056: [ Otherwise constbuffer_array_content_equal shall compare the bytes of left and right as if each array was one contiguous buffer (regardless of how the bytes are split in buffers) and return true if they are the same and false otherwise. ]*/
+                result = constbuffer_array_bytes_equal(left, right, left_size);
+            }
+        }
+    }
+    return result;
+}
+
+#if defined(CONSTBUFFER_ARRAY_X64)
+static uint32_t constbuffer_array_lowest_set_bit(uint32_t mask)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    (void)_BitScanForward(&index, mask);
+    return (uint32_t)index;
+#else
+    return (uint32_t)__builtin_ctz(mask);
+#endif
+}
+#endif
+
+/*looks for the pattern at the positions [from, last_start] of bytes (the whole pattern is in bytes for all these positions, so from <= last_start
+and last_start + pattern_length <= size of bytes). Returns true and writes the position in found if there is a match*/
+static bool constbuffer_array_find_in_bytes(const unsigned char* bytes, uint32_t from, uint32_t last_start, const unsigned char* pattern, uint32_t pattern_length, uint32_t* found)
+{
+    bool result = false;
+    uint32_t position = from;
+
+    if (pattern_length == 1)
+    {
+        /*memchr of the CRT is already vectorized*/
+        const unsigned char* match = memchr(bytes + position, pattern[0], last_start - position + 1);
+        if (match != NULL)
+        {
+            *found = (uint32_t)(match - bytes);
+            result = true;
+        }
+    }
+    else
+    {
+        const unsigned char first = pattern[0];
+        const unsigned char last = pattern[pattern_length - 1];
+
+#if defined(CONSTBUFFER_ARRAY_X64)
+        /*16 positions per iteration: a position is a candidate when both its first and its last byte match the pattern, only the candidates
+        compare the bytes in between. This skips most of the positions where just the first byte matches (for example the first byte of a delimiter
+        that is common in the payload)*/
+        const __m128i first_block = _mm_set1_epi8((char)first);
+        const __m128i last_block = _mm_set1_epi8((char)last);
+        while (last_start - position >= sizeof(__m128i) - 1)
+        {
+            __m128i first_equal = _mm_cmpeq_epi8(first_block, _mm_loadu_si128((const __m128i*)(bytes + position)));
+            __m128i last_equal = _mm_cmpeq_epi8(last_block, _mm_loadu_si128((const __m128i*)(bytes + position + pattern_length - 1)));
+            uint32_t candidates = (uint32_t)_mm_movemask_epi8(_mm_and_si128(first_equal, last_equal));
+            while (candidates != 0)
+            {
+                uint32_t candidate = position + constbuffer_array_lowest_set_bit(candidates);
+                if (memcmp(bytes + candidate + 1, pattern + 1, pattern_length - 2) == 0)
+                {
+                    *found = candidate;
+                    result = true;
+                    break;
+                }
+                candidates &= candidates - 1;
+            }
+
+            if (result)
+            {
+                break;
+            }
+            position += sizeof(__m128i);
+            if (position > last_start)
+            {
+                break;
+            }
+        }
+
+        if (!result && (position <= last_start))
+#endif
+        {
+            /*the positions that are left (all of them when there is no SSE2): memchr finds the next first byte*/
+            while (position <= last_start)
+            {
+                const unsigned char* candidate = memchr(bytes + position, first, last_start - position + 1);
+                if (candidate == NULL)
+                {
+                    break;
+                }
+                if (
+                    (candidate[pattern_length - 1] == last) &&
+                    (memcmp(candidate + 1, pattern + 1, pattern_length - 2) == 0)
+                    )
+                {
+                    *found = (uint32_t)(candidate - bytes);
+                    result = true;
+                    break;
+                }
+                position = (uint32_t)(candidate - bytes) + 1;
+            }
+        }
+    }
+    return result;
+}
+
+/*returns true when the bytes of the buffers from buffer_index on start with the length bytes at pattern (false when the buffers end before that)*/
+static bool constbuffer_array_buffers_start_with(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle, uint32_t buffer_index, const unsigned char* pattern, uint32_t length)
+{
+    bool result = true;
+    while (length > 0)
+    {
+        if (buffer_index == constbuffer_array_handle->nBuffers)
+        {
+            result = false;
+            break;
+        }
+
+        const CONSTBUFFER* content = CONSTBUFFER_GetContent(constbuffer_array_handle->buffers[buffer_index++]);
+        uint32_t chunk_size = (content->size < length) ? content->size : length;
+        if (
+            (chunk_size > 0) &&
+            (memcmp(content->buffer, pattern, chunk_size) != 0)
+            )
+        {
+            result = false;
+            break;
+        }
+        pattern += chunk_size;
+        length -= chunk_size;
+    }
+    return result;
+}
+
+static CONSTBUFFER_ARRAY_FIND_RESULT constbuffer_array_find_pattern(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle, const unsigned char* pattern, uint32_t pattern_length, uint64_t start_offset, CONSTBUFFER_ARRAY_POSITION* position)
+{
+    CONSTBUFFER_ARRAY_FIND_RESULT result = CONSTBUFFER_ARRAY_FIND_RESULT_NOT_FOUND;
+    uint64_t buffer_start = 0;
+
+    for (uint32_t i = 0; i < constbuffer_array_handle->nBuffers; i++)
+    {
+        const CONSTBUFFER* content = CONSTBUFFER_GetContent(constbuffer_array_handle->buffers[i]);
+        if (start_offset < buffer_start + content->size)
+        {
+            /*positions [from, size) of this buffer are searched. The positions up to size - pattern_length have the whole pattern in this buffer,
+            the ones after that need the bytes of the next buffers*/
+            uint32_t from = (start_offset > buffer_start) ? (uint32_t)(start_offset - buffer_start) : 0;
+            uint32_t straddle_from = (content->size >= pattern_length) ? content->size - pattern_length + 1 : 0;
+            uint32_t found;
+
+            if (
+                (from < straddle_from) &&
+                constbuffer_array_find_in_bytes(content->buffer, from, straddle_from - 1, pattern, pattern_length, &found)
+                )
+            {
+                result = CONSTBUFFER_ARRAY_FIND_RESULT_OK;
+            }
+            else
+            {
+                for (found = (from > straddle_from) ? from : straddle_from; found < content->size; found++)
+                {
+                    uint32_t in_buffer = content->size - found;
+                    if (
+                        (memcmp(content->buffer + found, pattern, in_buffer) == 0) &&
+                        constbuffer_array_buffers_start_with(constbuffer_array_handle, i + 1, pattern + in_buffer, pattern_length - in_buffer)
+                        )
+                    {
+                        result = CONSTBUFFER_ARRAY_FIND_RESULT_OK;
+                        break;
+                    }
+                }
+            }
+
+            if (result == CONSTBUFFER_ARRAY_FIND_RESULT_OK)
+            {
+                position->offset = buffer_start + found;
+                position->buffer_index = i;
+                position->buffer_offset = found;
+                break;
+            }
+        }
+        buffer_start += content->size;
+    }
+    return result;
+}
+
+CONSTBUFFER_ARRAY_FIND_RESULT constbuffer_array_find(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle, const unsigned char* pattern, uint32_t pattern_length, uint64_t start_offset, CONSTBUFFER_ARRAY_POSITION* position)
+{
+    CONSTBUFFER_ARRAY_FIND_RESULT result;
+    if (
+        /*Codes_SRS_CONSTBUFFER_ARRAY_12_057: [ If constbuffer_array_handle is NULL then constbuffer_array_find shall fail and return CONSTBUFFER_ARRAY_FIND_RESULT_INVALID_ARG. ]*/
+        (constbuffer_array_handle == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_ARRAY_12_058: [ If pattern is NULL then constbuffer_array_find shall fail and return CONSTBUFFER_ARRAY_FIND_RESULT_INVALID_ARG. ]*/
+        (pattern == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_ARRAY_12_059: [ If pattern_length is 0 then constbuffer_array_find shall fail and return CONSTBUFFER_ARRAY_FIND_RESULT_INVALID_ARG. ]*/
+        (pattern_length == 0) ||
+        /*Codes_SRS_CONSTBUFFER_ARRAY_12_060: [ If position is NULL then constbuffer_array_find shall fail and return CONSTBUFFER_ARRAY_FIND_RESULT_INVALID_ARG. ]*/
+        (position == NULL)
+        )
+    {
+        LogError("Invalid arguments: CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle=%p, const unsigned char* pattern=%p, uint32_t pattern_length=%" PRIu32 ", uint64_t start_offset=%" PRIu64 ", CONSTBUFFER_ARRAY_POSITION* position=%p",
+            constbuffer_array_handle, pattern, pattern_length, start_offset, position);
+        result = CONSTBUFFER_ARRAY_FIND_RESULT_INVALID_ARG;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_12_061: [ constbuffer_array_find shall look for the first position at or after start_offset where the bytes of the array (seen as one contiguous buffer, so that a match can span several buffers) are the pattern_length bytes of pattern. ]*/
+        /*Codes_SRS_CONSTBUFFER_ARRAY_12_062: [ If there is such a position then constbuffer_array_find shall write in position its offset from the start of the array, the index of the buffer where the match starts and the offset of the match in that buffer and return CONSTBUFFER_ARRAY_FIND_RESULT_OK. ]*/
+        /*Codes_SRS_CONSTBUFFER_ARRAY_12_063: [ Otherwise (including when start_offset is not less than the size of the array) constbuffer_array_find shall return CONSTBUFFER_ARRAY_FIND_RESULT_NOT_FOUND. ]*/
+        result = constbuffer_array_find_pattern(constbuffer_array_handle, pattern, pattern_length, start_offset, position);
+    }
+    return result;
+}
+
+CONSTBUFFER_ARRAY_FIND_RESULT constbuffer_array_find_byte(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle, unsigned char value, uint64_t start_offset, CONSTBUFFER_ARRAY_POSITION* position)
+{
+    CONSTBUFFER_ARRAY_FIND_RESULT result;
+    if (
+        /*Codes_SRS_CONSTBUFFER_ARRAY_12_064: [ If constbuffer_array_handle is NULL then constbuffer_array_find_byte shall fail and return CONSTBUFFER_ARRAY_FIND_RESULT_INVALID_ARG. ]*/
+        (constbuffer_array_handle == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_ARRAY_12_065: [ If position is NULL then constbuffer_array_find_byte shall fail and return CONSTBUFFER_ARRAY_FIND_RESULT_INVALID_ARG. ]*/
+        (position == NULL)
+        )
+    {
+        LogError("Invalid arguments: CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle=%p, unsigned char value=%u, uint64_t start_offset=%" PRIu64 ", CONSTBUFFER_ARRAY_POSITION* position=%p",
+            constbuffer_array_handle, (unsigned int)value, start_offset, position);
+        result = CONSTBUFFER_ARRAY_FIND_RESULT_INVALID_ARG;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_12_066: [ constbuffer_array_find_byte shall look for the first byte at or after start_offset that is value. ]*/
+        /*Codes_SRS_CONSTBUFFER_ARRAY_12_067: [ If there is such a byte then constbuffer_array_find_byte shall write in position its offset from the start of the array, the index of its buffer and its offset in that buffer and return CONSTBUFFER_ARRAY_FIND_RESULT_OK. ]*/
+        /*Codes_SRS_CONSTBUFFER_ARRAY_12_068: [ Otherwise (including when start_offset is not less than the size of the array) constbuffer_array_find_byte shall return CONSTBUFFER_ARRAY_FIND_RESULT_NOT_FOUND. ]*/
+        result = constbuffer_array_find_pattern(constbuffer_array_handle, &value, 1, start_offset, position);
+    }
+    return result;
+}
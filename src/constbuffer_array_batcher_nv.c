@@ -1,17 +1,52 @@
 // Copyright (C) Microsoft Corporation. All rights reserved.
 
 #include <stdlib.h>
+#include <stdbool.h>
 #include <inttypes.h>
 
+#include "macro_utils/macro_utils.h"
+
 #include "c_logging/logger.h"
 
 #include "c_pal/gballoc_hl.h"
 #include "c_pal/gballoc_hl_redirect.h"
 
 #include "c_util/memory_data.h"
+#include "c_util/constbuffer.h"
+#include "c_util/constbuffer_array.h"
 
 #include "c_util/constbuffer_array_batcher_nv.h"
 
+MU_DEFINE_ENUM_STRINGS(CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_RESULT, CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_RESULT_VALUES);
+
+#define BUILDER_INITIAL_PAYLOAD_CAPACITY 8
+#define BUILDER_INITIAL_BUFFER_CAPACITY 16
+
+/*same limit as constbuffer_array_batcher_nv_batch has for count*/
+#define BUILDER_MAX_PAYLOAD_COUNT ((uint32_t)(UINT32_MAX / sizeof(uint32_t) - 1))
+
+typedef struct CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_TAG
+{
+    uint32_t max_payload_count;
+    uint64_t max_batch_size;
+
+    uint32_t payload_count;
+    uint32_t payload_capacity;
+    uint32_t* payload_buffer_counts; /*what goes in the header after the payload count*/
+    uint64_t payloads_size; /*bytes of all the payloads, without the header*/
+
+    uint32_t buffer_count;
+    uint32_t buffer_capacity;
+    CONSTBUFFER_HANDLE* buffers; /*buffers[0] is reserved for the header, owns a reference on buffers[1..buffer_count-1]*/
+} CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER;
+
+typedef struct CONSTBUFFER_ARRAY_BATCHER_NV_VIEW_TAG
+{
+    CONSTBUFFER_ARRAY_HANDLE batch;
+    uint32_t payload_count;
+    uint32_t first_buffer_index[]; /*payload_count + 1 values, payload i is made of the buffers [first_buffer_index[i], first_buffer_index[i + 1]) of batch*/
+} CONSTBUFFER_ARRAY_BATCHER_NV_VIEW;
+
 CONSTBUFFER_ARRAY_HANDLE constbuffer_array_batcher_nv_batch(CONSTBUFFER_ARRAY_HANDLE* payloads, uint32_t count)
 {
     CONSTBUFFER_ARRAY_HANDLE result;
@@ -325,3 +360,635 @@ CONSTBUFFER_ARRAY_HANDLE* constbuffer_array_batcher_nv_unbatch(CONSTBUFFER_ARRAY
 all_ok:
     return result;
 }
+
+CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_HANDLE constbuffer_array_batcher_nv_builder_create(uint32_t max_payload_count, uint64_t max_batch_size)
+{
+    CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_HANDLE result;
+
+    if (
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_001: [ If max_payload_count is 0 then constbuffer_array_batcher_nv_builder_create shall fail and return NULL. ]*/
+        (max_payload_count == 0) ||
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_002: [ If max_batch_size is 0 then constbuffer_array_batcher_nv_builder_create shall fail and return NULL. ]*/
+        (max_batch_size == 0)
+        )
+    {
+        LogError("invalid arguments uint32_t max_payload_count=%" PRIu32 ", uint64_t max_batch_size=%" PRIu64 "",
+            max_payload_count, max_batch_size);
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_003: [ constbuffer_array_batcher_nv_builder_create shall allocate memory for a new CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_HANDLE. ]*/
+        result = malloc(sizeof(CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER));
+        if (result == NULL)
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_006: [ If there are any failures then constbuffer_array_batcher_nv_builder_create shall fail and return NULL. ]*/
+            LogError("failure in malloc(sizeof(CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER)=%zu)", sizeof(CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER));
+            /*return as is*/
+        }
+        else
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_004: [ constbuffer_array_batcher_nv_builder_create shall allocate memory for the buffer counts of the payloads and for the CONSTBUFFER_HANDLEs of the batch. ]*/
+            result->payload_capacity = BUILDER_INITIAL_PAYLOAD_CAPACITY;
+            result->payload_buffer_counts = malloc_2(result->payload_capacity, sizeof(uint32_t));
+            if (result->payload_buffer_counts == NULL)
+            {
+                /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_006: [ If there are any failures then constbuffer_array_batcher_nv_builder_create shall fail and return NULL. ]*/
+                LogError("failure in malloc_2(result->payload_capacity=%" PRIu32 ", sizeof(uint32_t)=%zu)", result->payload_capacity, sizeof(uint32_t));
+            }
+            else
+            {
+                result->buffer_capacity = BUILDER_INITIAL_BUFFER_CAPACITY;
+                result->buffers = malloc_2(result->buffer_capacity, sizeof(CONSTBUFFER_HANDLE));
+                if (result->buffers == NULL)
+                {
+                    /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_006: [ If there are any failures then constbuffer_array_batcher_nv_builder_create shall fail and return NULL. ]*/
+                    LogError("failure in malloc_2(result->buffer_capacity=%" PRIu32 ", sizeof(CONSTBUFFER_HANDLE)=%zu)", result->buffer_capacity, sizeof(CONSTBUFFER_HANDLE));
+                }
+                else
+                {
+                    /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_005: [ constbuffer_array_batcher_nv_builder_create shall succeed and return a non-NULL handle that holds no payloads. ]*/
+                    result->max_payload_count = max_payload_count;
+                    result->max_batch_size = max_batch_size;
+                    result->payload_count = 0;
+                    result->payloads_size = 0;
+                    result->buffer_count = 1; /*the header*/
+                    result->buffers[0] = NULL;
+                    goto all_ok;
+                }
+                free(result->payload_buffer_counts);
+            }
+            free(result);
+            result = NULL;
+        }
+    }
+all_ok:
+    return result;
+}
+
+void constbuffer_array_batcher_nv_builder_destroy(CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_HANDLE builder)
+{
+    if (builder == NULL)
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_007: [ If builder is NULL then constbuffer_array_batcher_nv_builder_destroy shall return. ]*/
+        LogError("invalid argument CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_HANDLE builder=%p", builder);
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_008: [ constbuffer_array_batcher_nv_builder_destroy shall decrement the reference count of all the buffers of the payloads held by builder and free all used resources. ]*/
+        for (uint32_t i = 1; i < builder->buffer_count; i++)
+        {
+            CONSTBUFFER_DecRef(builder->buffers[i]);
+        }
+        free(builder->buffers);
+        free(builder->payload_buffer_counts);
+        free(builder);
+    }
+}
+
+/*true when a payload of payload_buffer_count buffers and payload_size bytes can be added to the batch*/
+static bool constbuffer_array_batcher_nv_builder_fits(CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_HANDLE builder, uint32_t payload_buffer_count, uint64_t payload_size)
+{
+    bool result;
+    if (
+        (builder->payload_count == BUILDER_MAX_PAYLOAD_COUNT) ||
+        (payload_buffer_count > UINT32_MAX - builder->buffer_count)
+        )
+    {
+        result = false;
+    }
+    else if (builder->payload_count == 0)
+    {
+        result = true;
+    }
+    else if (builder->payload_count >= builder->max_payload_count)
+    {
+        result = false;
+    }
+    else
+    {
+        uint64_t header_size = ((uint64_t)builder->payload_count + 2) * sizeof(uint32_t);
+        result =
+            (header_size <= builder->max_batch_size) &&
+            (builder->payloads_size <= builder->max_batch_size - header_size) &&
+            (payload_size <= builder->max_batch_size - header_size - builder->payloads_size);
+    }
+    return result;
+}
+
+/*makes room for at least needed items in *items by doubling *capacity (up to UINT32_MAX), *items and *capacity are unchanged on failure*/
+static int constbuffer_array_batcher_nv_builder_reserve(void** items, uint32_t* capacity, uint32_t needed, size_t item_size)
+{
+    int result;
+    if (needed <= *capacity)
+    {
+        result = 0;
+    }
+    else
+    {
+        uint32_t new_capacity = *capacity;
+        while (new_capacity < needed)
+        {
+            new_capacity = (new_capacity > UINT32_MAX / 2) ? UINT32_MAX : new_capacity * 2;
+        }
+
+        void* new_items = realloc_2(*items, new_capacity, item_size);
+        if (new_items == NULL)
+        {
+            LogError("failure in realloc_2(*items=%p, new_capacity=%" PRIu32 ", item_size=%zu)", *items, new_capacity, item_size);
+            result = MU_FAILURE;
+        }
+        else
+        {
+            *items = new_items;
+            *capacity = new_capacity;
+            result = 0;
+        }
+    }
+    return result;
+}
+
+CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_RESULT constbuffer_array_batcher_nv_builder_append(CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_HANDLE builder, CONSTBUFFER_ARRAY_HANDLE payload)
+{
+    CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_RESULT result;
+
+    if (
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_009: [ If builder is NULL then constbuffer_array_batcher_nv_builder_append shall fail and return CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_INVALID_ARGS. ]*/
+        (builder == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_010: [ If payload is NULL then constbuffer_array_batcher_nv_builder_append shall fail and return CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_INVALID_ARGS. ]*/
+        (payload == NULL)
+        )
+    {
+        LogError("invalid arguments CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_HANDLE builder=%p, CONSTBUFFER_ARRAY_HANDLE payload=%p", builder, payload);
+        result = CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_INVALID_ARGS;
+    }
+    else
+    {
+        uint32_t payload_buffer_count;
+        uint64_t payload_size;
+
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_011: [ constbuffer_array_batcher_nv_builder_append shall get the number of buffers of payload by calling constbuffer_array_get_buffer_count and its size by calling constbuffer_array_get_all_buffers_size_64. ]*/
+        (void)constbuffer_array_get_buffer_count(payload, &payload_buffer_count);
+        if (constbuffer_array_get_all_buffers_size_64(payload, &payload_size) != 0)
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_015: [ If there are any failures then constbuffer_array_batcher_nv_builder_append shall fail, leave builder unchanged and return CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_ERROR. ]*/
+            LogError("failure in constbuffer_array_get_all_buffers_size_64(payload=%p, &payload_size=%p)", payload, &payload_size);
+            result = CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_ERROR;
+        }
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_012: [ If builder holds at least one payload and adding payload would take the batch over max_payload_count payloads, over max_batch_size bytes (header included), over UINT32_MAX / sizeof(uint32_t) - 1 payloads or over UINT32_MAX buffers then constbuffer_array_batcher_nv_builder_append shall leave builder unchanged and return CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_FULL. ]*/
+        else if (!constbuffer_array_batcher_nv_builder_fits(builder, payload_buffer_count, payload_size))
+        {
+            result = CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_FULL;
+        }
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_013: [ constbuffer_array_batcher_nv_builder_append shall make room for the buffer count of payload and for its CONSTBUFFER_HANDLEs by doubling the capacity of the arrays that hold them (calling realloc_2) as needed. ]*/
+        else if (constbuffer_array_batcher_nv_builder_reserve((void**)&builder->payload_buffer_counts, &builder->payload_capacity, builder->payload_count + 1, sizeof(uint32_t)) != 0)
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_015: [ If there are any failures then constbuffer_array_batcher_nv_builder_append shall fail, leave builder unchanged and return CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_ERROR. ]*/
+            LogError("failure reserving room for payload %" PRIu32 "", builder->payload_count);
+            result = CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_ERROR;
+        }
+        else if (constbuffer_array_batcher_nv_builder_reserve((void**)&builder->buffers, &builder->buffer_capacity, builder->buffer_count + payload_buffer_count, sizeof(CONSTBUFFER_HANDLE)) != 0)
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_015: [ If there are any failures then constbuffer_array_batcher_nv_builder_append shall fail, leave builder unchanged and return CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_ERROR. ]*/
+            LogError("failure reserving room for %" PRIu32 " more buffers", payload_buffer_count);
+            result = CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_ERROR;
+        }
+        else
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_014: [ constbuffer_array_batcher_nv_builder_append shall store the buffers of payload (obtained with constbuffer_array_get_buffer) after the buffers already held by builder, record the buffer count and the size of payload, succeed and return CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_OK. ]*/
+            for (uint32_t i = 0; i < payload_buffer_count; i++)
+            {
+                builder->buffers[builder->buffer_count++] = constbuffer_array_get_buffer(payload, i);
+            }
+            builder->payload_buffer_counts[builder->payload_count++] = payload_buffer_count;
+            builder->payloads_size += payload_size;
+            result = CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_OK;
+        }
+    }
+    return result;
+}
+
+int constbuffer_array_batcher_nv_builder_can_append(CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_HANDLE builder, CONSTBUFFER_ARRAY_HANDLE payload, bool* fits)
+{
+    int result;
+
+    if (
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_016: [ If builder is NULL then constbuffer_array_batcher_nv_builder_can_append shall fail and return a non-zero value. ]*/
+        (builder == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_017: [ If payload is NULL then constbuffer_array_batcher_nv_builder_can_append shall fail and return a non-zero value. ]*/
+        (payload == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_018: [ If fits is NULL then constbuffer_array_batcher_nv_builder_can_append shall fail and return a non-zero value. ]*/
+        (fits == NULL)
+        )
+    {
+        LogError("invalid arguments CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_HANDLE builder=%p, CONSTBUFFER_ARRAY_HANDLE payload=%p, bool* fits=%p", builder, payload, fits);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        uint32_t payload_buffer_count;
+        uint64_t payload_size;
+
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_019: [ constbuffer_array_batcher_nv_builder_can_append shall get the number of buffers of payload by calling constbuffer_array_get_buffer_count and its size by calling constbuffer_array_get_all_buffers_size_64. ]*/
+        (void)constbuffer_array_get_buffer_count(payload, &payload_buffer_count);
+        if (constbuffer_array_get_all_buffers_size_64(payload, &payload_size) != 0)
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_021: [ If there are any failures then constbuffer_array_batcher_nv_builder_can_append shall fail and return a non-zero value. ]*/
+            LogError("failure in constbuffer_array_get_all_buffers_size_64(payload=%p, &payload_size=%p)", payload, &payload_size);
+            result = MU_FAILURE;
+        }
+        else
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_020: [ constbuffer_array_batcher_nv_builder_can_append shall write in fits false if constbuffer_array_batcher_nv_builder_append would return CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_FULL for payload and true otherwise, succeed and return 0. ]*/
+            *fits = constbuffer_array_batcher_nv_builder_fits(builder, payload_buffer_count, payload_size);
+            result = 0;
+        }
+    }
+    return result;
+}
+
+int constbuffer_array_batcher_nv_builder_get_size(CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_HANDLE builder, uint32_t* payload_count, uint64_t* batch_size)
+{
+    int result;
+
+    if (
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_022: [ If builder is NULL then constbuffer_array_batcher_nv_builder_get_size shall fail and return a non-zero value. ]*/
+        (builder == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_023: [ If payload_count is NULL then constbuffer_array_batcher_nv_builder_get_size shall fail and return a non-zero value. ]*/
+        (payload_count == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_024: [ If batch_size is NULL then constbuffer_array_batcher_nv_builder_get_size shall fail and return a non-zero value. ]*/
+        (batch_size == NULL)
+        )
+    {
+        LogError("invalid arguments CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_HANDLE builder=%p, uint32_t* payload_count=%p, uint64_t* batch_size=%p", builder, payload_count, batch_size);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_025: [ constbuffer_array_batcher_nv_builder_get_size shall write in payload_count the number of payloads held by builder and in batch_size the size of the header ((payload_count + 1) * sizeof(uint32_t)) plus the size of all the payloads, succeed and return 0. ]*/
+        *payload_count = builder->payload_count;
+        *batch_size = ((uint64_t)builder->payload_count + 1) * sizeof(uint32_t) + builder->payloads_size;
+        result = 0;
+    }
+    return result;
+}
+
+CONSTBUFFER_ARRAY_HANDLE constbuffer_array_batcher_nv_builder_seal(CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_HANDLE builder)
+{
+    CONSTBUFFER_ARRAY_HANDLE result;
+
+    if (builder == NULL)
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_026: [ If builder is NULL then constbuffer_array_batcher_nv_builder_seal shall fail and return NULL. ]*/
+        LogError("invalid argument CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_HANDLE builder=%p", builder);
+    }
+    else if (builder->payload_count == 0)
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_027: [ If builder holds no payloads then constbuffer_array_batcher_nv_builder_seal shall fail and return NULL. ]*/
+        LogError("cannot seal builder=%p, it holds no payloads", builder);
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_028: [ constbuffer_array_batcher_nv_builder_seal shall allocate memory for the header buffer ((payload count + 1) uint32_t values). ]*/
+        uint32_t* header_memory = malloc_2(builder->payload_count + 1, sizeof(uint32_t));
+        if (header_memory == NULL)
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_033: [ If there are any failures then constbuffer_array_batcher_nv_builder_seal shall fail, leave builder unchanged and return NULL. ]*/
+            LogError("failure in malloc_2(builder->payload_count=%" PRIu32 " + 1, sizeof(uint32_t)=%zu)", builder->payload_count, sizeof(uint32_t));
+        }
+        else
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_029: [ constbuffer_array_batcher_nv_builder_seal shall write the payload count followed by the buffer count of each payload in the header memory. ]*/
+            write_uint32_t((void*)&header_memory[0], builder->payload_count);
+            for (uint32_t i = 0; i < builder->payload_count; i++)
+            {
+                write_uint32_t((void*)&header_memory[i + 1], builder->payload_buffer_counts[i]);
+            }
+
+            /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_030: [ constbuffer_array_batcher_nv_builder_seal shall create the header buffer by calling CONSTBUFFER_CreateWithMoveMemory and store it as the first CONSTBUFFER_HANDLE of the batch. ]*/
+            builder->buffers[0] = CONSTBUFFER_CreateWithMoveMemory((void*)header_memory, sizeof(uint32_t) * (builder->payload_count + 1)); /*BUILDER_MAX_PAYLOAD_COUNT ensures that this multiplication is always possible*/
+            if (builder->buffers[0] == NULL)
+            {
+                /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_033: [ If there are any failures then constbuffer_array_batcher_nv_builder_seal shall fail, leave builder unchanged and return NULL. ]*/
+                LogError("CONSTBUFFER_CreateWithMoveMemory failed");
+                free(header_memory);
+            }
+            else
+            {
+                /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_031: [ constbuffer_array_batcher_nv_builder_seal shall call constbuffer_array_create_with_move_buffers with the CONSTBUFFER_HANDLEs of the batch (the handles are not copied and their reference counts are not changed). ]*/
+                result = constbuffer_array_create_with_move_buffers(builder->buffers, builder->buffer_count);
+                if (result == NULL)
+                {
+                    /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_033: [ If there are any failures then constbuffer_array_batcher_nv_builder_seal shall fail, leave builder unchanged and return NULL. ]*/
+                    LogError("failure in constbuffer_array_create_with_move_buffers(builder->buffers=%p, builder->buffer_count=%" PRIu32 ")", builder->buffers, builder->buffer_count);
+                    CONSTBUFFER_DecRef(builder->buffers[0]);
+                    builder->buffers[0] = NULL;
+                }
+                else
+                {
+                    /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_032: [ constbuffer_array_batcher_nv_builder_seal shall free builder, succeed and return the batch. ]*/
+                    free(builder->payload_buffer_counts);
+                    free(builder);
+                    goto all_ok;
+                }
+            }
+        }
+    }
+
+    result = NULL;
+
+all_ok:
+    return result;
+}
+
+CONSTBUFFER_ARRAY_BATCHER_NV_VIEW_HANDLE constbuffer_array_batcher_nv_view_create(CONSTBUFFER_ARRAY_HANDLE batch)
+{
+    CONSTBUFFER_ARRAY_BATCHER_NV_VIEW_HANDLE result;
+
+    if (batch == NULL)
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_034: [ If batch is NULL then constbuffer_array_batcher_nv_view_create shall fail and return NULL. ]*/
+        LogError("invalid argument CONSTBUFFER_ARRAY_HANDLE batch=%p", batch);
+    }
+    else
+    {
+        uint32_t batch_buffer_count;
+
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_035: [ constbuffer_array_batcher_nv_view_create shall obtain the number of buffers in batch. ]*/
+        (void)constbuffer_array_get_buffer_count(batch, &batch_buffer_count);
+
+        if (batch_buffer_count == 0)
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_036: [ If batch has no buffers then constbuffer_array_batcher_nv_view_create shall fail and return NULL. ]*/
+            LogError("Insufficient buffers in batch");
+        }
+        else
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_037: [ constbuffer_array_batcher_nv_view_create shall obtain the content of the first (header) buffer in batch. ]*/
+            const CONSTBUFFER* header_buffer_content = constbuffer_array_get_buffer_content(batch, 0);
+
+            if ((header_buffer_content->size < sizeof(uint32_t)) ||
+                (header_buffer_content->size % sizeof(uint32_t) != 0))
+            {
+                /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_038: [ If the size of the header buffer is less than sizeof(uint32_t) or not a multiple of sizeof(uint32_t) then constbuffer_array_batcher_nv_view_create shall fail and return NULL. ]*/
+                LogError("Invalid header buffer size: %" PRIu32, (uint32_t)header_buffer_content->size);
+            }
+            else
+            {
+                const uint32_t* header_buffer_memory = (const void*)header_buffer_content->buffer;
+                uint32_t batch_payload_count;
+
+                /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_039: [ constbuffer_array_batcher_nv_view_create shall read the number of payloads from the first uint32_t of the header. ]*/
+                read_uint32_t((void*)&header_buffer_memory[0], &batch_payload_count);
+
+                if (batch_payload_count == 0)
+                {
+                    /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_040: [ If the number of payloads is 0 then constbuffer_array_batcher_nv_view_create shall fail and return NULL. ]*/
+                    LogError("Batch with 0 payloads");
+                }
+                else if (((header_buffer_content->size / sizeof(uint32_t)) - 1) != batch_payload_count)
+                {
+                    /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_041: [ If the number of payloads does not match the size of the header buffer then constbuffer_array_batcher_nv_view_create shall fail and return NULL. ]*/
+                    LogError("Header buffer size not matching number of payloads: payload count=%" PRIu32 ", header buffer size=%" PRIu32,
+                        batch_payload_count, (uint32_t)header_buffer_content->size);
+                }
+                else
+                {
+                    /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_042: [ constbuffer_array_batcher_nv_view_create shall allocate memory for the view, including the index of the first buffer of each payload and the index past the last payload (number of payloads + 1 uint32_t values). ]*/
+                    result = malloc_flex(sizeof(CONSTBUFFER_ARRAY_BATCHER_NV_VIEW), (size_t)batch_payload_count + 1, sizeof(uint32_t));
+                    if (result == NULL)
+                    {
+                        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_046: [ If there are any other failures then constbuffer_array_batcher_nv_view_create shall fail and return NULL. ]*/
+                        LogError("failure in malloc_flex(sizeof(CONSTBUFFER_ARRAY_BATCHER_NV_VIEW)=%zu, batch_payload_count=%" PRIu32 " + 1, sizeof(uint32_t)=%zu)",
+                            sizeof(CONSTBUFFER_ARRAY_BATCHER_NV_VIEW), batch_payload_count, sizeof(uint32_t));
+                    }
+                    else
+                    {
+                        uint32_t i;
+
+                        result->first_buffer_index[0] = 1; /*the header*/
+                        for (i = 0; i < batch_payload_count; i++)
+                        {
+                            uint32_t buffer_count;
+
+                            /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_043: [ constbuffer_array_batcher_nv_view_create shall read the buffer count of each payload from the rest of the header and compute the index of the first buffer of each payload. ]*/
+                            read_uint32_t((void*)&header_buffer_memory[i + 1], &buffer_count);
+
+                            if (buffer_count > batch_buffer_count - result->first_buffer_index[i])
+                            {
+                                /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_044: [ If there are not enough buffers in batch for all the payloads then constbuffer_array_batcher_nv_view_create shall fail and return NULL. ]*/
+                                LogError("Not enough buffers in batch");
+                                break;
+                            }
+
+                            result->first_buffer_index[i + 1] = result->first_buffer_index[i] + buffer_count;
+                        }
+
+                        if (i < batch_payload_count)
+                        {
+                            /*error in the loop above*/
+                        }
+                        else
+                        {
+                            /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_045: [ constbuffer_array_batcher_nv_view_create shall increment the reference count of batch, succeed and return the view. ]*/
+                            constbuffer_array_inc_ref(batch);
+                            result->batch = batch;
+                            result->payload_count = batch_payload_count;
+                            goto all_ok;
+                        }
+
+                        free(result);
+                    }
+                }
+            }
+        }
+    }
+
+    result = NULL;
+
+all_ok:
+    return result;
+}
+
+void constbuffer_array_batcher_nv_view_destroy(CONSTBUFFER_ARRAY_BATCHER_NV_VIEW_HANDLE view)
+{
+    if (view == NULL)
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_047: [ If view is NULL then constbuffer_array_batcher_nv_view_destroy shall return. ]*/
+        LogError("invalid argument CONSTBUFFER_ARRAY_BATCHER_NV_VIEW_HANDLE view=%p", view);
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_048: [ constbuffer_array_batcher_nv_view_destroy shall decrement the reference count of the batch and free the view. ]*/
+        constbuffer_array_dec_ref(view->batch);
+        free(view);
+    }
+}
+
+int constbuffer_array_batcher_nv_view_get_payload_count(CONSTBUFFER_ARRAY_BATCHER_NV_VIEW_HANDLE view, uint32_t* payload_count)
+{
+    int result;
+
+    if (
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_049: [ If view is NULL then constbuffer_array_batcher_nv_view_get_payload_count shall fail and return a non-zero value. ]*/
+        (view == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_050: [ If payload_count is NULL then constbuffer_array_batcher_nv_view_get_payload_count shall fail and return a non-zero value. ]*/
+        (payload_count == NULL)
+        )
+    {
+        LogError("invalid arguments CONSTBUFFER_ARRAY_BATCHER_NV_VIEW_HANDLE view=%p, uint32_t* payload_count=%p", view, payload_count);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_051: [ constbuffer_array_batcher_nv_view_get_payload_count shall write in payload_count the number of payloads in the batch, succeed and return 0. ]*/
+        *payload_count = view->payload_count;
+        result = 0;
+    }
+    return result;
+}
+
+int constbuffer_array_batcher_nv_view_get_payload_buffer_count(CONSTBUFFER_ARRAY_BATCHER_NV_VIEW_HANDLE view, uint32_t payload_index, uint32_t* buffer_count)
+{
+    int result;
+
+    if (
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_052: [ If view is NULL then constbuffer_array_batcher_nv_view_get_payload_buffer_count shall fail and return a non-zero value. ]*/
+        (view == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_054: [ If buffer_count is NULL then constbuffer_array_batcher_nv_view_get_payload_buffer_count shall fail and return a non-zero value. ]*/
+        (buffer_count == NULL)
+        )
+    {
+        LogError("invalid arguments CONSTBUFFER_ARRAY_BATCHER_NV_VIEW_HANDLE view=%p, uint32_t payload_index=%" PRIu32 ", uint32_t* buffer_count=%p", view, payload_index, buffer_count);
+        result = MU_FAILURE;
+    }
+    else if (payload_index >= view->payload_count)
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_053: [ If payload_index is not less than the number of payloads then constbuffer_array_batcher_nv_view_get_payload_buffer_count shall fail and return a non-zero value. ]*/
+        LogError("invalid payload_index=%" PRIu32 ", view=%p has %" PRIu32 " payloads", payload_index, view, view->payload_count);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_055: [ constbuffer_array_batcher_nv_view_get_payload_buffer_count shall write in buffer_count the number of buffers of the payload_index-th payload, succeed and return 0. ]*/
+        *buffer_count = view->first_buffer_index[payload_index + 1] - view->first_buffer_index[payload_index];
+        result = 0;
+    }
+    return result;
+}
+
+const CONSTBUFFER* constbuffer_array_batcher_nv_view_get_payload_buffer_content(CONSTBUFFER_ARRAY_BATCHER_NV_VIEW_HANDLE view, uint32_t payload_index, uint32_t buffer_index)
+{
+    const CONSTBUFFER* result;
+
+    if (view == NULL)
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_056: [ If view is NULL then constbuffer_array_batcher_nv_view_get_payload_buffer_content shall fail and return NULL. ]*/
+        LogError("invalid arguments CONSTBUFFER_ARRAY_BATCHER_NV_VIEW_HANDLE view=%p, uint32_t payload_index=%" PRIu32 ", uint32_t buffer_index=%" PRIu32 "", view, payload_index, buffer_index);
+        result = NULL;
+    }
+    else if (payload_index >= view->payload_count)
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_057: [ If payload_index is not less than the number of payloads then constbuffer_array_batcher_nv_view_get_payload_buffer_content shall fail and return NULL. ]*/
+        LogError("invalid payload_index=%" PRIu32 ", view=%p has %" PRIu32 " payloads", payload_index, view, view->payload_count);
+        result = NULL;
+    }
+    else if (buffer_index >= view->first_buffer_index[payload_index + 1] - view->first_buffer_index[payload_index])
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_058: [ If buffer_index is not less than the number of buffers of the payload_index-th payload then constbuffer_array_batcher_nv_view_get_payload_buffer_content shall fail and return NULL. ]*/
+        LogError("invalid buffer_index=%" PRIu32 ", payload %" PRIu32 " has %" PRIu32 " buffers", buffer_index, payload_index, view->first_buffer_index[payload_index + 1] - view->first_buffer_index[payload_index]);
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_059: [ constbuffer_array_batcher_nv_view_get_payload_buffer_content shall return the content of the buffer_index-th buffer of the payload by calling constbuffer_array_get_buffer_content on the batch. ]*/
+        result = constbuffer_array_get_buffer_content(view->batch, view->first_buffer_index[payload_index] + buffer_index);
+    }
+    return result;
+}
+
+CONSTBUFFER_ARRAY_HANDLE constbuffer_array_batcher_nv_view_get_payload(CONSTBUFFER_ARRAY_BATCHER_NV_VIEW_HANDLE view, uint32_t payload_index)
+{
+    CONSTBUFFER_ARRAY_HANDLE result;
+
+    if (view == NULL)
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_060: [ If view is NULL then constbuffer_array_batcher_nv_view_get_payload shall fail and return NULL. ]*/
+        LogError("invalid arguments CONSTBUFFER_ARRAY_BATCHER_NV_VIEW_HANDLE view=%p, uint32_t payload_index=%" PRIu32 "", view, payload_index);
+        result = NULL;
+    }
+    else if (payload_index >= view->payload_count)
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_061: [ If payload_index is not less than the number of payloads then constbuffer_array_batcher_nv_view_get_payload shall fail and return NULL. ]*/
+        LogError("invalid payload_index=%" PRIu32 ", view=%p has %" PRIu32 " payloads", payload_index, view, view->payload_count);
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_062: [ constbuffer_array_batcher_nv_view_get_payload shall call constbuffer_array_create_from_buffer_index_and_count with the batch, the index of the first buffer of the payload and its number of buffers and return the result. ]*/
+        result = constbuffer_array_create_from_buffer_index_and_count(view->batch, view->first_buffer_index[payload_index], view->first_buffer_index[payload_index + 1] - view->first_buffer_index[payload_index]);
+        if (result == NULL)
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_063: [ If there are any failures then constbuffer_array_batcher_nv_view_get_payload shall fail and return NULL. ]*/
+            LogError("failure in constbuffer_array_create_from_buffer_index_and_count for payload %" PRIu32 "", payload_index);
+        }
+    }
+    return result;
+}
+
+CONSTBUFFER_ARRAY_HANDLE* constbuffer_array_batcher_nv_view_get_all_payloads(CONSTBUFFER_ARRAY_BATCHER_NV_VIEW_HANDLE view, uint32_t* payload_count)
+{
+    CONSTBUFFER_ARRAY_HANDLE* result;
+
+    if (
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_064: [ If view is NULL then constbuffer_array_batcher_nv_view_get_all_payloads shall fail and return NULL. ]*/
+        (view == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_065: [ If payload_count is NULL then constbuffer_array_batcher_nv_view_get_all_payloads shall fail and return NULL. ]*/
+        (payload_count == NULL)
+        )
+    {
+        LogError("invalid arguments CONSTBUFFER_ARRAY_BATCHER_NV_VIEW_HANDLE view=%p, uint32_t* payload_count=%p", view, payload_count);
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_066: [ constbuffer_array_batcher_nv_view_get_all_payloads shall allocate memory for the handles of all the payloads. ]*/
+        result = malloc_2(view->payload_count, sizeof(CONSTBUFFER_ARRAY_HANDLE));
+        if (result == NULL)
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_069: [ If there are any failures then constbuffer_array_batcher_nv_view_get_all_payloads shall decrement the reference count of the payloads already created, free the memory and return NULL. ]*/
+            LogError("failure in malloc_2(view->payload_count=%" PRIu32 ", sizeof(CONSTBUFFER_ARRAY_HANDLE)=%zu)", view->payload_count, sizeof(CONSTBUFFER_ARRAY_HANDLE));
+        }
+        else
+        {
+            uint32_t i;
+            for (i = 0; i < view->payload_count; i++)
+            {
+                /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_067: [ constbuffer_array_batcher_nv_view_get_all_payloads shall create every payload by calling constbuffer_array_create_from_buffer_index_and_count with the batch, the index of the first buffer of the payload and its number of buffers. ]*/
+                result[i] = constbuffer_array_create_from_buffer_index_and_count(view->batch, view->first_buffer_index[i], view->first_buffer_index[i + 1] - view->first_buffer_index[i]);
+                if (result[i] == NULL)
+                {
+                    /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_069: [ If there are any failures then constbuffer_array_batcher_nv_view_get_all_payloads shall decrement the reference count of the payloads already created, free the memory and return NULL. ]*/
+                    LogError("failure in constbuffer_array_create_from_buffer_index_and_count for payload %" PRIu32 "", i);
+                    break;
+                }
+            }
+
+            if (i < view->payload_count)
+            {
+                for (uint32_t j = 0; j < i; j++)
+                {
+                    constbuffer_array_dec_ref(result[j]);
+                }
+                free(result);
+                result = NULL;
+            }
+            else
+            {
+                /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_068: [ constbuffer_array_batcher_nv_view_get_all_payloads shall write in payload_count the number of payloads, succeed and return the handles. ]*/
+                *payload_count = view->payload_count;
+            }
+        }
+    }
+    return result;
+}
@@ -0,0 +1,810 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stdalign.h>
+#include <stdbool.h>
+#include <inttypes.h>
+
+#include "macro_utils/macro_utils.h"
+
+#include "c_logging/logger.h"
+
+#include "c_pal/gballoc_hl.h"
+#include "c_pal/gballoc_hl_redirect.h"
+#include "c_pal/thandle.h"
+#include "c_pal/srw_lock.h"
+#include "c_pal/threadpool.h"
+#include "c_pal/timer.h"
+#include "c_pal/sm.h"
+
+#include "c_util/doublylinkedlist.h"
+#include "c_util/async_op.h"
+#include "c_util/constbuffer_array.h"
+#include "c_util/constbuffer_array_batcher_nv.h"
+#include "c_util/sliding_window_average_by_count.h"
+
+#include "c_util/constbuffer_array_batcher_nv_async.h"
+
+MU_DEFINE_ENUM_STRINGS(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT, CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT_VALUES);
+MU_DEFINE_ENUM_STRINGS(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_CALLBACK_RESULT, CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_CALLBACK_RESULT_VALUES);
+
+/*number of intervals between consecutive submits used to estimate the arrival rate*/
+#define ARRIVAL_INTERVALS_WINDOW_COUNT 32
+
+typedef struct CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_TAG
+{
+    THANDLE(THREADPOOL) threadpool;
+    SM_HANDLE sm;
+    SRW_LOCK_HANDLE lock;
+
+    uint32_t max_payload_count;
+    uint64_t max_batch_size;
+    uint32_t max_delay_ms;
+    CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_SEND_BATCH send_batch;
+    void* send_batch_context;
+
+    THANDLE(SLIDING_WINDOW_AVERAGE) arrival_intervals; /*microseconds between consecutive submits*/
+
+    /*everything below is protected by lock*/
+    bool is_closing; /*set by abandon_pending_ops, a submit that was already past sm_exec_begin when close started fails instead of adding a payload that nothing would complete*/
+    THANDLE(THREADPOOL_TIMER) timer; /*started by the first submit, released by close*/
+    double last_arrival_time_ms; /*negative until the first submit*/
+    DLIST_ENTRY pending_ops;
+    uint32_t pending_count;
+    uint64_t pending_payloads_size;
+} CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC;
+
+THANDLE_TYPE_DEFINE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC);
+
+typedef struct BATCHER_NV_ASYNC_OP_TAG
+{
+    THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) batcher; /*kept until the operation is disposed so that a late async_op_cancel still finds the batcher*/
+    THANDLE(ASYNC_OP) async_op; /*self reference, released when the payload completes*/
+
+    CONSTBUFFER_ARRAY_HANDLE payload;
+    uint64_t payload_size;
+    double arrival_time_ms;
+    ON_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_PAYLOAD_COMPLETE on_payload_complete;
+    void* context;
+
+    bool is_pending; /*protected by the lock of the batcher, true while anchor is in pending_ops*/
+    DLIST_ENTRY anchor;
+    CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_CALLBACK_RESULT result;
+} BATCHER_NV_ASYNC_OP;
+
+typedef struct BATCH_IN_FLIGHT_TAG
+{
+    uint32_t op_count;
+    BATCHER_NV_ASYNC_OP* ops[];
+} BATCH_IN_FLIGHT;
+
+static uint64_t get_batch_size(uint32_t payload_count, uint64_t payloads_size)
+{
+    return ((uint64_t)payload_count + 1) * sizeof(uint32_t) + payloads_size;
+}
+
+static void constbuffer_array_batcher_nv_async_dispose(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC* batcher)
+{
+    /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_009: [ constbuffer_array_batcher_nv_async_dispose shall release the timer (if any), the sliding window average and the threadpool, and call srw_lock_destroy and sm_destroy. ]*/
+    THANDLE_ASSIGN(THREADPOOL_TIMER)(&batcher->timer, NULL);
+    THANDLE_ASSIGN(SLIDING_WINDOW_AVERAGE)(&batcher->arrival_intervals, NULL);
+    THANDLE_ASSIGN(THREADPOOL)(&batcher->threadpool, NULL);
+    srw_lock_destroy(batcher->lock);
+    sm_destroy(batcher->sm);
+}
+
+static void complete_op(BATCHER_NV_ASYNC_OP* op)
+{
+    /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_053: [ complete_op shall decrement the reference count of the payload, call on_payload_complete with the result of the operation and release the reference the operation holds on itself. ]*/
+    constbuffer_array_dec_ref(op->payload);
+    op->payload = NULL;
+
+    op->on_payload_complete(op->context, op->result);
+
+    /*copy to a local so that the last reference is not released from a field of the op that is being released*/
+    THANDLE(ASYNC_OP) temp = NULL;
+    THANDLE_INITIALIZE_MOVE(ASYNC_OP)(&temp, &op->async_op);
+    THANDLE_ASSIGN(ASYNC_OP)(&temp, NULL);
+}
+
+static void complete_op_from_threadpool(void* context)
+{
+    complete_op(context);
+}
+
+static void complete_ops(PDLIST_ENTRY ops, CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_CALLBACK_RESULT result)
+{
+    for (PDLIST_ENTRY entry = DList_RemoveHeadList(ops); entry != ops; entry = DList_RemoveHeadList(ops))
+    {
+        BATCHER_NV_ASYNC_OP* op = CONTAINING_RECORD(entry, BATCHER_NV_ASYNC_OP, anchor);
+        op->result = result;
+        complete_op(op);
+    }
+}
+
+static void on_batch_sent(void* context, bool succeeded)
+{
+    if (context == NULL)
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_049: [ If context is NULL then on_batch_sent shall return. ]*/
+        LogError("Invalid arguments: void* context=%p, bool succeeded=%" PRI_BOOL "", context, MU_BOOL_VALUE(succeeded));
+    }
+    else
+    {
+        BATCH_IN_FLIGHT* batch_in_flight = context;
+
+        for (uint32_t i = 0; i < batch_in_flight->op_count; i++)
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_050: [ on_batch_sent shall complete every payload of the batch with CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_CALLBACK_RESULT_OK if succeeded is true and with CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_CALLBACK_RESULT_ERROR otherwise. ]*/
+            batch_in_flight->ops[i]->result = succeeded ? CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_CALLBACK_RESULT_OK : CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_CALLBACK_RESULT_ERROR;
+            complete_op(batch_in_flight->ops[i]);
+        }
+
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_051: [ on_batch_sent shall free the memory used to track the batch. ]*/
+        free(batch_in_flight);
+    }
+}
+
+/*ops is a list of op_count operations that are not pending anymore, they are sent as one batch*/
+static void send_ops(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC* batcher_ptr, PDLIST_ENTRY ops, uint32_t op_count)
+{
+    /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_043: [ send_ops shall allocate memory to track the operations of the batch. ]*/
+    BATCH_IN_FLIGHT* batch_in_flight = malloc_flex(sizeof(BATCH_IN_FLIGHT), op_count, sizeof(BATCHER_NV_ASYNC_OP*));
+    if (batch_in_flight == NULL)
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_048: [ If there are any failures then send_ops shall complete all the payloads with CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_CALLBACK_RESULT_ERROR. ]*/
+        LogError("failure in malloc_flex(sizeof(BATCH_IN_FLIGHT)=%zu, op_count=%" PRIu32 ", sizeof(BATCHER_NV_ASYNC_OP*)=%zu)", sizeof(BATCH_IN_FLIGHT), op_count, sizeof(BATCHER_NV_ASYNC_OP*));
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_044: [ send_ops shall allocate an array for the payloads of the batch. ]*/
+        CONSTBUFFER_ARRAY_HANDLE* payloads = malloc_2(op_count, sizeof(CONSTBUFFER_ARRAY_HANDLE));
+        if (payloads == NULL)
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_048: [ If there are any failures then send_ops shall complete all the payloads with CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_CALLBACK_RESULT_ERROR. ]*/
+            LogError("failure in malloc_2(op_count=%" PRIu32 ", sizeof(CONSTBUFFER_ARRAY_HANDLE)=%zu)", op_count, sizeof(CONSTBUFFER_ARRAY_HANDLE));
+        }
+        else
+        {
+            uint32_t i = 0;
+            for (PDLIST_ENTRY entry = ops->Flink; entry != ops; entry = entry->Flink)
+            {
+                BATCHER_NV_ASYNC_OP* op = CONTAINING_RECORD(entry, BATCHER_NV_ASYNC_OP, anchor);
+                batch_in_flight->ops[i] = op;
+                payloads[i] = op->payload;
+                i++;
+            }
+            batch_in_flight->op_count = op_count;
+
+            /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_045: [ send_ops shall create the batch by calling constbuffer_array_batcher_nv_batch with the payloads in the order in which they were submitted. ]*/
+            CONSTBUFFER_ARRAY_HANDLE batch = constbuffer_array_batcher_nv_batch(payloads, op_count);
+            free(payloads);
+
+            if (batch == NULL)
+            {
+                /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_048: [ If there are any failures then send_ops shall complete all the payloads with CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_CALLBACK_RESULT_ERROR. ]*/
+                LogError("failure in constbuffer_array_batcher_nv_batch(payloads, op_count=%" PRIu32 ")", op_count);
+            }
+            else
+            {
+                /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_046: [ send_ops shall call send_batch with send_batch_context, the batch, on_batch_sent and the tracking memory as context. ]*/
+                int send_result = batcher_ptr->send_batch(batcher_ptr->send_batch_context, batch, on_batch_sent, batch_in_flight);
+
+                /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_047: [ send_ops shall decrement the reference count of the batch. ]*/
+                constbuffer_array_dec_ref(batch);
+
+                if (send_result != 0)
+                {
+                    /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_048: [ If there are any failures then send_ops shall complete all the payloads with CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_CALLBACK_RESULT_ERROR. ]*/
+                    LogError("failure in send_batch(send_batch_context=%p, batch=%p, on_batch_sent=%p, batch_in_flight=%p), op_count=%" PRIu32 "",
+                        batcher_ptr->send_batch_context, batch, on_batch_sent, batch_in_flight, op_count);
+                }
+                else
+                {
+                    /*on_batch_sent owns the operations now*/
+                    goto all_ok;
+                }
+            }
+        }
+        free(batch_in_flight);
+    }
+
+    complete_ops(ops, CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_CALLBACK_RESULT_ERROR);
+
+all_ok:
+    return;
+}
+
+/*moves all the pending operations in ops, has to be called under the lock. Returns the number of operations moved*/
+static uint32_t take_pending_ops(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC* batcher_ptr, PDLIST_ENTRY ops)
+{
+    uint32_t result = batcher_ptr->pending_count;
+
+    for (PDLIST_ENTRY entry = DList_RemoveHeadList(&batcher_ptr->pending_ops); entry != &batcher_ptr->pending_ops; entry = DList_RemoveHeadList(&batcher_ptr->pending_ops))
+    {
+        BATCHER_NV_ASYNC_OP* op = CONTAINING_RECORD(entry, BATCHER_NV_ASYNC_OP, anchor);
+        op->is_pending = false;
+        DList_InsertTailList(ops, entry);
+    }
+    batcher_ptr->pending_count = 0;
+    batcher_ptr->pending_payloads_size = 0;
+
+    return result;
+}
+
+static void on_timer(void* context)
+{
+    if (context == NULL)
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_054: [ If context is NULL then on_timer shall return. ]*/
+        LogError("Invalid arguments: void* context=%p", context);
+    }
+    else
+    {
+        CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC* batcher_ptr = context;
+
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_055: [ on_timer shall call sm_exec_begin and return if it does not succeed. ]*/
+        SM_RESULT sm_result = sm_exec_begin(batcher_ptr->sm);
+        if (sm_result != SM_EXEC_GRANTED)
+        {
+            LogVerbose("timer of batcher %p fired when not open, SM_RESULT sm_result=%" PRI_MU_ENUM "", batcher_ptr, MU_ENUM_VALUE(SM_RESULT, sm_result));
+        }
+        else
+        {
+            DLIST_ENTRY ops;
+            uint32_t op_count = 0;
+            DList_InitializeListHead(&ops);
+
+            /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_056: [ on_timer shall call srw_lock_acquire_exclusive. ]*/
+            srw_lock_acquire_exclusive(batcher_ptr->lock);
+            {
+                if (batcher_ptr->pending_count == 0)
+                {
+                    /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_057: [ If there are no pending payloads then on_timer shall not send anything. ]*/
+                }
+                else
+                {
+                    BATCHER_NV_ASYNC_OP* oldest = CONTAINING_RECORD(batcher_ptr->pending_ops.Flink, BATCHER_NV_ASYNC_OP, anchor);
+                    double waited_ms = timer_global_get_elapsed_ms() - oldest->arrival_time_ms;
+
+                    if (waited_ms + 1 < batcher_ptr->max_delay_ms)
+                    {
+                        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_058: [ If the oldest pending payload has waited less than max_delay_ms then on_timer shall call threadpool_timer_restart with the time the oldest payload has left to wait. ]*/
+                        /*the batch this timer was started for has been sent already, this one is younger*/
+                        if (threadpool_timer_restart(batcher_ptr->timer, (uint32_t)(batcher_ptr->max_delay_ms - waited_ms), 0) != 0)
+                        {
+                            /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_059: [ If threadpool_timer_restart fails then on_timer shall send all the pending payloads. ]*/
+                            LogError("failure in threadpool_timer_restart, sending the pending payloads now");
+                            op_count = take_pending_ops(batcher_ptr, &ops);
+                        }
+                    }
+                    else
+                    {
+                        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_060: [ Otherwise on_timer shall take all the pending payloads. ]*/
+                        op_count = take_pending_ops(batcher_ptr, &ops);
+                    }
+                }
+                /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_061: [ on_timer shall call srw_lock_release_exclusive. ]*/
+                srw_lock_release_exclusive(batcher_ptr->lock);
+            }
+
+            if (op_count > 0)
+            {
+                /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_062: [ on_timer shall send the payloads it took as one batch. ]*/
+                send_ops(batcher_ptr, &ops, op_count);
+            }
+
+            /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_063: [ on_timer shall call sm_exec_end. ]*/
+            sm_exec_end(batcher_ptr->sm);
+        }
+    }
+}
+
+static void abandon_pending_ops(void* context)
+{
+    CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC* batcher_ptr = context;
+    DLIST_ENTRY ops;
+    DList_InitializeListHead(&ops);
+
+    /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_017: [ abandon_pending_ops shall take all the pending payloads under the lock. ]*/
+    srw_lock_acquire_exclusive(batcher_ptr->lock);
+    /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_077: [ abandon_pending_ops shall set is_closing to true under the lock. ]*/
+    batcher_ptr->is_closing = true;
+    (void)take_pending_ops(batcher_ptr, &ops);
+    srw_lock_release_exclusive(batcher_ptr->lock);
+
+    /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_018: [ abandon_pending_ops shall complete all the payloads it took with CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_CALLBACK_RESULT_ABANDONED. ]*/
+    complete_ops(&ops, CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_CALLBACK_RESULT_ABANDONED);
+}
+
+static void cancel_op(void* context)
+{
+    BATCHER_NV_ASYNC_OP* op = context;
+    CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC* batcher_ptr = THANDLE_GET_T(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC)(op->batcher);
+    bool was_pending = false;
+
+    /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_064: [ cancel_op shall call srw_lock_acquire_exclusive. ]*/
+    srw_lock_acquire_exclusive(batcher_ptr->lock);
+    {
+        if (op->is_pending)
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_065: [ If the payload is still pending then cancel_op shall remove it from the pending payloads. ]*/
+            (void)DList_RemoveEntryList(&op->anchor);
+            op->is_pending = false;
+            batcher_ptr->pending_count--;
+            batcher_ptr->pending_payloads_size -= op->payload_size;
+            was_pending = true;
+        }
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_066: [ cancel_op shall call srw_lock_release_exclusive. ]*/
+        srw_lock_release_exclusive(batcher_ptr->lock);
+    }
+
+    if (!was_pending)
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_067: [ If the payload is not pending anymore (it is part of a batch or it has completed) then cancel_op shall do nothing. ]*/
+    }
+    else
+    {
+        op->result = CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_CALLBACK_RESULT_CANCELLED;
+
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_068: [ cancel_op shall complete the payload with CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_CALLBACK_RESULT_CANCELLED by calling threadpool_schedule_work with complete_op_from_threadpool. ]*/
+        if (threadpool_schedule_work(batcher_ptr->threadpool, complete_op_from_threadpool, op) != 0)
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_069: [ If threadpool_schedule_work fails then cancel_op shall complete the payload on the calling thread. ]*/
+            LogError("failure in threadpool_schedule_work(batcher_ptr->threadpool=%p, complete_op_from_threadpool=%p, op=%p), completing the payload now", batcher_ptr->threadpool, complete_op_from_threadpool, op);
+            complete_op(op);
+        }
+    }
+}
+
+static void dispose_op(void* context)
+{
+    BATCHER_NV_ASYNC_OP* op = context;
+
+    /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_052: [ dispose_op shall release the reference the operation holds on the batcher. ]*/
+    THANDLE_ASSIGN(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC)(&op->batcher, NULL);
+}
+
+/*number of payloads after which the pending payloads are sent without waiting for the timer. When payloads arrive slower than one per max_delay_ms
+waiting only adds latency so the threshold goes down to 1, when they arrive faster it goes up to max_payload_count. Has to be called under the lock*/
+static uint32_t get_flush_payload_count(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC* batcher_ptr, double now_ms)
+{
+    uint32_t result = batcher_ptr->max_payload_count;
+
+    if (batcher_ptr->last_arrival_time_ms >= 0)
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_036: [ constbuffer_array_batcher_nv_async_submit shall add the time since the previous submit (in microseconds) to the sliding window average of arrival intervals by calling sliding_window_average_by_count_add. ]*/
+        if (sliding_window_average_by_count_add(batcher_ptr->arrival_intervals, (int64_t)((now_ms - batcher_ptr->last_arrival_time_ms) * 1000)) != 0)
+        {
+            LogError("failure in sliding_window_average_by_count_add, using max_payload_count=%" PRIu32 "", batcher_ptr->max_payload_count);
+        }
+        else
+        {
+            double average_interval_us;
+            /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_037: [ constbuffer_array_batcher_nv_async_submit shall get the average arrival interval by calling sliding_window_average_by_count_get. ]*/
+            if (sliding_window_average_by_count_get(batcher_ptr->arrival_intervals, &average_interval_us) != 0)
+            {
+                LogError("failure in sliding_window_average_by_count_get, using max_payload_count=%" PRIu32 "", batcher_ptr->max_payload_count);
+            }
+            else if (average_interval_us > 0)
+            {
+                /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_038: [ The number of payloads that triggers a batch shall be the number of payloads expected to arrive in max_delay_ms at the average arrival interval, but no less than 1 and no more than max_payload_count. ]*/
+                double expected_payload_count = (double)batcher_ptr->max_delay_ms * 1000 / average_interval_us;
+                if (expected_payload_count < 1)
+                {
+                    result = 1;
+                }
+                else if (expected_payload_count < batcher_ptr->max_payload_count)
+                {
+                    result = (uint32_t)expected_payload_count;
+                }
+                else
+                {
+                    /*result stays max_payload_count*/
+                }
+            }
+            else
+            {
+                /*payloads arrive faster than the timer can measure*/
+            }
+        }
+    }
+    batcher_ptr->last_arrival_time_ms = now_ms;
+
+    return result;
+}
+
+THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) constbuffer_array_batcher_nv_async_create(THANDLE(THREADPOOL) threadpool, uint32_t max_payload_count, uint64_t max_batch_size, uint32_t max_delay_ms, CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_SEND_BATCH send_batch, void* send_batch_context)
+{
+    THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) result = NULL;
+
+    if (
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_001: [ If threadpool is NULL then constbuffer_array_batcher_nv_async_create shall fail and return NULL. ]*/
+        (threadpool == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_002: [ If max_payload_count is 0 or greater than UINT32_MAX / sizeof(uint32_t) - 1 then constbuffer_array_batcher_nv_async_create shall fail and return NULL. ]*/
+        (max_payload_count == 0) ||
+        (max_payload_count > UINT32_MAX / sizeof(uint32_t) - 1) ||
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_003: [ If max_batch_size is 0 then constbuffer_array_batcher_nv_async_create shall fail and return NULL. ]*/
+        (max_batch_size == 0) ||
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_004: [ If max_delay_ms is 0 then constbuffer_array_batcher_nv_async_create shall fail and return NULL. ]*/
+        (max_delay_ms == 0) ||
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_005: [ If send_batch is NULL then constbuffer_array_batcher_nv_async_create shall fail and return NULL. ]*/
+        (send_batch == NULL)
+        )
+    {
+        LogError("Invalid arguments: THANDLE(THREADPOOL) threadpool=%p, uint32_t max_payload_count=%" PRIu32 ", uint64_t max_batch_size=%" PRIu64 ", uint32_t max_delay_ms=%" PRIu32 ", CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_SEND_BATCH send_batch=%p, void* send_batch_context=%p",
+            threadpool, max_payload_count, max_batch_size, max_delay_ms, send_batch, send_batch_context);
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_006: [ constbuffer_array_batcher_nv_async_create shall call sm_create, srw_lock_create and sliding_window_average_by_count_create. ]*/
+        SM_HANDLE sm = sm_create("constbuffer_array_batcher_nv_async");
+        if (sm == NULL)
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_008: [ If there are any failures then constbuffer_array_batcher_nv_async_create shall fail and return NULL. ]*/
+            LogError("failure in sm_create(\"constbuffer_array_batcher_nv_async\")");
+        }
+        else
+        {
+            SRW_LOCK_HANDLE lock = srw_lock_create(false, "constbuffer_array_batcher_nv_async");
+            if (lock == NULL)
+            {
+                /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_008: [ If there are any failures then constbuffer_array_batcher_nv_async_create shall fail and return NULL. ]*/
+                LogError("failure in srw_lock_create(false, \"constbuffer_array_batcher_nv_async\")");
+            }
+            else
+            {
+                THANDLE(SLIDING_WINDOW_AVERAGE) arrival_intervals = sliding_window_average_by_count_create(ARRIVAL_INTERVALS_WINDOW_COUNT);
+                if (arrival_intervals == NULL)
+                {
+                    /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_008: [ If there are any failures then constbuffer_array_batcher_nv_async_create shall fail and return NULL. ]*/
+                    LogError("failure in sliding_window_average_by_count_create(%d)", ARRIVAL_INTERVALS_WINDOW_COUNT);
+                }
+                else
+                {
+                    /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_007: [ constbuffer_array_batcher_nv_async_create shall allocate a THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) by calling THANDLE_MALLOC with constbuffer_array_batcher_nv_async_dispose, store the parameters, succeed and return it. ]*/
+                    THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) batcher = THANDLE_MALLOC(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC)(constbuffer_array_batcher_nv_async_dispose);
+                    if (batcher == NULL)
+                    {
+                        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_008: [ If there are any failures then constbuffer_array_batcher_nv_async_create shall fail and return NULL. ]*/
+                        LogError("failure in THANDLE_MALLOC(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC)(constbuffer_array_batcher_nv_async_dispose=%p)", constbuffer_array_batcher_nv_async_dispose);
+                    }
+                    else
+                    {
+                        CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC* batcher_ptr = THANDLE_GET_T(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC)(batcher);
+
+                        batcher_ptr->sm = sm;
+                        batcher_ptr->lock = lock;
+                        THANDLE_INITIALIZE(THREADPOOL)(&batcher_ptr->threadpool, threadpool);
+                        THANDLE_INITIALIZE_MOVE(SLIDING_WINDOW_AVERAGE)(&batcher_ptr->arrival_intervals, &arrival_intervals);
+                        THANDLE_INITIALIZE(THREADPOOL_TIMER)(&batcher_ptr->timer, NULL);
+
+                        batcher_ptr->max_payload_count = max_payload_count;
+                        batcher_ptr->max_batch_size = max_batch_size;
+                        batcher_ptr->max_delay_ms = max_delay_ms;
+                        batcher_ptr->send_batch = send_batch;
+                        batcher_ptr->send_batch_context = send_batch_context;
+
+                        batcher_ptr->is_closing = false;
+                        batcher_ptr->last_arrival_time_ms = -1;
+                        DList_InitializeListHead(&batcher_ptr->pending_ops);
+                        batcher_ptr->pending_count = 0;
+                        batcher_ptr->pending_payloads_size = 0;
+
+                        THANDLE_INITIALIZE_MOVE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC)(&result, &batcher);
+                        goto all_ok;
+                    }
+                    THANDLE_ASSIGN(SLIDING_WINDOW_AVERAGE)(&arrival_intervals, NULL);
+                }
+                srw_lock_destroy(lock);
+            }
+            sm_destroy(sm);
+        }
+    }
+all_ok:
+    return result;
+}
+
+int constbuffer_array_batcher_nv_async_open(THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) batcher)
+{
+    int result;
+
+    if (batcher == NULL)
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_010: [ If batcher is NULL then constbuffer_array_batcher_nv_async_open shall fail and return a non-zero value. ]*/
+        LogError("Invalid arguments: THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) batcher=%p", batcher);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_011: [ constbuffer_array_batcher_nv_async_open shall call sm_open_begin. ]*/
+        SM_RESULT sm_result = sm_open_begin(batcher->sm);
+        if (sm_result != SM_EXEC_GRANTED)
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_013: [ If there are any failures then constbuffer_array_batcher_nv_async_open shall fail and return a non-zero value. ]*/
+            LogError("failure in sm_open_begin(batcher->sm=%p). SM_RESULT sm_result = %" PRI_MU_ENUM "", batcher->sm, MU_ENUM_VALUE(SM_RESULT, sm_result));
+            result = MU_FAILURE;
+        }
+        else
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_076: [ constbuffer_array_batcher_nv_async_open shall set is_closing to false. ]*/
+            /*no submit or timer callback can run between sm_open_begin and sm_open_end*/
+            CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC* batcher_ptr = THANDLE_GET_T(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC)(batcher);
+            batcher_ptr->is_closing = false;
+
+            /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_012: [ constbuffer_array_batcher_nv_async_open shall call sm_open_end, succeed and return 0. ]*/
+            sm_open_end(batcher->sm, true);
+            result = 0;
+        }
+    }
+    return result;
+}
+
+void constbuffer_array_batcher_nv_async_close(THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) batcher)
+{
+    if (batcher == NULL)
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_014: [ If batcher is NULL then constbuffer_array_batcher_nv_async_close shall return. ]*/
+        LogError("Invalid arguments: THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) batcher=%p", batcher);
+    }
+    else
+    {
+        CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC* batcher_ptr = THANDLE_GET_T(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC)(batcher);
+
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_015: [ constbuffer_array_batcher_nv_async_close shall call sm_close_begin_with_cb with abandon_pending_ops as the callback. ]*/
+        SM_RESULT sm_result = sm_close_begin_with_cb(batcher_ptr->sm, abandon_pending_ops, batcher_ptr, NULL, NULL);
+        if (sm_result != SM_EXEC_GRANTED)
+        {
+            LogError("failure in sm_close_begin_with_cb(batcher_ptr->sm=%p, abandon_pending_ops=%p, batcher_ptr=%p, NULL, NULL). SM_RESULT sm_result = %" PRI_MU_ENUM "",
+                batcher_ptr->sm, abandon_pending_ops, batcher_ptr, MU_ENUM_VALUE(SM_RESULT, sm_result));
+        }
+        else
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_016: [ constbuffer_array_batcher_nv_async_close shall release the timer and call sm_close_end. ]*/
+            /*no submit or timer callback is in progress at this point, a timer callback that starts now does not get past sm_exec_begin*/
+            THANDLE_ASSIGN(THREADPOOL_TIMER)(&batcher_ptr->timer, NULL);
+            sm_close_end(batcher_ptr->sm);
+        }
+    }
+}
+
+CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT constbuffer_array_batcher_nv_async_submit(THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) batcher, CONSTBUFFER_ARRAY_HANDLE payload, ON_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_PAYLOAD_COMPLETE on_payload_complete, void* context, THANDLE(ASYNC_OP)* out_op)
+{
+    CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT result;
+
+    if (
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_019: [ If batcher is NULL then constbuffer_array_batcher_nv_async_submit shall fail and return CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT_INVALID_ARGS. ]*/
+        (batcher == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_020: [ If payload is NULL then constbuffer_array_batcher_nv_async_submit shall fail and return CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT_INVALID_ARGS. ]*/
+        (payload == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_021: [ If on_payload_complete is NULL then constbuffer_array_batcher_nv_async_submit shall fail and return CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT_INVALID_ARGS. ]*/
+        (on_payload_complete == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_022: [ If out_op is NULL then constbuffer_array_batcher_nv_async_submit shall fail and return CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT_INVALID_ARGS. ]*/
+        (out_op == NULL)
+        )
+    {
+        LogError("Invalid arguments: THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) batcher=%p, CONSTBUFFER_ARRAY_HANDLE payload=%p, ON_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_PAYLOAD_COMPLETE on_payload_complete=%p, void* context=%p, THANDLE(ASYNC_OP)* out_op=%p",
+            batcher, payload, on_payload_complete, context, out_op);
+        result = CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT_INVALID_ARGS;
+    }
+    else
+    {
+        CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC* batcher_ptr = THANDLE_GET_T(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC)(batcher);
+        uint64_t payload_size;
+
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_023: [ constbuffer_array_batcher_nv_async_submit shall call sm_exec_begin. ]*/
+        SM_RESULT sm_result = sm_exec_begin(batcher_ptr->sm);
+        if (sm_result != SM_EXEC_GRANTED)
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_042: [ If there are any failures then constbuffer_array_batcher_nv_async_submit shall fail and return CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT_ERROR. ]*/
+            LogError("failure in sm_exec_begin(batcher_ptr->sm=%p). SM_RESULT sm_result = %" PRI_MU_ENUM "", batcher_ptr->sm, MU_ENUM_VALUE(SM_RESULT, sm_result));
+            result = CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT_ERROR;
+        }
+        else
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_024: [ constbuffer_array_batcher_nv_async_submit shall get the size of payload by calling constbuffer_array_get_all_buffers_size_64. ]*/
+            if (constbuffer_array_get_all_buffers_size_64(payload, &payload_size) != 0)
+            {
+                /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_042: [ If there are any failures then constbuffer_array_batcher_nv_async_submit shall fail and return CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT_ERROR. ]*/
+                LogError("failure in constbuffer_array_get_all_buffers_size_64(payload=%p, &payload_size=%p)", payload, &payload_size);
+                result = CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT_ERROR;
+            }
+            else
+            {
+                /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_025: [ constbuffer_array_batcher_nv_async_submit shall create a THANDLE(ASYNC_OP) by calling async_op_create with cancel_op as cancel and dispose_op as dispose. ]*/
+                THANDLE(ASYNC_OP) async_op = async_op_create(cancel_op, sizeof(BATCHER_NV_ASYNC_OP), alignof(BATCHER_NV_ASYNC_OP), dispose_op);
+                if (async_op == NULL)
+                {
+                    /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_042: [ If there are any failures then constbuffer_array_batcher_nv_async_submit shall fail and return CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT_ERROR. ]*/
+                    LogError("failure in async_op_create(cancel_op=%p, sizeof(BATCHER_NV_ASYNC_OP)=%zu, alignof(BATCHER_NV_ASYNC_OP)=%zu, dispose_op=%p)", cancel_op, sizeof(BATCHER_NV_ASYNC_OP), alignof(BATCHER_NV_ASYNC_OP), dispose_op);
+                    result = CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT_ERROR;
+                }
+                else
+                {
+                    BATCHER_NV_ASYNC_OP* op = async_op->context;
+                    DLIST_ENTRY first_batch_ops;
+                    DLIST_ENTRY second_batch_ops;
+                    uint32_t first_batch_op_count = 0;
+                    uint32_t second_batch_op_count = 0;
+                    DList_InitializeListHead(&first_batch_ops);
+                    DList_InitializeListHead(&second_batch_ops);
+
+                    /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_026: [ constbuffer_array_batcher_nv_async_submit shall increment the reference count of payload and store it, its size, on_payload_complete and context in the operation. ]*/
+                    constbuffer_array_inc_ref(payload);
+                    op->payload = payload;
+                    op->payload_size = payload_size;
+                    op->on_payload_complete = on_payload_complete;
+                    op->context = context;
+                    op->result = CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_CALLBACK_RESULT_OK;
+                    op->is_pending = false;
+                    THANDLE_INITIALIZE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC)(&op->batcher, batcher);
+                    THANDLE_INITIALIZE(ASYNC_OP)(&op->async_op, async_op);
+
+                    /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_027: [ constbuffer_array_batcher_nv_async_submit shall record the time of the submit by calling timer_global_get_elapsed_ms. ]*/
+                    double now_ms = timer_global_get_elapsed_ms();
+                    op->arrival_time_ms = now_ms;
+
+                    /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_028: [ constbuffer_array_batcher_nv_async_submit shall call srw_lock_acquire_exclusive. ]*/
+                    srw_lock_acquire_exclusive(batcher_ptr->lock);
+                    {
+                        if (batcher_ptr->is_closing)
+                        {
+                            /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_078: [ If is_closing is true then constbuffer_array_batcher_nv_async_submit shall fail and return CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT_ERROR. ]*/
+                            LogError("batcher is closing, cannot submit payload=%p", payload);
+                            result = CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT_ERROR;
+                        }
+                        else if (
+                            (batcher_ptr->pending_count == 0) &&
+                            (batcher_ptr->timer == NULL)
+                            )
+                        {
+                            /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_029: [ If the timer has not been started yet then constbuffer_array_batcher_nv_async_submit shall start it by calling threadpool_timer_start with max_delay_ms and on_timer. ]*/
+                            THANDLE(THREADPOOL_TIMER) timer = threadpool_timer_start(batcher_ptr->threadpool, batcher_ptr->max_delay_ms, 0, on_timer, batcher_ptr);
+                            if (timer == NULL)
+                            {
+                                /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_042: [ If there are any failures then constbuffer_array_batcher_nv_async_submit shall fail and return CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT_ERROR. ]*/
+                                LogError("failure in threadpool_timer_start(batcher_ptr->threadpool=%p, max_delay_ms=%" PRIu32 ", 0, on_timer=%p, batcher_ptr=%p)", batcher_ptr->threadpool, batcher_ptr->max_delay_ms, on_timer, batcher_ptr);
+                                result = CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT_ERROR;
+                            }
+                            else
+                            {
+                                THANDLE_MOVE(THREADPOOL_TIMER)(&batcher_ptr->timer, &timer);
+                                result = CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT_OK;
+                            }
+                        }
+                        else if (batcher_ptr->pending_count == 0)
+                        {
+                            /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_030: [ If there are no pending payloads and the timer has been started then constbuffer_array_batcher_nv_async_submit shall call threadpool_timer_restart with max_delay_ms. ]*/
+                            if (threadpool_timer_restart(batcher_ptr->timer, batcher_ptr->max_delay_ms, 0) != 0)
+                            {
+                                /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_042: [ If there are any failures then constbuffer_array_batcher_nv_async_submit shall fail and return CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT_ERROR. ]*/
+                                LogError("failure in threadpool_timer_restart(batcher_ptr->timer=%p, max_delay_ms=%" PRIu32 ", 0)", batcher_ptr->timer, batcher_ptr->max_delay_ms);
+                                result = CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT_ERROR;
+                            }
+                            else
+                            {
+                                result = CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT_OK;
+                            }
+                        }
+                        else
+                        {
+                            /*the timer is already running for the oldest pending payload*/
+                            result = CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT_OK;
+                        }
+
+                        if (result == CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT_OK)
+                        {
+                            uint32_t flush_payload_count = get_flush_payload_count(batcher_ptr, now_ms);
+
+                            if (
+                                (batcher_ptr->pending_count > 0) &&
+                                (
+                                    (batcher_ptr->pending_count == batcher_ptr->max_payload_count) ||
+                                    (get_batch_size(batcher_ptr->pending_count + 1, batcher_ptr->pending_payloads_size) + payload_size > batcher_ptr->max_batch_size)
+                                )
+                                )
+                            {
+                                /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_031: [ If adding payload to the pending payloads would go over max_payload_count payloads or over max_batch_size bytes then constbuffer_array_batcher_nv_async_submit shall first take all the pending payloads to be sent as one batch. ]*/
+                                first_batch_op_count = take_pending_ops(batcher_ptr, &first_batch_ops);
+                            }
+
+                            /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_032: [ constbuffer_array_batcher_nv_async_submit shall add the operation to the pending payloads. ]*/
+                            DList_InsertTailList(&batcher_ptr->pending_ops, &op->anchor);
+                            op->is_pending = true;
+                            batcher_ptr->pending_count++;
+                            batcher_ptr->pending_payloads_size += payload_size;
+
+                            if (
+                                (batcher_ptr->pending_count >= flush_payload_count) ||
+                                (get_batch_size(batcher_ptr->pending_count, batcher_ptr->pending_payloads_size) >= batcher_ptr->max_batch_size)
+                                )
+                            {
+                                /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_033: [ If the number of pending payloads reached the number of payloads that triggers a batch or the pending payloads reached max_batch_size bytes then constbuffer_array_batcher_nv_async_submit shall take all the pending payloads to be sent as one batch. ]*/
+                                second_batch_op_count = take_pending_ops(batcher_ptr, &second_batch_ops);
+                            }
+
+                            /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_034: [ constbuffer_array_batcher_nv_async_submit shall set *out_op to the created THANDLE(ASYNC_OP). ]*/
+                            THANDLE_INITIALIZE_MOVE(ASYNC_OP)(out_op, &async_op);
+                        }
+
+                        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_035: [ constbuffer_array_batcher_nv_async_submit shall call srw_lock_release_exclusive. ]*/
+                        srw_lock_release_exclusive(batcher_ptr->lock);
+                    }
+
+                    if (result != CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT_OK)
+                    {
+                        constbuffer_array_dec_ref(op->payload);
+                        op->payload = NULL;
+                        THANDLE_ASSIGN(ASYNC_OP)(&op->async_op, NULL);
+                        THANDLE_ASSIGN(ASYNC_OP)(&async_op, NULL);
+                    }
+                    else
+                    {
+                        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_039: [ constbuffer_array_batcher_nv_async_submit shall send the payloads it took (if any) by calling constbuffer_array_batcher_nv_batch and send_batch outside of the lock, in the order they were taken. ]*/
+                        if (first_batch_op_count > 0)
+                        {
+                            send_ops(batcher_ptr, &first_batch_ops, first_batch_op_count);
+                        }
+                        if (second_batch_op_count > 0)
+                        {
+                            send_ops(batcher_ptr, &second_batch_ops, second_batch_op_count);
+                        }
+                        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_040: [ constbuffer_array_batcher_nv_async_submit shall succeed and return CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT_OK. ]*/
+                    }
+                }
+            }
+
+            /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_041: [ constbuffer_array_batcher_nv_async_submit shall call sm_exec_end. ]*/
+            sm_exec_end(batcher_ptr->sm);
+        }
+    }
+    return result;
+}
+
+int constbuffer_array_batcher_nv_async_flush(THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) batcher)
+{
+    int result;
+
+    if (batcher == NULL)
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_070: [ If batcher is NULL then constbuffer_array_batcher_nv_async_flush shall fail and return a non-zero value. ]*/
+        LogError("Invalid arguments: THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) batcher=%p", batcher);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC* batcher_ptr = THANDLE_GET_T(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC)(batcher);
+
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_071: [ constbuffer_array_batcher_nv_async_flush shall call sm_exec_begin. ]*/
+        SM_RESULT sm_result = sm_exec_begin(batcher_ptr->sm);
+        if (sm_result != SM_EXEC_GRANTED)
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_075: [ If there are any failures then constbuffer_array_batcher_nv_async_flush shall fail and return a non-zero value. ]*/
+            LogError("failure in sm_exec_begin(batcher_ptr->sm=%p). SM_RESULT sm_result = %" PRI_MU_ENUM "", batcher_ptr->sm, MU_ENUM_VALUE(SM_RESULT, sm_result));
+            result = MU_FAILURE;
+        }
+        else
+        {
+            DLIST_ENTRY ops;
+            uint32_t op_count;
+            DList_InitializeListHead(&ops);
+
+            /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_072: [ constbuffer_array_batcher_nv_async_flush shall take all the pending payloads under the lock. ]*/
+            srw_lock_acquire_exclusive(batcher_ptr->lock);
+            op_count = take_pending_ops(batcher_ptr, &ops);
+            srw_lock_release_exclusive(batcher_ptr->lock);
+
+            if (op_count > 0)
+            {
+                /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_073: [ constbuffer_array_batcher_nv_async_flush shall send the payloads it took (if any) as one batch. ]*/
+                send_ops(batcher_ptr, &ops, op_count);
+            }
+
+            /*Codes_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_074: [ constbuffer_array_batcher_nv_async_flush shall call sm_exec_end, succeed and return 0. ]*/
+            sm_exec_end(batcher_ptr->sm);
+            result = 0;
+        }
+    }
+    return result;
+}
@@ -0,0 +1,227 @@
+// Copyright (C) Microsoft Corporation. All rights reserved.
+
+#include <stdlib.h>
+#include <inttypes.h>
+
+#include "macro_utils/macro_utils.h"
+
+#include "c_logging/logger.h"
+
+#include "c_pal/gballoc_hl.h"
+#include "c_pal/gballoc_hl_redirect.h"
+
+#include "c_util/constbuffer.h"
+#include "c_util/constbuffer_array.h"
+
+#include "c_util/constbuffer_array_builder.h"
+
+typedef struct CONSTBUFFER_ARRAY_BUILDER_TAG
+{
+    uint32_t buffer_count;
+    uint32_t capacity;
+    CONSTBUFFER_HANDLE* buffers; /*owns a reference on buffers[0..buffer_count-1]*/
+} CONSTBUFFER_ARRAY_BUILDER;
+
+CONSTBUFFER_ARRAY_BUILDER_HANDLE constbuffer_array_builder_create(uint32_t initial_capacity)
+{
+    CONSTBUFFER_ARRAY_BUILDER_HANDLE result;
+
+    /*Codes_SRS_CONSTBUFFER_ARRAY_BUILDER_12_001: [ constbuffer_array_builder_create shall allocate memory for a new CONSTBUFFER_ARRAY_BUILDER_HANDLE. ]*/
+    result = malloc(sizeof(CONSTBUFFER_ARRAY_BUILDER));
+    if (result == NULL)
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BUILDER_12_004: [ If there are any failures then constbuffer_array_builder_create shall fail and return NULL. ]*/
+        LogError("failure in malloc(sizeof(CONSTBUFFER_ARRAY_BUILDER)=%zu)", sizeof(CONSTBUFFER_ARRAY_BUILDER));
+        /*return as is*/
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BUILDER_12_002: [ constbuffer_array_builder_create shall allocate memory for initial_capacity CONSTBUFFER_HANDLEs, or for CONSTBUFFER_ARRAY_BUILDER_DEFAULT_CAPACITY CONSTBUFFER_HANDLEs if initial_capacity is 0. ]*/
+        result->capacity = (initial_capacity == 0) ? CONSTBUFFER_ARRAY_BUILDER_DEFAULT_CAPACITY : initial_capacity;
+        result->buffers = malloc_2(result->capacity, sizeof(CONSTBUFFER_HANDLE));
+        if (result->buffers == NULL)
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_BUILDER_12_004: [ If there are any failures then constbuffer_array_builder_create shall fail and return NULL. ]*/
+            LogError("failure in malloc_2(result->capacity=%" PRIu32 ", sizeof(CONSTBUFFER_HANDLE)=%zu)", result->capacity, sizeof(CONSTBUFFER_HANDLE));
+            free(result);
+            result = NULL;
+        }
+        else
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_BUILDER_12_003: [ constbuffer_array_builder_create shall succeed and return a non-NULL handle that holds no buffers. ]*/
+            result->buffer_count = 0;
+        }
+    }
+    return result;
+}
+
+void constbuffer_array_builder_destroy(CONSTBUFFER_ARRAY_BUILDER_HANDLE builder)
+{
+    if (builder == NULL)
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BUILDER_12_005: [ If builder is NULL then constbuffer_array_builder_destroy shall return. ]*/
+        LogError("invalid argument CONSTBUFFER_ARRAY_BUILDER_HANDLE builder=%p", builder);
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BUILDER_12_006: [ constbuffer_array_builder_destroy shall decrement the reference count of all the buffers held by builder and free all used resources. ]*/
+        for (uint32_t i = 0; i < builder->buffer_count; i++)
+        {
+            CONSTBUFFER_DecRef(builder->buffers[i]);
+        }
+        free(builder->buffers);
+        free(builder);
+    }
+}
+
+/*stores buffer at the end of builder->buffers, growing it by doubling its capacity when it is full*/
+static int constbuffer_array_builder_store(CONSTBUFFER_ARRAY_BUILDER_HANDLE builder, CONSTBUFFER_HANDLE buffer)
+{
+    int result;
+    if (builder->buffer_count == builder->capacity)
+    {
+        if (builder->capacity == UINT32_MAX)
+        {
+            /*a CONSTBUFFER_ARRAY_HANDLE cannot hold more than UINT32_MAX buffers (not reachable in unit tests, it takes UINT32_MAX appends)*/
+            LogError("builder=%p already holds %" PRIu32 " buffers", builder, builder->buffer_count);
+            result = MU_FAILURE;
+        }
+        else
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_BUILDER_12_010: [ If builder is full then constbuffer_array_builder_append and constbuffer_array_builder_append_move shall double its capacity (up to UINT32_MAX) by reallocating the array of CONSTBUFFER_HANDLEs. ]*/
+            uint32_t new_capacity = (builder->capacity > UINT32_MAX / 2) ? UINT32_MAX : builder->capacity * 2;
+            CONSTBUFFER_HANDLE* new_buffers = realloc_2(builder->buffers, new_capacity, sizeof(CONSTBUFFER_HANDLE));
+            if (new_buffers == NULL)
+            {
+                /*Codes_SRS_CONSTBUFFER_ARRAY_BUILDER_12_011: [ If there are any failures then constbuffer_array_builder_append and constbuffer_array_builder_append_move shall fail, leave builder unchanged and return a non-zero value. ]*/
+                LogError("failure in realloc_2(builder->buffers=%p, new_capacity=%" PRIu32 ", sizeof(CONSTBUFFER_HANDLE)=%zu)", builder->buffers, new_capacity, sizeof(CONSTBUFFER_HANDLE));
+                result = MU_FAILURE;
+            }
+            else
+            {
+                builder->buffers = new_buffers;
+                builder->capacity = new_capacity;
+                result = 0;
+            }
+        }
+    }
+    else
+    {
+        result = 0;
+    }
+
+    if (result == 0)
+    {
+        builder->buffers[builder->buffer_count] = buffer;
+        builder->buffer_count++;
+    }
+    return result;
+}
+
+int constbuffer_array_builder_append(CONSTBUFFER_ARRAY_BUILDER_HANDLE builder, CONSTBUFFER_HANDLE buffer)
+{
+    int result;
+    if (
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BUILDER_12_007: [ If builder is NULL then constbuffer_array_builder_append shall fail and return a non-zero value. ]*/
+        (builder == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BUILDER_12_008: [ If buffer is NULL then constbuffer_array_builder_append shall fail and return a non-zero value. ]*/
+        (buffer == NULL)
+        )
+    {
+        LogError("invalid arguments CONSTBUFFER_ARRAY_BUILDER_HANDLE builder=%p, CONSTBUFFER_HANDLE buffer=%p", builder, buffer);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        if (constbuffer_array_builder_store(builder, buffer) != 0)
+        {
+            LogError("failure in constbuffer_array_builder_store(builder=%p, buffer=%p)", builder, buffer);
+            result = MU_FAILURE;
+        }
+        else
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_BUILDER_12_012: [ constbuffer_array_builder_append shall increment the reference count of buffer, store it after the buffers already held by builder, succeed and return 0. ]*/
+            CONSTBUFFER_IncRef(buffer);
+            result = 0;
+        }
+    }
+    return result;
+}
+
+int constbuffer_array_builder_append_move(CONSTBUFFER_ARRAY_BUILDER_HANDLE builder, CONSTBUFFER_HANDLE buffer)
+{
+    int result;
+    if (
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BUILDER_12_013: [ If builder is NULL then constbuffer_array_builder_append_move shall fail and return a non-zero value. ]*/
+        (builder == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BUILDER_12_014: [ If buffer is NULL then constbuffer_array_builder_append_move shall fail and return a non-zero value. ]*/
+        (buffer == NULL)
+        )
+    {
+        LogError("invalid arguments CONSTBUFFER_ARRAY_BUILDER_HANDLE builder=%p, CONSTBUFFER_HANDLE buffer=%p", builder, buffer);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        if (constbuffer_array_builder_store(builder, buffer) != 0)
+        {
+            LogError("failure in constbuffer_array_builder_store(builder=%p, buffer=%p)", builder, buffer);
+            result = MU_FAILURE;
+        }
+        else
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_BUILDER_12_015: [ constbuffer_array_builder_append_move shall store buffer after the buffers already held by builder without incrementing its reference count (the reference of the caller is moved in builder), succeed and return 0. ]*/
+            result = 0;
+        }
+    }
+    return result;
+}
+
+int constbuffer_array_builder_get_buffer_count(CONSTBUFFER_ARRAY_BUILDER_HANDLE builder, uint32_t* buffer_count)
+{
+    int result;
+    if (
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BUILDER_12_016: [ If builder is NULL then constbuffer_array_builder_get_buffer_count shall fail and return a non-zero value. ]*/
+        (builder == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BUILDER_12_017: [ If buffer_count is NULL then constbuffer_array_builder_get_buffer_count shall fail and return a non-zero value. ]*/
+        (buffer_count == NULL)
+        )
+    {
+        LogError("invalid arguments CONSTBUFFER_ARRAY_BUILDER_HANDLE builder=%p, uint32_t* buffer_count=%p", builder, buffer_count);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BUILDER_12_018: [ constbuffer_array_builder_get_buffer_count shall write in buffer_count the number of buffers held by builder, succeed and return 0. ]*/
+        *buffer_count = builder->buffer_count;
+        result = 0;
+    }
+    return result;
+}
+
+CONSTBUFFER_ARRAY_HANDLE constbuffer_array_builder_seal(CONSTBUFFER_ARRAY_BUILDER_HANDLE builder)
+{
+    CONSTBUFFER_ARRAY_HANDLE result;
+    if (builder == NULL)
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BUILDER_12_019: [ If builder is NULL then constbuffer_array_builder_seal shall fail and return NULL. ]*/
+        LogError("invalid argument CONSTBUFFER_ARRAY_BUILDER_HANDLE builder=%p", builder);
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_BUILDER_12_020: [ constbuffer_array_builder_seal shall call constbuffer_array_create_with_move_buffers with the array of CONSTBUFFER_HANDLEs of builder and the number of buffers it holds (the handles are not copied and their reference counts are not changed). ]*/
+        result = constbuffer_array_create_with_move_buffers(builder->buffers, builder->buffer_count);
+        if (result == NULL)
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_BUILDER_12_021: [ If there are any failures then constbuffer_array_builder_seal shall fail, leave builder unchanged and return NULL. ]*/
+            LogError("failure in constbuffer_array_create_with_move_buffers(builder->buffers=%p, builder->buffer_count=%" PRIu32 ")", builder->buffers, builder->buffer_count);
+        }
+        else
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_BUILDER_12_022: [ constbuffer_array_builder_seal shall free builder, succeed and return the CONSTBUFFER_ARRAY_HANDLE. ]*/
+            free(builder);
+        }
+    }
+    return result;
+}
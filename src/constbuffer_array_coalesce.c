@@ -0,0 +1,243 @@
+// Copyright (C) Microsoft Corporation. All rights reserved.
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "macro_utils/macro_utils.h"
+
+#include "c_logging/logger.h"
+
+#include "c_pal/gballoc_hl.h"
+#include "c_pal/gballoc_hl_redirect.h"
+
+#include "c_util/constbuffer.h"
+#include "c_util/constbuffer_array.h"
+
+#include "c_util/constbuffer_array_coalesce.h"
+
+/*a group of consecutive buffers of the original array that becomes one buffer of the result*/
+typedef struct SEGMENT_TAG
+{
+    uint32_t start_buffer_index;
+    uint32_t buffer_count;
+    uint32_t size;
+    bool is_run; /*the segment is made of buffers smaller than min_segment_size and can still grow*/
+} SEGMENT;
+
+static void segment_start(SEGMENT* segment, uint32_t buffer_index, uint32_t buffer_size, uint32_t min_segment_size)
+{
+    segment->start_buffer_index = buffer_index;
+    segment->buffer_count = 1;
+    segment->size = buffer_size;
+    segment->is_run = (buffer_size < min_segment_size);
+}
+
+static bool segment_try_append(SEGMENT* segment, uint32_t buffer_size, uint32_t min_segment_size, uint32_t max_segment_size)
+{
+    bool result;
+
+    /*a run never exceeds max_segment_size (its first buffer is smaller than min_segment_size), so max_segment_size - segment->size does not wrap*/
+    if (
+        segment->buffer_count != 0 &&
+        segment->is_run &&
+        buffer_size < min_segment_size &&
+        buffer_size <= max_segment_size - segment->size
+        )
+    {
+        segment->buffer_count++;
+        segment->size += buffer_size;
+        result = true;
+    }
+    else
+    {
+        result = false;
+    }
+
+    return result;
+}
+
+static int segment_produce(CONSTBUFFER_ARRAY_HANDLE buffers, const SEGMENT* segment, CONSTBUFFER_HANDLE* coalesced_buffers, uint32_t* coalesced_buffer_count)
+{
+    int result;
+
+    if (segment->size == 0)
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_COALESCE_12_011: [ Segments of 0 bytes shall be skipped. ]*/
+        result = 0;
+    }
+    else if (segment->buffer_count == 1)
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_COALESCE_12_009: [ For a segment made of a single buffer constbuffer_array_coalesce shall call constbuffer_array_get_buffer and use the buffer as-is (zero-copy). ]*/
+        coalesced_buffers[*coalesced_buffer_count] = constbuffer_array_get_buffer(buffers, segment->start_buffer_index);
+        (*coalesced_buffer_count)++;
+        result = 0;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_COALESCE_12_010: [ For a segment made of more than one buffer constbuffer_array_coalesce shall call CONSTBUFFER_CreateWritableHandle with the size of the segment, copy the content of the buffers of the segment (obtained with constbuffer_array_get_buffer_content) in it and call CONSTBUFFER_SealWritableHandle. ]*/
+        CONSTBUFFER_WRITABLE_HANDLE writable = CONSTBUFFER_CreateWritableHandle(segment->size);
+        if (writable == NULL)
+        {
+            LogError("failure in CONSTBUFFER_CreateWritableHandle(size=%" PRIu32 ")", segment->size);
+            result = MU_FAILURE;
+        }
+        else
+        {
+            unsigned char* destination = CONSTBUFFER_GetWritableBuffer(writable);
+            uint32_t copied = 0;
+
+            for (uint32_t i = 0; i < segment->buffer_count; i++)
+            {
+                const CONSTBUFFER* content = constbuffer_array_get_buffer_content(buffers, segment->start_buffer_index + i);
+                if (content->size != 0)
+                {
+                    (void)memcpy(destination + copied, content->buffer, content->size);
+                    copied += content->size;
+                }
+            }
+
+            coalesced_buffers[*coalesced_buffer_count] = CONSTBUFFER_SealWritableHandle(writable);
+            (*coalesced_buffer_count)++;
+            result = 0;
+        }
+    }
+
+    return result;
+}
+
+CONSTBUFFER_ARRAY_HANDLE constbuffer_array_coalesce(CONSTBUFFER_ARRAY_HANDLE buffers, uint32_t min_segment_size, uint32_t max_segment_size)
+{
+    CONSTBUFFER_ARRAY_HANDLE result;
+
+    if (
+        /*Codes_SRS_CONSTBUFFER_ARRAY_COALESCE_12_001: [ If buffers is NULL then constbuffer_array_coalesce shall fail and return NULL. ]*/
+        buffers == NULL ||
+        /*Codes_SRS_CONSTBUFFER_ARRAY_COALESCE_12_002: [ If max_segment_size is 0 then constbuffer_array_coalesce shall fail and return NULL. ]*/
+        max_segment_size == 0 ||
+        /*Codes_SRS_CONSTBUFFER_ARRAY_COALESCE_12_003: [ If min_segment_size is greater than max_segment_size then constbuffer_array_coalesce shall fail and return NULL. ]*/
+        min_segment_size > max_segment_size
+        )
+    {
+        LogError("Invalid args : CONSTBUFFER_ARRAY_HANDLE buffers=%p, uint32_t min_segment_size=%" PRIu32 ", uint32_t max_segment_size=%" PRIu32,
+            buffers, min_segment_size, max_segment_size);
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_COALESCE_12_004: [ constbuffer_array_coalesce shall call constbuffer_array_get_buffer_count. ]*/
+        uint32_t buffer_count;
+        (void)constbuffer_array_get_buffer_count(buffers, &buffer_count);
+
+        /*Codes_SRS_CONSTBUFFER_ARRAY_COALESCE_12_005: [ constbuffer_array_coalesce shall group the buffers in segments by calling constbuffer_array_get_buffer_content for each buffer: a buffer of at least min_segment_size bytes is a segment on its own, a buffer smaller than min_segment_size starts a segment that also takes the following buffers smaller than min_segment_size as long as the segment does not exceed max_segment_size bytes. ]*/
+        /*Codes_SRS_CONSTBUFFER_ARRAY_COALESCE_12_006: [ constbuffer_array_coalesce shall count the segments that are not empty. ]*/
+        SEGMENT segment = { 0 };
+        uint32_t segment_count = 0;
+
+        for (uint32_t i = 0; i < buffer_count; i++)
+        {
+            const CONSTBUFFER* content = constbuffer_array_get_buffer_content(buffers, i);
+            if (!segment_try_append(&segment, content->size, min_segment_size, max_segment_size))
+            {
+                if (segment.size != 0)
+                {
+                    segment_count++;
+                }
+                segment_start(&segment, i, content->size, min_segment_size);
+            }
+        }
+        if (segment.size != 0)
+        {
+            segment_count++;
+        }
+
+        if (segment_count == buffer_count)
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_COALESCE_12_007: [ If the number of segments is the number of buffers (there is nothing to merge and no empty buffer) then constbuffer_array_coalesce shall call constbuffer_array_inc_ref and return buffers. ]*/
+            constbuffer_array_inc_ref(buffers);
+            result = buffers;
+        }
+        else if (segment_count == 0)
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_COALESCE_12_015: [ If all the buffers are empty then constbuffer_array_coalesce shall call constbuffer_array_create_empty and return the result. ]*/
+            result = constbuffer_array_create_empty();
+
+            if (result == NULL)
+            {
+                LogError("constbuffer_array_create_empty failed");
+            }
+            // return as-is
+        }
+        else
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_COALESCE_12_008: [ constbuffer_array_coalesce shall allocate an array of CONSTBUFFER_HANDLE for the segments. ]*/
+            CONSTBUFFER_HANDLE* coalesced_buffers = malloc_2(segment_count, sizeof(CONSTBUFFER_HANDLE));
+            if (coalesced_buffers == NULL)
+            {
+                /*Codes_SRS_CONSTBUFFER_ARRAY_COALESCE_12_014: [ If there are any failures then constbuffer_array_coalesce shall fail and return NULL. ]*/
+                LogError("failure in malloc_2(segment_count=%" PRIu32 ", sizeof(CONSTBUFFER_HANDLE)=%zu)", segment_count, sizeof(CONSTBUFFER_HANDLE));
+                result = NULL;
+            }
+            else
+            {
+                uint32_t coalesced_buffer_count = 0;
+                int produce_result = 0;
+                SEGMENT produced_segment = { 0 };
+                uint32_t i;
+
+                for (i = 0; i < buffer_count; i++)
+                {
+                    const CONSTBUFFER* content = constbuffer_array_get_buffer_content(buffers, i);
+                    if (!segment_try_append(&produced_segment, content->size, min_segment_size, max_segment_size))
+                    {
+                        if (produced_segment.buffer_count != 0)
+                        {
+                            produce_result = segment_produce(buffers, &produced_segment, coalesced_buffers, &coalesced_buffer_count);
+                            if (produce_result != 0)
+                            {
+                                break;
+                            }
+                        }
+                        segment_start(&produced_segment, i, content->size, min_segment_size);
+                    }
+                }
+
+                if (i == buffer_count)
+                {
+                    produce_result = segment_produce(buffers, &produced_segment, coalesced_buffers, &coalesced_buffer_count);
+                }
+
+                if (produce_result != 0)
+                {
+                    /*Codes_SRS_CONSTBUFFER_ARRAY_COALESCE_12_014: [ If there are any failures then constbuffer_array_coalesce shall fail and return NULL. ]*/
+                    LogError("failure in segment_produce");
+                    result = NULL;
+                }
+                else
+                {
+                    /*Codes_SRS_CONSTBUFFER_ARRAY_COALESCE_12_012: [ constbuffer_array_coalesce shall call constbuffer_array_create_with_move_buffers with the array of segments. ]*/
+                    result = constbuffer_array_create_with_move_buffers(coalesced_buffers, coalesced_buffer_count);
+                    if (result == NULL)
+                    {
+                        /*Codes_SRS_CONSTBUFFER_ARRAY_COALESCE_12_014: [ If there are any failures then constbuffer_array_coalesce shall fail and return NULL. ]*/
+                        LogError("failure in constbuffer_array_create_with_move_buffers(coalesced_buffers=%p, coalesced_buffer_count=%" PRIu32 ")", coalesced_buffers, coalesced_buffer_count);
+                    }
+                    else
+                    {
+                        /*Codes_SRS_CONSTBUFFER_ARRAY_COALESCE_12_013: [ constbuffer_array_coalesce shall succeed and return the new array. ]*/
+                        goto all_ok;
+                    }
+                }
+
+                for (uint32_t j = 0; j < coalesced_buffer_count; j++)
+                {
+                    CONSTBUFFER_DecRef(coalesced_buffers[j]);
+                }
+                free(coalesced_buffers);
+            }
+        }
+    }
+all_ok:
+    return result;
+}
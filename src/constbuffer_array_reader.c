@@ -0,0 +1,318 @@
+// Copyright (C) Microsoft Corporation. All rights reserved.
+
+#include <stdlib.h>
+#include <inttypes.h>
+#include <string.h>
+
+#include "macro_utils/macro_utils.h"
+
+#include "c_logging/logger.h"
+
+#include "c_pal/gballoc_hl.h"
+#include "c_pal/gballoc_hl_redirect.h"
+
+#include "c_util/constbuffer.h"
+#include "c_util/constbuffer_array.h"
+#include "c_util/memory_data.h"
+#include "c_util/uuid_string.h"
+
+#include "c_util/constbuffer_array_reader.h"
+
+typedef struct CONSTBUFFER_ARRAY_READER_TAG
+{
+    CONSTBUFFER_ARRAY_HANDLE array; /*the reader holds a reference on it*/
+    uint64_t remaining; /*bytes not read yet*/
+    /*when remaining is not 0 the next byte is buffer->buffer[buffer_offset] (buffer_offset < buffer->size), buffer being the content of the buffer_index-th buffer of array*/
+    uint32_t buffer_index;
+    uint32_t buffer_offset;
+    const CONSTBUFFER* buffer;
+} CONSTBUFFER_ARRAY_READER;
+
+/*moves the reader past the end of the current buffer (and past any empty buffer after it) so that the next byte is in reader->buffer*/
+static void constbuffer_array_reader_settle(CONSTBUFFER_ARRAY_READER_HANDLE reader)
+{
+    while ((reader->remaining > 0) && (reader->buffer_offset == reader->buffer->size))
+    {
+        reader->buffer_index++;
+        reader->buffer_offset = 0;
+        reader->buffer = constbuffer_array_get_buffer_content(reader->array, reader->buffer_index);
+    }
+}
+
+/*moves the reader size bytes forward (size <= reader->remaining), copying them in destination when destination is not NULL*/
+static void constbuffer_array_reader_consume(CONSTBUFFER_ARRAY_READER_HANDLE reader, uint64_t size, unsigned char* destination)
+{
+    while (size > 0)
+    {
+        uint32_t available = (uint32_t)(reader->buffer->size - reader->buffer_offset);
+        uint32_t chunk = (size < available) ? (uint32_t)size : available;
+        if (destination != NULL)
+        {
+            (void)memcpy(destination, reader->buffer->buffer + reader->buffer_offset, chunk);
+            destination += chunk;
+        }
+        reader->buffer_offset += chunk;
+        reader->remaining -= chunk;
+        size -= chunk;
+        constbuffer_array_reader_settle(reader);
+    }
+}
+
+/*returns the address of the next size bytes (size <= reader->remaining) and moves the reader past them. When the bytes are all in the current buffer
+that is their address in the buffer, otherwise they are gathered in scratch (which has room for size bytes)*/
+static const unsigned char* constbuffer_array_reader_take(CONSTBUFFER_ARRAY_READER_HANDLE reader, uint32_t size, unsigned char* scratch)
+{
+    const unsigned char* result;
+    if (reader->buffer->size - reader->buffer_offset >= size)
+    {
+        result = reader->buffer->buffer + reader->buffer_offset;
+        reader->buffer_offset += size;
+        reader->remaining -= size;
+        constbuffer_array_reader_settle(reader);
+    }
+    else
+    {
+        constbuffer_array_reader_consume(reader, size, scratch);
+        result = scratch;
+    }
+    return result;
+}
+
+CONSTBUFFER_ARRAY_READER_HANDLE constbuffer_array_reader_create(CONSTBUFFER_ARRAY_HANDLE array)
+{
+    CONSTBUFFER_ARRAY_READER_HANDLE result;
+    uint64_t all_buffers_size;
+
+    if (array == NULL)
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_READER_12_001: [ If array is NULL then constbuffer_array_reader_create shall fail and return NULL. ]*/
+        LogError("invalid argument CONSTBUFFER_ARRAY_HANDLE array=%p", array);
+        result = NULL;
+    }
+    /*Codes_SRS_CONSTBUFFER_ARRAY_READER_12_002: [ constbuffer_array_reader_create shall get the total size of the buffers of array by calling constbuffer_array_get_all_buffers_size_64. ]*/
+    else if (constbuffer_array_get_all_buffers_size_64(array, &all_buffers_size) != 0)
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_READER_12_005: [ If there are any failures then constbuffer_array_reader_create shall fail and return NULL. ]*/
+        LogError("failure in constbuffer_array_get_all_buffers_size_64(array=%p, &all_buffers_size=%p)", array, &all_buffers_size);
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_READER_12_003: [ constbuffer_array_reader_create shall allocate memory for a new CONSTBUFFER_ARRAY_READER_HANDLE. ]*/
+        result = malloc(sizeof(CONSTBUFFER_ARRAY_READER));
+        if (result == NULL)
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_READER_12_005: [ If there are any failures then constbuffer_array_reader_create shall fail and return NULL. ]*/
+            LogError("failure in malloc(sizeof(CONSTBUFFER_ARRAY_READER)=%zu)", sizeof(CONSTBUFFER_ARRAY_READER));
+            /*return as is*/
+        }
+        else
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_READER_12_004: [ constbuffer_array_reader_create shall increment the reference count of array, position the reader at the first byte of array, succeed and return a non-NULL handle. ]*/
+            constbuffer_array_inc_ref(array);
+            result->array = array;
+            result->remaining = all_buffers_size;
+            result->buffer_index = 0;
+            result->buffer_offset = 0;
+            if (all_buffers_size == 0)
+            {
+                result->buffer = NULL;
+            }
+            else
+            {
+                result->buffer = constbuffer_array_get_buffer_content(array, 0);
+                constbuffer_array_reader_settle(result);
+            }
+        }
+    }
+    return result;
+}
+
+void constbuffer_array_reader_destroy(CONSTBUFFER_ARRAY_READER_HANDLE reader)
+{
+    if (reader == NULL)
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_READER_12_006: [ If reader is NULL then constbuffer_array_reader_destroy shall return. ]*/
+        LogError("invalid argument CONSTBUFFER_ARRAY_READER_HANDLE reader=%p", reader);
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_READER_12_007: [ constbuffer_array_reader_destroy shall decrement the reference count of the array and free all used resources. ]*/
+        constbuffer_array_dec_ref(reader->array);
+        free(reader);
+    }
+}
+
+int constbuffer_array_reader_get_remaining(CONSTBUFFER_ARRAY_READER_HANDLE reader, uint64_t* remaining)
+{
+    int result;
+    if (
+        /*Codes_SRS_CONSTBUFFER_ARRAY_READER_12_008: [ If reader is NULL then constbuffer_array_reader_get_remaining shall fail and return a non-zero value. ]*/
+        (reader == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_ARRAY_READER_12_009: [ If remaining is NULL then constbuffer_array_reader_get_remaining shall fail and return a non-zero value. ]*/
+        (remaining == NULL)
+        )
+    {
+        LogError("invalid arguments CONSTBUFFER_ARRAY_READER_HANDLE reader=%p, uint64_t* remaining=%p", reader, remaining);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_READER_12_010: [ constbuffer_array_reader_get_remaining shall write in remaining the number of bytes that were not read yet, succeed and return 0. ]*/
+        *remaining = reader->remaining;
+        result = 0;
+    }
+    return result;
+}
+
+/*Codes_SRS_CONSTBUFFER_ARRAY_READER_12_014: [ If all the bytes of the value are in the same buffer then constbuffer_array_reader_read_uint8, constbuffer_array_reader_read_uint16, constbuffer_array_reader_read_uint32, constbuffer_array_reader_read_uint64 and constbuffer_array_reader_read_uuid shall decode them from that buffer by calling read_uint8_t, read_uint16_t, read_uint32_t, read_uint64_t and read_uuid_t respectively. ]*/
+/*Codes_SRS_CONSTBUFFER_ARRAY_READER_12_015: [ Otherwise constbuffer_array_reader_read_uint8, constbuffer_array_reader_read_uint16, constbuffer_array_reader_read_uint32, constbuffer_array_reader_read_uint64 and constbuffer_array_reader_read_uuid shall copy the bytes of the value from the buffers that hold them in a local buffer and decode them from there. ]*/
+/*Codes_SRS_CONSTBUFFER_ARRAY_READER_12_016: [ constbuffer_array_reader_read_uint8, constbuffer_array_reader_read_uint16, constbuffer_array_reader_read_uint32, constbuffer_array_reader_read_uint64 and constbuffer_array_reader_read_uuid shall move the reader past the bytes of the value, succeed and return 0. ]*/
+#define CONSTBUFFER_ARRAY_READER_READ_VALUE(function_name, value_type, decode) \
+int function_name(CONSTBUFFER_ARRAY_READER_HANDLE reader, value_type* value) \
+{ \
+    int result; \
+    if ( \
+        /*Codes_SRS_CONSTBUFFER_ARRAY_READER_12_011: [ If reader is NULL then constbuffer_array_reader_read_uint8, constbuffer_array_reader_read_uint16, constbuffer_array_reader_read_uint32, constbuffer_array_reader_read_uint64 and constbuffer_array_reader_read_uuid shall fail and return a non-zero value. ]*/ \
+        (reader == NULL) || \
+        /*Codes_SRS_CONSTBUFFER_ARRAY_READER_12_012: [ If value is NULL then constbuffer_array_reader_read_uint8, constbuffer_array_reader_read_uint16, constbuffer_array_reader_read_uint32, constbuffer_array_reader_read_uint64 and constbuffer_array_reader_read_uuid shall fail and return a non-zero value. ]*/ \
+        (value == NULL) \
+        ) \
+    { \
+        LogError("invalid arguments CONSTBUFFER_ARRAY_READER_HANDLE reader=%p, " MU_TOSTRING(value_type) "* value=%p", reader, value); \
+        result = MU_FAILURE; \
+    } \
+    else if (reader->remaining < sizeof(value_type)) \
+    { \
+        /*Codes_SRS_CONSTBUFFER_ARRAY_READER_12_013: [ If fewer bytes than the size of the value remain to be read then constbuffer_array_reader_read_uint8, constbuffer_array_reader_read_uint16, constbuffer_array_reader_read_uint32, constbuffer_array_reader_read_uint64 and constbuffer_array_reader_read_uuid shall fail, leave the reader unchanged and return a non-zero value. ]*/ \
+        LogError("reader=%p has only %" PRIu64 " bytes left, cannot read %zu bytes", reader, reader->remaining, sizeof(value_type)); \
+        result = MU_FAILURE; \
+    } \
+    else \
+    { \
+        unsigned char scratch[sizeof(value_type)]; \
+        decode(constbuffer_array_reader_take(reader, sizeof(value_type), scratch), value); \
+        result = 0; \
+    } \
+    return result; \
+}
+
+CONSTBUFFER_ARRAY_READER_READ_VALUE(constbuffer_array_reader_read_uint8, uint8_t, read_uint8_t)
+CONSTBUFFER_ARRAY_READER_READ_VALUE(constbuffer_array_reader_read_uint16, uint16_t, read_uint16_t)
+CONSTBUFFER_ARRAY_READER_READ_VALUE(constbuffer_array_reader_read_uint32, uint32_t, read_uint32_t)
+CONSTBUFFER_ARRAY_READER_READ_VALUE(constbuffer_array_reader_read_uint64, uint64_t, read_uint64_t)
+CONSTBUFFER_ARRAY_READER_READ_VALUE(constbuffer_array_reader_read_uuid, UUID_T, read_uuid_t)
+
+int constbuffer_array_reader_skip(CONSTBUFFER_ARRAY_READER_HANDLE reader, uint64_t size)
+{
+    int result;
+    if (reader == NULL)
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_READER_12_017: [ If reader is NULL then constbuffer_array_reader_skip shall fail and return a non-zero value. ]*/
+        LogError("invalid arguments CONSTBUFFER_ARRAY_READER_HANDLE reader=%p, uint64_t size=%" PRIu64 "", reader, size);
+        result = MU_FAILURE;
+    }
+    else if (size > reader->remaining)
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_READER_12_018: [ If size is greater than the number of bytes that remain to be read then constbuffer_array_reader_skip shall fail, leave the reader unchanged and return a non-zero value. ]*/
+        LogError("reader=%p has only %" PRIu64 " bytes left, cannot skip %" PRIu64 " bytes", reader, reader->remaining, size);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_READER_12_019: [ constbuffer_array_reader_skip shall move the reader size bytes forward, succeed and return 0. ]*/
+        constbuffer_array_reader_consume(reader, size, NULL);
+        result = 0;
+    }
+    return result;
+}
+
+int constbuffer_array_reader_peek(CONSTBUFFER_ARRAY_READER_HANDLE reader, uint32_t size, unsigned char* destination)
+{
+    int result;
+    if (
+        /*Codes_SRS_CONSTBUFFER_ARRAY_READER_12_020: [ If reader is NULL then constbuffer_array_reader_peek shall fail and return a non-zero value. ]*/
+        (reader == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_ARRAY_READER_12_021: [ If destination is NULL then constbuffer_array_reader_peek shall fail and return a non-zero value. ]*/
+        (destination == NULL)
+        )
+    {
+        LogError("invalid arguments CONSTBUFFER_ARRAY_READER_HANDLE reader=%p, uint32_t size=%" PRIu32 ", unsigned char* destination=%p", reader, size, destination);
+        result = MU_FAILURE;
+    }
+    else if (size > reader->remaining)
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_READER_12_022: [ If size is greater than the number of bytes that remain to be read then constbuffer_array_reader_peek shall fail and return a non-zero value. ]*/
+        LogError("reader=%p has only %" PRIu64 " bytes left, cannot peek %" PRIu32 " bytes", reader, reader->remaining, size);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_READER_12_023: [ constbuffer_array_reader_peek shall copy the next size bytes in destination without moving the reader, succeed and return 0. ]*/
+        CONSTBUFFER_ARRAY_READER position = *reader;
+        constbuffer_array_reader_consume(&position, size, destination);
+        result = 0;
+    }
+    return result;
+}
+
+CONSTBUFFER_ARRAY_HANDLE constbuffer_array_reader_read_array(CONSTBUFFER_ARRAY_READER_HANDLE reader, uint64_t size)
+{
+    CONSTBUFFER_ARRAY_HANDLE result;
+    if (reader == NULL)
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_READER_12_024: [ If reader is NULL then constbuffer_array_reader_read_array shall fail and return NULL. ]*/
+        LogError("invalid arguments CONSTBUFFER_ARRAY_READER_HANDLE reader=%p, uint64_t size=%" PRIu64 "", reader, size);
+        result = NULL;
+    }
+    else if (size > reader->remaining)
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_READER_12_025: [ If size is greater than the number of bytes that remain to be read then constbuffer_array_reader_read_array shall fail, leave the reader unchanged and return NULL. ]*/
+        LogError("reader=%p has only %" PRIu64 " bytes left, cannot read %" PRIu64 " bytes", reader, reader->remaining, size);
+        result = NULL;
+    }
+    else if (size == 0)
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_READER_12_026: [ If size is 0 then constbuffer_array_reader_read_array shall call constbuffer_array_create_empty and return its result. ]*/
+        result = constbuffer_array_create_empty();
+        if (result == NULL)
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_READER_12_029: [ If there are any failures then constbuffer_array_reader_read_array shall fail, leave the reader unchanged and return NULL. ]*/
+            LogError("failure in constbuffer_array_create_empty()");
+        }
+    }
+    else
+    {
+        /*find the buffer that holds the last of the size bytes and how many of them are in it*/
+        uint32_t end_buffer_index = reader->buffer_index;
+        uint32_t end_buffer_offset = reader->buffer_offset;
+        const CONSTBUFFER* end_buffer = reader->buffer;
+        uint64_t left = size;
+        while (left > end_buffer->size - end_buffer_offset)
+        {
+            left -= end_buffer->size - end_buffer_offset;
+            end_buffer_index++;
+            end_buffer_offset = 0;
+            end_buffer = constbuffer_array_get_buffer_content(reader->array, end_buffer_index);
+        }
+
+        /*Codes_SRS_CONSTBUFFER_ARRAY_READER_12_027: [ Otherwise constbuffer_array_reader_read_array shall call constbuffer_array_create_from_buffer_offset_and_count with the index of the buffer that holds the next byte, the number of buffers that hold the next size bytes, the offset of the next byte in its buffer and the number of those bytes that are in the last of these buffers. ]*/
+        result = constbuffer_array_create_from_buffer_offset_and_count(reader->array, reader->buffer_index, end_buffer_index - reader->buffer_index + 1, reader->buffer_offset, (uint32_t)left);
+        if (result == NULL)
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_READER_12_029: [ If there are any failures then constbuffer_array_reader_read_array shall fail, leave the reader unchanged and return NULL. ]*/
+            LogError("failure in constbuffer_array_create_from_buffer_offset_and_count(reader->array=%p, reader->buffer_index=%" PRIu32 ", end_buffer_index - reader->buffer_index + 1=%" PRIu32 ", reader->buffer_offset=%" PRIu32 ", left=%" PRIu64 ")",
+                reader->array, reader->buffer_index, end_buffer_index - reader->buffer_index + 1, reader->buffer_offset, left);
+        }
+        else
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_READER_12_028: [ constbuffer_array_reader_read_array shall move the reader past the size bytes, succeed and return the new CONSTBUFFER_ARRAY_HANDLE. ]*/
+            reader->remaining -= size;
+            reader->buffer_index = end_buffer_index;
+            reader->buffer_offset = end_buffer_offset + (uint32_t)left;
+            reader->buffer = end_buffer;
+            constbuffer_array_reader_settle(reader);
+        }
+    }
+    return result;
+}
@@ -1,19 +1,96 @@
 // Copyright (C) Microsoft Corporation. All rights reserved.
 
 #include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
 #include <inttypes.h>
 
+#include "macro_utils/macro_utils.h"
+
 #include "c_logging/logger.h"
 
 #include "c_pal/gballoc_hl.h"
 #include "c_pal/gballoc_hl_redirect.h"
 
+#include "c_util/constbuffer.h"
 #include "c_util/constbuffer_array.h"
+#include "c_util/crc32c.h"
 
 #include "c_util/constbuffer_array_splitter.h"
 
 #define MIN(a,b) (((a) < (b)) ? (a) : (b))
 
+/*random values (splitmix64 from 0) mixed in by the rolling gear hash of the content-defined chunking, one per byte value. Changing them moves all the cut points*/
+static const uint64_t gear_table[256] =
+{
+    UINT64_C(0xE220A8397B1DCDAF), UINT64_C(0x6E789E6AA1B965F4), UINT64_C(0x06C45D188009454F), UINT64_C(0xF88BB8A8724C81EC),
+    UINT64_C(0x1B39896A51A8749B), UINT64_C(0x53CB9F0C747EA2EA), UINT64_C(0x2C829ABE1F4532E1), UINT64_C(0xC584133AC916AB3C),
+    UINT64_C(0x3EE5789041C98AC3), UINT64_C(0xF3B8488C368CB0A6), UINT64_C(0x657EECDD3CB13D09), UINT64_C(0xC2D326E0055BDEF6),
+    UINT64_C(0x8621A03FE0BBDB7B), UINT64_C(0x8E1F7555983AA92F), UINT64_C(0xB54E0F1600CC4D19), UINT64_C(0x84BB3F97971D80AB),
+    UINT64_C(0x7D29825C75521255), UINT64_C(0xC3CF17102B7F7F86), UINT64_C(0x3466E9A083914F64), UINT64_C(0xD81A8D2B5A4485AC),
+    UINT64_C(0xDB01602B100B9ED7), UINT64_C(0xA9038A921825F10D), UINT64_C(0xEDF5F1D90DCA2F6A), UINT64_C(0x54496AD67BD2634C),
+    UINT64_C(0xDD7C01D4F5407269), UINT64_C(0x935E82F1DB4C4F7B), UINT64_C(0x69B82EBC92233300), UINT64_C(0x40D29EB57DE1D510),
+    UINT64_C(0xA2F09DABB45C6316), UINT64_C(0xEE521D7A0F4D3872), UINT64_C(0xF16952EE72F3454F), UINT64_C(0x377D35DEA8E40225),
+    UINT64_C(0x0C7DE8064963BAB0), UINT64_C(0x05582D37111AC529), UINT64_C(0xD254741F599DC6F7), UINT64_C(0x69630F7593D108C3),
+    UINT64_C(0x417EF96181DAA383), UINT64_C(0x3C3C41A3B43343A1), UINT64_C(0x6E19905DCBE531DF), UINT64_C(0x4FA9FA7324851729),
+    UINT64_C(0x84EB4454A792922A), UINT64_C(0x134F7096918175CE), UINT64_C(0x07DC930B302278A8), UINT64_C(0x12C015A97019E937),
+    UINT64_C(0xCC06C31652EBF438), UINT64_C(0xECEE65630A691E37), UINT64_C(0x3E84ECB1763E79AD), UINT64_C(0x690ED476743AAE49),
+    UINT64_C(0x774615D7B1A1F2E1), UINT64_C(0x22B353F04F4F52DA), UINT64_C(0xE3DDD86BA71A5EB1), UINT64_C(0xDF268ADEB6513356),
+    UINT64_C(0x2098EB73D4367D77), UINT64_C(0x03D6845323CE3C71), UINT64_C(0xC952C5620043C714), UINT64_C(0x9B196BCA844F1705),
+    UINT64_C(0x30260345DD9E0EC1), UINT64_C(0xCF448A5882BB9698), UINT64_C(0xF4A578DCCBC87656), UINT64_C(0xBFDEAED9A17B3C8F),
+    UINT64_C(0xED79402D1D5C5D7B), UINT64_C(0x55F070AB1CBBF170), UINT64_C(0x3E00A34929A88F1D), UINT64_C(0xE255B237B8BB18FB),
+    UINT64_C(0x2A7B67AF6C6AD50E), UINT64_C(0x466D5E7F3E46F143), UINT64_C(0x42375CB399A4FC72), UINT64_C(0x8C8A1F148A8BB259),
+    UINT64_C(0x32FCAB5DAED5BDFC), UINT64_C(0x9E60398C8D8553C0), UINT64_C(0xEE89CCEB8C4064C0), UINT64_C(0xDB0215941D86A66F),
+    UINT64_C(0x5CCDE78203C367A8), UINT64_C(0xF1BCBC6A1EC11786), UINT64_C(0xEF054FCEEE954551), UINT64_C(0xDF82012D0555C6DF),
+    UINT64_C(0x292566FF72403C08), UINT64_C(0xC4DD302A1BFA1137), UINT64_C(0xD85F219DB5C554E1), UINT64_C(0x6A27FF807441BCD2),
+    UINT64_C(0x96A573E9B48216E8), UINT64_C(0x46A9FDAC40BF0048), UINT64_C(0x3DD12464A0EE15B4), UINT64_C(0x451E521296A7EEA1),
+    UINT64_C(0x56E4398A98F8A0FD), UINT64_C(0x7B7DC2160E3335A7), UINT64_C(0xC679EE0BEBCB1CCA), UINT64_C(0x928D6F2D7453424E),
+    UINT64_C(0x1B38994205234C6D), UINT64_C(0x8086D193A6F2B568), UINT64_C(0x21C6E26639AC2C65), UINT64_C(0xD9DCCAC414D23C6F),
+    UINT64_C(0x91CD642057E00235), UINT64_C(0x77FC607DC6589373), UINT64_C(0x05B8ABE26DD3AEE7), UINT64_C(0x12F6436AC376CC66),
+    UINT64_C(0x64952424897B2307), UINT64_C(0xEE8C2BAF6343E5C3), UINT64_C(0xDC4C613D9EBA2304), UINT64_C(0x3505B7796BD1A506),
+    UINT64_C(0x8176DAF800A05F50), UINT64_C(0x8BD8FF7A0385CDBC), UINT64_C(0x1A764A3CD78101DA), UINT64_C(0xBE4D15BF6CA266AC),
+    UINT64_C(0xA85E1F38BB2DC749), UINT64_C(0x56759A968493CD8C), UINT64_C(0xF3A9BCE7336BD182), UINT64_C(0x365B15013741519B),
+    UINT64_C(0x1F7A44A6B109AC94), UINT64_C(0x3521D628813CB177), UINT64_C(0x6A77AFAB0F7C9370), UINT64_C(0x179642D8CDE95015),
+    UINT64_C(0x5EF102A8FB354461), UINT64_C(0xF51C504764ED82F2), UINT64_C(0xC58427F041CE6808), UINT64_C(0xFAD8FC45C9643C37),
+    UINT64_C(0xCF8682F9A70FA9C0), UINT64_C(0x7E1B3B75A4005729), UINT64_C(0x992DD867927B52D8), UINT64_C(0x7FBD5DB142F6791F),
+    UINT64_C(0x370595AACAB4ADAE), UINT64_C(0xB1392DBDC5AB61D6), UINT64_C(0x9FEA7DFC79D452D9), UINT64_C(0x40B12B120085641C),
+    UINT64_C(0xA192AFE3157C85D0), UINT64_C(0xC847729F4E08F3A3), UINT64_C(0x6F1384A306C41FC2), UINT64_C(0x12D05C4045A39C19),
+    UINT64_C(0x9899202FD20F0841), UINT64_C(0xE9C7191857E774B8), UINT64_C(0x4EEAD809AF5B0CC3), UINT64_C(0xE809ACAFA23864A4),
+    UINT64_C(0x4DA1EDABA1D0F7BD), UINT64_C(0x846EB9673349F8E4), UINT64_C(0x87BAE55B86039FE8), UINT64_C(0x7F367B8BD953EFF2),
+    UINT64_C(0x3884700F650D04E1), UINT64_C(0xBFE4B2AB46980CAD), UINT64_C(0xC5FC89075299106C), UINT64_C(0x37B2FA361ADEA7CD),
+    UINT64_C(0x7D75D813F04895B4), UINT64_C(0x702F5B393F62C0E0), UINT64_C(0x0A3FC775F4ECF37F), UINT64_C(0xE4B23787A352437F),
+    UINT64_C(0xF83FA245C34D6363), UINT64_C(0xB99BCF040786CF50), UINT64_C(0x38B6EA0A0E6C9D8A), UINT64_C(0x093FDC76776E37E1),
+    UINT64_C(0x1A75E6F76BA7EEE8), UINT64_C(0x442CDCFEE9660C62), UINT64_C(0x22D58D35116B5E0B), UINT64_C(0x87D4A5180F6A3645),
+    UINT64_C(0x589FB216BD82131B), UINT64_C(0x91D031CAD319AEC0), UINT64_C(0xABECF76A553D320B), UINT64_C(0xB8686CB347612DCF),
+    UINT64_C(0xFCAB66337C0A77F5), UINT64_C(0xAC318214381EC437), UINT64_C(0x6EB7F0FCA24494AE), UINT64_C(0xCF42861DCDC895A9),
+    UINT64_C(0x4ABAD7A1586D7A91), UINT64_C(0xC21B318DC2F49745), UINT64_C(0xD49474DC2ACBD1F0), UINT64_C(0xB1D4873747C1C8E1),
+    UINT64_C(0x5434DC8C7D015BF6), UINT64_C(0xE1C486287511B6A9), UINT64_C(0xA8616DF62E89A193), UINT64_C(0x31CE6319498D8347),
+    UINT64_C(0xAFD0B486123D6FAA), UINT64_C(0xE6495F5D102301EB), UINT64_C(0x0DC51CED17A43C52), UINT64_C(0x8BCBCDE81355EF2D),
+    UINT64_C(0x2412AF73FDEE7CFC), UINT64_C(0xC8D589E486E29EED), UINT64_C(0x23390E8664517F89), UINT64_C(0x251ADE58E8A6849D),
+    UINT64_C(0xF8555DBD2E8F9CB0), UINT64_C(0xCB417C3EEF54F7C3), UINT64_C(0x8028F8E1AAC3A919), UINT64_C(0x10E31052ACF748A0),
+    UINT64_C(0x2D886C073B1E1B78), UINT64_C(0x972974D90DF9FAEE), UINT64_C(0xBC1B7B38796893BA), UINT64_C(0x1958ED432070E652),
+    UINT64_C(0xCA5F297197A12DCC), UINT64_C(0xE025A27375704F28), UINT64_C(0x418010A570A924FB), UINT64_C(0x9828E2941BFC419C),
+    UINT64_C(0x4FBACD2F52B85C1F), UINT64_C(0x33DD5B756211CC67), UINT64_C(0x23C8DFDD1DB57FF0), UINT64_C(0x32F81801A1A8E901),
+    UINT64_C(0x26884EAC5ADA36DA), UINT64_C(0xCAA82F9BB42E37D4), UINT64_C(0x19FB1A7491D6A7D1), UINT64_C(0x5AA0243AA357F38E),
+    UINT64_C(0xB31D917809E447F0), UINT64_C(0x3F9C197225215BE0), UINT64_C(0xDC3C315A1E33C095), UINT64_C(0x3DD399AD533E80AC),
+    UINT64_C(0x566F32CCE8301D95), UINT64_C(0xC880188083D9BA21), UINT64_C(0xB9CC357F3B0E7D2E), UINT64_C(0x0237D2123A8A8D6C),
+    UINT64_C(0xBF636E9AA7CBF6BD), UINT64_C(0xD7BD4284C4E2A6A7), UINT64_C(0xDA2EBB47D50577A9), UINT64_C(0x90BA1C11B539087D),
+    UINT64_C(0x44993D31552B4F57), UINT64_C(0x32C2D6F80A8A8898), UINT64_C(0x450583ED7FB54B19), UINT64_C(0xEC2B0B09E50EF3EF),
+    UINT64_C(0xD918A0B6E2EFD65C), UINT64_C(0xE37A868D9785F572), UINT64_C(0x7D1A6118F2B0F37A), UINT64_C(0x9E2E3CC13B343439),
+    UINT64_C(0xEFD82C11212E37E8), UINT64_C(0xAF89C05CD4FC75ED), UINT64_C(0x55BC16BB9697108E), UINT64_C(0x6C4701FA5DB69BEE),
+    UINT64_C(0x9237338441DAF445), UINT64_C(0x248CF0831E81A5FC), UINT64_C(0xACC13557E77DE273), UINT64_C(0x520970C25E06513A),
+    UINT64_C(0x657329CB02987CAB), UINT64_C(0xA9B0B3366A4E55A8), UINT64_C(0xC4D06CA2F39ACDD4), UINT64_C(0x5DCE37D68170CDE1),
+    UINT64_C(0x5F1E44E77E1854C9), UINT64_C(0x6883D452D55DF899), UINT64_C(0x05C5BD62F1067032), UINT64_C(0xE680B683CE60FAB0),
+    UINT64_C(0x5DC9DA3F286D18B1), UINT64_C(0x94B4BF3AB85ED6D8), UINT64_C(0xCE65F449E3ACC5A3), UINT64_C(0x34B0209642CEA639),
+    UINT64_C(0xC14C3C771D904827), UINT64_C(0x6ADDCEE2BD9CDEE5), UINT64_C(0xE24EED137FFBB613), UINT64_C(0x75DD58EF79963D1B),
+    UINT64_C(0xFDB83ECF6CC24920), UINT64_C(0x7A1D0057C57169FB), UINT64_C(0x339200F4FEB62D07), UINT64_C(0xD33F4D4AC88469F4),
+    UINT64_C(0x8226F234E68DFEE4), UINT64_C(0x320DEF4F2A105536), UINT64_C(0x7786F3B13AEFC159), UINT64_C(0xB28225AC9DF63EE2),
+    UINT64_C(0x781B9D0376CC6044), UINT64_C(0x05BD0115226C6AB6), UINT64_C(0xD302230207BDFDAB), UINT64_C(0xDB898ABD8E0D2933),
+    UINT64_C(0x9E79A397BA00B9CC), UINT64_C(0x89DF84A5F0003EE8), UINT64_C(0x011F04F2A75FB9BE), UINT64_C(0x5A5832BB47BCF19E)
+};
+
+MU_DEFINE_ENUM_STRINGS(CONSTBUFFER_ARRAY_SPLITTER_NEXT_RESULT, CONSTBUFFER_ARRAY_SPLITTER_NEXT_RESULT_VALUES);
+
 CONSTBUFFER_ARRAY_HANDLE constbuffer_array_splitter_split(CONSTBUFFER_ARRAY_HANDLE buffers, uint32_t max_buffer_size)
 {
     CONSTBUFFER_ARRAY_HANDLE result;
@@ -48,15 +125,19 @@ CONSTBUFFER_ARRAY_HANDLE constbuffer_array_splitter_split(CONSTBUFFER_ARRAY_HAND
         }
         else
         {
-            /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_42_004: [ constbuffer_array_splitter_split shall call constbuffer_array_get_all_buffers_size for buffers and store the result as remaining_buffer_size. ]*/
-            uint32_t remaining_buffer_size;
-            // NOTE: the total block size is limited to UINT32_MAX
-            // If we need to evict blocks with more than 4GB of data (including all headers) then this needs to be updated to get a 64-bit size
-            int temp_result = constbuffer_array_get_all_buffers_size(buffers, &remaining_buffer_size);
+            /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_42_004: [ constbuffer_array_splitter_split shall call constbuffer_array_get_all_buffers_size_64 for buffers and store the result as remaining_buffer_size. ]*/
+            uint64_t remaining_buffer_size;
+            int temp_result = constbuffer_array_get_all_buffers_size_64(buffers, &remaining_buffer_size);
             if (temp_result != 0)
             {
                 /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_42_017: [ If there are any other failures then constbuffer_array_splitter_split shall fail and return NULL. ]*/
-                LogError("constbuffer_array_get_all_buffers_size failed");
+                LogError("constbuffer_array_get_all_buffers_size_64 failed");
+                result = NULL;
+            }
+            else if ((remaining_buffer_size + max_buffer_size - 1) / max_buffer_size > UINT32_MAX)
+            {
+                /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_42_017: [ If there are any other failures then constbuffer_array_splitter_split shall fail and return NULL. ]*/
+                LogError("remaining_buffer_size=%" PRIu64 " cannot be split in at most UINT32_MAX buffers of max_buffer_size=%" PRIu32, remaining_buffer_size, max_buffer_size);
                 result = NULL;
             }
             else
@@ -75,7 +156,7 @@ CONSTBUFFER_ARRAY_HANDLE constbuffer_array_splitter_split(CONSTBUFFER_ARRAY_HAND
                 else
                 {
                     /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_42_005: [ constbuffer_array_splitter_split shall allocate an array of CONSTBUFFER_HANDLE of size remaining_buffer_size / max_buffer_size (rounded up). ]*/
-                    uint32_t split_buffer_count = (remaining_buffer_size + max_buffer_size - 1) / max_buffer_size;
+                    uint32_t split_buffer_count = (uint32_t)((remaining_buffer_size + max_buffer_size - 1) / max_buffer_size);
 
                     CONSTBUFFER_HANDLE* split_buffers = malloc_2(split_buffer_count, sizeof(CONSTBUFFER_HANDLE));
                     if (split_buffers == NULL)
@@ -106,7 +187,7 @@ CONSTBUFFER_ARRAY_HANDLE constbuffer_array_splitter_split(CONSTBUFFER_ARRAY_HAND
                             bool failed = false;
 
                             /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_42_009: [ constbuffer_array_splitter_split shall allocate memory of size min(max_buffer_size, remaining_buffer_size). ]*/
-                            uint32_t next_split_buffer_size = MIN(max_buffer_size, remaining_buffer_size);
+                            uint32_t next_split_buffer_size = (uint32_t)MIN(max_buffer_size, remaining_buffer_size);
 
                             unsigned char* split_buffer_memory = malloc(next_split_buffer_size);
                             if (split_buffer_memory == NULL)
@@ -232,14 +313,19 @@ TARRAY(CONSTBUFFER_ARRAY_HANDLE) constbuffer_array_splitter_split_to_array_of_ar
         /* Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_005: [ constbuffer_array_splitter_split_to_array_of_array shall call constbuffer_array_get_buffer_count to get the total number of buffers. ]*/
         (void)constbuffer_array_get_buffer_count(buffers, &buffer_count);
 
-        uint32_t remaining_buffer_size;
+        uint64_t remaining_buffer_size;
 
-        /* Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_008: [ constbuffer_array_splitter_split_to_array_of_array shall call constbuffer_array_get_all_buffers_size for buffers to obtain the total size of all buffers in buffers. ]*/
-        int temp_result = constbuffer_array_get_all_buffers_size(buffers, &remaining_buffer_size);
+        /* Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_008: [ constbuffer_array_splitter_split_to_array_of_array shall call constbuffer_array_get_all_buffers_size_64 for buffers to obtain the total size of all buffers in buffers. ]*/
+        int temp_result = constbuffer_array_get_all_buffers_size_64(buffers, &remaining_buffer_size);
         if (temp_result != 0)
         {
             /* Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_004: [ If there are any other failures then constbuffer_array_splitter_split_to_array_of_array shall fail and return NULL. ]*/
-            LogError("constbuffer_array_get_all_buffers_size failed");
+            LogError("constbuffer_array_get_all_buffers_size_64 failed");
+        }
+        else if ((remaining_buffer_size + max_buffer_size - 1) / max_buffer_size > UINT32_MAX)
+        {
+            /* Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_004: [ If there are any other failures then constbuffer_array_splitter_split_to_array_of_array shall fail and return NULL. ]*/
+            LogError("remaining_buffer_size=%" PRIu64 " cannot be split in at most UINT32_MAX arrays of max_buffer_size=%" PRIu32, remaining_buffer_size, max_buffer_size);
         }
         else
         {
@@ -293,7 +379,7 @@ TARRAY(CONSTBUFFER_ARRAY_HANDLE) constbuffer_array_splitter_split_to_array_of_ar
             else
             {
                 /* Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_023: [ constbuffer_array_splitter_split_to_array_of_array shall allocate a TARRAY of CONSTBUFFER_HANDLE of size remaining_buffer_size / max_buffer_size (rounded up). ]*/
-                uint32_t split_array_count = (remaining_buffer_size + max_buffer_size - 1) / max_buffer_size;
+                uint32_t split_array_count = (uint32_t)((remaining_buffer_size + max_buffer_size - 1) / max_buffer_size);
                 TARRAY(CONSTBUFFER_ARRAY_HANDLE) temp = TARRAY_CREATE_WITH_CAPACITY(CONSTBUFFER_ARRAY_HANDLE)(split_array_count);
 
                 if (temp == NULL)
@@ -320,8 +406,10 @@ TARRAY(CONSTBUFFER_ARRAY_HANDLE) constbuffer_array_splitter_split_to_array_of_ar
                         CONSTBUFFER_HANDLE curr_buffer = constbuffer_array_get_buffer(buffers, i);
                         /* Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_012: [ constbuffer_array_splitter_split_to_array_of_array shall get the buffer content by calling CONSTBUFFER_GetContent. ]*/
                         const CONSTBUFFER* buffer = CONSTBUFFER_GetContent(curr_buffer);
+                        /*in 64 bits, the total of all the buffers can be more than UINT32_MAX*/
+                        uint64_t size_with_buffer = (uint64_t)current_buffer_size + buffer->size;
 
-                        if(current_buffer_size + buffer->size < max_buffer_size)
+                        if(size_with_buffer < max_buffer_size)
                         {
                             /* Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_016: [ If current buffer size added the current sub-tarray size is smaller than max_buffer_size, constbuffer_array_splitter_split_to_array_of_array shall include the current buffer to the current sub-tarray. ]*/
                             current_buffer_count++;
@@ -347,14 +435,14 @@ TARRAY(CONSTBUFFER_ARRAY_HANDLE) constbuffer_array_splitter_split_to_array_of_ar
                                 }
                             }
                         }
-                        else if(current_buffer_size + buffer->size >= max_buffer_size)
+                        else if(size_with_buffer >= max_buffer_size)
                         {
                             /* Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_018: [ If current buffer size added the current sub-tarray size is greater than max_buffer_size, then constbuffer_array_splitter_split_to_array_of_array shall get part of the current buffer as end buffer and added a new array into the result until the remaining size for the current buffer is smaller than max_buffer_size. ]*/
 
                             current_buffer_count++;
                             end_buffer_size = max_buffer_size - current_buffer_size;
                             bool has_empty = false;
-                            if (current_buffer_size + buffer->size == max_buffer_size)
+                            if (size_with_buffer == max_buffer_size)
                             {
                                 /* Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_025: [ If current buffer size added the current sub-tarray size is equal to max_buffers_size, then constbuffer_array_splitter_split_to_array_of_array shall include any consecutive empty buffers right after the current buffer to the new array which will be added to the result. ]*/
                                 while (++i < buffer_count)
@@ -478,3 +566,520 @@ TARRAY(CONSTBUFFER_ARRAY_HANDLE) constbuffer_array_splitter_split_to_array_of_ar
     }
     return result;
 }
+
+int constbuffer_array_splitter_iterator_init(CONSTBUFFER_ARRAY_SPLITTER_ITERATOR* iterator, CONSTBUFFER_ARRAY_HANDLE buffers, uint32_t max_buffer_size)
+{
+    int result;
+    if (
+        /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_001: [ If iterator is NULL then constbuffer_array_splitter_iterator_init shall fail and return a non-zero value. ]*/
+        iterator == NULL ||
+        /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_002: [ If buffers is NULL then constbuffer_array_splitter_iterator_init shall fail and return a non-zero value. ]*/
+        buffers == NULL ||
+        /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_003: [ If max_buffer_size is 0 then constbuffer_array_splitter_iterator_init shall fail and return a non-zero value. ]*/
+        max_buffer_size == 0
+        )
+    {
+        LogError("Invalid args : CONSTBUFFER_ARRAY_SPLITTER_ITERATOR* iterator=%p, CONSTBUFFER_ARRAY_HANDLE buffers=%p, uint32_t max_buffer_size=%" PRIu32,
+            iterator, buffers, max_buffer_size);
+        result = MU_FAILURE;
+    }
+    /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_004: [ constbuffer_array_splitter_iterator_init shall call constbuffer_array_get_all_buffers_size_64 for buffers to obtain the number of bytes to split. ]*/
+    else if (constbuffer_array_get_all_buffers_size_64(buffers, &iterator->remaining_size) != 0)
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_005: [ If there are any failures then constbuffer_array_splitter_iterator_init shall fail and return a non-zero value. ]*/
+        LogError("constbuffer_array_get_all_buffers_size_64 failed");
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_006: [ constbuffer_array_splitter_iterator_init shall position iterator at the first byte of buffers, succeed and return 0. ]*/
+        iterator->buffers = buffers;
+        iterator->max_buffer_size = max_buffer_size;
+        iterator->buffer_index = 0;
+        iterator->buffer_offset = 0;
+        iterator->buffer = (iterator->remaining_size == 0) ? NULL : constbuffer_array_get_buffer_content(buffers, 0);
+        result = 0;
+    }
+    return result;
+}
+
+CONSTBUFFER_ARRAY_SPLITTER_NEXT_RESULT constbuffer_array_splitter_iterator_next(CONSTBUFFER_ARRAY_SPLITTER_ITERATOR* iterator, CONSTBUFFER_ARRAY_SPLITTER_CHUNK* chunk)
+{
+    CONSTBUFFER_ARRAY_SPLITTER_NEXT_RESULT result;
+    if (
+        /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_007: [ If iterator is NULL or chunk is NULL then constbuffer_array_splitter_iterator_next shall fail and return CONSTBUFFER_ARRAY_SPLITTER_NEXT_INVALID_ARG. ]*/
+        iterator == NULL ||
+        chunk == NULL
+        )
+    {
+        LogError("Invalid args : CONSTBUFFER_ARRAY_SPLITTER_ITERATOR* iterator=%p, CONSTBUFFER_ARRAY_SPLITTER_CHUNK* chunk=%p", iterator, chunk);
+        result = CONSTBUFFER_ARRAY_SPLITTER_NEXT_INVALID_ARG;
+    }
+    else if (iterator->remaining_size == 0)
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_008: [ If all the bytes of the array were already returned then constbuffer_array_splitter_iterator_next shall return CONSTBUFFER_ARRAY_SPLITTER_NEXT_END. ]*/
+        result = CONSTBUFFER_ARRAY_SPLITTER_NEXT_END;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_009: [ constbuffer_array_splitter_iterator_next shall move past the buffers that have no bytes left (getting the next buffer with constbuffer_array_get_buffer_content) so that the chunk starts at the next byte. ]*/
+        while (iterator->buffer_offset == iterator->buffer->size)
+        {
+            iterator->buffer_index++;
+            iterator->buffer_offset = 0;
+            iterator->buffer = constbuffer_array_get_buffer_content(iterator->buffers, iterator->buffer_index);
+        }
+
+        /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_010: [ constbuffer_array_splitter_iterator_next shall fill chunk with the next min(max_buffer_size, remaining size) bytes: the index of the buffer holding the first byte, the offset of that byte in it, the number of buffers spanned and the number of bytes in the last of them. ]*/
+        uint32_t chunk_size = (uint32_t)MIN(iterator->max_buffer_size, iterator->remaining_size);
+        uint32_t left = chunk_size;
+        chunk->start_buffer_index = iterator->buffer_index;
+        chunk->start_buffer_offset = iterator->buffer_offset;
+        while (left > iterator->buffer->size - iterator->buffer_offset)
+        {
+            left -= iterator->buffer->size - iterator->buffer_offset;
+            iterator->buffer_index++;
+            iterator->buffer_offset = 0;
+            iterator->buffer = constbuffer_array_get_buffer_content(iterator->buffers, iterator->buffer_index);
+        }
+        chunk->buffer_count = iterator->buffer_index - chunk->start_buffer_index + 1;
+        chunk->end_buffer_size = left;
+        chunk->size = chunk_size;
+
+        /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_011: [ constbuffer_array_splitter_iterator_next shall move iterator past the bytes of chunk and return CONSTBUFFER_ARRAY_SPLITTER_NEXT_OK. ]*/
+        iterator->buffer_offset += left;
+        iterator->remaining_size -= chunk_size;
+        result = CONSTBUFFER_ARRAY_SPLITTER_NEXT_OK;
+    }
+    return result;
+}
+
+int constbuffer_array_splitter_chunk_get_span(CONSTBUFFER_ARRAY_HANDLE buffers, const CONSTBUFFER_ARRAY_SPLITTER_CHUNK* chunk, uint32_t span_index, CONSTBUFFER_ARRAY_SPLITTER_SPAN* span)
+{
+    int result;
+    if (
+        /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_012: [ If buffers is NULL or chunk is NULL or span is NULL then constbuffer_array_splitter_chunk_get_span shall fail and return a non-zero value. ]*/
+        buffers == NULL ||
+        chunk == NULL ||
+        span == NULL ||
+        /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_013: [ If span_index is not less than the number of buffers spanned by chunk then constbuffer_array_splitter_chunk_get_span shall fail and return a non-zero value. ]*/
+        span_index >= chunk->buffer_count
+        )
+    {
+        LogError("Invalid args : CONSTBUFFER_ARRAY_HANDLE buffers=%p, const CONSTBUFFER_ARRAY_SPLITTER_CHUNK* chunk=%p, uint32_t span_index=%" PRIu32 ", CONSTBUFFER_ARRAY_SPLITTER_SPAN* span=%p",
+            buffers, chunk, span_index, span);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_014: [ constbuffer_array_splitter_chunk_get_span shall get the content of the span_index-th buffer spanned by chunk by calling constbuffer_array_get_buffer_content. ]*/
+        const CONSTBUFFER* buffer = constbuffer_array_get_buffer_content(buffers, chunk->start_buffer_index + span_index);
+        if (buffer == NULL)
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_015: [ If there are any failures then constbuffer_array_splitter_chunk_get_span shall fail and return a non-zero value. ]*/
+            LogError("constbuffer_array_get_buffer_content(buffers=%p, buffer_index=%" PRIu32 ") failed", buffers, chunk->start_buffer_index + span_index);
+            result = MU_FAILURE;
+        }
+        else
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_016: [ constbuffer_array_splitter_chunk_get_span shall write in span the content of the buffer, the offset of the chunk in it (start_buffer_offset for the first span, 0 for the others) and the number of bytes of the chunk in it (end_buffer_size for the last span, the rest of the buffer for the others), succeed and return 0. ]*/
+            span->buffer = buffer;
+            span->offset = (span_index == 0) ? chunk->start_buffer_offset : 0;
+            span->size = (span_index == chunk->buffer_count - 1) ? chunk->end_buffer_size : buffer->size - span->offset;
+            result = 0;
+        }
+    }
+    return result;
+}
+
+CONSTBUFFER_ARRAY_SPLITTER_CHUNK* constbuffer_array_splitter_split_to_chunks(CONSTBUFFER_ARRAY_HANDLE buffers, uint32_t max_buffer_size, uint32_t* chunk_count)
+{
+    CONSTBUFFER_ARRAY_SPLITTER_CHUNK* result;
+    CONSTBUFFER_ARRAY_SPLITTER_ITERATOR iterator;
+
+    if (
+        /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_017: [ If buffers is NULL then constbuffer_array_splitter_split_to_chunks shall fail and return NULL. ]*/
+        buffers == NULL ||
+        /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_018: [ If max_buffer_size is 0 then constbuffer_array_splitter_split_to_chunks shall fail and return NULL. ]*/
+        max_buffer_size == 0 ||
+        /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_019: [ If chunk_count is NULL then constbuffer_array_splitter_split_to_chunks shall fail and return NULL. ]*/
+        chunk_count == NULL
+        )
+    {
+        LogError("Invalid args : CONSTBUFFER_ARRAY_HANDLE buffers=%p, uint32_t max_buffer_size=%" PRIu32 ", uint32_t* chunk_count=%p",
+            buffers, max_buffer_size, chunk_count);
+        result = NULL;
+    }
+    /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_020: [ constbuffer_array_splitter_split_to_chunks shall initialize a CONSTBUFFER_ARRAY_SPLITTER_ITERATOR over buffers. ]*/
+    else if (constbuffer_array_splitter_iterator_init(&iterator, buffers, max_buffer_size) != 0)
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_023: [ If there are any failures then constbuffer_array_splitter_split_to_chunks shall fail and return NULL. ]*/
+        LogError("constbuffer_array_splitter_iterator_init(&iterator=%p, buffers=%p, max_buffer_size=%" PRIu32 ") failed", &iterator, buffers, max_buffer_size);
+        result = NULL;
+    }
+    else if ((iterator.remaining_size + max_buffer_size - 1) / max_buffer_size > UINT32_MAX)
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_023: [ If there are any failures then constbuffer_array_splitter_split_to_chunks shall fail and return NULL. ]*/
+        LogError("remaining_size=%" PRIu64 " cannot be split in at most UINT32_MAX chunks of max_buffer_size=%" PRIu32, iterator.remaining_size, max_buffer_size);
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_021: [ constbuffer_array_splitter_split_to_chunks shall allocate in one call the memory for all the chunks (total size / max_buffer_size rounded up, at least 1). ]*/
+        uint32_t count = (uint32_t)((iterator.remaining_size + max_buffer_size - 1) / max_buffer_size);
+        result = malloc_2((count == 0) ? 1 : count, sizeof(CONSTBUFFER_ARRAY_SPLITTER_CHUNK));
+        if (result == NULL)
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_023: [ If there are any failures then constbuffer_array_splitter_split_to_chunks shall fail and return NULL. ]*/
+            LogError("failure in malloc_2(count=%" PRIu32 ", sizeof(CONSTBUFFER_ARRAY_SPLITTER_CHUNK)=%zu)", count, sizeof(CONSTBUFFER_ARRAY_SPLITTER_CHUNK));
+            /*return as is*/
+        }
+        else
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_022: [ constbuffer_array_splitter_split_to_chunks shall fill the chunks by calling constbuffer_array_splitter_iterator_next once per chunk, write their number in chunk_count, succeed and return them. ]*/
+            for (uint32_t i = 0; i < count; i++)
+            {
+                (void)constbuffer_array_splitter_iterator_next(&iterator, &result[i]);
+            }
+            *chunk_count = count;
+        }
+    }
+    return result;
+}
+
+/*a mask of bit_count bits for the rolling gear hash. The high bits are used because they depend on the last 64 bytes, the low ones only on the last few*/
+static uint64_t cdc_mask(uint32_t bit_count)
+{
+    return (bit_count == 0) ? 0 : (((UINT64_C(1) << bit_count) - 1) << (64 - bit_count));
+}
+
+/*rolls the gear hash over bytes[begin..end) and stops after the first byte where the hash matches mask (setting *found)*/
+static uint32_t cdc_scan(const unsigned char* bytes, uint32_t begin, uint32_t end, uint64_t mask, uint64_t* hash, bool* found)
+{
+    uint64_t h = *hash;
+    uint32_t i;
+    for (i = begin; i < end; i++)
+    {
+        h = (h << 1) + gear_table[bytes[i]];
+        if ((h & mask) == 0)
+        {
+            *found = true;
+            i++;
+            break;
+        }
+    }
+    *hash = h;
+    return i;
+}
+
+int constbuffer_array_splitter_cdc_iterator_init(CONSTBUFFER_ARRAY_SPLITTER_CDC_ITERATOR* iterator, CONSTBUFFER_ARRAY_HANDLE buffers, uint32_t min_chunk_size, uint32_t avg_chunk_size, uint32_t max_chunk_size)
+{
+    int result;
+    if (
+        /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_024: [ If iterator is NULL then constbuffer_array_splitter_cdc_iterator_init shall fail and return a non-zero value. ]*/
+        iterator == NULL ||
+        /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_025: [ If buffers is NULL then constbuffer_array_splitter_cdc_iterator_init shall fail and return a non-zero value. ]*/
+        buffers == NULL ||
+        /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_026: [ If min_chunk_size is 0 then constbuffer_array_splitter_cdc_iterator_init shall fail and return a non-zero value. ]*/
+        min_chunk_size == 0 ||
+        /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_027: [ If min_chunk_size is greater than avg_chunk_size or avg_chunk_size is greater than max_chunk_size then constbuffer_array_splitter_cdc_iterator_init shall fail and return a non-zero value. ]*/
+        min_chunk_size > avg_chunk_size ||
+        avg_chunk_size > max_chunk_size
+        )
+    {
+        LogError("Invalid args : CONSTBUFFER_ARRAY_SPLITTER_CDC_ITERATOR* iterator=%p, CONSTBUFFER_ARRAY_HANDLE buffers=%p, uint32_t min_chunk_size=%" PRIu32 ", uint32_t avg_chunk_size=%" PRIu32 ", uint32_t max_chunk_size=%" PRIu32,
+            iterator, buffers, min_chunk_size, avg_chunk_size, max_chunk_size);
+        result = MU_FAILURE;
+    }
+    /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_028: [ constbuffer_array_splitter_cdc_iterator_init shall call constbuffer_array_get_all_buffers_size_64 for buffers to obtain the number of bytes to split. ]*/
+    else if (constbuffer_array_get_all_buffers_size_64(buffers, &iterator->remaining_size) != 0)
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_029: [ If there are any failures then constbuffer_array_splitter_cdc_iterator_init shall fail and return a non-zero value. ]*/
+        LogError("constbuffer_array_get_all_buffers_size_64 failed");
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_030: [ constbuffer_array_splitter_cdc_iterator_init shall compute the cut point masks (log2(avg_chunk_size) + 1 bits before avg_chunk_size bytes, log2(avg_chunk_size) - 1 bits after), position iterator at the first byte of buffers, succeed and return 0. ]*/
+        uint32_t avg_bits = 0;
+        while ((avg_chunk_size >> (avg_bits + 1)) != 0)
+        {
+            avg_bits++;
+        }
+
+        iterator->buffers = buffers;
+        iterator->min_chunk_size = min_chunk_size;
+        iterator->avg_chunk_size = avg_chunk_size;
+        iterator->max_chunk_size = max_chunk_size;
+        iterator->mask_small = cdc_mask(avg_bits + 1);
+        iterator->mask_large = cdc_mask((avg_bits == 0) ? 0 : avg_bits - 1);
+        iterator->buffer_index = 0;
+        iterator->buffer_offset = 0;
+        iterator->buffer = (iterator->remaining_size == 0) ? NULL : constbuffer_array_get_buffer_content(buffers, 0);
+        result = 0;
+    }
+    return result;
+}
+
+CONSTBUFFER_ARRAY_SPLITTER_NEXT_RESULT constbuffer_array_splitter_cdc_iterator_next(CONSTBUFFER_ARRAY_SPLITTER_CDC_ITERATOR* iterator, CONSTBUFFER_ARRAY_SPLITTER_CHUNK* chunk, uint32_t* fingerprint)
+{
+    CONSTBUFFER_ARRAY_SPLITTER_NEXT_RESULT result;
+    if (
+        /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_031: [ If iterator is NULL or chunk is NULL or fingerprint is NULL then constbuffer_array_splitter_cdc_iterator_next shall fail and return CONSTBUFFER_ARRAY_SPLITTER_NEXT_INVALID_ARG. ]*/
+        iterator == NULL ||
+        chunk == NULL ||
+        fingerprint == NULL
+        )
+    {
+        LogError("Invalid args : CONSTBUFFER_ARRAY_SPLITTER_CDC_ITERATOR* iterator=%p, CONSTBUFFER_ARRAY_SPLITTER_CHUNK* chunk=%p, uint32_t* fingerprint=%p", iterator, chunk, fingerprint);
+        result = CONSTBUFFER_ARRAY_SPLITTER_NEXT_INVALID_ARG;
+    }
+    else if (iterator->remaining_size == 0)
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_032: [ If all the bytes of the array were already returned then constbuffer_array_splitter_cdc_iterator_next shall return CONSTBUFFER_ARRAY_SPLITTER_NEXT_END. ]*/
+        result = CONSTBUFFER_ARRAY_SPLITTER_NEXT_END;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_033: [ constbuffer_array_splitter_cdc_iterator_next shall move past the buffers that have no bytes left (getting the next buffer with constbuffer_array_get_buffer_content) so that the chunk starts at the next byte. ]*/
+        while (iterator->buffer_offset == iterator->buffer->size)
+        {
+            iterator->buffer_index++;
+            iterator->buffer_offset = 0;
+            iterator->buffer = constbuffer_array_get_buffer_content(iterator->buffers, iterator->buffer_index);
+        }
+
+        /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_034: [ If there are no more than min_chunk_size bytes left then the chunk shall be all of them. ]*/
+        /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_035: [ Otherwise, constbuffer_array_splitter_cdc_iterator_next shall skip the first min_chunk_size bytes and then roll a gear hash (hash = (hash << 1) + gear_table[byte]) over the following bytes, ending the chunk after the first byte where hash & mask_small is 0 (before avg_chunk_size bytes) or hash & mask_large is 0 (after avg_chunk_size bytes), or after max_chunk_size bytes. ]*/
+        uint32_t limit = (uint32_t)MIN(iterator->max_chunk_size, iterator->remaining_size);
+        uint32_t skip = (limit <= iterator->min_chunk_size) ? limit : iterator->min_chunk_size;
+        uint32_t normal = MIN(iterator->avg_chunk_size, limit);
+        uint32_t chunk_size = 0;
+        uint32_t crc = 0;
+        uint64_t hash = 0;
+        bool found = false;
+
+        chunk->start_buffer_index = iterator->buffer_index;
+        chunk->start_buffer_offset = iterator->buffer_offset;
+
+        for (;;)
+        {
+            const unsigned char* bytes = iterator->buffer->buffer + iterator->buffer_offset;
+            uint32_t available = MIN(iterator->buffer->size - iterator->buffer_offset, limit - chunk_size);
+            uint32_t used = (chunk_size < skip) ? MIN(available, skip - chunk_size) : 0;
+
+            if (chunk_size + used < normal)
+            {
+                used = cdc_scan(bytes, used, MIN(available, normal - chunk_size), iterator->mask_small, &hash, &found);
+            }
+            if (!found)
+            {
+                used = cdc_scan(bytes, used, available, iterator->mask_large, &hash, &found);
+            }
+
+            /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_036: [ constbuffer_array_splitter_cdc_iterator_next shall compute the fingerprint of the chunk by calling crc32c_compute for the bytes of the chunk in each buffer it spans. ]*/
+            crc = crc32c_compute(crc, bytes, used);
+            chunk_size += used;
+            iterator->buffer_offset += used;
+
+            if (found || chunk_size == limit)
+            {
+                break;
+            }
+
+            do
+            {
+                iterator->buffer_index++;
+                iterator->buffer_offset = 0;
+                iterator->buffer = constbuffer_array_get_buffer_content(iterator->buffers, iterator->buffer_index);
+            } while (iterator->buffer->size == 0);
+        }
+
+        /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_037: [ constbuffer_array_splitter_cdc_iterator_next shall fill chunk with the index of the buffer holding the first byte, the offset of that byte in it, the number of buffers spanned and the number of bytes in the last of them, write the fingerprint, move iterator past the bytes of chunk and return CONSTBUFFER_ARRAY_SPLITTER_NEXT_OK. ]*/
+        chunk->buffer_count = iterator->buffer_index - chunk->start_buffer_index + 1;
+        chunk->end_buffer_size = (chunk->buffer_count == 1) ? chunk_size : iterator->buffer_offset;
+        chunk->size = chunk_size;
+        *fingerprint = crc;
+        iterator->remaining_size -= chunk_size;
+        result = CONSTBUFFER_ARRAY_SPLITTER_NEXT_OK;
+    }
+    return result;
+}
+
+static CONSTBUFFER_HANDLE create_buffer_from_chunk(CONSTBUFFER_ARRAY_HANDLE buffers, const CONSTBUFFER_ARRAY_SPLITTER_CHUNK* chunk)
+{
+    CONSTBUFFER_HANDLE result;
+
+    if (chunk->buffer_count == 1)
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_043: [ For a chunk that lies in one buffer, constbuffer_array_splitter_split_content_defined shall get the buffer with constbuffer_array_get_buffer, call CONSTBUFFER_CreateFromOffsetAndSize for the bytes of the chunk (no copy) and call CONSTBUFFER_DecRef on the buffer. ]*/
+        CONSTBUFFER_HANDLE buffer = constbuffer_array_get_buffer(buffers, chunk->start_buffer_index);
+        result = CONSTBUFFER_CreateFromOffsetAndSize(buffer, chunk->start_buffer_offset, chunk->size);
+        if (result == NULL)
+        {
+            LogError("failure in CONSTBUFFER_CreateFromOffsetAndSize(buffer=%p, offset=%" PRIu32 ", size=%" PRIu32 ")", buffer, chunk->start_buffer_offset, chunk->size);
+        }
+        CONSTBUFFER_DecRef(buffer);
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_044: [ For a chunk that spans several buffers, constbuffer_array_splitter_split_content_defined shall call CONSTBUFFER_CreateWritableHandle with the size of the chunk, copy the bytes of the chunk in it (obtained with constbuffer_array_splitter_chunk_get_span) and call CONSTBUFFER_SealWritableHandle. ]*/
+        CONSTBUFFER_WRITABLE_HANDLE writable = CONSTBUFFER_CreateWritableHandle(chunk->size);
+        if (writable == NULL)
+        {
+            LogError("failure in CONSTBUFFER_CreateWritableHandle(size=%" PRIu32 ")", chunk->size);
+            result = NULL;
+        }
+        else
+        {
+            unsigned char* destination = CONSTBUFFER_GetWritableBuffer(writable);
+            for (uint32_t i = 0; i < chunk->buffer_count; i++)
+            {
+                CONSTBUFFER_ARRAY_SPLITTER_SPAN span;
+                (void)constbuffer_array_splitter_chunk_get_span(buffers, chunk, i, &span);
+                if (span.size != 0)
+                {
+                    (void)memcpy(destination, span.buffer->buffer + span.offset, span.size);
+                    destination += span.size;
+                }
+            }
+            result = CONSTBUFFER_SealWritableHandle(writable);
+        }
+    }
+
+    return result;
+}
+
+CONSTBUFFER_ARRAY_HANDLE constbuffer_array_splitter_split_content_defined(CONSTBUFFER_ARRAY_HANDLE buffers, uint32_t min_chunk_size, uint32_t avg_chunk_size, uint32_t max_chunk_size, uint32_t** fingerprints)
+{
+    CONSTBUFFER_ARRAY_HANDLE result;
+    CONSTBUFFER_ARRAY_SPLITTER_CDC_ITERATOR iterator;
+
+    if (
+        /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_038: [ If buffers is NULL then constbuffer_array_splitter_split_content_defined shall fail and return NULL. ]*/
+        buffers == NULL ||
+        /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_039: [ If fingerprints is NULL then constbuffer_array_splitter_split_content_defined shall fail and return NULL. ]*/
+        fingerprints == NULL
+        )
+    {
+        LogError("Invalid args : CONSTBUFFER_ARRAY_HANDLE buffers=%p, uint32_t min_chunk_size=%" PRIu32 ", uint32_t avg_chunk_size=%" PRIu32 ", uint32_t max_chunk_size=%" PRIu32 ", uint32_t** fingerprints=%p",
+            buffers, min_chunk_size, avg_chunk_size, max_chunk_size, fingerprints);
+        result = NULL;
+    }
+    /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_040: [ constbuffer_array_splitter_split_content_defined shall initialize a CONSTBUFFER_ARRAY_SPLITTER_CDC_ITERATOR over buffers. ]*/
+    else if (constbuffer_array_splitter_cdc_iterator_init(&iterator, buffers, min_chunk_size, avg_chunk_size, max_chunk_size) != 0)
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_047: [ If there are any failures then constbuffer_array_splitter_split_content_defined shall fail and return NULL. ]*/
+        LogError("constbuffer_array_splitter_cdc_iterator_init(&iterator=%p, buffers=%p, min_chunk_size=%" PRIu32 ", avg_chunk_size=%" PRIu32 ", max_chunk_size=%" PRIu32 ") failed",
+            &iterator, buffers, min_chunk_size, avg_chunk_size, max_chunk_size);
+        result = NULL;
+    }
+    else if (iterator.remaining_size == 0)
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_041: [ If there are no bytes in buffers then constbuffer_array_splitter_split_content_defined shall write NULL in fingerprints, call constbuffer_array_create_empty and return the result. ]*/
+        result = constbuffer_array_create_empty();
+        if (result == NULL)
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_047: [ If there are any failures then constbuffer_array_splitter_split_content_defined shall fail and return NULL. ]*/
+            LogError("constbuffer_array_create_empty failed");
+        }
+        else
+        {
+            *fingerprints = NULL;
+        }
+    }
+    else if ((iterator.remaining_size + min_chunk_size - 1) / min_chunk_size > UINT32_MAX)
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_047: [ If there are any failures then constbuffer_array_splitter_split_content_defined shall fail and return NULL. ]*/
+        LogError("remaining_size=%" PRIu64 " can have more than UINT32_MAX chunks of min_chunk_size=%" PRIu32, iterator.remaining_size, min_chunk_size);
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_042: [ constbuffer_array_splitter_split_content_defined shall allocate an array of CONSTBUFFER_HANDLE and an array of fingerprints for the largest possible number of chunks (total size / min_chunk_size rounded up). ]*/
+        uint32_t capacity = (uint32_t)((iterator.remaining_size + min_chunk_size - 1) / min_chunk_size);
+        CONSTBUFFER_HANDLE* chunk_buffers = malloc_2(capacity, sizeof(CONSTBUFFER_HANDLE));
+        if (chunk_buffers == NULL)
+        {
+            /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_047: [ If there are any failures then constbuffer_array_splitter_split_content_defined shall fail and return NULL. ]*/
+            LogError("failure in malloc_2(capacity=%" PRIu32 ", sizeof(CONSTBUFFER_HANDLE)=%zu)", capacity, sizeof(CONSTBUFFER_HANDLE));
+            result = NULL;
+        }
+        else
+        {
+            uint32_t* chunk_fingerprints = malloc_2(capacity, sizeof(uint32_t));
+            if (chunk_fingerprints == NULL)
+            {
+                /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_047: [ If there are any failures then constbuffer_array_splitter_split_content_defined shall fail and return NULL. ]*/
+                LogError("failure in malloc_2(capacity=%" PRIu32 ", sizeof(uint32_t)=%zu)", capacity, sizeof(uint32_t));
+                result = NULL;
+            }
+            else
+            {
+                uint32_t chunk_count = 0;
+                bool failed = false;
+                CONSTBUFFER_ARRAY_SPLITTER_CHUNK chunk;
+
+                /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_043: [ For a chunk that lies in one buffer, constbuffer_array_splitter_split_content_defined shall get the buffer with constbuffer_array_get_buffer, call CONSTBUFFER_CreateFromOffsetAndSize for the bytes of the chunk (no copy) and call CONSTBUFFER_DecRef on the buffer. ]*/
+                /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_044: [ For a chunk that spans several buffers, constbuffer_array_splitter_split_content_defined shall call CONSTBUFFER_CreateWritableHandle with the size of the chunk, copy the bytes of the chunk in it (obtained with constbuffer_array_splitter_chunk_get_span) and call CONSTBUFFER_SealWritableHandle. ]*/
+                while (constbuffer_array_splitter_cdc_iterator_next(&iterator, &chunk, &chunk_fingerprints[chunk_count]) == CONSTBUFFER_ARRAY_SPLITTER_NEXT_OK)
+                {
+                    chunk_buffers[chunk_count] = create_buffer_from_chunk(buffers, &chunk);
+                    if (chunk_buffers[chunk_count] == NULL)
+                    {
+                        failed = true;
+                        break;
+                    }
+                    chunk_count++;
+                }
+
+                if (failed)
+                {
+                    /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_047: [ If there are any failures then constbuffer_array_splitter_split_content_defined shall fail and return NULL. ]*/
+                    LogError("failure in creating the buffer of chunk %" PRIu32, chunk_count);
+                    result = NULL;
+                }
+                else
+                {
+                    if (chunk_count < capacity)
+                    {
+                        /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_048: [ If there are fewer chunks than the largest possible number of chunks then constbuffer_array_splitter_split_content_defined shall call realloc_2 to give back the memory of the array of CONSTBUFFER_HANDLE that was not used (the array is moved in the new CONSTBUFFER_ARRAY_HANDLE). If realloc_2 fails then constbuffer_array_splitter_split_content_defined shall keep the array allocated initially. ]*/
+                        CONSTBUFFER_HANDLE* shrunk = realloc_2(chunk_buffers, chunk_count, sizeof(CONSTBUFFER_HANDLE));
+                        if (shrunk == NULL)
+                        {
+                            LogWarning("failure in realloc_2(chunk_buffers=%p, chunk_count=%" PRIu32 ", sizeof(CONSTBUFFER_HANDLE)=%zu), keeping capacity=%" PRIu32 " buffers",
+                                chunk_buffers, chunk_count, sizeof(CONSTBUFFER_HANDLE), capacity);
+                        }
+                        else
+                        {
+                            chunk_buffers = shrunk;
+                        }
+                    }
+
+                    /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_045: [ constbuffer_array_splitter_split_content_defined shall call constbuffer_array_create_with_move_buffers with the buffers of the chunks. ]*/
+                    result = constbuffer_array_create_with_move_buffers(chunk_buffers, chunk_count);
+                    if (result == NULL)
+                    {
+                        /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_047: [ If there are any failures then constbuffer_array_splitter_split_content_defined shall fail and return NULL. ]*/
+                        LogError("failure in constbuffer_array_create_with_move_buffers(chunk_buffers=%p, chunk_count=%" PRIu32 ")", chunk_buffers, chunk_count);
+                    }
+                    else
+                    {
+                        /*Codes_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_046: [ constbuffer_array_splitter_split_content_defined shall write the fingerprints of the chunks in fingerprints, succeed and return the new array. ]*/
+                        *fingerprints = chunk_fingerprints;
+                        goto all_ok;
+                    }
+                }
+
+                for (uint32_t i = 0; i < chunk_count; i++)
+                {
+                    CONSTBUFFER_DecRef(chunk_buffers[i]);
+                }
+                free(chunk_fingerprints);
+            }
+            free(chunk_buffers);
+        }
+    }
+all_ok:
+    return result;
+}
@@ -0,0 +1,344 @@
+// Copyright (C) Microsoft Corporation. All rights reserved.
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "macro_utils/macro_utils.h"
+
+#include "c_logging/logger.h"
+
+#include "c_pal/gballoc_hl.h"
+#include "c_pal/gballoc_hl_redirect.h"
+#include "c_pal/interlocked.h"
+#include "c_pal/srw_lock.h"
+
+#include "c_util/constbuffer.h"
+#include "c_util/hash.h"
+
+#include "c_util/constbuffer_dedup_store.h"
+
+#define CONSTBUFFER_DEDUP_STORE_INITIAL_BUCKET_COUNT 16 /*always a power of 2*/
+
+typedef struct CONSTBUFFER_DEDUP_STORE_ENTRY_TAG
+{
+    struct CONSTBUFFER_DEDUP_STORE_ENTRY_TAG* next;
+    uint64_t hash;
+    CONSTBUFFER_DEDUP_STORE_HANDLE store;
+    CONSTBUFFER_HANDLE original; /*the buffer that was interned first, it holds the bytes*/
+    CONSTBUFFER_HANDLE interned; /*the handle given out, the store does not hold a reference to it*/
+} CONSTBUFFER_DEDUP_STORE_ENTRY;
+
+typedef struct CONSTBUFFER_DEDUP_STORE_TAG
+{
+    volatile_atomic int32_t ref_count; /*1 for the owner of the store + 1 for every entry*/
+    SRW_LOCK_HANDLE lock;
+    uint32_t bucket_count;
+    CONSTBUFFER_DEDUP_STORE_ENTRY** buckets;
+    volatile_atomic int64_t intern_count;
+    volatile_atomic int64_t hit_count;
+    volatile_atomic int64_t saved_bytes;
+    volatile_atomic int64_t entry_count;
+    volatile_atomic int64_t stored_bytes;
+} CONSTBUFFER_DEDUP_STORE;
+
+static void constbuffer_dedup_store_dec_ref(CONSTBUFFER_DEDUP_STORE_HANDLE store)
+{
+    if (interlocked_decrement(&store->ref_count) == 0)
+    {
+        free(store->buckets);
+        srw_lock_destroy(store->lock);
+        free(store);
+    }
+}
+
+/*called with the lock held (shared or exclusive), returns a new reference to the interned handle or NULL*/
+static CONSTBUFFER_HANDLE constbuffer_dedup_store_find(CONSTBUFFER_DEDUP_STORE_HANDLE store, uint64_t hash, const CONSTBUFFER* content)
+{
+    CONSTBUFFER_HANDLE result = NULL;
+    for (CONSTBUFFER_DEDUP_STORE_ENTRY* entry = store->buckets[hash & (store->bucket_count - 1)]; entry != NULL; entry = entry->next)
+    {
+        if (entry->hash == hash)
+        {
+            const CONSTBUFFER* entry_content = CONSTBUFFER_GetContent(entry->original);
+            if (
+                (entry_content->size == content->size) &&
+                (memcmp(entry_content->buffer, content->buffer, content->size) == 0) &&
+                /*an entry whose interned handle is being freed is still in the bucket until its custom free function removes it*/
+                CONSTBUFFER_TryIncRef(entry->interned)
+                )
+            {
+                result = entry->interned;
+                break;
+            }
+        }
+    }
+    return result;
+}
+
+/*called with the lock held exclusively*/
+static void constbuffer_dedup_store_grow(CONSTBUFFER_DEDUP_STORE_HANDLE store)
+{
+    uint32_t new_bucket_count = store->bucket_count * 2;
+    CONSTBUFFER_DEDUP_STORE_ENTRY** new_buckets = malloc_2(new_bucket_count, sizeof(CONSTBUFFER_DEDUP_STORE_ENTRY*));
+    if (new_buckets == NULL)
+    {
+        /*the store keeps working with longer chains*/
+        LogError("failure in malloc_2(new_bucket_count=%" PRIu32 ", sizeof(CONSTBUFFER_DEDUP_STORE_ENTRY*)=%zu)", new_bucket_count, sizeof(CONSTBUFFER_DEDUP_STORE_ENTRY*));
+    }
+    else
+    {
+        for (uint32_t i = 0; i < new_bucket_count; i++)
+        {
+            new_buckets[i] = NULL;
+        }
+
+        for (uint32_t i = 0; i < store->bucket_count; i++)
+        {
+            CONSTBUFFER_DEDUP_STORE_ENTRY* entry = store->buckets[i];
+            while (entry != NULL)
+            {
+                CONSTBUFFER_DEDUP_STORE_ENTRY* next = entry->next;
+                uint32_t new_index = (uint32_t)(entry->hash & (new_bucket_count - 1));
+                entry->next = new_buckets[new_index];
+                new_buckets[new_index] = entry;
+                entry = next;
+            }
+        }
+
+        free(store->buckets);
+        store->buckets = new_buckets;
+        store->bucket_count = new_bucket_count;
+    }
+}
+
+static void on_interned_buffer_free(void* context)
+{
+    /*Codes_SRS_CONSTBUFFER_DEDUP_STORE_12_020: [ When the last reference to an interned handle is released, the entry shall be removed from the store (with the lock acquired exclusively), CONSTBUFFER_DecRef shall be called on the buffer held by the entry, the entry shall be freed and the reference of the entry to the store shall be released. ]*/
+    CONSTBUFFER_DEDUP_STORE_ENTRY* entry = context;
+    CONSTBUFFER_DEDUP_STORE_HANDLE store = entry->store;
+    uint32_t size = CONSTBUFFER_GetContent(entry->original)->size;
+
+    srw_lock_acquire_exclusive(store->lock);
+    {
+        CONSTBUFFER_DEDUP_STORE_ENTRY** link = &store->buckets[entry->hash & (store->bucket_count - 1)];
+        while (*link != entry)
+        {
+            link = &(*link)->next;
+        }
+        *link = entry->next;
+        (void)interlocked_add_64(&store->entry_count, -1);
+        (void)interlocked_add_64(&store->stored_bytes, -(int64_t)size);
+    }
+    srw_lock_release_exclusive(store->lock);
+
+    CONSTBUFFER_DecRef(entry->original);
+    free(entry);
+    constbuffer_dedup_store_dec_ref(store);
+}
+
+CONSTBUFFER_DEDUP_STORE_HANDLE constbuffer_dedup_store_create(void)
+{
+    /*Codes_SRS_CONSTBUFFER_DEDUP_STORE_12_001: [ constbuffer_dedup_store_create shall allocate memory for the store. ]*/
+    CONSTBUFFER_DEDUP_STORE_HANDLE result = malloc(sizeof(CONSTBUFFER_DEDUP_STORE));
+    if (result == NULL)
+    {
+        /*Codes_SRS_CONSTBUFFER_DEDUP_STORE_12_005: [ If there are any failures then constbuffer_dedup_store_create shall fail and return NULL. ]*/
+        LogError("failure in malloc(sizeof(CONSTBUFFER_DEDUP_STORE)=%zu)", sizeof(CONSTBUFFER_DEDUP_STORE));
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_DEDUP_STORE_12_002: [ constbuffer_dedup_store_create shall call srw_lock_create. ]*/
+        result->lock = srw_lock_create(false, "constbuffer_dedup_store");
+        if (result->lock == NULL)
+        {
+            /*Codes_SRS_CONSTBUFFER_DEDUP_STORE_12_005: [ If there are any failures then constbuffer_dedup_store_create shall fail and return NULL. ]*/
+            LogError("failure in srw_lock_create(false, \"constbuffer_dedup_store\")");
+        }
+        else
+        {
+            /*Codes_SRS_CONSTBUFFER_DEDUP_STORE_12_003: [ constbuffer_dedup_store_create shall allocate CONSTBUFFER_DEDUP_STORE_INITIAL_BUCKET_COUNT empty buckets. ]*/
+            result->buckets = malloc_2(CONSTBUFFER_DEDUP_STORE_INITIAL_BUCKET_COUNT, sizeof(CONSTBUFFER_DEDUP_STORE_ENTRY*));
+            if (result->buckets == NULL)
+            {
+                /*Codes_SRS_CONSTBUFFER_DEDUP_STORE_12_005: [ If there are any failures then constbuffer_dedup_store_create shall fail and return NULL. ]*/
+                LogError("failure in malloc_2(CONSTBUFFER_DEDUP_STORE_INITIAL_BUCKET_COUNT=%d, sizeof(CONSTBUFFER_DEDUP_STORE_ENTRY*)=%zu)",
+                    CONSTBUFFER_DEDUP_STORE_INITIAL_BUCKET_COUNT, sizeof(CONSTBUFFER_DEDUP_STORE_ENTRY*));
+            }
+            else
+            {
+                for (uint32_t i = 0; i < CONSTBUFFER_DEDUP_STORE_INITIAL_BUCKET_COUNT; i++)
+                {
+                    result->buckets[i] = NULL;
+                }
+                result->bucket_count = CONSTBUFFER_DEDUP_STORE_INITIAL_BUCKET_COUNT;
+                (void)interlocked_exchange(&result->ref_count, 1);
+                (void)interlocked_exchange_64(&result->intern_count, 0);
+                (void)interlocked_exchange_64(&result->hit_count, 0);
+                (void)interlocked_exchange_64(&result->saved_bytes, 0);
+                (void)interlocked_exchange_64(&result->entry_count, 0);
+                (void)interlocked_exchange_64(&result->stored_bytes, 0);
+
+                /*Codes_SRS_CONSTBUFFER_DEDUP_STORE_12_004: [ constbuffer_dedup_store_create shall succeed and return the store. ]*/
+                goto all_ok;
+            }
+            srw_lock_destroy(result->lock);
+        }
+        free(result);
+        result = NULL;
+    }
+all_ok:
+    return result;
+}
+
+void constbuffer_dedup_store_destroy(CONSTBUFFER_DEDUP_STORE_HANDLE store)
+{
+    if (store == NULL)
+    {
+        /*Codes_SRS_CONSTBUFFER_DEDUP_STORE_12_006: [ If store is NULL then constbuffer_dedup_store_destroy shall return. ]*/
+        LogError("Invalid arguments: CONSTBUFFER_DEDUP_STORE_HANDLE store=%p", store);
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_DEDUP_STORE_12_007: [ constbuffer_dedup_store_destroy shall release the reference of the owner of the store. When no interned handle of the store is alive anymore the buckets shall be freed, srw_lock_destroy shall be called and the store shall be freed. ]*/
+        constbuffer_dedup_store_dec_ref(store);
+    }
+}
+
+CONSTBUFFER_HANDLE constbuffer_dedup_store_intern(CONSTBUFFER_DEDUP_STORE_HANDLE store, CONSTBUFFER_HANDLE buffer)
+{
+    CONSTBUFFER_HANDLE result;
+    if (
+        /*Codes_SRS_CONSTBUFFER_DEDUP_STORE_12_008: [ If store is NULL then constbuffer_dedup_store_intern shall fail and return NULL. ]*/
+        (store == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_DEDUP_STORE_12_009: [ If buffer is NULL then constbuffer_dedup_store_intern shall fail and return NULL. ]*/
+        (buffer == NULL)
+        )
+    {
+        LogError("Invalid arguments: CONSTBUFFER_DEDUP_STORE_HANDLE store=%p, CONSTBUFFER_HANDLE buffer=%p", store, buffer);
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_DEDUP_STORE_12_010: [ constbuffer_dedup_store_intern shall get the content of buffer by calling CONSTBUFFER_GetContent. ]*/
+        const CONSTBUFFER* content = CONSTBUFFER_GetContent(buffer);
+
+        if (content->size == 0)
+        {
+            /*Codes_SRS_CONSTBUFFER_DEDUP_STORE_12_011: [ If the content of buffer is empty then constbuffer_dedup_store_intern shall call CONSTBUFFER_IncRef on buffer and return it (empty buffers are not stored). ]*/
+            CONSTBUFFER_IncRef(buffer);
+            (void)interlocked_add_64(&store->intern_count, 1);
+            result = buffer;
+        }
+        else
+        {
+            uint64_t hash;
+            /*Codes_SRS_CONSTBUFFER_DEDUP_STORE_12_012: [ constbuffer_dedup_store_intern shall compute a 64-bit hash of the content by calling hash_compute_hash_64. ]*/
+            if (hash_compute_hash_64(content->buffer, content->size, &hash) != 0)
+            {
+                /*Codes_SRS_CONSTBUFFER_DEDUP_STORE_12_019: [ If there are any failures then constbuffer_dedup_store_intern shall fail and return NULL. ]*/
+                LogError("failure in hash_compute_hash_64(content->buffer=%p, content->size=%" PRIu32 ", &hash=%p)", content->buffer, content->size, &hash);
+                result = NULL;
+            }
+            else
+            {
+                /*Codes_SRS_CONSTBUFFER_DEDUP_STORE_12_013: [ constbuffer_dedup_store_intern shall call srw_lock_acquire_shared, look for an entry with the same hash whose buffer has the same size and the same bytes (memcmp) and whose interned handle can be referenced with CONSTBUFFER_TryIncRef, and call srw_lock_release_shared. ]*/
+                srw_lock_acquire_shared(store->lock);
+                result = constbuffer_dedup_store_find(store, hash, content);
+                srw_lock_release_shared(store->lock);
+
+                bool is_hit = (result != NULL);
+                if (!is_hit)
+                {
+                    /*Codes_SRS_CONSTBUFFER_DEDUP_STORE_12_015: [ Otherwise constbuffer_dedup_store_intern shall call srw_lock_acquire_exclusive and look for the entry again (another thread might have interned the same content). ]*/
+                    srw_lock_acquire_exclusive(store->lock);
+                    result = constbuffer_dedup_store_find(store, hash, content);
+                    is_hit = (result != NULL);
+                    if (!is_hit)
+                    {
+                        /*Codes_SRS_CONSTBUFFER_DEDUP_STORE_12_016: [ If there is still no entry then constbuffer_dedup_store_intern shall allocate a new entry, call CONSTBUFFER_CreateWithCustomFree with the content of buffer and the entry as context to create the interned handle, call CONSTBUFFER_IncRef on buffer (the entry keeps the bytes) and add the entry to the store. ]*/
+                        CONSTBUFFER_DEDUP_STORE_ENTRY* entry = malloc(sizeof(CONSTBUFFER_DEDUP_STORE_ENTRY));
+                        if (entry == NULL)
+                        {
+                            /*Codes_SRS_CONSTBUFFER_DEDUP_STORE_12_019: [ If there are any failures then constbuffer_dedup_store_intern shall fail and return NULL. ]*/
+                            LogError("failure in malloc(sizeof(CONSTBUFFER_DEDUP_STORE_ENTRY)=%zu)", sizeof(CONSTBUFFER_DEDUP_STORE_ENTRY));
+                        }
+                        else
+                        {
+                            entry->interned = CONSTBUFFER_CreateWithCustomFree(content->buffer, content->size, on_interned_buffer_free, entry);
+                            if (entry->interned == NULL)
+                            {
+                                /*Codes_SRS_CONSTBUFFER_DEDUP_STORE_12_019: [ If there are any failures then constbuffer_dedup_store_intern shall fail and return NULL. ]*/
+                                LogError("failure in CONSTBUFFER_CreateWithCustomFree(content->buffer=%p, content->size=%" PRIu32 ", on_interned_buffer_free=%p, entry=%p)",
+                                    content->buffer, content->size, on_interned_buffer_free, entry);
+                                free(entry);
+                            }
+                            else
+                            {
+                                uint32_t index = (uint32_t)(hash & (store->bucket_count - 1));
+                                CONSTBUFFER_IncRef(buffer);
+                                entry->original = buffer;
+                                entry->hash = hash;
+                                entry->store = store;
+                                (void)interlocked_increment(&store->ref_count);
+                                entry->next = store->buckets[index];
+                                store->buckets[index] = entry;
+                                (void)interlocked_add_64(&store->stored_bytes, content->size);
+
+                                /*Codes_SRS_CONSTBUFFER_DEDUP_STORE_12_017: [ When there are more entries than buckets constbuffer_dedup_store_intern shall allocate twice as many buckets (malloc_2) and move the entries to them. If that fails the store shall keep the buckets it has. ]*/
+                                if (interlocked_add_64(&store->entry_count, 1) > (int64_t)store->bucket_count)
+                                {
+                                    constbuffer_dedup_store_grow(store);
+                                }
+
+                                result = entry->interned;
+                            }
+                        }
+                    }
+                    srw_lock_release_exclusive(store->lock);
+                }
+
+                if (result != NULL)
+                {
+                    (void)interlocked_add_64(&store->intern_count, 1);
+                    if (is_hit)
+                    {
+                        /*Codes_SRS_CONSTBUFFER_DEDUP_STORE_12_014: [ If an entry is found then constbuffer_dedup_store_intern shall count a hit and the size of the content as saved bytes. ]*/
+                        (void)interlocked_add_64(&store->hit_count, 1);
+                        (void)interlocked_add_64(&store->saved_bytes, content->size);
+                    }
+
+                    /*Codes_SRS_CONSTBUFFER_DEDUP_STORE_12_018: [ constbuffer_dedup_store_intern shall succeed and return the interned handle (with a reference for the caller). ]*/
+                }
+            }
+        }
+    }
+    return result;
+}
+
+int constbuffer_dedup_store_get_statistics(CONSTBUFFER_DEDUP_STORE_HANDLE store, CONSTBUFFER_DEDUP_STORE_STATISTICS* statistics)
+{
+    int result;
+    if (
+        /*Codes_SRS_CONSTBUFFER_DEDUP_STORE_12_021: [ If store is NULL then constbuffer_dedup_store_get_statistics shall fail and return a non-zero value. ]*/
+        (store == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_DEDUP_STORE_12_022: [ If statistics is NULL then constbuffer_dedup_store_get_statistics shall fail and return a non-zero value. ]*/
+        (statistics == NULL)
+        )
+    {
+        LogError("Invalid arguments: CONSTBUFFER_DEDUP_STORE_HANDLE store=%p, CONSTBUFFER_DEDUP_STORE_STATISTICS* statistics=%p", store, statistics);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_DEDUP_STORE_12_023: [ constbuffer_dedup_store_get_statistics shall write in statistics the number of buffers interned, the number of hits, the saved bytes, the number of entries and the number of bytes in the store and return 0. ]*/
+        statistics->intern_count = (uint64_t)interlocked_add_64(&store->intern_count, 0);
+        statistics->hit_count = (uint64_t)interlocked_add_64(&store->hit_count, 0);
+        statistics->saved_bytes = (uint64_t)interlocked_add_64(&store->saved_bytes, 0);
+        statistics->entry_count = (uint64_t)interlocked_add_64(&store->entry_count, 0);
+        statistics->stored_bytes = (uint64_t)interlocked_add_64(&store->stored_bytes, 0);
+        result = 0;
+    }
+    return result;
+}
@@ -14,6 +14,7 @@
 #include "c_pal/thandle.h"
 
 #include "c_util/memory_data.h"
+#include "c_util/memory_mapped_file.h"
 #include "c_util/constbuffer_format.h"
 #include "c_util/constbuffer_version.h"
 #include "c_util/constbuffer_thandle.h"
@@ -24,7 +25,8 @@
     CONSTBUFFER_THANDLE_TYPE_COPIED, \
     CONSTBUFFER_THANDLE_TYPE_MEMORY_MOVED, \
     CONSTBUFFER_THANDLE_TYPE_WITH_CUSTOM_FREE, \
-    CONSTBUFFER_THANDLE_TYPE_FROM_OFFSET_AND_SIZE
+    CONSTBUFFER_THANDLE_TYPE_FROM_OFFSET_AND_SIZE, \
+    CONSTBUFFER_THANDLE_TYPE_MAPPED_FILE
 
 MU_DEFINE_ENUM(CONSTBUFFER_THANDLE_TYPE, CONSTBUFFER_THANDLE_TYPE_VALUES)
 
@@ -46,6 +48,13 @@ typedef struct CONSTBUFFER_THANDLE_HANDLE_WITH_CUSTOM_FREE_DATA_TAG
     void* custom_free_func_context;
 } CONSTBUFFER_THANDLE_HANDLE_WITH_CUSTOM_FREE_DATA;
 
+typedef struct CONSTBUFFER_THANDLE_HANDLE_MAPPED_FILE_DATA_TAG
+{
+    CONSTBUFFER_CONTENT alias;  // Embedded alias structure
+    CONSTBUFFER_THANDLE_TYPE buffer_type;
+    MEMORY_MAPPED_FILE_VIEW view; // Released by CONSTBUFFER_dispose
+} CONSTBUFFER_THANDLE_HANDLE_MAPPED_FILE_DATA;
+
 // THANDLE type definition for CONSTBUFFER
 THANDLE_TYPE_DEFINE(CONSTBUFFER);
 
@@ -79,6 +88,12 @@ static void CONSTBUFFER_dispose(CONSTBUFFER* handle_data)
         CONSTBUFFER_THANDLE_HANDLE_WITH_CUSTOM_FREE_DATA* custom_free_data = (CONSTBUFFER_THANDLE_HANDLE_WITH_CUSTOM_FREE_DATA*)handle_data;
         custom_free_data->custom_free_func(custom_free_data->custom_free_func_context);
     }
+    else if (handle_data->buffer_type == CONSTBUFFER_THANDLE_TYPE_MAPPED_FILE)
+    {
+        /*Codes_SRS_CONSTBUFFER_THANDLE_12_006: [ If the buffer was created by calling CONSTBUFFER_THANDLE_CreateFromMappedFile, memory_mapped_file_unmap shall be called. ]*/
+        CONSTBUFFER_THANDLE_HANDLE_MAPPED_FILE_DATA* mapped_file_data = (CONSTBUFFER_THANDLE_HANDLE_MAPPED_FILE_DATA*)handle_data;
+        memory_mapped_file_unmap(&mapped_file_data->view);
+    }
     else if (handle_data->buffer_type == CONSTBUFFER_THANDLE_TYPE_FROM_OFFSET_AND_SIZE)
     {
         /*Codes_SRS_CONSTBUFFER_THANDLE_88_048: [ If the buffer was created by calling CONSTBUFFER_THANDLE_CreateFromOffsetAndSize, the original handle shall be assigned to NULL. ]*/
@@ -268,6 +283,53 @@ THANDLE(CONSTBUFFER) CONSTBUFFER_THANDLE_CreateWithCustomFree(const unsigned cha
     return result;
 }
 
+THANDLE(CONSTBUFFER) CONSTBUFFER_THANDLE_CreateFromMappedFile(const char* file_name, uint64_t offset, uint32_t size, MEMORY_MAPPED_FILE_ACCESS_HINT hint)
+{
+    THANDLE(CONSTBUFFER) result = NULL;
+
+    /*Codes_SRS_CONSTBUFFER_THANDLE_12_001: [ If file_name is NULL then CONSTBUFFER_THANDLE_CreateFromMappedFile shall fail and return NULL. ]*/
+    if (file_name == NULL)
+    {
+        LogError("Invalid arguments: const char* file_name=%s, uint64_t offset=%" PRIu64 ", uint32_t size=%" PRIu32 ", MEMORY_MAPPED_FILE_ACCESS_HINT hint=%" PRI_MU_ENUM "",
+            MU_P_OR_NULL(file_name), offset, size, MU_ENUM_VALUE(MEMORY_MAPPED_FILE_ACCESS_HINT, hint));
+    }
+    else
+    {
+        /*Codes_SRS_CONSTBUFFER_THANDLE_12_002: [ CONSTBUFFER_THANDLE_CreateFromMappedFile shall allocate memory for the const buffer. ]*/
+        // Allocate extra space for the mapped file fields beyond the base structure
+        size_t extra_size = sizeof(CONSTBUFFER_THANDLE_HANDLE_MAPPED_FILE_DATA) - sizeof(CONSTBUFFER);
+        THANDLE(CONSTBUFFER) temp_result = THANDLE_MALLOC_FLEX(CONSTBUFFER)(CONSTBUFFER_dispose, 1, extra_size);
+        if (temp_result == NULL)
+        {
+            /*Codes_SRS_CONSTBUFFER_THANDLE_12_005: [ If there are any failures then CONSTBUFFER_THANDLE_CreateFromMappedFile shall fail and return NULL. ]*/
+            LogError("failure in THANDLE_MALLOC_FLEX, extra_size=%zu", extra_size);
+        }
+        else
+        {
+            CONSTBUFFER_THANDLE_HANDLE_MAPPED_FILE_DATA* mapped_file_data = (CONSTBUFFER_THANDLE_HANDLE_MAPPED_FILE_DATA*)THANDLE_GET_T(CONSTBUFFER)(temp_result);
+
+            /*Codes_SRS_CONSTBUFFER_THANDLE_12_003: [ CONSTBUFFER_THANDLE_CreateFromMappedFile shall call memory_mapped_file_map to map size bytes of file_name starting at offset with hint. ]*/
+            if (memory_mapped_file_map(file_name, offset, size, hint, &mapped_file_data->view) != 0)
+            {
+                /*Codes_SRS_CONSTBUFFER_THANDLE_12_005: [ If there are any failures then CONSTBUFFER_THANDLE_CreateFromMappedFile shall fail and return NULL. ]*/
+                LogError("failure in memory_mapped_file_map(file_name=%s, offset=%" PRIu64 ", size=%" PRIu32 ", hint=%" PRI_MU_ENUM ")",
+                    file_name, offset, size, MU_ENUM_VALUE(MEMORY_MAPPED_FILE_ACCESS_HINT, hint));
+                THANDLE_FREE(CONSTBUFFER)((void*)temp_result);
+            }
+            else
+            {
+                /*Codes_SRS_CONSTBUFFER_THANDLE_12_004: [ CONSTBUFFER_THANDLE_CreateFromMappedFile shall set the content of the const buffer to the mapped bytes, succeed and return a non-NULL value. ]*/
+                mapped_file_data->alias.buffer = mapped_file_data->view.content;
+                mapped_file_data->alias.size = mapped_file_data->view.content_size;
+                mapped_file_data->buffer_type = CONSTBUFFER_THANDLE_TYPE_MAPPED_FILE;
+                THANDLE_MOVE(CONSTBUFFER)(&result, &temp_result);
+            }
+        }
+    }
+
+    return result;
+}
+
 THANDLE(CONSTBUFFER) CONSTBUFFER_THANDLE_CreateFromOffsetAndSizeWithCopy(THANDLE(CONSTBUFFER) handle, uint32_t offset, uint32_t size)
 {
     THANDLE(CONSTBUFFER) result = NULL;
@@ -694,6 +756,75 @@ CONSTBUFFER_THANDLE_FROM_BUFFER_RESULT CONSTBUFFER_THANDLE_from_buffer(const uns
     return result;
 }
 
+CONSTBUFFER_THANDLE_FROM_BUFFER_RESULT CONSTBUFFER_THANDLE_from_buffer_view(THANDLE(CONSTBUFFER) source, uint32_t offset, uint32_t* consumed, THANDLE(CONSTBUFFER)* destination)
+{
+    CONSTBUFFER_THANDLE_FROM_BUFFER_RESULT result;
+    if (
+        /*Codes_SRS_CONSTBUFFER_THANDLE_12_007: [ If source is NULL then CONSTBUFFER_THANDLE_from_buffer_view shall fail and return CONSTBUFFER_THANDLE_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
+        (source == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_THANDLE_12_008: [ If consumed is NULL then CONSTBUFFER_THANDLE_from_buffer_view shall fail and return CONSTBUFFER_THANDLE_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
+        (consumed == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_THANDLE_12_009: [ If destination is NULL then CONSTBUFFER_THANDLE_from_buffer_view shall fail and return CONSTBUFFER_THANDLE_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
+        (destination == NULL) ||
+        /*Codes_SRS_CONSTBUFFER_THANDLE_12_010: [ If offset is greater than or equal to the size of source then CONSTBUFFER_THANDLE_from_buffer_view shall fail and return CONSTBUFFER_THANDLE_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
+        (offset >= source->alias.size)
+        )
+    {
+        LogError("invalid arguments THANDLE(CONSTBUFFER) source=%p, uint32_t offset=%" PRIu32 ", uint32_t* consumed=%p, THANDLE(CONSTBUFFER)* destination=%p",
+            source, offset, consumed, destination);
+        result = CONSTBUFFER_THANDLE_FROM_BUFFER_RESULT_INVALID_ARG;
+    }
+    else
+    {
+        const unsigned char* serialized = source->alias.buffer + offset;
+        uint32_t size = source->alias.size - offset;
+        uint8_t version;
+        read_uint8_t(serialized + CONSTBUFFER_VERSION_OFFSET, &version);
+        if (
+            /*Codes_SRS_CONSTBUFFER_THANDLE_12_011: [ If the bytes of source starting at offset are not a valid serialized const buffer (wrong version, not enough bytes for the size or for the content) then CONSTBUFFER_THANDLE_from_buffer_view shall fail and return CONSTBUFFER_THANDLE_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
+            (version != CONSTBUFFER_VERSION_V1) ||
+            (size < CONSTBUFFER_VERSION_SIZE + CONSTBUFFER_SIZE_SIZE)
+            )
+        {
+            LogError("cannot deserialize version=%" PRIu8 " (expected %" PRIu8 ") from size=%" PRIu32 " bytes", version, CONSTBUFFER_VERSION_V1, size);
+            result = CONSTBUFFER_THANDLE_FROM_BUFFER_RESULT_INVALID_DATA;
+        }
+        else
+        {
+            uint32_t content_size;
+            read_uint32_t(serialized + CONSTBUFFER_SIZE_OFFSET, &content_size);
+            if (size - (CONSTBUFFER_VERSION_SIZE + CONSTBUFFER_SIZE_SIZE) < content_size)
+            {
+                /*Codes_SRS_CONSTBUFFER_THANDLE_12_011: [ If the bytes of source starting at offset are not a valid serialized const buffer (wrong version, not enough bytes for the size or for the content) then CONSTBUFFER_THANDLE_from_buffer_view shall fail and return CONSTBUFFER_THANDLE_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
+                LogError("in source=%p at offset=%" PRIu32 " there are not enough bytes remaining after version and size to construct content from. Serialized content size was computed as %" PRIu32 " but there are only %" PRIu32 " bytes available",
+                    source, offset, content_size, (uint32_t)(size - CONSTBUFFER_VERSION_SIZE - CONSTBUFFER_SIZE_SIZE));
+                result = CONSTBUFFER_THANDLE_FROM_BUFFER_RESULT_INVALID_DATA;
+            }
+            else
+            {
+                /*Codes_SRS_CONSTBUFFER_THANDLE_12_012: [ CONSTBUFFER_THANDLE_from_buffer_view shall call CONSTBUFFER_THANDLE_CreateFromOffsetAndSize to create a THANDLE(CONSTBUFFER) that points to the serialized content inside source (no bytes are copied). ]*/
+                THANDLE(CONSTBUFFER) temp_destination = CONSTBUFFER_THANDLE_CreateFromOffsetAndSize(source, offset + (uint32_t)CONSTBUFFER_CONTENT_OFFSET, content_size);
+                if (temp_destination == NULL)
+                {
+                    /*Codes_SRS_CONSTBUFFER_THANDLE_12_014: [ If there are any failures then CONSTBUFFER_THANDLE_from_buffer_view shall fail and return CONSTBUFFER_THANDLE_FROM_BUFFER_RESULT_ERROR. ]*/
+                    LogError("failure in CONSTBUFFER_THANDLE_CreateFromOffsetAndSize(source=%p, offset=%" PRIu32 " + CONSTBUFFER_CONTENT_OFFSET=%zu, content_size=%" PRIu32 ")",
+                        source, offset, CONSTBUFFER_CONTENT_OFFSET, content_size);
+                    result = CONSTBUFFER_THANDLE_FROM_BUFFER_RESULT_ERROR;
+                }
+                else
+                {
+                    /*Codes_SRS_CONSTBUFFER_THANDLE_12_013: [ CONSTBUFFER_THANDLE_from_buffer_view shall succeed, write in consumed the total number of consumed bytes from source starting at offset, write in destination the constructed THANDLE(CONSTBUFFER) and return CONSTBUFFER_THANDLE_FROM_BUFFER_RESULT_OK. ]*/
+                    THANDLE_ASSIGN(CONSTBUFFER)(destination, temp_destination);
+                    *consumed = CONSTBUFFER_VERSION_SIZE + CONSTBUFFER_SIZE_SIZE + content_size;
+                    result = CONSTBUFFER_THANDLE_FROM_BUFFER_RESULT_OK;
+                }
+                THANDLE_ASSIGN(CONSTBUFFER)(&temp_destination, NULL);
+            }
+        }
+    }
+    return result;
+}
+
 THANDLE(CONSTBUFFER_THANDLE_WRITABLE_HANDLE_DATA) CONSTBUFFER_THANDLE_CreateWritableHandle(uint32_t size)
 {
     THANDLE(CONSTBUFFER_THANDLE_WRITABLE_HANDLE_DATA) result = NULL;
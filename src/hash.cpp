@@ -2,13 +2,732 @@
 // Licensed under the MIT license. See LICENSE file in the project root for full license information.
 
 #include <cstdint>
+#include <cinttypes>
 #include <climits>
 #include <cstddef>
+#include <cstring>
+
+#if defined(_M_X64) || defined(__x86_64__)
+/*SSE2 is part of x64, AVX2 is used only when the CPU has it*/
+#define HASH_X64
+#include <emmintrin.h>
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define HASH_TARGET_AVX2
+#else
+/*the rest of the library is not built with -mavx2, only the functions that use the instructions are*/
+#define HASH_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#elif defined(_M_ARM64)
+#include <intrin.h>
+#endif
+
 #include "macro_utils/macro_utils.h"
 #include "c_util/hash.h"
 #include "c_logging/logger.h"
 #include "MurmurHash2.h"
 
+/*the 64-bit hash. Inputs of up to HASH64_SHORT_SIZE_MAX bytes are hashed with 64x64->128 bit multiplications in the style of wyhash, so a short key
+costs a handful of multiplications. Longer inputs are accumulated a stripe (64 bytes) at a time in 8 64-bit lanes in the style of XXH3: the lanes
+are independent, so a stripe is 4 SSE2 or 2 AVX2 operations. The constants are the published ones of wyhash (HASH64_P0..P3) and XXH3 (secret
+and initial accumulators), the way they are combined is not, so the values are not the ones of wyhash/XXH3. The values do not depend on the
+instructions used and can be persisted*/
+#define HASH64_SHORT_SIZE_MAX 256
+#define HASH64_STRIPE_SIZE 64
+#define HASH64_LANE_COUNT 8
+#define HASH64_STRIPES_PER_BLOCK 16
+#define HASH64_SECRET_COUNT 24
+
+/*keys of the stripes of a block start at secret[stripe index in the block], the other ranges are used once per input*/
+#define HASH64_SCRAMBLE_KEY_INDEX 16
+#define HASH64_LAST_STRIPE_KEY_INDEX 7
+#define HASH64_MERGE_KEY_INDEX 11
+
+#define HASH64_P0 0xA0761D6478BD642FULL
+#define HASH64_P1 0xE7037ED1A0B428DBULL
+#define HASH64_P2 0x8EBC6AF09C88C6E3ULL
+#define HASH64_P3 0x589965CC75374CC3ULL
+
+#define HASH64_PRIME32_1 0x9E3779B1U
+
+/*the first 192 bytes of the default secret of XXH3 (kSecret), read as little-endian 64-bit values*/
+static const uint64_t hash64_secret[HASH64_SECRET_COUNT] =
+{
+    0xBE4BA423396CFEB8ULL, 0x1CAD21F72C81017CULL, 0xDB979083E96DD4DEULL, 0x1F67B3B7A4A44072ULL,
+    0x78E5C0CC4EE679CBULL, 0x2172FFCC7DD05A82ULL, 0x8E2443F7744608B8ULL, 0x4C263A81E69035E0ULL,
+    0xCB00C391BB52283CULL, 0xA32E531B8B65D088ULL, 0x4EF90DA297486471ULL, 0xD8ACDEA946EF1938ULL,
+    0x3F349CE33F76FAA8ULL, 0x1D4F0BC7C7BBDCF9ULL, 0x3159B4CD4BE0518AULL, 0x647378D9C97E9FC8ULL,
+    0xC3EBD33483ACC5EAULL, 0xEB6313FAFFA081C5ULL, 0x49DAF0B751DD0D17ULL, 0x9E68D429265516D3ULL,
+    0xFCA1477D58BE162BULL, 0xCE31D07AD1B8F88FULL, 0x280416958F3ACB45ULL, 0x7E404BBBCAFBD7AFULL
+};
+
+/*the initial accumulators of XXH3 (XXH3_INIT_ACC)*/
+static const uint64_t hash64_initial_accumulators[HASH64_LANE_COUNT] =
+{
+    0x00000000C2B2AE3DULL, 0x9E3779B185EBCA87ULL, 0xC2B2AE3D27D4EB4FULL, 0x165667B19E3779F9ULL,
+    0x85EBCA77C2B2AE63ULL, 0x0000000085EBCA77ULL, 0x27D4EB2F165667C5ULL, 0x000000009E3779B1ULL
+};
+
+#define HASH64_IMPLEMENTATION_SCALAR 1
+#define HASH64_IMPLEMENTATION_SSE2 2
+#define HASH64_IMPLEMENTATION_AVX2 3
+
+/*the hash is defined on little-endian reads*/
+static uint64_t hash64_read64(const unsigned char* p)
+{
+    uint64_t result;
+    (void)memcpy(&result, p, sizeof(result));
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+    result = __builtin_bswap64(result);
+#endif
+    return result;
+}
+
+static uint64_t hash64_read32(const unsigned char* p)
+{
+    uint32_t result;
+    (void)memcpy(&result, p, sizeof(result));
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+    result = __builtin_bswap32(result);
+#endif
+    return result;
+}
+
+static void hash64_multiply(uint64_t a, uint64_t b, uint64_t* low, uint64_t* high)
+{
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 product = (unsigned __int128)a * b;
+    *low = (uint64_t)product;
+    *high = (uint64_t)(product >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    *low = _umul128(a, b, high);
+#elif defined(_MSC_VER) && defined(_M_ARM64)
+    *low = a * b;
+    *high = __umulh(a, b);
+#else
+    uint64_t a_high = a >> 32;
+    uint64_t a_low = (uint32_t)a;
+    uint64_t b_high = b >> 32;
+    uint64_t b_low = (uint32_t)b;
+    uint64_t high_high = a_high * b_high;
+    uint64_t high_low = a_high * b_low;
+    uint64_t low_high = a_low * b_high;
+    uint64_t low_low = a_low * b_low;
+    uint64_t middle = high_low + (low_low >> 32) + (uint32_t)low_high;
+    *high = high_high + (middle >> 32) + (low_high >> 32);
+    *low = (middle << 32) | (uint32_t)low_low;
+#endif
+}
+
+static uint64_t hash64_mix(uint64_t a, uint64_t b)
+{
+    uint64_t low;
+    uint64_t high;
+    hash64_multiply(a, b, &low, &high);
+    return low ^ high;
+}
+
+static uint64_t hash64_avalanche(uint64_t h)
+{
+    h ^= h >> 37;
+    h *= 0x165667919E3779F9ULL;
+    h ^= h >> 32;
+    return h;
+}
+
+static uint64_t hash64_short(const unsigned char* p, size_t length, uint64_t seed)
+{
+    uint64_t a;
+    uint64_t b;
+
+    seed ^= hash64_mix(seed ^ HASH64_P0, HASH64_P1);
+    if (length <= 16)
+    {
+        if (length >= 4)
+        {
+            /*2 overlapping 4 byte reads from each end cover any length from 4 to 16*/
+            size_t quarter = (length >> 3) << 2;
+            a = (hash64_read32(p) << 32) | hash64_read32(p + quarter);
+            b = (hash64_read32(p + length - 4) << 32) | hash64_read32(p + length - 4 - quarter);
+        }
+        else if (length > 0)
+        {
+            a = ((uint64_t)p[0] << 16) | ((uint64_t)p[length >> 1] << 8) | p[length - 1];
+            b = 0;
+        }
+        else
+        {
+            a = 0;
+            b = 0;
+        }
+    }
+    else
+    {
+        size_t remaining = length;
+        if (remaining > 48)
+        {
+            /*3 independent chains, so that the multiplications overlap*/
+            uint64_t seed1 = seed;
+            uint64_t seed2 = seed;
+            do
+            {
+                seed = hash64_mix(hash64_read64(p) ^ HASH64_P1, hash64_read64(p + 8) ^ seed);
+                seed1 = hash64_mix(hash64_read64(p + 16) ^ HASH64_P2, hash64_read64(p + 24) ^ seed1);
+                seed2 = hash64_mix(hash64_read64(p + 32) ^ HASH64_P3, hash64_read64(p + 40) ^ seed2);
+                p += 48;
+                remaining -= 48;
+            } while (remaining > 48);
+            seed ^= seed1 ^ seed2;
+        }
+        while (remaining > 16)
+        {
+            seed = hash64_mix(hash64_read64(p) ^ HASH64_P1, hash64_read64(p + 8) ^ seed);
+            p += 16;
+            remaining -= 16;
+        }
+        /*the last 16 bytes of the input, which can overlap bytes already mixed*/
+        a = hash64_read64(p + remaining - 16);
+        b = hash64_read64(p + remaining - 8);
+    }
+
+    a ^= HASH64_P1;
+    b ^= seed;
+    hash64_multiply(a, b, &a, &b);
+    return hash64_mix(a ^ HASH64_P0 ^ (uint64_t)length, b ^ HASH64_P1);
+}
+
+/*acc[i] += input[i ^ 1] + low32(input[i] ^ key[i]) * high32(input[i] ^ key[i]). Adding the input of the neighbor lane keeps the input bits that the
+multiplication loses (a key that makes a 32 bit half 0)*/
+static void hash64_accumulate_stripe_scalar(uint64_t* accumulators, const unsigned char* input, const uint64_t* key)
+{
+    for (uint32_t i = 0; i < HASH64_LANE_COUNT; i++)
+    {
+        uint64_t value = hash64_read64(input + 8 * i);
+        uint64_t keyed = value ^ key[i];
+        accumulators[i ^ 1] += value;
+        accumulators[i] += (uint64_t)(uint32_t)keyed * (keyed >> 32);
+    }
+}
+
+static void hash64_scramble_scalar(uint64_t* accumulators, const uint64_t* key)
+{
+    for (uint32_t i = 0; i < HASH64_LANE_COUNT; i++)
+    {
+        uint64_t accumulator = accumulators[i];
+        accumulators[i] = (accumulator ^ (accumulator >> 47) ^ key[i]) * HASH64_PRIME32_1;
+    }
+}
+
+/*accumulates stripe_count stripes, the first one being stripe first_stripe of the input (which sets the key of every stripe and where the blocks end)*/
+static void hash64_accumulate_scalar(uint64_t* accumulators, const unsigned char* input, size_t stripe_count, size_t first_stripe, const uint64_t* secret)
+{
+    size_t stripe_in_block = first_stripe % HASH64_STRIPES_PER_BLOCK;
+    for (size_t i = 0; i < stripe_count; i++)
+    {
+        hash64_accumulate_stripe_scalar(accumulators, input, secret + stripe_in_block);
+        input += HASH64_STRIPE_SIZE;
+        if (++stripe_in_block == HASH64_STRIPES_PER_BLOCK)
+        {
+            hash64_scramble_scalar(accumulators, secret + HASH64_SCRAMBLE_KEY_INDEX);
+            stripe_in_block = 0;
+        }
+    }
+}
+
+#if defined(HASH_X64)
+/*_mm_mul_epu32 multiplies the low 32 bits of each 64 bit lane, the shuffles swap the 32 bit halves of the lanes and the 2 lanes*/
+static void hash64_accumulate_sse2(uint64_t* accumulators, const unsigned char* input, size_t stripe_count, size_t first_stripe, const uint64_t* secret)
+{
+    __m128i acc[HASH64_LANE_COUNT / 2];
+    const __m128i prime = _mm_set1_epi32((int)HASH64_PRIME32_1);
+    size_t stripe_in_block = first_stripe % HASH64_STRIPES_PER_BLOCK;
+
+    for (uint32_t j = 0; j < HASH64_LANE_COUNT / 2; j++)
+    {
+        acc[j] = _mm_loadu_si128((const __m128i*)(accumulators + 2 * j));
+    }
+
+    for (size_t i = 0; i < stripe_count; i++)
+    {
+        const uint64_t* key = secret + stripe_in_block;
+        for (uint32_t j = 0; j < HASH64_LANE_COUNT / 2; j++)
+        {
+            __m128i value = _mm_loadu_si128((const __m128i*)(input + 16 * j));
+            __m128i keyed = _mm_xor_si128(value, _mm_loadu_si128((const __m128i*)(key + 2 * j)));
+            __m128i product = _mm_mul_epu32(keyed, _mm_shuffle_epi32(keyed, _MM_SHUFFLE(2, 3, 0, 1)));
+            acc[j] = _mm_add_epi64(acc[j], _mm_add_epi64(product, _mm_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2))));
+        }
+        input += HASH64_STRIPE_SIZE;
+
+        if (++stripe_in_block == HASH64_STRIPES_PER_BLOCK)
+        {
+            const uint64_t* scramble_key = secret + HASH64_SCRAMBLE_KEY_INDEX;
+            for (uint32_t j = 0; j < HASH64_LANE_COUNT / 2; j++)
+            {
+                __m128i scrambled = _mm_xor_si128(_mm_xor_si128(acc[j], _mm_srli_epi64(acc[j], 47)), _mm_loadu_si128((const __m128i*)(scramble_key + 2 * j)));
+                __m128i low = _mm_mul_epu32(scrambled, prime);
+                __m128i high = _mm_mul_epu32(_mm_srli_epi64(scrambled, 32), prime);
+                acc[j] = _mm_add_epi64(low, _mm_slli_epi64(high, 32));
+            }
+            stripe_in_block = 0;
+        }
+    }
+
+    for (uint32_t j = 0; j < HASH64_LANE_COUNT / 2; j++)
+    {
+        _mm_storeu_si128((__m128i*)(accumulators + 2 * j), acc[j]);
+    }
+}
+
+HASH_TARGET_AVX2
+static void hash64_accumulate_avx2(uint64_t* accumulators, const unsigned char* input, size_t stripe_count, size_t first_stripe, const uint64_t* secret)
+{
+    __m256i acc[HASH64_LANE_COUNT / 4];
+    const __m256i prime = _mm256_set1_epi32((int)HASH64_PRIME32_1);
+    size_t stripe_in_block = first_stripe % HASH64_STRIPES_PER_BLOCK;
+
+    for (uint32_t j = 0; j < HASH64_LANE_COUNT / 4; j++)
+    {
+        acc[j] = _mm256_loadu_si256((const __m256i*)(accumulators + 4 * j));
+    }
+
+    for (size_t i = 0; i < stripe_count; i++)
+    {
+        const uint64_t* key = secret + stripe_in_block;
+        for (uint32_t j = 0; j < HASH64_LANE_COUNT / 4; j++)
+        {
+            __m256i value = _mm256_loadu_si256((const __m256i*)(input + 32 * j));
+            __m256i keyed = _mm256_xor_si256(value, _mm256_loadu_si256((const __m256i*)(key + 4 * j)));
+            __m256i product = _mm256_mul_epu32(keyed, _mm256_shuffle_epi32(keyed, _MM_SHUFFLE(2, 3, 0, 1)));
+            acc[j] = _mm256_add_epi64(acc[j], _mm256_add_epi64(product, _mm256_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2))));
+        }
+        input += HASH64_STRIPE_SIZE;
+
+        if (++stripe_in_block == HASH64_STRIPES_PER_BLOCK)
+        {
+            const uint64_t* scramble_key = secret + HASH64_SCRAMBLE_KEY_INDEX;
+            for (uint32_t j = 0; j < HASH64_LANE_COUNT / 4; j++)
+            {
+                __m256i scrambled = _mm256_xor_si256(_mm256_xor_si256(acc[j], _mm256_srli_epi64(acc[j], 47)), _mm256_loadu_si256((const __m256i*)(scramble_key + 4 * j)));
+                __m256i low = _mm256_mul_epu32(scrambled, prime);
+                __m256i high = _mm256_mul_epu32(_mm256_srli_epi64(scrambled, 32), prime);
+                acc[j] = _mm256_add_epi64(low, _mm256_slli_epi64(high, 32));
+            }
+            stripe_in_block = 0;
+        }
+    }
+
+    for (uint32_t j = 0; j < HASH64_LANE_COUNT / 4; j++)
+    {
+        _mm256_storeu_si256((__m256i*)(accumulators + 4 * j), acc[j]);
+    }
+}
+
+static bool hash64_cpu_has_avx2(void)
+{
+#if defined(_MSC_VER)
+    int cpu_info[4];
+    __cpuid(cpu_info, 1);
+    /*ECX bit 27 is OSXSAVE, the OS must save the YMM registers (XCR0 bits 1 and 2)*/
+    bool result = ((cpu_info[2] & (1 << 27)) != 0) && ((_xgetbv(0) & 6) == 6);
+    if (result)
+    {
+        __cpuidex(cpu_info, 7, 0);
+        result = (cpu_info[1] & (1 << 5)) != 0; /*EBX bit 5 is AVX2*/
+    }
+    return result;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+static int hash64_detect_implementation(void)
+{
+#if defined(HASH_X64)
+    return hash64_cpu_has_avx2() ? HASH64_IMPLEMENTATION_AVX2 : HASH64_IMPLEMENTATION_SSE2;
+#else
+    return HASH64_IMPLEMENTATION_SCALAR;
+#endif
+}
+
+/*all the implementations produce the same accumulators*/
+static void hash64_accumulate(uint64_t* accumulators, const unsigned char* input, size_t stripe_count, size_t first_stripe, const uint64_t* secret)
+{
+    /*initialized once (thread-safe) by the first caller*/
+    static const int implementation = hash64_detect_implementation();
+
+#if defined(HASH_X64)
+    if (implementation == HASH64_IMPLEMENTATION_AVX2)
+    {
+        hash64_accumulate_avx2(accumulators, input, stripe_count, first_stripe, secret);
+    }
+    else if (implementation == HASH64_IMPLEMENTATION_SSE2)
+    {
+        hash64_accumulate_sse2(accumulators, input, stripe_count, first_stripe, secret);
+    }
+    else
+#endif
+    {
+        (void)implementation;
+        hash64_accumulate_scalar(accumulators, input, stripe_count, first_stripe, secret);
+    }
+}
+
+/*a seed changes every key: added to the even ones and subtracted from the odd ones*/
+static void hash64_seed_secret(uint64_t seed, uint64_t* seeded_secret)
+{
+    for (uint32_t i = 0; i < HASH64_SECRET_COUNT; i += 2)
+    {
+        seeded_secret[i] = hash64_secret[i] + seed;
+        seeded_secret[i + 1] = hash64_secret[i + 1] - seed;
+    }
+}
+
+static const uint64_t* hash64_get_secret(uint64_t seed, uint64_t* seeded_secret)
+{
+    const uint64_t* result;
+    if (seed == 0)
+    {
+        result = hash64_secret;
+    }
+    else
+    {
+        hash64_seed_secret(seed, seeded_secret);
+        result = seeded_secret;
+    }
+    return result;
+}
+
+static uint64_t hash64_merge(const uint64_t* accumulators, uint64_t length, const uint64_t* secret)
+{
+    uint64_t result = length * HASH64_P0;
+    for (uint32_t i = 0; i < HASH64_LANE_COUNT; i += 2)
+    {
+        result += hash64_mix(accumulators[i] ^ secret[HASH64_MERGE_KEY_INDEX + i], accumulators[i + 1] ^ secret[HASH64_MERGE_KEY_INDEX + i + 1]);
+    }
+    return hash64_avalanche(result);
+}
+
+/*for length > HASH64_SHORT_SIZE_MAX: the stripes that end before the last byte, then the last 64 bytes (which can overlap the last stripe)*/
+static uint64_t hash64_long(const unsigned char* p, size_t length, uint64_t seed)
+{
+    uint64_t seeded_secret[HASH64_SECRET_COUNT];
+    const uint64_t* secret = hash64_get_secret(seed, seeded_secret);
+    uint64_t accumulators[HASH64_LANE_COUNT];
+    (void)memcpy(accumulators, hash64_initial_accumulators, sizeof(accumulators));
+
+    hash64_accumulate(accumulators, p, (length - 1) / HASH64_STRIPE_SIZE, 0, secret);
+    hash64_accumulate_stripe_scalar(accumulators, p + length - HASH64_STRIPE_SIZE, secret + HASH64_LAST_STRIPE_KEY_INDEX);
+    return hash64_merge(accumulators, length, secret);
+}
+
+/*HASH_STATE is sized with the constants of the public header*/
+static_assert(HASH_STATE_ACCUMULATOR_COUNT == HASH64_LANE_COUNT, "HASH_STATE_ACCUMULATOR_COUNT must be HASH64_LANE_COUNT");
+static_assert(HASH_STATE_SECRET_COUNT == HASH64_SECRET_COUNT, "HASH_STATE_SECRET_COUNT must be HASH64_SECRET_COUNT");
+static_assert(HASH_STATE_STRIPE_SIZE == HASH64_STRIPE_SIZE, "HASH_STATE_STRIPE_SIZE must be HASH64_STRIPE_SIZE");
+static_assert(HASH_STATE_BUFFER_SIZE == HASH64_SHORT_SIZE_MAX, "an input that fits in the buffer must be a short one");
+static_assert(HASH_STATE_BUFFER_SIZE % HASH64_STRIPE_SIZE == 0, "the buffer must hold whole stripes");
+
+static uint64_t hash64_compute(const unsigned char* p, size_t length, uint64_t seed)
+{
+    return (length <= HASH64_SHORT_SIZE_MAX) ? hash64_short(p, length, seed) : hash64_long(p, length, seed);
+}
+
+/*hash_compute_hash_batch computes MurmurHash2 with seed 0 (the value of hash_compute_hash) of many keys. MurmurHash2 mixes 4 bytes (a block) at a time
+with 32-bit multiplications into a 32-bit state, so with AVX2 the whole hash of 8 keys is computed at once, one key per 32-bit lane (SSE2 has no
+32-bit multiplication, its emulation costs as much as the scalar code). Each lane loads 16 bytes (4 blocks) of its key and a 4x4 transpose turns
+them in 4 vectors of blocks*/
+#define HASH_MURMUR2_M 0x5bd1e995U
+#define HASH_MURMUR2_R 24
+#define HASH_BATCH_CHUNK_SIZE 16
+#define HASH_BATCH_LANE_COUNT 8
+
+/*MurmurHash2 reads the blocks in the byte order of the machine*/
+static uint32_t hash_murmur2_read_block(const unsigned char* p)
+{
+    uint32_t result;
+    (void)memcpy(&result, p, sizeof(result));
+    return result;
+}
+
+static uint32_t hash_murmur2_mix_block(uint32_t h, const unsigned char* p)
+{
+    uint32_t k = hash_murmur2_read_block(p);
+    k *= HASH_MURMUR2_M;
+    k ^= k >> HASH_MURMUR2_R;
+    k *= HASH_MURMUR2_M;
+    h *= HASH_MURMUR2_M;
+    return h ^ k;
+}
+
+static uint32_t hash_murmur2(const unsigned char* p, size_t length)
+{
+    /*the state starts as seed ^ length, the length is less than INT_MAX*/
+    uint32_t h = (uint32_t)length;
+    while (length >= 4)
+    {
+        h = hash_murmur2_mix_block(h, p);
+        p += 4;
+        length -= 4;
+    }
+
+    switch (length)
+    {
+        case 3:
+            h ^= (uint32_t)p[2] << 16;
+            /*fallthrough*/
+        case 2:
+            h ^= (uint32_t)p[1] << 8;
+            /*fallthrough*/
+        case 1:
+            h ^= p[0];
+            h *= HASH_MURMUR2_M;
+            break;
+        default:
+            break;
+    }
+
+    h ^= h >> 13;
+    h *= HASH_MURMUR2_M;
+    h ^= h >> 15;
+    return h;
+}
+
+static void hash_batch_scalar(const void* const* keys, const size_t* lengths, size_t count, uint32_t* hashes)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        hashes[i] = hash_murmur2((const unsigned char*)keys[i], lengths[i]);
+    }
+}
+
+#if defined(HASH_X64)
+static_assert(sizeof(size_t) == sizeof(uint64_t), "hash_batch_avx2 loads 4 lengths in a vector");
+
+/*row r moves the last r bytes of 16 to the front and zeroes the others (an index with the high bit set gives 0)*/
+static const unsigned char hash_batch_rest_shuffle[HASH_BATCH_CHUNK_SIZE][HASH_BATCH_CHUNK_SIZE] =
+{
+    { 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+    { 0x0F, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+    { 0x0E, 0x0F, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+    { 0x0D, 0x0E, 0x0F, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+    { 0x0C, 0x0D, 0x0E, 0x0F, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+    { 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+    { 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+    { 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+    { 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+    { 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+    { 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+    { 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x80, 0x80, 0x80, 0x80, 0x80 },
+    { 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x80, 0x80, 0x80, 0x80 },
+    { 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x80, 0x80, 0x80 },
+    { 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x80, 0x80 },
+    { 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x80 }
+};
+
+/*row r puts in order the r bytes of a key shorter than 16 bytes loaded as 2 overlapping halves of 8 bytes (4 bytes when r is less than 8), and
+zeroes the others*/
+static const unsigned char hash_batch_short_shuffle[HASH_BATCH_CHUNK_SIZE][HASH_BATCH_CHUNK_SIZE] =
+{
+    { 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+    { 0x00, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+    { 0x00, 0x01, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+    { 0x00, 0x01, 0x02, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+    { 0x00, 0x01, 0x02, 0x03, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+    { 0x00, 0x01, 0x02, 0x03, 0x07, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+    { 0x00, 0x01, 0x02, 0x03, 0x06, 0x07, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+    { 0x00, 0x01, 0x02, 0x03, 0x05, 0x06, 0x07, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+    { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+    { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x0F, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+    { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x0E, 0x0F, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+    { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x0D, 0x0E, 0x0F, 0x80, 0x80, 0x80, 0x80, 0x80 },
+    { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x0C, 0x0D, 0x0E, 0x0F, 0x80, 0x80, 0x80, 0x80 },
+    { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x80, 0x80, 0x80 },
+    { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x80, 0x80 },
+    { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x80 }
+};
+
+/*the length % 16 bytes after the chunks of a key, at the start of the row and followed by zeros. No byte outside of the key is read*/
+HASH_TARGET_AVX2
+static __m128i hash_batch_load_rest_avx2(const unsigned char* p, size_t length)
+{
+    __m128i result;
+    if (length >= HASH_BATCH_CHUNK_SIZE)
+    {
+        result = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(p + length - HASH_BATCH_CHUNK_SIZE)), _mm_loadu_si128((const __m128i*)hash_batch_rest_shuffle[length % HASH_BATCH_CHUNK_SIZE]));
+    }
+    else if (length >= 8)
+    {
+        uint64_t first;
+        uint64_t last;
+        (void)memcpy(&first, p, sizeof(first));
+        (void)memcpy(&last, p + length - sizeof(last), sizeof(last));
+        result = _mm_shuffle_epi8(_mm_set_epi64x((long long)last, (long long)first), _mm_loadu_si128((const __m128i*)hash_batch_short_shuffle[length]));
+    }
+    else if (length >= 4)
+    {
+        uint32_t first;
+        uint32_t last;
+        (void)memcpy(&first, p, sizeof(first));
+        (void)memcpy(&last, p + length - sizeof(last), sizeof(last));
+        result = _mm_shuffle_epi8(_mm_unpacklo_epi32(_mm_cvtsi32_si128((int)first), _mm_cvtsi32_si128((int)last)), _mm_loadu_si128((const __m128i*)hash_batch_short_shuffle[length]));
+    }
+    else
+    {
+        result = _mm_cvtsi32_si128((int)((uint32_t)p[0] | ((uint32_t)p[length / 2] << (8 * (length / 2))) | ((uint32_t)p[length - 1] << (8 * (length - 1)))));
+    }
+    return result;
+}
+
+/*rows[lane] holds 4 blocks of the key of lane. Lanes 0..3 go in the low half and 4..7 in the high half, the unpacks transpose each half*/
+HASH_TARGET_AVX2
+static void hash_batch_transpose_avx2(const __m128i* rows, __m256i* blocks)
+{
+    const __m256i x0 = _mm256_inserti128_si256(_mm256_castsi128_si256(rows[0]), rows[4], 1);
+    const __m256i x1 = _mm256_inserti128_si256(_mm256_castsi128_si256(rows[1]), rows[5], 1);
+    const __m256i x2 = _mm256_inserti128_si256(_mm256_castsi128_si256(rows[2]), rows[6], 1);
+    const __m256i x3 = _mm256_inserti128_si256(_mm256_castsi128_si256(rows[3]), rows[7], 1);
+    const __m256i t0 = _mm256_unpacklo_epi32(x0, x1);
+    const __m256i t1 = _mm256_unpackhi_epi32(x0, x1);
+    const __m256i t2 = _mm256_unpacklo_epi32(x2, x3);
+    const __m256i t3 = _mm256_unpackhi_epi32(x2, x3);
+    blocks[0] = _mm256_unpacklo_epi64(t0, t2);
+    blocks[1] = _mm256_unpackhi_epi64(t0, t2);
+    blocks[2] = _mm256_unpacklo_epi64(t1, t3);
+    blocks[3] = _mm256_unpackhi_epi64(t1, t3);
+}
+
+/*mixes a block in the lanes that are active. The others multiply their state by 1 and xor it with 0, so no blend lengthens the chain of the state*/
+HASH_TARGET_AVX2
+static __m256i hash_batch_mix_block_avx2(__m256i h, __m256i block, __m256i active)
+{
+    const __m256i m = _mm256_set1_epi32((int)HASH_MURMUR2_M);
+    const __m256i h_multiplier = _mm256_blendv_epi8(_mm256_set1_epi32(1), m, active);
+    __m256i k = _mm256_mullo_epi32(block, m);
+    k = _mm256_xor_si256(k, _mm256_srli_epi32(k, HASH_MURMUR2_R));
+    k = _mm256_and_si256(_mm256_mullo_epi32(k, m), active);
+    return _mm256_xor_si256(_mm256_mullo_epi32(h, h_multiplier), k);
+}
+
+/*8 keys at a time: the 16 byte chunks of the keys (in the lanes of the keys that have that chunk), then the 0 to 15 bytes left of each key. The
+chunks that only one key of the 8 has are not worth the vector operations and are mixed with the scalar code*/
+HASH_TARGET_AVX2
+static void hash_batch_avx2(const void* const* keys, const size_t* lengths, size_t count, uint32_t* hashes)
+{
+    static const unsigned char zero_chunk[HASH_BATCH_CHUNK_SIZE] = { 0 };
+    const __m256i m = _mm256_set1_epi32((int)HASH_MURMUR2_M);
+    /*the low 32 bits of 4 lengths (less than INT_MAX) are their even 32-bit elements*/
+    const __m256i even_elements = _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+    size_t i;
+
+    for (i = 0; i + HASH_BATCH_LANE_COUNT <= count; i += HASH_BATCH_LANE_COUNT)
+    {
+        const unsigned char* const* p = (const unsigned char* const*)(keys + i);
+        uint32_t chunk_counts[HASH_BATCH_LANE_COUNT];
+        __m128i rows[HASH_BATCH_LANE_COUNT];
+        __m256i blocks[4];
+        uint32_t chunk;
+        int active_lanes;
+
+        const __m256i length = _mm256_blend_epi32(
+            _mm256_permutevar8x32_epi32(_mm256_loadu_si256((const __m256i*)(lengths + i)), even_elements),
+            _mm256_permutevar8x32_epi32(_mm256_loadu_si256((const __m256i*)(lengths + i + 4)), even_elements),
+            0xF0);
+        const __m256i counts = _mm256_srli_epi32(length, 4);
+        _mm256_storeu_si256((__m256i*)chunk_counts, counts);
+        __m256i h = length;
+
+        for (chunk = 0; ; chunk++)
+        {
+            const __m256i active = _mm256_cmpgt_epi32(counts, _mm256_set1_epi32((int)chunk));
+            active_lanes = _mm256_movemask_ps(_mm256_castsi256_ps(active));
+            if ((active_lanes & (active_lanes - 1)) == 0)
+            {
+                /*at most one key has more chunks*/
+                break;
+            }
+            for (uint32_t lane = 0; lane < HASH_BATCH_LANE_COUNT; lane++)
+            {
+                const unsigned char* chunk_start = (chunk < chunk_counts[lane]) ? p[lane] + (size_t)chunk * HASH_BATCH_CHUNK_SIZE : zero_chunk;
+                rows[lane] = _mm_loadu_si128((const __m128i*)chunk_start);
+            }
+            hash_batch_transpose_avx2(rows, blocks);
+            for (uint32_t j = 0; j < 4; j++)
+            {
+                h = hash_batch_mix_block_avx2(h, blocks[j], active);
+            }
+        }
+
+        if (active_lanes != 0)
+        {
+            uint32_t state[HASH_BATCH_LANE_COUNT];
+            uint32_t lane = 0;
+            while ((active_lanes & (1 << lane)) == 0)
+            {
+                lane++;
+            }
+            _mm256_storeu_si256((__m256i*)state, h);
+            for (size_t offset = (size_t)chunk * HASH_BATCH_CHUNK_SIZE; offset < (size_t)chunk_counts[lane] * HASH_BATCH_CHUNK_SIZE; offset += 4)
+            {
+                state[lane] = hash_murmur2_mix_block(state[lane], p[lane] + offset);
+            }
+            h = _mm256_loadu_si256((const __m256i*)state);
+        }
+
+        const __m256i rest_size = _mm256_and_si256(length, _mm256_set1_epi32(HASH_BATCH_CHUNK_SIZE - 1));
+        if (!_mm256_testz_si256(rest_size, rest_size))
+        {
+            for (uint32_t lane = 0; lane < HASH_BATCH_LANE_COUNT; lane++)
+            {
+                rows[lane] = hash_batch_load_rest_avx2(p[lane], lengths[i + lane]);
+            }
+            hash_batch_transpose_avx2(rows, blocks);
+
+            const __m256i rest_blocks = _mm256_srli_epi32(rest_size, 2);
+            for (uint32_t j = 0; j < 3; j++)
+            {
+                h = hash_batch_mix_block_avx2(h, blocks[j], _mm256_cmpgt_epi32(rest_blocks, _mm256_set1_epi32((int)j)));
+            }
+
+            /*the 1 to 3 bytes of the tail are the block after the whole blocks, followed by zeros (all zeros when there is no tail)*/
+            __m256i tail = blocks[0];
+            tail = _mm256_blendv_epi8(tail, blocks[1], _mm256_cmpeq_epi32(rest_blocks, _mm256_set1_epi32(1)));
+            tail = _mm256_blendv_epi8(tail, blocks[2], _mm256_cmpeq_epi32(rest_blocks, _mm256_set1_epi32(2)));
+            tail = _mm256_blendv_epi8(tail, blocks[3], _mm256_cmpeq_epi32(rest_blocks, _mm256_set1_epi32(3)));
+            const __m256i has_tail = _mm256_cmpgt_epi32(_mm256_and_si256(length, _mm256_set1_epi32(3)), _mm256_setzero_si256());
+            h = _mm256_mullo_epi32(_mm256_xor_si256(h, tail), _mm256_blendv_epi8(_mm256_set1_epi32(1), m, has_tail));
+        }
+
+        h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 13));
+        h = _mm256_mullo_epi32(h, m);
+        h = _mm256_xor_si256(h, _mm256_srli_epi32(h, 15));
+        _mm256_storeu_si256((__m256i*)(hashes + i), h);
+    }
+
+    hash_batch_scalar(keys + i, lengths + i, count - i, hashes + i);
+}
+#endif
+
+/*all the implementations produce MurmurHash2 with seed 0*/
+static void hash_batch(const void* const* keys, const size_t* lengths, size_t count, uint32_t* hashes)
+{
+    static const int implementation = hash64_detect_implementation();
+
+#if defined(HASH_X64)
+    if (implementation == HASH64_IMPLEMENTATION_AVX2)
+    {
+        hash_batch_avx2(keys, lengths, count, hashes);
+    }
+    else
+#endif
+    {
+        (void)implementation;
+        hash_batch_scalar(keys, lengths, count, hashes);
+    }
+}
+
 int hash_compute_hash(const void* buffer, size_t length, uint32_t* hash)
 {
     int result;
@@ -37,3 +756,242 @@ int hash_compute_hash(const void* buffer, size_t length, uint32_t* hash)
 
     return result;
 }
+
+int hash_compute_hash_64(const void* buffer, size_t length, uint64_t* hash)
+{
+    int result;
+
+    /* Codes_SRS_HASH_12_001: [ If buffer is NULL and length is not 0, hash_compute_hash_64 shall fail and return a non-zero value. ]*/
+    if (((buffer == NULL) && (length != 0)) ||
+        /* Codes_SRS_HASH_12_002: [ If hash is NULL, hash_compute_hash_64 shall fail and return a non-zero value. ]*/
+        (hash == NULL))
+    {
+        LogError("Invalid arguments: buffer=%p, length=%zu, hash=%p",
+            buffer, length, hash);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /* Codes_SRS_HASH_12_003: [ hash_compute_hash_64 shall fill in hash the 64-bit hash of the length bytes at buffer with seed 0 (the same value as hash_compute_hash_seeded with seed 0). ]*/
+        *hash = hash64_compute((const unsigned char*)buffer, length, 0);
+
+        /* Codes_SRS_HASH_12_004: [ On success hash_compute_hash_64 shall return 0. ]*/
+        result = 0;
+    }
+
+    return result;
+}
+
+int hash_compute_hash_seeded(const void* buffer, size_t length, uint64_t seed, uint64_t* hash)
+{
+    int result;
+
+    /* Codes_SRS_HASH_12_005: [ If buffer is NULL and length is not 0, hash_compute_hash_seeded shall fail and return a non-zero value. ]*/
+    if (((buffer == NULL) && (length != 0)) ||
+        /* Codes_SRS_HASH_12_006: [ If hash is NULL, hash_compute_hash_seeded shall fail and return a non-zero value. ]*/
+        (hash == NULL))
+    {
+        LogError("Invalid arguments: buffer=%p, length=%zu, seed=%" PRIu64 ", hash=%p",
+            buffer, length, seed, hash);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /* Codes_SRS_HASH_12_007: [ hash_compute_hash_seeded shall fill in hash the 64-bit hash of the length bytes at buffer with seed. ]*/
+        *hash = hash64_compute((const unsigned char*)buffer, length, seed);
+
+        /* Codes_SRS_HASH_12_008: [ On success hash_compute_hash_seeded shall return 0. ]*/
+        result = 0;
+    }
+
+    return result;
+}
+
+int hash_init(HASH_STATE* state, uint64_t seed)
+{
+    int result;
+
+    /* Codes_SRS_HASH_12_009: [ If state is NULL, hash_init shall fail and return a non-zero value. ]*/
+    if (state == NULL)
+    {
+        LogError("Invalid arguments: state=%p, seed=%" PRIu64,
+            state, seed);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /* Codes_SRS_HASH_12_010: [ hash_init shall initialize state for hashing 0 bytes with seed and return 0. ]*/
+        (void)memcpy(state->accumulators, hash64_initial_accumulators, sizeof(state->accumulators));
+        hash64_seed_secret(seed, state->secret);
+        state->seed = seed;
+        state->total_length = 0;
+        state->stripe_count = 0;
+        state->buffered_size = 0;
+        result = 0;
+    }
+
+    return result;
+}
+
+int hash_update(HASH_STATE* state, const void* buffer, size_t length)
+{
+    int result;
+
+    /* Codes_SRS_HASH_12_011: [ If state is NULL, hash_update shall fail and return a non-zero value. ]*/
+    if ((state == NULL) ||
+        /* Codes_SRS_HASH_12_012: [ If buffer is NULL and length is not 0, hash_update shall fail and return a non-zero value. ]*/
+        ((buffer == NULL) && (length != 0)))
+    {
+        LogError("Invalid arguments: state=%p, buffer=%p, length=%zu",
+            state, buffer, length);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /* Codes_SRS_HASH_12_013: [ hash_update shall add the length bytes at buffer to the bytes hashed by state and return 0. ]*/
+        const unsigned char* input = (const unsigned char*)buffer;
+        state->total_length += length;
+
+        if (length <= HASH_STATE_BUFFER_SIZE - state->buffered_size)
+        {
+            /*kept for later: the whole input might be short, which is hashed at once by hash_final*/
+            if (length > 0)
+            {
+                (void)memcpy(state->buffer + state->buffered_size, input, length);
+                state->buffered_size += length;
+            }
+        }
+        else
+        {
+            /*the input is long. Only stripes that end before the last byte received are accumulated, the last stripe is accumulated by hash_final*/
+            if (state->buffered_size > 0)
+            {
+                size_t fill_size = HASH_STATE_BUFFER_SIZE - state->buffered_size;
+                (void)memcpy(state->buffer + state->buffered_size, input, fill_size);
+                input += fill_size;
+                length -= fill_size;
+
+                hash64_accumulate(state->accumulators, state->buffer, HASH_STATE_BUFFER_SIZE / HASH64_STRIPE_SIZE, state->stripe_count, state->secret);
+                state->stripe_count += HASH_STATE_BUFFER_SIZE / HASH64_STRIPE_SIZE;
+                (void)memcpy(state->last_stripe, state->buffer + HASH_STATE_BUFFER_SIZE - HASH64_STRIPE_SIZE, HASH64_STRIPE_SIZE);
+            }
+
+            if (length > HASH_STATE_BUFFER_SIZE)
+            {
+                /*straight from the input, without copying it*/
+                size_t stripe_count = (length - 1) / HASH64_STRIPE_SIZE;
+                hash64_accumulate(state->accumulators, input, stripe_count, state->stripe_count, state->secret);
+                state->stripe_count += stripe_count;
+                input += stripe_count * HASH64_STRIPE_SIZE;
+                length -= stripe_count * HASH64_STRIPE_SIZE;
+                (void)memcpy(state->last_stripe, input - HASH64_STRIPE_SIZE, HASH64_STRIPE_SIZE);
+            }
+
+            /*1 to HASH_STATE_BUFFER_SIZE bytes are left*/
+            (void)memcpy(state->buffer, input, length);
+            state->buffered_size = length;
+        }
+
+        result = 0;
+    }
+
+    return result;
+}
+
+int hash_final(const HASH_STATE* state, uint64_t* hash)
+{
+    int result;
+
+    /* Codes_SRS_HASH_12_014: [ If state is NULL, hash_final shall fail and return a non-zero value. ]*/
+    if ((state == NULL) ||
+        /* Codes_SRS_HASH_12_015: [ If hash is NULL, hash_final shall fail and return a non-zero value. ]*/
+        (hash == NULL))
+    {
+        LogError("Invalid arguments: state=%p, hash=%p",
+            state, hash);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /* Codes_SRS_HASH_12_016: [ hash_final shall fill in hash the value that hash_compute_hash_seeded returns for all the bytes added to state (in order, regardless of how they were split in calls to hash_update) and the seed of state, and return 0. ]*/
+        /* Codes_SRS_HASH_12_017: [ hash_final shall not change state. ]*/
+        if (state->total_length <= HASH_STATE_BUFFER_SIZE)
+        {
+            *hash = hash64_short(state->buffer, (size_t)state->total_length, state->seed);
+        }
+        else
+        {
+            uint64_t accumulators[HASH64_LANE_COUNT];
+            unsigned char last_stripe[HASH64_STRIPE_SIZE];
+            const unsigned char* last_stripe_bytes;
+
+            (void)memcpy(accumulators, state->accumulators, sizeof(accumulators));
+            hash64_accumulate(accumulators, state->buffer, (state->buffered_size - 1) / HASH64_STRIPE_SIZE, state->stripe_count, state->secret);
+
+            if (state->buffered_size >= HASH64_STRIPE_SIZE)
+            {
+                last_stripe_bytes = state->buffer + state->buffered_size - HASH64_STRIPE_SIZE;
+            }
+            else
+            {
+                /*the last stripe starts in the bytes already accumulated*/
+                size_t accumulated_size = HASH64_STRIPE_SIZE - state->buffered_size;
+                (void)memcpy(last_stripe, state->last_stripe + state->buffered_size, accumulated_size);
+                (void)memcpy(last_stripe + accumulated_size, state->buffer, state->buffered_size);
+                last_stripe_bytes = last_stripe;
+            }
+
+            hash64_accumulate_stripe_scalar(accumulators, last_stripe_bytes, state->secret + HASH64_LAST_STRIPE_KEY_INDEX);
+            *hash = hash64_merge(accumulators, state->total_length, state->secret);
+        }
+        result = 0;
+    }
+
+    return result;
+}
+
+int hash_compute_hash_batch(const void* const* keys, const size_t* lengths, size_t count, uint32_t* hashes)
+{
+    int result;
+
+    /* Codes_SRS_HASH_12_018: [ If keys is NULL, hash_compute_hash_batch shall fail and return a non-zero value. ]*/
+    if ((keys == NULL) ||
+        /* Codes_SRS_HASH_12_019: [ If lengths is NULL, hash_compute_hash_batch shall fail and return a non-zero value. ]*/
+        (lengths == NULL) ||
+        /* Codes_SRS_HASH_12_020: [ If hashes is NULL, hash_compute_hash_batch shall fail and return a non-zero value. ]*/
+        (hashes == NULL))
+    {
+        LogError("Invalid arguments: keys=%p, lengths=%p, count=%zu, hashes=%p",
+            keys, lengths, count, hashes);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        size_t i;
+        for (i = 0; i < count; i++)
+        {
+            /* Codes_SRS_HASH_12_021: [ If any of the keys is NULL or any of the lengths is 0 or greater than or equal to INT_MAX, hash_compute_hash_batch shall fail and return a non-zero value. ]*/
+            if ((keys[i] == NULL) || (lengths[i] == 0) || (lengths[i] >= INT_MAX))
+            {
+                LogError("Invalid arguments: keys[%zu]=%p, lengths[%zu]=%zu",
+                    i, keys[i], i, lengths[i]);
+                break;
+            }
+        }
+
+        if (i != count)
+        {
+            result = MU_FAILURE;
+        }
+        else
+        {
+            /* Codes_SRS_HASH_12_022: [ hash_compute_hash_batch shall fill in hashes[i] the value that hash_compute_hash computes for keys[i] and lengths[i] (MurmurHash2 with seed 0), for every i less than count, mixing several keys at once in SIMD lanes when the CPU supports it. ]*/
+            hash_batch(keys, lengths, count, hashes);
+
+            /* Codes_SRS_HASH_12_023: [ On success hash_compute_hash_batch shall return 0. ]*/
+            result = 0;
+        }
+    }
+
+    return result;
+}
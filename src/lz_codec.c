@@ -0,0 +1,387 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "macro_utils/macro_utils.h"
+
+#include "c_logging/logger.h"
+
+#include "c_util/lz_codec.h"
+
+/*a sequence is: token (4 bits literal length, 4 bits match length - LZ_CODEC_MIN_MATCH), [literal length extra bytes], literals, 2 bytes little endian offset, [match length extra bytes].
+A length nibble of 15 is followed by bytes that are added to it, a byte of 255 means another byte follows. The last sequence only has literals.*/
+#define LZ_CODEC_MIN_MATCH 4
+#define LZ_CODEC_MAX_OFFSET 65535
+#define LZ_CODEC_LENGTH_NIBBLE_MAX 15
+/*the last LZ_CODEC_LAST_LITERALS bytes are always literals and no match starts in the last LZ_CODEC_MATCH_FIND_LIMIT bytes (same rules as LZ4, so the output can be read by LZ4 decoders)*/
+#define LZ_CODEC_LAST_LITERALS 5
+#define LZ_CODEC_MATCH_FIND_LIMIT 12
+
+/*4096 entries of uint32_t: 16KB of stack*/
+#define LZ_CODEC_HASH_LOG 12
+#define LZ_CODEC_HASH_SIZE (1 << LZ_CODEC_HASH_LOG)
+
+/*after 2^LZ_CODEC_SKIP_TRIGGER consecutive failed lookups the step between lookups grows by 1, so incompressible data is skipped over quickly*/
+#define LZ_CODEC_SKIP_TRIGGER 6
+
+static uint32_t lz_codec_read_32(const unsigned char* p)
+{
+    uint32_t result;
+    (void)memcpy(&result, p, sizeof(result));
+    return result;
+}
+
+static uint32_t lz_codec_hash(uint32_t sequence)
+{
+    /*Knuth's multiplicative hash, keeping the best mixed bits*/
+    return (sequence * 2654435761U) >> (32 - LZ_CODEC_HASH_LOG);
+}
+
+static uint32_t lz_codec_length_extra_bytes(uint32_t length)
+{
+    return (length < LZ_CODEC_LENGTH_NIBBLE_MAX) ? 0 : 1 + (length - LZ_CODEC_LENGTH_NIBBLE_MAX) / 255;
+}
+
+static unsigned char* lz_codec_write_length_extra_bytes(unsigned char* destination, uint32_t length)
+{
+    if (length >= LZ_CODEC_LENGTH_NIBBLE_MAX)
+    {
+        length -= LZ_CODEC_LENGTH_NIBBLE_MAX;
+        while (length >= 255)
+        {
+            *destination++ = 255;
+            length -= 255;
+        }
+        *destination++ = (unsigned char)length;
+    }
+    return destination;
+}
+
+/*writes one sequence, match_length is 0 for the last sequence. Returns NULL when the sequence does not fit before destination_end*/
+static unsigned char* lz_codec_write_sequence(unsigned char* destination, const unsigned char* destination_end, const unsigned char* literals, uint32_t literal_length, uint32_t offset, uint32_t match_length)
+{
+    unsigned char* result;
+    uint32_t match_code = (match_length == 0) ? 0 : match_length - LZ_CODEC_MIN_MATCH;
+    size_t needed = 1 + (size_t)lz_codec_length_extra_bytes(literal_length) + literal_length +
+        ((match_length == 0) ? 0 : 2 + (size_t)lz_codec_length_extra_bytes(match_code));
+
+    if ((size_t)(destination_end - destination) < needed)
+    {
+        result = NULL;
+    }
+    else
+    {
+        uint32_t literal_nibble = (literal_length < LZ_CODEC_LENGTH_NIBBLE_MAX) ? literal_length : LZ_CODEC_LENGTH_NIBBLE_MAX;
+        uint32_t match_nibble = (match_code < LZ_CODEC_LENGTH_NIBBLE_MAX) ? match_code : LZ_CODEC_LENGTH_NIBBLE_MAX;
+        *destination++ = (unsigned char)((literal_nibble << 4) | match_nibble);
+        destination = lz_codec_write_length_extra_bytes(destination, literal_length);
+        if (literal_length > 0)
+        {
+            (void)memcpy(destination, literals, literal_length);
+            destination += literal_length;
+        }
+
+        if (match_length != 0)
+        {
+            *destination++ = (unsigned char)(offset & 0xFF);
+            *destination++ = (unsigned char)(offset >> 8);
+            destination = lz_codec_write_length_extra_bytes(destination, match_code);
+        }
+        result = destination;
+    }
+    return result;
+}
+
+uint32_t lz_codec_compress_bound(uint32_t source_size)
+{
+    uint32_t result;
+    if (source_size > LZ_CODEC_MAX_INPUT_SIZE)
+    {
+        /*Codes_SRS_LZ_CODEC_12_001: [ If source_size is greater than LZ_CODEC_MAX_INPUT_SIZE then lz_codec_compress_bound shall fail and return 0. ]*/
+        LogError("invalid argument uint32_t source_size=%" PRIu32 " exceeds LZ_CODEC_MAX_INPUT_SIZE=%" PRIu32 "", source_size, LZ_CODEC_MAX_INPUT_SIZE);
+        result = 0;
+    }
+    else
+    {
+        /*Codes_SRS_LZ_CODEC_12_002: [ Otherwise lz_codec_compress_bound shall return source_size + source_size / 255 + 16. ]*/
+        result = source_size + source_size / 255 + 16;
+    }
+    return result;
+}
+
+int lz_codec_compress(const unsigned char* source, uint32_t source_size, unsigned char* destination, uint32_t destination_size, uint32_t* compressed_size)
+{
+    int result;
+    if (
+        /*Codes_SRS_LZ_CODEC_12_003: [ If source is NULL and source_size is not 0 then lz_codec_compress shall fail and return a non-zero value. ]*/
+        ((source == NULL) && (source_size != 0)) ||
+        /*Codes_SRS_LZ_CODEC_12_004: [ If destination is NULL then lz_codec_compress shall fail and return a non-zero value. ]*/
+        (destination == NULL) ||
+        /*Codes_SRS_LZ_CODEC_12_005: [ If compressed_size is NULL then lz_codec_compress shall fail and return a non-zero value. ]*/
+        (compressed_size == NULL)
+        )
+    {
+        LogError("invalid arguments const unsigned char* source=%p, uint32_t source_size=%" PRIu32 ", unsigned char* destination=%p, uint32_t destination_size=%" PRIu32 ", uint32_t* compressed_size=%p",
+            source, source_size, destination, destination_size, compressed_size);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        const unsigned char* destination_end = destination + destination_size;
+        unsigned char* out = destination;
+        uint32_t anchor = 0; /*first byte not yet written*/
+
+        /*Codes_SRS_LZ_CODEC_12_007: [ lz_codec_compress shall write the last 5 bytes of source as literals and shall not start a match in the last 12 bytes of source. ]*/
+        if (source_size > LZ_CODEC_MATCH_FIND_LIMIT)
+        {
+            /*Codes_SRS_LZ_CODEC_12_006: [ lz_codec_compress shall encode source as a sequence of literals and matches, finding the matches by looking up the previous occurrence of each 4 byte sequence (within the last 65535 bytes) in a hash table. ]*/
+            uint32_t hash_table[LZ_CODEC_HASH_SIZE] = { 0 }; /*position of the last 4 byte sequence that had this hash*/
+            uint32_t match_find_limit = source_size - LZ_CODEC_MATCH_FIND_LIMIT;
+            uint32_t match_extend_limit = source_size - LZ_CODEC_LAST_LITERALS;
+            uint32_t position = 1; /*position 0 is what every empty slot of the hash table points to*/
+            uint32_t failed_lookups = 0;
+
+            while (position < match_find_limit)
+            {
+                uint32_t sequence = lz_codec_read_32(source + position);
+                uint32_t hash = lz_codec_hash(sequence);
+                uint32_t candidate = hash_table[hash];
+                hash_table[hash] = position;
+
+                if (
+                    (position - candidate > LZ_CODEC_MAX_OFFSET) ||
+                    (lz_codec_read_32(source + candidate) != sequence)
+                    )
+                {
+                    position += 1 + (failed_lookups++ >> LZ_CODEC_SKIP_TRIGGER);
+                }
+                else
+                {
+                    uint32_t match_length;
+
+                    /*the match might have started before the position where it was found*/
+                    while (
+                        (position > anchor) &&
+                        (candidate > 0) &&
+                        (source[position - 1] == source[candidate - 1])
+                        )
+                    {
+                        position--;
+                        candidate--;
+                    }
+
+                    match_length = LZ_CODEC_MIN_MATCH;
+                    while (
+                        (position + match_length + sizeof(uint64_t) <= match_extend_limit) &&
+                        (memcmp(source + position + match_length, source + candidate + match_length, sizeof(uint64_t)) == 0)
+                        )
+                    {
+                        match_length += sizeof(uint64_t);
+                    }
+                    while (
+                        (position + match_length < match_extend_limit) &&
+                        (source[position + match_length] == source[candidate + match_length])
+                        )
+                    {
+                        match_length++;
+                    }
+
+                    out = lz_codec_write_sequence(out, destination_end, source + anchor, position - anchor, position - candidate, match_length);
+                    if (out == NULL)
+                    {
+                        break;
+                    }
+
+                    position += match_length;
+                    anchor = position;
+                    failed_lookups = 0;
+
+                    /*the position just before the end of the match is likely to start the next match*/
+                    if (position < match_find_limit)
+                    {
+                        hash_table[lz_codec_hash(lz_codec_read_32(source + position - 2))] = position - 2;
+                    }
+                }
+            }
+        }
+
+        if (out != NULL)
+        {
+            out = lz_codec_write_sequence(out, destination_end, source + anchor, source_size - anchor, 0, 0);
+        }
+
+        if (out == NULL)
+        {
+            /*Codes_SRS_LZ_CODEC_12_008: [ If destination_size is not enough to hold the compressed bytes then lz_codec_compress shall fail and return a non-zero value. ]*/
+            LogError("destination_size=%" PRIu32 " is not enough to compress source_size=%" PRIu32 " bytes (lz_codec_compress_bound would have been %" PRIu32 ")",
+                destination_size, source_size, lz_codec_compress_bound(source_size));
+            result = MU_FAILURE;
+        }
+        else
+        {
+            /*Codes_SRS_LZ_CODEC_12_009: [ lz_codec_compress shall succeed, write in compressed_size the number of bytes written in destination and return 0. ]*/
+            *compressed_size = (uint32_t)(out - destination);
+            result = 0;
+        }
+    }
+    return result;
+}
+
+/*adds the extra bytes of a length whose nibble was 15 to length. Returns false when source ends before the length does or when the length exceeds limit*/
+static bool lz_codec_read_length_extra_bytes(const unsigned char** in, const unsigned char* source_end, uint32_t limit, uint32_t* length)
+{
+    bool result = false;
+    uint64_t value = *length;
+    while (*in < source_end)
+    {
+        unsigned char byte = *(*in)++;
+        value += byte;
+        if (value > limit)
+        {
+            break;
+        }
+        if (byte != 255)
+        {
+            *length = (uint32_t)value;
+            result = true;
+            break;
+        }
+    }
+    return result;
+}
+
+int lz_codec_decompress(const unsigned char* source, uint32_t source_size, unsigned char* destination, uint32_t destination_size)
+{
+    int result;
+    if (
+        /*Codes_SRS_LZ_CODEC_12_010: [ If source is NULL then lz_codec_decompress shall fail and return a non-zero value. ]*/
+        (source == NULL) ||
+        /*Codes_SRS_LZ_CODEC_12_011: [ If destination is NULL and destination_size is not 0 then lz_codec_decompress shall fail and return a non-zero value. ]*/
+        ((destination == NULL) && (destination_size != 0))
+        )
+    {
+        LogError("invalid arguments const unsigned char* source=%p, uint32_t source_size=%" PRIu32 ", unsigned char* destination=%p, uint32_t destination_size=%" PRIu32 "",
+            source, source_size, destination, destination_size);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        const unsigned char* in = source;
+        const unsigned char* source_end = source + source_size;
+        uint32_t written = 0;
+
+        /*Codes_SRS_LZ_CODEC_12_012: [ lz_codec_decompress shall decode the sequences in source, copying the literals and the matches in destination. ]*/
+        result = MU_FAILURE;
+        if (source_size == 0)
+        {
+            /*Codes_SRS_LZ_CODEC_12_013: [ If a sequence is truncated, has literals or a match that do not fit in destination_size bytes or has an offset of 0 or before the start of destination then lz_codec_decompress shall fail and return a non-zero value. ]*/
+            LogError("there are no compressed bytes, even an empty source compresses to 1 byte");
+        }
+        while (in < source_end)
+        {
+            unsigned char token = *in++;
+            uint32_t literal_length = token >> 4;
+            uint32_t match_length = token & LZ_CODEC_LENGTH_NIBBLE_MAX;
+            uint32_t offset;
+
+            /*Codes_SRS_LZ_CODEC_12_013: [ If a sequence is truncated, has literals or a match that do not fit in destination_size bytes or has an offset of 0 or before the start of destination then lz_codec_decompress shall fail and return a non-zero value. ]*/
+            if (
+                (literal_length == LZ_CODEC_LENGTH_NIBBLE_MAX) &&
+                !lz_codec_read_length_extra_bytes(&in, source_end, destination_size, &literal_length)
+                )
+            {
+                LogError("invalid literal length at byte %td of the compressed bytes", in - source);
+                break;
+            }
+
+            if (
+                (literal_length > (size_t)(source_end - in)) ||
+                (literal_length > destination_size - written)
+                )
+            {
+                LogError("literal length=%" PRIu32 " at byte %td of the compressed bytes exceeds the source or the destination (%" PRIu32 " bytes written out of %" PRIu32 ")",
+                    literal_length, in - source, written, destination_size);
+                break;
+            }
+
+            if (literal_length > 0)
+            {
+                (void)memcpy(destination + written, in, literal_length);
+                in += literal_length;
+                written += literal_length;
+            }
+
+            if (in == source_end)
+            {
+                /*the last sequence has no match*/
+                /*Codes_SRS_LZ_CODEC_12_014: [ If the number of decoded bytes is not destination_size then lz_codec_decompress shall fail and return a non-zero value. ]*/
+                if (written != destination_size)
+                {
+                    LogError("compressed bytes decode to %" PRIu32 " bytes, expected destination_size=%" PRIu32 "", written, destination_size);
+                }
+                else
+                {
+                    /*Codes_SRS_LZ_CODEC_12_015: [ lz_codec_decompress shall succeed and return 0. ]*/
+                    result = 0;
+                }
+                break;
+            }
+
+            if (source_end - in < 2)
+            {
+                LogError("truncated offset at byte %td of the compressed bytes", in - source);
+                break;
+            }
+            offset = (uint32_t)in[0] | ((uint32_t)in[1] << 8);
+            in += 2;
+
+            if (
+                (offset == 0) ||
+                (offset > written)
+                )
+            {
+                LogError("invalid offset=%" PRIu32 " at byte %td of the compressed bytes (%" PRIu32 " bytes written)", offset, in - source, written);
+                break;
+            }
+
+            if (
+                (match_length == LZ_CODEC_LENGTH_NIBBLE_MAX) &&
+                !lz_codec_read_length_extra_bytes(&in, source_end, destination_size, &match_length)
+                )
+            {
+                LogError("invalid match length at byte %td of the compressed bytes", in - source);
+                break;
+            }
+
+            /*checked before adding LZ_CODEC_MIN_MATCH, match_length can be up to destination_size and the addition would wrap*/
+            if (
+                (match_length > destination_size - written) ||
+                (destination_size - written - match_length < LZ_CODEC_MIN_MATCH)
+                )
+            {
+                LogError("match length=%" PRIu32 " + %d exceeds destination (%" PRIu32 " bytes written out of %" PRIu32 ")", match_length, LZ_CODEC_MIN_MATCH, written, destination_size);
+                break;
+            }
+            match_length += LZ_CODEC_MIN_MATCH;
+
+            /*when the match overlaps the bytes it produces (offset < match_length) it repeats the last offset bytes. All the copies read from match_source
+            and do not overlap: each one doubles the distance between match_source and the write position (offset, 2 * offset, 4 * offset...),
+            so a run of 1 byte takes log2(match_length) memcpy calls instead of match_length*/
+            const unsigned char* match_source = destination + written - offset;
+            while (match_length > 0)
+            {
+                uint32_t available = (uint32_t)((destination + written) - match_source);
+                uint32_t chunk = (match_length < available) ? match_length : available;
+                (void)memcpy(destination + written, match_source, chunk);
+                written += chunk;
+                match_length -= chunk;
+            }
+        }
+    }
+    return result;
+}
@@ -0,0 +1,184 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdint.h>
+#include <inttypes.h>
+
+#include "windows.h"
+
+#include "macro_utils/macro_utils.h"
+
+#include "c_logging/logger.h"
+
+#include "c_util/memory_mapped_file.h"
+
+MU_DEFINE_ENUM_STRINGS(MEMORY_MAPPED_FILE_ACCESS_HINT, MEMORY_MAPPED_FILE_ACCESS_HINT_VALUES);
+
+int memory_mapped_file_map(const char* file_name, uint64_t offset, uint32_t size, MEMORY_MAPPED_FILE_ACCESS_HINT hint, MEMORY_MAPPED_FILE_VIEW* view)
+{
+    int result;
+    if (
+        /*Codes_SRS_MEMORY_MAPPED_FILE_12_001: [ If file_name is NULL then memory_mapped_file_map shall fail and return a non-zero value. ]*/
+        (file_name == NULL) ||
+        /*Codes_SRS_MEMORY_MAPPED_FILE_12_002: [ If hint is not a valid MEMORY_MAPPED_FILE_ACCESS_HINT then memory_mapped_file_map shall fail and return a non-zero value. ]*/
+        ((int)hint < (int)MEMORY_MAPPED_FILE_ACCESS_HINT_NORMAL) ||
+        ((int)hint > (int)MEMORY_MAPPED_FILE_ACCESS_HINT_WILLNEED) ||
+        /*Codes_SRS_MEMORY_MAPPED_FILE_12_003: [ If view is NULL then memory_mapped_file_map shall fail and return a non-zero value. ]*/
+        (view == NULL)
+        )
+    {
+        LogError("invalid arguments const char* file_name=%s, uint64_t offset=%" PRIu64 ", uint32_t size=%" PRIu32 ", MEMORY_MAPPED_FILE_ACCESS_HINT hint=%" PRI_MU_ENUM ", MEMORY_MAPPED_FILE_VIEW* view=%p",
+            MU_P_OR_NULL(file_name), offset, size, MU_ENUM_VALUE(MEMORY_MAPPED_FILE_ACCESS_HINT, hint), view);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        DWORD flags_and_attributes = FILE_ATTRIBUTE_NORMAL;
+        if (hint == MEMORY_MAPPED_FILE_ACCESS_HINT_SEQUENTIAL)
+        {
+            flags_and_attributes |= FILE_FLAG_SEQUENTIAL_SCAN;
+        }
+        else if (hint == MEMORY_MAPPED_FILE_ACCESS_HINT_RANDOM)
+        {
+            flags_and_attributes |= FILE_FLAG_RANDOM_ACCESS;
+        }
+        else
+        {
+            /*nothing to add*/
+        }
+
+        /*Codes_SRS_MEMORY_MAPPED_FILE_12_004: [ memory_mapped_file_map shall open file_name for reading. ]*/
+        HANDLE file = CreateFileA(file_name, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, flags_and_attributes, NULL);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            /*Codes_SRS_MEMORY_MAPPED_FILE_12_014: [ If there are any failures then memory_mapped_file_map shall fail and return a non-zero value. ]*/
+            LogLastError("failure in CreateFileA(file_name=%s, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, flags_and_attributes=%" PRIu32 ", NULL)", file_name, (uint32_t)flags_and_attributes);
+            result = MU_FAILURE;
+        }
+        else
+        {
+            LARGE_INTEGER file_size_li;
+            /*Codes_SRS_MEMORY_MAPPED_FILE_12_005: [ memory_mapped_file_map shall get the size of the file. ]*/
+            if (!GetFileSizeEx(file, &file_size_li))
+            {
+                /*Codes_SRS_MEMORY_MAPPED_FILE_12_014: [ If there are any failures then memory_mapped_file_map shall fail and return a non-zero value. ]*/
+                LogLastError("failure in GetFileSizeEx(file=%p)", file);
+                result = MU_FAILURE;
+            }
+            else
+            {
+                uint64_t file_size = (uint64_t)file_size_li.QuadPart;
+                uint64_t content_size = (size == 0) ? (offset <= file_size ? file_size - offset : 0) : size;
+
+                if (
+                    /*Codes_SRS_MEMORY_MAPPED_FILE_12_006: [ If offset is greater than the size of the file then memory_mapped_file_map shall fail and return a non-zero value. ]*/
+                    (offset > file_size) ||
+                    /*Codes_SRS_MEMORY_MAPPED_FILE_12_007: [ If offset + size exceeds the size of the file then memory_mapped_file_map shall fail and return a non-zero value. ]*/
+                    (content_size > file_size - offset) ||
+                    /*Codes_SRS_MEMORY_MAPPED_FILE_12_008: [ If size is 0 and the number of bytes from offset to the end of the file exceeds UINT32_MAX then memory_mapped_file_map shall fail and return a non-zero value. ]*/
+                    (content_size > UINT32_MAX)
+                    )
+                {
+                    LogError("cannot map offset=%" PRIu64 ", size=%" PRIu32 " of file %s which has %" PRIu64 " bytes",
+                        offset, size, file_name, file_size);
+                    result = MU_FAILURE;
+                }
+                else if (content_size == 0)
+                {
+                    /*Codes_SRS_MEMORY_MAPPED_FILE_12_009: [ If the range to map has 0 bytes then memory_mapped_file_map shall set view to an empty view, succeed and return 0. ]*/
+                    view->mapping_base = NULL;
+                    view->mapping_size = 0;
+                    view->content = NULL;
+                    view->content_size = 0;
+                    result = 0;
+                }
+                else
+                {
+                    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+                    if (mapping == NULL)
+                    {
+                        /*Codes_SRS_MEMORY_MAPPED_FILE_12_014: [ If there are any failures then memory_mapped_file_map shall fail and return a non-zero value. ]*/
+                        LogLastError("failure in CreateFileMappingA(file=%p, NULL, PAGE_READONLY, 0, 0, NULL)", file);
+                        result = MU_FAILURE;
+                    }
+                    else
+                    {
+                        /*Codes_SRS_MEMORY_MAPPED_FILE_12_010: [ memory_mapped_file_map shall map the file read-only and shared starting from offset rounded down to the OS mapping granularity. ]*/
+                        SYSTEM_INFO system_info;
+                        GetSystemInfo(&system_info);
+                        uint64_t granularity = system_info.dwAllocationGranularity;
+                        uint64_t delta = offset % granularity;
+                        uint64_t mapping_offset = offset - delta;
+                        size_t mapping_size = (size_t)(delta + content_size);
+                        void* mapping_base = MapViewOfFile(mapping, FILE_MAP_READ, (DWORD)(mapping_offset >> 32), (DWORD)(mapping_offset & 0xFFFFFFFF), mapping_size);
+                        if (mapping_base == NULL)
+                        {
+                            /*Codes_SRS_MEMORY_MAPPED_FILE_12_014: [ If there are any failures then memory_mapped_file_map shall fail and return a non-zero value. ]*/
+                            LogLastError("failure in MapViewOfFile(mapping=%p, FILE_MAP_READ, mapping_offset=%" PRIu64 ", mapping_size=%zu)", mapping, mapping_offset, mapping_size);
+                            result = MU_FAILURE;
+                        }
+                        else
+                        {
+                            /*Codes_SRS_MEMORY_MAPPED_FILE_12_011: [ memory_mapped_file_map shall pass hint to the OS (madvise on Linux, file flags and PrefetchVirtualMemory on Windows). A failure to apply the hint shall not fail memory_mapped_file_map. ]*/
+                            if (hint == MEMORY_MAPPED_FILE_ACCESS_HINT_WILLNEED)
+                            {
+                                WIN32_MEMORY_RANGE_ENTRY range;
+                                range.VirtualAddress = mapping_base;
+                                range.NumberOfBytes = mapping_size;
+                                if (!PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0))
+                                {
+                                    LogWarning("failure in PrefetchVirtualMemory(mapping_base=%p, mapping_size=%zu)", mapping_base, mapping_size);
+                                }
+                            }
+
+                            /*Codes_SRS_MEMORY_MAPPED_FILE_12_012: [ memory_mapped_file_map shall fill view with the mapping and the address and size of the requested range, succeed and return 0. ]*/
+                            view->mapping_base = mapping_base;
+                            view->mapping_size = mapping_size;
+                            view->content = (const unsigned char*)mapping_base + delta;
+                            view->content_size = (uint32_t)content_size;
+                            result = 0;
+                        }
+
+                        /*the view keeps the mapping alive*/
+                        if (!CloseHandle(mapping))
+                        {
+                            LogLastError("failure in CloseHandle(mapping=%p)", mapping);
+                        }
+                    }
+                }
+            }
+
+            /*Codes_SRS_MEMORY_MAPPED_FILE_12_013: [ memory_mapped_file_map shall close the file. ]*/
+            if (!CloseHandle(file))
+            {
+                LogLastError("failure in CloseHandle(file=%p)", file);
+            }
+        }
+    }
+    return result;
+}
+
+void memory_mapped_file_unmap(MEMORY_MAPPED_FILE_VIEW* view)
+{
+    if (view == NULL)
+    {
+        /*Codes_SRS_MEMORY_MAPPED_FILE_12_015: [ If view is NULL then memory_mapped_file_unmap shall return. ]*/
+        LogError("invalid argument MEMORY_MAPPED_FILE_VIEW* view=%p", view);
+    }
+    else
+    {
+        /*Codes_SRS_MEMORY_MAPPED_FILE_12_016: [ If view is empty then memory_mapped_file_unmap shall return. ]*/
+        if (view->mapping_base != NULL)
+        {
+            /*Codes_SRS_MEMORY_MAPPED_FILE_12_017: [ memory_mapped_file_unmap shall unmap the view. ]*/
+            if (!UnmapViewOfFile(view->mapping_base))
+            {
+                LogLastError("failure in UnmapViewOfFile(view->mapping_base=%p)", view->mapping_base);
+            }
+            view->mapping_base = NULL;
+            view->mapping_size = 0;
+            view->content = NULL;
+            view->content_size = 0;
+        }
+    }
+}
@@ -0,0 +1,74 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "constbuffer_accounting_disabled_ut_pch.h"
+
+MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    ASSERT_FAIL("umock_c reported error :%" PRI_MU_ENUM "", MU_ENUM_VALUE(UMOCK_C_ERROR_CODE, error_code));
+}
+
+BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
+
+TEST_SUITE_INITIALIZE(a)
+{
+    umock_c_init(on_umock_c_error);
+
+    (void)umocktypes_stdint_register_types();
+}
+
+TEST_SUITE_CLEANUP(b)
+{
+    umock_c_deinit();
+}
+
+TEST_FUNCTION_INITIALIZE(c)
+{
+    umock_c_reset_all_calls();
+}
+
+TEST_FUNCTION_CLEANUP(d)
+{
+}
+
+/* constbuffer_accounting_get_snapshot */
+
+/*Tests_SRS_CONSTBUFFER_ACCOUNTING_12_001: [ If snapshot is NULL then constbuffer_accounting_get_snapshot shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_accounting_get_snapshot_with_NULL_snapshot_fails)
+{
+    ///act
+    int result = constbuffer_accounting_get_snapshot(NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_ACCOUNTING_12_002: [ If the accounting is compiled out then constbuffer_accounting_get_snapshot shall set is_enabled to false and all the counters to 0. ]*/
+/*Tests_SRS_CONSTBUFFER_ACCOUNTING_12_008: [ constbuffer_accounting_get_snapshot shall succeed and return 0. ]*/
+TEST_FUNCTION(constbuffer_accounting_get_snapshot_sets_is_enabled_to_false_and_all_the_counters_to_0)
+{
+    ///arrange
+    CONSTBUFFER_ACCOUNTING_SNAPSHOT snapshot;
+    (void)memset(&snapshot, 0xFF, sizeof(snapshot));
+
+    ///act
+    int result = constbuffer_accounting_get_snapshot(&snapshot);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_FALSE(snapshot.is_enabled);
+    for (uint32_t i = 0; i < CONSTBUFFER_ACCOUNTING_TYPE_COUNT; i++)
+    {
+        ASSERT_ARE_EQUAL(int64_t, 0, snapshot.by_type[i].live_handles);
+        ASSERT_ARE_EQUAL(int64_t, 0, snapshot.by_type[i].live_bytes);
+    }
+    for (uint32_t i = 0; i < CONSTBUFFER_ACCOUNTING_HISTOGRAM_BUCKET_COUNT; i++)
+    {
+        ASSERT_ARE_EQUAL(int64_t, 0, snapshot.size_histogram[i]);
+    }
+}
+
+END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
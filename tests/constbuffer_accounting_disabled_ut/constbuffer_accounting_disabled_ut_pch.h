@@ -0,0 +1,23 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+// Precompiled header for constbuffer_accounting_disabled_ut
+
+#ifndef CONSTBUFFER_ACCOUNTING_DISABLED_UT_PCH_H
+#define CONSTBUFFER_ACCOUNTING_DISABLED_UT_PCH_H
+
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "macro_utils/macro_utils.h"
+#include "testrunnerswitcher.h"
+
+#include "umock_c/umock_c.h"
+#include "umock_c/umocktypes_stdint.h"
+
+#include "c_util/constbuffer_accounting.h"
+
+#endif // CONSTBUFFER_ACCOUNTING_DISABLED_UT_PCH_H
@@ -0,0 +1,1112 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "constbuffer_accounting_hooks_ut_pch.h"
+
+/*the real constbuffer.c, constbuffer_array.c and constbuffer_accounting.c are tested together, compiled with CONSTBUFFER_ACCOUNTING. The calls they make are
+checked by constbuffer_ut and constbuffer_array_ut, these tests only check what the snapshot says after every create, failure and free path*/
+
+MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    ASSERT_FAIL("umock_c reported error :%" PRI_MU_ENUM "", MU_ENUM_VALUE(UMOCK_C_ERROR_CODE, error_code));
+}
+
+TEST_DEFINE_ENUM_TYPE(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_VALUES)
+
+MU_DEFINE_ENUM_STRINGS(MEMORY_MAPPED_FILE_ACCESS_HINT, MEMORY_MAPPED_FILE_ACCESS_HINT_VALUES)
+IMPLEMENT_UMOCK_C_ENUM_TYPE(MEMORY_MAPPED_FILE_ACCESS_HINT, MEMORY_MAPPED_FILE_ACCESS_HINT_VALUES)
+
+static const char* buffer1 = "le buffer no 1";
+
+#define BUFFER1_HANDLE (BUFFER_HANDLE)1
+#define BUFFER1_u_char ((unsigned char*)buffer1)
+#define BUFFER1_length (uint32_t)strlen(buffer1)
+
+static unsigned char* my_BUFFER_u_char(BUFFER_HANDLE handle)
+{
+    ASSERT_ARE_EQUAL(void_ptr, BUFFER1_HANDLE, handle);
+    return BUFFER1_u_char;
+}
+
+static size_t my_BUFFER_length(BUFFER_HANDLE handle)
+{
+    ASSERT_ARE_EQUAL(void_ptr, BUFFER1_HANDLE, handle);
+    return BUFFER1_length;
+}
+
+static const unsigned char test_mapped_content[] = { 'm', 'a', 'p', 'p', 'e', 'd' };
+#define TEST_MAPPING_BASE (void*)0x4201
+
+static int my_memory_mapped_file_map(const char* file_name, uint64_t offset, uint32_t size, MEMORY_MAPPED_FILE_ACCESS_HINT hint, MEMORY_MAPPED_FILE_VIEW* view)
+{
+    (void)file_name;
+    (void)offset;
+    (void)size;
+    (void)hint;
+    view->mapping_base = TEST_MAPPING_BASE;
+    view->mapping_size = sizeof(test_mapped_content);
+    view->content = test_mapped_content;
+    view->content_size = sizeof(test_mapped_content);
+    return 0;
+}
+
+static void test_free_func(void* context)
+{
+    (void)context;
+}
+
+/*2 serialized const buffers (version 1) that follow each other: { 0x42 } and { 0x43, 0x44 }*/
+static const unsigned char two_serialized_buffers[] = { 1, 0, 0, 0, 1, 0x42, 1, 0, 0, 0, 2, 0x43, 0x44 };
+
+/*the counters are global, so every test releases what it creates and the snapshot is all 0 between tests*/
+static void assert_snapshot_is_empty(void)
+{
+    CONSTBUFFER_ACCOUNTING_SNAPSHOT snapshot;
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_accounting_get_snapshot(&snapshot));
+    ASSERT_IS_TRUE(snapshot.is_enabled);
+    for (uint32_t i = 0; i < CONSTBUFFER_ACCOUNTING_TYPE_COUNT; i++)
+    {
+        ASSERT_ARE_EQUAL(int64_t, 0, snapshot.by_type[i].live_handles, "%" PRI_MU_ENUM "", MU_ENUM_VALUE(CONSTBUFFER_ACCOUNTING_TYPE, (CONSTBUFFER_ACCOUNTING_TYPE)i));
+        ASSERT_ARE_EQUAL(int64_t, 0, snapshot.by_type[i].live_bytes, "%" PRI_MU_ENUM "", MU_ENUM_VALUE(CONSTBUFFER_ACCOUNTING_TYPE, (CONSTBUFFER_ACCOUNTING_TYPE)i));
+    }
+    for (uint32_t i = 0; i < CONSTBUFFER_ACCOUNTING_HISTOGRAM_BUCKET_COUNT; i++)
+    {
+        ASSERT_ARE_EQUAL(int64_t, 0, snapshot.size_histogram[i]);
+    }
+}
+
+static void assert_live(CONSTBUFFER_ACCOUNTING_TYPE type, int64_t live_handles, int64_t live_bytes)
+{
+    CONSTBUFFER_ACCOUNTING_SNAPSHOT snapshot;
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_accounting_get_snapshot(&snapshot));
+    ASSERT_ARE_EQUAL(int64_t, live_handles, snapshot.by_type[type].live_handles, "%" PRI_MU_ENUM "", MU_ENUM_VALUE(CONSTBUFFER_ACCOUNTING_TYPE, type));
+    ASSERT_ARE_EQUAL(int64_t, live_bytes, snapshot.by_type[type].live_bytes, "%" PRI_MU_ENUM "", MU_ENUM_VALUE(CONSTBUFFER_ACCOUNTING_TYPE, type));
+}
+
+static void assert_live_arrays(int64_t live_handles, int64_t live_bytes)
+{
+    CONSTBUFFER_ACCOUNTING_SNAPSHOT snapshot;
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_accounting_get_snapshot(&snapshot));
+    ASSERT_ARE_EQUAL(int64_t, live_handles, snapshot.by_type[CONSTBUFFER_ACCOUNTING_TYPE_ARRAY].live_handles);
+    ASSERT_ARE_EQUAL(int64_t, live_bytes, snapshot.by_type[CONSTBUFFER_ACCOUNTING_TYPE_ARRAY].live_bytes);
+}
+
+/*the size of CONSTBUFFER_ARRAY_HANDLE_DATA is private to constbuffer_array.c, an empty array is accounted with exactly that size*/
+static int64_t get_array_handle_size(void)
+{
+    CONSTBUFFER_ACCOUNTING_SNAPSHOT snapshot;
+    CONSTBUFFER_ARRAY_HANDLE empty = constbuffer_array_create_empty();
+    ASSERT_IS_NOT_NULL(empty);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_accounting_get_snapshot(&snapshot));
+    constbuffer_array_dec_ref(empty);
+    ASSERT_ARE_EQUAL(int64_t, 1, snapshot.by_type[CONSTBUFFER_ACCOUNTING_TYPE_ARRAY].live_handles);
+    ASSERT_IS_TRUE(snapshot.by_type[CONSTBUFFER_ACCOUNTING_TYPE_ARRAY].live_bytes > 0);
+    return snapshot.by_type[CONSTBUFFER_ACCOUNTING_TYPE_ARRAY].live_bytes;
+}
+
+/*2 buffers of 2 and 3 bytes (5 bytes of COPIED buffers)*/
+static void create_two_buffers(CONSTBUFFER_HANDLE buffers[2])
+{
+    buffers[0] = CONSTBUFFER_Create((const unsigned char*)"ab", 2);
+    ASSERT_IS_NOT_NULL(buffers[0]);
+    buffers[1] = CONSTBUFFER_Create((const unsigned char*)"cde", 3);
+    ASSERT_IS_NOT_NULL(buffers[1]);
+}
+
+static void release_two_buffers(CONSTBUFFER_HANDLE buffers[2])
+{
+    CONSTBUFFER_DecRef(buffers[0]);
+    CONSTBUFFER_DecRef(buffers[1]);
+}
+
+BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
+
+TEST_SUITE_INITIALIZE(a)
+{
+    ASSERT_ARE_EQUAL(int, 0, real_gballoc_hl_init(NULL, NULL));
+
+    ASSERT_ARE_EQUAL(int, 0, umock_c_init(on_umock_c_error));
+    ASSERT_ARE_EQUAL(int, 0, umocktypes_stdint_register_types());
+
+    REGISTER_UMOCK_ALIAS_TYPE(BUFFER_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(MEMORY_MAPPED_FILE_VIEW*, void*);
+    REGISTER_TYPE(MEMORY_MAPPED_FILE_ACCESS_HINT, MEMORY_MAPPED_FILE_ACCESS_HINT);
+
+    REGISTER_GBALLOC_HL_GLOBAL_MOCK_HOOK();
+    REGISTER_GLOBAL_MOCK_HOOK(BUFFER_u_char, my_BUFFER_u_char);
+    REGISTER_GLOBAL_MOCK_HOOK(BUFFER_length, my_BUFFER_length);
+    REGISTER_GLOBAL_MOCK_HOOK(memory_mapped_file_map, my_memory_mapped_file_map);
+}
+
+TEST_SUITE_CLEANUP(b)
+{
+    umock_c_deinit();
+
+    real_gballoc_hl_deinit();
+}
+
+TEST_FUNCTION_INITIALIZE(c)
+{
+    umock_c_reset_all_calls();
+}
+
+TEST_FUNCTION_CLEANUP(d)
+{
+    assert_snapshot_is_empty();
+}
+
+/* CONSTBUFFER_Create */
+
+/*Tests_SRS_CONSTBUFFER_12_111: [ If CONSTBUFFER_ACCOUNTING is defined then every function that produces a CONSTBUFFER_HANDLE or a CONSTBUFFER_WRITABLE_HANDLE shall call constbuffer_accounting_add with the type of the handle and its size. ]*/
+/*Tests_SRS_CONSTBUFFER_12_112: [ If CONSTBUFFER_ACCOUNTING is defined then CONSTBUFFER_DecRef and CONSTBUFFER_WritableHandleDecRef shall call constbuffer_accounting_remove with the type of the handle and its size when the ref count reaches 0. ]*/
+TEST_FUNCTION(CONSTBUFFER_Create_accounts_a_COPIED_buffer_until_the_last_DecRef)
+{
+    ///act
+    CONSTBUFFER_HANDLE handle = CONSTBUFFER_Create((const unsigned char*)"abc", 3);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(handle);
+    assert_live(CONSTBUFFER_ACCOUNTING_TYPE_COPIED, 1, 3);
+
+    CONSTBUFFER_IncRef(handle);
+    CONSTBUFFER_DecRef(handle);
+    assert_live(CONSTBUFFER_ACCOUNTING_TYPE_COPIED, 1, 3);
+
+    ///clean
+    CONSTBUFFER_DecRef(handle);
+}
+
+/*Tests_SRS_CONSTBUFFER_12_111: [ If CONSTBUFFER_ACCOUNTING is defined then every function that produces a CONSTBUFFER_HANDLE or a CONSTBUFFER_WRITABLE_HANDLE shall call constbuffer_accounting_add with the type of the handle and its size. ]*/
+TEST_FUNCTION(CONSTBUFFER_Create_with_size_0_accounts_an_empty_COPIED_buffer)
+{
+    ///act
+    CONSTBUFFER_HANDLE handle = CONSTBUFFER_Create(NULL, 0);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(handle);
+    assert_live(CONSTBUFFER_ACCOUNTING_TYPE_COPIED, 1, 0);
+
+    ///clean
+    CONSTBUFFER_DecRef(handle);
+}
+
+TEST_FUNCTION(when_malloc_flex_fails_CONSTBUFFER_Create_accounts_nothing)
+{
+    ///arrange
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .SetReturn(NULL);
+
+    ///act
+    CONSTBUFFER_HANDLE handle = CONSTBUFFER_Create((const unsigned char*)"abc", 3);
+
+    ///assert
+    ASSERT_IS_NULL(handle);
+}
+
+/* CONSTBUFFER_CreateFromBuffer */
+
+/*Tests_SRS_CONSTBUFFER_12_111: [ If CONSTBUFFER_ACCOUNTING is defined then every function that produces a CONSTBUFFER_HANDLE or a CONSTBUFFER_WRITABLE_HANDLE shall call constbuffer_accounting_add with the type of the handle and its size. ]*/
+TEST_FUNCTION(CONSTBUFFER_CreateFromBuffer_accounts_a_COPIED_buffer)
+{
+    ///act
+    CONSTBUFFER_HANDLE handle = CONSTBUFFER_CreateFromBuffer(BUFFER1_HANDLE);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(handle);
+    assert_live(CONSTBUFFER_ACCOUNTING_TYPE_COPIED, 1, BUFFER1_length);
+
+    ///clean
+    CONSTBUFFER_DecRef(handle);
+}
+
+/* CONSTBUFFER_CreateWithMoveMemory */
+
+/*Tests_SRS_CONSTBUFFER_12_111: [ If CONSTBUFFER_ACCOUNTING is defined then every function that produces a CONSTBUFFER_HANDLE or a CONSTBUFFER_WRITABLE_HANDLE shall call constbuffer_accounting_add with the type of the handle and its size. ]*/
+/*Tests_SRS_CONSTBUFFER_12_112: [ If CONSTBUFFER_ACCOUNTING is defined then CONSTBUFFER_DecRef and CONSTBUFFER_WritableHandleDecRef shall call constbuffer_accounting_remove with the type of the handle and its size when the ref count reaches 0. ]*/
+TEST_FUNCTION(CONSTBUFFER_CreateWithMoveMemory_accounts_a_MEMORY_MOVED_buffer)
+{
+    ///arrange
+    unsigned char* memory = malloc(4);
+    ASSERT_IS_NOT_NULL(memory);
+    (void)memcpy(memory, "abcd", 4);
+
+    ///act
+    CONSTBUFFER_HANDLE handle = CONSTBUFFER_CreateWithMoveMemory(memory, 4);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(handle);
+    assert_live(CONSTBUFFER_ACCOUNTING_TYPE_MEMORY_MOVED, 1, 4);
+
+    ///clean
+    CONSTBUFFER_DecRef(handle);
+}
+
+TEST_FUNCTION(when_malloc_fails_CONSTBUFFER_CreateWithMoveMemory_accounts_nothing)
+{
+    ///arrange
+    unsigned char memory[4] = { 'a', 'b', 'c', 'd' };
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG))
+        .SetReturn(NULL);
+
+    ///act
+    CONSTBUFFER_HANDLE handle = CONSTBUFFER_CreateWithMoveMemory(memory, sizeof(memory));
+
+    ///assert
+    ASSERT_IS_NULL(handle);
+}
+
+/* CONSTBUFFER_CreateWithCustomFree */
+
+/*Tests_SRS_CONSTBUFFER_12_111: [ If CONSTBUFFER_ACCOUNTING is defined then every function that produces a CONSTBUFFER_HANDLE or a CONSTBUFFER_WRITABLE_HANDLE shall call constbuffer_accounting_add with the type of the handle and its size. ]*/
+/*Tests_SRS_CONSTBUFFER_12_112: [ If CONSTBUFFER_ACCOUNTING is defined then CONSTBUFFER_DecRef and CONSTBUFFER_WritableHandleDecRef shall call constbuffer_accounting_remove with the type of the handle and its size when the ref count reaches 0. ]*/
+TEST_FUNCTION(CONSTBUFFER_CreateWithCustomFree_accounts_a_WITH_CUSTOM_FREE_buffer)
+{
+    ///arrange
+    static const unsigned char memory[5] = { 'a', 'b', 'c', 'd', 'e' };
+
+    ///act
+    CONSTBUFFER_HANDLE handle = CONSTBUFFER_CreateWithCustomFree(memory, sizeof(memory), test_free_func, NULL);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(handle);
+    assert_live(CONSTBUFFER_ACCOUNTING_TYPE_WITH_CUSTOM_FREE, 1, sizeof(memory));
+
+    ///clean
+    CONSTBUFFER_DecRef(handle);
+}
+
+/* CONSTBUFFER_CreateFromMappedFile */
+
+/*Tests_SRS_CONSTBUFFER_12_111: [ If CONSTBUFFER_ACCOUNTING is defined then every function that produces a CONSTBUFFER_HANDLE or a CONSTBUFFER_WRITABLE_HANDLE shall call constbuffer_accounting_add with the type of the handle and its size. ]*/
+/*Tests_SRS_CONSTBUFFER_12_112: [ If CONSTBUFFER_ACCOUNTING is defined then CONSTBUFFER_DecRef and CONSTBUFFER_WritableHandleDecRef shall call constbuffer_accounting_remove with the type of the handle and its size when the ref count reaches 0. ]*/
+TEST_FUNCTION(CONSTBUFFER_CreateFromMappedFile_accounts_a_MAPPED_FILE_buffer)
+{
+    ///act
+    CONSTBUFFER_HANDLE handle = CONSTBUFFER_CreateFromMappedFile("some_file", 0, sizeof(test_mapped_content), MEMORY_MAPPED_FILE_ACCESS_HINT_NORMAL);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(handle);
+    assert_live(CONSTBUFFER_ACCOUNTING_TYPE_MAPPED_FILE, 1, sizeof(test_mapped_content));
+
+    ///clean
+    CONSTBUFFER_DecRef(handle);
+}
+
+TEST_FUNCTION(when_memory_mapped_file_map_fails_CONSTBUFFER_CreateFromMappedFile_accounts_nothing)
+{
+    ///arrange
+    STRICT_EXPECTED_CALL(memory_mapped_file_map(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .SetReturn(MU_FAILURE);
+
+    ///act
+    CONSTBUFFER_HANDLE handle = CONSTBUFFER_CreateFromMappedFile("some_file", 0, sizeof(test_mapped_content), MEMORY_MAPPED_FILE_ACCESS_HINT_NORMAL);
+
+    ///assert
+    ASSERT_IS_NULL(handle);
+}
+
+/* CONSTBUFFER_CreateFromOffsetAndSize */
+
+/*Tests_SRS_CONSTBUFFER_12_111: [ If CONSTBUFFER_ACCOUNTING is defined then every function that produces a CONSTBUFFER_HANDLE or a CONSTBUFFER_WRITABLE_HANDLE shall call constbuffer_accounting_add with the type of the handle and its size. ]*/
+/*Tests_SRS_CONSTBUFFER_12_112: [ If CONSTBUFFER_ACCOUNTING is defined then CONSTBUFFER_DecRef and CONSTBUFFER_WritableHandleDecRef shall call constbuffer_accounting_remove with the type of the handle and its size when the ref count reaches 0. ]*/
+TEST_FUNCTION(CONSTBUFFER_CreateFromOffsetAndSize_accounts_a_FROM_OFFSET_AND_SIZE_buffer)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE original = CONSTBUFFER_Create((const unsigned char*)"abcde", 5);
+    ASSERT_IS_NOT_NULL(original);
+
+    ///act
+    CONSTBUFFER_HANDLE handle = CONSTBUFFER_CreateFromOffsetAndSize(original, 1, 3);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(handle);
+    assert_live(CONSTBUFFER_ACCOUNTING_TYPE_FROM_OFFSET_AND_SIZE, 1, 3);
+
+    /*the original is kept alive by the new buffer*/
+    CONSTBUFFER_DecRef(original);
+    assert_live(CONSTBUFFER_ACCOUNTING_TYPE_COPIED, 1, 5);
+
+    ///clean
+    CONSTBUFFER_DecRef(handle);
+}
+
+/*Tests_SRS_CONSTBUFFER_12_111: [ If CONSTBUFFER_ACCOUNTING is defined then every function that produces a CONSTBUFFER_HANDLE or a CONSTBUFFER_WRITABLE_HANDLE shall call constbuffer_accounting_add with the type of the handle and its size. ]*/
+TEST_FUNCTION(CONSTBUFFER_CreateFromOffsetAndSizeWithCopy_accounts_a_COPIED_buffer)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE original = CONSTBUFFER_Create((const unsigned char*)"abcde", 5);
+    ASSERT_IS_NOT_NULL(original);
+
+    ///act
+    CONSTBUFFER_HANDLE handle = CONSTBUFFER_CreateFromOffsetAndSizeWithCopy(original, 1, 3);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(handle);
+    assert_live(CONSTBUFFER_ACCOUNTING_TYPE_COPIED, 2, 5 + 3);
+
+    ///clean
+    CONSTBUFFER_DecRef(original);
+    CONSTBUFFER_DecRef(handle);
+}
+
+/* CONSTBUFFER_from_buffer */
+
+/*Tests_SRS_CONSTBUFFER_12_111: [ If CONSTBUFFER_ACCOUNTING is defined then every function that produces a CONSTBUFFER_HANDLE or a CONSTBUFFER_WRITABLE_HANDLE shall call constbuffer_accounting_add with the type of the handle and its size. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_v2_accounts_a_COPIED_buffer)
+{
+    ///arrange
+    unsigned char source[CONSTBUFFER_V2_CONTENT_OFFSET + 3];
+    write_uint8_t(source + CONSTBUFFER_VERSION_OFFSET, CONSTBUFFER_VERSION_V2);
+    write_uint32_t(source + CONSTBUFFER_SIZE_OFFSET, 3);
+    (void)memcpy(source + CONSTBUFFER_V2_CONTENT_OFFSET, "abc", 3);
+    write_uint32_t(source + CONSTBUFFER_CRC32C_OFFSET, crc32c_compute(0, source + CONSTBUFFER_V2_CONTENT_OFFSET, 3));
+    uint32_t consumed;
+    CONSTBUFFER_HANDLE handle;
+
+    ///act
+    CONSTBUFFER_FROM_BUFFER_RESULT result = CONSTBUFFER_from_buffer(source, sizeof(source), &consumed, &handle);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_OK, result);
+    assert_live(CONSTBUFFER_ACCOUNTING_TYPE_COPIED, 1, 3);
+
+    ///clean
+    CONSTBUFFER_DecRef(handle);
+}
+
+TEST_FUNCTION(when_the_CRC32C_does_not_match_CONSTBUFFER_from_buffer_accounts_nothing)
+{
+    ///arrange
+    unsigned char source[CONSTBUFFER_V2_CONTENT_OFFSET + 3];
+    write_uint8_t(source + CONSTBUFFER_VERSION_OFFSET, CONSTBUFFER_VERSION_V2);
+    write_uint32_t(source + CONSTBUFFER_SIZE_OFFSET, 3);
+    (void)memcpy(source + CONSTBUFFER_V2_CONTENT_OFFSET, "abc", 3);
+    write_uint32_t(source + CONSTBUFFER_CRC32C_OFFSET, crc32c_compute(0, source + CONSTBUFFER_V2_CONTENT_OFFSET, 3) ^ 1);
+    uint32_t consumed;
+    CONSTBUFFER_HANDLE handle;
+
+    ///act
+    CONSTBUFFER_FROM_BUFFER_RESULT result = CONSTBUFFER_from_buffer(source, sizeof(source), &consumed, &handle);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA, result);
+}
+
+/* CONSTBUFFER_from_buffer_view */
+
+/*Tests_SRS_CONSTBUFFER_12_111: [ If CONSTBUFFER_ACCOUNTING is defined then every function that produces a CONSTBUFFER_HANDLE or a CONSTBUFFER_WRITABLE_HANDLE shall call constbuffer_accounting_add with the type of the handle and its size. ]*/
+/*Tests_SRS_CONSTBUFFER_12_112: [ If CONSTBUFFER_ACCOUNTING is defined then CONSTBUFFER_DecRef and CONSTBUFFER_WritableHandleDecRef shall call constbuffer_accounting_remove with the type of the handle and its size when the ref count reaches 0. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_view_accounts_a_FROM_OFFSET_AND_SIZE_buffer)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(two_serialized_buffers, sizeof(two_serialized_buffers));
+    ASSERT_IS_NOT_NULL(source);
+    uint32_t consumed;
+    CONSTBUFFER_HANDLE view;
+
+    ///act
+    CONSTBUFFER_FROM_BUFFER_RESULT result = CONSTBUFFER_from_buffer_view(source, 6, &consumed, &view);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_OK, result);
+    assert_live(CONSTBUFFER_ACCOUNTING_TYPE_FROM_OFFSET_AND_SIZE, 1, 2);
+
+    ///clean
+    CONSTBUFFER_DecRef(source);
+    CONSTBUFFER_DecRef(view);
+}
+
+/* CONSTBUFFER_from_buffer_view_bulk */
+
+/*Tests_SRS_CONSTBUFFER_12_111: [ If CONSTBUFFER_ACCOUNTING is defined then every function that produces a CONSTBUFFER_HANDLE or a CONSTBUFFER_WRITABLE_HANDLE shall call constbuffer_accounting_add with the type of the handle and its size. ]*/
+/*Tests_SRS_CONSTBUFFER_12_112: [ If CONSTBUFFER_ACCOUNTING is defined then CONSTBUFFER_DecRef and CONSTBUFFER_WritableHandleDecRef shall call constbuffer_accounting_remove with the type of the handle and its size when the ref count reaches 0. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_view_bulk_accounts_the_block_until_the_last_view_is_released)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(two_serialized_buffers, sizeof(two_serialized_buffers));
+    ASSERT_IS_NOT_NULL(source);
+    uint32_t consumed;
+    CONSTBUFFER_HANDLE views[2];
+
+    ///act
+    CONSTBUFFER_FROM_BUFFER_RESULT result = CONSTBUFFER_from_buffer_view_bulk(source, 0, 2, &consumed, views);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_OK, result);
+    CONSTBUFFER_DecRef(source);
+    CONSTBUFFER_ACCOUNTING_SNAPSHOT snapshot;
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_accounting_get_snapshot(&snapshot));
+    ASSERT_ARE_EQUAL(int64_t, 1, snapshot.by_type[CONSTBUFFER_ACCOUNTING_TYPE_COPIED].live_handles);
+    ASSERT_ARE_EQUAL(int64_t, 1, snapshot.by_type[CONSTBUFFER_ACCOUNTING_TYPE_FROM_OFFSET_AND_SIZE].live_handles);
+    ASSERT_ARE_EQUAL(int64_t, sizeof(two_serialized_buffers), snapshot.by_type[CONSTBUFFER_ACCOUNTING_TYPE_FROM_OFFSET_AND_SIZE].live_bytes);
+    ASSERT_ARE_EQUAL(int64_t, 2, snapshot.by_type[CONSTBUFFER_ACCOUNTING_TYPE_FROM_BUFFER_VIEW].live_handles);
+    ASSERT_ARE_EQUAL(int64_t, 1 + 2, snapshot.by_type[CONSTBUFFER_ACCOUNTING_TYPE_FROM_BUFFER_VIEW].live_bytes);
+
+    CONSTBUFFER_DecRef(views[0]);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_accounting_get_snapshot(&snapshot));
+    ASSERT_ARE_EQUAL(int64_t, 1, snapshot.by_type[CONSTBUFFER_ACCOUNTING_TYPE_FROM_OFFSET_AND_SIZE].live_handles);
+    ASSERT_ARE_EQUAL(int64_t, 1, snapshot.by_type[CONSTBUFFER_ACCOUNTING_TYPE_FROM_BUFFER_VIEW].live_handles);
+    ASSERT_ARE_EQUAL(int64_t, 2, snapshot.by_type[CONSTBUFFER_ACCOUNTING_TYPE_FROM_BUFFER_VIEW].live_bytes);
+
+    ///clean
+    CONSTBUFFER_DecRef(views[1]);
+}
+
+TEST_FUNCTION(when_malloc_flex_fails_CONSTBUFFER_from_buffer_view_bulk_accounts_nothing_more)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(two_serialized_buffers, sizeof(two_serialized_buffers));
+    ASSERT_IS_NOT_NULL(source);
+    uint32_t consumed;
+    CONSTBUFFER_HANDLE views[2];
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .SetReturn(NULL);
+
+    ///act
+    CONSTBUFFER_FROM_BUFFER_RESULT result = CONSTBUFFER_from_buffer_view_bulk(source, 0, 2, &consumed, views);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_ERROR, result);
+    assert_live(CONSTBUFFER_ACCOUNTING_TYPE_COPIED, 1, sizeof(two_serialized_buffers));
+
+    ///clean
+    CONSTBUFFER_DecRef(source);
+}
+
+/* CONSTBUFFER_CreateCompressed */
+
+/*Tests_SRS_CONSTBUFFER_12_111: [ If CONSTBUFFER_ACCOUNTING is defined then every function that produces a CONSTBUFFER_HANDLE or a CONSTBUFFER_WRITABLE_HANDLE shall call constbuffer_accounting_add with the type of the handle and its size. ]*/
+TEST_FUNCTION(CONSTBUFFER_CreateCompressed_and_CONSTBUFFER_Decompress_account_COPIED_buffers)
+{
+    ///arrange
+    unsigned char content[256];
+    (void)memset(content, 'x', sizeof(content));
+    CONSTBUFFER_HANDLE original = CONSTBUFFER_Create(content, sizeof(content));
+    ASSERT_IS_NOT_NULL(original);
+
+    ///act
+    CONSTBUFFER_HANDLE compressed = CONSTBUFFER_CreateCompressed(original);
+    ASSERT_IS_NOT_NULL(compressed);
+    CONSTBUFFER_HANDLE decompressed = CONSTBUFFER_Decompress(compressed);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(decompressed);
+    assert_live(CONSTBUFFER_ACCOUNTING_TYPE_COPIED, 3, sizeof(content) + CONSTBUFFER_GetContent(compressed)->size + sizeof(content));
+
+    ///clean
+    CONSTBUFFER_DecRef(original);
+    CONSTBUFFER_DecRef(compressed);
+    CONSTBUFFER_DecRef(decompressed);
+}
+
+TEST_FUNCTION(when_malloc_flex_fails_CONSTBUFFER_CreateCompressed_accounts_nothing_more)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE original = CONSTBUFFER_Create((const unsigned char*)"abcabcabc", 9);
+    ASSERT_IS_NOT_NULL(original);
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .SetReturn(NULL);
+
+    ///act
+    CONSTBUFFER_HANDLE compressed = CONSTBUFFER_CreateCompressed(original);
+
+    ///assert
+    ASSERT_IS_NULL(compressed);
+    assert_live(CONSTBUFFER_ACCOUNTING_TYPE_COPIED, 1, 9);
+
+    ///clean
+    CONSTBUFFER_DecRef(original);
+}
+
+/* CONSTBUFFER_CreateSharedHot */
+
+/*Tests_SRS_CONSTBUFFER_12_111: [ If CONSTBUFFER_ACCOUNTING is defined then every function that produces a CONSTBUFFER_HANDLE or a CONSTBUFFER_WRITABLE_HANDLE shall call constbuffer_accounting_add with the type of the handle and its size. ]*/
+/*Tests_SRS_CONSTBUFFER_12_112: [ If CONSTBUFFER_ACCOUNTING is defined then CONSTBUFFER_DecRef and CONSTBUFFER_WritableHandleDecRef shall call constbuffer_accounting_remove with the type of the handle and its size when the ref count reaches 0. ]*/
+TEST_FUNCTION(CONSTBUFFER_CreateSharedHot_accounts_a_SHARED_HOT_buffer_until_the_last_DecRef)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE original = CONSTBUFFER_Create((const unsigned char*)"abc", 3);
+    ASSERT_IS_NOT_NULL(original);
+
+    ///act
+    CONSTBUFFER_HANDLE handle = CONSTBUFFER_CreateSharedHot(original, 4);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(handle);
+    CONSTBUFFER_DecRef(original);
+    CONSTBUFFER_IncRef(handle);
+    CONSTBUFFER_DecRef(handle);
+    CONSTBUFFER_ACCOUNTING_SNAPSHOT snapshot;
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_accounting_get_snapshot(&snapshot));
+    ASSERT_ARE_EQUAL(int64_t, 1, snapshot.by_type[CONSTBUFFER_ACCOUNTING_TYPE_SHARED_HOT].live_handles);
+    ASSERT_ARE_EQUAL(int64_t, 3, snapshot.by_type[CONSTBUFFER_ACCOUNTING_TYPE_SHARED_HOT].live_bytes);
+
+    ///clean
+    CONSTBUFFER_DecRef(handle);
+}
+
+/* CONSTBUFFER_CreateWritableHandle */
+
+/*Tests_SRS_CONSTBUFFER_12_111: [ If CONSTBUFFER_ACCOUNTING is defined then every function that produces a CONSTBUFFER_HANDLE or a CONSTBUFFER_WRITABLE_HANDLE shall call constbuffer_accounting_add with the type of the handle and its size. ]*/
+/*Tests_SRS_CONSTBUFFER_12_112: [ If CONSTBUFFER_ACCOUNTING is defined then CONSTBUFFER_DecRef and CONSTBUFFER_WritableHandleDecRef shall call constbuffer_accounting_remove with the type of the handle and its size when the ref count reaches 0. ]*/
+TEST_FUNCTION(CONSTBUFFER_CreateWritableHandle_accounts_the_buffer_once_before_and_after_seal)
+{
+    ///act
+    CONSTBUFFER_WRITABLE_HANDLE writable = CONSTBUFFER_CreateWritableHandle(7);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(writable);
+    assert_live(CONSTBUFFER_ACCOUNTING_TYPE_COPIED, 1, 7);
+
+    CONSTBUFFER_WritableHandleIncRef(writable);
+    CONSTBUFFER_WritableHandleDecRef(writable);
+    assert_live(CONSTBUFFER_ACCOUNTING_TYPE_COPIED, 1, 7);
+
+    CONSTBUFFER_HANDLE sealed = CONSTBUFFER_SealWritableHandle(writable);
+    ASSERT_IS_NOT_NULL(sealed);
+    assert_live(CONSTBUFFER_ACCOUNTING_TYPE_COPIED, 1, 7);
+
+    ///clean
+    CONSTBUFFER_DecRef(sealed);
+}
+
+/*Tests_SRS_CONSTBUFFER_12_112: [ If CONSTBUFFER_ACCOUNTING is defined then CONSTBUFFER_DecRef and CONSTBUFFER_WritableHandleDecRef shall call constbuffer_accounting_remove with the type of the handle and its size when the ref count reaches 0. ]*/
+TEST_FUNCTION(CONSTBUFFER_WritableHandleDecRef_removes_the_buffer_from_the_accounting)
+{
+    ///arrange
+    CONSTBUFFER_WRITABLE_HANDLE writable = CONSTBUFFER_CreateWritableHandle(7);
+    ASSERT_IS_NOT_NULL(writable);
+
+    ///act
+    CONSTBUFFER_WritableHandleDecRef(writable);
+
+    ///assert
+    assert_live(CONSTBUFFER_ACCOUNTING_TYPE_COPIED, 0, 0);
+}
+
+/* CONSTBUFFER_POOL_CreateWritableHandle */
+
+/*Tests_SRS_CONSTBUFFER_12_111: [ If CONSTBUFFER_ACCOUNTING is defined then every function that produces a CONSTBUFFER_HANDLE or a CONSTBUFFER_WRITABLE_HANDLE shall call constbuffer_accounting_add with the type of the handle and its size. ]*/
+/*Tests_SRS_CONSTBUFFER_12_112: [ If CONSTBUFFER_ACCOUNTING is defined then CONSTBUFFER_DecRef and CONSTBUFFER_WritableHandleDecRef shall call constbuffer_accounting_remove with the type of the handle and its size when the ref count reaches 0. ]*/
+TEST_FUNCTION(CONSTBUFFER_POOL_CreateWritableHandle_accounts_a_POOLED_buffer_until_it_goes_back_to_the_pool)
+{
+    ///arrange
+    CONSTBUFFER_POOL_HANDLE pool = CONSTBUFFER_POOL_Create(1024, 2);
+    ASSERT_IS_NOT_NULL(pool);
+
+    ///act
+    CONSTBUFFER_WRITABLE_HANDLE writable = CONSTBUFFER_POOL_CreateWritableHandle(pool, 10);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(writable);
+    assert_live(CONSTBUFFER_ACCOUNTING_TYPE_POOLED, 1, 10);
+
+    /*the memory is retained by the pool, it is not a live handle anymore*/
+    CONSTBUFFER_HANDLE sealed = CONSTBUFFER_SealWritableHandle(writable);
+    CONSTBUFFER_DecRef(sealed);
+    assert_live(CONSTBUFFER_ACCOUNTING_TYPE_POOLED, 0, 0);
+
+    /*a hit is accounted as well*/
+    writable = CONSTBUFFER_POOL_CreateWritableHandle(pool, 20);
+    ASSERT_IS_NOT_NULL(writable);
+    assert_live(CONSTBUFFER_ACCOUNTING_TYPE_POOLED, 1, 20);
+
+    ///clean
+    CONSTBUFFER_WritableHandleDecRef(writable);
+    CONSTBUFFER_POOL_Destroy(pool);
+}
+
+TEST_FUNCTION(when_malloc_flex_fails_CONSTBUFFER_POOL_CreateWritableHandle_accounts_nothing)
+{
+    ///arrange
+    CONSTBUFFER_POOL_HANDLE pool = CONSTBUFFER_POOL_Create(1024, 2);
+    ASSERT_IS_NOT_NULL(pool);
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .SetReturn(NULL);
+
+    ///act
+    CONSTBUFFER_WRITABLE_HANDLE writable = CONSTBUFFER_POOL_CreateWritableHandle(pool, 10);
+
+    ///assert
+    ASSERT_IS_NULL(writable);
+
+    ///clean
+    CONSTBUFFER_POOL_Destroy(pool);
+}
+
+/* constbuffer_array_create */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_011: [ If CONSTBUFFER_ACCOUNTING is defined then every function that produces a CONSTBUFFER_ARRAY_HANDLE shall call constbuffer_accounting_add with CONSTBUFFER_ACCOUNTING_TYPE_ARRAY and the size of the handle. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_012: [ If CONSTBUFFER_ACCOUNTING is defined then constbuffer_array_dec_ref shall call constbuffer_accounting_remove with CONSTBUFFER_ACCOUNTING_TYPE_ARRAY and the size of the handle when the reference count reaches 0. ]*/
+TEST_FUNCTION(constbuffer_array_create_accounts_the_array_and_its_handles_until_the_last_dec_ref)
+{
+    ///arrange
+    int64_t handle_size = get_array_handle_size();
+    CONSTBUFFER_HANDLE buffers[2];
+    create_two_buffers(buffers);
+
+    ///act
+    CONSTBUFFER_ARRAY_HANDLE array = constbuffer_array_create(buffers, 2);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(array);
+    assert_live_arrays(1, handle_size + 2 * sizeof(CONSTBUFFER_HANDLE));
+
+    constbuffer_array_inc_ref(array);
+    constbuffer_array_dec_ref(array);
+    assert_live_arrays(1, handle_size + 2 * sizeof(CONSTBUFFER_HANDLE));
+
+    /*the buffers are still referenced by the array*/
+    release_two_buffers(buffers);
+    assert_live(CONSTBUFFER_ACCOUNTING_TYPE_COPIED, 2, 5);
+
+    ///clean
+    constbuffer_array_dec_ref(array);
+}
+
+TEST_FUNCTION(when_malloc_flex_fails_constbuffer_array_create_accounts_nothing_more)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE buffers[2];
+    create_two_buffers(buffers);
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .SetReturn(NULL);
+
+    ///act
+    CONSTBUFFER_ARRAY_HANDLE array = constbuffer_array_create(buffers, 2);
+
+    ///assert
+    ASSERT_IS_NULL(array);
+    assert_live_arrays(0, 0);
+
+    ///clean
+    release_two_buffers(buffers);
+}
+
+/* constbuffer_array_create_empty */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_011: [ If CONSTBUFFER_ACCOUNTING is defined then every function that produces a CONSTBUFFER_ARRAY_HANDLE shall call constbuffer_accounting_add with CONSTBUFFER_ACCOUNTING_TYPE_ARRAY and the size of the handle. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_012: [ If CONSTBUFFER_ACCOUNTING is defined then constbuffer_array_dec_ref shall call constbuffer_accounting_remove with CONSTBUFFER_ACCOUNTING_TYPE_ARRAY and the size of the handle when the reference count reaches 0. ]*/
+TEST_FUNCTION(constbuffer_array_create_empty_accounts_the_array)
+{
+    ///act
+    CONSTBUFFER_ARRAY_HANDLE array = constbuffer_array_create_empty();
+
+    ///assert
+    ASSERT_IS_NOT_NULL(array);
+    CONSTBUFFER_ACCOUNTING_SNAPSHOT snapshot;
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_accounting_get_snapshot(&snapshot));
+    ASSERT_ARE_EQUAL(int64_t, 1, snapshot.by_type[CONSTBUFFER_ACCOUNTING_TYPE_ARRAY].live_handles);
+    ASSERT_IS_TRUE(snapshot.by_type[CONSTBUFFER_ACCOUNTING_TYPE_ARRAY].live_bytes > 0);
+    /*arrays are not in the histogram of the CONSTBUFFER_HANDLE sizes*/
+    for (uint32_t i = 0; i < CONSTBUFFER_ACCOUNTING_HISTOGRAM_BUCKET_COUNT; i++)
+    {
+        ASSERT_ARE_EQUAL(int64_t, 0, snapshot.size_histogram[i]);
+    }
+
+    ///clean
+    constbuffer_array_dec_ref(array);
+}
+
+TEST_FUNCTION(when_malloc_flex_fails_constbuffer_array_create_empty_accounts_nothing)
+{
+    ///arrange
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .SetReturn(NULL);
+
+    ///act
+    CONSTBUFFER_ARRAY_HANDLE array = constbuffer_array_create_empty();
+
+    ///assert
+    ASSERT_IS_NULL(array);
+}
+
+/* constbuffer_array_create_with_move_buffers */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_011: [ If CONSTBUFFER_ACCOUNTING is defined then every function that produces a CONSTBUFFER_ARRAY_HANDLE shall call constbuffer_accounting_add with CONSTBUFFER_ACCOUNTING_TYPE_ARRAY and the size of the handle. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_012: [ If CONSTBUFFER_ACCOUNTING is defined then constbuffer_array_dec_ref shall call constbuffer_accounting_remove with CONSTBUFFER_ACCOUNTING_TYPE_ARRAY and the size of the handle when the reference count reaches 0. ]*/
+TEST_FUNCTION(constbuffer_array_create_with_move_buffers_accounts_the_array_and_the_moved_handles)
+{
+    ///arrange
+    int64_t handle_size = get_array_handle_size();
+    CONSTBUFFER_HANDLE* buffers = malloc(2 * sizeof(CONSTBUFFER_HANDLE));
+    ASSERT_IS_NOT_NULL(buffers);
+    create_two_buffers(buffers);
+
+    ///act
+    CONSTBUFFER_ARRAY_HANDLE array = constbuffer_array_create_with_move_buffers(buffers, 2);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(array);
+    assert_live_arrays(1, handle_size + 2 * sizeof(CONSTBUFFER_HANDLE));
+
+    ///clean
+    constbuffer_array_dec_ref(array);
+}
+
+TEST_FUNCTION(when_malloc_flex_fails_constbuffer_array_create_with_move_buffers_accounts_nothing_more)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE buffers[2];
+    create_two_buffers(buffers);
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .SetReturn(NULL);
+
+    ///act
+    CONSTBUFFER_ARRAY_HANDLE array = constbuffer_array_create_with_move_buffers(buffers, 2);
+
+    ///assert
+    ASSERT_IS_NULL(array);
+    assert_live_arrays(0, 0);
+
+    ///clean
+    release_two_buffers(buffers);
+}
+
+/* constbuffer_array_create_from_buffer_index_and_count */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_011: [ If CONSTBUFFER_ACCOUNTING is defined then every function that produces a CONSTBUFFER_ARRAY_HANDLE shall call constbuffer_accounting_add with CONSTBUFFER_ACCOUNTING_TYPE_ARRAY and the size of the handle. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_012: [ If CONSTBUFFER_ACCOUNTING is defined then constbuffer_array_dec_ref shall call constbuffer_accounting_remove with CONSTBUFFER_ACCOUNTING_TYPE_ARRAY and the size of the handle when the reference count reaches 0. ]*/
+TEST_FUNCTION(constbuffer_array_create_from_buffer_index_and_count_accounts_the_array_without_the_handles_of_the_original)
+{
+    ///arrange
+    int64_t handle_size = get_array_handle_size();
+    CONSTBUFFER_HANDLE buffers[2];
+    create_two_buffers(buffers);
+    CONSTBUFFER_ARRAY_HANDLE original = constbuffer_array_create(buffers, 2);
+    ASSERT_IS_NOT_NULL(original);
+    release_two_buffers(buffers);
+
+    ///act
+    CONSTBUFFER_ARRAY_HANDLE array = constbuffer_array_create_from_buffer_index_and_count(original, 1, 1);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(array);
+    assert_live_arrays(2, handle_size + 2 * sizeof(CONSTBUFFER_HANDLE) + handle_size);
+
+    /*the original is kept alive by the new array*/
+    constbuffer_array_dec_ref(original);
+    assert_live_arrays(2, handle_size + 2 * sizeof(CONSTBUFFER_HANDLE) + handle_size);
+
+    ///clean
+    constbuffer_array_dec_ref(array);
+}
+
+/* constbuffer_array_create_from_buffer_offset_and_count */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_011: [ If CONSTBUFFER_ACCOUNTING is defined then every function that produces a CONSTBUFFER_ARRAY_HANDLE shall call constbuffer_accounting_add with CONSTBUFFER_ACCOUNTING_TYPE_ARRAY and the size of the handle. ]*/
+TEST_FUNCTION(constbuffer_array_create_from_buffer_offset_and_count_accounts_the_array_and_the_new_buffers)
+{
+    ///arrange
+    int64_t handle_size = get_array_handle_size();
+    CONSTBUFFER_HANDLE buffers[2];
+    create_two_buffers(buffers);
+    CONSTBUFFER_ARRAY_HANDLE original = constbuffer_array_create(buffers, 2);
+    ASSERT_IS_NOT_NULL(original);
+    release_two_buffers(buffers);
+
+    ///act
+    CONSTBUFFER_ARRAY_HANDLE array = constbuffer_array_create_from_buffer_offset_and_count(original, 0, 2, 1, 2);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(array);
+    constbuffer_array_dec_ref(original);
+    assert_live_arrays(1, handle_size + 2 * sizeof(CONSTBUFFER_HANDLE));
+    CONSTBUFFER_ACCOUNTING_SNAPSHOT snapshot;
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_accounting_get_snapshot(&snapshot));
+    ASSERT_ARE_EQUAL(int64_t, 2, snapshot.by_type[CONSTBUFFER_ACCOUNTING_TYPE_FROM_OFFSET_AND_SIZE].live_handles);
+    ASSERT_ARE_EQUAL(int64_t, 1 + 2, snapshot.by_type[CONSTBUFFER_ACCOUNTING_TYPE_FROM_OFFSET_AND_SIZE].live_bytes);
+
+    ///clean
+    constbuffer_array_dec_ref(array);
+}
+
+TEST_FUNCTION(when_creating_the_end_buffer_fails_constbuffer_array_create_from_buffer_offset_and_count_removes_the_array_it_accounted)
+{
+    ///arrange
+    int64_t handle_size = get_array_handle_size();
+    CONSTBUFFER_HANDLE buffers[2];
+    create_two_buffers(buffers);
+    CONSTBUFFER_ARRAY_HANDLE original = constbuffer_array_create(buffers, 2);
+    ASSERT_IS_NOT_NULL(original);
+    release_two_buffers(buffers);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG)); /*the array, accounted before the buffers are made*/
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)); /*the start buffer*/
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG)) /*the end buffer*/
+        .SetReturn(NULL);
+
+    ///act
+    CONSTBUFFER_ARRAY_HANDLE array = constbuffer_array_create_from_buffer_offset_and_count(original, 0, 2, 1, 2);
+
+    ///assert
+    ASSERT_IS_NULL(array);
+    assert_live_arrays(1, handle_size + 2 * sizeof(CONSTBUFFER_HANDLE));
+    assert_live(CONSTBUFFER_ACCOUNTING_TYPE_COPIED, 2, 5);
+
+    ///clean
+    constbuffer_array_dec_ref(original);
+}
+
+/* constbuffer_array_create_from_array_array */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_011: [ If CONSTBUFFER_ACCOUNTING is defined then every function that produces a CONSTBUFFER_ARRAY_HANDLE shall call constbuffer_accounting_add with CONSTBUFFER_ACCOUNTING_TYPE_ARRAY and the size of the handle. ]*/
+TEST_FUNCTION(constbuffer_array_create_from_array_array_accounts_the_array_and_its_handles)
+{
+    ///arrange
+    int64_t handle_size = get_array_handle_size();
+    CONSTBUFFER_HANDLE buffers[2];
+    create_two_buffers(buffers);
+    CONSTBUFFER_ARRAY_HANDLE arrays[2];
+    arrays[0] = constbuffer_array_create(buffers, 2);
+    ASSERT_IS_NOT_NULL(arrays[0]);
+    arrays[1] = constbuffer_array_create(buffers, 1);
+    ASSERT_IS_NOT_NULL(arrays[1]);
+    release_two_buffers(buffers);
+
+    ///act
+    CONSTBUFFER_ARRAY_HANDLE array = constbuffer_array_create_from_array_array(arrays, 2);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(array);
+    constbuffer_array_dec_ref(arrays[0]);
+    constbuffer_array_dec_ref(arrays[1]);
+    assert_live_arrays(1, handle_size + 3 * sizeof(CONSTBUFFER_HANDLE));
+
+    ///clean
+    constbuffer_array_dec_ref(array);
+}
+
+/* constbuffer_array_remove_empty_buffers */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_011: [ If CONSTBUFFER_ACCOUNTING is defined then every function that produces a CONSTBUFFER_ARRAY_HANDLE shall call constbuffer_accounting_add with CONSTBUFFER_ACCOUNTING_TYPE_ARRAY and the size of the handle. ]*/
+TEST_FUNCTION(constbuffer_array_remove_empty_buffers_accounts_the_array_without_the_empty_buffers)
+{
+    ///arrange
+    int64_t handle_size = get_array_handle_size();
+    CONSTBUFFER_HANDLE buffers[3];
+    create_two_buffers(buffers);
+    buffers[2] = CONSTBUFFER_Create(NULL, 0);
+    ASSERT_IS_NOT_NULL(buffers[2]);
+    CONSTBUFFER_ARRAY_HANDLE original = constbuffer_array_create(buffers, 3);
+    ASSERT_IS_NOT_NULL(original);
+    release_two_buffers(buffers);
+    CONSTBUFFER_DecRef(buffers[2]);
+
+    ///act
+    CONSTBUFFER_ARRAY_HANDLE array = constbuffer_array_remove_empty_buffers(original);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(array);
+    constbuffer_array_dec_ref(original);
+    assert_live_arrays(1, handle_size + 2 * sizeof(CONSTBUFFER_HANDLE));
+    assert_live(CONSTBUFFER_ACCOUNTING_TYPE_COPIED, 2, 5);
+
+    ///clean
+    constbuffer_array_dec_ref(array);
+}
+
+/* constbuffer_array_create_compressed */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_011: [ If CONSTBUFFER_ACCOUNTING is defined then every function that produces a CONSTBUFFER_ARRAY_HANDLE shall call constbuffer_accounting_add with CONSTBUFFER_ACCOUNTING_TYPE_ARRAY and the size of the handle. ]*/
+TEST_FUNCTION(constbuffer_array_create_compressed_and_constbuffer_array_create_decompressed_account_the_arrays)
+{
+    ///arrange
+    int64_t handle_size = get_array_handle_size();
+    CONSTBUFFER_HANDLE buffers[2];
+    create_two_buffers(buffers);
+    CONSTBUFFER_ARRAY_HANDLE original = constbuffer_array_create(buffers, 2);
+    ASSERT_IS_NOT_NULL(original);
+    release_two_buffers(buffers);
+
+    ///act
+    CONSTBUFFER_ARRAY_HANDLE compressed = constbuffer_array_create_compressed(original);
+    ASSERT_IS_NOT_NULL(compressed);
+    CONSTBUFFER_ARRAY_HANDLE decompressed = constbuffer_array_create_decompressed(compressed);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(decompressed);
+    assert_live_arrays(3, 3 * (handle_size + 2 * sizeof(CONSTBUFFER_HANDLE)));
+
+    ///clean
+    constbuffer_array_dec_ref(original);
+    constbuffer_array_dec_ref(compressed);
+    constbuffer_array_dec_ref(decompressed);
+}
+
+TEST_FUNCTION(when_compressing_the_second_buffer_fails_constbuffer_array_create_compressed_removes_the_array_it_accounted)
+{
+    ///arrange
+    int64_t handle_size = get_array_handle_size();
+    CONSTBUFFER_HANDLE buffers[2];
+    create_two_buffers(buffers);
+    CONSTBUFFER_ARRAY_HANDLE original = constbuffer_array_create(buffers, 2);
+    ASSERT_IS_NOT_NULL(original);
+    release_two_buffers(buffers);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG)); /*the array, accounted before the buffers are compressed*/
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG)); /*the first compressed buffer*/
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG)) /*the second compressed buffer*/
+        .SetReturn(NULL);
+
+    ///act
+    CONSTBUFFER_ARRAY_HANDLE compressed = constbuffer_array_create_compressed(original);
+
+    ///assert
+    ASSERT_IS_NULL(compressed);
+    assert_live_arrays(1, handle_size + 2 * sizeof(CONSTBUFFER_HANDLE));
+    assert_live(CONSTBUFFER_ACCOUNTING_TYPE_COPIED, 2, 5);
+
+    ///clean
+    constbuffer_array_dec_ref(original);
+}
+
+/* constbuffer_array_add_front */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_011: [ If CONSTBUFFER_ACCOUNTING is defined then every function that produces a CONSTBUFFER_ARRAY_HANDLE shall call constbuffer_accounting_add with CONSTBUFFER_ACCOUNTING_TYPE_ARRAY and the size of the handle. ]*/
+TEST_FUNCTION(constbuffer_array_add_front_and_constbuffer_array_add_back_account_the_new_arrays)
+{
+    ///arrange
+    int64_t handle_size = get_array_handle_size();
+    CONSTBUFFER_HANDLE buffers[2];
+    create_two_buffers(buffers);
+    CONSTBUFFER_ARRAY_HANDLE original = constbuffer_array_create(buffers, 1);
+    ASSERT_IS_NOT_NULL(original);
+
+    ///act
+    CONSTBUFFER_ARRAY_HANDLE front = constbuffer_array_add_front(original, buffers[1]);
+    ASSERT_IS_NOT_NULL(front);
+    CONSTBUFFER_ARRAY_HANDLE back = constbuffer_array_add_back(original, buffers[1]);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(back);
+    assert_live_arrays(3, (handle_size + sizeof(CONSTBUFFER_HANDLE)) + 2 * (handle_size + 2 * sizeof(CONSTBUFFER_HANDLE)));
+
+    ///clean
+    release_two_buffers(buffers);
+    constbuffer_array_dec_ref(original);
+    constbuffer_array_dec_ref(front);
+    constbuffer_array_dec_ref(back);
+}
+
+TEST_FUNCTION(when_malloc_flex_fails_constbuffer_array_add_back_accounts_nothing_more)
+{
+    ///arrange
+    int64_t handle_size = get_array_handle_size();
+    CONSTBUFFER_HANDLE buffers[2];
+    create_two_buffers(buffers);
+    CONSTBUFFER_ARRAY_HANDLE original = constbuffer_array_create(buffers, 1);
+    ASSERT_IS_NOT_NULL(original);
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .SetReturn(NULL);
+
+    ///act
+    CONSTBUFFER_ARRAY_HANDLE back = constbuffer_array_add_back(original, buffers[1]);
+
+    ///assert
+    ASSERT_IS_NULL(back);
+    assert_live_arrays(1, handle_size + sizeof(CONSTBUFFER_HANDLE));
+
+    ///clean
+    release_two_buffers(buffers);
+    constbuffer_array_dec_ref(original);
+}
+
+/* constbuffer_array_remove_front */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_011: [ If CONSTBUFFER_ACCOUNTING is defined then every function that produces a CONSTBUFFER_ARRAY_HANDLE shall call constbuffer_accounting_add with CONSTBUFFER_ACCOUNTING_TYPE_ARRAY and the size of the handle. ]*/
+TEST_FUNCTION(constbuffer_array_remove_front_and_constbuffer_array_remove_back_account_the_new_arrays)
+{
+    ///arrange
+    int64_t handle_size = get_array_handle_size();
+    CONSTBUFFER_HANDLE buffers[2];
+    create_two_buffers(buffers);
+    CONSTBUFFER_ARRAY_HANDLE original = constbuffer_array_create(buffers, 2);
+    ASSERT_IS_NOT_NULL(original);
+    release_two_buffers(buffers);
+    CONSTBUFFER_HANDLE removed_front;
+    CONSTBUFFER_HANDLE removed_back;
+
+    ///act
+    CONSTBUFFER_ARRAY_HANDLE front = constbuffer_array_remove_front(original, &removed_front);
+    ASSERT_IS_NOT_NULL(front);
+    CONSTBUFFER_ARRAY_HANDLE back = constbuffer_array_remove_back(original, &removed_back);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(back);
+    assert_live_arrays(3, (handle_size + 2 * sizeof(CONSTBUFFER_HANDLE)) + 2 * (handle_size + sizeof(CONSTBUFFER_HANDLE)));
+
+    ///clean
+    CONSTBUFFER_DecRef(removed_front);
+    CONSTBUFFER_DecRef(removed_back);
+    constbuffer_array_dec_ref(original);
+    constbuffer_array_dec_ref(front);
+    constbuffer_array_dec_ref(back);
+}
+
+/* constbuffer_array_add_back_shared */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_011: [ If CONSTBUFFER_ACCOUNTING is defined then every function that produces a CONSTBUFFER_ARRAY_HANDLE shall call constbuffer_accounting_add with CONSTBUFFER_ACCOUNTING_TYPE_ARRAY and the size of the handle. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_012: [ If CONSTBUFFER_ACCOUNTING is defined then constbuffer_array_dec_ref shall call constbuffer_accounting_remove with CONSTBUFFER_ACCOUNTING_TYPE_ARRAY and the size of the handle when the reference count reaches 0. ]*/
+TEST_FUNCTION(the_shared_add_and_remove_functions_account_the_arrays_without_the_handles_of_the_storage)
+{
+    ///arrange
+    int64_t handle_size = get_array_handle_size();
+    CONSTBUFFER_HANDLE buffers[2];
+    create_two_buffers(buffers);
+    CONSTBUFFER_ARRAY_HANDLE original = constbuffer_array_create(buffers, 1);
+    ASSERT_IS_NOT_NULL(original);
+    CONSTBUFFER_HANDLE removed;
+
+    ///act
+    CONSTBUFFER_ARRAY_HANDLE with_new_storage = constbuffer_array_add_back_shared(original, buffers[1]);
+    ASSERT_IS_NOT_NULL(with_new_storage);
+    CONSTBUFFER_ARRAY_HANDLE in_place = constbuffer_array_add_front_shared(with_new_storage, buffers[1]);
+    ASSERT_IS_NOT_NULL(in_place);
+    CONSTBUFFER_ARRAY_HANDLE removed_back = constbuffer_array_remove_back_shared(in_place, &removed);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(removed_back);
+    assert_live_arrays(4, (handle_size + sizeof(CONSTBUFFER_HANDLE)) + 3 * handle_size);
+
+    ///clean
+    CONSTBUFFER_DecRef(removed);
+    release_two_buffers(buffers);
+    constbuffer_array_dec_ref(original);
+    constbuffer_array_dec_ref(with_new_storage);
+    constbuffer_array_dec_ref(in_place);
+    constbuffer_array_dec_ref(removed_back);
+}
+
+TEST_FUNCTION(when_allocating_the_storage_fails_constbuffer_array_add_back_shared_accounts_nothing_more)
+{
+    ///arrange
+    int64_t handle_size = get_array_handle_size();
+    CONSTBUFFER_HANDLE buffers[2];
+    create_two_buffers(buffers);
+    CONSTBUFFER_ARRAY_HANDLE original = constbuffer_array_create(buffers, 1);
+    ASSERT_IS_NOT_NULL(original);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG)); /*the array*/
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG)) /*the shared storage*/
+        .SetReturn(NULL);
+
+    ///act
+    CONSTBUFFER_ARRAY_HANDLE array = constbuffer_array_add_back_shared(original, buffers[1]);
+
+    ///assert
+    ASSERT_IS_NULL(array);
+    assert_live_arrays(1, handle_size + sizeof(CONSTBUFFER_HANDLE));
+
+    ///clean
+    release_two_buffers(buffers);
+    constbuffer_array_dec_ref(original);
+}
+
+END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
@@ -0,0 +1,40 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+// Precompiled header for constbuffer_accounting_hooks_ut
+
+#ifndef CONSTBUFFER_ACCOUNTING_HOOKS_UT_PCH_H
+#define CONSTBUFFER_ACCOUNTING_HOOKS_UT_PCH_H
+
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "macro_utils/macro_utils.h"
+#include "testrunnerswitcher.h"
+
+#include "umock_c/umock_c.h"
+#include "umock_c/umocktypes_stdint.h"
+
+#include "umock_c/umock_c_ENABLE_MOCKS.h" // ============================== ENABLE_MOCKS
+#include "c_pal/gballoc_hl.h"
+#include "c_pal/gballoc_hl_redirect.h"
+#include "c_pal/threadapi.h"
+#include "c_util/buffer_.h"
+#include "c_util/hash.h"
+#include "c_util/memory_mapped_file.h"
+#include "umock_c/umock_c_DISABLE_MOCKS.h" // ============================== DISABLE_MOCKS
+
+#include "real_gballoc_hl.h"
+
+#include "c_util/memory_data.h"
+#include "c_util/crc32c.h"
+#include "c_util/constbuffer_format.h"
+#include "c_util/constbuffer_version.h"
+#include "c_util/constbuffer_accounting.h"
+#include "c_util/constbuffer.h"
+#include "c_util/constbuffer_array.h"
+
+#endif // CONSTBUFFER_ACCOUNTING_HOOKS_UT_PCH_H
@@ -0,0 +1,266 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "constbuffer_accounting_ut_pch.h"
+
+MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    ASSERT_FAIL("umock_c reported error :%" PRI_MU_ENUM "", MU_ENUM_VALUE(UMOCK_C_ERROR_CODE, error_code));
+}
+
+/*the counters are global, so every test removes what it adds and the snapshot is all 0 between tests*/
+static void assert_snapshot_is_empty(void)
+{
+    CONSTBUFFER_ACCOUNTING_SNAPSHOT snapshot;
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_accounting_get_snapshot(&snapshot));
+    for (uint32_t i = 0; i < CONSTBUFFER_ACCOUNTING_TYPE_COUNT; i++)
+    {
+        ASSERT_ARE_EQUAL(int64_t, 0, snapshot.by_type[i].live_handles);
+        ASSERT_ARE_EQUAL(int64_t, 0, snapshot.by_type[i].live_bytes);
+    }
+    for (uint32_t i = 0; i < CONSTBUFFER_ACCOUNTING_HISTOGRAM_BUCKET_COUNT; i++)
+    {
+        ASSERT_ARE_EQUAL(int64_t, 0, snapshot.size_histogram[i]);
+    }
+}
+
+/*adds and removes one buffer of size bytes and returns the histogram bucket it was counted in*/
+static uint32_t get_bucket_of_size(uint64_t size)
+{
+    CONSTBUFFER_ACCOUNTING_SNAPSHOT snapshot;
+    uint32_t result = CONSTBUFFER_ACCOUNTING_HISTOGRAM_BUCKET_COUNT;
+
+    constbuffer_accounting_add(CONSTBUFFER_ACCOUNTING_TYPE_COPIED, size);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_accounting_get_snapshot(&snapshot));
+    for (uint32_t i = 0; i < CONSTBUFFER_ACCOUNTING_HISTOGRAM_BUCKET_COUNT; i++)
+    {
+        if (snapshot.size_histogram[i] != 0)
+        {
+            ASSERT_ARE_EQUAL(int64_t, 1, snapshot.size_histogram[i]);
+            ASSERT_ARE_EQUAL(uint32_t, CONSTBUFFER_ACCOUNTING_HISTOGRAM_BUCKET_COUNT, result);
+            result = i;
+        }
+    }
+    constbuffer_accounting_remove(CONSTBUFFER_ACCOUNTING_TYPE_COPIED, size);
+    return result;
+}
+
+BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
+
+TEST_SUITE_INITIALIZE(a)
+{
+    umock_c_init(on_umock_c_error);
+
+    (void)umocktypes_stdint_register_types();
+}
+
+TEST_SUITE_CLEANUP(b)
+{
+    umock_c_deinit();
+}
+
+TEST_FUNCTION_INITIALIZE(c)
+{
+    umock_c_reset_all_calls();
+}
+
+TEST_FUNCTION_CLEANUP(d)
+{
+    assert_snapshot_is_empty();
+}
+
+/* constbuffer_accounting_get_snapshot */
+
+/*Tests_SRS_CONSTBUFFER_ACCOUNTING_12_001: [ If snapshot is NULL then constbuffer_accounting_get_snapshot shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_accounting_get_snapshot_with_NULL_snapshot_fails)
+{
+    ///act
+    int result = constbuffer_accounting_get_snapshot(NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_ACCOUNTING_12_003: [ constbuffer_accounting_get_snapshot shall set is_enabled to true and write in snapshot the sums of the counters of all the shards. ]*/
+/*Tests_SRS_CONSTBUFFER_ACCOUNTING_12_008: [ constbuffer_accounting_get_snapshot shall succeed and return 0. ]*/
+TEST_FUNCTION(constbuffer_accounting_get_snapshot_with_nothing_accounted_returns_all_0)
+{
+    ///arrange
+    CONSTBUFFER_ACCOUNTING_SNAPSHOT snapshot;
+    (void)memset(&snapshot, 0xFF, sizeof(snapshot));
+
+    ///act
+    int result = constbuffer_accounting_get_snapshot(&snapshot);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_TRUE(snapshot.is_enabled);
+    for (uint32_t i = 0; i < CONSTBUFFER_ACCOUNTING_TYPE_COUNT; i++)
+    {
+        ASSERT_ARE_EQUAL(int64_t, 0, snapshot.by_type[i].live_handles);
+        ASSERT_ARE_EQUAL(int64_t, 0, snapshot.by_type[i].live_bytes);
+    }
+    for (uint32_t i = 0; i < CONSTBUFFER_ACCOUNTING_HISTOGRAM_BUCKET_COUNT; i++)
+    {
+        ASSERT_ARE_EQUAL(int64_t, 0, snapshot.size_histogram[i]);
+    }
+}
+
+/*Tests_SRS_CONSTBUFFER_ACCOUNTING_12_003: [ constbuffer_accounting_get_snapshot shall set is_enabled to true and write in snapshot the sums of the counters of all the shards. ]*/
+TEST_FUNCTION(constbuffer_accounting_get_snapshot_sums_the_counters_of_different_threads)
+{
+    ///arrange
+    CONSTBUFFER_ACCOUNTING_SNAPSHOT snapshot;
+    STRICT_EXPECTED_CALL(ThreadAPI_GetCurrentId())
+        .SetReturn(1);
+    STRICT_EXPECTED_CALL(ThreadAPI_GetCurrentId())
+        .SetReturn(2);
+    constbuffer_accounting_add(CONSTBUFFER_ACCOUNTING_TYPE_MEMORY_MOVED, 10);
+    constbuffer_accounting_add(CONSTBUFFER_ACCOUNTING_TYPE_MEMORY_MOVED, 20);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    umock_c_reset_all_calls();
+
+    ///act
+    int result = constbuffer_accounting_get_snapshot(&snapshot);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int64_t, 2, snapshot.by_type[CONSTBUFFER_ACCOUNTING_TYPE_MEMORY_MOVED].live_handles);
+    ASSERT_ARE_EQUAL(int64_t, 30, snapshot.by_type[CONSTBUFFER_ACCOUNTING_TYPE_MEMORY_MOVED].live_bytes);
+    ASSERT_ARE_EQUAL(int64_t, 1, snapshot.size_histogram[4]); /*10 is in [8, 16)*/
+    ASSERT_ARE_EQUAL(int64_t, 1, snapshot.size_histogram[5]); /*20 is in [16, 32)*/
+
+    ///clean
+    STRICT_EXPECTED_CALL(ThreadAPI_GetCurrentId())
+        .SetReturn(2);
+    STRICT_EXPECTED_CALL(ThreadAPI_GetCurrentId())
+        .SetReturn(1);
+    constbuffer_accounting_remove(CONSTBUFFER_ACCOUNTING_TYPE_MEMORY_MOVED, 20);
+    constbuffer_accounting_remove(CONSTBUFFER_ACCOUNTING_TYPE_MEMORY_MOVED, 10);
+}
+
+/* constbuffer_accounting_add */
+
+/*Tests_SRS_CONSTBUFFER_ACCOUNTING_12_004: [ constbuffer_accounting_add shall add 1 to the live handles and size to the live bytes of type in the shard picked by the id of the calling thread. ]*/
+/*Tests_SRS_CONSTBUFFER_ACCOUNTING_12_005: [ If type is not CONSTBUFFER_ACCOUNTING_TYPE_ARRAY then constbuffer_accounting_add shall add 1 to the histogram bucket of size in the same shard. ]*/
+TEST_FUNCTION(constbuffer_accounting_add_counts_the_handle_its_bytes_and_its_size_bucket)
+{
+    ///arrange
+    CONSTBUFFER_ACCOUNTING_SNAPSHOT snapshot;
+    STRICT_EXPECTED_CALL(ThreadAPI_GetCurrentId());
+
+    ///act
+    constbuffer_accounting_add(CONSTBUFFER_ACCOUNTING_TYPE_FROM_OFFSET_AND_SIZE, 100);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_accounting_get_snapshot(&snapshot));
+    for (uint32_t i = 0; i < CONSTBUFFER_ACCOUNTING_TYPE_COUNT; i++)
+    {
+        ASSERT_ARE_EQUAL(int64_t, (i == CONSTBUFFER_ACCOUNTING_TYPE_FROM_OFFSET_AND_SIZE) ? 1 : 0, snapshot.by_type[i].live_handles);
+        ASSERT_ARE_EQUAL(int64_t, (i == CONSTBUFFER_ACCOUNTING_TYPE_FROM_OFFSET_AND_SIZE) ? 100 : 0, snapshot.by_type[i].live_bytes);
+    }
+    for (uint32_t i = 0; i < CONSTBUFFER_ACCOUNTING_HISTOGRAM_BUCKET_COUNT; i++)
+    {
+        ASSERT_ARE_EQUAL(int64_t, (i == 7) ? 1 : 0, snapshot.size_histogram[i]); /*100 is in [64, 128)*/
+    }
+
+    ///clean
+    constbuffer_accounting_remove(CONSTBUFFER_ACCOUNTING_TYPE_FROM_OFFSET_AND_SIZE, 100);
+}
+
+/*Tests_SRS_CONSTBUFFER_ACCOUNTING_12_005: [ If type is not CONSTBUFFER_ACCOUNTING_TYPE_ARRAY then constbuffer_accounting_add shall add 1 to the histogram bucket of size in the same shard. ]*/
+TEST_FUNCTION(constbuffer_accounting_add_puts_the_sizes_in_log2_buckets)
+{
+    ///act
+    uint32_t bucket_0 = get_bucket_of_size(0);
+    uint32_t bucket_1 = get_bucket_of_size(1);
+    uint32_t bucket_2 = get_bucket_of_size(2);
+    uint32_t bucket_3 = get_bucket_of_size(3);
+    uint32_t bucket_4 = get_bucket_of_size(4);
+    uint32_t bucket_2_31 = get_bucket_of_size((uint64_t)1 << 31);
+    uint32_t bucket_max = get_bucket_of_size(UINT32_MAX);
+
+    ///assert
+    ASSERT_ARE_EQUAL(uint32_t, 0, bucket_0);
+    ASSERT_ARE_EQUAL(uint32_t, 1, bucket_1);
+    ASSERT_ARE_EQUAL(uint32_t, 2, bucket_2);
+    ASSERT_ARE_EQUAL(uint32_t, 2, bucket_3);
+    ASSERT_ARE_EQUAL(uint32_t, 3, bucket_4);
+    ASSERT_ARE_EQUAL(uint32_t, 32, bucket_2_31);
+    ASSERT_ARE_EQUAL(uint32_t, 32, bucket_max);
+}
+
+/*Tests_SRS_CONSTBUFFER_ACCOUNTING_12_004: [ constbuffer_accounting_add shall add 1 to the live handles and size to the live bytes of type in the shard picked by the id of the calling thread. ]*/
+/*Tests_SRS_CONSTBUFFER_ACCOUNTING_12_005: [ If type is not CONSTBUFFER_ACCOUNTING_TYPE_ARRAY then constbuffer_accounting_add shall add 1 to the histogram bucket of size in the same shard. ]*/
+TEST_FUNCTION(constbuffer_accounting_add_with_CONSTBUFFER_ACCOUNTING_TYPE_ARRAY_does_not_count_in_the_histogram)
+{
+    ///arrange
+    CONSTBUFFER_ACCOUNTING_SNAPSHOT snapshot;
+    STRICT_EXPECTED_CALL(ThreadAPI_GetCurrentId());
+
+    ///act
+    constbuffer_accounting_add(CONSTBUFFER_ACCOUNTING_TYPE_ARRAY, 48);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_accounting_get_snapshot(&snapshot));
+    ASSERT_ARE_EQUAL(int64_t, 1, snapshot.by_type[CONSTBUFFER_ACCOUNTING_TYPE_ARRAY].live_handles);
+    ASSERT_ARE_EQUAL(int64_t, 48, snapshot.by_type[CONSTBUFFER_ACCOUNTING_TYPE_ARRAY].live_bytes);
+    for (uint32_t i = 0; i < CONSTBUFFER_ACCOUNTING_HISTOGRAM_BUCKET_COUNT; i++)
+    {
+        ASSERT_ARE_EQUAL(int64_t, 0, snapshot.size_histogram[i]);
+    }
+
+    ///clean
+    constbuffer_accounting_remove(CONSTBUFFER_ACCOUNTING_TYPE_ARRAY, 48);
+}
+
+/* constbuffer_accounting_remove */
+
+/*Tests_SRS_CONSTBUFFER_ACCOUNTING_12_006: [ constbuffer_accounting_remove shall subtract 1 from the live handles and size from the live bytes of type in the shard picked by the id of the calling thread. ]*/
+/*Tests_SRS_CONSTBUFFER_ACCOUNTING_12_007: [ If type is not CONSTBUFFER_ACCOUNTING_TYPE_ARRAY then constbuffer_accounting_remove shall subtract 1 from the histogram bucket of size in the same shard. ]*/
+TEST_FUNCTION(constbuffer_accounting_remove_undoes_constbuffer_accounting_add)
+{
+    ///arrange
+    constbuffer_accounting_add(CONSTBUFFER_ACCOUNTING_TYPE_SHARED_HOT, 1000);
+    constbuffer_accounting_add(CONSTBUFFER_ACCOUNTING_TYPE_ARRAY, 64);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(ThreadAPI_GetCurrentId());
+    STRICT_EXPECTED_CALL(ThreadAPI_GetCurrentId());
+
+    ///act
+    constbuffer_accounting_remove(CONSTBUFFER_ACCOUNTING_TYPE_SHARED_HOT, 1000);
+    constbuffer_accounting_remove(CONSTBUFFER_ACCOUNTING_TYPE_ARRAY, 64);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    assert_snapshot_is_empty();
+}
+
+/*Tests_SRS_CONSTBUFFER_ACCOUNTING_12_006: [ constbuffer_accounting_remove shall subtract 1 from the live handles and size from the live bytes of type in the shard picked by the id of the calling thread. ]*/
+TEST_FUNCTION(constbuffer_accounting_remove_on_another_thread_than_constbuffer_accounting_add_balances_in_the_snapshot)
+{
+    ///arrange
+    STRICT_EXPECTED_CALL(ThreadAPI_GetCurrentId())
+        .SetReturn(1);
+    constbuffer_accounting_add(CONSTBUFFER_ACCOUNTING_TYPE_POOLED, 4096);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(ThreadAPI_GetCurrentId())
+        .SetReturn(2);
+
+    ///act
+    constbuffer_accounting_remove(CONSTBUFFER_ACCOUNTING_TYPE_POOLED, 4096);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    assert_snapshot_is_empty();
+}
+
+END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
@@ -0,0 +1,2056 @@
+// Copyright (c) Microsoft. All rights reserved.
+
+
+#include "constbuffer_array_batcher_nv_async_ut_pch.h"
+
+TEST_DEFINE_ENUM_TYPE(SM_RESULT, SM_RESULT_VALUES);
+IMPLEMENT_UMOCK_C_ENUM_TYPE(SM_RESULT, SM_RESULT_VALUES);
+MU_DEFINE_ENUM_STRINGS(SM_RESULT, SM_RESULT_VALUES);
+
+TEST_DEFINE_ENUM_TYPE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT, CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT_VALUES);
+IMPLEMENT_UMOCK_C_ENUM_TYPE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT, CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT_VALUES);
+
+TEST_DEFINE_ENUM_TYPE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_CALLBACK_RESULT, CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_CALLBACK_RESULT_VALUES);
+IMPLEMENT_UMOCK_C_ENUM_TYPE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_CALLBACK_RESULT, CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_CALLBACK_RESULT_VALUES);
+
+MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    ASSERT_FAIL("umock_c reported error :%" PRI_MU_ENUM "", MU_ENUM_VALUE(UMOCK_C_ERROR_CODE, error_code));
+}
+
+typedef struct THREADPOOL_TAG
+{
+    uint8_t dummy;
+} THREADPOOL;
+
+#include "real_interlocked_renames.h" // IWYU pragma: keep
+REAL_THANDLE_DECLARE(THREADPOOL);
+REAL_THANDLE_DEFINE(THREADPOOL);
+#include "real_interlocked_undo_rename.h" // IWYU pragma: keep
+
+static void dispose_REAL_THREADPOOL_do_nothing(REAL_THREADPOOL* nothing)
+{
+    (void)nothing;
+}
+
+#define TEST_MAX_PAYLOAD_COUNT 10
+#define TEST_MAX_BATCH_SIZE 1024
+#define TEST_MAX_DELAY_MS 10
+
+#define TEST_MAX_SENT_BATCHES 4
+
+static THANDLE(THREADPOOL_TIMER) test_timer = (void*)0x4201;
+static THANDLE(SLIDING_WINDOW_AVERAGE) test_arrival_intervals = (void*)0x4202;
+static void* test_send_batch_context = (void*)0x4203;
+static void* test_payload_context_1 = (void*)0x4211;
+static void* test_payload_context_2 = (void*)0x4212;
+static void* test_payload_context_3 = (void*)0x4213;
+static void* test_payload_context_4 = (void*)0x4214;
+
+typedef struct SENT_BATCH_TAG
+{
+    CONSTBUFFER_ARRAY_HANDLE batch;
+    ON_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_BATCH_SENT on_batch_sent;
+    void* on_batch_sent_context;
+} SENT_BATCH;
+
+static struct G_TAG /*g comes from "global*/
+{
+    THANDLE(THREADPOOL) test_threadpool;
+
+    double now_ms;
+    double average_interval_us;
+
+    THREADPOOL_WORK_FUNCTION timer_callback;
+    void* timer_callback_context;
+
+    THREADPOOL_WORK_FUNCTION work_function;
+    void* work_function_context;
+
+    uint32_t sent_batch_count;
+    SENT_BATCH sent_batches[TEST_MAX_SENT_BATCHES];
+
+    THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) batcher_to_close_during_submit; /*closed by the next submit, between sm_exec_begin and the lock*/
+    bool is_closing_during_submit;
+} g;
+
+MOCK_FUNCTION_WITH_CODE(, int, test_send_batch, void*, context, CONSTBUFFER_ARRAY_HANDLE, batch, ON_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_BATCH_SENT, on_batch_sent, void*, on_batch_sent_context)
+    ASSERT_IS_TRUE(g.sent_batch_count < TEST_MAX_SENT_BATCHES);
+    real_constbuffer_array_inc_ref(batch);
+    g.sent_batches[g.sent_batch_count].batch = batch;
+    g.sent_batches[g.sent_batch_count].on_batch_sent = on_batch_sent;
+    g.sent_batches[g.sent_batch_count].on_batch_sent_context = on_batch_sent_context;
+    g.sent_batch_count++;
+MOCK_FUNCTION_END(0)
+
+MOCK_FUNCTION_WITH_CODE(, void, test_on_payload_complete, void*, context, CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_CALLBACK_RESULT, result)
+MOCK_FUNCTION_END();
+
+/*the timer and the sliding window are fake handles, these hooks give them the value semantics the module relies on*/
+static void hook_THANDLE_INITIALIZE_THREADPOOL_TIMER(THANDLE(THREADPOOL_TIMER)* lvalue, THANDLE(THREADPOOL_TIMER) rvalue)
+{
+    *lvalue = rvalue;
+}
+
+static void hook_THANDLE_ASSIGN_THREADPOOL_TIMER(THANDLE(THREADPOOL_TIMER)* lvalue, THANDLE(THREADPOOL_TIMER) rvalue)
+{
+    *lvalue = rvalue;
+}
+
+static void hook_THANDLE_MOVE_THREADPOOL_TIMER(THANDLE(THREADPOOL_TIMER)* lvalue, THANDLE(THREADPOOL_TIMER)* rvalue)
+{
+    *lvalue = *rvalue;
+    *rvalue = NULL;
+}
+
+static void hook_THANDLE_INITIALIZE_MOVE_SLIDING_WINDOW_AVERAGE(THANDLE(SLIDING_WINDOW_AVERAGE)* lvalue, THANDLE(SLIDING_WINDOW_AVERAGE)* rvalue)
+{
+    *lvalue = *rvalue;
+    *rvalue = NULL;
+}
+
+static void hook_THANDLE_ASSIGN_SLIDING_WINDOW_AVERAGE(THANDLE(SLIDING_WINDOW_AVERAGE)* lvalue, THANDLE(SLIDING_WINDOW_AVERAGE) rvalue)
+{
+    *lvalue = rvalue;
+}
+
+static THANDLE(THREADPOOL_TIMER) hook_threadpool_timer_start(THANDLE(THREADPOOL) threadpool, uint32_t start_delay_ms, uint32_t timer_period_ms, THREADPOOL_WORK_FUNCTION work_function, void* work_function_context)
+{
+    (void)threadpool;
+    (void)start_delay_ms;
+    (void)timer_period_ms;
+    g.timer_callback = work_function;
+    g.timer_callback_context = work_function_context;
+    return test_timer;
+}
+
+static int hook_threadpool_schedule_work(THANDLE(THREADPOOL) threadpool, THREADPOOL_WORK_FUNCTION work_function, void* work_function_context)
+{
+    (void)threadpool;
+    g.work_function = work_function;
+    g.work_function_context = work_function_context;
+    return 0;
+}
+
+static double hook_timer_global_get_elapsed_ms(void)
+{
+    if (g.batcher_to_close_during_submit != NULL)
+    {
+        THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) batcher = NULL;
+        THANDLE_MOVE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC)(&batcher, &g.batcher_to_close_during_submit);
+        g.is_closing_during_submit = true;
+        constbuffer_array_batcher_nv_async_close(batcher);
+        g.is_closing_during_submit = false;
+        THANDLE_ASSIGN(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC)(&batcher, NULL);
+    }
+    return g.now_ms;
+}
+
+/*the real sm_close_begin_with_cb calls the callback and then waits for the submit in progress to call sm_exec_end, on a single thread only the callback can be run*/
+static SM_RESULT hook_sm_close_begin_with_cb(SM_HANDLE sm, ON_SM_CLOSING_COMPLETE_CALLBACK callback, void* callback_context, ON_SM_CLOSING_WHILE_OPENING_CALLBACK on_closing_while_opening_callback, void* on_closing_while_opening_context)
+{
+    SM_RESULT result;
+    if (g.is_closing_during_submit)
+    {
+        callback(callback_context);
+        result = SM_EXEC_GRANTED;
+    }
+    else
+    {
+        result = real_sm_close_begin_with_cb(sm, callback, callback_context, on_closing_while_opening_callback, on_closing_while_opening_context);
+    }
+    return result;
+}
+
+static void hook_sm_close_end(SM_HANDLE sm)
+{
+    if (!g.is_closing_during_submit)
+    {
+        real_sm_close_end(sm);
+    }
+}
+
+static int hook_sliding_window_average_by_count_get(THANDLE(SLIDING_WINDOW_AVERAGE) handle, double* average)
+{
+    (void)handle;
+    *average = g.average_interval_us;
+    return 0;
+}
+
+static CONSTBUFFER_ARRAY_HANDLE create_test_payload(uint32_t size)
+{
+    CONSTBUFFER_ARRAY_HANDLE result;
+    if (size == 0)
+    {
+        result = real_constbuffer_array_create_empty();
+    }
+    else
+    {
+        unsigned char* content = real_gballoc_hl_malloc(size);
+        ASSERT_IS_NOT_NULL(content);
+        for (uint32_t i = 0; i < size; i++)
+        {
+            content[i] = (unsigned char)i;
+        }
+        CONSTBUFFER_HANDLE buffer = real_CONSTBUFFER_Create(content, size);
+        ASSERT_IS_NOT_NULL(buffer);
+        result = real_constbuffer_array_create(&buffer, 1);
+        real_CONSTBUFFER_DecRef(buffer);
+        real_gballoc_hl_free(content);
+    }
+    ASSERT_IS_NOT_NULL(result);
+    return result;
+}
+
+static void expect_create(void)
+{
+    STRICT_EXPECTED_CALL(sm_create(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_create(false, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(sliding_window_average_by_count_create(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(THANDLE_INITIALIZE(THREADPOOL)(IGNORED_ARG, g.test_threadpool));
+    STRICT_EXPECTED_CALL(THANDLE_INITIALIZE_MOVE(SLIDING_WINDOW_AVERAGE)(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(THANDLE_INITIALIZE(THREADPOOL_TIMER)(IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(DList_InitializeListHead(IGNORED_ARG));
+}
+
+/*take_pending_ops moves the pending payloads one by one to the list of payloads to send*/
+static void expect_take_pending_ops(uint32_t pending_count)
+{
+    for (uint32_t i = 0; i < pending_count; i++)
+    {
+        STRICT_EXPECTED_CALL(DList_RemoveHeadList(IGNORED_ARG));
+        STRICT_EXPECTED_CALL(DList_InsertTailList(IGNORED_ARG, IGNORED_ARG));
+    }
+    STRICT_EXPECTED_CALL(DList_RemoveHeadList(IGNORED_ARG));
+}
+
+static THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) test_create_and_open(uint32_t max_payload_count, uint64_t max_batch_size)
+{
+    THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) batcher = constbuffer_array_batcher_nv_async_create(g.test_threadpool, max_payload_count, max_batch_size, TEST_MAX_DELAY_MS, test_send_batch, test_send_batch_context);
+    ASSERT_IS_NOT_NULL(batcher);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_batcher_nv_async_open(batcher));
+    umock_c_reset_all_calls();
+    return batcher;
+}
+
+#define TIMER_ACTION_VALUES \
+    TIMER_ALREADY_RUNNING, \
+    TIMER_STARTED, \
+    TIMER_RESTARTED
+
+MU_DEFINE_ENUM(TIMER_ACTION, TIMER_ACTION_VALUES);
+
+static void expect_send(uint32_t op_count)
+{
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, op_count, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(malloc_2(op_count, sizeof(CONSTBUFFER_ARRAY_HANDLE)));
+    STRICT_EXPECTED_CALL(constbuffer_array_batcher_nv_batch(IGNORED_ARG, op_count));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(test_send_batch(test_send_batch_context, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_dec_ref(IGNORED_ARG));
+}
+
+/*payloads sent in the same call have to be listed in first_batch_op_count and second_batch_op_count*/
+static void expect_submit(CONSTBUFFER_ARRAY_HANDLE payload, TIMER_ACTION timer_action, bool is_first_arrival, uint32_t first_batch_op_count, uint32_t second_batch_op_count)
+{
+    STRICT_EXPECTED_CALL(sm_exec_begin(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size_64(payload, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(async_op_create(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(DList_InitializeListHead(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(DList_InitializeListHead(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_inc_ref(payload));
+    STRICT_EXPECTED_CALL(THANDLE_INITIALIZE(ASYNC_OP)(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_ms());
+    STRICT_EXPECTED_CALL(srw_lock_acquire_exclusive(IGNORED_ARG));
+    switch (timer_action)
+    {
+        case TIMER_STARTED:
+            STRICT_EXPECTED_CALL(threadpool_timer_start(g.test_threadpool, TEST_MAX_DELAY_MS, 0, IGNORED_ARG, IGNORED_ARG));
+            STRICT_EXPECTED_CALL(THANDLE_MOVE(THREADPOOL_TIMER)(IGNORED_ARG, IGNORED_ARG));
+            break;
+        case TIMER_RESTARTED:
+            STRICT_EXPECTED_CALL(threadpool_timer_restart(test_timer, TEST_MAX_DELAY_MS, 0));
+            break;
+        default:
+            break;
+    }
+    if (!is_first_arrival)
+    {
+        STRICT_EXPECTED_CALL(sliding_window_average_by_count_add(test_arrival_intervals, IGNORED_ARG));
+        STRICT_EXPECTED_CALL(sliding_window_average_by_count_get(test_arrival_intervals, IGNORED_ARG));
+    }
+    if (first_batch_op_count > 0)
+    {
+        expect_take_pending_ops(first_batch_op_count);
+    }
+    STRICT_EXPECTED_CALL(DList_InsertTailList(IGNORED_ARG, IGNORED_ARG));
+    if (second_batch_op_count > 0)
+    {
+        expect_take_pending_ops(second_batch_op_count);
+    }
+    STRICT_EXPECTED_CALL(THANDLE_INITIALIZE_MOVE(ASYNC_OP)(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_release_exclusive(IGNORED_ARG));
+    if (first_batch_op_count > 0)
+    {
+        expect_send(first_batch_op_count);
+    }
+    if (second_batch_op_count > 0)
+    {
+        expect_send(second_batch_op_count);
+    }
+    STRICT_EXPECTED_CALL(sm_exec_end(IGNORED_ARG));
+}
+
+static void expect_complete(void* context, CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_CALLBACK_RESULT result)
+{
+    STRICT_EXPECTED_CALL(constbuffer_array_dec_ref(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(test_on_payload_complete(context, result));
+    STRICT_EXPECTED_CALL(THANDLE_INITIALIZE_MOVE(ASYNC_OP)(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(THANDLE_ASSIGN(ASYNC_OP)(IGNORED_ARG, NULL));
+}
+
+static void expect_complete_ops(void** contexts, uint32_t count, CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_CALLBACK_RESULT result)
+{
+    for (uint32_t i = 0; i < count; i++)
+    {
+        STRICT_EXPECTED_CALL(DList_RemoveHeadList(IGNORED_ARG));
+        expect_complete(contexts[i], result);
+    }
+    STRICT_EXPECTED_CALL(DList_RemoveHeadList(IGNORED_ARG));
+}
+
+static void do_submit(THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) batcher, CONSTBUFFER_ARRAY_HANDLE payload, void* context, THANDLE(ASYNC_OP)* out_op)
+{
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT, CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT_OK, constbuffer_array_batcher_nv_async_submit(batcher, payload, test_on_payload_complete, context, out_op));
+}
+
+/*checks that batch holds exactly the payloads (in order)*/
+static void assert_batch_contains(CONSTBUFFER_ARRAY_HANDLE batch, CONSTBUFFER_ARRAY_HANDLE* payloads, uint32_t payload_count)
+{
+    uint32_t unbatched_count;
+    CONSTBUFFER_ARRAY_HANDLE* unbatched = real_constbuffer_array_batcher_nv_unbatch(batch, &unbatched_count);
+    ASSERT_IS_NOT_NULL(unbatched);
+    ASSERT_ARE_EQUAL(uint32_t, payload_count, unbatched_count);
+    for (uint32_t i = 0; i < payload_count; i++)
+    {
+        ASSERT_IS_TRUE(real_CONSTBUFFER_ARRAY_HANDLE_contain_same(payloads[i], unbatched[i]));
+        real_constbuffer_array_dec_ref(unbatched[i]);
+    }
+    real_gballoc_hl_free(unbatched);
+}
+
+static void release_sent_batches(void)
+{
+    for (uint32_t i = 0; i < g.sent_batch_count; i++)
+    {
+        real_constbuffer_array_dec_ref(g.sent_batches[i].batch);
+    }
+    g.sent_batch_count = 0;
+}
+
+BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    ASSERT_ARE_EQUAL(int, 0, real_gballoc_hl_init(NULL, NULL));
+
+    ASSERT_ARE_EQUAL(int, 0, umock_c_init(on_umock_c_error), "umock_c_init");
+    ASSERT_ARE_EQUAL(int, 0, umocktypes_bool_register_types(), "umocktypes_bool_register_types");
+    ASSERT_ARE_EQUAL(int, 0, umocktypes_stdint_register_types(), "umocktypes_stdint_register_types");
+
+    REGISTER_GBALLOC_HL_GLOBAL_MOCK_HOOK();
+    REGISTER_SRW_LOCK_GLOBAL_MOCK_HOOK();
+    REGISTER_SM_GLOBAL_MOCK_HOOK();
+    REGISTER_GLOBAL_MOCK_HOOK(sm_close_begin_with_cb, hook_sm_close_begin_with_cb);
+    REGISTER_GLOBAL_MOCK_HOOK(sm_close_end, hook_sm_close_end);
+    REGISTER_DOUBLYLINKEDLIST_GLOBAL_MOCK_HOOKS();
+    REGISTER_ASYNC_OP_GLOBAL_MOCK_HOOKS();
+    REGISTER_CONSTBUFFER_ARRAY_GLOBAL_MOCK_HOOK();
+    REGISTER_CONSTBUFFER_ARRAY_BATCHER_GLOBAL_MOCK_HOOK();
+    REGISTER_REAL_THANDLE_MOCK_HOOK(THREADPOOL);
+
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(malloc, NULL);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(malloc_2, NULL);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(malloc_flex, NULL);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(sm_create, NULL);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(srw_lock_create, NULL);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(async_op_create, NULL);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(constbuffer_array_get_all_buffers_size_64, MU_FAILURE);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(constbuffer_array_batcher_nv_batch, NULL);
+
+    REGISTER_GLOBAL_MOCK_HOOK(threadpool_timer_start, hook_threadpool_timer_start);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(threadpool_timer_start, NULL);
+    REGISTER_GLOBAL_MOCK_RETURNS(threadpool_timer_restart, 0, MU_FAILURE);
+    REGISTER_GLOBAL_MOCK_HOOK(threadpool_schedule_work, hook_threadpool_schedule_work);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(threadpool_schedule_work, MU_FAILURE);
+    REGISTER_GLOBAL_MOCK_HOOK(THANDLE_INITIALIZE(THREADPOOL_TIMER), hook_THANDLE_INITIALIZE_THREADPOOL_TIMER);
+    REGISTER_GLOBAL_MOCK_HOOK(THANDLE_ASSIGN(THREADPOOL_TIMER), hook_THANDLE_ASSIGN_THREADPOOL_TIMER);
+    REGISTER_GLOBAL_MOCK_HOOK(THANDLE_MOVE(THREADPOOL_TIMER), hook_THANDLE_MOVE_THREADPOOL_TIMER);
+
+    REGISTER_GLOBAL_MOCK_HOOK(timer_global_get_elapsed_ms, hook_timer_global_get_elapsed_ms);
+
+    REGISTER_GLOBAL_MOCK_RETURNS(sliding_window_average_by_count_create, test_arrival_intervals, NULL);
+    REGISTER_GLOBAL_MOCK_RETURNS(sliding_window_average_by_count_add, 0, MU_FAILURE);
+    REGISTER_GLOBAL_MOCK_HOOK(sliding_window_average_by_count_get, hook_sliding_window_average_by_count_get);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(sliding_window_average_by_count_get, MU_FAILURE);
+    REGISTER_GLOBAL_MOCK_HOOK(THANDLE_INITIALIZE_MOVE(SLIDING_WINDOW_AVERAGE), hook_THANDLE_INITIALIZE_MOVE_SLIDING_WINDOW_AVERAGE);
+    REGISTER_GLOBAL_MOCK_HOOK(THANDLE_ASSIGN(SLIDING_WINDOW_AVERAGE), hook_THANDLE_ASSIGN_SLIDING_WINDOW_AVERAGE);
+
+    REGISTER_UMOCK_ALIAS_TYPE(SM_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(ON_SM_CLOSING_COMPLETE_CALLBACK, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(ON_SM_CLOSING_WHILE_OPENING_CALLBACK, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(SRW_LOCK_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(PDLIST_ENTRY, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(THANDLE(THREADPOOL), void*);
+    REGISTER_UMOCK_ALIAS_TYPE(THANDLE(THREADPOOL_TIMER), void*);
+    REGISTER_UMOCK_ALIAS_TYPE(THREADPOOL_WORK_FUNCTION, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(THANDLE(SLIDING_WINDOW_AVERAGE), void*);
+    REGISTER_UMOCK_ALIAS_TYPE(ASYNC_OP_CANCEL_IMPL, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(ASYNC_OP_DISPOSE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(THANDLE(ASYNC_OP), void*);
+    REGISTER_UMOCK_ALIAS_TYPE(CONSTBUFFER_ARRAY_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(ON_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_BATCH_SENT, void*);
+
+    REGISTER_TYPE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT, CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT);
+    REGISTER_TYPE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_CALLBACK_RESULT, CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_CALLBACK_RESULT);
+
+    THANDLE(THREADPOOL) threadpool = THANDLE_MALLOC(REAL_THREADPOOL)(dispose_REAL_THREADPOOL_do_nothing);
+    ASSERT_IS_NOT_NULL(threadpool);
+    THANDLE_MOVE(REAL_THREADPOOL)(&g.test_threadpool, &threadpool);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    THANDLE_ASSIGN(REAL_THREADPOOL)(&g.test_threadpool, NULL);
+
+    umock_c_deinit();
+
+    real_gballoc_hl_deinit();
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    g.now_ms = 1000;
+    g.average_interval_us = 0;
+    g.timer_callback = NULL;
+    g.timer_callback_context = NULL;
+    g.work_function = NULL;
+    g.work_function_context = NULL;
+    g.sent_batch_count = 0;
+    g.is_closing_during_submit = false;
+
+    umock_c_reset_all_calls();
+    umock_c_negative_tests_init();
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    release_sent_batches();
+
+    umock_c_negative_tests_deinit();
+}
+
+/* constbuffer_array_batcher_nv_async_create */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_001: [ If threadpool is NULL then constbuffer_array_batcher_nv_async_create shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_async_create_with_NULL_threadpool_fails)
+{
+    // arrange
+
+    // act
+    THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) result = constbuffer_array_batcher_nv_async_create(NULL, TEST_MAX_PAYLOAD_COUNT, TEST_MAX_BATCH_SIZE, TEST_MAX_DELAY_MS, test_send_batch, test_send_batch_context);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_002: [ If max_payload_count is 0 or greater than UINT32_MAX / sizeof(uint32_t) - 1 then constbuffer_array_batcher_nv_async_create shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_async_create_with_0_max_payload_count_fails)
+{
+    // arrange
+
+    // act
+    THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) result = constbuffer_array_batcher_nv_async_create(g.test_threadpool, 0, TEST_MAX_BATCH_SIZE, TEST_MAX_DELAY_MS, test_send_batch, test_send_batch_context);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_002: [ If max_payload_count is 0 or greater than UINT32_MAX / sizeof(uint32_t) - 1 then constbuffer_array_batcher_nv_async_create shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_async_create_with_too_big_max_payload_count_fails)
+{
+    // arrange
+
+    // act
+    THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) result = constbuffer_array_batcher_nv_async_create(g.test_threadpool, UINT32_MAX / sizeof(uint32_t), TEST_MAX_BATCH_SIZE, TEST_MAX_DELAY_MS, test_send_batch, test_send_batch_context);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_003: [ If max_batch_size is 0 then constbuffer_array_batcher_nv_async_create shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_async_create_with_0_max_batch_size_fails)
+{
+    // arrange
+
+    // act
+    THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) result = constbuffer_array_batcher_nv_async_create(g.test_threadpool, TEST_MAX_PAYLOAD_COUNT, 0, TEST_MAX_DELAY_MS, test_send_batch, test_send_batch_context);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_004: [ If max_delay_ms is 0 then constbuffer_array_batcher_nv_async_create shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_async_create_with_0_max_delay_ms_fails)
+{
+    // arrange
+
+    // act
+    THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) result = constbuffer_array_batcher_nv_async_create(g.test_threadpool, TEST_MAX_PAYLOAD_COUNT, TEST_MAX_BATCH_SIZE, 0, test_send_batch, test_send_batch_context);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_005: [ If send_batch is NULL then constbuffer_array_batcher_nv_async_create shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_async_create_with_NULL_send_batch_fails)
+{
+    // arrange
+
+    // act
+    THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) result = constbuffer_array_batcher_nv_async_create(g.test_threadpool, TEST_MAX_PAYLOAD_COUNT, TEST_MAX_BATCH_SIZE, TEST_MAX_DELAY_MS, NULL, test_send_batch_context);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_006: [ constbuffer_array_batcher_nv_async_create shall call sm_create, srw_lock_create and sliding_window_average_by_count_create. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_007: [ constbuffer_array_batcher_nv_async_create shall allocate a THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) by calling THANDLE_MALLOC with constbuffer_array_batcher_nv_async_dispose, store the parameters, succeed and return it. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_async_create_succeeds)
+{
+    // arrange
+    expect_create();
+
+    // act
+    THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) result = constbuffer_array_batcher_nv_async_create(g.test_threadpool, TEST_MAX_PAYLOAD_COUNT, TEST_MAX_BATCH_SIZE, TEST_MAX_DELAY_MS, test_send_batch, test_send_batch_context);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    THANDLE_ASSIGN(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC)(&result, NULL);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_008: [ If there are any failures then constbuffer_array_batcher_nv_async_create shall fail and return NULL. ]*/
+TEST_FUNCTION(when_underlying_calls_fail_constbuffer_array_batcher_nv_async_create_fails)
+{
+    // arrange
+    expect_create();
+
+    umock_c_negative_tests_snapshot();
+
+    for (size_t i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
+        if (umock_c_negative_tests_can_call_fail(i))
+        {
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(i);
+
+            // act
+            THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) result = constbuffer_array_batcher_nv_async_create(g.test_threadpool, TEST_MAX_PAYLOAD_COUNT, TEST_MAX_BATCH_SIZE, TEST_MAX_DELAY_MS, test_send_batch, test_send_batch_context);
+
+            // assert
+            ASSERT_IS_NULL(result, "On failed call %zu", i);
+        }
+    }
+}
+
+/* constbuffer_array_batcher_nv_async_dispose */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_009: [ constbuffer_array_batcher_nv_async_dispose shall release the timer (if any), the sliding window average and the threadpool, and call srw_lock_destroy and sm_destroy. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_async_dispose_releases_everything)
+{
+    // arrange
+    THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) batcher = constbuffer_array_batcher_nv_async_create(g.test_threadpool, TEST_MAX_PAYLOAD_COUNT, TEST_MAX_BATCH_SIZE, TEST_MAX_DELAY_MS, test_send_batch, test_send_batch_context);
+    ASSERT_IS_NOT_NULL(batcher);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(THANDLE_ASSIGN(THREADPOOL_TIMER)(IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(THANDLE_ASSIGN(SLIDING_WINDOW_AVERAGE)(IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(THANDLE_ASSIGN(THREADPOOL)(IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(srw_lock_destroy(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(sm_destroy(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    // act
+    THANDLE_ASSIGN(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC)(&batcher, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* constbuffer_array_batcher_nv_async_open */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_010: [ If batcher is NULL then constbuffer_array_batcher_nv_async_open shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_async_open_with_NULL_batcher_fails)
+{
+    // arrange
+
+    // act
+    int result = constbuffer_array_batcher_nv_async_open(NULL);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_011: [ constbuffer_array_batcher_nv_async_open shall call sm_open_begin. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_076: [ constbuffer_array_batcher_nv_async_open shall set is_closing to false. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_012: [ constbuffer_array_batcher_nv_async_open shall call sm_open_end, succeed and return 0. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_async_open_succeeds)
+{
+    // arrange
+    THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) batcher = constbuffer_array_batcher_nv_async_create(g.test_threadpool, TEST_MAX_PAYLOAD_COUNT, TEST_MAX_BATCH_SIZE, TEST_MAX_DELAY_MS, test_send_batch, test_send_batch_context);
+    ASSERT_IS_NOT_NULL(batcher);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(sm_open_begin(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(sm_open_end(IGNORED_ARG, true));
+
+    // act
+    int result = constbuffer_array_batcher_nv_async_open(batcher);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    constbuffer_array_batcher_nv_async_close(batcher);
+    THANDLE_ASSIGN(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC)(&batcher, NULL);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_013: [ If there are any failures then constbuffer_array_batcher_nv_async_open shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_async_open_when_already_open_fails)
+{
+    // arrange
+    THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) batcher = test_create_and_open(TEST_MAX_PAYLOAD_COUNT, TEST_MAX_BATCH_SIZE);
+
+    STRICT_EXPECTED_CALL(sm_open_begin(IGNORED_ARG));
+
+    // act
+    int result = constbuffer_array_batcher_nv_async_open(batcher);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    constbuffer_array_batcher_nv_async_close(batcher);
+    THANDLE_ASSIGN(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC)(&batcher, NULL);
+}
+
+/* constbuffer_array_batcher_nv_async_close */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_014: [ If batcher is NULL then constbuffer_array_batcher_nv_async_close shall return. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_async_close_with_NULL_batcher_returns)
+{
+    // arrange
+
+    // act
+    constbuffer_array_batcher_nv_async_close(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_015: [ constbuffer_array_batcher_nv_async_close shall call sm_close_begin_with_cb with abandon_pending_ops as the callback. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_016: [ constbuffer_array_batcher_nv_async_close shall release the timer and call sm_close_end. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_async_close_with_no_pending_payloads_succeeds)
+{
+    // arrange
+    THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) batcher = test_create_and_open(TEST_MAX_PAYLOAD_COUNT, TEST_MAX_BATCH_SIZE);
+
+    STRICT_EXPECTED_CALL(sm_close_begin_with_cb(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, NULL, NULL));
+    STRICT_EXPECTED_CALL(DList_InitializeListHead(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_acquire_exclusive(IGNORED_ARG));
+    expect_take_pending_ops(0);
+    STRICT_EXPECTED_CALL(srw_lock_release_exclusive(IGNORED_ARG));
+    expect_complete_ops(NULL, 0, CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_CALLBACK_RESULT_ABANDONED);
+    STRICT_EXPECTED_CALL(THANDLE_ASSIGN(THREADPOOL_TIMER)(IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(sm_close_end(IGNORED_ARG));
+
+    // act
+    constbuffer_array_batcher_nv_async_close(batcher);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    THANDLE_ASSIGN(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC)(&batcher, NULL);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_017: [ abandon_pending_ops shall take all the pending payloads under the lock. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_077: [ abandon_pending_ops shall set is_closing to true under the lock. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_018: [ abandon_pending_ops shall complete all the payloads it took with CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_CALLBACK_RESULT_ABANDONED. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_async_close_abandons_the_pending_payloads)
+{
+    // arrange
+    THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) batcher = test_create_and_open(TEST_MAX_PAYLOAD_COUNT, TEST_MAX_BATCH_SIZE);
+    CONSTBUFFER_ARRAY_HANDLE payload = create_test_payload(0);
+    THANDLE(ASYNC_OP) op_1 = NULL;
+    THANDLE(ASYNC_OP) op_2 = NULL;
+    do_submit(batcher, payload, test_payload_context_1, &op_1);
+    do_submit(batcher, payload, test_payload_context_2, &op_2);
+    void* contexts[2] = { test_payload_context_1, test_payload_context_2 };
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(sm_close_begin_with_cb(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, NULL, NULL));
+    STRICT_EXPECTED_CALL(DList_InitializeListHead(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_acquire_exclusive(IGNORED_ARG));
+    expect_take_pending_ops(2);
+    STRICT_EXPECTED_CALL(srw_lock_release_exclusive(IGNORED_ARG));
+    expect_complete_ops(contexts, 2, CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_CALLBACK_RESULT_ABANDONED);
+    STRICT_EXPECTED_CALL(THANDLE_ASSIGN(THREADPOOL_TIMER)(IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(sm_close_end(IGNORED_ARG));
+
+    // act
+    constbuffer_array_batcher_nv_async_close(batcher);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 0, g.sent_batch_count);
+
+    // cleanup
+    THANDLE_ASSIGN(ASYNC_OP)(&op_1, NULL);
+    THANDLE_ASSIGN(ASYNC_OP)(&op_2, NULL);
+    real_constbuffer_array_dec_ref(payload);
+    THANDLE_ASSIGN(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC)(&batcher, NULL);
+}
+
+/* constbuffer_array_batcher_nv_async_submit */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_019: [ If batcher is NULL then constbuffer_array_batcher_nv_async_submit shall fail and return CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT_INVALID_ARGS. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_async_submit_with_NULL_batcher_fails)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE payload = create_test_payload(0);
+    THANDLE(ASYNC_OP) op = NULL;
+
+    // act
+    CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT result = constbuffer_array_batcher_nv_async_submit(NULL, payload, test_on_payload_complete, test_payload_context_1, &op);
+
+    // assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT, CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT_INVALID_ARGS, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(op);
+
+    // cleanup
+    real_constbuffer_array_dec_ref(payload);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_020: [ If payload is NULL then constbuffer_array_batcher_nv_async_submit shall fail and return CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT_INVALID_ARGS. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_async_submit_with_NULL_payload_fails)
+{
+    // arrange
+    THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) batcher = test_create_and_open(TEST_MAX_PAYLOAD_COUNT, TEST_MAX_BATCH_SIZE);
+    THANDLE(ASYNC_OP) op = NULL;
+
+    // act
+    CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT result = constbuffer_array_batcher_nv_async_submit(batcher, NULL, test_on_payload_complete, test_payload_context_1, &op);
+
+    // assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT, CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT_INVALID_ARGS, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(op);
+
+    // cleanup
+    constbuffer_array_batcher_nv_async_close(batcher);
+    THANDLE_ASSIGN(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC)(&batcher, NULL);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_021: [ If on_payload_complete is NULL then constbuffer_array_batcher_nv_async_submit shall fail and return CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT_INVALID_ARGS. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_async_submit_with_NULL_on_payload_complete_fails)
+{
+    // arrange
+    THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) batcher = test_create_and_open(TEST_MAX_PAYLOAD_COUNT, TEST_MAX_BATCH_SIZE);
+    CONSTBUFFER_ARRAY_HANDLE payload = create_test_payload(0);
+    THANDLE(ASYNC_OP) op = NULL;
+
+    // act
+    CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT result = constbuffer_array_batcher_nv_async_submit(batcher, payload, NULL, test_payload_context_1, &op);
+
+    // assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT, CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT_INVALID_ARGS, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(op);
+
+    // cleanup
+    real_constbuffer_array_dec_ref(payload);
+    constbuffer_array_batcher_nv_async_close(batcher);
+    THANDLE_ASSIGN(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC)(&batcher, NULL);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_022: [ If out_op is NULL then constbuffer_array_batcher_nv_async_submit shall fail and return CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT_INVALID_ARGS. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_async_submit_with_NULL_out_op_fails)
+{
+    // arrange
+    THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) batcher = test_create_and_open(TEST_MAX_PAYLOAD_COUNT, TEST_MAX_BATCH_SIZE);
+    CONSTBUFFER_ARRAY_HANDLE payload = create_test_payload(0);
+
+    // act
+    CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT result = constbuffer_array_batcher_nv_async_submit(batcher, payload, test_on_payload_complete, test_payload_context_1, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT, CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT_INVALID_ARGS, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    real_constbuffer_array_dec_ref(payload);
+    constbuffer_array_batcher_nv_async_close(batcher);
+    THANDLE_ASSIGN(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC)(&batcher, NULL);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_042: [ If there are any failures then constbuffer_array_batcher_nv_async_submit shall fail and return CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT_ERROR. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_async_submit_when_not_open_fails)
+{
+    // arrange
+    THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) batcher = constbuffer_array_batcher_nv_async_create(g.test_threadpool, TEST_MAX_PAYLOAD_COUNT, TEST_MAX_BATCH_SIZE, TEST_MAX_DELAY_MS, test_send_batch, test_send_batch_context);
+    ASSERT_IS_NOT_NULL(batcher);
+    CONSTBUFFER_ARRAY_HANDLE payload = create_test_payload(0);
+    THANDLE(ASYNC_OP) op = NULL;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(sm_exec_begin(IGNORED_ARG));
+
+    // act
+    CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT result = constbuffer_array_batcher_nv_async_submit(batcher, payload, test_on_payload_complete, test_payload_context_1, &op);
+
+    // assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT, CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(op);
+
+    // cleanup
+    real_constbuffer_array_dec_ref(payload);
+    THANDLE_ASSIGN(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC)(&batcher, NULL);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_023: [ constbuffer_array_batcher_nv_async_submit shall call sm_exec_begin. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_024: [ constbuffer_array_batcher_nv_async_submit shall get the size of payload by calling constbuffer_array_get_all_buffers_size_64. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_025: [ constbuffer_array_batcher_nv_async_submit shall create a THANDLE(ASYNC_OP) by calling async_op_create with cancel_op as cancel and dispose_op as dispose. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_026: [ constbuffer_array_batcher_nv_async_submit shall increment the reference count of payload and store it, its size, on_payload_complete and context in the operation. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_027: [ constbuffer_array_batcher_nv_async_submit shall record the time of the submit by calling timer_global_get_elapsed_ms. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_028: [ constbuffer_array_batcher_nv_async_submit shall call srw_lock_acquire_exclusive. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_029: [ If the timer has not been started yet then constbuffer_array_batcher_nv_async_submit shall start it by calling threadpool_timer_start with max_delay_ms and on_timer. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_032: [ constbuffer_array_batcher_nv_async_submit shall add the operation to the pending payloads. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_034: [ constbuffer_array_batcher_nv_async_submit shall set *out_op to the created THANDLE(ASYNC_OP). ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_035: [ constbuffer_array_batcher_nv_async_submit shall call srw_lock_release_exclusive. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_040: [ constbuffer_array_batcher_nv_async_submit shall succeed and return CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT_OK. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_041: [ constbuffer_array_batcher_nv_async_submit shall call sm_exec_end. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_async_submit_first_payload_starts_the_timer_and_keeps_the_payload_pending)
+{
+    // arrange
+    THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) batcher = test_create_and_open(TEST_MAX_PAYLOAD_COUNT, TEST_MAX_BATCH_SIZE);
+    CONSTBUFFER_ARRAY_HANDLE payload = create_test_payload(0);
+    THANDLE(ASYNC_OP) op = NULL;
+
+    expect_submit(payload, TIMER_STARTED, true, 0, 0);
+
+    // act
+    CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT result = constbuffer_array_batcher_nv_async_submit(batcher, payload, test_on_payload_complete, test_payload_context_1, &op);
+
+    // assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT, CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(op);
+    ASSERT_IS_NOT_NULL(g.timer_callback);
+    ASSERT_ARE_EQUAL(uint32_t, 0, g.sent_batch_count);
+
+    // cleanup
+    constbuffer_array_batcher_nv_async_close(batcher);
+    THANDLE_ASSIGN(ASYNC_OP)(&op, NULL);
+    real_constbuffer_array_dec_ref(payload);
+    THANDLE_ASSIGN(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC)(&batcher, NULL);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_042: [ If there are any failures then constbuffer_array_batcher_nv_async_submit shall fail and return CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT_ERROR. ]*/
+TEST_FUNCTION(when_underlying_calls_fail_constbuffer_array_batcher_nv_async_submit_fails)
+{
+    // arrange
+    THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) batcher = test_create_and_open(TEST_MAX_PAYLOAD_COUNT, TEST_MAX_BATCH_SIZE);
+    CONSTBUFFER_ARRAY_HANDLE payload = create_test_payload(0);
+
+    expect_submit(payload, TIMER_STARTED, true, 0, 0);
+
+    umock_c_negative_tests_snapshot();
+
+    for (size_t i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
+        if (umock_c_negative_tests_can_call_fail(i))
+        {
+            THANDLE(ASYNC_OP) op = NULL;
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(i);
+
+            // act
+            CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT result = constbuffer_array_batcher_nv_async_submit(batcher, payload, test_on_payload_complete, test_payload_context_1, &op);
+
+            // assert
+            ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT, CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT_ERROR, result, "On failed call %zu", i);
+            ASSERT_IS_NULL(op, "On failed call %zu", i);
+        }
+    }
+
+    // cleanup
+    constbuffer_array_batcher_nv_async_close(batcher);
+    real_constbuffer_array_dec_ref(payload);
+    THANDLE_ASSIGN(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC)(&batcher, NULL);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_036: [ constbuffer_array_batcher_nv_async_submit shall add the time since the previous submit (in microseconds) to the sliding window average of arrival intervals by calling sliding_window_average_by_count_add. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_037: [ constbuffer_array_batcher_nv_async_submit shall get the average arrival interval by calling sliding_window_average_by_count_get. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_async_submit_adds_the_arrival_interval_to_the_sliding_window)
+{
+    // arrange
+    THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) batcher = test_create_and_open(TEST_MAX_PAYLOAD_COUNT, TEST_MAX_BATCH_SIZE);
+    CONSTBUFFER_ARRAY_HANDLE payload = create_test_payload(0);
+    THANDLE(ASYNC_OP) op_1 = NULL;
+    THANDLE(ASYNC_OP) op_2 = NULL;
+    do_submit(batcher, payload, test_payload_context_1, &op_1);
+    umock_c_reset_all_calls();
+
+    g.now_ms += 0.25;
+    /*payloads arrive every 250us so 40 are expected in 10ms, the limit is TEST_MAX_PAYLOAD_COUNT*/
+    g.average_interval_us = 250;
+    expect_submit(payload, TIMER_ALREADY_RUNNING, false, 0, 0);
+    STRICT_EXPECTED_CALL(sliding_window_average_by_count_add(test_arrival_intervals, 250));
+
+    // act
+    CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT result = constbuffer_array_batcher_nv_async_submit(batcher, payload, test_on_payload_complete, test_payload_context_2, &op_2);
+
+    // assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT, CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT_OK, result);
+    ASSERT_ARE_EQUAL(uint32_t, 0, g.sent_batch_count);
+
+    // cleanup
+    umock_c_reset_all_calls();
+    constbuffer_array_batcher_nv_async_close(batcher);
+    THANDLE_ASSIGN(ASYNC_OP)(&op_1, NULL);
+    THANDLE_ASSIGN(ASYNC_OP)(&op_2, NULL);
+    real_constbuffer_array_dec_ref(payload);
+    THANDLE_ASSIGN(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC)(&batcher, NULL);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_038: [ The number of payloads that triggers a batch shall be the number of payloads expected to arrive in max_delay_ms at the average arrival interval, but no less than 1 and no more than max_payload_count. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_033: [ If the number of pending payloads reached the number of payloads that triggers a batch or the pending payloads reached max_batch_size bytes then constbuffer_array_batcher_nv_async_submit shall take all the pending payloads to be sent as one batch. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_039: [ constbuffer_array_batcher_nv_async_submit shall send the payloads it took (if any) by calling constbuffer_array_batcher_nv_batch and send_batch outside of the lock, in the order they were taken. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_async_submit_sends_when_the_payloads_expected_in_max_delay_ms_have_arrived)
+{
+    // arrange
+    THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) batcher = test_create_and_open(TEST_MAX_PAYLOAD_COUNT, TEST_MAX_BATCH_SIZE);
+    CONSTBUFFER_ARRAY_HANDLE payloads[3];
+    THANDLE(ASYNC_OP) ops[3] = { NULL, NULL, NULL };
+    void* contexts[3] = { test_payload_context_1, test_payload_context_2, test_payload_context_3 };
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        payloads[i] = create_test_payload(i + 1);
+    }
+
+    /*payloads arrive every 3.5ms so 2 (rounded down) are expected in 10ms*/
+    g.average_interval_us = 3500;
+    do_submit(batcher, payloads[0], contexts[0], &ops[0]);
+    g.now_ms += 3.5;
+    umock_c_reset_all_calls();
+
+    expect_submit(payloads[1], TIMER_ALREADY_RUNNING, false, 0, 2);
+
+    // act
+    CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT result = constbuffer_array_batcher_nv_async_submit(batcher, payloads[1], test_on_payload_complete, contexts[1], &ops[1]);
+
+    // assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT, CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 1, g.sent_batch_count);
+    assert_batch_contains(g.sent_batches[0].batch, payloads, 2);
+
+    /*the next payload starts a new batch*/
+    g.now_ms += 3.5;
+    do_submit(batcher, payloads[2], contexts[2], &ops[2]);
+    ASSERT_ARE_EQUAL(uint32_t, 1, g.sent_batch_count);
+
+    // cleanup
+    g.sent_batches[0].on_batch_sent(g.sent_batches[0].on_batch_sent_context, true);
+    constbuffer_array_batcher_nv_async_close(batcher);
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        THANDLE_ASSIGN(ASYNC_OP)(&ops[i], NULL);
+        real_constbuffer_array_dec_ref(payloads[i]);
+    }
+    THANDLE_ASSIGN(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC)(&batcher, NULL);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_038: [ The number of payloads that triggers a batch shall be the number of payloads expected to arrive in max_delay_ms at the average arrival interval, but no less than 1 and no more than max_payload_count. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_async_submit_sends_right_away_when_payloads_arrive_slower_than_max_delay_ms)
+{
+    // arrange
+    THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) batcher = test_create_and_open(TEST_MAX_PAYLOAD_COUNT, TEST_MAX_BATCH_SIZE);
+    CONSTBUFFER_ARRAY_HANDLE payload = create_test_payload(0);
+    THANDLE(ASYNC_OP) op_1 = NULL;
+    THANDLE(ASYNC_OP) op_2 = NULL;
+    THANDLE(ASYNC_OP) op_3 = NULL;
+    do_submit(batcher, payload, test_payload_context_1, &op_1);
+    g.now_ms += 5;
+    g.average_interval_us = 50000;
+    do_submit(batcher, payload, test_payload_context_2, &op_2);
+    ASSERT_ARE_EQUAL(uint32_t, 1, g.sent_batch_count);
+    g.now_ms += 50;
+    umock_c_reset_all_calls();
+
+    /*there are no pending payloads, the timer is restarted and the payload is sent right away*/
+    expect_submit(payload, TIMER_RESTARTED, false, 0, 1);
+
+    // act
+    CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT result = constbuffer_array_batcher_nv_async_submit(batcher, payload, test_on_payload_complete, test_payload_context_3, &op_3);
+
+    // assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT, CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 2, g.sent_batch_count);
+    assert_batch_contains(g.sent_batches[1].batch, &payload, 1);
+
+    // cleanup
+    g.sent_batches[0].on_batch_sent(g.sent_batches[0].on_batch_sent_context, true);
+    g.sent_batches[1].on_batch_sent(g.sent_batches[1].on_batch_sent_context, true);
+    constbuffer_array_batcher_nv_async_close(batcher);
+    THANDLE_ASSIGN(ASYNC_OP)(&op_1, NULL);
+    THANDLE_ASSIGN(ASYNC_OP)(&op_2, NULL);
+    THANDLE_ASSIGN(ASYNC_OP)(&op_3, NULL);
+    real_constbuffer_array_dec_ref(payload);
+    THANDLE_ASSIGN(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC)(&batcher, NULL);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_038: [ The number of payloads that triggers a batch shall be the number of payloads expected to arrive in max_delay_ms at the average arrival interval, but no less than 1 and no more than max_payload_count. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_async_submit_sends_at_max_payload_count)
+{
+    // arrange
+    THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) batcher = test_create_and_open(3, TEST_MAX_BATCH_SIZE);
+    CONSTBUFFER_ARRAY_HANDLE payloads[3];
+    THANDLE(ASYNC_OP) ops[3] = { NULL, NULL, NULL };
+    void* contexts[3] = { test_payload_context_1, test_payload_context_2, test_payload_context_3 };
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        payloads[i] = create_test_payload(0);
+    }
+
+    /*payloads arrive every 1us, a lot more than max_payload_count are expected in 10ms*/
+    g.average_interval_us = 1;
+    do_submit(batcher, payloads[0], contexts[0], &ops[0]);
+    g.now_ms += 0.001;
+    do_submit(batcher, payloads[1], contexts[1], &ops[1]);
+    g.now_ms += 0.001;
+    umock_c_reset_all_calls();
+
+    expect_submit(payloads[2], TIMER_ALREADY_RUNNING, false, 0, 3);
+
+    // act
+    CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT result = constbuffer_array_batcher_nv_async_submit(batcher, payloads[2], test_on_payload_complete, contexts[2], &ops[2]);
+
+    // assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT, CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 1, g.sent_batch_count);
+    assert_batch_contains(g.sent_batches[0].batch, payloads, 3);
+
+    // cleanup
+    g.sent_batches[0].on_batch_sent(g.sent_batches[0].on_batch_sent_context, true);
+    constbuffer_array_batcher_nv_async_close(batcher);
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        THANDLE_ASSIGN(ASYNC_OP)(&ops[i], NULL);
+        real_constbuffer_array_dec_ref(payloads[i]);
+    }
+    THANDLE_ASSIGN(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC)(&batcher, NULL);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_038: [ The number of payloads that triggers a batch shall be the number of payloads expected to arrive in max_delay_ms at the average arrival interval, but no less than 1 and no more than max_payload_count. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_async_submit_uses_max_payload_count_when_sliding_window_average_by_count_get_fails)
+{
+    // arrange
+    THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) batcher = test_create_and_open(TEST_MAX_PAYLOAD_COUNT, TEST_MAX_BATCH_SIZE);
+    CONSTBUFFER_ARRAY_HANDLE payload = create_test_payload(0);
+    THANDLE(ASYNC_OP) op_1 = NULL;
+    THANDLE(ASYNC_OP) op_2 = NULL;
+    do_submit(batcher, payload, test_payload_context_1, &op_1);
+    g.now_ms += 50;
+    umock_c_reset_all_calls();
+
+    /*with a working average the payload would be sent right away*/
+    g.average_interval_us = 50000;
+    STRICT_EXPECTED_CALL(sm_exec_begin(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size_64(payload, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(async_op_create(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(DList_InitializeListHead(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(DList_InitializeListHead(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_inc_ref(payload));
+    STRICT_EXPECTED_CALL(THANDLE_INITIALIZE(ASYNC_OP)(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_ms());
+    STRICT_EXPECTED_CALL(srw_lock_acquire_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(sliding_window_average_by_count_add(test_arrival_intervals, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(sliding_window_average_by_count_get(test_arrival_intervals, IGNORED_ARG))
+        .SetReturn(MU_FAILURE);
+    STRICT_EXPECTED_CALL(DList_InsertTailList(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(THANDLE_INITIALIZE_MOVE(ASYNC_OP)(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_release_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(sm_exec_end(IGNORED_ARG));
+
+    // act
+    CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT result = constbuffer_array_batcher_nv_async_submit(batcher, payload, test_on_payload_complete, test_payload_context_2, &op_2);
+
+    // assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT, CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 0, g.sent_batch_count);
+
+    // cleanup
+    constbuffer_array_batcher_nv_async_close(batcher);
+    THANDLE_ASSIGN(ASYNC_OP)(&op_1, NULL);
+    THANDLE_ASSIGN(ASYNC_OP)(&op_2, NULL);
+    real_constbuffer_array_dec_ref(payload);
+    THANDLE_ASSIGN(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC)(&batcher, NULL);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_031: [ If adding payload to the pending payloads would go over max_payload_count payloads or over max_batch_size bytes then constbuffer_array_batcher_nv_async_submit shall first take all the pending payloads to be sent as one batch. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_async_submit_sends_the_pending_payloads_first_when_the_payload_does_not_fit)
+{
+    // arrange
+    /*a batch with 1 payload of 8 bytes is 16 bytes, with 2 it is 28 bytes*/
+    THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) batcher = test_create_and_open(TEST_MAX_PAYLOAD_COUNT, 20);
+    CONSTBUFFER_ARRAY_HANDLE payload_1 = create_test_payload(8);
+    CONSTBUFFER_ARRAY_HANDLE payload_2 = create_test_payload(8);
+    THANDLE(ASYNC_OP) op_1 = NULL;
+    THANDLE(ASYNC_OP) op_2 = NULL;
+    g.average_interval_us = 1;
+    do_submit(batcher, payload_1, test_payload_context_1, &op_1);
+    g.now_ms += 0.001;
+    umock_c_reset_all_calls();
+
+    expect_submit(payload_2, TIMER_ALREADY_RUNNING, false, 1, 0);
+
+    // act
+    CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT result = constbuffer_array_batcher_nv_async_submit(batcher, payload_2, test_on_payload_complete, test_payload_context_2, &op_2);
+
+    // assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT, CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 1, g.sent_batch_count);
+    assert_batch_contains(g.sent_batches[0].batch, &payload_1, 1);
+
+    // cleanup
+    g.sent_batches[0].on_batch_sent(g.sent_batches[0].on_batch_sent_context, true);
+    constbuffer_array_batcher_nv_async_close(batcher);
+    THANDLE_ASSIGN(ASYNC_OP)(&op_1, NULL);
+    THANDLE_ASSIGN(ASYNC_OP)(&op_2, NULL);
+    real_constbuffer_array_dec_ref(payload_1);
+    real_constbuffer_array_dec_ref(payload_2);
+    THANDLE_ASSIGN(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC)(&batcher, NULL);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_033: [ If the number of pending payloads reached the number of payloads that triggers a batch or the pending payloads reached max_batch_size bytes then constbuffer_array_batcher_nv_async_submit shall take all the pending payloads to be sent as one batch. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_async_submit_sends_when_max_batch_size_is_reached)
+{
+    // arrange
+    /*a batch with 2 payloads of 4 bytes is 20 bytes*/
+    THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) batcher = test_create_and_open(TEST_MAX_PAYLOAD_COUNT, 20);
+    CONSTBUFFER_ARRAY_HANDLE payloads[2];
+    payloads[0] = create_test_payload(4);
+    payloads[1] = create_test_payload(4);
+    THANDLE(ASYNC_OP) op_1 = NULL;
+    THANDLE(ASYNC_OP) op_2 = NULL;
+    g.average_interval_us = 1;
+    do_submit(batcher, payloads[0], test_payload_context_1, &op_1);
+    g.now_ms += 0.001;
+    umock_c_reset_all_calls();
+
+    expect_submit(payloads[1], TIMER_ALREADY_RUNNING, false, 0, 2);
+
+    // act
+    CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT result = constbuffer_array_batcher_nv_async_submit(batcher, payloads[1], test_on_payload_complete, test_payload_context_2, &op_2);
+
+    // assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT, CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 1, g.sent_batch_count);
+    assert_batch_contains(g.sent_batches[0].batch, payloads, 2);
+
+    // cleanup
+    g.sent_batches[0].on_batch_sent(g.sent_batches[0].on_batch_sent_context, true);
+    constbuffer_array_batcher_nv_async_close(batcher);
+    THANDLE_ASSIGN(ASYNC_OP)(&op_1, NULL);
+    THANDLE_ASSIGN(ASYNC_OP)(&op_2, NULL);
+    real_constbuffer_array_dec_ref(payloads[0]);
+    real_constbuffer_array_dec_ref(payloads[1]);
+    THANDLE_ASSIGN(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC)(&batcher, NULL);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_031: [ If adding payload to the pending payloads would go over max_payload_count payloads or over max_batch_size bytes then constbuffer_array_batcher_nv_async_submit shall first take all the pending payloads to be sent as one batch. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_033: [ If the number of pending payloads reached the number of payloads that triggers a batch or the pending payloads reached max_batch_size bytes then constbuffer_array_batcher_nv_async_submit shall take all the pending payloads to be sent as one batch. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_039: [ constbuffer_array_batcher_nv_async_submit shall send the payloads it took (if any) by calling constbuffer_array_batcher_nv_batch and send_batch outside of the lock, in the order they were taken. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_async_submit_sends_a_payload_bigger_than_max_batch_size_alone)
+{
+    // arrange
+    THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) batcher = test_create_and_open(TEST_MAX_PAYLOAD_COUNT, 20);
+    CONSTBUFFER_ARRAY_HANDLE small_payload = create_test_payload(1);
+    CONSTBUFFER_ARRAY_HANDLE big_payload = create_test_payload(100);
+    THANDLE(ASYNC_OP) op_1 = NULL;
+    THANDLE(ASYNC_OP) op_2 = NULL;
+    g.average_interval_us = 1;
+    do_submit(batcher, small_payload, test_payload_context_1, &op_1);
+    g.now_ms += 0.001;
+    umock_c_reset_all_calls();
+
+    expect_submit(big_payload, TIMER_ALREADY_RUNNING, false, 1, 1);
+
+    // act
+    CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT result = constbuffer_array_batcher_nv_async_submit(batcher, big_payload, test_on_payload_complete, test_payload_context_2, &op_2);
+
+    // assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT, CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 2, g.sent_batch_count);
+    assert_batch_contains(g.sent_batches[0].batch, &small_payload, 1);
+    assert_batch_contains(g.sent_batches[1].batch, &big_payload, 1);
+
+    // cleanup
+    g.sent_batches[0].on_batch_sent(g.sent_batches[0].on_batch_sent_context, true);
+    g.sent_batches[1].on_batch_sent(g.sent_batches[1].on_batch_sent_context, true);
+    constbuffer_array_batcher_nv_async_close(batcher);
+    THANDLE_ASSIGN(ASYNC_OP)(&op_1, NULL);
+    THANDLE_ASSIGN(ASYNC_OP)(&op_2, NULL);
+    real_constbuffer_array_dec_ref(small_payload);
+    real_constbuffer_array_dec_ref(big_payload);
+    THANDLE_ASSIGN(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC)(&batcher, NULL);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_030: [ If there are no pending payloads and the timer has been started then constbuffer_array_batcher_nv_async_submit shall call threadpool_timer_restart with max_delay_ms. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_async_submit_after_a_flush_restarts_the_timer)
+{
+    // arrange
+    THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) batcher = test_create_and_open(TEST_MAX_PAYLOAD_COUNT, TEST_MAX_BATCH_SIZE);
+    CONSTBUFFER_ARRAY_HANDLE payload = create_test_payload(0);
+    THANDLE(ASYNC_OP) op_1 = NULL;
+    THANDLE(ASYNC_OP) op_2 = NULL;
+    do_submit(batcher, payload, test_payload_context_1, &op_1);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_batcher_nv_async_flush(batcher));
+    g.now_ms += 1;
+    g.average_interval_us = 1000;
+    umock_c_reset_all_calls();
+
+    expect_submit(payload, TIMER_RESTARTED, false, 0, 0);
+
+    // act
+    CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT result = constbuffer_array_batcher_nv_async_submit(batcher, payload, test_on_payload_complete, test_payload_context_2, &op_2);
+
+    // assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT, CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 1, g.sent_batch_count);
+
+    // cleanup
+    g.sent_batches[0].on_batch_sent(g.sent_batches[0].on_batch_sent_context, true);
+    constbuffer_array_batcher_nv_async_close(batcher);
+    THANDLE_ASSIGN(ASYNC_OP)(&op_1, NULL);
+    THANDLE_ASSIGN(ASYNC_OP)(&op_2, NULL);
+    real_constbuffer_array_dec_ref(payload);
+    THANDLE_ASSIGN(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC)(&batcher, NULL);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_042: [ If there are any failures then constbuffer_array_batcher_nv_async_submit shall fail and return CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT_ERROR. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_async_submit_fails_when_threadpool_timer_restart_fails)
+{
+    // arrange
+    THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) batcher = test_create_and_open(TEST_MAX_PAYLOAD_COUNT, TEST_MAX_BATCH_SIZE);
+    CONSTBUFFER_ARRAY_HANDLE payload = create_test_payload(0);
+    THANDLE(ASYNC_OP) op_1 = NULL;
+    THANDLE(ASYNC_OP) op_2 = NULL;
+    do_submit(batcher, payload, test_payload_context_1, &op_1);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_batcher_nv_async_flush(batcher));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(sm_exec_begin(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size_64(payload, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(async_op_create(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(DList_InitializeListHead(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(DList_InitializeListHead(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_inc_ref(payload));
+    STRICT_EXPECTED_CALL(THANDLE_INITIALIZE(ASYNC_OP)(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_ms());
+    STRICT_EXPECTED_CALL(srw_lock_acquire_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(threadpool_timer_restart(test_timer, TEST_MAX_DELAY_MS, 0))
+        .SetReturn(MU_FAILURE);
+    STRICT_EXPECTED_CALL(srw_lock_release_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_dec_ref(payload));
+    STRICT_EXPECTED_CALL(THANDLE_ASSIGN(ASYNC_OP)(IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(THANDLE_ASSIGN(ASYNC_OP)(IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(sm_exec_end(IGNORED_ARG));
+
+    // act
+    CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT result = constbuffer_array_batcher_nv_async_submit(batcher, payload, test_on_payload_complete, test_payload_context_2, &op_2);
+
+    // assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT, CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(op_2);
+
+    // cleanup
+    g.sent_batches[0].on_batch_sent(g.sent_batches[0].on_batch_sent_context, true);
+    constbuffer_array_batcher_nv_async_close(batcher);
+    THANDLE_ASSIGN(ASYNC_OP)(&op_1, NULL);
+    real_constbuffer_array_dec_ref(payload);
+    THANDLE_ASSIGN(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC)(&batcher, NULL);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_077: [ abandon_pending_ops shall set is_closing to true under the lock. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_078: [ If is_closing is true then constbuffer_array_batcher_nv_async_submit shall fail and return CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT_ERROR. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_async_submit_racing_close_fails_after_the_pending_payloads_are_abandoned)
+{
+    // arrange
+    THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) batcher = test_create_and_open(TEST_MAX_PAYLOAD_COUNT, TEST_MAX_BATCH_SIZE);
+    CONSTBUFFER_ARRAY_HANDLE payload = create_test_payload(0);
+    THANDLE(ASYNC_OP) op_1 = NULL;
+    THANDLE(ASYNC_OP) op_2 = NULL;
+    do_submit(batcher, payload, test_payload_context_1, &op_1);
+    void* contexts[1] = { test_payload_context_1 };
+    THANDLE_INITIALIZE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC)(&g.batcher_to_close_during_submit, batcher);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(sm_exec_begin(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size_64(payload, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(async_op_create(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(DList_InitializeListHead(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(DList_InitializeListHead(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_inc_ref(payload));
+    STRICT_EXPECTED_CALL(THANDLE_INITIALIZE(ASYNC_OP)(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_ms());
+    // close
+    STRICT_EXPECTED_CALL(sm_close_begin_with_cb(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, NULL, NULL));
+    STRICT_EXPECTED_CALL(DList_InitializeListHead(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_acquire_exclusive(IGNORED_ARG));
+    expect_take_pending_ops(1);
+    STRICT_EXPECTED_CALL(srw_lock_release_exclusive(IGNORED_ARG));
+    expect_complete_ops(contexts, 1, CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_CALLBACK_RESULT_ABANDONED);
+    STRICT_EXPECTED_CALL(THANDLE_ASSIGN(THREADPOOL_TIMER)(IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(sm_close_end(IGNORED_ARG));
+    // the submit takes the lock after the pending payloads were abandoned
+    STRICT_EXPECTED_CALL(srw_lock_acquire_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_release_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_dec_ref(payload));
+    STRICT_EXPECTED_CALL(THANDLE_ASSIGN(ASYNC_OP)(IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(THANDLE_ASSIGN(ASYNC_OP)(IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(sm_exec_end(IGNORED_ARG));
+
+    // act
+    CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT result = constbuffer_array_batcher_nv_async_submit(batcher, payload, test_on_payload_complete, test_payload_context_2, &op_2);
+
+    // assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT, CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(op_2);
+    ASSERT_ARE_EQUAL(uint32_t, 0, g.sent_batch_count);
+
+    // cleanup
+    constbuffer_array_batcher_nv_async_close(batcher);
+    THANDLE_ASSIGN(ASYNC_OP)(&op_1, NULL);
+    real_constbuffer_array_dec_ref(payload);
+    THANDLE_ASSIGN(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC)(&batcher, NULL);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_076: [ constbuffer_array_batcher_nv_async_open shall set is_closing to false. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_async_submit_after_close_and_open_succeeds)
+{
+    // arrange
+    THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) batcher = test_create_and_open(TEST_MAX_PAYLOAD_COUNT, TEST_MAX_BATCH_SIZE);
+    CONSTBUFFER_ARRAY_HANDLE payload = create_test_payload(0);
+    THANDLE(ASYNC_OP) op = NULL;
+    constbuffer_array_batcher_nv_async_close(batcher);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_batcher_nv_async_open(batcher));
+    umock_c_reset_all_calls();
+
+    expect_submit(payload, TIMER_STARTED, true, 0, 0);
+
+    // act
+    CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT result = constbuffer_array_batcher_nv_async_submit(batcher, payload, test_on_payload_complete, test_payload_context_1, &op);
+
+    // assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT, CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_RESULT_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(op);
+
+    // cleanup
+    constbuffer_array_batcher_nv_async_close(batcher);
+    THANDLE_ASSIGN(ASYNC_OP)(&op, NULL);
+    real_constbuffer_array_dec_ref(payload);
+    THANDLE_ASSIGN(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC)(&batcher, NULL);
+}
+
+/* constbuffer_array_batcher_nv_async_flush */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_070: [ If batcher is NULL then constbuffer_array_batcher_nv_async_flush shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_async_flush_with_NULL_batcher_fails)
+{
+    // arrange
+
+    // act
+    int result = constbuffer_array_batcher_nv_async_flush(NULL);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_075: [ If there are any failures then constbuffer_array_batcher_nv_async_flush shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_async_flush_when_not_open_fails)
+{
+    // arrange
+    THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) batcher = constbuffer_array_batcher_nv_async_create(g.test_threadpool, TEST_MAX_PAYLOAD_COUNT, TEST_MAX_BATCH_SIZE, TEST_MAX_DELAY_MS, test_send_batch, test_send_batch_context);
+    ASSERT_IS_NOT_NULL(batcher);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(sm_exec_begin(IGNORED_ARG));
+
+    // act
+    int result = constbuffer_array_batcher_nv_async_flush(batcher);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    THANDLE_ASSIGN(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC)(&batcher, NULL);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_071: [ constbuffer_array_batcher_nv_async_flush shall call sm_exec_begin. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_072: [ constbuffer_array_batcher_nv_async_flush shall take all the pending payloads under the lock. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_074: [ constbuffer_array_batcher_nv_async_flush shall call sm_exec_end, succeed and return 0. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_async_flush_with_no_pending_payloads_sends_nothing)
+{
+    // arrange
+    THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) batcher = test_create_and_open(TEST_MAX_PAYLOAD_COUNT, TEST_MAX_BATCH_SIZE);
+
+    STRICT_EXPECTED_CALL(sm_exec_begin(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(DList_InitializeListHead(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_acquire_exclusive(IGNORED_ARG));
+    expect_take_pending_ops(0);
+    STRICT_EXPECTED_CALL(srw_lock_release_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(sm_exec_end(IGNORED_ARG));
+
+    // act
+    int result = constbuffer_array_batcher_nv_async_flush(batcher);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 0, g.sent_batch_count);
+
+    // cleanup
+    constbuffer_array_batcher_nv_async_close(batcher);
+    THANDLE_ASSIGN(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC)(&batcher, NULL);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_073: [ constbuffer_array_batcher_nv_async_flush shall send the payloads it took (if any) as one batch. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_043: [ send_ops shall allocate memory to track the operations of the batch. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_044: [ send_ops shall allocate an array for the payloads of the batch. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_045: [ send_ops shall create the batch by calling constbuffer_array_batcher_nv_batch with the payloads in the order in which they were submitted. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_046: [ send_ops shall call send_batch with send_batch_context, the batch, on_batch_sent and the tracking memory as context. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_047: [ send_ops shall decrement the reference count of the batch. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_async_flush_sends_the_pending_payloads_in_order)
+{
+    // arrange
+    THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) batcher = test_create_and_open(TEST_MAX_PAYLOAD_COUNT, TEST_MAX_BATCH_SIZE);
+    CONSTBUFFER_ARRAY_HANDLE payloads[3];
+    THANDLE(ASYNC_OP) ops[3] = { NULL, NULL, NULL };
+    void* contexts[3] = { test_payload_context_1, test_payload_context_2, test_payload_context_3 };
+    g.average_interval_us = 1;
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        payloads[i] = create_test_payload(i);
+        do_submit(batcher, payloads[i], contexts[i], &ops[i]);
+        g.now_ms += 0.001;
+    }
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(sm_exec_begin(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(DList_InitializeListHead(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_acquire_exclusive(IGNORED_ARG));
+    expect_take_pending_ops(3);
+    STRICT_EXPECTED_CALL(srw_lock_release_exclusive(IGNORED_ARG));
+    expect_send(3);
+    STRICT_EXPECTED_CALL(sm_exec_end(IGNORED_ARG));
+
+    // act
+    int result = constbuffer_array_batcher_nv_async_flush(batcher);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 1, g.sent_batch_count);
+    assert_batch_contains(g.sent_batches[0].batch, payloads, 3);
+
+    // cleanup
+    g.sent_batches[0].on_batch_sent(g.sent_batches[0].on_batch_sent_context, true);
+    constbuffer_array_batcher_nv_async_close(batcher);
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        THANDLE_ASSIGN(ASYNC_OP)(&ops[i], NULL);
+        real_constbuffer_array_dec_ref(payloads[i]);
+    }
+    THANDLE_ASSIGN(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC)(&batcher, NULL);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_048: [ If there are any failures then send_ops shall complete all the payloads with CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_CALLBACK_RESULT_ERROR. ]*/
+TEST_FUNCTION(when_send_batch_fails_the_payloads_complete_with_ERROR)
+{
+    // arrange
+    THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) batcher = test_create_and_open(TEST_MAX_PAYLOAD_COUNT, TEST_MAX_BATCH_SIZE);
+    CONSTBUFFER_ARRAY_HANDLE payload = create_test_payload(0);
+    THANDLE(ASYNC_OP) op_1 = NULL;
+    THANDLE(ASYNC_OP) op_2 = NULL;
+    g.average_interval_us = 1;
+    do_submit(batcher, payload, test_payload_context_1, &op_1);
+    g.now_ms += 0.001;
+    do_submit(batcher, payload, test_payload_context_2, &op_2);
+    void* contexts[2] = { test_payload_context_1, test_payload_context_2 };
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(sm_exec_begin(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(DList_InitializeListHead(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_acquire_exclusive(IGNORED_ARG));
+    expect_take_pending_ops(2);
+    STRICT_EXPECTED_CALL(srw_lock_release_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 2, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(malloc_2(2, sizeof(CONSTBUFFER_ARRAY_HANDLE)));
+    STRICT_EXPECTED_CALL(constbuffer_array_batcher_nv_batch(IGNORED_ARG, 2));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(test_send_batch(test_send_batch_context, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .SetReturn(MU_FAILURE);
+    STRICT_EXPECTED_CALL(constbuffer_array_dec_ref(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    expect_complete_ops(contexts, 2, CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_CALLBACK_RESULT_ERROR);
+    STRICT_EXPECTED_CALL(sm_exec_end(IGNORED_ARG));
+
+    // act
+    int result = constbuffer_array_batcher_nv_async_flush(batcher);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    constbuffer_array_batcher_nv_async_close(batcher);
+    THANDLE_ASSIGN(ASYNC_OP)(&op_1, NULL);
+    THANDLE_ASSIGN(ASYNC_OP)(&op_2, NULL);
+    real_constbuffer_array_dec_ref(payload);
+    THANDLE_ASSIGN(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC)(&batcher, NULL);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_048: [ If there are any failures then send_ops shall complete all the payloads with CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_CALLBACK_RESULT_ERROR. ]*/
+TEST_FUNCTION(when_underlying_calls_fail_send_ops_completes_the_payloads_with_ERROR)
+{
+    // arrange
+    THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) batcher = test_create_and_open(TEST_MAX_PAYLOAD_COUNT, TEST_MAX_BATCH_SIZE);
+    CONSTBUFFER_ARRAY_HANDLE payload = create_test_payload(0);
+    THANDLE(ASYNC_OP) op = NULL;
+
+    expect_send(1);
+
+    umock_c_negative_tests_snapshot();
+
+    for (size_t i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
+        if (umock_c_negative_tests_can_call_fail(i))
+        {
+            do_submit(batcher, payload, test_payload_context_1, &op);
+
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(i);
+
+            // act
+            int result = constbuffer_array_batcher_nv_async_flush(batcher);
+
+            // assert
+            ASSERT_ARE_EQUAL(int, 0, result, "On failed call %zu", i);
+            ASSERT_ARE_EQUAL(uint32_t, 0, g.sent_batch_count, "On failed call %zu", i);
+
+            THANDLE_ASSIGN(ASYNC_OP)(&op, NULL);
+        }
+    }
+
+    // cleanup
+    constbuffer_array_batcher_nv_async_close(batcher);
+    real_constbuffer_array_dec_ref(payload);
+    THANDLE_ASSIGN(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC)(&batcher, NULL);
+}
+
+/* on_batch_sent */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_049: [ If context is NULL then on_batch_sent shall return. ]*/
+TEST_FUNCTION(on_batch_sent_with_NULL_context_returns)
+{
+    // arrange
+    THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) batcher = test_create_and_open(TEST_MAX_PAYLOAD_COUNT, TEST_MAX_BATCH_SIZE);
+    CONSTBUFFER_ARRAY_HANDLE payload = create_test_payload(0);
+    THANDLE(ASYNC_OP) op = NULL;
+    do_submit(batcher, payload, test_payload_context_1, &op);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_batcher_nv_async_flush(batcher));
+    umock_c_reset_all_calls();
+
+    // act
+    g.sent_batches[0].on_batch_sent(NULL, true);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    g.sent_batches[0].on_batch_sent(g.sent_batches[0].on_batch_sent_context, true);
+    constbuffer_array_batcher_nv_async_close(batcher);
+    THANDLE_ASSIGN(ASYNC_OP)(&op, NULL);
+    real_constbuffer_array_dec_ref(payload);
+    THANDLE_ASSIGN(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC)(&batcher, NULL);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_050: [ on_batch_sent shall complete every payload of the batch with CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_CALLBACK_RESULT_OK if succeeded is true and with CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_CALLBACK_RESULT_ERROR otherwise. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_051: [ on_batch_sent shall free the memory used to track the batch. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_053: [ complete_op shall decrement the reference count of the payload, call on_payload_complete with the result of the operation and release the reference the operation holds on itself. ]*/
+TEST_FUNCTION(on_batch_sent_with_true_completes_the_payloads_with_OK)
+{
+    // arrange
+    THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) batcher = test_create_and_open(TEST_MAX_PAYLOAD_COUNT, TEST_MAX_BATCH_SIZE);
+    CONSTBUFFER_ARRAY_HANDLE payload = create_test_payload(0);
+    THANDLE(ASYNC_OP) op_1 = NULL;
+    THANDLE(ASYNC_OP) op_2 = NULL;
+    g.average_interval_us = 1;
+    do_submit(batcher, payload, test_payload_context_1, &op_1);
+    g.now_ms += 0.001;
+    do_submit(batcher, payload, test_payload_context_2, &op_2);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_batcher_nv_async_flush(batcher));
+    umock_c_reset_all_calls();
+
+    expect_complete(test_payload_context_1, CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_CALLBACK_RESULT_OK);
+    expect_complete(test_payload_context_2, CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_CALLBACK_RESULT_OK);
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    // act
+    g.sent_batches[0].on_batch_sent(g.sent_batches[0].on_batch_sent_context, true);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    constbuffer_array_batcher_nv_async_close(batcher);
+    THANDLE_ASSIGN(ASYNC_OP)(&op_1, NULL);
+    THANDLE_ASSIGN(ASYNC_OP)(&op_2, NULL);
+    real_constbuffer_array_dec_ref(payload);
+    THANDLE_ASSIGN(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC)(&batcher, NULL);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_050: [ on_batch_sent shall complete every payload of the batch with CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_CALLBACK_RESULT_OK if succeeded is true and with CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_CALLBACK_RESULT_ERROR otherwise. ]*/
+TEST_FUNCTION(on_batch_sent_with_false_completes_the_payloads_with_ERROR)
+{
+    // arrange
+    THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) batcher = test_create_and_open(TEST_MAX_PAYLOAD_COUNT, TEST_MAX_BATCH_SIZE);
+    CONSTBUFFER_ARRAY_HANDLE payload = create_test_payload(0);
+    THANDLE(ASYNC_OP) op = NULL;
+    do_submit(batcher, payload, test_payload_context_1, &op);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_batcher_nv_async_flush(batcher));
+    umock_c_reset_all_calls();
+
+    expect_complete(test_payload_context_1, CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_CALLBACK_RESULT_ERROR);
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    // act
+    g.sent_batches[0].on_batch_sent(g.sent_batches[0].on_batch_sent_context, false);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    constbuffer_array_batcher_nv_async_close(batcher);
+    THANDLE_ASSIGN(ASYNC_OP)(&op, NULL);
+    real_constbuffer_array_dec_ref(payload);
+    THANDLE_ASSIGN(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC)(&batcher, NULL);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_052: [ dispose_op shall release the reference the operation holds on the batcher. ]*/
+TEST_FUNCTION(the_batcher_is_disposed_after_the_last_operation_is_released)
+{
+    // arrange
+    THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) batcher = test_create_and_open(TEST_MAX_PAYLOAD_COUNT, TEST_MAX_BATCH_SIZE);
+    CONSTBUFFER_ARRAY_HANDLE payload = create_test_payload(0);
+    THANDLE(ASYNC_OP) op = NULL;
+    do_submit(batcher, payload, test_payload_context_1, &op);
+    constbuffer_array_batcher_nv_async_close(batcher);
+    THANDLE_ASSIGN(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC)(&batcher, NULL);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(THANDLE_ASSIGN(ASYNC_OP)(IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(THANDLE_ASSIGN(THREADPOOL_TIMER)(IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(THANDLE_ASSIGN(SLIDING_WINDOW_AVERAGE)(IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(THANDLE_ASSIGN(THREADPOOL)(IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(srw_lock_destroy(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(sm_destroy(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    // act
+    THANDLE_ASSIGN(ASYNC_OP)(&op, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    real_constbuffer_array_dec_ref(payload);
+}
+
+/* on_timer */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_054: [ If context is NULL then on_timer shall return. ]*/
+TEST_FUNCTION(on_timer_with_NULL_context_returns)
+{
+    // arrange
+    THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) batcher = test_create_and_open(TEST_MAX_PAYLOAD_COUNT, TEST_MAX_BATCH_SIZE);
+    CONSTBUFFER_ARRAY_HANDLE payload = create_test_payload(0);
+    THANDLE(ASYNC_OP) op = NULL;
+    do_submit(batcher, payload, test_payload_context_1, &op);
+    umock_c_reset_all_calls();
+
+    // act
+    g.timer_callback(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    constbuffer_array_batcher_nv_async_close(batcher);
+    THANDLE_ASSIGN(ASYNC_OP)(&op, NULL);
+    real_constbuffer_array_dec_ref(payload);
+    THANDLE_ASSIGN(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC)(&batcher, NULL);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_055: [ on_timer shall call sm_exec_begin and return if it does not succeed. ]*/
+TEST_FUNCTION(on_timer_after_close_does_nothing)
+{
+    // arrange
+    THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) batcher = test_create_and_open(TEST_MAX_PAYLOAD_COUNT, TEST_MAX_BATCH_SIZE);
+    CONSTBUFFER_ARRAY_HANDLE payload = create_test_payload(0);
+    THANDLE(ASYNC_OP) op = NULL;
+    do_submit(batcher, payload, test_payload_context_1, &op);
+    constbuffer_array_batcher_nv_async_close(batcher);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(sm_exec_begin(IGNORED_ARG));
+
+    // act
+    g.timer_callback(g.timer_callback_context);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    THANDLE_ASSIGN(ASYNC_OP)(&op, NULL);
+    real_constbuffer_array_dec_ref(payload);
+    THANDLE_ASSIGN(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC)(&batcher, NULL);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_057: [ If there are no pending payloads then on_timer shall not send anything. ]*/
+TEST_FUNCTION(on_timer_with_no_pending_payloads_does_not_send)
+{
+    // arrange
+    THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) batcher = test_create_and_open(TEST_MAX_PAYLOAD_COUNT, TEST_MAX_BATCH_SIZE);
+    CONSTBUFFER_ARRAY_HANDLE payload = create_test_payload(0);
+    THANDLE(ASYNC_OP) op = NULL;
+    do_submit(batcher, payload, test_payload_context_1, &op);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_batcher_nv_async_flush(batcher));
+    g.now_ms += TEST_MAX_DELAY_MS;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(sm_exec_begin(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(DList_InitializeListHead(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_acquire_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_release_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(sm_exec_end(IGNORED_ARG));
+
+    // act
+    g.timer_callback(g.timer_callback_context);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 1, g.sent_batch_count);
+
+    // cleanup
+    g.sent_batches[0].on_batch_sent(g.sent_batches[0].on_batch_sent_context, true);
+    constbuffer_array_batcher_nv_async_close(batcher);
+    THANDLE_ASSIGN(ASYNC_OP)(&op, NULL);
+    real_constbuffer_array_dec_ref(payload);
+    THANDLE_ASSIGN(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC)(&batcher, NULL);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_056: [ on_timer shall call srw_lock_acquire_exclusive. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_060: [ Otherwise on_timer shall take all the pending payloads. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_061: [ on_timer shall call srw_lock_release_exclusive. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_062: [ on_timer shall send the payloads it took as one batch. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_063: [ on_timer shall call sm_exec_end. ]*/
+TEST_FUNCTION(on_timer_sends_the_payloads_that_waited_max_delay_ms)
+{
+    // arrange
+    THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) batcher = test_create_and_open(TEST_MAX_PAYLOAD_COUNT, TEST_MAX_BATCH_SIZE);
+    CONSTBUFFER_ARRAY_HANDLE payloads[2];
+    payloads[0] = create_test_payload(1);
+    payloads[1] = create_test_payload(2);
+    THANDLE(ASYNC_OP) op_1 = NULL;
+    THANDLE(ASYNC_OP) op_2 = NULL;
+    g.average_interval_us = 1;
+    do_submit(batcher, payloads[0], test_payload_context_1, &op_1);
+    g.now_ms += 0.001;
+    do_submit(batcher, payloads[1], test_payload_context_2, &op_2);
+    g.now_ms += TEST_MAX_DELAY_MS;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(sm_exec_begin(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(DList_InitializeListHead(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_acquire_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_ms());
+    expect_take_pending_ops(2);
+    STRICT_EXPECTED_CALL(srw_lock_release_exclusive(IGNORED_ARG));
+    expect_send(2);
+    STRICT_EXPECTED_CALL(sm_exec_end(IGNORED_ARG));
+
+    // act
+    g.timer_callback(g.timer_callback_context);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 1, g.sent_batch_count);
+    assert_batch_contains(g.sent_batches[0].batch, payloads, 2);
+
+    // cleanup
+    g.sent_batches[0].on_batch_sent(g.sent_batches[0].on_batch_sent_context, true);
+    constbuffer_array_batcher_nv_async_close(batcher);
+    THANDLE_ASSIGN(ASYNC_OP)(&op_1, NULL);
+    THANDLE_ASSIGN(ASYNC_OP)(&op_2, NULL);
+    real_constbuffer_array_dec_ref(payloads[0]);
+    real_constbuffer_array_dec_ref(payloads[1]);
+    THANDLE_ASSIGN(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC)(&batcher, NULL);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_058: [ If the oldest pending payload has waited less than max_delay_ms then on_timer shall call threadpool_timer_restart with the time the oldest payload has left to wait. ]*/
+TEST_FUNCTION(on_timer_restarts_the_timer_when_the_oldest_payload_has_not_waited_max_delay_ms)
+{
+    // arrange
+    THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) batcher = test_create_and_open(TEST_MAX_PAYLOAD_COUNT, TEST_MAX_BATCH_SIZE);
+    CONSTBUFFER_ARRAY_HANDLE payload = create_test_payload(0);
+    THANDLE(ASYNC_OP) op_1 = NULL;
+    THANDLE(ASYNC_OP) op_2 = NULL;
+    g.average_interval_us = 1;
+    do_submit(batcher, payload, test_payload_context_1, &op_1);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_batcher_nv_async_flush(batcher));
+    /*the timer was started for the first payload, the second one arrives 6ms later*/
+    g.now_ms += 6;
+    do_submit(batcher, payload, test_payload_context_2, &op_2);
+    g.now_ms += 4;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(sm_exec_begin(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(DList_InitializeListHead(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_acquire_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_ms());
+    STRICT_EXPECTED_CALL(threadpool_timer_restart(test_timer, 6, 0));
+    STRICT_EXPECTED_CALL(srw_lock_release_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(sm_exec_end(IGNORED_ARG));
+
+    // act
+    g.timer_callback(g.timer_callback_context);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 1, g.sent_batch_count);
+
+    // cleanup
+    g.sent_batches[0].on_batch_sent(g.sent_batches[0].on_batch_sent_context, true);
+    constbuffer_array_batcher_nv_async_close(batcher);
+    THANDLE_ASSIGN(ASYNC_OP)(&op_1, NULL);
+    THANDLE_ASSIGN(ASYNC_OP)(&op_2, NULL);
+    real_constbuffer_array_dec_ref(payload);
+    THANDLE_ASSIGN(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC)(&batcher, NULL);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_059: [ If threadpool_timer_restart fails then on_timer shall send all the pending payloads. ]*/
+TEST_FUNCTION(on_timer_sends_the_pending_payloads_when_threadpool_timer_restart_fails)
+{
+    // arrange
+    THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) batcher = test_create_and_open(TEST_MAX_PAYLOAD_COUNT, TEST_MAX_BATCH_SIZE);
+    CONSTBUFFER_ARRAY_HANDLE payload = create_test_payload(0);
+    THANDLE(ASYNC_OP) op_1 = NULL;
+    THANDLE(ASYNC_OP) op_2 = NULL;
+    g.average_interval_us = 1;
+    do_submit(batcher, payload, test_payload_context_1, &op_1);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_batcher_nv_async_flush(batcher));
+    g.now_ms += 6;
+    do_submit(batcher, payload, test_payload_context_2, &op_2);
+    g.now_ms += 4;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(sm_exec_begin(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(DList_InitializeListHead(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_acquire_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_ms());
+    STRICT_EXPECTED_CALL(threadpool_timer_restart(test_timer, 6, 0))
+        .SetReturn(MU_FAILURE);
+    expect_take_pending_ops(1);
+    STRICT_EXPECTED_CALL(srw_lock_release_exclusive(IGNORED_ARG));
+    expect_send(1);
+    STRICT_EXPECTED_CALL(sm_exec_end(IGNORED_ARG));
+
+    // act
+    g.timer_callback(g.timer_callback_context);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 2, g.sent_batch_count);
+
+    // cleanup
+    g.sent_batches[0].on_batch_sent(g.sent_batches[0].on_batch_sent_context, true);
+    g.sent_batches[1].on_batch_sent(g.sent_batches[1].on_batch_sent_context, true);
+    constbuffer_array_batcher_nv_async_close(batcher);
+    THANDLE_ASSIGN(ASYNC_OP)(&op_1, NULL);
+    THANDLE_ASSIGN(ASYNC_OP)(&op_2, NULL);
+    real_constbuffer_array_dec_ref(payload);
+    THANDLE_ASSIGN(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC)(&batcher, NULL);
+}
+
+/* cancel_op */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_064: [ cancel_op shall call srw_lock_acquire_exclusive. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_065: [ If the payload is still pending then cancel_op shall remove it from the pending payloads. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_066: [ cancel_op shall call srw_lock_release_exclusive. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_068: [ cancel_op shall complete the payload with CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_CALLBACK_RESULT_CANCELLED by calling threadpool_schedule_work with complete_op_from_threadpool. ]*/
+TEST_FUNCTION(cancelling_a_pending_payload_completes_it_with_CANCELLED)
+{
+    // arrange
+    THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) batcher = test_create_and_open(TEST_MAX_PAYLOAD_COUNT, TEST_MAX_BATCH_SIZE);
+    CONSTBUFFER_ARRAY_HANDLE payloads[2];
+    payloads[0] = create_test_payload(1);
+    payloads[1] = create_test_payload(2);
+    THANDLE(ASYNC_OP) op_1 = NULL;
+    THANDLE(ASYNC_OP) op_2 = NULL;
+    g.average_interval_us = 1;
+    do_submit(batcher, payloads[0], test_payload_context_1, &op_1);
+    g.now_ms += 0.001;
+    do_submit(batcher, payloads[1], test_payload_context_2, &op_2);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(srw_lock_acquire_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(DList_RemoveEntryList(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_release_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(threadpool_schedule_work(g.test_threadpool, IGNORED_ARG, IGNORED_ARG));
+
+    // act
+    (void)real_async_op_cancel(op_1);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(g.work_function);
+
+    /*the cancelled payload completes on the threadpool*/
+    umock_c_reset_all_calls();
+    expect_complete(test_payload_context_1, CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_CALLBACK_RESULT_CANCELLED);
+    g.work_function(g.work_function_context);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    /*and is not part of the next batch*/
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_batcher_nv_async_flush(batcher));
+    ASSERT_ARE_EQUAL(uint32_t, 1, g.sent_batch_count);
+    assert_batch_contains(g.sent_batches[0].batch, &payloads[1], 1);
+
+    // cleanup
+    g.sent_batches[0].on_batch_sent(g.sent_batches[0].on_batch_sent_context, true);
+    constbuffer_array_batcher_nv_async_close(batcher);
+    THANDLE_ASSIGN(ASYNC_OP)(&op_1, NULL);
+    THANDLE_ASSIGN(ASYNC_OP)(&op_2, NULL);
+    real_constbuffer_array_dec_ref(payloads[0]);
+    real_constbuffer_array_dec_ref(payloads[1]);
+    THANDLE_ASSIGN(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC)(&batcher, NULL);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_069: [ If threadpool_schedule_work fails then cancel_op shall complete the payload on the calling thread. ]*/
+TEST_FUNCTION(cancelling_a_pending_payload_completes_it_inline_when_threadpool_schedule_work_fails)
+{
+    // arrange
+    THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) batcher = test_create_and_open(TEST_MAX_PAYLOAD_COUNT, TEST_MAX_BATCH_SIZE);
+    CONSTBUFFER_ARRAY_HANDLE payload = create_test_payload(0);
+    THANDLE(ASYNC_OP) op = NULL;
+    do_submit(batcher, payload, test_payload_context_1, &op);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(srw_lock_acquire_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(DList_RemoveEntryList(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_release_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(threadpool_schedule_work(g.test_threadpool, IGNORED_ARG, IGNORED_ARG))
+        .SetReturn(MU_FAILURE);
+    expect_complete(test_payload_context_1, CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_CALLBACK_RESULT_CANCELLED);
+
+    // act
+    (void)real_async_op_cancel(op);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    constbuffer_array_batcher_nv_async_close(batcher);
+    THANDLE_ASSIGN(ASYNC_OP)(&op, NULL);
+    real_constbuffer_array_dec_ref(payload);
+    THANDLE_ASSIGN(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC)(&batcher, NULL);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_12_067: [ If the payload is not pending anymore (it is part of a batch or it has completed) then cancel_op shall do nothing. ]*/
+TEST_FUNCTION(cancelling_a_payload_that_is_part_of_a_batch_does_nothing)
+{
+    // arrange
+    THANDLE(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC) batcher = test_create_and_open(TEST_MAX_PAYLOAD_COUNT, TEST_MAX_BATCH_SIZE);
+    CONSTBUFFER_ARRAY_HANDLE payload = create_test_payload(0);
+    THANDLE(ASYNC_OP) op = NULL;
+    do_submit(batcher, payload, test_payload_context_1, &op);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_batcher_nv_async_flush(batcher));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(srw_lock_acquire_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_release_exclusive(IGNORED_ARG));
+
+    // act
+    (void)real_async_op_cancel(op);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    /*the payload still completes with the outcome of its batch*/
+    umock_c_reset_all_calls();
+    expect_complete(test_payload_context_1, CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_CALLBACK_RESULT_OK);
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    g.sent_batches[0].on_batch_sent(g.sent_batches[0].on_batch_sent_context, true);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    constbuffer_array_batcher_nv_async_close(batcher);
+    THANDLE_ASSIGN(ASYNC_OP)(&op, NULL);
+    real_constbuffer_array_dec_ref(payload);
+    THANDLE_ASSIGN(CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC)(&batcher, NULL);
+}
+
+END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
@@ -0,0 +1,58 @@
+// Copyright (c) Microsoft. All rights reserved.
+
+// Precompiled header for constbuffer_array_batcher_nv_async_ut
+
+#ifndef CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_UT_PCH_H
+#define CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_UT_PCH_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <inttypes.h>
+
+#include "macro_utils/macro_utils.h"
+
+#include "testrunnerswitcher.h"
+
+#include "umock_c/umock_c.h"
+#include "umock_c/umocktypes_bool.h"
+#include "umock_c/umocktypes_stdint.h"
+#include "umock_c/umock_c_negative_tests.h"
+
+#include "c_pal/interlocked.h"
+
+#include "umock_c/umock_c_ENABLE_MOCKS.h" // ============================== ENABLE_MOCKS
+#include "c_pal/gballoc_hl.h"
+#include "c_pal/gballoc_hl_redirect.h"
+#include "c_pal/srw_lock.h"
+#include "c_pal/threadpool.h"
+#include "c_pal/timer.h"
+#include "c_pal/sm.h"
+
+#include "c_util/doublylinkedlist.h"
+#include "c_util/async_op.h"
+#include "c_util/constbuffer_array.h"
+#include "c_util/constbuffer_array_batcher_nv.h"
+#include "c_util/sliding_window_average_by_count.h"
+#include "umock_c/umock_c_DISABLE_MOCKS.h" // ============================== DISABLE_MOCKS
+
+// Must include umock_c_prod so mocks are not expanded in the reals
+#include "umock_c/umock_c_prod.h"
+
+#include "real_gballoc_hl.h"
+#include "real_interlocked.h"
+#include "real_srw_lock.h"
+#include "real_thandle_helper.h"
+#include "real_sm.h"
+
+#include "real_doublylinkedlist.h"
+#include "real_async_op.h"
+#include "real_constbuffer.h"
+#include "real_constbuffer_array.h"
+#include "real_constbuffer_array_batcher_nv.h"
+
+#include "c_pal/thandle.h"
+
+#include "c_util/constbuffer_array_batcher_nv_async.h"
+
+#endif // CONSTBUFFER_ARRAY_BATCHER_NV_ASYNC_UT_PCH_H
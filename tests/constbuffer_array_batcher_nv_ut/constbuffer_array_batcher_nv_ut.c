@@ -6,11 +6,89 @@
 
 MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
 
+TEST_DEFINE_ENUM_TYPE(CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_RESULT, CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_RESULT_VALUES)
+
 static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
 {
     ASSERT_FAIL("umock_c reported error :%" PRI_MU_ENUM "", MU_ENUM_VALUE(UMOCK_C_ERROR_CODE, error_code));
 }
 
+/*creates a payload of buffer_count buffers of buffer_size bytes each*/
+static CONSTBUFFER_ARRAY_HANDLE create_test_payload(uint32_t buffer_count, uint32_t buffer_size)
+{
+    CONSTBUFFER_ARRAY_HANDLE result;
+    if (buffer_count == 0)
+    {
+        result = real_constbuffer_array_create_empty();
+    }
+    else
+    {
+        CONSTBUFFER_HANDLE* buffers = real_gballoc_hl_malloc_2(buffer_count, sizeof(CONSTBUFFER_HANDLE));
+        ASSERT_IS_NOT_NULL(buffers);
+        unsigned char* memory = real_gballoc_hl_malloc(buffer_size == 0 ? 1 : buffer_size);
+        ASSERT_IS_NOT_NULL(memory);
+        (void)memset(memory, 0x42, buffer_size);
+        for (uint32_t i = 0; i < buffer_count; i++)
+        {
+            buffers[i] = real_CONSTBUFFER_Create(memory, buffer_size);
+            ASSERT_IS_NOT_NULL(buffers[i]);
+        }
+        real_gballoc_hl_free(memory);
+        result = real_constbuffer_array_create_with_move_buffers(buffers, buffer_count);
+    }
+    ASSERT_IS_NOT_NULL(result);
+    return result;
+}
+
+static CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_HANDLE create_test_builder(uint32_t max_payload_count, uint64_t max_batch_size, CONSTBUFFER_ARRAY_HANDLE* payloads, uint32_t payload_count)
+{
+    CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_HANDLE result = constbuffer_array_batcher_nv_builder_create(max_payload_count, max_batch_size);
+    ASSERT_IS_NOT_NULL(result);
+    for (uint32_t i = 0; i < payload_count; i++)
+    {
+        ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_RESULT, CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_OK, constbuffer_array_batcher_nv_builder_append(result, payloads[i]));
+    }
+    return result;
+}
+
+/*creates the payloads used by the view tests (2 buffers, 0 buffers, 1 buffer) and their batch*/
+static CONSTBUFFER_ARRAY_HANDLE create_test_batch(CONSTBUFFER_ARRAY_HANDLE payloads[3])
+{
+    payloads[0] = create_test_payload(2, 3);
+    payloads[1] = create_test_payload(0, 0);
+    payloads[2] = create_test_payload(1, 7);
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_batcher_nv_batch(payloads, 3);
+    ASSERT_IS_NOT_NULL(result);
+    return result;
+}
+
+static void destroy_test_batch(CONSTBUFFER_ARRAY_HANDLE batch, CONSTBUFFER_ARRAY_HANDLE payloads[3])
+{
+    real_constbuffer_array_dec_ref(batch);
+    real_constbuffer_array_dec_ref(payloads[0]);
+    real_constbuffer_array_dec_ref(payloads[1]);
+    real_constbuffer_array_dec_ref(payloads[2]);
+}
+
+static CONSTBUFFER_ARRAY_BATCHER_NV_VIEW_HANDLE create_test_view(CONSTBUFFER_ARRAY_HANDLE batch)
+{
+    CONSTBUFFER_ARRAY_BATCHER_NV_VIEW_HANDLE result = constbuffer_array_batcher_nv_view_create(batch);
+    ASSERT_IS_NOT_NULL(result);
+    umock_c_reset_all_calls();
+    return result;
+}
+
+/*creates a batch made only of header_size bytes of header*/
+static CONSTBUFFER_ARRAY_HANDLE create_test_batch_from_header(const uint8_t* header, uint32_t header_size)
+{
+    CONSTBUFFER_HANDLE header_buffer = real_CONSTBUFFER_Create(header, header_size);
+    ASSERT_IS_NOT_NULL(header_buffer);
+    CONSTBUFFER_ARRAY_HANDLE result = real_constbuffer_array_create(&header_buffer, 1);
+    ASSERT_IS_NOT_NULL(result);
+    real_CONSTBUFFER_DecRef(header_buffer);
+    return result;
+}
+
 BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
 
 TEST_SUITE_INITIALIZE(suite_init)
@@ -28,10 +106,15 @@ TEST_SUITE_INITIALIZE(suite_init)
     REGISTER_GBALLOC_HL_GLOBAL_MOCK_HOOK();
     REGISTER_GLOBAL_MOCK_FAIL_RETURN(malloc, NULL);
     REGISTER_GLOBAL_MOCK_FAIL_RETURN(malloc_2, NULL);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(malloc_flex, NULL);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(realloc_2, NULL);
 
     REGISTER_GLOBAL_MOCK_FAIL_RETURN(constbuffer_array_create_empty, NULL);
     REGISTER_GLOBAL_MOCK_FAIL_RETURN(constbuffer_array_create, NULL);
     REGISTER_GLOBAL_MOCK_FAIL_RETURN(CONSTBUFFER_CreateWithMoveMemory, NULL);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(constbuffer_array_create_with_move_buffers, NULL);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(constbuffer_array_get_all_buffers_size_64, MU_FAILURE);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(constbuffer_array_create_from_buffer_index_and_count, NULL);
 
     REGISTER_CONSTBUFFER_GLOBAL_MOCK_HOOK();
     REGISTER_CONSTBUFFER_ARRAY_GLOBAL_MOCK_HOOK();
@@ -1365,4 +1448,1585 @@ TEST_FUNCTION(constbuffer_array_batcher_nv_unbatch_with_payload_count_0_fails)
     real_CONSTBUFFER_DecRef(test_buffers[0]);
 }
 
+/* constbuffer_array_batcher_nv_builder_create */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_001: [ If max_payload_count is 0 then constbuffer_array_batcher_nv_builder_create shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_builder_create_with_0_max_payload_count_fails)
+{
+    // act
+    CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_HANDLE result = constbuffer_array_batcher_nv_builder_create(0, UINT64_MAX);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(result);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_002: [ If max_batch_size is 0 then constbuffer_array_batcher_nv_builder_create shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_builder_create_with_0_max_batch_size_fails)
+{
+    // act
+    CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_HANDLE result = constbuffer_array_batcher_nv_builder_create(UINT32_MAX, 0);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(result);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_003: [ constbuffer_array_batcher_nv_builder_create shall allocate memory for a new CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_HANDLE. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_004: [ constbuffer_array_batcher_nv_builder_create shall allocate memory for the buffer counts of the payloads and for the CONSTBUFFER_HANDLEs of the batch. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_005: [ constbuffer_array_batcher_nv_builder_create shall succeed and return a non-NULL handle that holds no payloads. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_builder_create_succeeds)
+{
+    // arrange
+    uint32_t payload_count;
+    uint64_t batch_size;
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(malloc_2(IGNORED_ARG, sizeof(uint32_t)));
+    STRICT_EXPECTED_CALL(malloc_2(IGNORED_ARG, sizeof(CONSTBUFFER_HANDLE)));
+
+    // act
+    CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_HANDLE result = constbuffer_array_batcher_nv_builder_create(10, 1024);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_batcher_nv_builder_get_size(result, &payload_count, &batch_size));
+    ASSERT_ARE_EQUAL(uint32_t, 0, payload_count);
+    ASSERT_ARE_EQUAL(uint64_t, sizeof(uint32_t), batch_size);
+
+    // cleanup
+    constbuffer_array_batcher_nv_builder_destroy(result);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_006: [ If there are any failures then constbuffer_array_batcher_nv_builder_create shall fail and return NULL. ]*/
+TEST_FUNCTION(when_underlying_calls_fail_constbuffer_array_batcher_nv_builder_create_also_fails)
+{
+    // arrange
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(malloc_2(IGNORED_ARG, sizeof(uint32_t)));
+    STRICT_EXPECTED_CALL(malloc_2(IGNORED_ARG, sizeof(CONSTBUFFER_HANDLE)));
+
+    umock_c_negative_tests_snapshot();
+
+    for (size_t i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
+        if (umock_c_negative_tests_can_call_fail(i))
+        {
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(i);
+
+            // act
+            CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_HANDLE result = constbuffer_array_batcher_nv_builder_create(10, 1024);
+
+            // assert
+            ASSERT_IS_NULL(result, "On failed call %zu", i);
+        }
+    }
+}
+
+/* constbuffer_array_batcher_nv_builder_destroy */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_007: [ If builder is NULL then constbuffer_array_batcher_nv_builder_destroy shall return. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_builder_destroy_with_NULL_builder_returns)
+{
+    // act
+    constbuffer_array_batcher_nv_builder_destroy(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_008: [ constbuffer_array_batcher_nv_builder_destroy shall decrement the reference count of all the buffers of the payloads held by builder and free all used resources. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_builder_destroy_releases_the_buffers_of_the_payloads)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE payloads[2];
+    payloads[0] = create_test_payload(1, 3);
+    payloads[1] = create_test_payload(2, 3);
+    CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_HANDLE builder = create_test_builder(10, 1024, payloads, 2);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(CONSTBUFFER_DecRef(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_DecRef(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_DecRef(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    // act
+    constbuffer_array_batcher_nv_builder_destroy(builder);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    real_constbuffer_array_dec_ref(payloads[0]);
+    real_constbuffer_array_dec_ref(payloads[1]);
+}
+
+/* constbuffer_array_batcher_nv_builder_append */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_009: [ If builder is NULL then constbuffer_array_batcher_nv_builder_append shall fail and return CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_INVALID_ARGS. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_builder_append_with_NULL_builder_fails)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE payload = create_test_payload(1, 3);
+    umock_c_reset_all_calls();
+
+    // act
+    CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_RESULT result = constbuffer_array_batcher_nv_builder_append(NULL, payload);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_RESULT, CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_INVALID_ARGS, result);
+
+    // cleanup
+    real_constbuffer_array_dec_ref(payload);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_010: [ If payload is NULL then constbuffer_array_batcher_nv_builder_append shall fail and return CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_INVALID_ARGS. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_builder_append_with_NULL_payload_fails)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_HANDLE builder = create_test_builder(10, 1024, NULL, 0);
+    umock_c_reset_all_calls();
+
+    // act
+    CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_RESULT result = constbuffer_array_batcher_nv_builder_append(builder, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_RESULT, CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_INVALID_ARGS, result);
+
+    // cleanup
+    constbuffer_array_batcher_nv_builder_destroy(builder);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_011: [ constbuffer_array_batcher_nv_builder_append shall get the number of buffers of payload by calling constbuffer_array_get_buffer_count and its size by calling constbuffer_array_get_all_buffers_size_64. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_014: [ constbuffer_array_batcher_nv_builder_append shall store the buffers of payload (obtained with constbuffer_array_get_buffer) after the buffers already held by builder, record the buffer count and the size of payload, succeed and return CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_OK. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_builder_append_succeeds)
+{
+    // arrange
+    uint32_t payload_count;
+    uint64_t batch_size;
+    CONSTBUFFER_ARRAY_HANDLE payload = create_test_payload(2, 3);
+    CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_HANDLE builder = create_test_builder(10, 1024, NULL, 0);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(payload, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size_64(payload, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer(payload, 0));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer(payload, 1));
+
+    // act
+    CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_RESULT result = constbuffer_array_batcher_nv_builder_append(builder, payload);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_RESULT, CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_OK, result);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_batcher_nv_builder_get_size(builder, &payload_count, &batch_size));
+    ASSERT_ARE_EQUAL(uint32_t, 1, payload_count);
+    ASSERT_ARE_EQUAL(uint64_t, 2 * sizeof(uint32_t) + 6, batch_size);
+
+    // cleanup
+    constbuffer_array_batcher_nv_builder_destroy(builder);
+    real_constbuffer_array_dec_ref(payload);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_014: [ constbuffer_array_batcher_nv_builder_append shall store the buffers of payload (obtained with constbuffer_array_get_buffer) after the buffers already held by builder, record the buffer count and the size of payload, succeed and return CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_OK. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_builder_append_of_an_empty_payload_succeeds)
+{
+    // arrange
+    uint32_t payload_count;
+    uint64_t batch_size;
+    CONSTBUFFER_ARRAY_HANDLE payload = create_test_payload(0, 0);
+    CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_HANDLE builder = create_test_builder(10, 1024, NULL, 0);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(payload, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size_64(payload, IGNORED_ARG));
+
+    // act
+    CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_RESULT result = constbuffer_array_batcher_nv_builder_append(builder, payload);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_RESULT, CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_OK, result);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_batcher_nv_builder_get_size(builder, &payload_count, &batch_size));
+    ASSERT_ARE_EQUAL(uint32_t, 1, payload_count);
+    ASSERT_ARE_EQUAL(uint64_t, 2 * sizeof(uint32_t), batch_size);
+
+    // cleanup
+    constbuffer_array_batcher_nv_builder_destroy(builder);
+    real_constbuffer_array_dec_ref(payload);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_012: [ If builder holds at least one payload and adding payload would take the batch over max_payload_count payloads, over max_batch_size bytes (header included), over UINT32_MAX / sizeof(uint32_t) - 1 payloads or over UINT32_MAX buffers then constbuffer_array_batcher_nv_builder_append shall leave builder unchanged and return CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_FULL. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_builder_append_over_max_payload_count_returns_FULL)
+{
+    // arrange
+    uint32_t payload_count;
+    uint64_t batch_size;
+    CONSTBUFFER_ARRAY_HANDLE payloads[3];
+    payloads[0] = create_test_payload(1, 3);
+    payloads[1] = create_test_payload(1, 3);
+    payloads[2] = create_test_payload(1, 3);
+    CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_HANDLE builder = create_test_builder(2, 1024, payloads, 2);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(payloads[2], IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size_64(payloads[2], IGNORED_ARG));
+
+    // act
+    CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_RESULT result = constbuffer_array_batcher_nv_builder_append(builder, payloads[2]);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_RESULT, CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_FULL, result);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_batcher_nv_builder_get_size(builder, &payload_count, &batch_size));
+    ASSERT_ARE_EQUAL(uint32_t, 2, payload_count);
+    ASSERT_ARE_EQUAL(uint64_t, 3 * sizeof(uint32_t) + 6, batch_size);
+
+    // cleanup
+    constbuffer_array_batcher_nv_builder_destroy(builder);
+    real_constbuffer_array_dec_ref(payloads[0]);
+    real_constbuffer_array_dec_ref(payloads[1]);
+    real_constbuffer_array_dec_ref(payloads[2]);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_012: [ If builder holds at least one payload and adding payload would take the batch over max_payload_count payloads, over max_batch_size bytes (header included), over UINT32_MAX / sizeof(uint32_t) - 1 payloads or over UINT32_MAX buffers then constbuffer_array_batcher_nv_builder_append shall leave builder unchanged and return CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_FULL. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_builder_append_over_max_batch_size_returns_FULL)
+{
+    // arrange
+    uint32_t payload_count;
+    uint64_t batch_size;
+    CONSTBUFFER_ARRAY_HANDLE payloads[2];
+    payloads[0] = create_test_payload(1, 4);
+    payloads[1] = create_test_payload(1, 5);
+    /*header of a 2 payloads batch is 12 bytes, the payloads have 9 bytes*/
+    CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_HANDLE builder = create_test_builder(10, 20, payloads, 1);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(payloads[1], IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size_64(payloads[1], IGNORED_ARG));
+
+    // act
+    CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_RESULT result = constbuffer_array_batcher_nv_builder_append(builder, payloads[1]);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_RESULT, CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_FULL, result);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_batcher_nv_builder_get_size(builder, &payload_count, &batch_size));
+    ASSERT_ARE_EQUAL(uint32_t, 1, payload_count);
+    ASSERT_ARE_EQUAL(uint64_t, 2 * sizeof(uint32_t) + 4, batch_size);
+
+    // cleanup
+    constbuffer_array_batcher_nv_builder_destroy(builder);
+    real_constbuffer_array_dec_ref(payloads[0]);
+    real_constbuffer_array_dec_ref(payloads[1]);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_012: [ If builder holds at least one payload and adding payload would take the batch over max_payload_count payloads, over max_batch_size bytes (header included), over UINT32_MAX / sizeof(uint32_t) - 1 payloads or over UINT32_MAX buffers then constbuffer_array_batcher_nv_builder_append shall leave builder unchanged and return CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_FULL. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_builder_append_exactly_max_batch_size_succeeds)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE payloads[2];
+    payloads[0] = create_test_payload(1, 4);
+    payloads[1] = create_test_payload(1, 4);
+    CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_HANDLE builder = create_test_builder(10, 20, payloads, 1);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(payloads[1], IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size_64(payloads[1], IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer(payloads[1], 0));
+
+    // act
+    CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_RESULT result = constbuffer_array_batcher_nv_builder_append(builder, payloads[1]);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_RESULT, CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_OK, result);
+
+    // cleanup
+    constbuffer_array_batcher_nv_builder_destroy(builder);
+    real_constbuffer_array_dec_ref(payloads[0]);
+    real_constbuffer_array_dec_ref(payloads[1]);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_012: [ If builder holds at least one payload and adding payload would take the batch over max_payload_count payloads, over max_batch_size bytes (header included), over UINT32_MAX / sizeof(uint32_t) - 1 payloads or over UINT32_MAX buffers then constbuffer_array_batcher_nv_builder_append shall leave builder unchanged and return CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_FULL. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_builder_append_of_a_payload_bigger_than_max_batch_size_to_an_empty_builder_succeeds)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE payload = create_test_payload(2, 10);
+    CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_HANDLE builder = create_test_builder(10, 5, NULL, 0);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(payload, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size_64(payload, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer(payload, 0));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer(payload, 1));
+
+    // act
+    CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_RESULT result = constbuffer_array_batcher_nv_builder_append(builder, payload);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_RESULT, CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_OK, result);
+
+    // cleanup
+    constbuffer_array_batcher_nv_builder_destroy(builder);
+    real_constbuffer_array_dec_ref(payload);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_013: [ constbuffer_array_batcher_nv_builder_append shall make room for the buffer count of payload and for its CONSTBUFFER_HANDLEs by doubling the capacity of the arrays that hold them (calling realloc_2) as needed. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_builder_append_grows_the_arrays)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE payloads[9];
+    for (uint32_t i = 0; i < 9; i++)
+    {
+        payloads[i] = create_test_payload(1, 1);
+    }
+    CONSTBUFFER_ARRAY_HANDLE big_payload = create_test_payload(20, 1);
+    CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_HANDLE builder = create_test_builder(UINT32_MAX, UINT64_MAX, payloads, 8);
+    umock_c_reset_all_calls();
+
+    /*9th payload does not fit in the initial 8 buffer counts*/
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(payloads[8], IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size_64(payloads[8], IGNORED_ARG));
+    STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, 16, sizeof(uint32_t)));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer(payloads[8], 0));
+
+    /*1 + 9 + 20 buffers do not fit in the initial 16 handles, the capacity is doubled until they do*/
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(big_payload, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size_64(big_payload, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, 32, sizeof(CONSTBUFFER_HANDLE)));
+    for (uint32_t i = 0; i < 20; i++)
+    {
+        STRICT_EXPECTED_CALL(constbuffer_array_get_buffer(big_payload, i));
+    }
+
+    // act
+    CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_RESULT result_1 = constbuffer_array_batcher_nv_builder_append(builder, payloads[8]);
+    CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_RESULT result_2 = constbuffer_array_batcher_nv_builder_append(builder, big_payload);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_RESULT, CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_OK, result_1);
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_RESULT, CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_OK, result_2);
+
+    // cleanup
+    constbuffer_array_batcher_nv_builder_destroy(builder);
+    for (uint32_t i = 0; i < 9; i++)
+    {
+        real_constbuffer_array_dec_ref(payloads[i]);
+    }
+    real_constbuffer_array_dec_ref(big_payload);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_015: [ If there are any failures then constbuffer_array_batcher_nv_builder_append shall fail, leave builder unchanged and return CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_ERROR. ]*/
+TEST_FUNCTION(when_underlying_calls_fail_constbuffer_array_batcher_nv_builder_append_also_fails)
+{
+    // arrange
+    uint32_t payload_count;
+    uint64_t batch_size;
+    CONSTBUFFER_ARRAY_HANDLE payloads[9];
+    for (uint32_t i = 0; i < 8; i++)
+    {
+        payloads[i] = create_test_payload(1, 1);
+    }
+    /*does not fit in the buffer counts nor in the handles the builder has room for*/
+    payloads[8] = create_test_payload(8, 1);
+    CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_HANDLE builder = create_test_builder(UINT32_MAX, UINT64_MAX, payloads, 8);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(payloads[8], IGNORED_ARG))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size_64(payloads[8], IGNORED_ARG));
+    STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, 16, sizeof(uint32_t)));
+    STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, 32, sizeof(CONSTBUFFER_HANDLE)));
+
+    umock_c_negative_tests_snapshot();
+
+    for (size_t i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
+        if (umock_c_negative_tests_can_call_fail(i))
+        {
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(i);
+
+            // act
+            CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_RESULT result = constbuffer_array_batcher_nv_builder_append(builder, payloads[8]);
+
+            // assert
+            ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_RESULT, CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_ERROR, result, "On failed call %zu", i);
+            ASSERT_ARE_EQUAL(int, 0, constbuffer_array_batcher_nv_builder_get_size(builder, &payload_count, &batch_size));
+            ASSERT_ARE_EQUAL(uint32_t, 8, payload_count, "On failed call %zu", i);
+        }
+    }
+
+    // cleanup
+    constbuffer_array_batcher_nv_builder_destroy(builder);
+    for (uint32_t i = 0; i < 9; i++)
+    {
+        real_constbuffer_array_dec_ref(payloads[i]);
+    }
+}
+
+/* constbuffer_array_batcher_nv_builder_can_append */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_016: [ If builder is NULL then constbuffer_array_batcher_nv_builder_can_append shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_builder_can_append_with_NULL_builder_fails)
+{
+    // arrange
+    bool fits;
+    CONSTBUFFER_ARRAY_HANDLE payload = create_test_payload(1, 3);
+    umock_c_reset_all_calls();
+
+    // act
+    int result = constbuffer_array_batcher_nv_builder_can_append(NULL, payload, &fits);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    real_constbuffer_array_dec_ref(payload);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_017: [ If payload is NULL then constbuffer_array_batcher_nv_builder_can_append shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_builder_can_append_with_NULL_payload_fails)
+{
+    // arrange
+    bool fits;
+    CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_HANDLE builder = create_test_builder(10, 1024, NULL, 0);
+    umock_c_reset_all_calls();
+
+    // act
+    int result = constbuffer_array_batcher_nv_builder_can_append(builder, NULL, &fits);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    constbuffer_array_batcher_nv_builder_destroy(builder);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_018: [ If fits is NULL then constbuffer_array_batcher_nv_builder_can_append shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_builder_can_append_with_NULL_fits_fails)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE payload = create_test_payload(1, 3);
+    CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_HANDLE builder = create_test_builder(10, 1024, NULL, 0);
+    umock_c_reset_all_calls();
+
+    // act
+    int result = constbuffer_array_batcher_nv_builder_can_append(builder, payload, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    constbuffer_array_batcher_nv_builder_destroy(builder);
+    real_constbuffer_array_dec_ref(payload);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_019: [ constbuffer_array_batcher_nv_builder_can_append shall get the number of buffers of payload by calling constbuffer_array_get_buffer_count and its size by calling constbuffer_array_get_all_buffers_size_64. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_020: [ constbuffer_array_batcher_nv_builder_can_append shall write in fits false if constbuffer_array_batcher_nv_builder_append would return CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_FULL for payload and true otherwise, succeed and return 0. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_builder_can_append_with_a_payload_that_fits_returns_true)
+{
+    // arrange
+    bool fits = false;
+    CONSTBUFFER_ARRAY_HANDLE payloads[2];
+    payloads[0] = create_test_payload(1, 4);
+    payloads[1] = create_test_payload(1, 4);
+    CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_HANDLE builder = create_test_builder(10, 20, payloads, 1);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(payloads[1], IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size_64(payloads[1], IGNORED_ARG));
+
+    // act
+    int result = constbuffer_array_batcher_nv_builder_can_append(builder, payloads[1], &fits);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_IS_TRUE(fits);
+
+    // cleanup
+    constbuffer_array_batcher_nv_builder_destroy(builder);
+    real_constbuffer_array_dec_ref(payloads[0]);
+    real_constbuffer_array_dec_ref(payloads[1]);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_020: [ constbuffer_array_batcher_nv_builder_can_append shall write in fits false if constbuffer_array_batcher_nv_builder_append would return CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_FULL for payload and true otherwise, succeed and return 0. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_builder_can_append_with_a_payload_that_does_not_fit_returns_false)
+{
+    // arrange
+    bool fits = true;
+    CONSTBUFFER_ARRAY_HANDLE payloads[2];
+    payloads[0] = create_test_payload(1, 4);
+    payloads[1] = create_test_payload(1, 5);
+    CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_HANDLE builder = create_test_builder(10, 20, payloads, 1);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(payloads[1], IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size_64(payloads[1], IGNORED_ARG));
+
+    // act
+    int result = constbuffer_array_batcher_nv_builder_can_append(builder, payloads[1], &fits);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_IS_FALSE(fits);
+
+    // cleanup
+    constbuffer_array_batcher_nv_builder_destroy(builder);
+    real_constbuffer_array_dec_ref(payloads[0]);
+    real_constbuffer_array_dec_ref(payloads[1]);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_021: [ If there are any failures then constbuffer_array_batcher_nv_builder_can_append shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_builder_can_append_fails_when_constbuffer_array_get_all_buffers_size_64_fails)
+{
+    // arrange
+    bool fits;
+    CONSTBUFFER_ARRAY_HANDLE payload = create_test_payload(1, 3);
+    CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_HANDLE builder = create_test_builder(10, 1024, NULL, 0);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(payload, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size_64(payload, IGNORED_ARG))
+        .SetReturn(MU_FAILURE);
+
+    // act
+    int result = constbuffer_array_batcher_nv_builder_can_append(builder, payload, &fits);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    constbuffer_array_batcher_nv_builder_destroy(builder);
+    real_constbuffer_array_dec_ref(payload);
+}
+
+/* constbuffer_array_batcher_nv_builder_get_size */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_022: [ If builder is NULL then constbuffer_array_batcher_nv_builder_get_size shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_builder_get_size_with_NULL_builder_fails)
+{
+    // arrange
+    uint32_t payload_count;
+    uint64_t batch_size;
+
+    // act
+    int result = constbuffer_array_batcher_nv_builder_get_size(NULL, &payload_count, &batch_size);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_023: [ If payload_count is NULL then constbuffer_array_batcher_nv_builder_get_size shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_builder_get_size_with_NULL_payload_count_fails)
+{
+    // arrange
+    uint64_t batch_size;
+    CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_HANDLE builder = create_test_builder(10, 1024, NULL, 0);
+    umock_c_reset_all_calls();
+
+    // act
+    int result = constbuffer_array_batcher_nv_builder_get_size(builder, NULL, &batch_size);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    constbuffer_array_batcher_nv_builder_destroy(builder);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_024: [ If batch_size is NULL then constbuffer_array_batcher_nv_builder_get_size shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_builder_get_size_with_NULL_batch_size_fails)
+{
+    // arrange
+    uint32_t payload_count;
+    CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_HANDLE builder = create_test_builder(10, 1024, NULL, 0);
+    umock_c_reset_all_calls();
+
+    // act
+    int result = constbuffer_array_batcher_nv_builder_get_size(builder, &payload_count, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    constbuffer_array_batcher_nv_builder_destroy(builder);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_025: [ constbuffer_array_batcher_nv_builder_get_size shall write in payload_count the number of payloads held by builder and in batch_size the size of the header ((payload_count + 1) * sizeof(uint32_t)) plus the size of all the payloads, succeed and return 0. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_builder_get_size_succeeds)
+{
+    // arrange
+    uint32_t payload_count;
+    uint64_t batch_size;
+    CONSTBUFFER_ARRAY_HANDLE payloads[3];
+    payloads[0] = create_test_payload(1, 3);
+    payloads[1] = create_test_payload(0, 0);
+    payloads[2] = create_test_payload(3, 5);
+    CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_HANDLE builder = create_test_builder(10, 1024, payloads, 3);
+    umock_c_reset_all_calls();
+
+    // act
+    int result = constbuffer_array_batcher_nv_builder_get_size(builder, &payload_count, &batch_size);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 3, payload_count);
+    ASSERT_ARE_EQUAL(uint64_t, 4 * sizeof(uint32_t) + 3 + 15, batch_size);
+
+    // cleanup
+    constbuffer_array_batcher_nv_builder_destroy(builder);
+    real_constbuffer_array_dec_ref(payloads[0]);
+    real_constbuffer_array_dec_ref(payloads[1]);
+    real_constbuffer_array_dec_ref(payloads[2]);
+}
+
+/* constbuffer_array_batcher_nv_builder_seal */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_026: [ If builder is NULL then constbuffer_array_batcher_nv_builder_seal shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_builder_seal_with_NULL_builder_fails)
+{
+    // act
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_batcher_nv_builder_seal(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(result);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_027: [ If builder holds no payloads then constbuffer_array_batcher_nv_builder_seal shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_builder_seal_with_no_payloads_fails)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_HANDLE builder = create_test_builder(10, 1024, NULL, 0);
+    umock_c_reset_all_calls();
+
+    // act
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_batcher_nv_builder_seal(builder);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(result);
+
+    // cleanup
+    constbuffer_array_batcher_nv_builder_destroy(builder);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_028: [ constbuffer_array_batcher_nv_builder_seal shall allocate memory for the header buffer ((payload count + 1) uint32_t values). ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_029: [ constbuffer_array_batcher_nv_builder_seal shall write the payload count followed by the buffer count of each payload in the header memory. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_030: [ constbuffer_array_batcher_nv_builder_seal shall create the header buffer by calling CONSTBUFFER_CreateWithMoveMemory and store it as the first CONSTBUFFER_HANDLE of the batch. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_031: [ constbuffer_array_batcher_nv_builder_seal shall call constbuffer_array_create_with_move_buffers with the CONSTBUFFER_HANDLEs of the batch (the handles are not copied and their reference counts are not changed). ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_032: [ constbuffer_array_batcher_nv_builder_seal shall free builder, succeed and return the batch. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_builder_seal_succeeds)
+{
+    // arrange
+    uint32_t buffer_count;
+    uint8_t expected_header_memory[] = { 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x03 };
+    CONSTBUFFER_ARRAY_HANDLE payloads[2];
+    payloads[0] = create_test_payload(1, 1);
+    payloads[1] = create_test_payload(3, 1);
+    CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_HANDLE builder = create_test_builder(10, 1024, payloads, 2);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(malloc_2(3, sizeof(uint32_t)));
+    STRICT_EXPECTED_CALL(write_uint32_t(IGNORED_ARG, 2));
+    STRICT_EXPECTED_CALL(write_uint32_t(IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(write_uint32_t(IGNORED_ARG, 3));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_CreateWithMoveMemory(IGNORED_ARG, sizeof(uint32_t) * 3))
+        .ValidateArgumentBuffer(1, expected_header_memory, sizeof(expected_header_memory));
+    STRICT_EXPECTED_CALL(constbuffer_array_create_with_move_buffers(IGNORED_ARG, 5));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    // act
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_batcher_nv_builder_seal(builder);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(int, 0, real_constbuffer_array_get_buffer_count(result, &buffer_count));
+    ASSERT_ARE_EQUAL(uint32_t, 5, buffer_count);
+    ASSERT_ARE_EQUAL(void_ptr, real_constbuffer_array_get_buffer_content(payloads[0], 0), real_constbuffer_array_get_buffer_content(result, 1));
+    ASSERT_ARE_EQUAL(void_ptr, real_constbuffer_array_get_buffer_content(payloads[1], 0), real_constbuffer_array_get_buffer_content(result, 2));
+    ASSERT_ARE_EQUAL(void_ptr, real_constbuffer_array_get_buffer_content(payloads[1], 1), real_constbuffer_array_get_buffer_content(result, 3));
+    ASSERT_ARE_EQUAL(void_ptr, real_constbuffer_array_get_buffer_content(payloads[1], 2), real_constbuffer_array_get_buffer_content(result, 4));
+
+    // cleanup
+    real_constbuffer_array_dec_ref(result);
+    real_constbuffer_array_dec_ref(payloads[0]);
+    real_constbuffer_array_dec_ref(payloads[1]);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_032: [ constbuffer_array_batcher_nv_builder_seal shall free builder, succeed and return the batch. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_builder_seal_produces_the_same_batch_as_constbuffer_array_batcher_nv_batch)
+{
+    // arrange
+    uint32_t payload_count;
+    CONSTBUFFER_ARRAY_HANDLE payloads[3];
+    payloads[0] = create_test_payload(2, 3);
+    payloads[1] = create_test_payload(0, 0);
+    payloads[2] = create_test_payload(1, 7);
+    CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_HANDLE builder = create_test_builder(10, 1024, payloads, 3);
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_batcher_nv_builder_seal(builder);
+    ASSERT_IS_NOT_NULL(result);
+    CONSTBUFFER_ARRAY_HANDLE expected = constbuffer_array_batcher_nv_batch(payloads, 3);
+    ASSERT_IS_NOT_NULL(expected);
+    umock_c_reset_all_calls();
+
+    // act
+    CONSTBUFFER_ARRAY_HANDLE* unbatched = constbuffer_array_batcher_nv_unbatch(result, &payload_count);
+
+    // assert
+    ASSERT_IS_NOT_NULL(unbatched);
+    ASSERT_ARE_EQUAL(uint32_t, 3, payload_count);
+    ASSERT_IS_TRUE(real_CONSTBUFFER_ARRAY_HANDLE_contain_same(payloads[0], unbatched[0]));
+    ASSERT_IS_TRUE(real_CONSTBUFFER_ARRAY_HANDLE_contain_same(payloads[1], unbatched[1]));
+    ASSERT_IS_TRUE(real_CONSTBUFFER_ARRAY_HANDLE_contain_same(payloads[2], unbatched[2]));
+    CONSTBUFFER_HANDLE expected_header = real_constbuffer_array_get_buffer(expected, 0);
+    CONSTBUFFER_HANDLE result_header = real_constbuffer_array_get_buffer(result, 0);
+    ASSERT_IS_TRUE(real_CONSTBUFFER_HANDLE_contain_same(expected_header, result_header));
+
+    // cleanup
+    real_CONSTBUFFER_DecRef(expected_header);
+    real_CONSTBUFFER_DecRef(result_header);
+    for (uint32_t i = 0; i < payload_count; i++)
+    {
+        real_constbuffer_array_dec_ref(unbatched[i]);
+    }
+    real_gballoc_hl_free(unbatched);
+    real_constbuffer_array_dec_ref(expected);
+    real_constbuffer_array_dec_ref(result);
+    real_constbuffer_array_dec_ref(payloads[0]);
+    real_constbuffer_array_dec_ref(payloads[1]);
+    real_constbuffer_array_dec_ref(payloads[2]);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_033: [ If there are any failures then constbuffer_array_batcher_nv_builder_seal shall fail, leave builder unchanged and return NULL. ]*/
+TEST_FUNCTION(when_underlying_calls_fail_constbuffer_array_batcher_nv_builder_seal_also_fails)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE payloads[2];
+    payloads[0] = create_test_payload(1, 1);
+    payloads[1] = create_test_payload(3, 1);
+    CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_HANDLE builder = create_test_builder(10, 1024, payloads, 2);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(malloc_2(3, sizeof(uint32_t)));
+    STRICT_EXPECTED_CALL(write_uint32_t(IGNORED_ARG, 2));
+    STRICT_EXPECTED_CALL(write_uint32_t(IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(write_uint32_t(IGNORED_ARG, 3));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_CreateWithMoveMemory(IGNORED_ARG, sizeof(uint32_t) * 3));
+    STRICT_EXPECTED_CALL(constbuffer_array_create_with_move_buffers(IGNORED_ARG, 5));
+
+    umock_c_negative_tests_snapshot();
+
+    for (size_t i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
+        if (umock_c_negative_tests_can_call_fail(i))
+        {
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(i);
+
+            // act
+            CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_batcher_nv_builder_seal(builder);
+
+            // assert
+            ASSERT_IS_NULL(result, "On failed call %zu", i);
+        }
+    }
+
+    // cleanup
+    constbuffer_array_batcher_nv_builder_destroy(builder);
+    real_constbuffer_array_dec_ref(payloads[0]);
+    real_constbuffer_array_dec_ref(payloads[1]);
+}
+
+/* constbuffer_array_batcher_nv_view_create */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_034: [ If batch is NULL then constbuffer_array_batcher_nv_view_create shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_view_create_with_NULL_batch_fails)
+{
+    // arrange
+
+    // act
+    CONSTBUFFER_ARRAY_BATCHER_NV_VIEW_HANDLE result = constbuffer_array_batcher_nv_view_create(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(result);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_035: [ constbuffer_array_batcher_nv_view_create shall obtain the number of buffers in batch. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_036: [ If batch has no buffers then constbuffer_array_batcher_nv_view_create shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_view_create_with_0_buffers_fails)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE batch = real_constbuffer_array_create_empty();
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(batch, IGNORED_ARG));
+
+    // act
+    CONSTBUFFER_ARRAY_BATCHER_NV_VIEW_HANDLE result = constbuffer_array_batcher_nv_view_create(batch);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(result);
+
+    // cleanup
+    real_constbuffer_array_dec_ref(batch);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_037: [ constbuffer_array_batcher_nv_view_create shall obtain the content of the first (header) buffer in batch. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_038: [ If the size of the header buffer is less than sizeof(uint32_t) or not a multiple of sizeof(uint32_t) then constbuffer_array_batcher_nv_view_create shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_view_create_with_header_buffer_size_3_fails)
+{
+    // arrange
+    uint8_t header[] = { 0x00, 0x00, 0x00 };
+    CONSTBUFFER_ARRAY_HANDLE batch = create_test_batch_from_header(header, sizeof(header));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(batch, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(batch, 0));
+
+    // act
+    CONSTBUFFER_ARRAY_BATCHER_NV_VIEW_HANDLE result = constbuffer_array_batcher_nv_view_create(batch);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(result);
+
+    // cleanup
+    real_constbuffer_array_dec_ref(batch);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_038: [ If the size of the header buffer is less than sizeof(uint32_t) or not a multiple of sizeof(uint32_t) then constbuffer_array_batcher_nv_view_create shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_view_create_with_header_buffer_size_5_fails)
+{
+    // arrange
+    uint8_t header[] = { 0x00, 0x00, 0x00, 0x01, 0x00 };
+    CONSTBUFFER_ARRAY_HANDLE batch = create_test_batch_from_header(header, sizeof(header));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(batch, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(batch, 0));
+
+    // act
+    CONSTBUFFER_ARRAY_BATCHER_NV_VIEW_HANDLE result = constbuffer_array_batcher_nv_view_create(batch);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(result);
+
+    // cleanup
+    real_constbuffer_array_dec_ref(batch);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_039: [ constbuffer_array_batcher_nv_view_create shall read the number of payloads from the first uint32_t of the header. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_040: [ If the number of payloads is 0 then constbuffer_array_batcher_nv_view_create shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_view_create_with_payload_count_0_fails)
+{
+    // arrange
+    uint8_t header[] = { 0x00, 0x00, 0x00, 0x00 };
+    CONSTBUFFER_ARRAY_HANDLE batch = create_test_batch_from_header(header, sizeof(header));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(batch, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(batch, 0));
+    STRICT_EXPECTED_CALL(read_uint32_t(IGNORED_ARG, IGNORED_ARG));
+
+    // act
+    CONSTBUFFER_ARRAY_BATCHER_NV_VIEW_HANDLE result = constbuffer_array_batcher_nv_view_create(batch);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(result);
+
+    // cleanup
+    real_constbuffer_array_dec_ref(batch);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_041: [ If the number of payloads does not match the size of the header buffer then constbuffer_array_batcher_nv_view_create shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_view_create_with_size_of_header_buffer_not_matching_the_number_of_payloads_fails)
+{
+    // arrange
+    uint8_t header[] = { 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
+    CONSTBUFFER_ARRAY_HANDLE batch = create_test_batch_from_header(header, sizeof(header));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(batch, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(batch, 0));
+    STRICT_EXPECTED_CALL(read_uint32_t(IGNORED_ARG, IGNORED_ARG));
+
+    // act
+    CONSTBUFFER_ARRAY_BATCHER_NV_VIEW_HANDLE result = constbuffer_array_batcher_nv_view_create(batch);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(result);
+
+    // cleanup
+    real_constbuffer_array_dec_ref(batch);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_044: [ If there are not enough buffers in batch for all the payloads then constbuffer_array_batcher_nv_view_create shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_view_create_with_not_enough_buffers_for_the_second_payload_fails)
+{
+    // arrange
+    uint8_t header[] = { 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x01 };
+    CONSTBUFFER_HANDLE test_buffers[2];
+    test_buffers[0] = real_CONSTBUFFER_Create(header, sizeof(header));
+    test_buffers[1] = real_CONSTBUFFER_Create(header, 1);
+    CONSTBUFFER_ARRAY_HANDLE batch = real_constbuffer_array_create(test_buffers, 2);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(batch, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(batch, 0));
+    STRICT_EXPECTED_CALL(read_uint32_t(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 3, sizeof(uint32_t)));
+    STRICT_EXPECTED_CALL(read_uint32_t(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(read_uint32_t(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    // act
+    CONSTBUFFER_ARRAY_BATCHER_NV_VIEW_HANDLE result = constbuffer_array_batcher_nv_view_create(batch);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(result);
+
+    // cleanup
+    real_constbuffer_array_dec_ref(batch);
+    real_CONSTBUFFER_DecRef(test_buffers[0]);
+    real_CONSTBUFFER_DecRef(test_buffers[1]);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_035: [ constbuffer_array_batcher_nv_view_create shall obtain the number of buffers in batch. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_037: [ constbuffer_array_batcher_nv_view_create shall obtain the content of the first (header) buffer in batch. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_039: [ constbuffer_array_batcher_nv_view_create shall read the number of payloads from the first uint32_t of the header. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_042: [ constbuffer_array_batcher_nv_view_create shall allocate memory for the view, including the index of the first buffer of each payload and the index past the last payload (number of payloads + 1 uint32_t values). ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_043: [ constbuffer_array_batcher_nv_view_create shall read the buffer count of each payload from the rest of the header and compute the index of the first buffer of each payload. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_045: [ constbuffer_array_batcher_nv_view_create shall increment the reference count of batch, succeed and return the view. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_view_create_succeeds)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE payloads[3];
+    CONSTBUFFER_ARRAY_HANDLE batch = create_test_batch(payloads);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(batch, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(batch, 0));
+    STRICT_EXPECTED_CALL(read_uint32_t(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 4, sizeof(uint32_t)));
+    STRICT_EXPECTED_CALL(read_uint32_t(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(read_uint32_t(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(read_uint32_t(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_inc_ref(batch));
+
+    // act
+    CONSTBUFFER_ARRAY_BATCHER_NV_VIEW_HANDLE result = constbuffer_array_batcher_nv_view_create(batch);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(result);
+
+    // cleanup
+    constbuffer_array_batcher_nv_view_destroy(result);
+    destroy_test_batch(batch, payloads);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_045: [ constbuffer_array_batcher_nv_view_create shall increment the reference count of batch, succeed and return the view. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_view_keeps_the_batch_alive)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE payloads[3];
+    CONSTBUFFER_ARRAY_HANDLE batch = create_test_batch(payloads);
+    CONSTBUFFER_ARRAY_BATCHER_NV_VIEW_HANDLE view = create_test_view(batch);
+    real_constbuffer_array_dec_ref(batch);
+
+    // act
+    CONSTBUFFER_ARRAY_HANDLE payload = constbuffer_array_batcher_nv_view_get_payload(view, 2);
+
+    // assert
+    ASSERT_IS_NOT_NULL(payload);
+    ASSERT_IS_TRUE(real_CONSTBUFFER_ARRAY_HANDLE_contain_same(payloads[2], payload));
+
+    // cleanup
+    real_constbuffer_array_dec_ref(payload);
+    constbuffer_array_batcher_nv_view_destroy(view);
+    real_constbuffer_array_dec_ref(payloads[0]);
+    real_constbuffer_array_dec_ref(payloads[1]);
+    real_constbuffer_array_dec_ref(payloads[2]);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_046: [ If there are any other failures then constbuffer_array_batcher_nv_view_create shall fail and return NULL. ]*/
+TEST_FUNCTION(when_underlying_calls_fail_constbuffer_array_batcher_nv_view_create_also_fails)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE payloads[3];
+    CONSTBUFFER_ARRAY_HANDLE batch = create_test_batch(payloads);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(batch, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(batch, 0));
+    STRICT_EXPECTED_CALL(read_uint32_t(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 4, sizeof(uint32_t)));
+    STRICT_EXPECTED_CALL(read_uint32_t(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(read_uint32_t(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(read_uint32_t(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_inc_ref(batch));
+
+    umock_c_negative_tests_snapshot();
+
+    for (size_t i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
+        if (umock_c_negative_tests_can_call_fail(i))
+        {
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(i);
+
+            // act
+            CONSTBUFFER_ARRAY_BATCHER_NV_VIEW_HANDLE result = constbuffer_array_batcher_nv_view_create(batch);
+
+            // assert
+            ASSERT_IS_NULL(result, "On failed call %zu", i);
+        }
+    }
+
+    // cleanup
+    destroy_test_batch(batch, payloads);
+}
+
+/* constbuffer_array_batcher_nv_view_destroy */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_047: [ If view is NULL then constbuffer_array_batcher_nv_view_destroy shall return. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_view_destroy_with_NULL_view_returns)
+{
+    // arrange
+
+    // act
+    constbuffer_array_batcher_nv_view_destroy(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_048: [ constbuffer_array_batcher_nv_view_destroy shall decrement the reference count of the batch and free the view. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_view_destroy_releases_the_batch_and_frees_the_view)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE payloads[3];
+    CONSTBUFFER_ARRAY_HANDLE batch = create_test_batch(payloads);
+    CONSTBUFFER_ARRAY_BATCHER_NV_VIEW_HANDLE view = create_test_view(batch);
+
+    STRICT_EXPECTED_CALL(constbuffer_array_dec_ref(batch));
+    STRICT_EXPECTED_CALL(free(view));
+
+    // act
+    constbuffer_array_batcher_nv_view_destroy(view);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    destroy_test_batch(batch, payloads);
+}
+
+/* constbuffer_array_batcher_nv_view_get_payload_count */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_049: [ If view is NULL then constbuffer_array_batcher_nv_view_get_payload_count shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_view_get_payload_count_with_NULL_view_fails)
+{
+    // arrange
+    uint32_t payload_count;
+
+    // act
+    int result = constbuffer_array_batcher_nv_view_get_payload_count(NULL, &payload_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_050: [ If payload_count is NULL then constbuffer_array_batcher_nv_view_get_payload_count shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_view_get_payload_count_with_NULL_payload_count_fails)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE payloads[3];
+    CONSTBUFFER_ARRAY_HANDLE batch = create_test_batch(payloads);
+    CONSTBUFFER_ARRAY_BATCHER_NV_VIEW_HANDLE view = create_test_view(batch);
+
+    // act
+    int result = constbuffer_array_batcher_nv_view_get_payload_count(view, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    constbuffer_array_batcher_nv_view_destroy(view);
+    destroy_test_batch(batch, payloads);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_051: [ constbuffer_array_batcher_nv_view_get_payload_count shall write in payload_count the number of payloads in the batch, succeed and return 0. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_view_get_payload_count_succeeds)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE payloads[3];
+    CONSTBUFFER_ARRAY_HANDLE batch = create_test_batch(payloads);
+    CONSTBUFFER_ARRAY_BATCHER_NV_VIEW_HANDLE view = create_test_view(batch);
+    uint32_t payload_count;
+
+    // act
+    int result = constbuffer_array_batcher_nv_view_get_payload_count(view, &payload_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 3, payload_count);
+
+    // cleanup
+    constbuffer_array_batcher_nv_view_destroy(view);
+    destroy_test_batch(batch, payloads);
+}
+
+/* constbuffer_array_batcher_nv_view_get_payload_buffer_count */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_052: [ If view is NULL then constbuffer_array_batcher_nv_view_get_payload_buffer_count shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_view_get_payload_buffer_count_with_NULL_view_fails)
+{
+    // arrange
+    uint32_t buffer_count;
+
+    // act
+    int result = constbuffer_array_batcher_nv_view_get_payload_buffer_count(NULL, 0, &buffer_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_053: [ If payload_index is not less than the number of payloads then constbuffer_array_batcher_nv_view_get_payload_buffer_count shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_view_get_payload_buffer_count_with_payload_index_out_of_range_fails)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE payloads[3];
+    CONSTBUFFER_ARRAY_HANDLE batch = create_test_batch(payloads);
+    CONSTBUFFER_ARRAY_BATCHER_NV_VIEW_HANDLE view = create_test_view(batch);
+    uint32_t buffer_count;
+
+    // act
+    int result = constbuffer_array_batcher_nv_view_get_payload_buffer_count(view, 3, &buffer_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    constbuffer_array_batcher_nv_view_destroy(view);
+    destroy_test_batch(batch, payloads);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_054: [ If buffer_count is NULL then constbuffer_array_batcher_nv_view_get_payload_buffer_count shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_view_get_payload_buffer_count_with_NULL_buffer_count_fails)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE payloads[3];
+    CONSTBUFFER_ARRAY_HANDLE batch = create_test_batch(payloads);
+    CONSTBUFFER_ARRAY_BATCHER_NV_VIEW_HANDLE view = create_test_view(batch);
+
+    // act
+    int result = constbuffer_array_batcher_nv_view_get_payload_buffer_count(view, 0, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    constbuffer_array_batcher_nv_view_destroy(view);
+    destroy_test_batch(batch, payloads);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_055: [ constbuffer_array_batcher_nv_view_get_payload_buffer_count shall write in buffer_count the number of buffers of the payload_index-th payload, succeed and return 0. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_view_get_payload_buffer_count_succeeds)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE payloads[3];
+    CONSTBUFFER_ARRAY_HANDLE batch = create_test_batch(payloads);
+    CONSTBUFFER_ARRAY_BATCHER_NV_VIEW_HANDLE view = create_test_view(batch);
+    uint32_t buffer_counts[3];
+
+    // act
+    int result_0 = constbuffer_array_batcher_nv_view_get_payload_buffer_count(view, 0, &buffer_counts[0]);
+    int result_1 = constbuffer_array_batcher_nv_view_get_payload_buffer_count(view, 1, &buffer_counts[1]);
+    int result_2 = constbuffer_array_batcher_nv_view_get_payload_buffer_count(view, 2, &buffer_counts[2]);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result_0);
+    ASSERT_ARE_EQUAL(int, 0, result_1);
+    ASSERT_ARE_EQUAL(int, 0, result_2);
+    ASSERT_ARE_EQUAL(uint32_t, 2, buffer_counts[0]);
+    ASSERT_ARE_EQUAL(uint32_t, 0, buffer_counts[1]);
+    ASSERT_ARE_EQUAL(uint32_t, 1, buffer_counts[2]);
+
+    // cleanup
+    constbuffer_array_batcher_nv_view_destroy(view);
+    destroy_test_batch(batch, payloads);
+}
+
+/* constbuffer_array_batcher_nv_view_get_payload_buffer_content */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_056: [ If view is NULL then constbuffer_array_batcher_nv_view_get_payload_buffer_content shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_view_get_payload_buffer_content_with_NULL_view_fails)
+{
+    // arrange
+
+    // act
+    const CONSTBUFFER* result = constbuffer_array_batcher_nv_view_get_payload_buffer_content(NULL, 0, 0);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(result);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_057: [ If payload_index is not less than the number of payloads then constbuffer_array_batcher_nv_view_get_payload_buffer_content shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_view_get_payload_buffer_content_with_payload_index_out_of_range_fails)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE payloads[3];
+    CONSTBUFFER_ARRAY_HANDLE batch = create_test_batch(payloads);
+    CONSTBUFFER_ARRAY_BATCHER_NV_VIEW_HANDLE view = create_test_view(batch);
+
+    // act
+    const CONSTBUFFER* result = constbuffer_array_batcher_nv_view_get_payload_buffer_content(view, 3, 0);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(result);
+
+    // cleanup
+    constbuffer_array_batcher_nv_view_destroy(view);
+    destroy_test_batch(batch, payloads);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_058: [ If buffer_index is not less than the number of buffers of the payload_index-th payload then constbuffer_array_batcher_nv_view_get_payload_buffer_content shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_view_get_payload_buffer_content_with_buffer_index_out_of_range_fails)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE payloads[3];
+    CONSTBUFFER_ARRAY_HANDLE batch = create_test_batch(payloads);
+    CONSTBUFFER_ARRAY_BATCHER_NV_VIEW_HANDLE view = create_test_view(batch);
+
+    // act
+    const CONSTBUFFER* result_0 = constbuffer_array_batcher_nv_view_get_payload_buffer_content(view, 0, 2);
+    const CONSTBUFFER* result_1 = constbuffer_array_batcher_nv_view_get_payload_buffer_content(view, 1, 0);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(result_0);
+    ASSERT_IS_NULL(result_1);
+
+    // cleanup
+    constbuffer_array_batcher_nv_view_destroy(view);
+    destroy_test_batch(batch, payloads);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_059: [ constbuffer_array_batcher_nv_view_get_payload_buffer_content shall return the content of the buffer_index-th buffer of the payload by calling constbuffer_array_get_buffer_content on the batch. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_view_get_payload_buffer_content_succeeds)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE payloads[3];
+    CONSTBUFFER_ARRAY_HANDLE batch = create_test_batch(payloads);
+    CONSTBUFFER_ARRAY_BATCHER_NV_VIEW_HANDLE view = create_test_view(batch);
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(batch, 2));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(batch, 3));
+
+    // act
+    const CONSTBUFFER* result_0 = constbuffer_array_batcher_nv_view_get_payload_buffer_content(view, 0, 1);
+    const CONSTBUFFER* result_2 = constbuffer_array_batcher_nv_view_get_payload_buffer_content(view, 2, 0);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, real_constbuffer_array_get_buffer_content(payloads[0], 1), result_0);
+    ASSERT_ARE_EQUAL(void_ptr, real_constbuffer_array_get_buffer_content(payloads[2], 0), result_2);
+
+    // cleanup
+    constbuffer_array_batcher_nv_view_destroy(view);
+    destroy_test_batch(batch, payloads);
+}
+
+/* constbuffer_array_batcher_nv_view_get_payload */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_060: [ If view is NULL then constbuffer_array_batcher_nv_view_get_payload shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_view_get_payload_with_NULL_view_fails)
+{
+    // arrange
+
+    // act
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_batcher_nv_view_get_payload(NULL, 0);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(result);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_061: [ If payload_index is not less than the number of payloads then constbuffer_array_batcher_nv_view_get_payload shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_view_get_payload_with_payload_index_out_of_range_fails)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE payloads[3];
+    CONSTBUFFER_ARRAY_HANDLE batch = create_test_batch(payloads);
+    CONSTBUFFER_ARRAY_BATCHER_NV_VIEW_HANDLE view = create_test_view(batch);
+
+    // act
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_batcher_nv_view_get_payload(view, 3);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(result);
+
+    // cleanup
+    constbuffer_array_batcher_nv_view_destroy(view);
+    destroy_test_batch(batch, payloads);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_062: [ constbuffer_array_batcher_nv_view_get_payload shall call constbuffer_array_create_from_buffer_index_and_count with the batch, the index of the first buffer of the payload and its number of buffers and return the result. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_view_get_payload_succeeds)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE payloads[3];
+    CONSTBUFFER_ARRAY_HANDLE batch = create_test_batch(payloads);
+    CONSTBUFFER_ARRAY_BATCHER_NV_VIEW_HANDLE view = create_test_view(batch);
+
+    STRICT_EXPECTED_CALL(constbuffer_array_create_from_buffer_index_and_count(batch, 1, 2));
+
+    // act
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_batcher_nv_view_get_payload(view, 0);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_IS_TRUE(real_CONSTBUFFER_ARRAY_HANDLE_contain_same(payloads[0], result));
+
+    // cleanup
+    real_constbuffer_array_dec_ref(result);
+    constbuffer_array_batcher_nv_view_destroy(view);
+    destroy_test_batch(batch, payloads);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_062: [ constbuffer_array_batcher_nv_view_get_payload shall call constbuffer_array_create_from_buffer_index_and_count with the batch, the index of the first buffer of the payload and its number of buffers and return the result. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_view_get_payload_with_0_buffers_succeeds)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE payloads[3];
+    CONSTBUFFER_ARRAY_HANDLE batch = create_test_batch(payloads);
+    CONSTBUFFER_ARRAY_BATCHER_NV_VIEW_HANDLE view = create_test_view(batch);
+    uint32_t buffer_count;
+
+    STRICT_EXPECTED_CALL(constbuffer_array_create_from_buffer_index_and_count(batch, 3, 0));
+
+    // act
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_batcher_nv_view_get_payload(view, 1);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(int, 0, real_constbuffer_array_get_buffer_count(result, &buffer_count));
+    ASSERT_ARE_EQUAL(uint32_t, 0, buffer_count);
+
+    // cleanup
+    real_constbuffer_array_dec_ref(result);
+    constbuffer_array_batcher_nv_view_destroy(view);
+    destroy_test_batch(batch, payloads);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_063: [ If there are any failures then constbuffer_array_batcher_nv_view_get_payload shall fail and return NULL. ]*/
+TEST_FUNCTION(when_constbuffer_array_create_from_buffer_index_and_count_fails_constbuffer_array_batcher_nv_view_get_payload_also_fails)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE payloads[3];
+    CONSTBUFFER_ARRAY_HANDLE batch = create_test_batch(payloads);
+    CONSTBUFFER_ARRAY_BATCHER_NV_VIEW_HANDLE view = create_test_view(batch);
+
+    STRICT_EXPECTED_CALL(constbuffer_array_create_from_buffer_index_and_count(batch, 3, 1))
+        .SetReturn(NULL);
+
+    // act
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_batcher_nv_view_get_payload(view, 2);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(result);
+
+    // cleanup
+    constbuffer_array_batcher_nv_view_destroy(view);
+    destroy_test_batch(batch, payloads);
+}
+
+/* constbuffer_array_batcher_nv_view_get_all_payloads */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_064: [ If view is NULL then constbuffer_array_batcher_nv_view_get_all_payloads shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_view_get_all_payloads_with_NULL_view_fails)
+{
+    // arrange
+    uint32_t payload_count;
+
+    // act
+    CONSTBUFFER_ARRAY_HANDLE* result = constbuffer_array_batcher_nv_view_get_all_payloads(NULL, &payload_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(result);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_065: [ If payload_count is NULL then constbuffer_array_batcher_nv_view_get_all_payloads shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_view_get_all_payloads_with_NULL_payload_count_fails)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE payloads[3];
+    CONSTBUFFER_ARRAY_HANDLE batch = create_test_batch(payloads);
+    CONSTBUFFER_ARRAY_BATCHER_NV_VIEW_HANDLE view = create_test_view(batch);
+
+    // act
+    CONSTBUFFER_ARRAY_HANDLE* result = constbuffer_array_batcher_nv_view_get_all_payloads(view, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(result);
+
+    // cleanup
+    constbuffer_array_batcher_nv_view_destroy(view);
+    destroy_test_batch(batch, payloads);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_066: [ constbuffer_array_batcher_nv_view_get_all_payloads shall allocate memory for the handles of all the payloads. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_067: [ constbuffer_array_batcher_nv_view_get_all_payloads shall create every payload by calling constbuffer_array_create_from_buffer_index_and_count with the batch, the index of the first buffer of the payload and its number of buffers. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_068: [ constbuffer_array_batcher_nv_view_get_all_payloads shall write in payload_count the number of payloads, succeed and return the handles. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_view_get_all_payloads_succeeds)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE payloads[3];
+    CONSTBUFFER_ARRAY_HANDLE batch = create_test_batch(payloads);
+    CONSTBUFFER_ARRAY_BATCHER_NV_VIEW_HANDLE view = create_test_view(batch);
+    uint32_t payload_count;
+
+    STRICT_EXPECTED_CALL(malloc_2(3, sizeof(CONSTBUFFER_ARRAY_HANDLE)));
+    STRICT_EXPECTED_CALL(constbuffer_array_create_from_buffer_index_and_count(batch, 1, 2));
+    STRICT_EXPECTED_CALL(constbuffer_array_create_from_buffer_index_and_count(batch, 3, 0));
+    STRICT_EXPECTED_CALL(constbuffer_array_create_from_buffer_index_and_count(batch, 3, 1));
+
+    // act
+    CONSTBUFFER_ARRAY_HANDLE* result = constbuffer_array_batcher_nv_view_get_all_payloads(view, &payload_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(uint32_t, 3, payload_count);
+    ASSERT_IS_TRUE(real_CONSTBUFFER_ARRAY_HANDLE_contain_same(payloads[0], result[0]));
+    ASSERT_IS_TRUE(real_CONSTBUFFER_ARRAY_HANDLE_contain_same(payloads[1], result[1]));
+    ASSERT_IS_TRUE(real_CONSTBUFFER_ARRAY_HANDLE_contain_same(payloads[2], result[2]));
+
+    // cleanup
+    for (uint32_t i = 0; i < payload_count; i++)
+    {
+        real_constbuffer_array_dec_ref(result[i]);
+    }
+    real_gballoc_hl_free(result);
+    constbuffer_array_batcher_nv_view_destroy(view);
+    destroy_test_batch(batch, payloads);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_068: [ constbuffer_array_batcher_nv_view_get_all_payloads shall write in payload_count the number of payloads, succeed and return the handles. ]*/
+TEST_FUNCTION(constbuffer_array_batcher_nv_view_get_all_payloads_returns_the_same_payloads_as_unbatch)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE payloads[3];
+    CONSTBUFFER_ARRAY_HANDLE batch = create_test_batch(payloads);
+    CONSTBUFFER_ARRAY_BATCHER_NV_VIEW_HANDLE view = create_test_view(batch);
+    uint32_t payload_count;
+    uint32_t unbatched_payload_count;
+    CONSTBUFFER_ARRAY_HANDLE* unbatched = constbuffer_array_batcher_nv_unbatch(batch, &unbatched_payload_count);
+    ASSERT_IS_NOT_NULL(unbatched);
+    umock_c_reset_all_calls();
+
+    // act
+    CONSTBUFFER_ARRAY_HANDLE* result = constbuffer_array_batcher_nv_view_get_all_payloads(view, &payload_count);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(uint32_t, unbatched_payload_count, payload_count);
+    for (uint32_t i = 0; i < payload_count; i++)
+    {
+        ASSERT_IS_TRUE(real_CONSTBUFFER_ARRAY_HANDLE_contain_same(unbatched[i], result[i]));
+    }
+
+    // cleanup
+    for (uint32_t i = 0; i < payload_count; i++)
+    {
+        real_constbuffer_array_dec_ref(result[i]);
+        real_constbuffer_array_dec_ref(unbatched[i]);
+    }
+    real_gballoc_hl_free(result);
+    real_gballoc_hl_free(unbatched);
+    constbuffer_array_batcher_nv_view_destroy(view);
+    destroy_test_batch(batch, payloads);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BATCHER_NV_12_069: [ If there are any failures then constbuffer_array_batcher_nv_view_get_all_payloads shall decrement the reference count of the payloads already created, free the memory and return NULL. ]*/
+TEST_FUNCTION(when_underlying_calls_fail_constbuffer_array_batcher_nv_view_get_all_payloads_also_fails)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE payloads[3];
+    CONSTBUFFER_ARRAY_HANDLE batch = create_test_batch(payloads);
+    CONSTBUFFER_ARRAY_BATCHER_NV_VIEW_HANDLE view = create_test_view(batch);
+    uint32_t payload_count;
+
+    STRICT_EXPECTED_CALL(malloc_2(3, sizeof(CONSTBUFFER_ARRAY_HANDLE)));
+    STRICT_EXPECTED_CALL(constbuffer_array_create_from_buffer_index_and_count(batch, 1, 2));
+    STRICT_EXPECTED_CALL(constbuffer_array_create_from_buffer_index_and_count(batch, 3, 0));
+    STRICT_EXPECTED_CALL(constbuffer_array_create_from_buffer_index_and_count(batch, 3, 1));
+
+    umock_c_negative_tests_snapshot();
+
+    for (size_t i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
+        if (umock_c_negative_tests_can_call_fail(i))
+        {
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(i);
+
+            // act
+            CONSTBUFFER_ARRAY_HANDLE* result = constbuffer_array_batcher_nv_view_get_all_payloads(view, &payload_count);
+
+            // assert
+            ASSERT_IS_NULL(result, "On failed call %zu", i);
+        }
+    }
+
+    // cleanup
+    constbuffer_array_batcher_nv_view_destroy(view);
+    destroy_test_batch(batch, payloads);
+}
+
 END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
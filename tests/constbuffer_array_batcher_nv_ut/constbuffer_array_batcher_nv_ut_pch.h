@@ -6,7 +6,9 @@
 #define CONSTBUFFER_ARRAY_BATCHER_NV_UT_PCH_H
 
 #include <stdlib.h>
+#include <stdbool.h>
 #include <inttypes.h>
+#include <string.h>
 
 #include "macro_utils/macro_utils.h"
 
@@ -0,0 +1,544 @@
+// Copyright (c) Microsoft. All rights reserved.
+
+#include "constbuffer_array_builder_ut_pch.h"
+
+MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    ASSERT_FAIL("umock_c reported error :%" PRI_MU_ENUM "", MU_ENUM_VALUE(UMOCK_C_ERROR_CODE, error_code));
+}
+
+static const unsigned char one[] = { '1' };
+static const unsigned char two[] = { '2', '2' };
+
+static CONSTBUFFER_ARRAY_BUILDER_HANDLE create_builder_with_buffers(uint32_t initial_capacity, CONSTBUFFER_HANDLE buffer_1, CONSTBUFFER_HANDLE buffer_2)
+{
+    CONSTBUFFER_ARRAY_BUILDER_HANDLE builder = constbuffer_array_builder_create(initial_capacity);
+    ASSERT_IS_NOT_NULL(builder);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_builder_append(builder, buffer_1));
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_builder_append(builder, buffer_2));
+    umock_c_reset_all_calls();
+    return builder;
+}
+
+BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    int result;
+
+    ASSERT_ARE_EQUAL(int, 0, real_gballoc_hl_init(NULL, NULL));
+
+    result = umock_c_init(on_umock_c_error);
+    ASSERT_ARE_EQUAL(int, 0, result, "umock_c_init failed");
+
+    result = umocktypes_stdint_register_types();
+    ASSERT_ARE_EQUAL(int, 0, result, "umocktypes_stdint_register_types failed");
+
+    REGISTER_GBALLOC_HL_GLOBAL_MOCK_HOOK();
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(malloc, NULL);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(malloc_2, NULL);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(realloc_2, NULL);
+
+    REGISTER_CONSTBUFFER_GLOBAL_MOCK_HOOK();
+    REGISTER_CONSTBUFFER_ARRAY_GLOBAL_MOCK_HOOK();
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(constbuffer_array_create_with_move_buffers, NULL);
+
+    REGISTER_UMOCK_ALIAS_TYPE(CONSTBUFFER_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(CONSTBUFFER_ARRAY_HANDLE, void*);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    umock_c_deinit();
+
+    real_gballoc_hl_deinit();
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    umock_c_reset_all_calls();
+    umock_c_negative_tests_init();
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    umock_c_negative_tests_deinit();
+}
+
+/* constbuffer_array_builder_create */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BUILDER_12_001: [ constbuffer_array_builder_create shall allocate memory for a new CONSTBUFFER_ARRAY_BUILDER_HANDLE. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_BUILDER_12_002: [ constbuffer_array_builder_create shall allocate memory for initial_capacity CONSTBUFFER_HANDLEs, or for CONSTBUFFER_ARRAY_BUILDER_DEFAULT_CAPACITY CONSTBUFFER_HANDLEs if initial_capacity is 0. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_BUILDER_12_003: [ constbuffer_array_builder_create shall succeed and return a non-NULL handle that holds no buffers. ]*/
+TEST_FUNCTION(constbuffer_array_builder_create_with_0_initial_capacity_succeeds)
+{
+    // arrange
+    uint32_t buffer_count;
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(malloc_2(CONSTBUFFER_ARRAY_BUILDER_DEFAULT_CAPACITY, sizeof(CONSTBUFFER_HANDLE)));
+
+    // act
+    CONSTBUFFER_ARRAY_BUILDER_HANDLE builder = constbuffer_array_builder_create(0);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(builder);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_builder_get_buffer_count(builder, &buffer_count));
+    ASSERT_ARE_EQUAL(uint32_t, 0, buffer_count);
+
+    // cleanup
+    constbuffer_array_builder_destroy(builder);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BUILDER_12_002: [ constbuffer_array_builder_create shall allocate memory for initial_capacity CONSTBUFFER_HANDLEs, or for CONSTBUFFER_ARRAY_BUILDER_DEFAULT_CAPACITY CONSTBUFFER_HANDLEs if initial_capacity is 0. ]*/
+TEST_FUNCTION(constbuffer_array_builder_create_with_initial_capacity_allocates_it)
+{
+    // arrange
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(malloc_2(5, sizeof(CONSTBUFFER_HANDLE)));
+
+    // act
+    CONSTBUFFER_ARRAY_BUILDER_HANDLE builder = constbuffer_array_builder_create(5);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(builder);
+
+    // cleanup
+    constbuffer_array_builder_destroy(builder);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BUILDER_12_004: [ If there are any failures then constbuffer_array_builder_create shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_builder_create_fails_when_underlying_functions_fail)
+{
+    // arrange
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(malloc_2(5, sizeof(CONSTBUFFER_HANDLE)));
+
+    umock_c_negative_tests_snapshot();
+
+    for (size_t i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
+        umock_c_negative_tests_reset();
+        umock_c_negative_tests_fail_call(i);
+
+        // act
+        CONSTBUFFER_ARRAY_BUILDER_HANDLE builder = constbuffer_array_builder_create(5);
+
+        // assert
+        ASSERT_IS_NULL(builder, "On failed call %zu", i);
+    }
+}
+
+/* constbuffer_array_builder_destroy */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BUILDER_12_005: [ If builder is NULL then constbuffer_array_builder_destroy shall return. ]*/
+TEST_FUNCTION(constbuffer_array_builder_destroy_with_NULL_builder_returns)
+{
+    // act
+    constbuffer_array_builder_destroy(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BUILDER_12_006: [ constbuffer_array_builder_destroy shall decrement the reference count of all the buffers held by builder and free all used resources. ]*/
+TEST_FUNCTION(constbuffer_array_builder_destroy_releases_the_buffers_and_frees_the_builder)
+{
+    // arrange
+    CONSTBUFFER_HANDLE buffer_1 = real_CONSTBUFFER_Create(one, sizeof(one));
+    CONSTBUFFER_HANDLE buffer_2 = real_CONSTBUFFER_Create(two, sizeof(two));
+    CONSTBUFFER_ARRAY_BUILDER_HANDLE builder = create_builder_with_buffers(0, buffer_1, buffer_2);
+
+    STRICT_EXPECTED_CALL(CONSTBUFFER_DecRef(buffer_1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_DecRef(buffer_2));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(builder));
+
+    // act
+    constbuffer_array_builder_destroy(builder);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    real_CONSTBUFFER_DecRef(buffer_1);
+    real_CONSTBUFFER_DecRef(buffer_2);
+}
+
+/* constbuffer_array_builder_append */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BUILDER_12_007: [ If builder is NULL then constbuffer_array_builder_append shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_builder_append_with_NULL_builder_fails)
+{
+    // arrange
+    CONSTBUFFER_HANDLE buffer_1 = real_CONSTBUFFER_Create(one, sizeof(one));
+    umock_c_reset_all_calls();
+
+    // act
+    int result = constbuffer_array_builder_append(NULL, buffer_1);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    real_CONSTBUFFER_DecRef(buffer_1);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BUILDER_12_008: [ If buffer is NULL then constbuffer_array_builder_append shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_builder_append_with_NULL_buffer_fails)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_BUILDER_HANDLE builder = constbuffer_array_builder_create(0);
+    ASSERT_IS_NOT_NULL(builder);
+    umock_c_reset_all_calls();
+
+    // act
+    int result = constbuffer_array_builder_append(builder, NULL);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    constbuffer_array_builder_destroy(builder);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BUILDER_12_012: [ constbuffer_array_builder_append shall increment the reference count of buffer, store it after the buffers already held by builder, succeed and return 0. ]*/
+TEST_FUNCTION(constbuffer_array_builder_append_takes_a_reference_on_the_buffer)
+{
+    // arrange
+    uint32_t buffer_count;
+    CONSTBUFFER_HANDLE buffer_1 = real_CONSTBUFFER_Create(one, sizeof(one));
+    CONSTBUFFER_ARRAY_BUILDER_HANDLE builder = constbuffer_array_builder_create(0);
+    ASSERT_IS_NOT_NULL(builder);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(buffer_1));
+
+    // act
+    int result = constbuffer_array_builder_append(builder, buffer_1);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_builder_get_buffer_count(builder, &buffer_count));
+    ASSERT_ARE_EQUAL(uint32_t, 1, buffer_count);
+
+    // cleanup
+    constbuffer_array_builder_destroy(builder);
+    real_CONSTBUFFER_DecRef(buffer_1);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BUILDER_12_010: [ If builder is full then constbuffer_array_builder_append and constbuffer_array_builder_append_move shall double its capacity (up to UINT32_MAX) by reallocating the array of CONSTBUFFER_HANDLEs. ]*/
+TEST_FUNCTION(constbuffer_array_builder_append_when_full_doubles_the_capacity)
+{
+    // arrange
+    uint32_t buffer_count;
+    CONSTBUFFER_HANDLE buffer_1 = real_CONSTBUFFER_Create(one, sizeof(one));
+    CONSTBUFFER_HANDLE buffer_2 = real_CONSTBUFFER_Create(two, sizeof(two));
+    CONSTBUFFER_ARRAY_BUILDER_HANDLE builder = constbuffer_array_builder_create(1);
+    ASSERT_IS_NOT_NULL(builder);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_builder_append(builder, buffer_1));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, 2, sizeof(CONSTBUFFER_HANDLE)));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(buffer_2));
+
+    // act
+    int result = constbuffer_array_builder_append(builder, buffer_2);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_builder_get_buffer_count(builder, &buffer_count));
+    ASSERT_ARE_EQUAL(uint32_t, 2, buffer_count);
+
+    // cleanup
+    constbuffer_array_builder_destroy(builder);
+    real_CONSTBUFFER_DecRef(buffer_1);
+    real_CONSTBUFFER_DecRef(buffer_2);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BUILDER_12_011: [ If there are any failures then constbuffer_array_builder_append and constbuffer_array_builder_append_move shall fail, leave builder unchanged and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_builder_append_when_realloc_2_fails_fails)
+{
+    // arrange
+    uint32_t buffer_count;
+    CONSTBUFFER_HANDLE buffer_1 = real_CONSTBUFFER_Create(one, sizeof(one));
+    CONSTBUFFER_HANDLE buffer_2 = real_CONSTBUFFER_Create(two, sizeof(two));
+    CONSTBUFFER_ARRAY_BUILDER_HANDLE builder = constbuffer_array_builder_create(1);
+    ASSERT_IS_NOT_NULL(builder);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_builder_append(builder, buffer_1));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, 2, sizeof(CONSTBUFFER_HANDLE)))
+        .SetReturn(NULL);
+
+    // act
+    int result = constbuffer_array_builder_append(builder, buffer_2);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_builder_get_buffer_count(builder, &buffer_count));
+    ASSERT_ARE_EQUAL(uint32_t, 1, buffer_count);
+
+    // cleanup
+    constbuffer_array_builder_destroy(builder);
+    real_CONSTBUFFER_DecRef(buffer_1);
+    real_CONSTBUFFER_DecRef(buffer_2);
+}
+
+/* constbuffer_array_builder_append_move */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BUILDER_12_013: [ If builder is NULL then constbuffer_array_builder_append_move shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_builder_append_move_with_NULL_builder_fails)
+{
+    // arrange
+    CONSTBUFFER_HANDLE buffer_1 = real_CONSTBUFFER_Create(one, sizeof(one));
+    umock_c_reset_all_calls();
+
+    // act
+    int result = constbuffer_array_builder_append_move(NULL, buffer_1);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    real_CONSTBUFFER_DecRef(buffer_1);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BUILDER_12_014: [ If buffer is NULL then constbuffer_array_builder_append_move shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_builder_append_move_with_NULL_buffer_fails)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_BUILDER_HANDLE builder = constbuffer_array_builder_create(0);
+    ASSERT_IS_NOT_NULL(builder);
+    umock_c_reset_all_calls();
+
+    // act
+    int result = constbuffer_array_builder_append_move(builder, NULL);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    constbuffer_array_builder_destroy(builder);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BUILDER_12_015: [ constbuffer_array_builder_append_move shall store buffer after the buffers already held by builder without incrementing its reference count (the reference of the caller is moved in builder), succeed and return 0. ]*/
+TEST_FUNCTION(constbuffer_array_builder_append_move_does_not_touch_the_reference_count)
+{
+    // arrange
+    uint32_t buffer_count;
+    CONSTBUFFER_HANDLE buffer_1 = real_CONSTBUFFER_Create(one, sizeof(one));
+    CONSTBUFFER_ARRAY_BUILDER_HANDLE builder = constbuffer_array_builder_create(0);
+    ASSERT_IS_NOT_NULL(builder);
+    umock_c_reset_all_calls();
+
+    // act
+    int result = constbuffer_array_builder_append_move(builder, buffer_1);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_builder_get_buffer_count(builder, &buffer_count));
+    ASSERT_ARE_EQUAL(uint32_t, 1, buffer_count);
+
+    // cleanup
+    constbuffer_array_builder_destroy(builder); /*releases the reference moved in*/
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BUILDER_12_010: [ If builder is full then constbuffer_array_builder_append and constbuffer_array_builder_append_move shall double its capacity (up to UINT32_MAX) by reallocating the array of CONSTBUFFER_HANDLEs. ]*/
+TEST_FUNCTION(constbuffer_array_builder_append_move_many_buffers_reallocates_log_n_times)
+{
+    // arrange
+    uint32_t buffer_count;
+    CONSTBUFFER_ARRAY_BUILDER_HANDLE builder = constbuffer_array_builder_create(1);
+    ASSERT_IS_NOT_NULL(builder);
+    umock_c_reset_all_calls();
+
+    /*1 -> 2 -> 4 -> ... -> 1024*/
+    for (uint32_t capacity = 2; capacity <= 1024; capacity *= 2)
+    {
+        STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, capacity, sizeof(CONSTBUFFER_HANDLE)));
+    }
+
+    // act
+    for (uint32_t i = 0; i < 1000; i++)
+    {
+        CONSTBUFFER_HANDLE buffer = real_CONSTBUFFER_Create(one, sizeof(one));
+        ASSERT_ARE_EQUAL(int, 0, constbuffer_array_builder_append_move(builder, buffer));
+    }
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_builder_get_buffer_count(builder, &buffer_count));
+    ASSERT_ARE_EQUAL(uint32_t, 1000, buffer_count);
+
+    // cleanup
+    constbuffer_array_builder_destroy(builder);
+}
+
+/* constbuffer_array_builder_get_buffer_count */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BUILDER_12_016: [ If builder is NULL then constbuffer_array_builder_get_buffer_count shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_builder_get_buffer_count_with_NULL_builder_fails)
+{
+    // arrange
+    uint32_t buffer_count;
+
+    // act
+    int result = constbuffer_array_builder_get_buffer_count(NULL, &buffer_count);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BUILDER_12_017: [ If buffer_count is NULL then constbuffer_array_builder_get_buffer_count shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_builder_get_buffer_count_with_NULL_buffer_count_fails)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_BUILDER_HANDLE builder = constbuffer_array_builder_create(0);
+    ASSERT_IS_NOT_NULL(builder);
+    umock_c_reset_all_calls();
+
+    // act
+    int result = constbuffer_array_builder_get_buffer_count(builder, NULL);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    constbuffer_array_builder_destroy(builder);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BUILDER_12_018: [ constbuffer_array_builder_get_buffer_count shall write in buffer_count the number of buffers held by builder, succeed and return 0. ]*/
+TEST_FUNCTION(constbuffer_array_builder_get_buffer_count_succeeds)
+{
+    // arrange
+    uint32_t buffer_count;
+    CONSTBUFFER_HANDLE buffer_1 = real_CONSTBUFFER_Create(one, sizeof(one));
+    CONSTBUFFER_HANDLE buffer_2 = real_CONSTBUFFER_Create(two, sizeof(two));
+    CONSTBUFFER_ARRAY_BUILDER_HANDLE builder = create_builder_with_buffers(0, buffer_1, buffer_2);
+
+    // act
+    int result = constbuffer_array_builder_get_buffer_count(builder, &buffer_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 2, buffer_count);
+
+    // cleanup
+    constbuffer_array_builder_destroy(builder);
+    real_CONSTBUFFER_DecRef(buffer_1);
+    real_CONSTBUFFER_DecRef(buffer_2);
+}
+
+/* constbuffer_array_builder_seal */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BUILDER_12_019: [ If builder is NULL then constbuffer_array_builder_seal shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_builder_seal_with_NULL_builder_fails)
+{
+    // act
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_builder_seal(NULL);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BUILDER_12_020: [ constbuffer_array_builder_seal shall call constbuffer_array_create_with_move_buffers with the array of CONSTBUFFER_HANDLEs of builder and the number of buffers it holds (the handles are not copied and their reference counts are not changed). ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_BUILDER_12_022: [ constbuffer_array_builder_seal shall free builder, succeed and return the CONSTBUFFER_ARRAY_HANDLE. ]*/
+TEST_FUNCTION(constbuffer_array_builder_seal_moves_the_buffers_in_a_CONSTBUFFER_ARRAY_HANDLE)
+{
+    // arrange
+    uint32_t buffer_count;
+    CONSTBUFFER_HANDLE buffer_1 = real_CONSTBUFFER_Create(one, sizeof(one));
+    CONSTBUFFER_HANDLE buffer_2 = real_CONSTBUFFER_Create(two, sizeof(two));
+    CONSTBUFFER_ARRAY_BUILDER_HANDLE builder = create_builder_with_buffers(0, buffer_1, buffer_2);
+
+    STRICT_EXPECTED_CALL(constbuffer_array_create_with_move_buffers(IGNORED_ARG, 2));
+    STRICT_EXPECTED_CALL(free(builder));
+
+    // act
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_builder_seal(builder);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, real_constbuffer_array_get_buffer_count(result, &buffer_count));
+    ASSERT_ARE_EQUAL(uint32_t, 2, buffer_count);
+    ASSERT_ARE_EQUAL(void_ptr, buffer_1, real_constbuffer_array_get_buffer(result, 0));
+    real_CONSTBUFFER_DecRef(buffer_1); /*the one taken by constbuffer_array_get_buffer*/
+    ASSERT_ARE_EQUAL(void_ptr, buffer_2, real_constbuffer_array_get_buffer(result, 1));
+    real_CONSTBUFFER_DecRef(buffer_2);
+
+    // cleanup
+    real_constbuffer_array_dec_ref(result);
+    real_CONSTBUFFER_DecRef(buffer_1);
+    real_CONSTBUFFER_DecRef(buffer_2);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BUILDER_12_020: [ constbuffer_array_builder_seal shall call constbuffer_array_create_with_move_buffers with the array of CONSTBUFFER_HANDLEs of builder and the number of buffers it holds (the handles are not copied and their reference counts are not changed). ]*/
+TEST_FUNCTION(constbuffer_array_builder_seal_with_no_buffers_produces_an_empty_array)
+{
+    // arrange
+    uint32_t buffer_count;
+    CONSTBUFFER_ARRAY_BUILDER_HANDLE builder = constbuffer_array_builder_create(0);
+    ASSERT_IS_NOT_NULL(builder);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(constbuffer_array_create_with_move_buffers(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(free(builder));
+
+    // act
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_builder_seal(builder);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, real_constbuffer_array_get_buffer_count(result, &buffer_count));
+    ASSERT_ARE_EQUAL(uint32_t, 0, buffer_count);
+
+    // cleanup
+    real_constbuffer_array_dec_ref(result);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_BUILDER_12_021: [ If there are any failures then constbuffer_array_builder_seal shall fail, leave builder unchanged and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_builder_seal_when_constbuffer_array_create_with_move_buffers_fails_leaves_the_builder_unchanged)
+{
+    // arrange
+    uint32_t buffer_count;
+    CONSTBUFFER_HANDLE buffer_1 = real_CONSTBUFFER_Create(one, sizeof(one));
+    CONSTBUFFER_HANDLE buffer_2 = real_CONSTBUFFER_Create(two, sizeof(two));
+    CONSTBUFFER_ARRAY_BUILDER_HANDLE builder = create_builder_with_buffers(0, buffer_1, buffer_2);
+
+    STRICT_EXPECTED_CALL(constbuffer_array_create_with_move_buffers(IGNORED_ARG, 2))
+        .SetReturn(NULL);
+
+    // act
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_builder_seal(builder);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_builder_get_buffer_count(builder, &buffer_count));
+    ASSERT_ARE_EQUAL(uint32_t, 2, buffer_count);
+
+    // cleanup
+    constbuffer_array_builder_destroy(builder);
+    real_CONSTBUFFER_DecRef(buffer_1);
+    real_CONSTBUFFER_DecRef(buffer_2);
+}
+
+END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
@@ -0,0 +1,588 @@
+// Copyright (c) Microsoft. All rights reserved.
+
+
+
+#include "constbuffer_array_coalesce_ut_pch.h"
+
+MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    ASSERT_FAIL("umock_c reported error :%" PRI_MU_ENUM "", MU_ENUM_VALUE(UMOCK_C_ERROR_CODE, error_code));
+}
+
+static CONSTBUFFER_HANDLE generate_test_buffer(uint32_t size, unsigned char data)
+{
+    CONSTBUFFER_HANDLE result;
+
+    if (size == 0)
+    {
+        result = real_CONSTBUFFER_Create(NULL, 0);
+    }
+    else
+    {
+        unsigned char* memory = real_gballoc_hl_malloc(size);
+        ASSERT_IS_NOT_NULL(memory);
+
+        (void)memset(memory, data, size);
+
+        result = real_CONSTBUFFER_CreateWithMoveMemory(memory, size);
+    }
+    ASSERT_IS_NOT_NULL(result);
+
+    return result;
+}
+
+// Creates CONSTBUFFER_ARRAY where the i-th buffer has sizes[i] bytes, all set to 'a' + i
+static CONSTBUFFER_ARRAY_HANDLE generate_test_buffer_array(const uint32_t* sizes, uint32_t buffer_count)
+{
+    CONSTBUFFER_HANDLE* buffers = real_gballoc_hl_malloc(sizeof(CONSTBUFFER_HANDLE) * buffer_count);
+    ASSERT_IS_NOT_NULL(buffers);
+
+    for (uint32_t i = 0; i < buffer_count; ++i)
+    {
+        buffers[i] = generate_test_buffer(sizes[i], (unsigned char)('a' + i));
+    }
+
+    CONSTBUFFER_ARRAY_HANDLE buffer_array = real_constbuffer_array_create(buffers, buffer_count);
+    ASSERT_IS_NOT_NULL(buffer_array);
+
+    // cleanup
+
+    for (uint32_t i = 0; i < buffer_count; ++i)
+    {
+        real_CONSTBUFFER_DecRef(buffers[i]);
+    }
+    real_gballoc_hl_free(buffers);
+
+    return buffer_array;
+}
+
+// Asserts result has expected_buffer_count buffers and the same bytes as original, in the same order
+static void assert_same_bytes(CONSTBUFFER_ARRAY_HANDLE original, CONSTBUFFER_ARRAY_HANDLE result, uint32_t expected_buffer_count)
+{
+    uint32_t buffer_count;
+    ASSERT_ARE_EQUAL(int, 0, real_constbuffer_array_get_buffer_count(result, &buffer_count));
+    ASSERT_ARE_EQUAL(uint32_t, expected_buffer_count, buffer_count);
+
+    uint32_t original_size;
+    uint32_t result_size;
+    ASSERT_ARE_EQUAL(int, 0, real_constbuffer_array_get_all_buffers_size(original, &original_size));
+    ASSERT_ARE_EQUAL(int, 0, real_constbuffer_array_get_all_buffers_size(result, &result_size));
+    ASSERT_ARE_EQUAL(uint32_t, original_size, result_size);
+
+    uint32_t original_index = 0;
+    uint32_t original_offset = 0;
+    for (uint32_t i = 0; i < buffer_count; ++i)
+    {
+        const CONSTBUFFER* content = real_constbuffer_array_get_buffer_content(result, i);
+        ASSERT_ARE_NOT_EQUAL(uint32_t, 0, content->size, "coalesced arrays have no empty buffers");
+
+        for (uint32_t j = 0; j < content->size; ++j)
+        {
+            const CONSTBUFFER* original_content = real_constbuffer_array_get_buffer_content(original, original_index);
+            while (original_offset == original_content->size)
+            {
+                original_index++;
+                original_offset = 0;
+                original_content = real_constbuffer_array_get_buffer_content(original, original_index);
+            }
+            ASSERT_ARE_EQUAL(uint8_t, original_content->buffer[original_offset], content->buffer[j], "byte %" PRIu32 " of buffer %" PRIu32 "", j, i);
+            original_offset++;
+        }
+    }
+}
+
+BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    ASSERT_ARE_EQUAL(int, 0, real_gballoc_hl_init(NULL, NULL));
+
+    ASSERT_ARE_EQUAL(int, 0, umock_c_init(on_umock_c_error), "umock_c_init");
+
+    ASSERT_ARE_EQUAL(int, 0, umocktypes_stdint_register_types(), "umocktypes_stdint_register_types");
+
+    REGISTER_GBALLOC_HL_GLOBAL_MOCK_HOOK();
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(malloc, NULL);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(malloc_2, NULL);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(malloc_flex, NULL);
+
+    REGISTER_CONSTBUFFER_GLOBAL_MOCK_HOOK();
+    REGISTER_CONSTBUFFER_ARRAY_GLOBAL_MOCK_HOOK();
+
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(CONSTBUFFER_CreateWritableHandle, NULL);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(constbuffer_array_create_with_move_buffers, NULL);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(constbuffer_array_create_empty, NULL);
+
+    REGISTER_UMOCK_ALIAS_TYPE(CONSTBUFFER_ARRAY_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(CONSTBUFFER_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(CONSTBUFFER_WRITABLE_HANDLE, void*);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    umock_c_deinit();
+
+    real_gballoc_hl_deinit();
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    umock_c_reset_all_calls();
+    int result = umock_c_negative_tests_init();
+    ASSERT_ARE_EQUAL(int, 0, result, "umock_c_negative_tests_init failed");
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    umock_c_negative_tests_deinit();
+}
+
+/* constbuffer_array_coalesce */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_COALESCE_12_001: [ If buffers is NULL then constbuffer_array_coalesce shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_coalesce_with_null_buffers_fails)
+{
+    /// act
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_coalesce(NULL, 100, 1000);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(result);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_COALESCE_12_002: [ If max_segment_size is 0 then constbuffer_array_coalesce shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_coalesce_with_0_max_segment_size_fails)
+{
+    /// arrange
+    uint32_t sizes[] = { 10, 10 };
+    CONSTBUFFER_ARRAY_HANDLE buffers = generate_test_buffer_array(sizes, MU_COUNT_ARRAY_ITEMS(sizes));
+
+    /// act
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_coalesce(buffers, 0, 0);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(result);
+
+    /// cleanup
+    real_constbuffer_array_dec_ref(buffers);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_COALESCE_12_003: [ If min_segment_size is greater than max_segment_size then constbuffer_array_coalesce shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_coalesce_with_min_segment_size_greater_than_max_segment_size_fails)
+{
+    /// arrange
+    uint32_t sizes[] = { 10, 10 };
+    CONSTBUFFER_ARRAY_HANDLE buffers = generate_test_buffer_array(sizes, MU_COUNT_ARRAY_ITEMS(sizes));
+
+    /// act
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_coalesce(buffers, 101, 100);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(result);
+
+    /// cleanup
+    real_constbuffer_array_dec_ref(buffers);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_COALESCE_12_004: [ constbuffer_array_coalesce shall call constbuffer_array_get_buffer_count. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_COALESCE_12_007: [ If the number of segments is the number of buffers (there is nothing to merge and no empty buffer) then constbuffer_array_coalesce shall call constbuffer_array_inc_ref and return buffers. ]*/
+TEST_FUNCTION(constbuffer_array_coalesce_with_empty_array_returns_the_same_array)
+{
+    /// arrange
+    CONSTBUFFER_ARRAY_HANDLE buffers = real_constbuffer_array_create_empty();
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(buffers, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_inc_ref(buffers));
+
+    /// act
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_coalesce(buffers, 100, 1000);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, buffers, result);
+
+    /// cleanup
+    real_constbuffer_array_dec_ref(result);
+    real_constbuffer_array_dec_ref(buffers);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_COALESCE_12_004: [ constbuffer_array_coalesce shall call constbuffer_array_get_buffer_count. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_COALESCE_12_005: [ constbuffer_array_coalesce shall group the buffers in segments by calling constbuffer_array_get_buffer_content for each buffer: a buffer of at least min_segment_size bytes is a segment on its own, a buffer smaller than min_segment_size starts a segment that also takes the following buffers smaller than min_segment_size as long as the segment does not exceed max_segment_size bytes. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_COALESCE_12_006: [ constbuffer_array_coalesce shall count the segments that are not empty. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_COALESCE_12_007: [ If the number of segments is the number of buffers (there is nothing to merge and no empty buffer) then constbuffer_array_coalesce shall call constbuffer_array_inc_ref and return buffers. ]*/
+TEST_FUNCTION(constbuffer_array_coalesce_with_only_large_buffers_returns_the_same_array)
+{
+    /// arrange
+    uint32_t sizes[] = { 100, 200, 300 };
+    CONSTBUFFER_ARRAY_HANDLE buffers = generate_test_buffer_array(sizes, MU_COUNT_ARRAY_ITEMS(sizes));
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(buffers, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 0));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 1));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 2));
+    STRICT_EXPECTED_CALL(constbuffer_array_inc_ref(buffers));
+
+    /// act
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_coalesce(buffers, 100, 1000);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, buffers, result);
+
+    /// cleanup
+    real_constbuffer_array_dec_ref(result);
+    real_constbuffer_array_dec_ref(buffers);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_COALESCE_12_005: [ constbuffer_array_coalesce shall group the buffers in segments by calling constbuffer_array_get_buffer_content for each buffer: a buffer of at least min_segment_size bytes is a segment on its own, a buffer smaller than min_segment_size starts a segment that also takes the following buffers smaller than min_segment_size as long as the segment does not exceed max_segment_size bytes. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_COALESCE_12_007: [ If the number of segments is the number of buffers (there is nothing to merge and no empty buffer) then constbuffer_array_coalesce shall call constbuffer_array_inc_ref and return buffers. ]*/
+TEST_FUNCTION(constbuffer_array_coalesce_with_small_buffers_between_large_buffers_returns_the_same_array)
+{
+    /// arrange
+    uint32_t sizes[] = { 10, 200, 10, 300, 10 };
+    CONSTBUFFER_ARRAY_HANDLE buffers = generate_test_buffer_array(sizes, MU_COUNT_ARRAY_ITEMS(sizes));
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(buffers, IGNORED_ARG));
+    for (uint32_t i = 0; i < MU_COUNT_ARRAY_ITEMS(sizes); i++)
+    {
+        STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, i));
+    }
+    STRICT_EXPECTED_CALL(constbuffer_array_inc_ref(buffers));
+
+    /// act
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_coalesce(buffers, 100, 1000);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, buffers, result);
+
+    /// cleanup
+    real_constbuffer_array_dec_ref(result);
+    real_constbuffer_array_dec_ref(buffers);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_COALESCE_12_015: [ If all the buffers are empty then constbuffer_array_coalesce shall call constbuffer_array_create_empty and return the result. ]*/
+TEST_FUNCTION(constbuffer_array_coalesce_with_all_empty_buffers_returns_an_empty_array)
+{
+    /// arrange
+    uint32_t sizes[] = { 0, 0, 0 };
+    CONSTBUFFER_ARRAY_HANDLE buffers = generate_test_buffer_array(sizes, MU_COUNT_ARRAY_ITEMS(sizes));
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(buffers, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 0));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 1));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 2));
+    STRICT_EXPECTED_CALL(constbuffer_array_create_empty());
+
+    /// act
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_coalesce(buffers, 100, 1000);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(result);
+    assert_same_bytes(buffers, result, 0);
+
+    /// cleanup
+    real_constbuffer_array_dec_ref(result);
+    real_constbuffer_array_dec_ref(buffers);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_COALESCE_12_014: [ If there are any failures then constbuffer_array_coalesce shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_coalesce_with_all_empty_buffers_fails_when_constbuffer_array_create_empty_fails)
+{
+    /// arrange
+    uint32_t sizes[] = { 0, 0 };
+    CONSTBUFFER_ARRAY_HANDLE buffers = generate_test_buffer_array(sizes, MU_COUNT_ARRAY_ITEMS(sizes));
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(buffers, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 0));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 1));
+    STRICT_EXPECTED_CALL(constbuffer_array_create_empty())
+        .SetReturn(NULL);
+
+    /// act
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_coalesce(buffers, 100, 1000);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(result);
+
+    /// cleanup
+    real_constbuffer_array_dec_ref(buffers);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_COALESCE_12_004: [ constbuffer_array_coalesce shall call constbuffer_array_get_buffer_count. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_COALESCE_12_005: [ constbuffer_array_coalesce shall group the buffers in segments by calling constbuffer_array_get_buffer_content for each buffer: a buffer of at least min_segment_size bytes is a segment on its own, a buffer smaller than min_segment_size starts a segment that also takes the following buffers smaller than min_segment_size as long as the segment does not exceed max_segment_size bytes. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_COALESCE_12_006: [ constbuffer_array_coalesce shall count the segments that are not empty. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_COALESCE_12_008: [ constbuffer_array_coalesce shall allocate an array of CONSTBUFFER_HANDLE for the segments. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_COALESCE_12_010: [ For a segment made of more than one buffer constbuffer_array_coalesce shall call CONSTBUFFER_CreateWritableHandle with the size of the segment, copy the content of the buffers of the segment (obtained with constbuffer_array_get_buffer_content) in it and call CONSTBUFFER_SealWritableHandle. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_COALESCE_12_012: [ constbuffer_array_coalesce shall call constbuffer_array_create_with_move_buffers with the array of segments. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_COALESCE_12_013: [ constbuffer_array_coalesce shall succeed and return the new array. ]*/
+TEST_FUNCTION(constbuffer_array_coalesce_with_3_small_buffers_merges_them)
+{
+    /// arrange
+    uint32_t sizes[] = { 10, 20, 30 };
+    CONSTBUFFER_ARRAY_HANDLE buffers = generate_test_buffer_array(sizes, MU_COUNT_ARRAY_ITEMS(sizes));
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(buffers, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 0));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 1));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 2));
+
+    STRICT_EXPECTED_CALL(malloc_2(1, sizeof(CONSTBUFFER_HANDLE)));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 0));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 1));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 2));
+
+    STRICT_EXPECTED_CALL(CONSTBUFFER_CreateWritableHandle(60));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetWritableBuffer(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 0));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 1));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_SealWritableHandle(IGNORED_ARG));
+
+    STRICT_EXPECTED_CALL(constbuffer_array_create_with_move_buffers(IGNORED_ARG, 1));
+
+    /// act
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_coalesce(buffers, 100, 1000);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(result);
+    assert_same_bytes(buffers, result, 1);
+
+    /// cleanup
+    real_constbuffer_array_dec_ref(result);
+    real_constbuffer_array_dec_ref(buffers);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_COALESCE_12_005: [ constbuffer_array_coalesce shall group the buffers in segments by calling constbuffer_array_get_buffer_content for each buffer: a buffer of at least min_segment_size bytes is a segment on its own, a buffer smaller than min_segment_size starts a segment that also takes the following buffers smaller than min_segment_size as long as the segment does not exceed max_segment_size bytes. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_COALESCE_12_009: [ For a segment made of a single buffer constbuffer_array_coalesce shall call constbuffer_array_get_buffer and use the buffer as-is (zero-copy). ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_COALESCE_12_010: [ For a segment made of more than one buffer constbuffer_array_coalesce shall call CONSTBUFFER_CreateWritableHandle with the size of the segment, copy the content of the buffers of the segment (obtained with constbuffer_array_get_buffer_content) in it and call CONSTBUFFER_SealWritableHandle. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_COALESCE_12_012: [ constbuffer_array_coalesce shall call constbuffer_array_create_with_move_buffers with the array of segments. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_COALESCE_12_013: [ constbuffer_array_coalesce shall succeed and return the new array. ]*/
+TEST_FUNCTION(constbuffer_array_coalesce_keeps_large_buffers_and_lone_small_buffers_zero_copy)
+{
+    /// arrange
+    // segments: [0, 1] merged (20 bytes), [2] as-is, [3] as-is
+    uint32_t sizes[] = { 10, 10, 200, 10 };
+    CONSTBUFFER_ARRAY_HANDLE buffers = generate_test_buffer_array(sizes, MU_COUNT_ARRAY_ITEMS(sizes));
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(buffers, IGNORED_ARG));
+    for (uint32_t i = 0; i < MU_COUNT_ARRAY_ITEMS(sizes); i++)
+    {
+        STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, i));
+    }
+
+    STRICT_EXPECTED_CALL(malloc_2(3, sizeof(CONSTBUFFER_HANDLE)));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 0));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 1));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_CreateWritableHandle(20));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetWritableBuffer(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 0));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_SealWritableHandle(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 3));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer(buffers, 2));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer(buffers, 3));
+
+    STRICT_EXPECTED_CALL(constbuffer_array_create_with_move_buffers(IGNORED_ARG, 3));
+
+    /// act
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_coalesce(buffers, 100, 1000);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(result);
+    assert_same_bytes(buffers, result, 3);
+    ASSERT_ARE_EQUAL(void_ptr, real_constbuffer_array_get_buffer_content(buffers, 2), real_constbuffer_array_get_buffer_content(result, 1));
+    ASSERT_ARE_EQUAL(void_ptr, real_constbuffer_array_get_buffer_content(buffers, 3), real_constbuffer_array_get_buffer_content(result, 2));
+
+    /// cleanup
+    real_constbuffer_array_dec_ref(result);
+    real_constbuffer_array_dec_ref(buffers);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_COALESCE_12_005: [ constbuffer_array_coalesce shall group the buffers in segments by calling constbuffer_array_get_buffer_content for each buffer: a buffer of at least min_segment_size bytes is a segment on its own, a buffer smaller than min_segment_size starts a segment that also takes the following buffers smaller than min_segment_size as long as the segment does not exceed max_segment_size bytes. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_COALESCE_12_010: [ For a segment made of more than one buffer constbuffer_array_coalesce shall call CONSTBUFFER_CreateWritableHandle with the size of the segment, copy the content of the buffers of the segment (obtained with constbuffer_array_get_buffer_content) in it and call CONSTBUFFER_SealWritableHandle. ]*/
+TEST_FUNCTION(constbuffer_array_coalesce_starts_a_new_segment_when_max_segment_size_would_be_exceeded)
+{
+    /// arrange
+    // segments: [0, 1] (exactly max_segment_size), [2, 3, 4]
+    uint32_t sizes[] = { 10, 10, 5, 5, 10 };
+    CONSTBUFFER_ARRAY_HANDLE buffers = generate_test_buffer_array(sizes, MU_COUNT_ARRAY_ITEMS(sizes));
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(buffers, IGNORED_ARG));
+    for (uint32_t i = 0; i < MU_COUNT_ARRAY_ITEMS(sizes); i++)
+    {
+        STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, i));
+    }
+
+    STRICT_EXPECTED_CALL(malloc_2(2, sizeof(CONSTBUFFER_HANDLE)));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 0));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 1));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_CreateWritableHandle(20));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetWritableBuffer(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 0));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_SealWritableHandle(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 3));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 4));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_CreateWritableHandle(20));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetWritableBuffer(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 2));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 3));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 4));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_SealWritableHandle(IGNORED_ARG));
+
+    STRICT_EXPECTED_CALL(constbuffer_array_create_with_move_buffers(IGNORED_ARG, 2));
+
+    /// act
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_coalesce(buffers, 20, 20);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(result);
+    assert_same_bytes(buffers, result, 2);
+
+    /// cleanup
+    real_constbuffer_array_dec_ref(result);
+    real_constbuffer_array_dec_ref(buffers);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_COALESCE_12_005: [ constbuffer_array_coalesce shall group the buffers in segments by calling constbuffer_array_get_buffer_content for each buffer: a buffer of at least min_segment_size bytes is a segment on its own, a buffer smaller than min_segment_size starts a segment that also takes the following buffers smaller than min_segment_size as long as the segment does not exceed max_segment_size bytes. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_COALESCE_12_006: [ constbuffer_array_coalesce shall count the segments that are not empty. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_COALESCE_12_011: [ Segments of 0 bytes shall be skipped. ]*/
+TEST_FUNCTION(constbuffer_array_coalesce_drops_empty_buffers_between_large_buffers)
+{
+    /// arrange
+    uint32_t sizes[] = { 200, 0, 0, 300 };
+    CONSTBUFFER_ARRAY_HANDLE buffers = generate_test_buffer_array(sizes, MU_COUNT_ARRAY_ITEMS(sizes));
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(buffers, IGNORED_ARG));
+    for (uint32_t i = 0; i < MU_COUNT_ARRAY_ITEMS(sizes); i++)
+    {
+        STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, i));
+    }
+
+    STRICT_EXPECTED_CALL(malloc_2(2, sizeof(CONSTBUFFER_HANDLE)));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 0));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 1));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer(buffers, 0));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 2));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 3));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer(buffers, 3));
+
+    STRICT_EXPECTED_CALL(constbuffer_array_create_with_move_buffers(IGNORED_ARG, 2));
+
+    /// act
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_coalesce(buffers, 100, 1000);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(result);
+    assert_same_bytes(buffers, result, 2);
+
+    /// cleanup
+    real_constbuffer_array_dec_ref(result);
+    real_constbuffer_array_dec_ref(buffers);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_COALESCE_12_009: [ For a segment made of a single buffer constbuffer_array_coalesce shall call constbuffer_array_get_buffer and use the buffer as-is (zero-copy). ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_COALESCE_12_010: [ For a segment made of more than one buffer constbuffer_array_coalesce shall call CONSTBUFFER_CreateWritableHandle with the size of the segment, copy the content of the buffers of the segment (obtained with constbuffer_array_get_buffer_content) in it and call CONSTBUFFER_SealWritableHandle. ]*/
+TEST_FUNCTION(constbuffer_array_coalesce_with_empty_buffers_in_a_run_merges_the_run)
+{
+    /// arrange
+    uint32_t sizes[] = { 0, 10, 0, 10, 0 };
+    CONSTBUFFER_ARRAY_HANDLE buffers = generate_test_buffer_array(sizes, MU_COUNT_ARRAY_ITEMS(sizes));
+
+    /// act
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_coalesce(buffers, 100, 1000);
+
+    /// assert
+    ASSERT_IS_NOT_NULL(result);
+    assert_same_bytes(buffers, result, 1);
+
+    /// cleanup
+    real_constbuffer_array_dec_ref(result);
+    real_constbuffer_array_dec_ref(buffers);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_COALESCE_12_014: [ If there are any failures then constbuffer_array_coalesce shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_coalesce_fails_when_underlying_functions_fail)
+{
+    /// arrange
+    // segments: [0, 1] merged, [2] as-is, [3, 4] merged
+    uint32_t sizes[] = { 10, 10, 200, 10, 10 };
+    CONSTBUFFER_ARRAY_HANDLE buffers = generate_test_buffer_array(sizes, MU_COUNT_ARRAY_ITEMS(sizes));
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(buffers, IGNORED_ARG))
+        .CallCannotFail();
+    for (uint32_t i = 0; i < MU_COUNT_ARRAY_ITEMS(sizes); i++)
+    {
+        STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, i))
+            .CallCannotFail();
+    }
+
+    STRICT_EXPECTED_CALL(malloc_2(3, sizeof(CONSTBUFFER_HANDLE)));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 0))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 1))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 2))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(CONSTBUFFER_CreateWritableHandle(20));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetWritableBuffer(IGNORED_ARG))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 0))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 1))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(CONSTBUFFER_SealWritableHandle(IGNORED_ARG))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 3))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer(buffers, 2))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 4))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(CONSTBUFFER_CreateWritableHandle(20));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetWritableBuffer(IGNORED_ARG))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 3))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 4))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(CONSTBUFFER_SealWritableHandle(IGNORED_ARG))
+        .CallCannotFail();
+
+    STRICT_EXPECTED_CALL(constbuffer_array_create_with_move_buffers(IGNORED_ARG, 3));
+
+    umock_c_negative_tests_snapshot();
+
+    for (size_t i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
+        if (umock_c_negative_tests_can_call_fail(i))
+        {
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(i);
+
+            /// act
+            CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_coalesce(buffers, 100, 1000);
+
+            /// assert
+            ASSERT_IS_NULL(result, "On failed call %zu", i);
+        }
+    }
+
+    /// cleanup
+    real_constbuffer_array_dec_ref(buffers);
+}
+
+END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
@@ -0,0 +1,144 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "macro_utils/macro_utils.h"
+#include "testrunnerswitcher.h"
+
+#include "c_logging/logger.h"
+
+#include "c_pal/gballoc_hl.h"
+#include "c_pal/gballoc_hl_redirect.h"
+#include "c_pal/timer.h"
+
+#include "c_util/constbuffer.h"
+#include "c_util/constbuffer_array.h"
+
+/*every measurement copies about this many bytes in total, whatever the size of the array*/
+#define BYTES_COPIED_PER_MEASUREMENT (1024ULL * 1024 * 1024)
+
+/*builds an array of segment_count buffers of segment_size bytes each*/
+static CONSTBUFFER_ARRAY_HANDLE create_test_array(uint32_t segment_count, uint32_t segment_size)
+{
+    CONSTBUFFER_HANDLE* buffers = malloc_2(segment_count, sizeof(CONSTBUFFER_HANDLE));
+    ASSERT_IS_NOT_NULL(buffers);
+    unsigned char* segment = malloc(segment_size);
+    ASSERT_IS_NOT_NULL(segment);
+
+    for (uint32_t i = 0; i < segment_count; i++)
+    {
+        (void)memset(segment, (int)(i & 0xFF), segment_size);
+        buffers[i] = CONSTBUFFER_Create(segment, segment_size);
+        ASSERT_IS_NOT_NULL(buffers[i]);
+    }
+
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_create_with_move_buffers(buffers, segment_count);
+    ASSERT_IS_NOT_NULL(result);
+    free(segment);
+    return result;
+}
+
+/*what callers used to write by hand*/
+static void naive_copy(CONSTBUFFER_ARRAY_HANDLE array, unsigned char* destination)
+{
+    uint32_t buffer_count;
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_buffer_count(array, &buffer_count));
+    for (uint32_t i = 0; i < buffer_count; i++)
+    {
+        const CONSTBUFFER* content = constbuffer_array_get_buffer_content(array, i);
+        (void)memcpy(destination, content->buffer, content->size);
+        destination += content->size;
+    }
+}
+
+/*logs the throughput of the naive loop, constbuffer_array_copy_to and constbuffer_array_flatten over an array of segment_count segments of segment_size bytes*/
+static void measure_copies(uint32_t segment_count, uint32_t segment_size)
+{
+    CONSTBUFFER_ARRAY_HANDLE array = create_test_array(segment_count, segment_size);
+    uint64_t total_size = (uint64_t)segment_count * segment_size;
+    uint64_t iteration_count = BYTES_COPIED_PER_MEASUREMENT / total_size;
+    unsigned char* destination = malloc((size_t)total_size);
+    ASSERT_IS_NOT_NULL(destination);
+
+    double start = timer_global_get_elapsed_ms();
+    for (uint64_t i = 0; i < iteration_count; i++)
+    {
+        naive_copy(array, destination);
+    }
+    double naive_ms = timer_global_get_elapsed_ms() - start;
+
+    start = timer_global_get_elapsed_ms();
+    for (uint64_t i = 0; i < iteration_count; i++)
+    {
+        ASSERT_ARE_EQUAL(int, 0, constbuffer_array_copy_to(array, 0, total_size, destination));
+    }
+    double copy_to_ms = timer_global_get_elapsed_ms() - start;
+
+    start = timer_global_get_elapsed_ms();
+    for (uint64_t i = 0; i < iteration_count; i++)
+    {
+        CONSTBUFFER_HANDLE flat = constbuffer_array_flatten(array);
+        ASSERT_IS_NOT_NULL(flat);
+        CONSTBUFFER_DecRef(flat);
+    }
+    double flatten_ms = timer_global_get_elapsed_ms() - start;
+
+    double megabytes = (double)(iteration_count * total_size) / (1024.0 * 1024.0);
+    LogInfo("%" PRIu64 " bytes in %" PRIu32 " segments: naive loop %.1f MB/s, copy_to %.1f MB/s (x%.2f), flatten %.1f MB/s (x%.2f)",
+        total_size, segment_count,
+        megabytes * 1000.0 / naive_ms,
+        megabytes * 1000.0 / copy_to_ms, naive_ms / copy_to_ms,
+        megabytes * 1000.0 / flatten_ms, naive_ms / flatten_ms);
+
+    /*the copies are actually right*/
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_copy_to(array, 0, total_size, destination));
+    for (uint32_t i = 0; i < segment_count; i++)
+    {
+        ASSERT_ARE_EQUAL(uint8_t, (uint8_t)(i & 0xFF), destination[(uint64_t)i * segment_size]);
+    }
+
+    free(destination);
+    constbuffer_array_dec_ref(array);
+}
+
+BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    ASSERT_ARE_EQUAL(int, 0, gballoc_hl_init(NULL, NULL));
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    gballoc_hl_deinit();
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+}
+
+TEST_FUNCTION(constbuffer_array_perf_copy_1KB_in_16_segments)
+{
+    measure_copies(16, 64);
+}
+
+TEST_FUNCTION(constbuffer_array_perf_copy_64KB_in_256_segments)
+{
+    measure_copies(256, 256);
+}
+
+TEST_FUNCTION(constbuffer_array_perf_copy_16MB_in_4096_segments)
+{
+    measure_copies(4096, 4096);
+}
+
+END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
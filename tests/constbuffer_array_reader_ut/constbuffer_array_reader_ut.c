@@ -0,0 +1,898 @@
+// Copyright (c) Microsoft. All rights reserved.
+
+#include "constbuffer_array_reader_ut_pch.h"
+
+MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    ASSERT_FAIL("umock_c reported error :%" PRI_MU_ENUM "", MU_ENUM_VALUE(UMOCK_C_ERROR_CODE, error_code));
+}
+
+/*the test array holds the bytes 0x01..0x20 in buffers of 3, 0, 1, 20 and 8 bytes*/
+static const unsigned char test_bytes[] =
+{
+    0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x10,
+    0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F, 0x20
+};
+static const uint32_t test_buffer_sizes[] = { 3, 0, 1, 20, 8 };
+
+static CONSTBUFFER_ARRAY_HANDLE create_array(const unsigned char* bytes, const uint32_t* buffer_sizes, uint32_t buffer_count)
+{
+    CONSTBUFFER_HANDLE buffers[8];
+    ASSERT_IS_TRUE(buffer_count <= MU_COUNT_ARRAY_ITEMS(buffers));
+    uint32_t offset = 0;
+    for (uint32_t i = 0; i < buffer_count; i++)
+    {
+        buffers[i] = real_CONSTBUFFER_Create(bytes + offset, buffer_sizes[i]);
+        ASSERT_IS_NOT_NULL(buffers[i]);
+        offset += buffer_sizes[i];
+    }
+    CONSTBUFFER_ARRAY_HANDLE result = real_constbuffer_array_create(buffers, buffer_count);
+    ASSERT_IS_NOT_NULL(result);
+    for (uint32_t i = 0; i < buffer_count; i++)
+    {
+        real_CONSTBUFFER_DecRef(buffers[i]);
+    }
+    return result;
+}
+
+static CONSTBUFFER_ARRAY_HANDLE create_test_array(void)
+{
+    return create_array(test_bytes, test_buffer_sizes, MU_COUNT_ARRAY_ITEMS(test_buffer_sizes));
+}
+
+/*creates a reader over array that already moved past the first position bytes*/
+static CONSTBUFFER_ARRAY_READER_HANDLE create_reader_at(CONSTBUFFER_ARRAY_HANDLE array, uint64_t position)
+{
+    CONSTBUFFER_ARRAY_READER_HANDLE reader = constbuffer_array_reader_create(array);
+    ASSERT_IS_NOT_NULL(reader);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_reader_skip(reader, position));
+    umock_c_reset_all_calls();
+    return reader;
+}
+
+static void assert_array_content(CONSTBUFFER_ARRAY_HANDLE array, const unsigned char* expected, uint32_t size)
+{
+    unsigned char content[sizeof(test_bytes)];
+    uint64_t all_buffers_size;
+    ASSERT_ARE_EQUAL(int, 0, real_constbuffer_array_get_all_buffers_size_64(array, &all_buffers_size));
+    ASSERT_ARE_EQUAL(uint64_t, size, all_buffers_size);
+    ASSERT_ARE_EQUAL(int, 0, real_constbuffer_array_copy_to(array, 0, size, content));
+    ASSERT_ARE_EQUAL(int, 0, memcmp(expected, content, size));
+}
+
+BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    int result;
+
+    ASSERT_ARE_EQUAL(int, 0, real_gballoc_hl_init(NULL, NULL));
+
+    result = umock_c_init(on_umock_c_error);
+    ASSERT_ARE_EQUAL(int, 0, result, "umock_c_init failed");
+
+    result = umocktypes_stdint_register_types();
+    ASSERT_ARE_EQUAL(int, 0, result, "umocktypes_stdint_register_types failed");
+
+    REGISTER_GBALLOC_HL_GLOBAL_MOCK_HOOK();
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(malloc, NULL);
+
+    REGISTER_CONSTBUFFER_GLOBAL_MOCK_HOOK();
+    REGISTER_CONSTBUFFER_ARRAY_GLOBAL_MOCK_HOOK();
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(constbuffer_array_get_all_buffers_size_64, MU_FAILURE);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(constbuffer_array_create_empty, NULL);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(constbuffer_array_create_from_buffer_offset_and_count, NULL);
+
+    REGISTER_UMOCK_ALIAS_TYPE(CONSTBUFFER_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(CONSTBUFFER_ARRAY_HANDLE, void*);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    umock_c_deinit();
+
+    real_gballoc_hl_deinit();
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    umock_c_reset_all_calls();
+    umock_c_negative_tests_init();
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    umock_c_negative_tests_deinit();
+}
+
+/* constbuffer_array_reader_create */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_READER_12_001: [ If array is NULL then constbuffer_array_reader_create shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_reader_create_with_NULL_array_fails)
+{
+    // act
+    CONSTBUFFER_ARRAY_READER_HANDLE reader = constbuffer_array_reader_create(NULL);
+
+    // assert
+    ASSERT_IS_NULL(reader);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_READER_12_002: [ constbuffer_array_reader_create shall get the total size of the buffers of array by calling constbuffer_array_get_all_buffers_size_64. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_READER_12_003: [ constbuffer_array_reader_create shall allocate memory for a new CONSTBUFFER_ARRAY_READER_HANDLE. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_READER_12_004: [ constbuffer_array_reader_create shall increment the reference count of array, position the reader at the first byte of array, succeed and return a non-NULL handle. ]*/
+TEST_FUNCTION(constbuffer_array_reader_create_succeeds)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE array = create_test_array();
+    uint64_t remaining;
+    uint8_t value;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size_64(array, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_inc_ref(array));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(array, 0));
+
+    // act
+    CONSTBUFFER_ARRAY_READER_HANDLE reader = constbuffer_array_reader_create(array);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(reader);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_reader_get_remaining(reader, &remaining));
+    ASSERT_ARE_EQUAL(uint64_t, sizeof(test_bytes), remaining);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_reader_read_uint8(reader, &value));
+    ASSERT_ARE_EQUAL(uint8_t, 0x01, value);
+
+    // cleanup
+    constbuffer_array_reader_destroy(reader);
+    real_constbuffer_array_dec_ref(array);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_READER_12_004: [ constbuffer_array_reader_create shall increment the reference count of array, position the reader at the first byte of array, succeed and return a non-NULL handle. ]*/
+TEST_FUNCTION(constbuffer_array_reader_create_skips_leading_empty_buffers)
+{
+    // arrange
+    static const unsigned char bytes[] = { 'a', 'b' };
+    static const uint32_t buffer_sizes[] = { 0, 0, 2 };
+    CONSTBUFFER_ARRAY_HANDLE array = create_array(bytes, buffer_sizes, MU_COUNT_ARRAY_ITEMS(buffer_sizes));
+    uint8_t value;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size_64(array, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_inc_ref(array));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(array, 0));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(array, 1));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(array, 2));
+
+    // act
+    CONSTBUFFER_ARRAY_READER_HANDLE reader = constbuffer_array_reader_create(array);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(reader);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_reader_read_uint8(reader, &value));
+    ASSERT_ARE_EQUAL(uint8_t, 'a', value);
+
+    // cleanup
+    constbuffer_array_reader_destroy(reader);
+    real_constbuffer_array_dec_ref(array);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_READER_12_004: [ constbuffer_array_reader_create shall increment the reference count of array, position the reader at the first byte of array, succeed and return a non-NULL handle. ]*/
+TEST_FUNCTION(constbuffer_array_reader_create_with_empty_array_succeeds)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE array = real_constbuffer_array_create_empty();
+    ASSERT_IS_NOT_NULL(array);
+    uint64_t remaining;
+    uint8_t value;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size_64(array, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_inc_ref(array));
+
+    // act
+    CONSTBUFFER_ARRAY_READER_HANDLE reader = constbuffer_array_reader_create(array);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(reader);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_reader_get_remaining(reader, &remaining));
+    ASSERT_ARE_EQUAL(uint64_t, 0, remaining);
+    ASSERT_ARE_NOT_EQUAL(int, 0, constbuffer_array_reader_read_uint8(reader, &value));
+
+    // cleanup
+    constbuffer_array_reader_destroy(reader);
+    real_constbuffer_array_dec_ref(array);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_READER_12_005: [ If there are any failures then constbuffer_array_reader_create shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_reader_create_fails_when_underlying_functions_fail)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE array = create_test_array();
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size_64(array, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_inc_ref(array));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(array, 0));
+
+    umock_c_negative_tests_snapshot();
+
+    for (size_t i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
+        if (umock_c_negative_tests_can_call_fail(i))
+        {
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(i);
+
+            // act
+            CONSTBUFFER_ARRAY_READER_HANDLE reader = constbuffer_array_reader_create(array);
+
+            // assert
+            ASSERT_IS_NULL(reader, "On failed call %zu", i);
+        }
+    }
+
+    // cleanup
+    real_constbuffer_array_dec_ref(array);
+}
+
+/* constbuffer_array_reader_destroy */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_READER_12_006: [ If reader is NULL then constbuffer_array_reader_destroy shall return. ]*/
+TEST_FUNCTION(constbuffer_array_reader_destroy_with_NULL_reader_returns)
+{
+    // act
+    constbuffer_array_reader_destroy(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_READER_12_007: [ constbuffer_array_reader_destroy shall decrement the reference count of the array and free all used resources. ]*/
+TEST_FUNCTION(constbuffer_array_reader_destroy_releases_the_array_and_frees_the_reader)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE array = create_test_array();
+    CONSTBUFFER_ARRAY_READER_HANDLE reader = create_reader_at(array, 0);
+
+    STRICT_EXPECTED_CALL(constbuffer_array_dec_ref(array));
+    STRICT_EXPECTED_CALL(free(reader));
+
+    // act
+    constbuffer_array_reader_destroy(reader);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    real_constbuffer_array_dec_ref(array);
+}
+
+/* constbuffer_array_reader_get_remaining */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_READER_12_008: [ If reader is NULL then constbuffer_array_reader_get_remaining shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_reader_get_remaining_with_NULL_reader_fails)
+{
+    // arrange
+    uint64_t remaining;
+
+    // act
+    int result = constbuffer_array_reader_get_remaining(NULL, &remaining);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_READER_12_009: [ If remaining is NULL then constbuffer_array_reader_get_remaining shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_reader_get_remaining_with_NULL_remaining_fails)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE array = create_test_array();
+    CONSTBUFFER_ARRAY_READER_HANDLE reader = create_reader_at(array, 0);
+
+    // act
+    int result = constbuffer_array_reader_get_remaining(reader, NULL);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    constbuffer_array_reader_destroy(reader);
+    real_constbuffer_array_dec_ref(array);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_READER_12_010: [ constbuffer_array_reader_get_remaining shall write in remaining the number of bytes that were not read yet, succeed and return 0. ]*/
+TEST_FUNCTION(constbuffer_array_reader_get_remaining_succeeds)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE array = create_test_array();
+    CONSTBUFFER_ARRAY_READER_HANDLE reader = create_reader_at(array, 5);
+    uint64_t remaining;
+
+    // act
+    int result = constbuffer_array_reader_get_remaining(reader, &remaining);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint64_t, sizeof(test_bytes) - 5, remaining);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    constbuffer_array_reader_destroy(reader);
+    real_constbuffer_array_dec_ref(array);
+}
+
+/* constbuffer_array_reader_read_uint8, constbuffer_array_reader_read_uint16, constbuffer_array_reader_read_uint32, constbuffer_array_reader_read_uint64, constbuffer_array_reader_read_uuid */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_READER_12_011: [ If reader is NULL then constbuffer_array_reader_read_uint8, constbuffer_array_reader_read_uint16, constbuffer_array_reader_read_uint32, constbuffer_array_reader_read_uint64 and constbuffer_array_reader_read_uuid shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_reader_read_functions_with_NULL_reader_fail)
+{
+    // arrange
+    uint8_t value_8;
+    uint16_t value_16;
+    uint32_t value_32;
+    uint64_t value_64;
+    UUID_T value_uuid;
+
+    // act
+    int result_8 = constbuffer_array_reader_read_uint8(NULL, &value_8);
+    int result_16 = constbuffer_array_reader_read_uint16(NULL, &value_16);
+    int result_32 = constbuffer_array_reader_read_uint32(NULL, &value_32);
+    int result_64 = constbuffer_array_reader_read_uint64(NULL, &value_64);
+    int result_uuid = constbuffer_array_reader_read_uuid(NULL, &value_uuid);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result_8);
+    ASSERT_ARE_NOT_EQUAL(int, 0, result_16);
+    ASSERT_ARE_NOT_EQUAL(int, 0, result_32);
+    ASSERT_ARE_NOT_EQUAL(int, 0, result_64);
+    ASSERT_ARE_NOT_EQUAL(int, 0, result_uuid);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_READER_12_012: [ If value is NULL then constbuffer_array_reader_read_uint8, constbuffer_array_reader_read_uint16, constbuffer_array_reader_read_uint32, constbuffer_array_reader_read_uint64 and constbuffer_array_reader_read_uuid shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_reader_read_functions_with_NULL_value_fail)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE array = create_test_array();
+    CONSTBUFFER_ARRAY_READER_HANDLE reader = create_reader_at(array, 0);
+    uint64_t remaining;
+
+    // act
+    int result_8 = constbuffer_array_reader_read_uint8(reader, NULL);
+    int result_16 = constbuffer_array_reader_read_uint16(reader, NULL);
+    int result_32 = constbuffer_array_reader_read_uint32(reader, NULL);
+    int result_64 = constbuffer_array_reader_read_uint64(reader, NULL);
+    int result_uuid = constbuffer_array_reader_read_uuid(reader, NULL);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result_8);
+    ASSERT_ARE_NOT_EQUAL(int, 0, result_16);
+    ASSERT_ARE_NOT_EQUAL(int, 0, result_32);
+    ASSERT_ARE_NOT_EQUAL(int, 0, result_64);
+    ASSERT_ARE_NOT_EQUAL(int, 0, result_uuid);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_reader_get_remaining(reader, &remaining));
+    ASSERT_ARE_EQUAL(uint64_t, sizeof(test_bytes), remaining);
+
+    // cleanup
+    constbuffer_array_reader_destroy(reader);
+    real_constbuffer_array_dec_ref(array);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_READER_12_013: [ If fewer bytes than the size of the value remain to be read then constbuffer_array_reader_read_uint8, constbuffer_array_reader_read_uint16, constbuffer_array_reader_read_uint32, constbuffer_array_reader_read_uint64 and constbuffer_array_reader_read_uuid shall fail, leave the reader unchanged and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_reader_read_functions_with_not_enough_bytes_fail)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE array = create_test_array();
+    CONSTBUFFER_ARRAY_READER_HANDLE reader = create_reader_at(array, sizeof(test_bytes) - 2);
+    uint16_t value_16;
+    uint32_t value_32;
+    uint64_t value_64;
+    UUID_T value_uuid;
+
+    // act
+    int result_32 = constbuffer_array_reader_read_uint32(reader, &value_32);
+    int result_64 = constbuffer_array_reader_read_uint64(reader, &value_64);
+    int result_uuid = constbuffer_array_reader_read_uuid(reader, &value_uuid);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result_32);
+    ASSERT_ARE_NOT_EQUAL(int, 0, result_64);
+    ASSERT_ARE_NOT_EQUAL(int, 0, result_uuid);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_reader_read_uint16(reader, &value_16));
+    ASSERT_ARE_EQUAL(uint16_t, 0x1F20, value_16);
+
+    // cleanup
+    constbuffer_array_reader_destroy(reader);
+    real_constbuffer_array_dec_ref(array);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_READER_12_013: [ If fewer bytes than the size of the value remain to be read then constbuffer_array_reader_read_uint8, constbuffer_array_reader_read_uint16, constbuffer_array_reader_read_uint32, constbuffer_array_reader_read_uint64 and constbuffer_array_reader_read_uuid shall fail, leave the reader unchanged and return a non-zero value. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_READER_12_016: [ constbuffer_array_reader_read_uint8, constbuffer_array_reader_read_uint16, constbuffer_array_reader_read_uint32, constbuffer_array_reader_read_uint64 and constbuffer_array_reader_read_uuid shall move the reader past the bytes of the value, succeed and return 0. ]*/
+TEST_FUNCTION(constbuffer_array_reader_read_uint8_reads_all_the_bytes_one_by_one)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE array = create_test_array();
+    CONSTBUFFER_ARRAY_READER_HANDLE reader = create_reader_at(array, 0);
+    uint8_t value;
+
+    // act
+    for (size_t i = 0; i < sizeof(test_bytes); i++)
+    {
+        ASSERT_ARE_EQUAL(int, 0, constbuffer_array_reader_read_uint8(reader, &value));
+        ASSERT_ARE_EQUAL(uint8_t, test_bytes[i], value, "byte %zu", i);
+    }
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, constbuffer_array_reader_read_uint8(reader, &value));
+
+    // cleanup
+    constbuffer_array_reader_destroy(reader);
+    real_constbuffer_array_dec_ref(array);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_READER_12_014: [ If all the bytes of the value are in the same buffer then constbuffer_array_reader_read_uint8, constbuffer_array_reader_read_uint16, constbuffer_array_reader_read_uint32, constbuffer_array_reader_read_uint64 and constbuffer_array_reader_read_uuid shall decode them from that buffer by calling read_uint8_t, read_uint16_t, read_uint32_t, read_uint64_t and read_uuid_t respectively. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_READER_12_016: [ constbuffer_array_reader_read_uint8, constbuffer_array_reader_read_uint16, constbuffer_array_reader_read_uint32, constbuffer_array_reader_read_uint64 and constbuffer_array_reader_read_uuid shall move the reader past the bytes of the value, succeed and return 0. ]*/
+TEST_FUNCTION(constbuffer_array_reader_read_functions_inside_one_buffer_succeed)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE array = create_test_array();
+    CONSTBUFFER_ARRAY_READER_HANDLE reader = create_reader_at(array, 4); /*the 20 bytes buffer*/
+    uint8_t value_8;
+    uint16_t value_16;
+    uint32_t value_32;
+    uint64_t value_64;
+    uint64_t remaining;
+
+    // act
+    int result_8 = constbuffer_array_reader_read_uint8(reader, &value_8);
+    int result_16 = constbuffer_array_reader_read_uint16(reader, &value_16);
+    int result_32 = constbuffer_array_reader_read_uint32(reader, &value_32);
+    int result_64 = constbuffer_array_reader_read_uint64(reader, &value_64);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result_8);
+    ASSERT_ARE_EQUAL(uint8_t, 0x05, value_8);
+    ASSERT_ARE_EQUAL(int, 0, result_16);
+    ASSERT_ARE_EQUAL(uint16_t, 0x0607, value_16);
+    ASSERT_ARE_EQUAL(int, 0, result_32);
+    ASSERT_ARE_EQUAL(uint32_t, 0x08090A0B, value_32);
+    ASSERT_ARE_EQUAL(int, 0, result_64);
+    ASSERT_ARE_EQUAL(uint64_t, 0x0C0D0E0F10111213, value_64);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_reader_get_remaining(reader, &remaining));
+    ASSERT_ARE_EQUAL(uint64_t, sizeof(test_bytes) - 4 - 15, remaining);
+
+    // cleanup
+    constbuffer_array_reader_destroy(reader);
+    real_constbuffer_array_dec_ref(array);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_READER_12_015: [ Otherwise constbuffer_array_reader_read_uint8, constbuffer_array_reader_read_uint16, constbuffer_array_reader_read_uint32, constbuffer_array_reader_read_uint64 and constbuffer_array_reader_read_uuid shall copy the bytes of the value from the buffers that hold them in a local buffer and decode them from there. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_READER_12_016: [ constbuffer_array_reader_read_uint8, constbuffer_array_reader_read_uint16, constbuffer_array_reader_read_uint32, constbuffer_array_reader_read_uint64 and constbuffer_array_reader_read_uuid shall move the reader past the bytes of the value, succeed and return 0. ]*/
+TEST_FUNCTION(constbuffer_array_reader_read_uint16_across_an_empty_buffer_succeeds)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE array = create_test_array();
+    CONSTBUFFER_ARRAY_READER_HANDLE reader = create_reader_at(array, 2);
+    uint16_t value;
+    uint8_t next;
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(array, 1));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(array, 2));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(array, 3));
+
+    // act
+    int result = constbuffer_array_reader_read_uint16(reader, &value);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint16_t, 0x0304, value);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_reader_read_uint8(reader, &next));
+    ASSERT_ARE_EQUAL(uint8_t, 0x05, next);
+
+    // cleanup
+    constbuffer_array_reader_destroy(reader);
+    real_constbuffer_array_dec_ref(array);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_READER_12_015: [ Otherwise constbuffer_array_reader_read_uint8, constbuffer_array_reader_read_uint16, constbuffer_array_reader_read_uint32, constbuffer_array_reader_read_uint64 and constbuffer_array_reader_read_uuid shall copy the bytes of the value from the buffers that hold them in a local buffer and decode them from there. ]*/
+TEST_FUNCTION(constbuffer_array_reader_read_uint32_across_buffers_succeeds)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE array = create_test_array();
+    CONSTBUFFER_ARRAY_READER_HANDLE reader = create_reader_at(array, 22);
+    uint32_t value;
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(array, 4));
+
+    // act
+    int result = constbuffer_array_reader_read_uint32(reader, &value);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 0x1718191A, value);
+
+    // cleanup
+    constbuffer_array_reader_destroy(reader);
+    real_constbuffer_array_dec_ref(array);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_READER_12_015: [ Otherwise constbuffer_array_reader_read_uint8, constbuffer_array_reader_read_uint16, constbuffer_array_reader_read_uint32, constbuffer_array_reader_read_uint64 and constbuffer_array_reader_read_uuid shall copy the bytes of the value from the buffers that hold them in a local buffer and decode them from there. ]*/
+TEST_FUNCTION(constbuffer_array_reader_read_uint64_across_4_buffers_succeeds)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE array = create_test_array();
+    CONSTBUFFER_ARRAY_READER_HANDLE reader = create_reader_at(array, 0);
+    uint64_t value;
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(array, 1));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(array, 2));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(array, 3));
+
+    // act
+    int result = constbuffer_array_reader_read_uint64(reader, &value);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint64_t, 0x0102030405060708, value);
+
+    // cleanup
+    constbuffer_array_reader_destroy(reader);
+    real_constbuffer_array_dec_ref(array);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_READER_12_015: [ Otherwise constbuffer_array_reader_read_uint8, constbuffer_array_reader_read_uint16, constbuffer_array_reader_read_uint32, constbuffer_array_reader_read_uint64 and constbuffer_array_reader_read_uuid shall copy the bytes of the value from the buffers that hold them in a local buffer and decode them from there. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_READER_12_016: [ constbuffer_array_reader_read_uint8, constbuffer_array_reader_read_uint16, constbuffer_array_reader_read_uint32, constbuffer_array_reader_read_uint64 and constbuffer_array_reader_read_uuid shall move the reader past the bytes of the value, succeed and return 0. ]*/
+TEST_FUNCTION(constbuffer_array_reader_read_uuid_across_buffers_up_to_the_end_succeeds)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE array = create_test_array();
+    CONSTBUFFER_ARRAY_READER_HANDLE reader = create_reader_at(array, sizeof(test_bytes) - sizeof(UUID_T));
+    UUID_T value;
+    uint64_t remaining;
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(array, 4));
+
+    // act
+    int result = constbuffer_array_reader_read_uuid(reader, &value);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(test_bytes + sizeof(test_bytes) - sizeof(UUID_T), value, sizeof(UUID_T)));
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_reader_get_remaining(reader, &remaining));
+    ASSERT_ARE_EQUAL(uint64_t, 0, remaining);
+
+    // cleanup
+    constbuffer_array_reader_destroy(reader);
+    real_constbuffer_array_dec_ref(array);
+}
+
+/* constbuffer_array_reader_skip */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_READER_12_017: [ If reader is NULL then constbuffer_array_reader_skip shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_reader_skip_with_NULL_reader_fails)
+{
+    // act
+    int result = constbuffer_array_reader_skip(NULL, 1);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_READER_12_018: [ If size is greater than the number of bytes that remain to be read then constbuffer_array_reader_skip shall fail, leave the reader unchanged and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_reader_skip_past_the_end_fails)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE array = create_test_array();
+    CONSTBUFFER_ARRAY_READER_HANDLE reader = create_reader_at(array, 1);
+    uint64_t remaining;
+
+    // act
+    int result = constbuffer_array_reader_skip(reader, sizeof(test_bytes));
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_reader_get_remaining(reader, &remaining));
+    ASSERT_ARE_EQUAL(uint64_t, sizeof(test_bytes) - 1, remaining);
+
+    // cleanup
+    constbuffer_array_reader_destroy(reader);
+    real_constbuffer_array_dec_ref(array);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_READER_12_019: [ constbuffer_array_reader_skip shall move the reader size bytes forward, succeed and return 0. ]*/
+TEST_FUNCTION(constbuffer_array_reader_skip_across_buffers_succeeds)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE array = create_test_array();
+    CONSTBUFFER_ARRAY_READER_HANDLE reader = create_reader_at(array, 1);
+    uint8_t value;
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(array, 1));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(array, 2));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(array, 3));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(array, 4));
+
+    // act
+    int result = constbuffer_array_reader_skip(reader, 23);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_reader_read_uint8(reader, &value));
+    ASSERT_ARE_EQUAL(uint8_t, 0x19, value);
+
+    // cleanup
+    constbuffer_array_reader_destroy(reader);
+    real_constbuffer_array_dec_ref(array);
+}
+
+/* constbuffer_array_reader_peek */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_READER_12_020: [ If reader is NULL then constbuffer_array_reader_peek shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_reader_peek_with_NULL_reader_fails)
+{
+    // arrange
+    unsigned char destination[4];
+
+    // act
+    int result = constbuffer_array_reader_peek(NULL, sizeof(destination), destination);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_READER_12_021: [ If destination is NULL then constbuffer_array_reader_peek shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_reader_peek_with_NULL_destination_fails)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE array = create_test_array();
+    CONSTBUFFER_ARRAY_READER_HANDLE reader = create_reader_at(array, 0);
+
+    // act
+    int result = constbuffer_array_reader_peek(reader, 4, NULL);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    constbuffer_array_reader_destroy(reader);
+    real_constbuffer_array_dec_ref(array);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_READER_12_022: [ If size is greater than the number of bytes that remain to be read then constbuffer_array_reader_peek shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_reader_peek_past_the_end_fails)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE array = create_test_array();
+    CONSTBUFFER_ARRAY_READER_HANDLE reader = create_reader_at(array, sizeof(test_bytes) - 3);
+    unsigned char destination[4];
+
+    // act
+    int result = constbuffer_array_reader_peek(reader, sizeof(destination), destination);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    constbuffer_array_reader_destroy(reader);
+    real_constbuffer_array_dec_ref(array);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_READER_12_023: [ constbuffer_array_reader_peek shall copy the next size bytes in destination without moving the reader, succeed and return 0. ]*/
+TEST_FUNCTION(constbuffer_array_reader_peek_across_buffers_does_not_move_the_reader)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE array = create_test_array();
+    CONSTBUFFER_ARRAY_READER_HANDLE reader = create_reader_at(array, 1);
+    unsigned char destination[6];
+    uint8_t value;
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(array, 1));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(array, 2));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(array, 3));
+
+    // act
+    int result = constbuffer_array_reader_peek(reader, sizeof(destination), destination);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(test_bytes + 1, destination, sizeof(destination)));
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_reader_read_uint8(reader, &value));
+    ASSERT_ARE_EQUAL(uint8_t, 0x02, value);
+
+    // cleanup
+    constbuffer_array_reader_destroy(reader);
+    real_constbuffer_array_dec_ref(array);
+}
+
+/* constbuffer_array_reader_read_array */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_READER_12_024: [ If reader is NULL then constbuffer_array_reader_read_array shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_reader_read_array_with_NULL_reader_fails)
+{
+    // act
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_reader_read_array(NULL, 1);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_READER_12_025: [ If size is greater than the number of bytes that remain to be read then constbuffer_array_reader_read_array shall fail, leave the reader unchanged and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_reader_read_array_past_the_end_fails)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE array = create_test_array();
+    CONSTBUFFER_ARRAY_READER_HANDLE reader = create_reader_at(array, 2);
+    uint64_t remaining;
+
+    // act
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_reader_read_array(reader, sizeof(test_bytes) - 1);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_reader_get_remaining(reader, &remaining));
+    ASSERT_ARE_EQUAL(uint64_t, sizeof(test_bytes) - 2, remaining);
+
+    // cleanup
+    constbuffer_array_reader_destroy(reader);
+    real_constbuffer_array_dec_ref(array);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_READER_12_026: [ If size is 0 then constbuffer_array_reader_read_array shall call constbuffer_array_create_empty and return its result. ]*/
+TEST_FUNCTION(constbuffer_array_reader_read_array_with_0_size_returns_an_empty_array)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE array = create_test_array();
+    CONSTBUFFER_ARRAY_READER_HANDLE reader = create_reader_at(array, 2);
+    uint32_t buffer_count;
+
+    STRICT_EXPECTED_CALL(constbuffer_array_create_empty());
+
+    // act
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_reader_read_array(reader, 0);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(int, 0, real_constbuffer_array_get_buffer_count(result, &buffer_count));
+    ASSERT_ARE_EQUAL(uint32_t, 0, buffer_count);
+
+    // cleanup
+    real_constbuffer_array_dec_ref(result);
+    constbuffer_array_reader_destroy(reader);
+    real_constbuffer_array_dec_ref(array);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_READER_12_027: [ Otherwise constbuffer_array_reader_read_array shall call constbuffer_array_create_from_buffer_offset_and_count with the index of the buffer that holds the next byte, the number of buffers that hold the next size bytes, the offset of the next byte in its buffer and the number of those bytes that are in the last of these buffers. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_READER_12_028: [ constbuffer_array_reader_read_array shall move the reader past the size bytes, succeed and return the new CONSTBUFFER_ARRAY_HANDLE. ]*/
+TEST_FUNCTION(constbuffer_array_reader_read_array_inside_one_buffer_succeeds)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE array = create_test_array();
+    CONSTBUFFER_ARRAY_READER_HANDLE reader = create_reader_at(array, 5);
+    uint8_t value;
+
+    STRICT_EXPECTED_CALL(constbuffer_array_create_from_buffer_offset_and_count(array, 3, 1, 1, 10));
+
+    // act
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_reader_read_array(reader, 10);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(result);
+    assert_array_content(result, test_bytes + 5, 10);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_reader_read_uint8(reader, &value));
+    ASSERT_ARE_EQUAL(uint8_t, 0x10, value);
+
+    // cleanup
+    real_constbuffer_array_dec_ref(result);
+    constbuffer_array_reader_destroy(reader);
+    real_constbuffer_array_dec_ref(array);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_READER_12_027: [ Otherwise constbuffer_array_reader_read_array shall call constbuffer_array_create_from_buffer_offset_and_count with the index of the buffer that holds the next byte, the number of buffers that hold the next size bytes, the offset of the next byte in its buffer and the number of those bytes that are in the last of these buffers. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_READER_12_028: [ constbuffer_array_reader_read_array shall move the reader past the size bytes, succeed and return the new CONSTBUFFER_ARRAY_HANDLE. ]*/
+TEST_FUNCTION(constbuffer_array_reader_read_array_across_buffers_succeeds)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE array = create_test_array();
+    CONSTBUFFER_ARRAY_READER_HANDLE reader = create_reader_at(array, 1);
+    uint8_t value;
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(array, 1));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(array, 2));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(array, 3));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(array, 4));
+    STRICT_EXPECTED_CALL(constbuffer_array_create_from_buffer_offset_and_count(array, 0, 5, 1, 2));
+
+    // act
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_reader_read_array(reader, 25);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(result);
+    assert_array_content(result, test_bytes + 1, 25);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_reader_read_uint8(reader, &value));
+    ASSERT_ARE_EQUAL(uint8_t, 0x1B, value);
+
+    // cleanup
+    real_constbuffer_array_dec_ref(result);
+    constbuffer_array_reader_destroy(reader);
+    real_constbuffer_array_dec_ref(array);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_READER_12_029: [ If there are any failures then constbuffer_array_reader_read_array shall fail, leave the reader unchanged and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_reader_read_array_fails_when_constbuffer_array_create_from_buffer_offset_and_count_fails)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE array = create_test_array();
+    CONSTBUFFER_ARRAY_READER_HANDLE reader = create_reader_at(array, 5);
+    uint64_t remaining;
+
+    STRICT_EXPECTED_CALL(constbuffer_array_create_from_buffer_offset_and_count(array, 3, 1, 1, 10))
+        .SetReturn(NULL);
+
+    // act
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_reader_read_array(reader, 10);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_reader_get_remaining(reader, &remaining));
+    ASSERT_ARE_EQUAL(uint64_t, sizeof(test_bytes) - 5, remaining);
+
+    // cleanup
+    constbuffer_array_reader_destroy(reader);
+    real_constbuffer_array_dec_ref(array);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_READER_12_029: [ If there are any failures then constbuffer_array_reader_read_array shall fail, leave the reader unchanged and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_reader_read_array_with_0_size_fails_when_constbuffer_array_create_empty_fails)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE array = create_test_array();
+    CONSTBUFFER_ARRAY_READER_HANDLE reader = create_reader_at(array, 5);
+
+    STRICT_EXPECTED_CALL(constbuffer_array_create_empty())
+        .SetReturn(NULL);
+
+    // act
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_reader_read_array(reader, 0);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(result);
+
+    // cleanup
+    constbuffer_array_reader_destroy(reader);
+    real_constbuffer_array_dec_ref(array);
+}
+
+END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
@@ -11,6 +11,8 @@ static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
     ASSERT_FAIL("umock_c reported error :%" PRI_MU_ENUM "", MU_ENUM_VALUE(UMOCK_C_ERROR_CODE, error_code));
 }
 
+TEST_DEFINE_ENUM_TYPE(CONSTBUFFER_ARRAY_SPLITTER_NEXT_RESULT, CONSTBUFFER_ARRAY_SPLITTER_NEXT_RESULT_VALUES)
+
 static CONSTBUFFER_HANDLE generate_test_buffer(uint32_t size, unsigned char data)
 {
     unsigned char* memory = real_gballoc_hl_malloc(size);
@@ -66,6 +68,76 @@ static CONSTBUFFER_ARRAY_HANDLE generate_test_buffer_array(uint32_t buffer_count
     return generate_test_buffer_array_increasing_size(buffer_count, buffer_size, 0);
 }
 
+static void assert_chunk_is(const CONSTBUFFER_ARRAY_SPLITTER_CHUNK* chunk, uint32_t start_buffer_index, uint32_t buffer_count, uint32_t start_buffer_offset, uint32_t end_buffer_size, uint32_t size)
+{
+    ASSERT_ARE_EQUAL(uint32_t, start_buffer_index, chunk->start_buffer_index);
+    ASSERT_ARE_EQUAL(uint32_t, buffer_count, chunk->buffer_count);
+    ASSERT_ARE_EQUAL(uint32_t, start_buffer_offset, chunk->start_buffer_offset);
+    ASSERT_ARE_EQUAL(uint32_t, end_buffer_size, chunk->end_buffer_size);
+    ASSERT_ARE_EQUAL(uint32_t, size, chunk->size);
+}
+
+// Fills bytes with a deterministic pseudo-random sequence (xorshift), content-defined chunking needs bytes that are not all the same
+static void generate_pseudo_random_bytes(unsigned char* bytes, uint32_t size, uint64_t seed)
+{
+    uint64_t x = seed;
+    for (uint32_t i = 0; i < size; ++i)
+    {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        bytes[i] = (unsigned char)x;
+    }
+}
+
+// Creates CONSTBUFFER_ARRAY holding a copy of bytes, cut in buffers of buffer_size bytes (the last one may be smaller)
+static CONSTBUFFER_ARRAY_HANDLE generate_test_buffer_array_from_bytes(const unsigned char* bytes, uint32_t size, uint32_t buffer_size)
+{
+    uint32_t buffer_count = (size + buffer_size - 1) / buffer_size;
+    CONSTBUFFER_HANDLE* buffers = real_gballoc_hl_malloc(sizeof(CONSTBUFFER_HANDLE) * buffer_count);
+    ASSERT_IS_NOT_NULL(buffers);
+
+    for (uint32_t i = 0; i < buffer_count; ++i)
+    {
+        uint32_t this_buffer_size = (i == buffer_count - 1) ? size - i * buffer_size : buffer_size;
+        buffers[i] = real_CONSTBUFFER_Create(bytes + i * buffer_size, this_buffer_size);
+        ASSERT_IS_NOT_NULL(buffers[i]);
+    }
+
+    CONSTBUFFER_ARRAY_HANDLE buffer_array = real_constbuffer_array_create(buffers, buffer_count);
+    ASSERT_IS_NOT_NULL(buffer_array);
+
+    // cleanup
+
+    for (uint32_t i = 0; i < buffer_count; ++i)
+    {
+        real_CONSTBUFFER_DecRef(buffers[i]);
+    }
+    real_gballoc_hl_free(buffers);
+
+    return buffer_array;
+}
+
+// Walks all the content-defined chunks of buffers, returns their number (at most max_chunk_count) and fills sizes and fingerprints
+static uint32_t get_all_cdc_chunks(CONSTBUFFER_ARRAY_HANDLE buffers, uint32_t min_chunk_size, uint32_t avg_chunk_size, uint32_t max_chunk_size, uint32_t* sizes, uint32_t* fingerprints, uint32_t max_chunk_count)
+{
+    CONSTBUFFER_ARRAY_SPLITTER_CDC_ITERATOR iterator;
+    CONSTBUFFER_ARRAY_SPLITTER_CHUNK chunk;
+    uint32_t fingerprint;
+    uint32_t chunk_count = 0;
+
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_splitter_cdc_iterator_init(&iterator, buffers, min_chunk_size, avg_chunk_size, max_chunk_size));
+    while (constbuffer_array_splitter_cdc_iterator_next(&iterator, &chunk, &fingerprint) == CONSTBUFFER_ARRAY_SPLITTER_NEXT_OK)
+    {
+        ASSERT_IS_TRUE(chunk_count < max_chunk_count);
+        sizes[chunk_count] = chunk.size;
+        fingerprints[chunk_count] = fingerprint;
+        chunk_count++;
+    }
+
+    return chunk_count;
+}
+
 BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
 
 TEST_SUITE_INITIALIZE(suite_init)
@@ -87,17 +159,22 @@ TEST_SUITE_INITIALIZE(suite_init)
     REGISTER_CONSTBUFFER_GLOBAL_MOCK_HOOK();
     REGISTER_CONSTBUFFER_ARRAY_GLOBAL_MOCK_HOOK();
     REGISTER_TARRAY_CONSTBUFFER_ARRAY_HANDLE_GLOBAL_MOCK_HOOK();
+    REGISTER_CRC32C_GLOBAL_MOCK_HOOK();
 
-    REGISTER_GLOBAL_MOCK_FAIL_RETURN(constbuffer_array_get_all_buffers_size, MU_FAILURE);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(constbuffer_array_get_all_buffers_size_64, MU_FAILURE);
     REGISTER_GLOBAL_MOCK_FAIL_RETURN(CONSTBUFFER_CreateWithMoveMemory, NULL);
     REGISTER_GLOBAL_MOCK_FAIL_RETURN(constbuffer_array_create, NULL);
     REGISTER_GLOBAL_MOCK_FAIL_RETURN(constbuffer_array_create_empty, NULL);
     REGISTER_GLOBAL_MOCK_FAIL_RETURN(TARRAY_CREATE(CONSTBUFFER_ARRAY_HANDLE), NULL);
     REGISTER_GLOBAL_MOCK_FAIL_RETURN(TARRAY_ENSURE_CAPACITY(CONSTBUFFER_ARRAY_HANDLE), MU_FAILURE);
     REGISTER_GLOBAL_MOCK_FAIL_RETURN(constbuffer_array_create_from_buffer_offset_and_count, NULL);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(constbuffer_array_create_with_move_buffers, NULL);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(CONSTBUFFER_CreateFromOffsetAndSize, NULL);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(CONSTBUFFER_CreateWritableHandle, NULL);
 
     REGISTER_UMOCK_ALIAS_TYPE(CONSTBUFFER_ARRAY_HANDLE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(CONSTBUFFER_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(CONSTBUFFER_WRITABLE_HANDLE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(TARRAY(CONSTBUFFER_ARRAY_HANDLE), void*);
 }
 
@@ -179,7 +256,7 @@ TEST_FUNCTION(constbuffer_array_splitter_split_with_empty_array_succeeds)
 }
 
 /*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_42_018: [ constbuffer_array_splitter_split shall call constbuffer_array_get_buffer_count. ]*/
-/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_42_004: [ constbuffer_array_splitter_split shall call constbuffer_array_get_all_buffers_size for buffers and store the result as remaining_buffer_size. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_42_004: [ constbuffer_array_splitter_split shall call constbuffer_array_get_all_buffers_size_64 for buffers and store the result as remaining_buffer_size. ]*/
 /*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_42_020: [ If the remaining_buffer_size is 0 (all buffers are empty) then constbuffer_array_splitter_split shall call constbuffer_array_create_empty and return the result. ]*/
 TEST_FUNCTION(constbuffer_array_splitter_split_with_all_empty_buffers_succeeds)
 {
@@ -187,7 +264,7 @@ TEST_FUNCTION(constbuffer_array_splitter_split_with_all_empty_buffers_succeeds)
     CONSTBUFFER_ARRAY_HANDLE buffers = generate_test_buffer_array(3, 0);
 
     STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(buffers, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size(buffers, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size_64(buffers, IGNORED_ARG));
 
     STRICT_EXPECTED_CALL(constbuffer_array_create_empty());
 
@@ -208,7 +285,7 @@ TEST_FUNCTION(constbuffer_array_splitter_split_with_all_empty_buffers_succeeds)
 }
 
 /*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_42_018: [ constbuffer_array_splitter_split shall call constbuffer_array_get_buffer_count. ]*/
-/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_42_004: [ constbuffer_array_splitter_split shall call constbuffer_array_get_all_buffers_size for buffers and store the result as remaining_buffer_size. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_42_004: [ constbuffer_array_splitter_split shall call constbuffer_array_get_all_buffers_size_64 for buffers and store the result as remaining_buffer_size. ]*/
 /*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_42_005: [ constbuffer_array_splitter_split shall allocate an array of CONSTBUFFER_HANDLE of size remaining_buffer_size / max_buffer_size (rounded up). ]*/
 /*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_42_006: [ constbuffer_array_splitter_split shall initialize the current buffer index to 0 and the current buffer offset to 0. ]*/
 /*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_42_007: [ constbuffer_array_splitter_split shall get the first buffer in buffers that is not empty. ]*/
@@ -227,7 +304,7 @@ TEST_FUNCTION(constbuffer_array_splitter_split_with_1_buffer_1_byte_succeeds)
     CONSTBUFFER_ARRAY_HANDLE buffers = generate_test_buffer_array(1, 1);
 
     STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(buffers, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size(buffers, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size_64(buffers, IGNORED_ARG));
 
     STRICT_EXPECTED_CALL(malloc_2(1, sizeof(CONSTBUFFER_HANDLE)));
     STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 0));
@@ -260,7 +337,7 @@ TEST_FUNCTION(constbuffer_array_splitter_split_with_1_buffer_1_byte_succeeds)
 }
 
 /*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_42_018: [ constbuffer_array_splitter_split shall call constbuffer_array_get_buffer_count. ]*/
-/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_42_004: [ constbuffer_array_splitter_split shall call constbuffer_array_get_all_buffers_size for buffers and store the result as remaining_buffer_size. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_42_004: [ constbuffer_array_splitter_split shall call constbuffer_array_get_all_buffers_size_64 for buffers and store the result as remaining_buffer_size. ]*/
 /*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_42_005: [ constbuffer_array_splitter_split shall allocate an array of CONSTBUFFER_HANDLE of size remaining_buffer_size / max_buffer_size (rounded up). ]*/
 /*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_42_006: [ constbuffer_array_splitter_split shall initialize the current buffer index to 0 and the current buffer offset to 0. ]*/
 /*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_42_007: [ constbuffer_array_splitter_split shall get the first buffer in buffers that is not empty. ]*/
@@ -279,7 +356,7 @@ TEST_FUNCTION(constbuffer_array_splitter_split_with_multiple_buffers_1_byte_each
     CONSTBUFFER_ARRAY_HANDLE buffers = generate_test_buffer_array(100, 1);
 
     STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(buffers, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size(buffers, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size_64(buffers, IGNORED_ARG));
 
     STRICT_EXPECTED_CALL(malloc_2(1, sizeof(CONSTBUFFER_HANDLE)));
     STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 0));
@@ -315,7 +392,7 @@ TEST_FUNCTION(constbuffer_array_splitter_split_with_multiple_buffers_1_byte_each
 }
 
 /*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_42_018: [ constbuffer_array_splitter_split shall call constbuffer_array_get_buffer_count. ]*/
-/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_42_004: [ constbuffer_array_splitter_split shall call constbuffer_array_get_all_buffers_size for buffers and store the result as remaining_buffer_size. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_42_004: [ constbuffer_array_splitter_split shall call constbuffer_array_get_all_buffers_size_64 for buffers and store the result as remaining_buffer_size. ]*/
 /*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_42_005: [ constbuffer_array_splitter_split shall allocate an array of CONSTBUFFER_HANDLE of size remaining_buffer_size / max_buffer_size (rounded up). ]*/
 /*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_42_006: [ constbuffer_array_splitter_split shall initialize the current buffer index to 0 and the current buffer offset to 0. ]*/
 /*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_42_007: [ constbuffer_array_splitter_split shall get the first buffer in buffers that is not empty. ]*/
@@ -334,7 +411,7 @@ TEST_FUNCTION(constbuffer_array_splitter_split_with_multiple_buffers_1000_bytes_
     CONSTBUFFER_ARRAY_HANDLE buffers = generate_test_buffer_array(10, 1000);
 
     STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(buffers, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size(buffers, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size_64(buffers, IGNORED_ARG));
 
     STRICT_EXPECTED_CALL(malloc_2(1, sizeof(CONSTBUFFER_HANDLE)));
 
@@ -370,7 +447,7 @@ TEST_FUNCTION(constbuffer_array_splitter_split_with_multiple_buffers_1000_bytes_
 }
 
 /*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_42_018: [ constbuffer_array_splitter_split shall call constbuffer_array_get_buffer_count. ]*/
-/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_42_004: [ constbuffer_array_splitter_split shall call constbuffer_array_get_all_buffers_size for buffers and store the result as remaining_buffer_size. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_42_004: [ constbuffer_array_splitter_split shall call constbuffer_array_get_all_buffers_size_64 for buffers and store the result as remaining_buffer_size. ]*/
 /*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_42_005: [ constbuffer_array_splitter_split shall allocate an array of CONSTBUFFER_HANDLE of size remaining_buffer_size / max_buffer_size (rounded up). ]*/
 /*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_42_006: [ constbuffer_array_splitter_split shall initialize the current buffer index to 0 and the current buffer offset to 0. ]*/
 /*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_42_007: [ constbuffer_array_splitter_split shall get the first buffer in buffers that is not empty. ]*/
@@ -391,7 +468,7 @@ TEST_FUNCTION(constbuffer_array_splitter_split_with_multiple_buffers_1000_bytes_
     CONSTBUFFER_ARRAY_HANDLE buffers = generate_test_buffer_array(10, 1000);
 
     STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(buffers, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size(buffers, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size_64(buffers, IGNORED_ARG));
 
     STRICT_EXPECTED_CALL(malloc_2(7, sizeof(CONSTBUFFER_HANDLE)));
 
@@ -482,7 +559,7 @@ TEST_FUNCTION(constbuffer_array_splitter_split_with_multiple_buffers_1000_bytes_
 }
 
 /*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_42_018: [ constbuffer_array_splitter_split shall call constbuffer_array_get_buffer_count. ]*/
-/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_42_004: [ constbuffer_array_splitter_split shall call constbuffer_array_get_all_buffers_size for buffers and store the result as remaining_buffer_size. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_42_004: [ constbuffer_array_splitter_split shall call constbuffer_array_get_all_buffers_size_64 for buffers and store the result as remaining_buffer_size. ]*/
 /*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_42_005: [ constbuffer_array_splitter_split shall allocate an array of CONSTBUFFER_HANDLE of size remaining_buffer_size / max_buffer_size (rounded up). ]*/
 /*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_42_006: [ constbuffer_array_splitter_split shall initialize the current buffer index to 0 and the current buffer offset to 0. ]*/
 /*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_42_007: [ constbuffer_array_splitter_split shall get the first buffer in buffers that is not empty. ]*/
@@ -505,7 +582,7 @@ TEST_FUNCTION(constbuffer_array_splitter_split_large_buffers_to_100MB_chunks_suc
     CONSTBUFFER_ARRAY_HANDLE buffers = generate_test_buffer_array_increasing_size(3, 201 * 1024 * 1024, 1024 * 1024);
 
     STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(buffers, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size(buffers, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size_64(buffers, IGNORED_ARG));
 
     STRICT_EXPECTED_CALL(malloc_2(7, sizeof(CONSTBUFFER_HANDLE)));
 
@@ -582,7 +659,7 @@ TEST_FUNCTION(constbuffer_array_splitter_split_large_buffers_to_100MB_chunks_suc
 }
 
 /*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_42_018: [ constbuffer_array_splitter_split shall call constbuffer_array_get_buffer_count. ]*/
-/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_42_004: [ constbuffer_array_splitter_split shall call constbuffer_array_get_all_buffers_size for buffers and store the result as remaining_buffer_size. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_42_004: [ constbuffer_array_splitter_split shall call constbuffer_array_get_all_buffers_size_64 for buffers and store the result as remaining_buffer_size. ]*/
 /*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_42_005: [ constbuffer_array_splitter_split shall allocate an array of CONSTBUFFER_HANDLE of size remaining_buffer_size / max_buffer_size (rounded up). ]*/
 /*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_42_006: [ constbuffer_array_splitter_split shall initialize the current buffer index to 0 and the current buffer offset to 0. ]*/
 /*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_42_007: [ constbuffer_array_splitter_split shall get the first buffer in buffers that is not empty. ]*/
@@ -612,7 +689,7 @@ TEST_FUNCTION(constbuffer_array_splitter_split_with_empty_buffers_at_start_succe
     real_constbuffer_array_dec_ref(empty);
 
     STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(buffers, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size(buffers, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size_64(buffers, IGNORED_ARG));
 
     STRICT_EXPECTED_CALL(malloc_2(7, sizeof(CONSTBUFFER_HANDLE)));
 
@@ -692,7 +769,7 @@ TEST_FUNCTION(constbuffer_array_splitter_split_with_empty_buffers_at_start_succe
 }
 
 /*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_42_018: [ constbuffer_array_splitter_split shall call constbuffer_array_get_buffer_count. ]*/
-/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_42_004: [ constbuffer_array_splitter_split shall call constbuffer_array_get_all_buffers_size for buffers and store the result as remaining_buffer_size. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_42_004: [ constbuffer_array_splitter_split shall call constbuffer_array_get_all_buffers_size_64 for buffers and store the result as remaining_buffer_size. ]*/
 /*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_42_005: [ constbuffer_array_splitter_split shall allocate an array of CONSTBUFFER_HANDLE of size remaining_buffer_size / max_buffer_size (rounded up). ]*/
 /*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_42_006: [ constbuffer_array_splitter_split shall initialize the current buffer index to 0 and the current buffer offset to 0. ]*/
 /*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_42_007: [ constbuffer_array_splitter_split shall get the first buffer in buffers that is not empty. ]*/
@@ -726,7 +803,7 @@ TEST_FUNCTION(constbuffer_array_splitter_split_with_empty_buffers_in_middle_succ
     real_constbuffer_array_dec_ref(buffers_temp2);
 
     STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(buffers, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size(buffers, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size_64(buffers, IGNORED_ARG));
 
     STRICT_EXPECTED_CALL(malloc_2(7, sizeof(CONSTBUFFER_HANDLE)));
 
@@ -817,7 +894,7 @@ TEST_FUNCTION(constbuffer_array_splitter_split_with_multiple_buffers_1000_bytes_
 
     STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(buffers, IGNORED_ARG))
         .CallCannotFail();
-    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size(buffers, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size_64(buffers, IGNORED_ARG));
 
     STRICT_EXPECTED_CALL(malloc_2(7, sizeof(CONSTBUFFER_HANDLE)));
 
@@ -948,7 +1025,7 @@ TEST_FUNCTION(constbuffer_array_splitter_split_with_all_empty_buffers_fails_if_u
 
     STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(buffers, IGNORED_ARG))
         .CallCannotFail();
-    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size(buffers, IGNORED_ARG))
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size_64(buffers, IGNORED_ARG))
         .CallCannotFail(); // technically this call can fail, but it is only due to overflow of the buffer sizes so not applicable to this case
 
     STRICT_EXPECTED_CALL(constbuffer_array_create_empty());
@@ -1026,7 +1103,7 @@ TEST_FUNCTION(constbuffer_array_splitter_split_to_array_of_array_with_null_split
 }
 
 /* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_005: [ constbuffer_array_splitter_split_to_array_of_array shall call constbuffer_array_get_buffer_count to get the total number of buffers. ]*/
-/* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_008: [ constbuffer_array_splitter_split_to_array_of_array shall call constbuffer_array_get_all_buffers_size for buffers to obtain the total size of all buffers in buffers. ]*/
+/* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_008: [ constbuffer_array_splitter_split_to_array_of_array shall call constbuffer_array_get_all_buffers_size_64 for buffers to obtain the total size of all buffers in buffers. ]*/
 /* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_007: [ constbuffer_array_splitter_split_to_array_of_array shall call constbuffer_array_create_empty and store the created const buffer array in the first entry of the TARRAY that was created. ]*/
 /* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_024: [ If the total size for all buffers in buffers is 0 or buffer_count is 0: ]*/
 /* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_021: [ constbuffer_array_splitter_split_to_array_of_array shall call TARRAY_CREATE_WITH_CAPACITY with size 1. ]*/
@@ -1038,7 +1115,7 @@ TEST_FUNCTION(constbuffer_array_splitter_split_to_array_of_array_with_empty_arra
     uint32_t split_buffer_arrays_count;
 
     STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(buffers, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size(buffers, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size_64(buffers, IGNORED_ARG));
     STRICT_EXPECTED_CALL(TARRAY_CREATE_WITH_CAPACITY(CONSTBUFFER_ARRAY_HANDLE)(1));
     STRICT_EXPECTED_CALL(constbuffer_array_create_empty());
     STRICT_EXPECTED_CALL(TARRAY_INITIALIZE_MOVE(CONSTBUFFER_ARRAY_HANDLE)(IGNORED_ARG, IGNORED_ARG));
@@ -1062,7 +1139,7 @@ TEST_FUNCTION(constbuffer_array_splitter_split_to_array_of_array_with_empty_arra
 }
 
 /* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_005: [ constbuffer_array_splitter_split_to_array_of_array shall call constbuffer_array_get_buffer_count to get the total number of buffers. ]*/
-/* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_008: [ constbuffer_array_splitter_split_to_array_of_array shall call constbuffer_array_get_all_buffers_size for buffers to obtain the total size of all buffers in buffers. ]*/
+/* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_008: [ constbuffer_array_splitter_split_to_array_of_array shall call constbuffer_array_get_all_buffers_size_64 for buffers to obtain the total size of all buffers in buffers. ]*/
 /* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_024: [ If the total size for all buffers in buffers is 0 or buffer_count is 0: ]*/
 /* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_021: [ constbuffer_array_splitter_split_to_array_of_array shall call TARRAY_CREATE_WITH_CAPACITY with size 1. ]*/
 /* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_007: [ constbuffer_array_splitter_split_to_array_of_array shall call constbuffer_array_create_empty and store the created const buffer array in the first entry of the TARRAY that was created. ]*/
@@ -1074,7 +1151,7 @@ TEST_FUNCTION(constbuffer_array_splitter_split_to_array_of_array_split_with_all_
     uint32_t split_buffer_arrays_count;
 
     STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(buffers, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size(buffers, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size_64(buffers, IGNORED_ARG));
     STRICT_EXPECTED_CALL(TARRAY_CREATE_WITH_CAPACITY(CONSTBUFFER_ARRAY_HANDLE)(1));
     STRICT_EXPECTED_CALL(constbuffer_array_create_empty());
     STRICT_EXPECTED_CALL(TARRAY_INITIALIZE_MOVE(CONSTBUFFER_ARRAY_HANDLE)(IGNORED_ARG, IGNORED_ARG));
@@ -1098,7 +1175,7 @@ TEST_FUNCTION(constbuffer_array_splitter_split_to_array_of_array_split_with_all_
 }
 
 /* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_005: [ constbuffer_array_splitter_split_to_array_of_array shall call constbuffer_array_get_buffer_count to get the total number of buffers. ]*/
-/* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_008: [ constbuffer_array_splitter_split_to_array_of_array shall call constbuffer_array_get_all_buffers_size for buffers to obtain the total size of all buffers in buffers. ]*/
+/* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_008: [ constbuffer_array_splitter_split_to_array_of_array shall call constbuffer_array_get_all_buffers_size_64 for buffers to obtain the total size of all buffers in buffers. ]*/
 /* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_022: [ If remaining_buffers_size is smaller or equal to max_buffer_size, constbuffer_array_splitter_split_to_array_of_array shall call TARRAY_CREATE_WITH_CAPACITY with size 1, inc ref the original buffer and return it. ]*/
 /* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_020: [ constbuffer_array_splitter_split_to_array_of_array shall succeed and return the new TARRAY(CONSTBUFFER_ARRAY_HANDLE) and write the count of used constbuffer array in split_buffer_arrays_count. ]*/
 TEST_FUNCTION(constbuffer_array_splitter_split_to_array_of_array_with_1_buffer_1_byte_succeeds)
@@ -1108,7 +1185,7 @@ TEST_FUNCTION(constbuffer_array_splitter_split_to_array_of_array_with_1_buffer_1
     uint32_t split_buffer_arrays_count;
 
     STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(buffers, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size(buffers, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size_64(buffers, IGNORED_ARG));
     STRICT_EXPECTED_CALL(TARRAY_CREATE_WITH_CAPACITY(CONSTBUFFER_ARRAY_HANDLE)(1));
     STRICT_EXPECTED_CALL(constbuffer_array_inc_ref(IGNORED_ARG));
     STRICT_EXPECTED_CALL(TARRAY_INITIALIZE_MOVE(CONSTBUFFER_ARRAY_HANDLE)(IGNORED_ARG, IGNORED_ARG));
@@ -1135,7 +1212,7 @@ TEST_FUNCTION(constbuffer_array_splitter_split_to_array_of_array_with_1_buffer_1
 }
 
 /* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_005: [ constbuffer_array_splitter_split_to_array_of_array shall call constbuffer_array_get_buffer_count to get the total number of buffers. ]*/
-/* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_008: [ constbuffer_array_splitter_split_to_array_of_array shall call constbuffer_array_get_all_buffers_size for buffers to obtain the total size of all buffers in buffers. ]*/
+/* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_008: [ constbuffer_array_splitter_split_to_array_of_array shall call constbuffer_array_get_all_buffers_size_64 for buffers to obtain the total size of all buffers in buffers. ]*/
 /* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_022: [ If remaining_buffers_size is smaller or equal to max_buffer_size, constbuffer_array_splitter_split_to_array_of_array shall call TARRAY_CREATE_WITH_CAPACITY with size 1, inc ref the original buffer and return it. ]*/
 /* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_020: [ constbuffer_array_splitter_split_to_array_of_array shall succeed and return the new TARRAY(CONSTBUFFER_ARRAY_HANDLE) and write the count of used constbuffer array in split_buffer_arrays_count. ]*/
 TEST_FUNCTION(constbuffer_array_splitter_split_to_array_of_array_with_multiple_buffers_1_byte_each_merge_succeeds)
@@ -1145,7 +1222,7 @@ TEST_FUNCTION(constbuffer_array_splitter_split_to_array_of_array_with_multiple_b
     uint32_t split_buffer_arrays_count;
 
     STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(buffers, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size(buffers, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size_64(buffers, IGNORED_ARG));
     STRICT_EXPECTED_CALL(TARRAY_CREATE_WITH_CAPACITY(CONSTBUFFER_ARRAY_HANDLE)(1));
     STRICT_EXPECTED_CALL(constbuffer_array_inc_ref(IGNORED_ARG));
     STRICT_EXPECTED_CALL(TARRAY_INITIALIZE_MOVE(CONSTBUFFER_ARRAY_HANDLE)(IGNORED_ARG, IGNORED_ARG));
@@ -1175,7 +1252,7 @@ TEST_FUNCTION(constbuffer_array_splitter_split_to_array_of_array_with_multiple_b
 }
 
 /* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_005: [ constbuffer_array_splitter_split_to_array_of_array shall call constbuffer_array_get_buffer_count to get the total number of buffers. ]*/
-/* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_008: [ constbuffer_array_splitter_split_to_array_of_array shall call constbuffer_array_get_all_buffers_size for buffers to obtain the total size of all buffers in buffers. ]*/
+/* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_008: [ constbuffer_array_splitter_split_to_array_of_array shall call constbuffer_array_get_all_buffers_size_64 for buffers to obtain the total size of all buffers in buffers. ]*/
 /* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_022: [ If remaining_buffers_size is smaller or equal to max_buffer_size, constbuffer_array_splitter_split_to_array_of_array shall call TARRAY_CREATE_WITH_CAPACITY with size 1, inc ref the original buffer and return it. ]*/
 /* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_020: [ constbuffer_array_splitter_split_to_array_of_array shall succeed and return the new TARRAY(CONSTBUFFER_ARRAY_HANDLE) and write the count of used constbuffer array in split_buffer_arrays_count. ]*/
 TEST_FUNCTION(constbuffer_array_splitter_split_to_array_of_array_with_multiple_buffers_1000_bytes_each_merge_succeeds)
@@ -1185,7 +1262,7 @@ TEST_FUNCTION(constbuffer_array_splitter_split_to_array_of_array_with_multiple_b
     uint32_t split_buffer_arrays_count;
 
     STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(buffers, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size(buffers, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size_64(buffers, IGNORED_ARG));
     STRICT_EXPECTED_CALL(TARRAY_CREATE_WITH_CAPACITY(CONSTBUFFER_ARRAY_HANDLE)(1));
     STRICT_EXPECTED_CALL(constbuffer_array_inc_ref(IGNORED_ARG));
     STRICT_EXPECTED_CALL(TARRAY_INITIALIZE_MOVE(CONSTBUFFER_ARRAY_HANDLE)(IGNORED_ARG, IGNORED_ARG));
@@ -1215,7 +1292,7 @@ TEST_FUNCTION(constbuffer_array_splitter_split_to_array_of_array_with_multiple_b
 }
 
 /* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_005: [ constbuffer_array_splitter_split_to_array_of_array shall call constbuffer_array_get_buffer_count to get the total number of buffers. ]*/
-/* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_008: [ constbuffer_array_splitter_split_to_array_of_array shall call constbuffer_array_get_all_buffers_size for buffers to obtain the total size of all buffers in buffers. ]*/
+/* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_008: [ constbuffer_array_splitter_split_to_array_of_array shall call constbuffer_array_get_all_buffers_size_64 for buffers to obtain the total size of all buffers in buffers. ]*/
 /* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_023: [ constbuffer_array_splitter_split_to_array_of_array shall allocate a TARRAY of CONSTBUFFER_HANDLE of size remaining_buffer_size / max_buffer_size (rounded up). ]*/
 /* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_010: [ constbuffer_array_splitter_split_to_array_of_array shall initialize the start buffer index and offset to 0, current buffer count to 0 and end buffer size to 0. ]*/
 /* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_011: [ constbuffer_array_splitter_split_to_array_of_array shall get the buffer currently checking for the size by calling constbuffer_array_get_buffer. ]*/
@@ -1233,7 +1310,7 @@ TEST_FUNCTION(constbuffer_array_splitter_split_to_array_of_array_with_multiple_b
     uint32_t split_buffer_arrays_count;
 
     STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(buffers, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size(buffers, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size_64(buffers, IGNORED_ARG));
     STRICT_EXPECTED_CALL(TARRAY_CREATE_WITH_CAPACITY(CONSTBUFFER_ARRAY_HANDLE)(7));
 
     for (uint32_t i = 0; i < 7; i += 3)
@@ -1307,7 +1384,7 @@ TEST_FUNCTION(constbuffer_array_splitter_split_to_array_of_array_with_multiple_b
 }
 
 /* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_005: [ constbuffer_array_splitter_split_to_array_of_array shall call constbuffer_array_get_buffer_count to get the total number of buffers. ]*/
-/* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_008: [ constbuffer_array_splitter_split_to_array_of_array shall call constbuffer_array_get_all_buffers_size for buffers to obtain the total size of all buffers in buffers. ]*/
+/* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_008: [ constbuffer_array_splitter_split_to_array_of_array shall call constbuffer_array_get_all_buffers_size_64 for buffers to obtain the total size of all buffers in buffers. ]*/
 /* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_023: [ constbuffer_array_splitter_split_to_array_of_array shall allocate a TARRAY of CONSTBUFFER_HANDLE of size remaining_buffer_size / max_buffer_size (rounded up). ]*/
 /* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_010: [ constbuffer_array_splitter_split_to_array_of_array shall initialize the start buffer index and offset to 0, current buffer count to 0 and end buffer size to 0. ]*/
 /* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_011: [ constbuffer_array_splitter_split_to_array_of_array shall get the buffer currently checking for the size by calling constbuffer_array_get_buffer. ]*/
@@ -1327,7 +1404,7 @@ TEST_FUNCTION(constbuffer_array_splitter_split_to_array_of_array_large_buffers_t
     uint32_t split_buffer_arrays_count;
 
     STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(buffers, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size(buffers, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size_64(buffers, IGNORED_ARG));
     STRICT_EXPECTED_CALL(TARRAY_CREATE_WITH_CAPACITY(CONSTBUFFER_ARRAY_HANDLE)(7));
 
     //first buffer
@@ -1408,7 +1485,7 @@ TEST_FUNCTION(constbuffer_array_splitter_split_to_array_of_array_large_buffers_t
 }
 
 /* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_005: [ constbuffer_array_splitter_split_to_array_of_array shall call constbuffer_array_get_buffer_count to get the total number of buffers. ]*/
-/* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_008: [ constbuffer_array_splitter_split_to_array_of_array shall call constbuffer_array_get_all_buffers_size for buffers to obtain the total size of all buffers in buffers. ]*/
+/* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_008: [ constbuffer_array_splitter_split_to_array_of_array shall call constbuffer_array_get_all_buffers_size_64 for buffers to obtain the total size of all buffers in buffers. ]*/
 /* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_023: [ constbuffer_array_splitter_split_to_array_of_array shall allocate a TARRAY of CONSTBUFFER_HANDLE of size remaining_buffer_size / max_buffer_size (rounded up). ]*/
 /* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_010: [ constbuffer_array_splitter_split_to_array_of_array shall initialize the start buffer index and offset to 0, current buffer count to 0 and end buffer size to 0. ]*/
 /* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_011: [ constbuffer_array_splitter_split_to_array_of_array shall get the buffer currently checking for the size by calling constbuffer_array_get_buffer. ]*/
@@ -1436,7 +1513,7 @@ TEST_FUNCTION(constbuffer_array_splitter_split_to_array_of_array_with_empty_buff
     real_constbuffer_array_dec_ref(empty);
 
     STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(buffers, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size(buffers, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size_64(buffers, IGNORED_ARG));
     STRICT_EXPECTED_CALL(TARRAY_CREATE_WITH_CAPACITY(CONSTBUFFER_ARRAY_HANDLE)(7));
 
     //first three empty buffers
@@ -1531,7 +1608,7 @@ TEST_FUNCTION(constbuffer_array_splitter_split_to_array_of_array_with_empty_buff
 }
 
 /* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_005: [ constbuffer_array_splitter_split_to_array_of_array shall call constbuffer_array_get_buffer_count to get the total number of buffers. ]*/
-/* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_008: [ constbuffer_array_splitter_split_to_array_of_array shall call constbuffer_array_get_all_buffers_size for buffers to obtain the total size of all buffers in buffers. ]*/
+/* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_008: [ constbuffer_array_splitter_split_to_array_of_array shall call constbuffer_array_get_all_buffers_size_64 for buffers to obtain the total size of all buffers in buffers. ]*/
 /* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_023: [ constbuffer_array_splitter_split_to_array_of_array shall allocate a TARRAY of CONSTBUFFER_HANDLE of size remaining_buffer_size / max_buffer_size (rounded up). ]*/
 /* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_010: [ constbuffer_array_splitter_split_to_array_of_array shall initialize the start buffer index and offset to 0, current buffer count to 0 and end buffer size to 0. ]*/
 /* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_011: [ constbuffer_array_splitter_split_to_array_of_array shall get the buffer currently checking for the size by calling constbuffer_array_get_buffer. ]*/
@@ -1563,7 +1640,7 @@ TEST_FUNCTION(constbuffer_array_splitter_split_to_array_of_array_with_empty_buff
     real_constbuffer_array_dec_ref(buffers_temp2);
 
     STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(buffers, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size(buffers, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size_64(buffers, IGNORED_ARG));
     STRICT_EXPECTED_CALL(TARRAY_CREATE_WITH_CAPACITY(CONSTBUFFER_ARRAY_HANDLE)(7));
 
     //get first 1000 in index 0
@@ -1693,7 +1770,7 @@ TEST_FUNCTION(constbuffer_array_splitter_split_to_array_of_array_with_empty_buff
 }
 
 /* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_005: [ constbuffer_array_splitter_split_to_array_of_array shall call constbuffer_array_get_buffer_count to get the total number of buffers. ]*/
-/* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_008: [ constbuffer_array_splitter_split_to_array_of_array shall call constbuffer_array_get_all_buffers_size for buffers to obtain the total size of all buffers in buffers. ]*/
+/* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_008: [ constbuffer_array_splitter_split_to_array_of_array shall call constbuffer_array_get_all_buffers_size_64 for buffers to obtain the total size of all buffers in buffers. ]*/
 /* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_023: [ constbuffer_array_splitter_split_to_array_of_array shall allocate a TARRAY of CONSTBUFFER_HANDLE of size remaining_buffer_size / max_buffer_size (rounded up). ]*/
 /* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_010: [ constbuffer_array_splitter_split_to_array_of_array shall initialize the start buffer index and offset to 0, current buffer count to 0 and end buffer size to 0. ]*/
 /* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_011: [ constbuffer_array_splitter_split_to_array_of_array shall get the buffer currently checking for the size by calling constbuffer_array_get_buffer. ]*/
@@ -1726,7 +1803,7 @@ TEST_FUNCTION(constbuffer_array_splitter_split_to_array_of_array_with_empty_buff
     real_constbuffer_array_dec_ref(buffers_temp2);
 
     STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(buffers, IGNORED_ARG));
-    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size(buffers, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size_64(buffers, IGNORED_ARG));
     STRICT_EXPECTED_CALL(TARRAY_CREATE_WITH_CAPACITY(CONSTBUFFER_ARRAY_HANDLE)(6));
 
     //get first 1000 in index 0
@@ -1834,6 +1911,61 @@ TEST_FUNCTION(constbuffer_array_splitter_split_to_array_of_array_with_empty_buff
     TARRAY_ASSIGN(CONSTBUFFER_ARRAY_HANDLE)(&result, NULL);
 }
 
+/* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_016: [ If current buffer size added the current sub-tarray size is smaller than max_buffer_size, constbuffer_array_splitter_split_to_array_of_array shall include the current buffer to the current sub-tarray. ]*/
+/* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_018: [ If current buffer size added the current sub-tarray size is greater than max_buffer_size, then constbuffer_array_splitter_split_to_array_of_array shall get part of the current buffer as end buffer and added a new array into the result until the remaining size for the current buffer is smaller than max_buffer_size. ]*/
+/* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_014: [ If current buffer is the last buffer in the original constbuffer_array, constbuffer_array_splitter_split_to_array_of_array shall store the sub-tarray with size smaller than max_buffer_size to result. ]*/
+TEST_FUNCTION(constbuffer_array_splitter_split_to_array_of_array_with_2_buffers_of_3GB_does_not_overflow_the_sub_tarray_size)
+{
+    /// arrange
+    // 2 x 3GB (the sizes are mocked), split at UINT32_MAX
+    // 3GB + 3GB does not fit in 32 bits (it would be 2GB and both buffers would go in the first array)
+    CONSTBUFFER_ARRAY_HANDLE buffers = generate_test_buffer_array(2, 1);
+    uint64_t all_buffers_size = 2 * (uint64_t)0xC0000000;
+    CONSTBUFFER huge_content = { NULL, 0xC0000000 };
+    CONSTBUFFER_ARRAY_HANDLE first = real_constbuffer_array_create_empty();
+    CONSTBUFFER_ARRAY_HANDLE second = real_constbuffer_array_create_empty();
+    uint32_t split_buffer_arrays_count;
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(buffers, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size_64(buffers, IGNORED_ARG))
+        .CopyOutArgumentBuffer_all_buffers_size(&all_buffers_size, sizeof(all_buffers_size));
+    STRICT_EXPECTED_CALL(TARRAY_CREATE_WITH_CAPACITY(CONSTBUFFER_ARRAY_HANDLE)(2));
+
+    //3GB, fits
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer(buffers, 0));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(IGNORED_ARG))
+        .SetReturn(&huge_content);
+    STRICT_EXPECTED_CALL(CONSTBUFFER_DecRef(IGNORED_ARG));
+
+    //6GB, the first array ends 1GB - 1 bytes in the second buffer
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer(buffers, 1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(IGNORED_ARG))
+        .SetReturn(&huge_content);
+    STRICT_EXPECTED_CALL(constbuffer_array_create_from_buffer_offset_and_count(buffers, 0, 2, 0, 0x3FFFFFFF))
+        .SetReturn(first);
+    STRICT_EXPECTED_CALL(constbuffer_array_create_from_buffer_offset_and_count(buffers, 1, 1, 0x3FFFFFFF, 0x80000001))
+        .SetReturn(second);
+    STRICT_EXPECTED_CALL(CONSTBUFFER_DecRef(IGNORED_ARG));
+
+    STRICT_EXPECTED_CALL(TARRAY_INITIALIZE_MOVE(CONSTBUFFER_ARRAY_HANDLE)(IGNORED_ARG, IGNORED_ARG));
+
+    /// act
+    TARRAY(CONSTBUFFER_ARRAY_HANDLE) result = constbuffer_array_splitter_split_to_array_of_array(buffers, UINT32_MAX, &split_buffer_arrays_count);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(uint32_t, 2, split_buffer_arrays_count);
+    ASSERT_ARE_EQUAL(void_ptr, first, result->arr[0]);
+    ASSERT_ARE_EQUAL(void_ptr, second, result->arr[1]);
+
+    /// cleanup
+    real_constbuffer_array_dec_ref(first);
+    real_constbuffer_array_dec_ref(second);
+    real_constbuffer_array_dec_ref(buffers);
+    TARRAY_ASSIGN(CONSTBUFFER_ARRAY_HANDLE)(&result, NULL);
+}
+
 /* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_004: [ If there are any other failures then constbuffer_array_splitter_split_to_array_of_array shall fail and return NULL. ]*/
 /* Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_07_019: [ On any failure, constbuffer_array_splitter_split_to_array_of_array dec ref the sub-tarrays by calling constbuffer_array_dec_ref. ]*/
 TEST_FUNCTION(constbuffer_array_splitter_split_to_array_of_array_with_multiple_buffers_1000_bytes_each_merge_and_split_fails_if_underlying_functions_fail)
@@ -1845,7 +1977,7 @@ TEST_FUNCTION(constbuffer_array_splitter_split_to_array_of_array_with_multiple_b
 
     STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(buffers, IGNORED_ARG))
         .CallCannotFail();
-    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size(buffers, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size_64(buffers, IGNORED_ARG));
     STRICT_EXPECTED_CALL(TARRAY_CREATE_WITH_CAPACITY(CONSTBUFFER_ARRAY_HANDLE)(7));
 
     for (uint32_t i = 0; i < 7; i += 3)
@@ -1921,7 +2053,7 @@ TEST_FUNCTION(constbuffer_array_splitter_split_to_array_of_array_with_empty_arra
 
     STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(buffers, IGNORED_ARG))
         .CallCannotFail();
-    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size(buffers, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size_64(buffers, IGNORED_ARG));
     STRICT_EXPECTED_CALL(TARRAY_CREATE_WITH_CAPACITY(CONSTBUFFER_ARRAY_HANDLE)(1));
     STRICT_EXPECTED_CALL(constbuffer_array_create_empty());
 
@@ -1956,7 +2088,7 @@ TEST_FUNCTION(constbuffer_array_splitter_split_to_array_of_array_with_all_empty_
 
     STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_count(buffers, IGNORED_ARG))
         .CallCannotFail();
-    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size(buffers, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size_64(buffers, IGNORED_ARG));
     STRICT_EXPECTED_CALL(TARRAY_CREATE_WITH_CAPACITY(CONSTBUFFER_ARRAY_HANDLE)(1));
     STRICT_EXPECTED_CALL(constbuffer_array_create_empty());
 
@@ -1981,4 +2113,1278 @@ TEST_FUNCTION(constbuffer_array_splitter_split_to_array_of_array_with_all_empty_
     real_constbuffer_array_dec_ref(buffers);
 }
 
+/* constbuffer_array_splitter_iterator_init */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_001: [ If iterator is NULL then constbuffer_array_splitter_iterator_init shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_splitter_iterator_init_with_NULL_iterator_fails)
+{
+    /// arrange
+    CONSTBUFFER_ARRAY_HANDLE buffers = generate_test_buffer_array(3, 10);
+    umock_c_reset_all_calls();
+
+    /// act
+    int result = constbuffer_array_splitter_iterator_init(NULL, buffers, 8);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    /// cleanup
+    real_constbuffer_array_dec_ref(buffers);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_002: [ If buffers is NULL then constbuffer_array_splitter_iterator_init shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_splitter_iterator_init_with_NULL_buffers_fails)
+{
+    /// arrange
+    CONSTBUFFER_ARRAY_SPLITTER_ITERATOR iterator;
+
+    /// act
+    int result = constbuffer_array_splitter_iterator_init(&iterator, NULL, 8);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_003: [ If max_buffer_size is 0 then constbuffer_array_splitter_iterator_init shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_splitter_iterator_init_with_0_max_buffer_size_fails)
+{
+    /// arrange
+    CONSTBUFFER_ARRAY_SPLITTER_ITERATOR iterator;
+    CONSTBUFFER_ARRAY_HANDLE buffers = generate_test_buffer_array(3, 10);
+    umock_c_reset_all_calls();
+
+    /// act
+    int result = constbuffer_array_splitter_iterator_init(&iterator, buffers, 0);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    /// cleanup
+    real_constbuffer_array_dec_ref(buffers);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_005: [ If there are any failures then constbuffer_array_splitter_iterator_init shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_splitter_iterator_init_fails_when_constbuffer_array_get_all_buffers_size_64_fails)
+{
+    /// arrange
+    CONSTBUFFER_ARRAY_SPLITTER_ITERATOR iterator;
+    CONSTBUFFER_ARRAY_HANDLE buffers = generate_test_buffer_array(3, 10);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size_64(buffers, IGNORED_ARG))
+        .SetReturn(MU_FAILURE);
+
+    /// act
+    int result = constbuffer_array_splitter_iterator_init(&iterator, buffers, 8);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    /// cleanup
+    real_constbuffer_array_dec_ref(buffers);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_004: [ constbuffer_array_splitter_iterator_init shall call constbuffer_array_get_all_buffers_size_64 for buffers to obtain the number of bytes to split. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_006: [ constbuffer_array_splitter_iterator_init shall position iterator at the first byte of buffers, succeed and return 0. ]*/
+TEST_FUNCTION(constbuffer_array_splitter_iterator_init_succeeds)
+{
+    /// arrange
+    CONSTBUFFER_ARRAY_SPLITTER_ITERATOR iterator;
+    CONSTBUFFER_ARRAY_HANDLE buffers = generate_test_buffer_array(3, 10);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size_64(buffers, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 0));
+
+    /// act
+    int result = constbuffer_array_splitter_iterator_init(&iterator, buffers, 8);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    /// cleanup
+    real_constbuffer_array_dec_ref(buffers);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_006: [ constbuffer_array_splitter_iterator_init shall position iterator at the first byte of buffers, succeed and return 0. ]*/
+TEST_FUNCTION(constbuffer_array_splitter_iterator_init_with_empty_array_succeeds)
+{
+    /// arrange
+    CONSTBUFFER_ARRAY_SPLITTER_ITERATOR iterator;
+    CONSTBUFFER_ARRAY_HANDLE buffers = generate_test_buffer_array(0, 0);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size_64(buffers, IGNORED_ARG));
+
+    /// act
+    int result = constbuffer_array_splitter_iterator_init(&iterator, buffers, 8);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    /// cleanup
+    real_constbuffer_array_dec_ref(buffers);
+}
+
+/* constbuffer_array_splitter_iterator_next */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_007: [ If iterator is NULL or chunk is NULL then constbuffer_array_splitter_iterator_next shall fail and return CONSTBUFFER_ARRAY_SPLITTER_NEXT_INVALID_ARG. ]*/
+TEST_FUNCTION(constbuffer_array_splitter_iterator_next_with_NULL_arguments_fails)
+{
+    /// arrange
+    CONSTBUFFER_ARRAY_SPLITTER_ITERATOR iterator;
+    CONSTBUFFER_ARRAY_SPLITTER_CHUNK chunk;
+    CONSTBUFFER_ARRAY_HANDLE buffers = generate_test_buffer_array(3, 10);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_splitter_iterator_init(&iterator, buffers, 8));
+    umock_c_reset_all_calls();
+
+    /// act
+    CONSTBUFFER_ARRAY_SPLITTER_NEXT_RESULT result_1 = constbuffer_array_splitter_iterator_next(NULL, &chunk);
+    CONSTBUFFER_ARRAY_SPLITTER_NEXT_RESULT result_2 = constbuffer_array_splitter_iterator_next(&iterator, NULL);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_SPLITTER_NEXT_RESULT, CONSTBUFFER_ARRAY_SPLITTER_NEXT_INVALID_ARG, result_1);
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_SPLITTER_NEXT_RESULT, CONSTBUFFER_ARRAY_SPLITTER_NEXT_INVALID_ARG, result_2);
+
+    /// cleanup
+    real_constbuffer_array_dec_ref(buffers);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_008: [ If all the bytes of the array were already returned then constbuffer_array_splitter_iterator_next shall return CONSTBUFFER_ARRAY_SPLITTER_NEXT_END. ]*/
+TEST_FUNCTION(constbuffer_array_splitter_iterator_next_with_empty_array_returns_END)
+{
+    /// arrange
+    CONSTBUFFER_ARRAY_SPLITTER_ITERATOR iterator;
+    CONSTBUFFER_ARRAY_SPLITTER_CHUNK chunk;
+    CONSTBUFFER_ARRAY_HANDLE buffers = generate_test_buffer_array(3, 0);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_splitter_iterator_init(&iterator, buffers, 8));
+    umock_c_reset_all_calls();
+
+    /// act
+    CONSTBUFFER_ARRAY_SPLITTER_NEXT_RESULT result = constbuffer_array_splitter_iterator_next(&iterator, &chunk);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_SPLITTER_NEXT_RESULT, CONSTBUFFER_ARRAY_SPLITTER_NEXT_END, result);
+
+    /// cleanup
+    real_constbuffer_array_dec_ref(buffers);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_008: [ If all the bytes of the array were already returned then constbuffer_array_splitter_iterator_next shall return CONSTBUFFER_ARRAY_SPLITTER_NEXT_END. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_010: [ constbuffer_array_splitter_iterator_next shall fill chunk with the next min(max_buffer_size, remaining size) bytes: the index of the buffer holding the first byte, the offset of that byte in it, the number of buffers spanned and the number of bytes in the last of them. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_011: [ constbuffer_array_splitter_iterator_next shall move iterator past the bytes of chunk and return CONSTBUFFER_ARRAY_SPLITTER_NEXT_OK. ]*/
+TEST_FUNCTION(constbuffer_array_splitter_iterator_next_returns_all_the_chunks_without_allocating)
+{
+    /// arrange
+    CONSTBUFFER_ARRAY_SPLITTER_ITERATOR iterator;
+    CONSTBUFFER_ARRAY_SPLITTER_CHUNK chunks[5];
+    CONSTBUFFER_ARRAY_HANDLE buffers = generate_test_buffer_array(3, 10);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_splitter_iterator_init(&iterator, buffers, 8));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 1));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 2));
+
+    /// act
+    CONSTBUFFER_ARRAY_SPLITTER_NEXT_RESULT results[5];
+    for (uint32_t i = 0; i < 5; i++)
+    {
+        results[i] = constbuffer_array_splitter_iterator_next(&iterator, &chunks[i]);
+    }
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_SPLITTER_NEXT_RESULT, CONSTBUFFER_ARRAY_SPLITTER_NEXT_OK, results[i]);
+    }
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_SPLITTER_NEXT_RESULT, CONSTBUFFER_ARRAY_SPLITTER_NEXT_END, results[4]);
+    assert_chunk_is(&chunks[0], 0, 1, 0, 8, 8);
+    assert_chunk_is(&chunks[1], 0, 2, 8, 6, 8);
+    assert_chunk_is(&chunks[2], 1, 2, 6, 4, 8);
+    assert_chunk_is(&chunks[3], 2, 1, 4, 6, 6);
+
+    /// cleanup
+    real_constbuffer_array_dec_ref(buffers);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_009: [ constbuffer_array_splitter_iterator_next shall move past the buffers that have no bytes left (getting the next buffer with constbuffer_array_get_buffer_content) so that the chunk starts at the next byte. ]*/
+TEST_FUNCTION(constbuffer_array_splitter_iterator_next_skips_leading_empty_buffers)
+{
+    /// arrange
+    CONSTBUFFER_ARRAY_SPLITTER_ITERATOR iterator;
+    CONSTBUFFER_ARRAY_SPLITTER_CHUNK chunk;
+    CONSTBUFFER_ARRAY_HANDLE buffers = generate_test_buffer_array_increasing_size(3, 0, 5); /*0, 5 and 10 bytes*/
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_splitter_iterator_init(&iterator, buffers, 20));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 1));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 2));
+
+    /// act
+    CONSTBUFFER_ARRAY_SPLITTER_NEXT_RESULT result = constbuffer_array_splitter_iterator_next(&iterator, &chunk);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_SPLITTER_NEXT_RESULT, CONSTBUFFER_ARRAY_SPLITTER_NEXT_OK, result);
+    assert_chunk_is(&chunk, 1, 2, 0, 10, 15);
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_SPLITTER_NEXT_RESULT, CONSTBUFFER_ARRAY_SPLITTER_NEXT_END, constbuffer_array_splitter_iterator_next(&iterator, &chunk));
+
+    /// cleanup
+    real_constbuffer_array_dec_ref(buffers);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_008: [ If all the bytes of the array were already returned then constbuffer_array_splitter_iterator_next shall return CONSTBUFFER_ARRAY_SPLITTER_NEXT_END. ]*/
+TEST_FUNCTION(constbuffer_array_splitter_iterator_next_does_not_visit_trailing_empty_buffers)
+{
+    /// arrange
+    CONSTBUFFER_ARRAY_SPLITTER_ITERATOR iterator;
+    CONSTBUFFER_ARRAY_SPLITTER_CHUNK chunks[3];
+    CONSTBUFFER_ARRAY_HANDLE buffers = generate_test_buffer_array_increasing_size(3, 4, -2); /*4, 2 and 0 bytes*/
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_splitter_iterator_init(&iterator, buffers, 3));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 1));
+
+    /// act
+    CONSTBUFFER_ARRAY_SPLITTER_NEXT_RESULT results[3];
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        results[i] = constbuffer_array_splitter_iterator_next(&iterator, &chunks[i]);
+    }
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_SPLITTER_NEXT_RESULT, CONSTBUFFER_ARRAY_SPLITTER_NEXT_OK, results[0]);
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_SPLITTER_NEXT_RESULT, CONSTBUFFER_ARRAY_SPLITTER_NEXT_OK, results[1]);
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_SPLITTER_NEXT_RESULT, CONSTBUFFER_ARRAY_SPLITTER_NEXT_END, results[2]);
+    assert_chunk_is(&chunks[0], 0, 1, 0, 3, 3);
+    assert_chunk_is(&chunks[1], 0, 2, 3, 2, 3);
+
+    /// cleanup
+    real_constbuffer_array_dec_ref(buffers);
+}
+
+/* constbuffer_array_splitter_chunk_get_span */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_012: [ If buffers is NULL or chunk is NULL or span is NULL then constbuffer_array_splitter_chunk_get_span shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_splitter_chunk_get_span_with_NULL_arguments_fails)
+{
+    /// arrange
+    CONSTBUFFER_ARRAY_SPLITTER_CHUNK chunk = { 0, 1, 0, 8, 8 };
+    CONSTBUFFER_ARRAY_SPLITTER_SPAN span;
+    CONSTBUFFER_ARRAY_HANDLE buffers = generate_test_buffer_array(3, 10);
+    umock_c_reset_all_calls();
+
+    /// act
+    int result_1 = constbuffer_array_splitter_chunk_get_span(NULL, &chunk, 0, &span);
+    int result_2 = constbuffer_array_splitter_chunk_get_span(buffers, NULL, 0, &span);
+    int result_3 = constbuffer_array_splitter_chunk_get_span(buffers, &chunk, 0, NULL);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result_1);
+    ASSERT_ARE_NOT_EQUAL(int, 0, result_2);
+    ASSERT_ARE_NOT_EQUAL(int, 0, result_3);
+
+    /// cleanup
+    real_constbuffer_array_dec_ref(buffers);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_013: [ If span_index is not less than the number of buffers spanned by chunk then constbuffer_array_splitter_chunk_get_span shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_splitter_chunk_get_span_with_span_index_too_large_fails)
+{
+    /// arrange
+    CONSTBUFFER_ARRAY_SPLITTER_CHUNK chunk = { 0, 2, 8, 6, 8 };
+    CONSTBUFFER_ARRAY_SPLITTER_SPAN span;
+    CONSTBUFFER_ARRAY_HANDLE buffers = generate_test_buffer_array(3, 10);
+    umock_c_reset_all_calls();
+
+    /// act
+    int result = constbuffer_array_splitter_chunk_get_span(buffers, &chunk, 2, &span);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    /// cleanup
+    real_constbuffer_array_dec_ref(buffers);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_015: [ If there are any failures then constbuffer_array_splitter_chunk_get_span shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_splitter_chunk_get_span_fails_when_constbuffer_array_get_buffer_content_fails)
+{
+    /// arrange
+    CONSTBUFFER_ARRAY_SPLITTER_CHUNK chunk = { 0, 1, 0, 8, 8 };
+    CONSTBUFFER_ARRAY_SPLITTER_SPAN span;
+    CONSTBUFFER_ARRAY_HANDLE buffers = generate_test_buffer_array(3, 10);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 0))
+        .SetReturn(NULL);
+
+    /// act
+    int result = constbuffer_array_splitter_chunk_get_span(buffers, &chunk, 0, &span);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    /// cleanup
+    real_constbuffer_array_dec_ref(buffers);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_014: [ constbuffer_array_splitter_chunk_get_span shall get the content of the span_index-th buffer spanned by chunk by calling constbuffer_array_get_buffer_content. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_016: [ constbuffer_array_splitter_chunk_get_span shall write in span the content of the buffer, the offset of the chunk in it (start_buffer_offset for the first span, 0 for the others) and the number of bytes of the chunk in it (end_buffer_size for the last span, the rest of the buffer for the others), succeed and return 0. ]*/
+TEST_FUNCTION(constbuffer_array_splitter_chunk_get_span_returns_the_spans_of_a_chunk_over_3_buffers)
+{
+    /// arrange
+    CONSTBUFFER_ARRAY_SPLITTER_CHUNK chunk = { 0, 3, 4, 6, 22 };
+    CONSTBUFFER_ARRAY_SPLITTER_SPAN spans[3];
+    CONSTBUFFER_ARRAY_HANDLE buffers = generate_test_buffer_array(3, 10);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 0));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 1));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 2));
+
+    /// act
+    int results[3];
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        results[i] = constbuffer_array_splitter_chunk_get_span(buffers, &chunk, i, &spans[i]);
+    }
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        ASSERT_ARE_EQUAL(int, 0, results[i]);
+        ASSERT_ARE_EQUAL(void_ptr, real_constbuffer_array_get_buffer_content(buffers, i), spans[i].buffer);
+    }
+    ASSERT_ARE_EQUAL(uint32_t, 4, spans[0].offset);
+    ASSERT_ARE_EQUAL(uint32_t, 6, spans[0].size);
+    ASSERT_ARE_EQUAL(uint32_t, 0, spans[1].offset);
+    ASSERT_ARE_EQUAL(uint32_t, 10, spans[1].size);
+    ASSERT_ARE_EQUAL(uint32_t, 0, spans[2].offset);
+    ASSERT_ARE_EQUAL(uint32_t, 6, spans[2].size);
+
+    /// cleanup
+    real_constbuffer_array_dec_ref(buffers);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_016: [ constbuffer_array_splitter_chunk_get_span shall write in span the content of the buffer, the offset of the chunk in it (start_buffer_offset for the first span, 0 for the others) and the number of bytes of the chunk in it (end_buffer_size for the last span, the rest of the buffer for the others), succeed and return 0. ]*/
+TEST_FUNCTION(constbuffer_array_splitter_chunk_get_span_returns_the_span_of_a_chunk_inside_1_buffer)
+{
+    /// arrange
+    CONSTBUFFER_ARRAY_SPLITTER_CHUNK chunk = { 1, 1, 2, 5, 5 };
+    CONSTBUFFER_ARRAY_SPLITTER_SPAN span;
+    CONSTBUFFER_ARRAY_HANDLE buffers = generate_test_buffer_array(3, 10);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 1));
+
+    /// act
+    int result = constbuffer_array_splitter_chunk_get_span(buffers, &chunk, 0, &span);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(void_ptr, real_constbuffer_array_get_buffer_content(buffers, 1), span.buffer);
+    ASSERT_ARE_EQUAL(uint32_t, 2, span.offset);
+    ASSERT_ARE_EQUAL(uint32_t, 5, span.size);
+
+    /// cleanup
+    real_constbuffer_array_dec_ref(buffers);
+}
+
+/* constbuffer_array_splitter_split_to_chunks */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_017: [ If buffers is NULL then constbuffer_array_splitter_split_to_chunks shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_splitter_split_to_chunks_with_NULL_buffers_fails)
+{
+    /// arrange
+    uint32_t chunk_count;
+
+    /// act
+    CONSTBUFFER_ARRAY_SPLITTER_CHUNK* result = constbuffer_array_splitter_split_to_chunks(NULL, 8, &chunk_count);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(result);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_018: [ If max_buffer_size is 0 then constbuffer_array_splitter_split_to_chunks shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_splitter_split_to_chunks_with_0_max_buffer_size_fails)
+{
+    /// arrange
+    uint32_t chunk_count;
+    CONSTBUFFER_ARRAY_HANDLE buffers = generate_test_buffer_array(3, 10);
+    umock_c_reset_all_calls();
+
+    /// act
+    CONSTBUFFER_ARRAY_SPLITTER_CHUNK* result = constbuffer_array_splitter_split_to_chunks(buffers, 0, &chunk_count);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(result);
+
+    /// cleanup
+    real_constbuffer_array_dec_ref(buffers);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_019: [ If chunk_count is NULL then constbuffer_array_splitter_split_to_chunks shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_splitter_split_to_chunks_with_NULL_chunk_count_fails)
+{
+    /// arrange
+    CONSTBUFFER_ARRAY_HANDLE buffers = generate_test_buffer_array(3, 10);
+    umock_c_reset_all_calls();
+
+    /// act
+    CONSTBUFFER_ARRAY_SPLITTER_CHUNK* result = constbuffer_array_splitter_split_to_chunks(buffers, 8, NULL);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(result);
+
+    /// cleanup
+    real_constbuffer_array_dec_ref(buffers);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_020: [ constbuffer_array_splitter_split_to_chunks shall initialize a CONSTBUFFER_ARRAY_SPLITTER_ITERATOR over buffers. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_021: [ constbuffer_array_splitter_split_to_chunks shall allocate in one call the memory for all the chunks (total size / max_buffer_size rounded up, at least 1). ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_022: [ constbuffer_array_splitter_split_to_chunks shall fill the chunks by calling constbuffer_array_splitter_iterator_next once per chunk, write their number in chunk_count, succeed and return them. ]*/
+TEST_FUNCTION(constbuffer_array_splitter_split_to_chunks_succeeds)
+{
+    /// arrange
+    uint32_t chunk_count;
+    CONSTBUFFER_ARRAY_HANDLE buffers = generate_test_buffer_array(3, 10);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size_64(buffers, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 0));
+    STRICT_EXPECTED_CALL(malloc_2(4, sizeof(CONSTBUFFER_ARRAY_SPLITTER_CHUNK)));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 1));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 2));
+
+    /// act
+    CONSTBUFFER_ARRAY_SPLITTER_CHUNK* result = constbuffer_array_splitter_split_to_chunks(buffers, 8, &chunk_count);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(uint32_t, 4, chunk_count);
+    assert_chunk_is(&result[0], 0, 1, 0, 8, 8);
+    assert_chunk_is(&result[1], 0, 2, 8, 6, 8);
+    assert_chunk_is(&result[2], 1, 2, 6, 4, 8);
+    assert_chunk_is(&result[3], 2, 1, 4, 6, 6);
+
+    /// cleanup
+    real_gballoc_hl_free(result);
+    real_constbuffer_array_dec_ref(buffers);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_021: [ constbuffer_array_splitter_split_to_chunks shall allocate in one call the memory for all the chunks (total size / max_buffer_size rounded up, at least 1). ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_022: [ constbuffer_array_splitter_split_to_chunks shall fill the chunks by calling constbuffer_array_splitter_iterator_next once per chunk, write their number in chunk_count, succeed and return them. ]*/
+TEST_FUNCTION(constbuffer_array_splitter_split_to_chunks_with_empty_array_succeeds)
+{
+    /// arrange
+    uint32_t chunk_count;
+    CONSTBUFFER_ARRAY_HANDLE buffers = generate_test_buffer_array(0, 0);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size_64(buffers, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(malloc_2(1, sizeof(CONSTBUFFER_ARRAY_SPLITTER_CHUNK)));
+
+    /// act
+    CONSTBUFFER_ARRAY_SPLITTER_CHUNK* result = constbuffer_array_splitter_split_to_chunks(buffers, 8, &chunk_count);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(uint32_t, 0, chunk_count);
+
+    /// cleanup
+    real_gballoc_hl_free(result);
+    real_constbuffer_array_dec_ref(buffers);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_023: [ If there are any failures then constbuffer_array_splitter_split_to_chunks shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_splitter_split_to_chunks_fails_when_underlying_functions_fail)
+{
+    /// arrange
+    uint32_t chunk_count;
+    CONSTBUFFER_ARRAY_HANDLE buffers = generate_test_buffer_array(3, 10);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size_64(buffers, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 0));
+    STRICT_EXPECTED_CALL(malloc_2(4, sizeof(CONSTBUFFER_ARRAY_SPLITTER_CHUNK)));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 1));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 2));
+
+    umock_c_negative_tests_snapshot();
+
+    for (size_t i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
+        if (umock_c_negative_tests_can_call_fail(i))
+        {
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(i);
+
+            /// act
+            CONSTBUFFER_ARRAY_SPLITTER_CHUNK* result = constbuffer_array_splitter_split_to_chunks(buffers, 8, &chunk_count);
+
+            ///assert
+            ASSERT_IS_NULL(result, "On failed call %zu", i);
+        }
+    }
+
+    /// cleanup
+    real_constbuffer_array_dec_ref(buffers);
+}
+
+/* constbuffer_array_splitter_cdc_iterator_init */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_024: [ If iterator is NULL then constbuffer_array_splitter_cdc_iterator_init shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_splitter_cdc_iterator_init_with_NULL_iterator_fails)
+{
+    /// arrange
+    CONSTBUFFER_ARRAY_HANDLE buffers = generate_test_buffer_array(3, 10);
+    umock_c_reset_all_calls();
+
+    /// act
+    int result = constbuffer_array_splitter_cdc_iterator_init(NULL, buffers, 4, 8, 16);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    /// cleanup
+    real_constbuffer_array_dec_ref(buffers);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_025: [ If buffers is NULL then constbuffer_array_splitter_cdc_iterator_init shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_splitter_cdc_iterator_init_with_NULL_buffers_fails)
+{
+    /// arrange
+    CONSTBUFFER_ARRAY_SPLITTER_CDC_ITERATOR iterator;
+
+    /// act
+    int result = constbuffer_array_splitter_cdc_iterator_init(&iterator, NULL, 4, 8, 16);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_026: [ If min_chunk_size is 0 then constbuffer_array_splitter_cdc_iterator_init shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_splitter_cdc_iterator_init_with_0_min_chunk_size_fails)
+{
+    /// arrange
+    CONSTBUFFER_ARRAY_SPLITTER_CDC_ITERATOR iterator;
+    CONSTBUFFER_ARRAY_HANDLE buffers = generate_test_buffer_array(3, 10);
+    umock_c_reset_all_calls();
+
+    /// act
+    int result = constbuffer_array_splitter_cdc_iterator_init(&iterator, buffers, 0, 8, 16);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    /// cleanup
+    real_constbuffer_array_dec_ref(buffers);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_027: [ If min_chunk_size is greater than avg_chunk_size or avg_chunk_size is greater than max_chunk_size then constbuffer_array_splitter_cdc_iterator_init shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_splitter_cdc_iterator_init_with_min_chunk_size_greater_than_avg_chunk_size_fails)
+{
+    /// arrange
+    CONSTBUFFER_ARRAY_SPLITTER_CDC_ITERATOR iterator;
+    CONSTBUFFER_ARRAY_HANDLE buffers = generate_test_buffer_array(3, 10);
+    umock_c_reset_all_calls();
+
+    /// act
+    int result = constbuffer_array_splitter_cdc_iterator_init(&iterator, buffers, 9, 8, 16);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    /// cleanup
+    real_constbuffer_array_dec_ref(buffers);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_027: [ If min_chunk_size is greater than avg_chunk_size or avg_chunk_size is greater than max_chunk_size then constbuffer_array_splitter_cdc_iterator_init shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_splitter_cdc_iterator_init_with_avg_chunk_size_greater_than_max_chunk_size_fails)
+{
+    /// arrange
+    CONSTBUFFER_ARRAY_SPLITTER_CDC_ITERATOR iterator;
+    CONSTBUFFER_ARRAY_HANDLE buffers = generate_test_buffer_array(3, 10);
+    umock_c_reset_all_calls();
+
+    /// act
+    int result = constbuffer_array_splitter_cdc_iterator_init(&iterator, buffers, 4, 17, 16);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    /// cleanup
+    real_constbuffer_array_dec_ref(buffers);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_029: [ If there are any failures then constbuffer_array_splitter_cdc_iterator_init shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_splitter_cdc_iterator_init_fails_when_constbuffer_array_get_all_buffers_size_64_fails)
+{
+    /// arrange
+    CONSTBUFFER_ARRAY_SPLITTER_CDC_ITERATOR iterator;
+    CONSTBUFFER_ARRAY_HANDLE buffers = generate_test_buffer_array(3, 10);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size_64(buffers, IGNORED_ARG))
+        .SetReturn(MU_FAILURE);
+
+    /// act
+    int result = constbuffer_array_splitter_cdc_iterator_init(&iterator, buffers, 4, 8, 16);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    /// cleanup
+    real_constbuffer_array_dec_ref(buffers);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_028: [ constbuffer_array_splitter_cdc_iterator_init shall call constbuffer_array_get_all_buffers_size_64 for buffers to obtain the number of bytes to split. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_030: [ constbuffer_array_splitter_cdc_iterator_init shall compute the cut point masks (log2(avg_chunk_size) + 1 bits before avg_chunk_size bytes, log2(avg_chunk_size) - 1 bits after), position iterator at the first byte of buffers, succeed and return 0. ]*/
+TEST_FUNCTION(constbuffer_array_splitter_cdc_iterator_init_succeeds)
+{
+    /// arrange
+    CONSTBUFFER_ARRAY_SPLITTER_CDC_ITERATOR iterator;
+    CONSTBUFFER_ARRAY_HANDLE buffers = generate_test_buffer_array(3, 10);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size_64(buffers, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 0));
+
+    /// act
+    int result = constbuffer_array_splitter_cdc_iterator_init(&iterator, buffers, 2048, 8192, 65536);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint64_t, UINT64_C(0xFFFC000000000000), iterator.mask_small); /*14 bits*/
+    ASSERT_ARE_EQUAL(uint64_t, UINT64_C(0xFFF0000000000000), iterator.mask_large); /*12 bits*/
+    ASSERT_ARE_EQUAL(uint64_t, 30, iterator.remaining_size);
+
+    /// cleanup
+    real_constbuffer_array_dec_ref(buffers);
+}
+
+/* constbuffer_array_splitter_cdc_iterator_next */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_031: [ If iterator is NULL or chunk is NULL or fingerprint is NULL then constbuffer_array_splitter_cdc_iterator_next shall fail and return CONSTBUFFER_ARRAY_SPLITTER_NEXT_INVALID_ARG. ]*/
+TEST_FUNCTION(constbuffer_array_splitter_cdc_iterator_next_with_NULL_arguments_fails)
+{
+    /// arrange
+    CONSTBUFFER_ARRAY_SPLITTER_CDC_ITERATOR iterator;
+    CONSTBUFFER_ARRAY_SPLITTER_CHUNK chunk;
+    uint32_t fingerprint;
+    CONSTBUFFER_ARRAY_HANDLE buffers = generate_test_buffer_array(3, 10);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_splitter_cdc_iterator_init(&iterator, buffers, 4, 8, 16));
+    umock_c_reset_all_calls();
+
+    /// act
+    CONSTBUFFER_ARRAY_SPLITTER_NEXT_RESULT result_1 = constbuffer_array_splitter_cdc_iterator_next(NULL, &chunk, &fingerprint);
+    CONSTBUFFER_ARRAY_SPLITTER_NEXT_RESULT result_2 = constbuffer_array_splitter_cdc_iterator_next(&iterator, NULL, &fingerprint);
+    CONSTBUFFER_ARRAY_SPLITTER_NEXT_RESULT result_3 = constbuffer_array_splitter_cdc_iterator_next(&iterator, &chunk, NULL);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_SPLITTER_NEXT_RESULT, CONSTBUFFER_ARRAY_SPLITTER_NEXT_INVALID_ARG, result_1);
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_SPLITTER_NEXT_RESULT, CONSTBUFFER_ARRAY_SPLITTER_NEXT_INVALID_ARG, result_2);
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_SPLITTER_NEXT_RESULT, CONSTBUFFER_ARRAY_SPLITTER_NEXT_INVALID_ARG, result_3);
+
+    /// cleanup
+    real_constbuffer_array_dec_ref(buffers);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_032: [ If all the bytes of the array were already returned then constbuffer_array_splitter_cdc_iterator_next shall return CONSTBUFFER_ARRAY_SPLITTER_NEXT_END. ]*/
+TEST_FUNCTION(constbuffer_array_splitter_cdc_iterator_next_with_empty_array_returns_END)
+{
+    /// arrange
+    CONSTBUFFER_ARRAY_SPLITTER_CDC_ITERATOR iterator;
+    CONSTBUFFER_ARRAY_SPLITTER_CHUNK chunk;
+    uint32_t fingerprint;
+    CONSTBUFFER_ARRAY_HANDLE buffers = generate_test_buffer_array(3, 0);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_splitter_cdc_iterator_init(&iterator, buffers, 4, 8, 16));
+    umock_c_reset_all_calls();
+
+    /// act
+    CONSTBUFFER_ARRAY_SPLITTER_NEXT_RESULT result = constbuffer_array_splitter_cdc_iterator_next(&iterator, &chunk, &fingerprint);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_SPLITTER_NEXT_RESULT, CONSTBUFFER_ARRAY_SPLITTER_NEXT_END, result);
+
+    /// cleanup
+    real_constbuffer_array_dec_ref(buffers);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_033: [ constbuffer_array_splitter_cdc_iterator_next shall move past the buffers that have no bytes left (getting the next buffer with constbuffer_array_get_buffer_content) so that the chunk starts at the next byte. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_034: [ If there are no more than min_chunk_size bytes left then the chunk shall be all of them. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_035: [ Otherwise, constbuffer_array_splitter_cdc_iterator_next shall skip the first min_chunk_size bytes and then roll a gear hash (hash = (hash << 1) + gear_table[byte]) over the following bytes, ending the chunk after the first byte where hash & mask_small is 0 (before avg_chunk_size bytes) or hash & mask_large is 0 (after avg_chunk_size bytes), or after max_chunk_size bytes. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_036: [ constbuffer_array_splitter_cdc_iterator_next shall compute the fingerprint of the chunk by calling crc32c_compute for the bytes of the chunk in each buffer it spans. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_037: [ constbuffer_array_splitter_cdc_iterator_next shall fill chunk with the index of the buffer holding the first byte, the offset of that byte in it, the number of buffers spanned and the number of bytes in the last of them, write the fingerprint, move iterator past the bytes of chunk and return CONSTBUFFER_ARRAY_SPLITTER_NEXT_OK. ]*/
+TEST_FUNCTION(constbuffer_array_splitter_cdc_iterator_next_with_equal_chunk_sizes_returns_fixed_size_chunks)
+{
+    /// arrange
+    // with min_chunk_size = avg_chunk_size = max_chunk_size no byte is hashed and the chunks are the same as constbuffer_array_splitter_iterator_next's
+    CONSTBUFFER_ARRAY_SPLITTER_CDC_ITERATOR iterator;
+    CONSTBUFFER_ARRAY_SPLITTER_CHUNK chunks[5];
+    uint32_t fingerprints[5];
+    CONSTBUFFER_ARRAY_HANDLE buffers = generate_test_buffer_array(3, 10);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_splitter_cdc_iterator_init(&iterator, buffers, 8, 8, 8));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(crc32c_compute(0, IGNORED_ARG, 8));
+    STRICT_EXPECTED_CALL(crc32c_compute(0, IGNORED_ARG, 2));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 1));
+    STRICT_EXPECTED_CALL(crc32c_compute(IGNORED_ARG, IGNORED_ARG, 6));
+    STRICT_EXPECTED_CALL(crc32c_compute(0, IGNORED_ARG, 4));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 2));
+    STRICT_EXPECTED_CALL(crc32c_compute(IGNORED_ARG, IGNORED_ARG, 4));
+    STRICT_EXPECTED_CALL(crc32c_compute(0, IGNORED_ARG, 6));
+
+    /// act
+    CONSTBUFFER_ARRAY_SPLITTER_NEXT_RESULT results[5];
+    for (uint32_t i = 0; i < 5; i++)
+    {
+        results[i] = constbuffer_array_splitter_cdc_iterator_next(&iterator, &chunks[i], &fingerprints[i]);
+    }
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_SPLITTER_NEXT_RESULT, CONSTBUFFER_ARRAY_SPLITTER_NEXT_OK, results[i]);
+    }
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_SPLITTER_NEXT_RESULT, CONSTBUFFER_ARRAY_SPLITTER_NEXT_END, results[4]);
+    assert_chunk_is(&chunks[0], 0, 1, 0, 8, 8);
+    assert_chunk_is(&chunks[1], 0, 2, 8, 6, 8);
+    assert_chunk_is(&chunks[2], 1, 2, 6, 4, 8);
+    assert_chunk_is(&chunks[3], 2, 1, 4, 6, 6);
+
+    unsigned char bytes[30];
+    for (uint32_t i = 0; i < 30; i++)
+    {
+        bytes[i] = (unsigned char)(('a' + i / 10) % ('z' - 'a'));
+    }
+    ASSERT_ARE_EQUAL(uint32_t, real_crc32c_compute(0, bytes, 8), fingerprints[0]);
+    ASSERT_ARE_EQUAL(uint32_t, real_crc32c_compute(0, bytes + 8, 8), fingerprints[1]);
+    ASSERT_ARE_EQUAL(uint32_t, real_crc32c_compute(0, bytes + 16, 8), fingerprints[2]);
+    ASSERT_ARE_EQUAL(uint32_t, real_crc32c_compute(0, bytes + 24, 6), fingerprints[3]);
+
+    /// cleanup
+    real_constbuffer_array_dec_ref(buffers);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_035: [ Otherwise, constbuffer_array_splitter_cdc_iterator_next shall skip the first min_chunk_size bytes and then roll a gear hash (hash = (hash << 1) + gear_table[byte]) over the following bytes, ending the chunk after the first byte where hash & mask_small is 0 (before avg_chunk_size bytes) or hash & mask_large is 0 (after avg_chunk_size bytes), or after max_chunk_size bytes. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_036: [ constbuffer_array_splitter_cdc_iterator_next shall compute the fingerprint of the chunk by calling crc32c_compute for the bytes of the chunk in each buffer it spans. ]*/
+TEST_FUNCTION(constbuffer_array_splitter_cdc_iterator_next_returns_chunks_between_min_and_max_chunk_size)
+{
+    /// arrange
+    uint32_t size = 1024 * 1024;
+    unsigned char* bytes = real_gballoc_hl_malloc(size);
+    ASSERT_IS_NOT_NULL(bytes);
+    generate_pseudo_random_bytes(bytes, size, 42);
+    CONSTBUFFER_ARRAY_HANDLE buffers = generate_test_buffer_array_from_bytes(bytes, size, 3000);
+    uint32_t* sizes = real_gballoc_hl_malloc(sizeof(uint32_t) * 1024);
+    ASSERT_IS_NOT_NULL(sizes);
+    uint32_t* fingerprints = real_gballoc_hl_malloc(sizeof(uint32_t) * 1024);
+    ASSERT_IS_NOT_NULL(fingerprints);
+
+    /// act
+    uint32_t chunk_count = get_all_cdc_chunks(buffers, 1024, 4096, 16384, sizes, fingerprints, 1024);
+
+    /// assert
+    uint32_t offset = 0;
+    for (uint32_t i = 0; i < chunk_count; i++)
+    {
+        ASSERT_IS_TRUE(sizes[i] <= 16384);
+        ASSERT_IS_TRUE((sizes[i] >= 1024) || (i == chunk_count - 1));
+        ASSERT_ARE_EQUAL(uint32_t, real_crc32c_compute(0, bytes + offset, sizes[i]), fingerprints[i]);
+        offset += sizes[i];
+    }
+    ASSERT_ARE_EQUAL(uint32_t, size, offset);
+    // the average is close to avg_chunk_size (plus the min_chunk_size bytes that are skipped)
+    ASSERT_IS_TRUE(size / chunk_count > 2048);
+    ASSERT_IS_TRUE(size / chunk_count < 8192);
+
+    /// cleanup
+    real_gballoc_hl_free(fingerprints);
+    real_gballoc_hl_free(sizes);
+    real_constbuffer_array_dec_ref(buffers);
+    real_gballoc_hl_free(bytes);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_035: [ Otherwise, constbuffer_array_splitter_cdc_iterator_next shall skip the first min_chunk_size bytes and then roll a gear hash (hash = (hash << 1) + gear_table[byte]) over the following bytes, ending the chunk after the first byte where hash & mask_small is 0 (before avg_chunk_size bytes) or hash & mask_large is 0 (after avg_chunk_size bytes), or after max_chunk_size bytes. ]*/
+TEST_FUNCTION(constbuffer_array_splitter_cdc_iterator_next_chunks_do_not_depend_on_the_buffers)
+{
+    /// arrange
+    uint32_t size = 256 * 1024;
+    unsigned char* bytes = real_gballoc_hl_malloc(size);
+    ASSERT_IS_NOT_NULL(bytes);
+    generate_pseudo_random_bytes(bytes, size, 42);
+    CONSTBUFFER_ARRAY_HANDLE buffers_1 = generate_test_buffer_array_from_bytes(bytes, size, 7);
+    CONSTBUFFER_ARRAY_HANDLE buffers_2 = generate_test_buffer_array_from_bytes(bytes, size, size);
+    uint32_t sizes_1[256];
+    uint32_t sizes_2[256];
+    uint32_t fingerprints_1[256];
+    uint32_t fingerprints_2[256];
+
+    /// act
+    uint32_t chunk_count_1 = get_all_cdc_chunks(buffers_1, 512, 2048, 8192, sizes_1, fingerprints_1, 256);
+    uint32_t chunk_count_2 = get_all_cdc_chunks(buffers_2, 512, 2048, 8192, sizes_2, fingerprints_2, 256);
+
+    /// assert
+    ASSERT_ARE_EQUAL(uint32_t, chunk_count_1, chunk_count_2);
+    for (uint32_t i = 0; i < chunk_count_1; i++)
+    {
+        ASSERT_ARE_EQUAL(uint32_t, sizes_1[i], sizes_2[i]);
+        ASSERT_ARE_EQUAL(uint32_t, fingerprints_1[i], fingerprints_2[i]);
+    }
+
+    /// cleanup
+    real_constbuffer_array_dec_ref(buffers_1);
+    real_constbuffer_array_dec_ref(buffers_2);
+    real_gballoc_hl_free(bytes);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_035: [ Otherwise, constbuffer_array_splitter_cdc_iterator_next shall skip the first min_chunk_size bytes and then roll a gear hash (hash = (hash << 1) + gear_table[byte]) over the following bytes, ending the chunk after the first byte where hash & mask_small is 0 (before avg_chunk_size bytes) or hash & mask_large is 0 (after avg_chunk_size bytes), or after max_chunk_size bytes. ]*/
+TEST_FUNCTION(constbuffer_array_splitter_cdc_iterator_next_after_inserting_a_byte_only_the_chunks_around_it_change)
+{
+    /// arrange
+    uint32_t size = 256 * 1024;
+    unsigned char* bytes = real_gballoc_hl_malloc(size + 1);
+    ASSERT_IS_NOT_NULL(bytes);
+    generate_pseudo_random_bytes(bytes, size, 42);
+    CONSTBUFFER_ARRAY_HANDLE buffers = generate_test_buffer_array_from_bytes(bytes, size, 1000);
+    (void)memmove(bytes + 50001, bytes + 50000, size - 50000);
+    bytes[50000] = 0x42;
+    CONSTBUFFER_ARRAY_HANDLE edited_buffers = generate_test_buffer_array_from_bytes(bytes, size + 1, 1000);
+    uint32_t sizes[256];
+    uint32_t edited_sizes[256];
+    uint32_t fingerprints[256];
+    uint32_t edited_fingerprints[256];
+
+    /// act
+    uint32_t chunk_count = get_all_cdc_chunks(buffers, 512, 2048, 8192, sizes, fingerprints, 256);
+    uint32_t edited_chunk_count = get_all_cdc_chunks(edited_buffers, 512, 2048, 8192, edited_sizes, edited_fingerprints, 256);
+
+    /// assert
+    uint32_t same_count = 0;
+    for (uint32_t i = 0; i < edited_chunk_count; i++)
+    {
+        for (uint32_t j = 0; j < chunk_count; j++)
+        {
+            if (edited_fingerprints[i] == fingerprints[j])
+            {
+                same_count++;
+                break;
+            }
+        }
+    }
+    ASSERT_IS_TRUE(same_count + 3 >= chunk_count, "only %" PRIu32 " chunks out of %" PRIu32 " are the same", same_count, chunk_count);
+
+    /// cleanup
+    real_constbuffer_array_dec_ref(buffers);
+    real_constbuffer_array_dec_ref(edited_buffers);
+    real_gballoc_hl_free(bytes);
+}
+
+/* constbuffer_array_splitter_split_content_defined */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_038: [ If buffers is NULL then constbuffer_array_splitter_split_content_defined shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_splitter_split_content_defined_with_NULL_buffers_fails)
+{
+    /// arrange
+    uint32_t* fingerprints;
+
+    /// act
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_splitter_split_content_defined(NULL, 4, 8, 16, &fingerprints);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(result);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_039: [ If fingerprints is NULL then constbuffer_array_splitter_split_content_defined shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_splitter_split_content_defined_with_NULL_fingerprints_fails)
+{
+    /// arrange
+    CONSTBUFFER_ARRAY_HANDLE buffers = generate_test_buffer_array(3, 10);
+    umock_c_reset_all_calls();
+
+    /// act
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_splitter_split_content_defined(buffers, 4, 8, 16, NULL);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(result);
+
+    /// cleanup
+    real_constbuffer_array_dec_ref(buffers);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_040: [ constbuffer_array_splitter_split_content_defined shall initialize a CONSTBUFFER_ARRAY_SPLITTER_CDC_ITERATOR over buffers. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_047: [ If there are any failures then constbuffer_array_splitter_split_content_defined shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_splitter_split_content_defined_with_invalid_chunk_sizes_fails)
+{
+    /// arrange
+    uint32_t* fingerprints;
+    CONSTBUFFER_ARRAY_HANDLE buffers = generate_test_buffer_array(3, 10);
+    umock_c_reset_all_calls();
+
+    /// act
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_splitter_split_content_defined(buffers, 16, 8, 4, &fingerprints);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(result);
+
+    /// cleanup
+    real_constbuffer_array_dec_ref(buffers);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_041: [ If there are no bytes in buffers then constbuffer_array_splitter_split_content_defined shall write NULL in fingerprints, call constbuffer_array_create_empty and return the result. ]*/
+TEST_FUNCTION(constbuffer_array_splitter_split_content_defined_with_all_empty_buffers_succeeds)
+{
+    /// arrange
+    uint32_t* fingerprints = (uint32_t*)0x4242;
+    CONSTBUFFER_ARRAY_HANDLE buffers = generate_test_buffer_array(3, 0);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size_64(buffers, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_create_empty());
+
+    /// act
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_splitter_split_content_defined(buffers, 4, 8, 16, &fingerprints);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_IS_NULL(fingerprints);
+
+    uint32_t buffer_count;
+    (void)real_constbuffer_array_get_buffer_count(result, &buffer_count);
+    ASSERT_ARE_EQUAL(uint32_t, 0, buffer_count);
+
+    /// cleanup
+    real_constbuffer_array_dec_ref(result);
+    real_constbuffer_array_dec_ref(buffers);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_040: [ constbuffer_array_splitter_split_content_defined shall initialize a CONSTBUFFER_ARRAY_SPLITTER_CDC_ITERATOR over buffers. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_042: [ constbuffer_array_splitter_split_content_defined shall allocate an array of CONSTBUFFER_HANDLE and an array of fingerprints for the largest possible number of chunks (total size / min_chunk_size rounded up). ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_043: [ For a chunk that lies in one buffer, constbuffer_array_splitter_split_content_defined shall get the buffer with constbuffer_array_get_buffer, call CONSTBUFFER_CreateFromOffsetAndSize for the bytes of the chunk (no copy) and call CONSTBUFFER_DecRef on the buffer. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_044: [ For a chunk that spans several buffers, constbuffer_array_splitter_split_content_defined shall call CONSTBUFFER_CreateWritableHandle with the size of the chunk, copy the bytes of the chunk in it (obtained with constbuffer_array_splitter_chunk_get_span) and call CONSTBUFFER_SealWritableHandle. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_045: [ constbuffer_array_splitter_split_content_defined shall call constbuffer_array_create_with_move_buffers with the buffers of the chunks. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_046: [ constbuffer_array_splitter_split_content_defined shall write the fingerprints of the chunks in fingerprints, succeed and return the new array. ]*/
+TEST_FUNCTION(constbuffer_array_splitter_split_content_defined_succeeds)
+{
+    /// arrange
+    // chunks of 8 bytes over 3 buffers of 10 bytes: [0..8) and [24..30) are inside one buffer, the other 2 span 2 buffers
+    uint32_t* fingerprints;
+    CONSTBUFFER_ARRAY_HANDLE buffers = generate_test_buffer_array(3, 10);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size_64(buffers, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 0));
+    STRICT_EXPECTED_CALL(malloc_2(4, sizeof(CONSTBUFFER_HANDLE)));
+    STRICT_EXPECTED_CALL(malloc_2(4, sizeof(uint32_t)));
+
+    STRICT_EXPECTED_CALL(crc32c_compute(0, IGNORED_ARG, 8));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer(buffers, 0));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_CreateFromOffsetAndSize(IGNORED_ARG, 0, 8));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_DecRef(IGNORED_ARG));
+
+    STRICT_EXPECTED_CALL(crc32c_compute(0, IGNORED_ARG, 2));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 1));
+    STRICT_EXPECTED_CALL(crc32c_compute(IGNORED_ARG, IGNORED_ARG, 6));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_CreateWritableHandle(8));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetWritableBuffer(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 0));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_SealWritableHandle(IGNORED_ARG));
+
+    STRICT_EXPECTED_CALL(crc32c_compute(0, IGNORED_ARG, 4));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 2));
+    STRICT_EXPECTED_CALL(crc32c_compute(IGNORED_ARG, IGNORED_ARG, 4));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_CreateWritableHandle(8));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetWritableBuffer(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 1));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_SealWritableHandle(IGNORED_ARG));
+
+    STRICT_EXPECTED_CALL(crc32c_compute(0, IGNORED_ARG, 6));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer(buffers, 2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_CreateFromOffsetAndSize(IGNORED_ARG, 4, 6));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_DecRef(IGNORED_ARG));
+
+    STRICT_EXPECTED_CALL(constbuffer_array_create_with_move_buffers(IGNORED_ARG, 4));
+
+    /// act
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_splitter_split_content_defined(buffers, 8, 8, 8, &fingerprints);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_IS_NOT_NULL(fingerprints);
+
+    uint32_t buffer_count;
+    (void)real_constbuffer_array_get_buffer_count(result, &buffer_count);
+    ASSERT_ARE_EQUAL(uint32_t, 4, buffer_count);
+
+    // the chunks inside one buffer are not copied
+    ASSERT_ARE_EQUAL(void_ptr, real_constbuffer_array_get_buffer_content(buffers, 0)->buffer, real_constbuffer_array_get_buffer_content(result, 0)->buffer);
+    ASSERT_ARE_EQUAL(void_ptr, real_constbuffer_array_get_buffer_content(buffers, 2)->buffer + 4, real_constbuffer_array_get_buffer_content(result, 3)->buffer);
+
+    for (uint32_t i = 0; i < buffer_count; i++)
+    {
+        const CONSTBUFFER* content = real_constbuffer_array_get_buffer_content(result, i);
+        ASSERT_ARE_EQUAL(uint32_t, (i == 3) ? 6 : 8, content->size);
+        for (uint32_t j = 0; j < content->size; j++)
+        {
+            ASSERT_ARE_EQUAL(uint8_t, ('a' + (i * 8 + j) / 10) % ('z' - 'a'), content->buffer[j]);
+        }
+        ASSERT_ARE_EQUAL(uint32_t, real_crc32c_compute(0, content->buffer, content->size), fingerprints[i]);
+    }
+
+    /// cleanup
+    real_gballoc_hl_free(fingerprints);
+    real_constbuffer_array_dec_ref(result);
+    real_constbuffer_array_dec_ref(buffers);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_042: [ constbuffer_array_splitter_split_content_defined shall allocate an array of CONSTBUFFER_HANDLE and an array of fingerprints for the largest possible number of chunks (total size / min_chunk_size rounded up). ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_048: [ If there are fewer chunks than the largest possible number of chunks then constbuffer_array_splitter_split_content_defined shall call realloc_2 to give back the memory of the array of CONSTBUFFER_HANDLE that was not used (the array is moved in the new CONSTBUFFER_ARRAY_HANDLE). If realloc_2 fails then constbuffer_array_splitter_split_content_defined shall keep the array allocated initially. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_046: [ constbuffer_array_splitter_split_content_defined shall write the fingerprints of the chunks in fingerprints, succeed and return the new array. ]*/
+TEST_FUNCTION(constbuffer_array_splitter_split_content_defined_gives_back_the_handles_that_were_not_used)
+{
+    /// arrange
+    // with min_chunk_size 8 there can be 4 chunks in 30 bytes, the cut points of these bytes make 2 chunks (19 and 11 bytes) that both span 2 buffers
+    uint32_t* fingerprints;
+    CONSTBUFFER_ARRAY_HANDLE buffers = generate_test_buffer_array(3, 10);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size_64(buffers, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 0));
+    STRICT_EXPECTED_CALL(malloc_2(4, sizeof(CONSTBUFFER_HANDLE)));
+    STRICT_EXPECTED_CALL(malloc_2(4, sizeof(uint32_t)));
+
+    STRICT_EXPECTED_CALL(crc32c_compute(0, IGNORED_ARG, 10));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 1));
+    STRICT_EXPECTED_CALL(crc32c_compute(IGNORED_ARG, IGNORED_ARG, 9));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_CreateWritableHandle(19));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetWritableBuffer(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 0));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_SealWritableHandle(IGNORED_ARG));
+
+    STRICT_EXPECTED_CALL(crc32c_compute(0, IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 2));
+    STRICT_EXPECTED_CALL(crc32c_compute(IGNORED_ARG, IGNORED_ARG, 10));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_CreateWritableHandle(11));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetWritableBuffer(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 1));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_SealWritableHandle(IGNORED_ARG));
+
+    STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, 2, sizeof(CONSTBUFFER_HANDLE)));
+    STRICT_EXPECTED_CALL(constbuffer_array_create_with_move_buffers(IGNORED_ARG, 2));
+
+    /// act
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_splitter_split_content_defined(buffers, 8, 16, 32, &fingerprints);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_IS_NOT_NULL(fingerprints);
+
+    uint32_t buffer_count;
+    (void)real_constbuffer_array_get_buffer_count(result, &buffer_count);
+    ASSERT_ARE_EQUAL(uint32_t, 2, buffer_count);
+    ASSERT_ARE_EQUAL(uint32_t, 19, real_constbuffer_array_get_buffer_content(result, 0)->size);
+    ASSERT_ARE_EQUAL(uint32_t, 11, real_constbuffer_array_get_buffer_content(result, 1)->size);
+    for (uint32_t i = 0; i < buffer_count; i++)
+    {
+        const CONSTBUFFER* content = real_constbuffer_array_get_buffer_content(result, i);
+        ASSERT_ARE_EQUAL(uint32_t, real_crc32c_compute(0, content->buffer, content->size), fingerprints[i]);
+    }
+
+    /// cleanup
+    real_gballoc_hl_free(fingerprints);
+    real_constbuffer_array_dec_ref(result);
+    real_constbuffer_array_dec_ref(buffers);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_042: [ constbuffer_array_splitter_split_content_defined shall allocate an array of CONSTBUFFER_HANDLE and an array of fingerprints for the largest possible number of chunks (total size / min_chunk_size rounded up). ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_048: [ If there are fewer chunks than the largest possible number of chunks then constbuffer_array_splitter_split_content_defined shall call realloc_2 to give back the memory of the array of CONSTBUFFER_HANDLE that was not used (the array is moved in the new CONSTBUFFER_ARRAY_HANDLE). If realloc_2 fails then constbuffer_array_splitter_split_content_defined shall keep the array allocated initially. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_046: [ constbuffer_array_splitter_split_content_defined shall write the fingerprints of the chunks in fingerprints, succeed and return the new array. ]*/
+TEST_FUNCTION(constbuffer_array_splitter_split_content_defined_when_realloc_2_fails_keeps_the_handles_allocated_initially)
+{
+    /// arrange
+    // same chunks as constbuffer_array_splitter_split_content_defined_gives_back_the_handles_that_were_not_used, failing to shrink the array of 4 handles is not an error
+    uint32_t* fingerprints;
+    CONSTBUFFER_ARRAY_HANDLE buffers = generate_test_buffer_array(3, 10);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size_64(buffers, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 0));
+    STRICT_EXPECTED_CALL(malloc_2(4, sizeof(CONSTBUFFER_HANDLE)));
+    STRICT_EXPECTED_CALL(malloc_2(4, sizeof(uint32_t)));
+
+    STRICT_EXPECTED_CALL(crc32c_compute(0, IGNORED_ARG, 10));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 1));
+    STRICT_EXPECTED_CALL(crc32c_compute(IGNORED_ARG, IGNORED_ARG, 9));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_CreateWritableHandle(19));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetWritableBuffer(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 0));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_SealWritableHandle(IGNORED_ARG));
+
+    STRICT_EXPECTED_CALL(crc32c_compute(0, IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 2));
+    STRICT_EXPECTED_CALL(crc32c_compute(IGNORED_ARG, IGNORED_ARG, 10));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_CreateWritableHandle(11));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetWritableBuffer(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 1));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_SealWritableHandle(IGNORED_ARG));
+
+    STRICT_EXPECTED_CALL(realloc_2(IGNORED_ARG, 2, sizeof(CONSTBUFFER_HANDLE)))
+        .SetReturn(NULL);
+    STRICT_EXPECTED_CALL(constbuffer_array_create_with_move_buffers(IGNORED_ARG, 2));
+
+    /// act
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_splitter_split_content_defined(buffers, 8, 16, 32, &fingerprints);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_IS_NOT_NULL(fingerprints);
+
+    uint32_t buffer_count;
+    (void)real_constbuffer_array_get_buffer_count(result, &buffer_count);
+    ASSERT_ARE_EQUAL(uint32_t, 2, buffer_count);
+    ASSERT_ARE_EQUAL(uint32_t, 19, real_constbuffer_array_get_buffer_content(result, 0)->size);
+    ASSERT_ARE_EQUAL(uint32_t, 11, real_constbuffer_array_get_buffer_content(result, 1)->size);
+    for (uint32_t i = 0; i < buffer_count; i++)
+    {
+        const CONSTBUFFER* content = real_constbuffer_array_get_buffer_content(result, i);
+        ASSERT_ARE_EQUAL(uint32_t, real_crc32c_compute(0, content->buffer, content->size), fingerprints[i]);
+    }
+
+    /// cleanup
+    real_gballoc_hl_free(fingerprints);
+    real_constbuffer_array_dec_ref(result);
+    real_constbuffer_array_dec_ref(buffers);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_SPLITTER_12_047: [ If there are any failures then constbuffer_array_splitter_split_content_defined shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_splitter_split_content_defined_fails_when_underlying_functions_fail)
+{
+    /// arrange
+    uint32_t* fingerprints;
+    CONSTBUFFER_ARRAY_HANDLE buffers = generate_test_buffer_array(3, 10);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(constbuffer_array_get_all_buffers_size_64(buffers, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 0))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(malloc_2(4, sizeof(CONSTBUFFER_HANDLE)));
+    STRICT_EXPECTED_CALL(malloc_2(4, sizeof(uint32_t)));
+
+    STRICT_EXPECTED_CALL(crc32c_compute(0, IGNORED_ARG, 8))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer(buffers, 0))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(CONSTBUFFER_CreateFromOffsetAndSize(IGNORED_ARG, 0, 8));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_DecRef(IGNORED_ARG))
+        .CallCannotFail();
+
+    STRICT_EXPECTED_CALL(crc32c_compute(0, IGNORED_ARG, 2))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 1))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(crc32c_compute(IGNORED_ARG, IGNORED_ARG, 6))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(CONSTBUFFER_CreateWritableHandle(8));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetWritableBuffer(IGNORED_ARG))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 0))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 1))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(CONSTBUFFER_SealWritableHandle(IGNORED_ARG))
+        .CallCannotFail();
+
+    STRICT_EXPECTED_CALL(crc32c_compute(0, IGNORED_ARG, 4))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 2))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(crc32c_compute(IGNORED_ARG, IGNORED_ARG, 4))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(CONSTBUFFER_CreateWritableHandle(8));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetWritableBuffer(IGNORED_ARG))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 1))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer_content(buffers, 2))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(CONSTBUFFER_SealWritableHandle(IGNORED_ARG))
+        .CallCannotFail();
+
+    STRICT_EXPECTED_CALL(crc32c_compute(0, IGNORED_ARG, 6))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(constbuffer_array_get_buffer(buffers, 2))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(CONSTBUFFER_CreateFromOffsetAndSize(IGNORED_ARG, 4, 6));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_DecRef(IGNORED_ARG))
+        .CallCannotFail();
+
+    STRICT_EXPECTED_CALL(constbuffer_array_create_with_move_buffers(IGNORED_ARG, 4));
+
+    umock_c_negative_tests_snapshot();
+
+    for (size_t i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
+        if (umock_c_negative_tests_can_call_fail(i))
+        {
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(i);
+
+            /// act
+            CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_splitter_split_content_defined(buffers, 8, 8, 8, &fingerprints);
+
+            ///assert
+            ASSERT_IS_NULL(result, "On failed call %zu", i);
+        }
+    }
+
+    /// cleanup
+    real_constbuffer_array_dec_ref(buffers);
+}
+
 END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
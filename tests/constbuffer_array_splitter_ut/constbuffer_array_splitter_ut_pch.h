@@ -7,6 +7,7 @@
 
 #include <stdlib.h>
 #include <inttypes.h>
+#include <string.h>
 
 #include "macro_utils/macro_utils.h"
 
@@ -25,6 +26,7 @@
 #include "c_util/constbuffer.h"
 #include "c_util/constbuffer_array.h"
 #include "c_util/constbuffer_array_tarray.h"
+#include "c_util/crc32c.h"
 #include "umock_c/umock_c_DISABLE_MOCKS.h" // ============================== DISABLE_MOCKS
 
 #include "real_gballoc_hl.h"
@@ -32,6 +34,7 @@
 #include "../reals/real_constbuffer.h"
 #include "../reals/real_constbuffer_array.h"
 #include "../reals/real_constbuffer_array_tarray.h"
+#include "../reals/real_crc32c.h"
 
 #include "c_util/constbuffer_array_splitter.h"
 
@@ -6,6 +6,8 @@
 
 MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
 
+TEST_DEFINE_ENUM_TYPE(CONSTBUFFER_ARRAY_FIND_RESULT, CONSTBUFFER_ARRAY_FIND_RESULT_VALUES);
+
 static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
 {
     ASSERT_FAIL("umock_c reported error :%" PRI_MU_ENUM "", MU_ENUM_VALUE(UMOCK_C_ERROR_CODE, error_code));
@@ -32,13 +34,18 @@ static void constbuffer_array_create_empty_inert_path(void)
         .CallCannotFail();
 }
 
-static void constbuffer_array_create_from_buffer_index_and_count_inert_path(void)
+static void constbuffer_array_create_from_buffer_index_and_count_inert_path(uint32_t buffer_count)
 {
     STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
     STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1))
         .CallCannotFail();
     STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG))
         .CallCannotFail();
+    for (uint32_t i = 0; i < buffer_count; i++)
+    {
+        STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(IGNORED_ARG))
+            .CallCannotFail();
+    }
 }
 
 static void constbuffer_array_create_from_buffer_offset_and_count_inert_path(uint32_t nBuffers, uint32_t start_offset, uint32_t start_size, uint32_t end_offset, uint32_t end_size)
@@ -55,6 +62,8 @@ static void constbuffer_array_create_from_buffer_offset_and_count_inert_path(uin
     for (uint32_t i = 0; i < nBuffers; i++)
     {
         STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(IGNORED_ARG));
+        STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(IGNORED_ARG))
+            .CallCannotFail();
     }
 }
 
@@ -64,6 +73,10 @@ static void constbuffer_array_add_front_inert_path(void)
     STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1))
         .CallCannotFail();
     STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_1));
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1))
+        .CallCannotFail();
 }
 
 static void constbuffer_array_add_back_inert_path(void)
@@ -72,6 +85,10 @@ static void constbuffer_array_add_back_inert_path(void)
     STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1))
         .CallCannotFail();
     STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_1));
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1))
+        .CallCannotFail();
 }
 
 static void constbuffer_array_remove_front_inert_path(uint32_t nExistingItems)
@@ -89,6 +106,10 @@ static void constbuffer_array_remove_front_inert_path(uint32_t nExistingItems)
             STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(IGNORED_ARG));
         }
     }
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(IGNORED_ARG))
+        .CallCannotFail();
 }
 
 static void constbuffer_array_remove_back_inert_path(uint32_t nExistingItems)
@@ -106,6 +127,10 @@ static void constbuffer_array_remove_back_inert_path(uint32_t nExistingItems)
             STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(IGNORED_ARG));
         }
     }
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(IGNORED_ARG))
+        .CallCannotFail();
 }
 
 static CONSTBUFFER_ARRAY_HANDLE TEST_constbuffer_array_create_empty(void)
@@ -137,6 +162,60 @@ static CONSTBUFFER_ARRAY_HANDLE TEST_constbuffer_array_create(uint32_t size, uin
     return result;
 }
 
+/*creates an array that does not know its total size (constbuffer_array_create_with_move_buffers does not look at the buffers)*/
+static CONSTBUFFER_ARRAY_HANDLE TEST_constbuffer_array_create_with_move_buffers(uint32_t size, uint32_t start_buffer)
+{
+    CONSTBUFFER_HANDLE all_buffers[6];
+    CONSTBUFFER_HANDLE* buffers = real_gballoc_hl_malloc_2(size, sizeof(CONSTBUFFER_HANDLE));
+    CONSTBUFFER_ARRAY_HANDLE result;
+    ASSERT_IS_NOT_NULL(buffers);
+
+    all_buffers[0] = TEST_CONSTBUFFER_HANDLE_1;
+    all_buffers[1] = TEST_CONSTBUFFER_HANDLE_2;
+    all_buffers[2] = TEST_CONSTBUFFER_HANDLE_3;
+    all_buffers[3] = TEST_CONSTBUFFER_HANDLE_4;
+    all_buffers[4] = TEST_CONSTBUFFER_HANDLE_5;
+    all_buffers[5] = TEST_CONSTBUFFER_HANDLE_6;
+
+    for (uint32_t i = 0; i < size; i++)
+    {
+        real_CONSTBUFFER_IncRef(all_buffers[start_buffer + i]);
+        buffers[i] = all_buffers[start_buffer + i];
+    }
+
+    result = constbuffer_array_create_with_move_buffers(buffers, size);
+    ASSERT_IS_NOT_NULL(result);
+
+    umock_c_reset_all_calls();
+    return result;
+}
+
+/*creates an array with the bytes of content split in buffers of split_sizes[0], split_sizes[1]... bytes*/
+static CONSTBUFFER_ARRAY_HANDLE TEST_constbuffer_array_create_split(const unsigned char* content, const uint32_t* split_sizes, uint32_t split_count)
+{
+    CONSTBUFFER_HANDLE buffers[8];
+    CONSTBUFFER_ARRAY_HANDLE result;
+    ASSERT_IS_TRUE(split_count <= sizeof(buffers) / sizeof(buffers[0]));
+
+    for (uint32_t i = 0; i < split_count; i++)
+    {
+        buffers[i] = real_CONSTBUFFER_Create(content, split_sizes[i]);
+        ASSERT_IS_NOT_NULL(buffers[i]);
+        content += split_sizes[i];
+    }
+
+    result = constbuffer_array_create(buffers, split_count);
+    ASSERT_IS_NOT_NULL(result);
+
+    for (uint32_t i = 0; i < split_count; i++)
+    {
+        real_CONSTBUFFER_DecRef(buffers[i]);
+    }
+
+    umock_c_reset_all_calls();
+    return result;
+}
+
 static CONSTBUFFER_ARRAY_HANDLE TEST_constbuffer_array_add_front(CONSTBUFFER_ARRAY_HANDLE constbuffer_array, uint32_t nExistingBuffers, CONSTBUFFER_HANDLE constbuffer_handle)
 {
     uint32_t i;
@@ -171,6 +250,34 @@ static CONSTBUFFER_ARRAY_HANDLE TEST_constbuffer_array_add_back(CONSTBUFFER_ARRA
     return result;
 }
 
+/*adds constbuffer_handle in front of the buffers of constbuffer_array as if constbuffer_array had fake_total_size bytes (the total size of constbuffer_array is only read when the new array is created)*/
+static CONSTBUFFER_ARRAY_HANDLE TEST_constbuffer_array_add_front_with_fake_total_size(CONSTBUFFER_ARRAY_HANDLE constbuffer_array, CONSTBUFFER_HANDLE constbuffer_handle, int64_t fake_total_size)
+{
+    CONSTBUFFER_ARRAY_HANDLE result;
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0))
+        .SetReturn(fake_total_size);
+
+    result = constbuffer_array_add_front(constbuffer_array, constbuffer_handle);
+    ASSERT_IS_NOT_NULL(result);
+    umock_c_reset_all_calls();
+    return result;
+}
+
+/*adds constbuffer_handle after the buffers of constbuffer_array as if constbuffer_array had fake_total_size bytes (the total size of constbuffer_array is only read when the new array is created)*/
+static CONSTBUFFER_ARRAY_HANDLE TEST_constbuffer_array_add_back_with_fake_total_size(CONSTBUFFER_ARRAY_HANDLE constbuffer_array, CONSTBUFFER_HANDLE constbuffer_handle, int64_t fake_total_size)
+{
+    CONSTBUFFER_ARRAY_HANDLE result;
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0))
+        .SetReturn(fake_total_size);
+
+    result = constbuffer_array_add_back(constbuffer_array, constbuffer_handle);
+    ASSERT_IS_NOT_NULL(result);
+    umock_c_reset_all_calls();
+    return result;
+}
+
 static CONSTBUFFER_ARRAY_HANDLE TEST_constbuffer_array_remove_front(CONSTBUFFER_ARRAY_HANDLE constbuffer_array, uint32_t nExistingBuffers, CONSTBUFFER_HANDLE* constbuffer_handle)
 {
     uint32_t i;
@@ -222,7 +329,7 @@ static void TEST_constbuffer_array_dec_ref(CONSTBUFFER_ARRAY_HANDLE constbuffer_
 
 /* constbuffer_array_create_from_array_array */
 
-static void constbuffer_array_create_from_array_array_inert_path(uint32_t existing_item_count)
+static void constbuffer_array_create_from_array_array_inert_path(uint32_t array_count, uint32_t existing_item_count)
 {
     STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, existing_item_count, sizeof(CONSTBUFFER_HANDLE)));
     STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1))
@@ -231,6 +338,11 @@ static void constbuffer_array_create_from_array_array_inert_path(uint32_t existi
     {
         STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(IGNORED_ARG));
     }
+    for (uint32_t i = 0; i < array_count; i++)
+    {
+        STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0))
+            .CallCannotFail();
+    }
 }
 
 static void validate_sorted_constbuffer_array(CONSTBUFFER_ARRAY_HANDLE constbuffer_array, uint32_t size)
@@ -285,11 +397,22 @@ TEST_SUITE_INITIALIZE(suite_init)
     REGISTER_UMOCK_ALIAS_TYPE(CONSTBUFFER_HANDLE, void*);
 
     REGISTER_GLOBAL_MOCK_FAIL_RETURN(CONSTBUFFER_GetContent, NULL);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(CONSTBUFFER_CreateCompressed, NULL);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(CONSTBUFFER_Decompress, NULL);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(CONSTBUFFER_Create, NULL);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(CONSTBUFFER_CreateWithMoveMemory, NULL);
 
     REGISTER_GBALLOC_HL_GLOBAL_MOCK_HOOK();
     REGISTER_GLOBAL_MOCK_FAIL_RETURN(malloc, NULL);
 
     REGISTER_INTERLOCKED_GLOBAL_MOCK_HOOK();
+
+    REGISTER_HASH_GLOBAL_MOCK_HOOK();
+    REGISTER_UMOCK_ALIAS_TYPE(HASH_STATE*, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(const HASH_STATE*, void*);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(hash_init, MU_FAILURE);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(hash_update, MU_FAILURE);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(hash_final, MU_FAILURE);
 }
 
 TEST_SUITE_CLEANUP(suite_cleanup)
@@ -339,6 +462,7 @@ TEST_FUNCTION_CLEANUP(method_cleanup)
 /* Tests_SRS_CONSTBUFFER_ARRAY_01_009: [ constbuffer_array_create shall allocate memory for a new CONSTBUFFER_ARRAY_HANDLE that can hold buffer_count buffers. ]*/
 /* Tests_SRS_CONSTBUFFER_ARRAY_01_010: [ constbuffer_array_create shall clone the buffers in buffers and store them. ]*/
 /* Tests_SRS_CONSTBUFFER_ARRAY_01_011: [ On success constbuffer_array_create shall return a non-NULL handle. ]*/
+/* Tests_SRS_CONSTBUFFER_ARRAY_12_078: [ constbuffer_array_create shall store the sum of the sizes of the buffers (obtained by calling CONSTBUFFER_GetContent while cloning them) as the total size of the new array. ]*/
 TEST_FUNCTION(constbuffer_array_create_succeeds)
 {
     ///arrange
@@ -351,7 +475,9 @@ TEST_FUNCTION(constbuffer_array_create_succeeds)
     STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(test_buffers) / sizeof(test_buffers[0]), sizeof(CONSTBUFFER_HANDLE)));
     STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1));
     STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1));
     STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2));
 
     ///act
     constbuffer_array = constbuffer_array_create(test_buffers, sizeof(test_buffers) / sizeof(test_buffers[0]));
@@ -364,6 +490,27 @@ TEST_FUNCTION(constbuffer_array_create_succeeds)
     constbuffer_array_dec_ref(constbuffer_array);
 }
 
+/* Tests_SRS_CONSTBUFFER_ARRAY_12_078: [ constbuffer_array_create shall store the sum of the sizes of the buffers (obtained by calling CONSTBUFFER_GetContent while cloning them) as the total size of the new array. ]*/
+TEST_FUNCTION(constbuffer_array_create_knows_the_total_size)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = TEST_constbuffer_array_create(3, 1);
+    uint64_t all_buffers_size;
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); /*no buffer is read*/
+
+    ///act
+    int result = constbuffer_array_get_all_buffers_size_64(constbuffer_array, &all_buffers_size);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint64_t, 2 + 3 + 4, all_buffers_size);
+
+    ///clean
+    constbuffer_array_dec_ref(constbuffer_array);
+}
+
 /* Tests_SRS_CONSTBUFFER_ARRAY_01_012: [ If buffers is NULL and buffer_count is not 0, constbuffer_array_create shall fail and return NULL. ]*/
 TEST_FUNCTION(constbuffer_array_create_with_NULL_buffers_fails)
 {
@@ -419,7 +566,11 @@ TEST_FUNCTION(when_underlying_calls_fail_constbuffer_array_create_fails)
 
     STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(test_buffers) / sizeof(test_buffers[0]), sizeof(CONSTBUFFER_HANDLE)));
     STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1))
+        .CallCannotFail();
     STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2))
+        .CallCannotFail();
 
     umock_c_negative_tests_snapshot();
     for (i = 0; i < umock_c_negative_tests_call_count(); i++)
@@ -616,6 +767,7 @@ TEST_FUNCTION(constbuffer_array_create_from_buffer_index_and_count_with_start_bu
 /*Tests_SRS_CONSTBUFFER_ARRAY_42_013: [ constbuffer_array_create_from_buffer_index_and_count shall allocate memory for a new CONSTBUFFER_ARRAY_HANDLE. ]*/
 /*Tests_SRS_CONSTBUFFER_ARRAY_42_014: [ constbuffer_array_create_from_buffer_index_and_count shall increment the reference count on original. ]*/
 /*Tests_SRS_CONSTBUFFER_ARRAY_42_015: [ constbuffer_array_create_from_buffer_index_and_count shall return a non-NULL handle. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_079: [ constbuffer_array_create_from_buffer_index_and_count shall store the sum of the sizes of the buffer_count buffers starting at start_buffer_index (obtained by calling CONSTBUFFER_GetContent) as the total size of the new array. ]*/
 TEST_FUNCTION(constbuffer_array_create_from_buffer_index_and_count_succeeds_full_array)
 {
     // arrange
@@ -630,7 +782,7 @@ TEST_FUNCTION(constbuffer_array_create_from_buffer_index_and_count_succeeds_full
     original = constbuffer_array_create(test_buffers, sizeof(test_buffers) / sizeof(test_buffers[0]));
     umock_c_reset_all_calls();
 
-    constbuffer_array_create_from_buffer_index_and_count_inert_path();
+    constbuffer_array_create_from_buffer_index_and_count_inert_path(3);
 
     // act
     constbuffer_array = constbuffer_array_create_from_buffer_index_and_count(original, 0, 3);
@@ -670,7 +822,7 @@ TEST_FUNCTION(constbuffer_array_create_from_buffer_index_and_count_succeeds_midd
     original = constbuffer_array_create(test_buffers, sizeof(test_buffers) / sizeof(test_buffers[0]));
     umock_c_reset_all_calls();
 
-    constbuffer_array_create_from_buffer_index_and_count_inert_path();
+    constbuffer_array_create_from_buffer_index_and_count_inert_path(2);
 
     // act
     constbuffer_array = constbuffer_array_create_from_buffer_index_and_count(original, 1, 2);
@@ -709,7 +861,7 @@ TEST_FUNCTION(constbuffer_array_create_from_buffer_index_and_count_succeeds_0_bu
     original = constbuffer_array_create(test_buffers, sizeof(test_buffers) / sizeof(test_buffers[0]));
     umock_c_reset_all_calls();
 
-    constbuffer_array_create_from_buffer_index_and_count_inert_path();
+    constbuffer_array_create_from_buffer_index_and_count_inert_path(0);
 
     // act
     constbuffer_array = constbuffer_array_create_from_buffer_index_and_count(original, 2, 0);
@@ -745,7 +897,7 @@ TEST_FUNCTION(constbuffer_array_create_from_buffer_index_and_count_succeeds_0_bu
     original = constbuffer_array_create(test_buffers, sizeof(test_buffers) / sizeof(test_buffers[0]));
     umock_c_reset_all_calls();
 
-    constbuffer_array_create_from_buffer_index_and_count_inert_path();
+    constbuffer_array_create_from_buffer_index_and_count_inert_path(0);
 
     // act
     constbuffer_array = constbuffer_array_create_from_buffer_index_and_count(original, 3, 0);
@@ -783,9 +935,9 @@ TEST_FUNCTION(constbuffer_array_create_from_buffer_index_and_count_succeeds_when
     original = constbuffer_array_create(test_buffers, sizeof(test_buffers) / sizeof(test_buffers[0]));
     umock_c_reset_all_calls();
 
-    constbuffer_array_create_from_buffer_index_and_count_inert_path();
-    constbuffer_array_create_from_buffer_index_and_count_inert_path();
-    constbuffer_array_create_from_buffer_index_and_count_inert_path();
+    constbuffer_array_create_from_buffer_index_and_count_inert_path(3);
+    constbuffer_array_create_from_buffer_index_and_count_inert_path(2);
+    constbuffer_array_create_from_buffer_index_and_count_inert_path(1);
 
     // act
     constbuffer_array_1_2_3 = constbuffer_array_create_from_buffer_index_and_count(original, 0, 3);
@@ -826,6 +978,31 @@ TEST_FUNCTION(constbuffer_array_create_from_buffer_index_and_count_succeeds_when
     constbuffer_array_dec_ref(constbuffer_array_2);
 }
 
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_079: [ constbuffer_array_create_from_buffer_index_and_count shall store the sum of the sizes of the buffer_count buffers starting at start_buffer_index (obtained by calling CONSTBUFFER_GetContent) as the total size of the new array. ]*/
+TEST_FUNCTION(constbuffer_array_create_from_buffer_index_and_count_knows_the_total_size)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE original = TEST_constbuffer_array_create(4, 0);
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = constbuffer_array_create_from_buffer_index_and_count(original, 1, 2);
+    ASSERT_IS_NOT_NULL(constbuffer_array);
+    uint64_t all_buffers_size;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); /*no buffer is read*/
+
+    // act
+    int result = constbuffer_array_get_all_buffers_size_64(constbuffer_array, &all_buffers_size);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint64_t, 2 + 3, all_buffers_size);
+
+    // cleanup
+    constbuffer_array_dec_ref(original);
+    constbuffer_array_dec_ref(constbuffer_array);
+}
+
 /*Tests_SRS_CONSTBUFFER_ARRAY_42_016: [ If any error occurs then constbuffer_array_create_from_buffer_index_and_count shall fail and return NULL. ]*/
 TEST_FUNCTION(constbuffer_array_create_from_buffer_index_and_count_fails_when_underlying_functions_fail)
 {
@@ -842,7 +1019,7 @@ TEST_FUNCTION(constbuffer_array_create_from_buffer_index_and_count_fails_when_un
     original = constbuffer_array_create(test_buffers, sizeof(test_buffers) / sizeof(test_buffers[0]));
     umock_c_reset_all_calls();
 
-    constbuffer_array_create_from_buffer_index_and_count_inert_path();
+    constbuffer_array_create_from_buffer_index_and_count_inert_path(2);
 
     umock_c_negative_tests_snapshot();
     for (i = 0; i < umock_c_negative_tests_call_count(); i++)
@@ -1357,6 +1534,64 @@ TEST_FUNCTION(constbuffer_array_create_from_buffer_index_and_count_succeeds_when
     constbuffer_array_dec_ref(constbuffer_array);
 }
 
+/* Tests_SRS_CONSTBUFFER_ARRAY_12_077: [ constbuffer_array_create_from_buffer_offset_and_count shall store the size of the start buffer plus the sizes of the buffers between the start and end buffers (obtained by calling CONSTBUFFER_GetContent while copying them) plus end_buffer_offset as the total size of the new array. ]*/
+TEST_FUNCTION(constbuffer_array_create_from_buffer_offset_and_count_with_2_buffers_knows_the_total_size)
+{
+    // arrange
+    CONSTBUFFER_HANDLE test_buffers[3];
+    CONSTBUFFER_ARRAY_HANDLE original;
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array;
+    uint64_t all_buffers_size;
+
+    test_buffers[0] = TEST_CONSTBUFFER_HANDLE_2;
+    test_buffers[1] = TEST_CONSTBUFFER_HANDLE_3;
+    test_buffers[2] = TEST_CONSTBUFFER_HANDLE_4;
+
+    original = constbuffer_array_create(test_buffers, sizeof(test_buffers) / sizeof(test_buffers[0]));
+    constbuffer_array = constbuffer_array_create_from_buffer_offset_and_count(original, 1, 2, 1, 2);
+    ASSERT_IS_NOT_NULL(constbuffer_array);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); /*no buffer is read*/
+
+    // act
+    int result = constbuffer_array_get_all_buffers_size_64(constbuffer_array, &all_buffers_size);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint64_t, 2 + 2, all_buffers_size);
+
+    // cleanup
+    constbuffer_array_dec_ref(original);
+    constbuffer_array_dec_ref(constbuffer_array);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_12_077: [ constbuffer_array_create_from_buffer_offset_and_count shall store the size of the start buffer plus the sizes of the buffers between the start and end buffers (obtained by calling CONSTBUFFER_GetContent while copying them) plus end_buffer_offset as the total size of the new array. ]*/
+TEST_FUNCTION(constbuffer_array_create_from_buffer_offset_and_count_with_4_buffers_knows_the_total_size)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE original = TEST_constbuffer_array_create(5, 1);
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = constbuffer_array_create_from_buffer_offset_and_count(original, 0, 4, 1, 3);
+    ASSERT_IS_NOT_NULL(constbuffer_array);
+    uint64_t all_buffers_size;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); /*no buffer is read*/
+
+    // act
+    int result = constbuffer_array_get_all_buffers_size_64(constbuffer_array, &all_buffers_size);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint64_t, 1 + 3 + 4 + 3, all_buffers_size);
+
+    // cleanup
+    constbuffer_array_dec_ref(original);
+    constbuffer_array_dec_ref(constbuffer_array);
+}
+
 /* Tests_SRS_CONSTBUFFER_ARRAY_07_007: [ constbuffer_array_create_from_buffer_offset_and_count shall allocate memory for a new CONSTBUFFER_ARRAY_HANDLE. ]*/
 /* Tests_SRS_CONSTBUFFER_ARRAY_07_011: [ constbuffer_array_create_from_buffer_offset_and_count shall compute the start buffer size. ]*/
 /* Tests_SRS_CONSTBUFFER_ARRAY_07_005: [ constbuffer_array_create_from_buffer_offset_and_count shall get the start buffer by calling CONSTBUFFER_CreateFromOffsetAndSize. ]*/
@@ -1571,7 +1806,7 @@ TEST_FUNCTION(constbuffer_array_create_from_array_array_with_two_empty_arrays_su
     buffer_array[0] = TEST_constbuffer_array_create_empty();
     buffer_array[1] = TEST_constbuffer_array_create_empty();
 
-    constbuffer_array_create_from_array_array_inert_path(0);
+    constbuffer_array_create_from_array_array_inert_path(array_count, 0);
 
     ///act
     result = constbuffer_array_create_from_array_array(buffer_array, array_count);
@@ -1601,7 +1836,7 @@ TEST_FUNCTION(constbuffer_array_create_from_array_array_with_three_empty_arrays_
     buffer_array[1] = TEST_constbuffer_array_create_empty();
     buffer_array[2] = TEST_constbuffer_array_create_empty();
 
-    constbuffer_array_create_from_array_array_inert_path(0);
+    constbuffer_array_create_from_array_array_inert_path(array_count, 0);
 
     ///act
     result = constbuffer_array_create_from_array_array(buffer_array, array_count);
@@ -1632,7 +1867,7 @@ TEST_FUNCTION(constbuffer_array_create_from_array_array_with_empty_array_and_1_e
     buffer_array[0] = TEST_constbuffer_array_create_empty();
     buffer_array[1] = TEST_constbuffer_array_create(1, 0);
 
-    constbuffer_array_create_from_array_array_inert_path(1);
+    constbuffer_array_create_from_array_array_inert_path(array_count, 1);
 
     ///act
     result = constbuffer_array_create_from_array_array(buffer_array, array_count);
@@ -1663,7 +1898,7 @@ TEST_FUNCTION(constbuffer_array_create_from_array_array_with_1_element_array_and
     buffer_array[0] = TEST_constbuffer_array_create(1, 0);
     buffer_array[1] = TEST_constbuffer_array_create_empty();
 
-    constbuffer_array_create_from_array_array_inert_path(1);
+    constbuffer_array_create_from_array_array_inert_path(array_count, 1);
 
     ///act
     result = constbuffer_array_create_from_array_array(buffer_array, array_count);
@@ -1694,7 +1929,7 @@ TEST_FUNCTION(constbuffer_array_create_from_array_array_with_2_1_element_arrays_
     buffer_array[0] = TEST_constbuffer_array_create(1, 0);
     buffer_array[1] = TEST_constbuffer_array_create(1, 1);
 
-    constbuffer_array_create_from_array_array_inert_path(2);
+    constbuffer_array_create_from_array_array_inert_path(array_count, 2);
 
     ///act
     result = constbuffer_array_create_from_array_array(buffer_array, array_count);
@@ -1726,7 +1961,7 @@ TEST_FUNCTION(constbuffer_array_create_from_array_array_with_3_1_element_arrays_
     buffer_array[1] = TEST_constbuffer_array_create(1, 1);
     buffer_array[2] = TEST_constbuffer_array_create(1, 2);
 
-    constbuffer_array_create_from_array_array_inert_path(3);
+    constbuffer_array_create_from_array_array_inert_path(array_count, 3);
 
     ///act
     result = constbuffer_array_create_from_array_array(buffer_array, array_count);
@@ -1757,7 +1992,7 @@ TEST_FUNCTION(constbuffer_array_create_from_array_array_with_2_2_element_arrays_
     buffer_array[0] = TEST_constbuffer_array_create(2, 0);
     buffer_array[1] = TEST_constbuffer_array_create(2, 2);
 
-    constbuffer_array_create_from_array_array_inert_path(4);
+    constbuffer_array_create_from_array_array_inert_path(array_count, 4);
 
     ///act
     result = constbuffer_array_create_from_array_array(buffer_array, array_count);
@@ -1789,7 +2024,7 @@ TEST_FUNCTION(constbuffer_array_create_from_array_array_with_3_2_element_arrays_
     buffer_array[1] = TEST_constbuffer_array_create(2, 2);
     buffer_array[2] = TEST_constbuffer_array_create(2, 4);
 
-    constbuffer_array_create_from_array_array_inert_path(6);
+    constbuffer_array_create_from_array_array_inert_path(array_count, 6);
 
     ///act
     result = constbuffer_array_create_from_array_array(buffer_array, array_count);
@@ -1821,7 +2056,7 @@ TEST_FUNCTION(constbuffer_array_create_from_array_array_with_3_arrays_of_size_1_
     buffer_array[1] = TEST_constbuffer_array_create(2, 1);
     buffer_array[2] = TEST_constbuffer_array_create(3, 3);
 
-    constbuffer_array_create_from_array_array_inert_path(6);
+    constbuffer_array_create_from_array_array_inert_path(array_count, 6);
 
     ///act
     result = constbuffer_array_create_from_array_array(buffer_array, array_count);
@@ -1856,7 +2091,7 @@ TEST_FUNCTION(constbuffer_array_create_from_array_array_with_2_2_element_arrays_
     buffer_array[0] = test_array;
     buffer_array[1] = test_array;
 
-    constbuffer_array_create_from_array_array_inert_path(4);
+    constbuffer_array_create_from_array_array_inert_path(array_count, 4);
 
     ///act
     result = constbuffer_array_create_from_array_array(buffer_array, array_count);
@@ -1887,6 +2122,40 @@ TEST_FUNCTION(constbuffer_array_create_from_array_array_with_2_2_element_arrays_
     constbuffer_array_dec_ref(test_array);
 }
 
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_076: [ constbuffer_array_create_from_array_array shall store the sum of the total sizes of all the arrays in buffer_arrays (read with interlocked_add_64) as the total size of the new array. ]*/
+TEST_FUNCTION(constbuffer_array_create_from_array_array_with_known_sizes_knows_the_total_size)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE result;
+    const uint32_t array_count = 2;
+    CONSTBUFFER_ARRAY_HANDLE buffer_array[2];
+    uint64_t all_buffers_size;
+    buffer_array[0] = TEST_constbuffer_array_create(2, 0);
+    buffer_array[1] = TEST_constbuffer_array_create(2, 2);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_all_buffers_size_64(buffer_array[0], &all_buffers_size));
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_all_buffers_size_64(buffer_array[1], &all_buffers_size));
+    result = constbuffer_array_create_from_array_array(buffer_array, array_count);
+    ASSERT_IS_NOT_NULL(result);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); /*no buffer is read*/
+
+    ///act
+    int get_size_result = constbuffer_array_get_all_buffers_size_64(result, &all_buffers_size);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, get_size_result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint64_t, 1 + 2 + 3 + 4, all_buffers_size);
+
+    ///clean
+    constbuffer_array_dec_ref(result);
+    for (uint32_t i = 0; i < array_count; ++i)
+    {
+        constbuffer_array_dec_ref(buffer_array[i]);
+    }
+}
+
 /*Tests_SRS_CONSTBUFFER_ARRAY_42_008: [ If there are any failures then constbuffer_array_create_from_array_array shall fail and return NULL. ]*/
 TEST_FUNCTION(constbuffer_array_create_from_array_array_fails_if_malloc_fails)
 {
@@ -1978,6 +2247,7 @@ TEST_FUNCTION(constbuffer_array_add_back_with_constbuffer_handle_NULL_fails)
 /*Tests_SRS_CONSTBUFFER_ARRAY_02_043: [ constbuffer_array_add_front shall copy constbuffer_handle and all of constbuffer_array_handle existing CONSTBUFFER_HANDLE. ]*/
 /*Tests_SRS_CONSTBUFFER_ARRAY_02_044: [ constbuffer_array_add_front shall inc_ref all the CONSTBUFFER_HANDLE it had copied. ]*/
 /*Tests_SRS_CONSTBUFFER_ARRAY_02_010: [ constbuffer_array_add_front shall succeed and return a non-NULL value. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_080: [ constbuffer_array_add_front shall store the total size of constbuffer_array_handle (read with interlocked_add_64) plus the size of constbuffer_handle (obtained by calling CONSTBUFFER_GetContent) as the total size of the new array. ]*/
 TEST_FUNCTION(constbuffer_array_add_front_succeeds)
 {
     ///arrange
@@ -2002,6 +2272,7 @@ TEST_FUNCTION(constbuffer_array_add_front_succeeds)
 /*Tests_SRS_CONSTBUFFER_ARRAY_05_004: [ constbuffer_array_add_back shall copy constbuffer_handle and all of constbuffer_array_handle existing CONSTBUFFER_HANDLE. ]*/
 /*Tests_SRS_CONSTBUFFER_ARRAY_05_005: [ constbuffer_array_add_back shall inc_ref all the CONSTBUFFER_HANDLE it had copied. ]*/
 /*Tests_SRS_CONSTBUFFER_ARRAY_05_006: [ constbuffer_array_add_back shall succeed and return a non-NULL value. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_082: [ constbuffer_array_add_back shall store the total size of constbuffer_array_handle (read with interlocked_add_64) plus the size of constbuffer_handle (obtained by calling CONSTBUFFER_GetContent) as the total size of the new array. ]*/
 TEST_FUNCTION(constbuffer_array_add_back_succeeds)
 {
     ///arrange
@@ -2022,6 +2293,56 @@ TEST_FUNCTION(constbuffer_array_add_back_succeeds)
     constbuffer_array_dec_ref(result);
 }
 
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_080: [ constbuffer_array_add_front shall store the total size of constbuffer_array_handle (read with interlocked_add_64) plus the size of constbuffer_handle (obtained by calling CONSTBUFFER_GetContent) as the total size of the new array. ]*/
+TEST_FUNCTION(constbuffer_array_add_front_knows_the_total_size)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create(2, 0);
+    CONSTBUFFER_ARRAY_HANDLE afterAdd = constbuffer_array_add_front(TEST_CONSTBUFFER_ARRAY_HANDLE, TEST_CONSTBUFFER_HANDLE_4);
+    ASSERT_IS_NOT_NULL(afterAdd);
+    uint64_t all_buffers_size;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); /*no buffer is read*/
+
+    ///act
+    int result = constbuffer_array_get_all_buffers_size_64(afterAdd, &all_buffers_size);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint64_t, 1 + 2 + 4, all_buffers_size);
+
+    ///clean
+    constbuffer_array_dec_ref(afterAdd);
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_082: [ constbuffer_array_add_back shall store the total size of constbuffer_array_handle (read with interlocked_add_64) plus the size of constbuffer_handle (obtained by calling CONSTBUFFER_GetContent) as the total size of the new array. ]*/
+TEST_FUNCTION(constbuffer_array_add_back_knows_the_total_size)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create(2, 0);
+    CONSTBUFFER_ARRAY_HANDLE afterAdd = constbuffer_array_add_back(TEST_CONSTBUFFER_ARRAY_HANDLE, TEST_CONSTBUFFER_HANDLE_4);
+    ASSERT_IS_NOT_NULL(afterAdd);
+    uint64_t all_buffers_size;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); /*no buffer is read*/
+
+    ///act
+    int result = constbuffer_array_get_all_buffers_size_64(afterAdd, &all_buffers_size);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint64_t, 1 + 2 + 4, all_buffers_size);
+
+    ///clean
+    constbuffer_array_dec_ref(afterAdd);
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+}
+
 /*Tests_SRS_CONSTBUFFER_ARRAY_02_011: [ If there any failures constbuffer_array_add_front shall fail and return NULL. ]*/
 TEST_FUNCTION(constbuffer_array_add_front_unhappy_paths)
 {
@@ -2306,6 +2627,7 @@ TEST_FUNCTION(constbuffer_array_remove_back_with_1_item_succeeds)
 /*Tests_SRS_CONSTBUFFER_ARRAY_02_048: [ constbuffer_array_remove_front shall inc_ref all the copied CONSTBUFFER_HANDLEs. ]*/
 /*Tests_SRS_CONSTBUFFER_ARRAY_01_001: [ constbuffer_array_remove_front shall inc_ref the removed buffer. ]*/
 /*Tests_SRS_CONSTBUFFER_ARRAY_02_049: [ constbuffer_array_remove_front shall succeed, write in constbuffer_handle the front handle and return a non-NULL value. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_081: [ constbuffer_array_remove_front shall store the total size of constbuffer_array_handle (read with interlocked_add_64) minus the size of the front buffer (obtained by calling CONSTBUFFER_GetContent) as the total size of the new array. ]*/
 TEST_FUNCTION(constbuffer_array_remove_front_with_2_items_succeeds)
 {
     ///arrange
@@ -2341,6 +2663,7 @@ TEST_FUNCTION(constbuffer_array_remove_front_with_2_items_succeeds)
 /*Tests_SRS_CONSTBUFFER_ARRAY_05_015: [ constbuffer_array_remove_back shall copy all of constbuffer_array_handle CONSTBUFFER_HANDLEs except the back one. ]*/
 /*Tests_SRS_CONSTBUFFER_ARRAY_05_016: [ constbuffer_array_remove_back shall inc_ref all the copied CONSTBUFFER_HANDLEs. ]*/
 /*Tests_SRS_CONSTBUFFER_ARRAY_05_017: [ constbuffer_array_remove_back shall succeed and return a non-NULL value. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_083: [ constbuffer_array_remove_back shall store the total size of constbuffer_array_handle (read with interlocked_add_64) minus the size of the back buffer (obtained by calling CONSTBUFFER_GetContent) as the total size of the new array. ]*/
 TEST_FUNCTION(constbuffer_array_remove_back_with_2_items_succeeds)
 {
     ///arrange
@@ -2370,6 +2693,60 @@ TEST_FUNCTION(constbuffer_array_remove_back_with_2_items_succeeds)
     constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
 }
 
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_081: [ constbuffer_array_remove_front shall store the total size of constbuffer_array_handle (read with interlocked_add_64) minus the size of the front buffer (obtained by calling CONSTBUFFER_GetContent) as the total size of the new array. ]*/
+TEST_FUNCTION(constbuffer_array_remove_front_knows_the_total_size)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create(3, 1);
+    CONSTBUFFER_HANDLE removed = NULL;
+    CONSTBUFFER_ARRAY_HANDLE afterRemove = constbuffer_array_remove_front(TEST_CONSTBUFFER_ARRAY_HANDLE, &removed);
+    ASSERT_IS_NOT_NULL(afterRemove);
+    uint64_t all_buffers_size;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); /*no buffer is read*/
+
+    ///act
+    int result = constbuffer_array_get_all_buffers_size_64(afterRemove, &all_buffers_size);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint64_t, 3 + 4, all_buffers_size);
+
+    ///clean
+    constbuffer_array_dec_ref(afterRemove);
+    CONSTBUFFER_DecRef(removed);
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_083: [ constbuffer_array_remove_back shall store the total size of constbuffer_array_handle (read with interlocked_add_64) minus the size of the back buffer (obtained by calling CONSTBUFFER_GetContent) as the total size of the new array. ]*/
+TEST_FUNCTION(constbuffer_array_remove_back_knows_the_total_size)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create(3, 1);
+    CONSTBUFFER_HANDLE removed = NULL;
+    CONSTBUFFER_ARRAY_HANDLE afterRemove = constbuffer_array_remove_back(TEST_CONSTBUFFER_ARRAY_HANDLE, &removed);
+    ASSERT_IS_NOT_NULL(afterRemove);
+    uint64_t all_buffers_size;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); /*no buffer is read*/
+
+    ///act
+    int result = constbuffer_array_get_all_buffers_size_64(afterRemove, &all_buffers_size);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint64_t, 2 + 3, all_buffers_size);
+
+    ///clean
+    constbuffer_array_dec_ref(afterRemove);
+    CONSTBUFFER_DecRef(removed);
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+}
+
 /*Tests_SRS_CONSTBUFFER_ARRAY_02_036: [ If there are any failures then constbuffer_array_remove_front shall fail and return NULL. ]*/
 TEST_FUNCTION(constbuffer_array_remove_front_unhappy_paths)
 {
@@ -2440,1141 +2817,3436 @@ TEST_FUNCTION(constbuffer_array_remove_back_unhappy_paths)
     constbuffer_array_dec_ref(afterAdd);
 }
 
-/* constbuffer_array_get_buffer_count */
+/*constbuffer_array_add_front_shared, constbuffer_array_add_back_shared, constbuffer_array_remove_front_shared, constbuffer_array_remove_back_shared*/
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_002: [ On success, constbuffer_array_get_buffer_count shall return 0 and write the buffer count in buffer_count. ]*/
-TEST_FUNCTION(constbuffer_array_get_buffer_count_returns_0_for_an_empty_array)
+static void constbuffer_array_add_shared_with_new_storage_inert_path(uint32_t nExistingItems)
 {
-    // arrange
-    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = TEST_constbuffer_array_create_empty();
-    uint32_t buffer_count;
-
-    // act
-    int result = constbuffer_array_get_buffer_count(constbuffer_array, &buffer_count);
-
-    // assert
-    ASSERT_ARE_EQUAL(int, 0, result);
-    ASSERT_ARE_EQUAL(uint32_t, 0, buffer_count);
-    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 0, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 2 * (nExistingItems + 1) + 4, sizeof(CONSTBUFFER_HANDLE)));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1))
+        .CallCannotFail();
+    for (uint32_t i = 0; i < nExistingItems + 1; i++)
+    {
+        STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(IGNORED_ARG))
+            .CallCannotFail();
+    }
+}
 
-    // cleanup
-    constbuffer_array_dec_ref(constbuffer_array);
+static void constbuffer_array_add_shared_in_place_inert_path(CONSTBUFFER_HANDLE constbuffer_handle)
+{
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 0, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(constbuffer_handle));
 }
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_002: [ On success, constbuffer_array_get_buffer_count shall return 0 and write the buffer count in buffer_count. ]*/
-TEST_FUNCTION(constbuffer_array_get_buffer_count_after_add_on_empty_array_yields_1)
+static void constbuffer_array_remove_shared_inert_path(CONSTBUFFER_HANDLE removed)
 {
-    // arrange
-    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = TEST_constbuffer_array_create_empty();
-    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_front(constbuffer_array, 0, TEST_CONSTBUFFER_HANDLE_1);
-    uint32_t buffer_count;
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 0, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(removed));
+}
 
-    // act
-    int result = constbuffer_array_get_buffer_count(afterAdd1, &buffer_count);
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_013: [ If constbuffer_array_handle is NULL or constbuffer_handle is NULL then constbuffer_array_add_front_shared and constbuffer_array_add_back_shared shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_add_front_shared_with_constbuffer_array_handle_NULL_fails)
+{
+    ///act
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_add_front_shared(NULL, TEST_CONSTBUFFER_HANDLE_1);
 
-    // assert
-    ASSERT_ARE_EQUAL(int, 0, result);
-    ASSERT_ARE_EQUAL(uint32_t, 1, buffer_count);
+    ///assert
+    ASSERT_IS_NULL(result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-
-    // cleanup
-    constbuffer_array_dec_ref(afterAdd1);
-    constbuffer_array_dec_ref(constbuffer_array);
 }
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_002: [ On success, constbuffer_array_get_buffer_count shall return 0 and write the buffer count in buffer_count. ]*/
-TEST_FUNCTION(constbuffer_array_get_buffer_count_after_add_back_on_empty_array_yields_1)
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_013: [ If constbuffer_array_handle is NULL or constbuffer_handle is NULL then constbuffer_array_add_front_shared and constbuffer_array_add_back_shared shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_add_front_shared_with_constbuffer_handle_NULL_fails)
 {
-    // arrange
-    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = TEST_constbuffer_array_create_empty();
-    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_back(constbuffer_array, 0, TEST_CONSTBUFFER_HANDLE_1);
-    uint32_t buffer_count;
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
 
-    // act
-    int result = constbuffer_array_get_buffer_count(afterAdd1, &buffer_count);
+    ///act
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_add_front_shared(TEST_CONSTBUFFER_ARRAY_HANDLE, NULL);
 
-    // assert
-    ASSERT_ARE_EQUAL(int, 0, result);
-    ASSERT_ARE_EQUAL(uint32_t, 1, buffer_count);
+    ///assert
+    ASSERT_IS_NULL(result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
-    // cleanup
-    constbuffer_array_dec_ref(afterAdd1);
-    constbuffer_array_dec_ref(constbuffer_array);
+    ///clean
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
 }
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_002: [ On success, constbuffer_array_get_buffer_count shall return 0 and write the buffer count in buffer_count. ]*/
-TEST_FUNCTION(constbuffer_array_get_buffer_count_on_a_1_buffer_array_yields_1)
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_013: [ If constbuffer_array_handle is NULL or constbuffer_handle is NULL then constbuffer_array_add_front_shared and constbuffer_array_add_back_shared shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_add_back_shared_with_constbuffer_array_handle_NULL_fails)
 {
-    // arrange
-    CONSTBUFFER_HANDLE test_buffers[1];
-    CONSTBUFFER_ARRAY_HANDLE constbuffer_array;
-    uint32_t buffer_count;
-    int result;
+    ///act
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_add_back_shared(NULL, TEST_CONSTBUFFER_HANDLE_1);
 
-    test_buffers[0] = TEST_CONSTBUFFER_HANDLE_1;
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
 
-    constbuffer_array = constbuffer_array_create(test_buffers, sizeof(test_buffers) / sizeof(test_buffers[0]));
-    umock_c_reset_all_calls();
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_013: [ If constbuffer_array_handle is NULL or constbuffer_handle is NULL then constbuffer_array_add_front_shared and constbuffer_array_add_back_shared shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_add_back_shared_with_constbuffer_handle_NULL_fails)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
 
-    // act
-    result = constbuffer_array_get_buffer_count(constbuffer_array, &buffer_count);
+    ///act
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_add_back_shared(TEST_CONSTBUFFER_ARRAY_HANDLE, NULL);
 
-    // assert
-    ASSERT_ARE_EQUAL(int, 0, result);
-    ASSERT_ARE_EQUAL(uint32_t, 1, buffer_count);
+    ///assert
+    ASSERT_IS_NULL(result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
-    // cleanup
-    constbuffer_array_dec_ref(constbuffer_array);
+    ///clean
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
 }
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_002: [ On success, constbuffer_array_get_buffer_count shall return 0 and write the buffer count in buffer_count. ]*/
-TEST_FUNCTION(constbuffer_array_get_buffer_count_on_a_2_buffer_array_yields_2)
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_014: [ constbuffer_array_add_front_shared and constbuffer_array_add_back_shared shall allocate memory for a new CONSTBUFFER_ARRAY_HANDLE. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_016: [ Otherwise constbuffer_array_add_front_shared and constbuffer_array_add_back_shared shall allocate a new shared storage with free slots on both sides, inc_ref and copy in it constbuffer_handle and all the CONSTBUFFER_HANDLEs of constbuffer_array_handle, and return a new handle over the storage. ]*/
+TEST_FUNCTION(constbuffer_array_add_back_shared_on_a_not_shared_array_copies_it_in_a_new_storage)
 {
-    // arrange
-    CONSTBUFFER_HANDLE test_buffers[2];
-    CONSTBUFFER_ARRAY_HANDLE constbuffer_array;
-    uint32_t buffer_count;
-    int result;
-
-    test_buffers[0] = TEST_CONSTBUFFER_HANDLE_1;
-    test_buffers[1] = TEST_CONSTBUFFER_HANDLE_2;
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create(2, 0);
+    CONSTBUFFER_ARRAY_HANDLE result;
 
-    constbuffer_array = constbuffer_array_create(test_buffers, sizeof(test_buffers) / sizeof(test_buffers[0]));
-    umock_c_reset_all_calls();
+    constbuffer_array_add_shared_with_new_storage_inert_path(2);
 
-    // act
-    result = constbuffer_array_get_buffer_count(constbuffer_array, &buffer_count);
+    ///act
+    result = constbuffer_array_add_back_shared(TEST_CONSTBUFFER_ARRAY_HANDLE, TEST_CONSTBUFFER_HANDLE_3);
 
-    // assert
-    ASSERT_ARE_EQUAL(int, 0, result);
-    ASSERT_ARE_EQUAL(uint32_t, 2, buffer_count);
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    validate_sorted_constbuffer_array(result, 3);
+    validate_sorted_constbuffer_array(TEST_CONSTBUFFER_ARRAY_HANDLE, 2);
 
-    // cleanup
-    constbuffer_array_dec_ref(constbuffer_array);
+    ///clean
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    constbuffer_array_dec_ref(result);
 }
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_003: [ If constbuffer_array_handle is NULL, constbuffer_array_get_buffer_count shall fail and return a non-zero value. ]*/
-TEST_FUNCTION(constbuffer_array_get_buffer_count_with_NULL_constbuffer_array_handle_fails)
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_016: [ Otherwise constbuffer_array_add_front_shared and constbuffer_array_add_back_shared shall allocate a new shared storage with free slots on both sides, inc_ref and copy in it constbuffer_handle and all the CONSTBUFFER_HANDLEs of constbuffer_array_handle, and return a new handle over the storage. ]*/
+TEST_FUNCTION(constbuffer_array_add_front_shared_on_a_not_shared_array_copies_it_in_a_new_storage)
 {
-    // arrange
-    uint32_t buffer_count;
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create(2, 1);
+    CONSTBUFFER_ARRAY_HANDLE result;
 
-    // act
-    int result = constbuffer_array_get_buffer_count(NULL, &buffer_count);
+    constbuffer_array_add_shared_with_new_storage_inert_path(2);
 
-    // assert
-    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ///act
+    result = constbuffer_array_add_front_shared(TEST_CONSTBUFFER_ARRAY_HANDLE, TEST_CONSTBUFFER_HANDLE_1);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    validate_sorted_constbuffer_array(result, 3);
+
+    ///clean
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    constbuffer_array_dec_ref(result);
 }
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_004: [ If buffer_count is NULL, constbuffer_array_get_buffer_count shall fail and return a non-zero value. ]*/
-TEST_FUNCTION(constbuffer_array_get_buffer_count_with_NULL_buffer_count_fails)
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_015: [ If constbuffer_array_handle was produced by a constbuffer_array_*_shared function and the slot next to its front (for constbuffer_array_add_front_shared) or back (for constbuffer_array_add_back_shared) in the shared storage is free, then constbuffer_array_add_front_shared and constbuffer_array_add_back_shared shall claim the slot with interlocked_compare_exchange_64, inc_ref constbuffer_handle, store it in the slot and return a new handle that shares the storage with constbuffer_array_handle. ]*/
+TEST_FUNCTION(constbuffer_array_add_back_shared_on_a_shared_array_adds_in_place)
 {
-    // arrange
-    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = TEST_constbuffer_array_create_empty();
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create(1, 0);
+    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = constbuffer_array_add_back_shared(TEST_CONSTBUFFER_ARRAY_HANDLE, TEST_CONSTBUFFER_HANDLE_2);
+    CONSTBUFFER_ARRAY_HANDLE result;
+    ASSERT_IS_NOT_NULL(afterAdd1);
+    umock_c_reset_all_calls();
 
-    // act
-    int result = constbuffer_array_get_buffer_count(constbuffer_array, NULL);
+    constbuffer_array_add_shared_in_place_inert_path(TEST_CONSTBUFFER_HANDLE_3);
 
-    // assert
-    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ///act
+    result = constbuffer_array_add_back_shared(afterAdd1, TEST_CONSTBUFFER_HANDLE_3);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, constbuffer_array_get_const_buffer_handle_array(afterAdd1), constbuffer_array_get_const_buffer_handle_array(result));
+    validate_sorted_constbuffer_array(result, 3);
+    validate_sorted_constbuffer_array(afterAdd1, 2);
 
-    // cleanup
-    constbuffer_array_dec_ref(constbuffer_array);
+    ///clean
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    constbuffer_array_dec_ref(afterAdd1);
+    constbuffer_array_dec_ref(result);
 }
 
-/* constbuffer_array_get_buffer */
-
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_005: [ On success, constbuffer_array_get_buffer shall return a non-NULL handle to the buffer_index-th const buffer in the array. ]*/
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_006: [ The returned handle shall have its reference count incremented. ]*/
-TEST_FUNCTION(constbuffer_array_get_buffer_succeeds)
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_015: [ If constbuffer_array_handle was produced by a constbuffer_array_*_shared function and the slot next to its front (for constbuffer_array_add_front_shared) or back (for constbuffer_array_add_back_shared) in the shared storage is free, then constbuffer_array_add_front_shared and constbuffer_array_add_back_shared shall claim the slot with interlocked_compare_exchange_64, inc_ref constbuffer_handle, store it in the slot and return a new handle that shares the storage with constbuffer_array_handle. ]*/
+TEST_FUNCTION(constbuffer_array_add_front_shared_on_a_shared_array_adds_in_place)
 {
-    // arrange
-    CONSTBUFFER_HANDLE test_buffers[2];
-    CONSTBUFFER_ARRAY_HANDLE constbuffer_array;
-    CONSTBUFFER_HANDLE result;
-
-    test_buffers[0] = TEST_CONSTBUFFER_HANDLE_1;
-    test_buffers[1] = TEST_CONSTBUFFER_HANDLE_2;
-
-    constbuffer_array = constbuffer_array_create(test_buffers, sizeof(test_buffers) / sizeof(test_buffers[0]));
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create(1, 2);
+    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = constbuffer_array_add_front_shared(TEST_CONSTBUFFER_ARRAY_HANDLE, TEST_CONSTBUFFER_HANDLE_2);
+    CONSTBUFFER_ARRAY_HANDLE result;
+    ASSERT_IS_NOT_NULL(afterAdd1);
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_1));
+    constbuffer_array_add_shared_in_place_inert_path(TEST_CONSTBUFFER_HANDLE_1);
 
-    // act
-    result = constbuffer_array_get_buffer(constbuffer_array, 0);
+    ///act
+    result = constbuffer_array_add_front_shared(afterAdd1, TEST_CONSTBUFFER_HANDLE_1);
 
-    // assert
-    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_1, result);
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, constbuffer_array_get_const_buffer_handle_array(afterAdd1), constbuffer_array_get_const_buffer_handle_array(result) + 1);
+    validate_sorted_constbuffer_array(result, 3);
 
-    // cleanup
-    constbuffer_array_dec_ref(constbuffer_array);
-    CONSTBUFFER_DecRef(result);
+    ///clean
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    constbuffer_array_dec_ref(afterAdd1);
+    constbuffer_array_dec_ref(result);
 }
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_005: [ On success, constbuffer_array_get_buffer shall return a non-NULL handle to the buffer_index-th const buffer in the array. ]*/
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_006: [ The returned handle shall have its reference count incremented. ]*/
-TEST_FUNCTION(constbuffer_array_get_buffer_for_2nd_buffer_succeeds)
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_015: [ If constbuffer_array_handle was produced by a constbuffer_array_*_shared function and the slot next to its front (for constbuffer_array_add_front_shared) or back (for constbuffer_array_add_back_shared) in the shared storage is free, then constbuffer_array_add_front_shared and constbuffer_array_add_back_shared shall claim the slot with interlocked_compare_exchange_64, inc_ref constbuffer_handle, store it in the slot and return a new handle that shares the storage with constbuffer_array_handle. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_016: [ Otherwise constbuffer_array_add_front_shared and constbuffer_array_add_back_shared shall allocate a new shared storage with free slots on both sides, inc_ref and copy in it constbuffer_handle and all the CONSTBUFFER_HANDLEs of constbuffer_array_handle, and return a new handle over the storage. ]*/
+TEST_FUNCTION(constbuffer_array_add_back_shared_twice_on_the_same_array_copies_the_second_time)
 {
-    // arrange
-    CONSTBUFFER_HANDLE test_buffers[2];
-    CONSTBUFFER_ARRAY_HANDLE constbuffer_array;
-    CONSTBUFFER_HANDLE result;
-
-    test_buffers[0] = TEST_CONSTBUFFER_HANDLE_1;
-    test_buffers[1] = TEST_CONSTBUFFER_HANDLE_2;
-
-    constbuffer_array = constbuffer_array_create(test_buffers, sizeof(test_buffers) / sizeof(test_buffers[0]));
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
+    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = constbuffer_array_add_back_shared(TEST_CONSTBUFFER_ARRAY_HANDLE, TEST_CONSTBUFFER_HANDLE_1);
+    CONSTBUFFER_ARRAY_HANDLE afterAdd2 = constbuffer_array_add_back_shared(afterAdd1, TEST_CONSTBUFFER_HANDLE_2);
+    CONSTBUFFER_ARRAY_HANDLE result;
+    CONSTBUFFER_HANDLE last;
+    ASSERT_IS_NOT_NULL(afterAdd1);
+    ASSERT_IS_NOT_NULL(afterAdd2);
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_2));
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 0, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); /*afterAdd2 is also a window of the storage, the slot cannot be reused*/
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0)); /*back is past the slot, the slot holds TEST_CONSTBUFFER_HANDLE_2*/
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 2 * 2 + 4, sizeof(CONSTBUFFER_HANDLE)));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_3));
 
-    // act
-    result = constbuffer_array_get_buffer(constbuffer_array, 1);
+    ///act
+    result = constbuffer_array_add_back_shared(afterAdd1, TEST_CONSTBUFFER_HANDLE_3);
 
-    // assert
-    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_2, result);
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    last = constbuffer_array_get_buffer(result, 1);
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_3, last);
+    CONSTBUFFER_DecRef(last);
+    validate_sorted_constbuffer_array(afterAdd2, 2);
 
-    // cleanup
-    constbuffer_array_dec_ref(constbuffer_array);
-    CONSTBUFFER_DecRef(result);
+    ///clean
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    constbuffer_array_dec_ref(afterAdd1);
+    constbuffer_array_dec_ref(afterAdd2);
+    constbuffer_array_dec_ref(result);
 }
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_007: [ If constbuffer_array_handle is NULL, constbuffer_array_get_buffer shall fail and return NULL. ]*/
-TEST_FUNCTION(constbuffer_array_get_buffer_with_NULL_constbuffer_array_handle_fails)
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_017: [ If there are any failures then constbuffer_array_add_front_shared and constbuffer_array_add_back_shared shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_add_back_shared_unhappy_paths)
 {
-    // arrange
-    CONSTBUFFER_HANDLE result;
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create(2, 0);
+    size_t i;
 
-    // act
-    result = constbuffer_array_get_buffer(NULL, 0);
+    constbuffer_array_add_shared_with_new_storage_inert_path(2);
 
-    // assert
-    ASSERT_IS_NULL(result);
-    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-}
+    umock_c_negative_tests_snapshot();
+    for (i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
+        if (umock_c_negative_tests_can_call_fail(i))
+        {
+            CONSTBUFFER_ARRAY_HANDLE result;
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_008: [ If buffer_index is greater or equal to the number of buffers in the array, constbuffer_array_get_buffer shall fail and return NULL. ]*/
-TEST_FUNCTION(constbuffer_array_get_buffer_with_index_equal_to_number_of_buffers_fails)
-{
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(i);
+
+            ///act
+            result = constbuffer_array_add_back_shared(TEST_CONSTBUFFER_ARRAY_HANDLE, TEST_CONSTBUFFER_HANDLE_3);
+
+            ///assert
+            ASSERT_IS_NULL(result);
+        }
+    }
+
+    ///clean
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_017: [ If there are any failures then constbuffer_array_add_front_shared and constbuffer_array_add_back_shared shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_add_front_shared_in_place_unhappy_paths)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create(1, 2);
+    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = constbuffer_array_add_front_shared(TEST_CONSTBUFFER_ARRAY_HANDLE, TEST_CONSTBUFFER_HANDLE_2);
+    size_t i;
+    ASSERT_IS_NOT_NULL(afterAdd1);
+    umock_c_reset_all_calls();
+
+    constbuffer_array_add_shared_in_place_inert_path(TEST_CONSTBUFFER_HANDLE_1);
+
+    umock_c_negative_tests_snapshot();
+    for (i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
+        if (umock_c_negative_tests_can_call_fail(i))
+        {
+            CONSTBUFFER_ARRAY_HANDLE result;
+
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(i);
+
+            ///act
+            result = constbuffer_array_add_front_shared(afterAdd1, TEST_CONSTBUFFER_HANDLE_1);
+
+            ///assert
+            ASSERT_IS_NULL(result);
+        }
+    }
+
+    ///clean
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    constbuffer_array_dec_ref(afterAdd1);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_018: [ If constbuffer_array_handle is NULL or constbuffer_handle is NULL then constbuffer_array_remove_front_shared and constbuffer_array_remove_back_shared shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_remove_front_shared_with_constbuffer_array_handle_NULL_fails)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE constbuffer_handle;
+
+    ///act
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_remove_front_shared(NULL, &constbuffer_handle);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_018: [ If constbuffer_array_handle is NULL or constbuffer_handle is NULL then constbuffer_array_remove_front_shared and constbuffer_array_remove_back_shared shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_remove_back_shared_with_constbuffer_handle_NULL_fails)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create(1, 0);
+
+    ///act
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_remove_back_shared(TEST_CONSTBUFFER_ARRAY_HANDLE, NULL);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_019: [ If constbuffer_array_handle is empty then constbuffer_array_remove_front_shared and constbuffer_array_remove_back_shared shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_remove_front_shared_with_constbuffer_array_handle_empty_fails)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
+    CONSTBUFFER_HANDLE constbuffer_handle;
+
+    ///act
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_remove_front_shared(TEST_CONSTBUFFER_ARRAY_HANDLE, &constbuffer_handle);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_020: [ constbuffer_array_remove_front_shared and constbuffer_array_remove_back_shared shall allocate memory for a new CONSTBUFFER_ARRAY_HANDLE. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_022: [ Otherwise the new handle shall reference the CONSTBUFFER_HANDLEs of constbuffer_array_handle (or of the array constbuffer_array_handle was created from by constbuffer_array_create_from_buffer_index_and_count) without the removed one and increment the reference count of that array. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_023: [ constbuffer_array_remove_front_shared and constbuffer_array_remove_back_shared shall inc_ref the removed CONSTBUFFER_HANDLE, write it in constbuffer_handle, succeed and return the new handle. ]*/
+TEST_FUNCTION(constbuffer_array_remove_front_shared_on_a_not_shared_array_references_its_buffers)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create(3, 0);
+    CONSTBUFFER_HANDLE removed = NULL;
+    CONSTBUFFER_ARRAY_HANDLE result;
+
+    constbuffer_array_remove_shared_inert_path(TEST_CONSTBUFFER_HANDLE_1);
+
+    ///act
+    result = constbuffer_array_remove_front_shared(TEST_CONSTBUFFER_ARRAY_HANDLE, &removed);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_1, removed);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, constbuffer_array_get_const_buffer_handle_array(TEST_CONSTBUFFER_ARRAY_HANDLE) + 1, constbuffer_array_get_const_buffer_handle_array(result));
+
+    ///clean
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    constbuffer_array_dec_ref(result);
+    CONSTBUFFER_DecRef(removed);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_022: [ Otherwise the new handle shall reference the CONSTBUFFER_HANDLEs of constbuffer_array_handle (or of the array constbuffer_array_handle was created from by constbuffer_array_create_from_buffer_index_and_count) without the removed one and increment the reference count of that array. ]*/
+TEST_FUNCTION(constbuffer_array_remove_back_shared_repeated_does_not_keep_the_intermediate_arrays)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create(3, 0);
+    CONSTBUFFER_HANDLE removed1 = NULL;
+    CONSTBUFFER_HANDLE removed2 = NULL;
+    CONSTBUFFER_ARRAY_HANDLE afterRemove1;
+    CONSTBUFFER_ARRAY_HANDLE afterRemove2;
+    afterRemove1 = constbuffer_array_remove_back_shared(TEST_CONSTBUFFER_ARRAY_HANDLE, &removed1);
+    ASSERT_IS_NOT_NULL(afterRemove1);
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    afterRemove2 = constbuffer_array_remove_back_shared(afterRemove1, &removed2);
+    ASSERT_IS_NOT_NULL(afterRemove2);
+    umock_c_reset_all_calls();
+
+    /*afterRemove2 references the original array (not afterRemove1), so releasing afterRemove1 does not release any buffer*/
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(afterRemove1));
+
+    ///act
+    constbuffer_array_dec_ref(afterRemove1);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_3, removed1);
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_2, removed2);
+    validate_sorted_constbuffer_array(afterRemove2, 1);
+
+    ///clean
+    constbuffer_array_dec_ref(afterRemove2);
+    CONSTBUFFER_DecRef(removed1);
+    CONSTBUFFER_DecRef(removed2);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_021: [ If constbuffer_array_handle was produced by a constbuffer_array_*_shared function then the new handle shall share the storage of constbuffer_array_handle without the removed CONSTBUFFER_HANDLE. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_023: [ constbuffer_array_remove_front_shared and constbuffer_array_remove_back_shared shall inc_ref the removed CONSTBUFFER_HANDLE, write it in constbuffer_handle, succeed and return the new handle. ]*/
+TEST_FUNCTION(constbuffer_array_remove_back_shared_on_a_shared_array_shares_the_storage)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create(2, 0);
+    CONSTBUFFER_ARRAY_HANDLE afterAdd = constbuffer_array_add_back_shared(TEST_CONSTBUFFER_ARRAY_HANDLE, TEST_CONSTBUFFER_HANDLE_3);
+    CONSTBUFFER_HANDLE removed = NULL;
+    CONSTBUFFER_ARRAY_HANDLE result;
+    ASSERT_IS_NOT_NULL(afterAdd);
+    umock_c_reset_all_calls();
+
+    constbuffer_array_remove_shared_inert_path(TEST_CONSTBUFFER_HANDLE_3);
+
+    ///act
+    result = constbuffer_array_remove_back_shared(afterAdd, &removed);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_3, removed);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, constbuffer_array_get_const_buffer_handle_array(afterAdd), constbuffer_array_get_const_buffer_handle_array(result));
+    validate_sorted_constbuffer_array(result, 2);
+
+    ///clean
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    constbuffer_array_dec_ref(afterAdd);
+    constbuffer_array_dec_ref(result);
+    CONSTBUFFER_DecRef(removed);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_021: [ If constbuffer_array_handle was produced by a constbuffer_array_*_shared function then the new handle shall share the storage of constbuffer_array_handle without the removed CONSTBUFFER_HANDLE. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_015: [ If constbuffer_array_handle was produced by a constbuffer_array_*_shared function and the slot next to its front (for constbuffer_array_add_front_shared) or back (for constbuffer_array_add_back_shared) in the shared storage is free, then constbuffer_array_add_front_shared and constbuffer_array_add_back_shared shall claim the slot with interlocked_compare_exchange_64, inc_ref constbuffer_handle, store it in the slot and return a new handle that shares the storage with constbuffer_array_handle. ]*/
+TEST_FUNCTION(constbuffer_array_remove_front_shared_then_add_front_shared_does_not_overwrite_the_removed_slot)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create(2, 1);
+    CONSTBUFFER_ARRAY_HANDLE afterAdd = constbuffer_array_add_front_shared(TEST_CONSTBUFFER_ARRAY_HANDLE, TEST_CONSTBUFFER_HANDLE_1);
+    CONSTBUFFER_HANDLE removed = NULL;
+    CONSTBUFFER_ARRAY_HANDLE afterRemove = constbuffer_array_remove_front_shared(afterAdd, &removed);
+    CONSTBUFFER_ARRAY_HANDLE result;
+    CONSTBUFFER_HANDLE first;
+    ASSERT_IS_NOT_NULL(afterAdd);
+    ASSERT_IS_NOT_NULL(afterRemove);
+
+    ///act
+    result = constbuffer_array_add_front_shared(afterRemove, TEST_CONSTBUFFER_HANDLE_6);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
+    first = constbuffer_array_get_buffer(result, 0);
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_6, first);
+    CONSTBUFFER_DecRef(first);
+    validate_sorted_constbuffer_array(afterAdd, 3);
+
+    ///clean
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    constbuffer_array_dec_ref(afterAdd);
+    constbuffer_array_dec_ref(afterRemove);
+    constbuffer_array_dec_ref(result);
+    CONSTBUFFER_DecRef(removed);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_075: [ If constbuffer_array_handle was produced by a constbuffer_array_*_shared function, it is the only array that shares the storage and the slots between its front (for constbuffer_array_add_front_shared) or back (for constbuffer_array_add_back_shared) and the edge of the used slots hold only removed CONSTBUFFER_HANDLEs, then constbuffer_array_add_front_shared and constbuffer_array_add_back_shared shall move the edge next to constbuffer_array_handle with interlocked_compare_exchange_64, dec_ref the removed CONSTBUFFER_HANDLEs, inc_ref constbuffer_handle, store it in the slot next to constbuffer_array_handle and return a new handle that shares the storage with constbuffer_array_handle. ]*/
+TEST_FUNCTION(constbuffer_array_remove_front_shared_then_add_front_shared_on_the_only_array_reuses_the_removed_slot)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create(2, 1);
+    CONSTBUFFER_ARRAY_HANDLE afterAdd = constbuffer_array_add_front_shared(TEST_CONSTBUFFER_ARRAY_HANDLE, TEST_CONSTBUFFER_HANDLE_1);
+    CONSTBUFFER_HANDLE removed = NULL;
+    CONSTBUFFER_ARRAY_HANDLE afterRemove;
+    CONSTBUFFER_ARRAY_HANDLE result;
+    ASSERT_IS_NOT_NULL(afterAdd);
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    afterRemove = constbuffer_array_remove_front_shared(afterAdd, &removed);
+    ASSERT_IS_NOT_NULL(afterRemove);
+    constbuffer_array_dec_ref(afterAdd);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 0, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); /*afterRemove is the only window of the storage*/
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_DecRef(TEST_CONSTBUFFER_HANDLE_1)); /*the storage does not keep the removed handle anymore*/
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_6));
+
+    ///act
+    result = constbuffer_array_add_front_shared(afterRemove, TEST_CONSTBUFFER_HANDLE_6);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, constbuffer_array_get_const_buffer_handle_array(afterRemove) - 1, constbuffer_array_get_const_buffer_handle_array(result));
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_6, constbuffer_array_get_const_buffer_handle_array(result)[0]);
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_2, constbuffer_array_get_const_buffer_handle_array(result)[1]);
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_3, constbuffer_array_get_const_buffer_handle_array(result)[2]);
+
+    ///clean
+    constbuffer_array_dec_ref(afterRemove);
+    constbuffer_array_dec_ref(result);
+    CONSTBUFFER_DecRef(removed);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_075: [ If constbuffer_array_handle was produced by a constbuffer_array_*_shared function, it is the only array that shares the storage and the slots between its front (for constbuffer_array_add_front_shared) or back (for constbuffer_array_add_back_shared) and the edge of the used slots hold only removed CONSTBUFFER_HANDLEs, then constbuffer_array_add_front_shared and constbuffer_array_add_back_shared shall move the edge next to constbuffer_array_handle with interlocked_compare_exchange_64, dec_ref the removed CONSTBUFFER_HANDLEs, inc_ref constbuffer_handle, store it in the slot next to constbuffer_array_handle and return a new handle that shares the storage with constbuffer_array_handle. ]*/
+TEST_FUNCTION(constbuffer_array_remove_back_shared_twice_then_add_back_shared_on_the_only_array_reuses_the_removed_slots)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create(2, 0);
+    CONSTBUFFER_ARRAY_HANDLE afterAdd = constbuffer_array_add_back_shared(TEST_CONSTBUFFER_ARRAY_HANDLE, TEST_CONSTBUFFER_HANDLE_3);
+    CONSTBUFFER_HANDLE removed1 = NULL;
+    CONSTBUFFER_HANDLE removed2 = NULL;
+    CONSTBUFFER_ARRAY_HANDLE afterRemove1;
+    CONSTBUFFER_ARRAY_HANDLE afterRemove2;
+    CONSTBUFFER_ARRAY_HANDLE result;
+    ASSERT_IS_NOT_NULL(afterAdd);
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    afterRemove1 = constbuffer_array_remove_back_shared(afterAdd, &removed1);
+    ASSERT_IS_NOT_NULL(afterRemove1);
+    constbuffer_array_dec_ref(afterAdd);
+    afterRemove2 = constbuffer_array_remove_back_shared(afterRemove1, &removed2);
+    ASSERT_IS_NOT_NULL(afterRemove2);
+    constbuffer_array_dec_ref(afterRemove1);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 0, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG)); /*afterRemove2 is the only window of the storage*/
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_DecRef(TEST_CONSTBUFFER_HANDLE_2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_DecRef(TEST_CONSTBUFFER_HANDLE_3));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_6));
+
+    ///act
+    result = constbuffer_array_add_back_shared(afterRemove2, TEST_CONSTBUFFER_HANDLE_6);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, constbuffer_array_get_const_buffer_handle_array(afterRemove2), constbuffer_array_get_const_buffer_handle_array(result));
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_1, constbuffer_array_get_const_buffer_handle_array(result)[0]);
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_6, constbuffer_array_get_const_buffer_handle_array(result)[1]);
+
+    ///clean
+    constbuffer_array_dec_ref(afterRemove2);
+    constbuffer_array_dec_ref(result);
+    CONSTBUFFER_DecRef(removed1);
+    CONSTBUFFER_DecRef(removed2);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_024: [ If there are any failures then constbuffer_array_remove_front_shared and constbuffer_array_remove_back_shared shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_remove_front_shared_unhappy_paths)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create(2, 0);
+    size_t i;
+
+    constbuffer_array_remove_shared_inert_path(TEST_CONSTBUFFER_HANDLE_1);
+
+    umock_c_negative_tests_snapshot();
+    for (i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
+        if (umock_c_negative_tests_can_call_fail(i))
+        {
+            CONSTBUFFER_HANDLE removed;
+            CONSTBUFFER_ARRAY_HANDLE afterRemove;
+
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(i);
+
+            ///act
+            afterRemove = constbuffer_array_remove_front_shared(TEST_CONSTBUFFER_ARRAY_HANDLE, &removed);
+
+            ///assert
+            ASSERT_IS_NULL(afterRemove);
+        }
+    }
+
+    ///clean
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+}
+
+/* constbuffer_array_get_buffer_count */
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_002: [ On success, constbuffer_array_get_buffer_count shall return 0 and write the buffer count in buffer_count. ]*/
+TEST_FUNCTION(constbuffer_array_get_buffer_count_returns_0_for_an_empty_array)
+{
     // arrange
-    CONSTBUFFER_HANDLE test_buffers[2];
-    CONSTBUFFER_ARRAY_HANDLE constbuffer_array;
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = TEST_constbuffer_array_create_empty();
+    uint32_t buffer_count;
+
+    // act
+    int result = constbuffer_array_get_buffer_count(constbuffer_array, &buffer_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 0, buffer_count);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    constbuffer_array_dec_ref(constbuffer_array);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_002: [ On success, constbuffer_array_get_buffer_count shall return 0 and write the buffer count in buffer_count. ]*/
+TEST_FUNCTION(constbuffer_array_get_buffer_count_after_add_on_empty_array_yields_1)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = TEST_constbuffer_array_create_empty();
+    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_front(constbuffer_array, 0, TEST_CONSTBUFFER_HANDLE_1);
+    uint32_t buffer_count;
+
+    // act
+    int result = constbuffer_array_get_buffer_count(afterAdd1, &buffer_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 1, buffer_count);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    constbuffer_array_dec_ref(afterAdd1);
+    constbuffer_array_dec_ref(constbuffer_array);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_002: [ On success, constbuffer_array_get_buffer_count shall return 0 and write the buffer count in buffer_count. ]*/
+TEST_FUNCTION(constbuffer_array_get_buffer_count_after_add_back_on_empty_array_yields_1)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = TEST_constbuffer_array_create_empty();
+    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_back(constbuffer_array, 0, TEST_CONSTBUFFER_HANDLE_1);
+    uint32_t buffer_count;
+
+    // act
+    int result = constbuffer_array_get_buffer_count(afterAdd1, &buffer_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 1, buffer_count);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    constbuffer_array_dec_ref(afterAdd1);
+    constbuffer_array_dec_ref(constbuffer_array);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_002: [ On success, constbuffer_array_get_buffer_count shall return 0 and write the buffer count in buffer_count. ]*/
+TEST_FUNCTION(constbuffer_array_get_buffer_count_on_a_1_buffer_array_yields_1)
+{
+    // arrange
+    CONSTBUFFER_HANDLE test_buffers[1];
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array;
+    uint32_t buffer_count;
+    int result;
+
+    test_buffers[0] = TEST_CONSTBUFFER_HANDLE_1;
+
+    constbuffer_array = constbuffer_array_create(test_buffers, sizeof(test_buffers) / sizeof(test_buffers[0]));
+    umock_c_reset_all_calls();
+
+    // act
+    result = constbuffer_array_get_buffer_count(constbuffer_array, &buffer_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 1, buffer_count);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    constbuffer_array_dec_ref(constbuffer_array);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_002: [ On success, constbuffer_array_get_buffer_count shall return 0 and write the buffer count in buffer_count. ]*/
+TEST_FUNCTION(constbuffer_array_get_buffer_count_on_a_2_buffer_array_yields_2)
+{
+    // arrange
+    CONSTBUFFER_HANDLE test_buffers[2];
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array;
+    uint32_t buffer_count;
+    int result;
+
+    test_buffers[0] = TEST_CONSTBUFFER_HANDLE_1;
+    test_buffers[1] = TEST_CONSTBUFFER_HANDLE_2;
+
+    constbuffer_array = constbuffer_array_create(test_buffers, sizeof(test_buffers) / sizeof(test_buffers[0]));
+    umock_c_reset_all_calls();
+
+    // act
+    result = constbuffer_array_get_buffer_count(constbuffer_array, &buffer_count);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 2, buffer_count);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    constbuffer_array_dec_ref(constbuffer_array);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_003: [ If constbuffer_array_handle is NULL, constbuffer_array_get_buffer_count shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_get_buffer_count_with_NULL_constbuffer_array_handle_fails)
+{
+    // arrange
+    uint32_t buffer_count;
+
+    // act
+    int result = constbuffer_array_get_buffer_count(NULL, &buffer_count);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_004: [ If buffer_count is NULL, constbuffer_array_get_buffer_count shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_get_buffer_count_with_NULL_buffer_count_fails)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = TEST_constbuffer_array_create_empty();
+
+    // act
+    int result = constbuffer_array_get_buffer_count(constbuffer_array, NULL);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    constbuffer_array_dec_ref(constbuffer_array);
+}
+
+/* constbuffer_array_get_buffer */
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_005: [ On success, constbuffer_array_get_buffer shall return a non-NULL handle to the buffer_index-th const buffer in the array. ]*/
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_006: [ The returned handle shall have its reference count incremented. ]*/
+TEST_FUNCTION(constbuffer_array_get_buffer_succeeds)
+{
+    // arrange
+    CONSTBUFFER_HANDLE test_buffers[2];
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array;
+    CONSTBUFFER_HANDLE result;
+
+    test_buffers[0] = TEST_CONSTBUFFER_HANDLE_1;
+    test_buffers[1] = TEST_CONSTBUFFER_HANDLE_2;
+
+    constbuffer_array = constbuffer_array_create(test_buffers, sizeof(test_buffers) / sizeof(test_buffers[0]));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_1));
+
+    // act
+    result = constbuffer_array_get_buffer(constbuffer_array, 0);
+
+    // assert
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_1, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    constbuffer_array_dec_ref(constbuffer_array);
+    CONSTBUFFER_DecRef(result);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_005: [ On success, constbuffer_array_get_buffer shall return a non-NULL handle to the buffer_index-th const buffer in the array. ]*/
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_006: [ The returned handle shall have its reference count incremented. ]*/
+TEST_FUNCTION(constbuffer_array_get_buffer_for_2nd_buffer_succeeds)
+{
+    // arrange
+    CONSTBUFFER_HANDLE test_buffers[2];
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array;
+    CONSTBUFFER_HANDLE result;
+
+    test_buffers[0] = TEST_CONSTBUFFER_HANDLE_1;
+    test_buffers[1] = TEST_CONSTBUFFER_HANDLE_2;
+
+    constbuffer_array = constbuffer_array_create(test_buffers, sizeof(test_buffers) / sizeof(test_buffers[0]));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_2));
+
+    // act
+    result = constbuffer_array_get_buffer(constbuffer_array, 1);
+
+    // assert
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_2, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    constbuffer_array_dec_ref(constbuffer_array);
+    CONSTBUFFER_DecRef(result);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_007: [ If constbuffer_array_handle is NULL, constbuffer_array_get_buffer shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_get_buffer_with_NULL_constbuffer_array_handle_fails)
+{
+    // arrange
+    CONSTBUFFER_HANDLE result;
+
+    // act
+    result = constbuffer_array_get_buffer(NULL, 0);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_008: [ If buffer_index is greater or equal to the number of buffers in the array, constbuffer_array_get_buffer shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_get_buffer_with_index_equal_to_number_of_buffers_fails)
+{
+    // arrange
+    CONSTBUFFER_HANDLE test_buffers[2];
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array;
+    CONSTBUFFER_HANDLE result;
+
+    test_buffers[0] = TEST_CONSTBUFFER_HANDLE_1;
+    test_buffers[1] = TEST_CONSTBUFFER_HANDLE_2;
+
+    constbuffer_array = constbuffer_array_create(test_buffers, sizeof(test_buffers) / sizeof(test_buffers[0]));
+    umock_c_reset_all_calls();
+
+    // act
+    result = constbuffer_array_get_buffer(constbuffer_array, 2);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    constbuffer_array_dec_ref(constbuffer_array);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_008: [ If buffer_index is greater or equal to the number of buffers in the array, constbuffer_array_get_buffer shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_get_buffer_with_index_grater_than_number_of_buffers_fails)
+{
+    // arrange
+    CONSTBUFFER_HANDLE test_buffers[2];
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array;
+    CONSTBUFFER_HANDLE result;
+
+    test_buffers[0] = TEST_CONSTBUFFER_HANDLE_1;
+    test_buffers[1] = TEST_CONSTBUFFER_HANDLE_2;
+
+    constbuffer_array = constbuffer_array_create(test_buffers, sizeof(test_buffers) / sizeof(test_buffers[0]));
+    umock_c_reset_all_calls();
+
+    // act
+    result = constbuffer_array_get_buffer(constbuffer_array, 3);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    constbuffer_array_dec_ref(constbuffer_array);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_008: [ If buffer_index is greater or equal to the number of buffers in the array, constbuffer_array_get_buffer shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_get_buffer_with_index_0_on_empty_array_fails)
+{
+    // arrange
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array;
+    CONSTBUFFER_HANDLE result;
+
+    constbuffer_array = TEST_constbuffer_array_create_empty();
+
+    // act
+    result = constbuffer_array_get_buffer(constbuffer_array, 0);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    constbuffer_array_dec_ref(constbuffer_array);
+}
+
+/* constbuffer_array_get_buffer_content */
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_023: [ If constbuffer_array_handle is NULL, constbuffer_array_get_buffer_content shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_get_buffer_content_with_NULL_constbuffer_array_handle_fails)
+{
+    // arrange
+    const CONSTBUFFER* result;
+
+    // act
+    result = constbuffer_array_get_buffer_content(NULL, 0);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_025: [ Otherwise constbuffer_array_get_buffer_content shall call CONSTBUFFER_GetContent for the buffer_index-th buffer and return its result. ]*/
+TEST_FUNCTION(constbuffer_array_get_buffer_content_succeeds)
+{
+    // arrange
+    CONSTBUFFER_HANDLE test_buffers[2];
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array;
+    const CONSTBUFFER* result;
+
+    test_buffers[0] = TEST_CONSTBUFFER_HANDLE_1;
+    test_buffers[1] = TEST_CONSTBUFFER_HANDLE_2;
+
+    constbuffer_array = constbuffer_array_create(test_buffers, sizeof(test_buffers) / sizeof(test_buffers[0]));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1));
+
+    // act
+    result = constbuffer_array_get_buffer_content(constbuffer_array, 0);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 1, result->size);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(&one, result->buffer, result->size));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    constbuffer_array_dec_ref(constbuffer_array);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_025: [ Otherwise constbuffer_array_get_buffer_content shall call CONSTBUFFER_GetContent for the buffer_index-th buffer and return its result. ]*/
+TEST_FUNCTION(constbuffer_array_get_buffer_content_for_the_2nd_buffer_succeeds)
+{
+    // arrange
+    CONSTBUFFER_HANDLE test_buffers[2];
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array;
+    const CONSTBUFFER* result;
+
+    test_buffers[0] = TEST_CONSTBUFFER_HANDLE_1;
+    test_buffers[1] = TEST_CONSTBUFFER_HANDLE_2;
+
+    constbuffer_array = constbuffer_array_create(test_buffers, sizeof(test_buffers) / sizeof(test_buffers[0]));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2));
+
+    // act
+    result = constbuffer_array_get_buffer_content(constbuffer_array, 1);
+
+    // assert
+    ASSERT_ARE_EQUAL(size_t, 2, result->size);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(two, result->buffer, result->size));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    constbuffer_array_dec_ref(constbuffer_array);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_024: [ If buffer_index is greater or equal to the number of buffers in the array, constbuffer_array_get_buffer_content shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_get_buffer_content_with_index_out_of_range_fails)
+{
+    // arrange
+    CONSTBUFFER_HANDLE test_buffers[2];
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array;
+    const CONSTBUFFER* result;
+
+    test_buffers[0] = TEST_CONSTBUFFER_HANDLE_1;
+    test_buffers[1] = TEST_CONSTBUFFER_HANDLE_2;
+
+    constbuffer_array = constbuffer_array_create(test_buffers, sizeof(test_buffers) / sizeof(test_buffers[0]));
+    umock_c_reset_all_calls();
+
+    // act
+    result = constbuffer_array_get_buffer_content(constbuffer_array, 2);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    constbuffer_array_dec_ref(constbuffer_array);
+}
+
+/* constbuffer_array_inc_ref */
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_018: [ Otherwise constbuffer_array_inc_ref shall increment the reference count for constbuffer_array_handle. ]*/
+TEST_FUNCTION(constbuffer_array_inc_ref_increments_the_ref_count_for_empty_buffer_array)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+
+    ///act
+    constbuffer_array_inc_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_018: [ Otherwise constbuffer_array_inc_ref shall increment the reference count for constbuffer_array_handle. ]*/
+TEST_FUNCTION(constbuffer_array_inc_ref_increments_the_ref_count)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE test_buffers[2];
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array;
+
+    test_buffers[0] = TEST_CONSTBUFFER_HANDLE_1;
+    test_buffers[1] = TEST_CONSTBUFFER_HANDLE_2;
+
+    constbuffer_array = constbuffer_array_create(test_buffers, sizeof(test_buffers) / sizeof(test_buffers[0]));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+
+    ///act
+    constbuffer_array_inc_ref(constbuffer_array);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    constbuffer_array_dec_ref(constbuffer_array);
+    constbuffer_array_dec_ref(constbuffer_array);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_017: [ If constbuffer_array_handle is NULL then constbuffer_array_inc_ref shall return. ]*/
+TEST_FUNCTION(constbuffer_array_inc_ref_with_NULL_constbuffer_array_handle_returns)
+{
+    ///arrange
+
+    ///act
+    constbuffer_array_inc_ref(NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* constbuffer_array_dec_ref */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_02_039: [ If constbuffer_array_handle is NULL then constbuffer_array_dec_ref shall return. ]*/
+TEST_FUNCTION(constbuffer_array_dec_ref_with_constbuffer_array_handle_NULL_returns)
+{
+    ///arrange
+
+    ///act
+    constbuffer_array_dec_ref(NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_016: [ Otherwise constbuffer_array_dec_ref shall decrement the reference count for constbuffer_array_handle. ]*/
+TEST_FUNCTION(constbuffer_array_dec_ref_does_not_free_when_references_are_still_held)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
+    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_front(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, TEST_CONSTBUFFER_HANDLE_1);
+    CONSTBUFFER_ARRAY_HANDLE afterAdd2 = TEST_constbuffer_array_add_front(afterAdd1, 1, TEST_CONSTBUFFER_HANDLE_2);
+    constbuffer_array_inc_ref(afterAdd2);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+
+    ///act
+    constbuffer_array_dec_ref(afterAdd2);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    constbuffer_array_dec_ref(afterAdd2);
+    constbuffer_array_dec_ref(afterAdd1);
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_016: [ Otherwise constbuffer_array_dec_ref shall decrement the reference count for constbuffer_array_handle. ]*/
+TEST_FUNCTION(constbuffer_array_dec_ref_does_not_free_when_references_are_still_held_when_array_add_back)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
+    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_back(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, TEST_CONSTBUFFER_HANDLE_1);
+    CONSTBUFFER_ARRAY_HANDLE afterAdd2 = TEST_constbuffer_array_add_back(afterAdd1, 1, TEST_CONSTBUFFER_HANDLE_2);
+    constbuffer_array_inc_ref(afterAdd2);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+
+    ///act
+    constbuffer_array_dec_ref(afterAdd2);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    constbuffer_array_dec_ref(afterAdd2);
+    constbuffer_array_dec_ref(afterAdd1);
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_016: [ Otherwise constbuffer_array_dec_ref shall decrement the reference count for constbuffer_array_handle. ]*/
+/* Tests_SRS_CONSTBUFFER_ARRAY_02_038: [ If the reference count reaches 0, constbuffer_array_dec_ref shall free all used resources. ]*/
+TEST_FUNCTION(constbuffer_array_dec_ref_frees)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
+    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_front(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, TEST_CONSTBUFFER_HANDLE_1);
+    CONSTBUFFER_ARRAY_HANDLE afterAdd2 = TEST_constbuffer_array_add_front(afterAdd1, 1, TEST_CONSTBUFFER_HANDLE_2);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_DecRef(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_DecRef(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    ///act
+    constbuffer_array_dec_ref(afterAdd2);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    constbuffer_array_dec_ref(afterAdd1);
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_016: [ Otherwise constbuffer_array_dec_ref shall decrement the reference count for constbuffer_array_handle. ]*/
+/* Tests_SRS_CONSTBUFFER_ARRAY_02_038: [ If the reference count reaches 0, constbuffer_array_dec_ref shall free all used resources. ]*/
+TEST_FUNCTION(constbuffer_array_dec_ref_frees_when_array_add_back)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
+    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_back(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, TEST_CONSTBUFFER_HANDLE_1);
+    CONSTBUFFER_ARRAY_HANDLE afterAdd2 = TEST_constbuffer_array_add_back(afterAdd1, 1, TEST_CONSTBUFFER_HANDLE_2);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_DecRef(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_DecRef(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    ///act
+    constbuffer_array_dec_ref(afterAdd2);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    constbuffer_array_dec_ref(afterAdd1);
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+}
+
+/* constbuffer_array_get_all_buffers_size */
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_019: [ If constbuffer_array_handle is NULL, constbuffer_array_get_all_buffers_size shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_get_all_buffers_size_with_NULL_constbuffer_array_handle_fails)
+{
+    ///arrange
+    uint32_t all_buffers_size;
+    int result;
+
+    ///act
+    result = constbuffer_array_get_all_buffers_size(NULL, &all_buffers_size);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_020: [ If all_buffers_size is NULL, constbuffer_array_get_all_buffers_size shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_get_all_buffers_size_with_NULL_all_buffers_size_fails)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
+    int result;
+
+    ///act
+    result = constbuffer_array_get_all_buffers_size(TEST_CONSTBUFFER_ARRAY_HANDLE, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_12_084: [ constbuffer_array_get_all_buffers_size shall obtain the total size of all buffers by calling constbuffer_array_get_all_buffers_size_64. ]*/
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_021: [ If constbuffer_array_get_all_buffers_size_64 fails or the total size exceeds UINT32_MAX, constbuffer_array_get_all_buffers_size shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_get_all_buffers_size_when_overflow_happens_fails)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
+    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_front(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, TEST_CONSTBUFFER_HANDLE_1);
+    CONSTBUFFER_ARRAY_HANDLE afterAdd2 = TEST_constbuffer_array_add_front_with_fake_total_size(afterAdd1, TEST_CONSTBUFFER_HANDLE_2, (int64_t)UINT32_MAX - 1);
+    uint32_t all_buffers_size;
+    int result;
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+
+    ///act
+    result = constbuffer_array_get_all_buffers_size(afterAdd2, &all_buffers_size);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    constbuffer_array_dec_ref(afterAdd1);
+    constbuffer_array_dec_ref(afterAdd2);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_12_084: [ constbuffer_array_get_all_buffers_size shall obtain the total size of all buffers by calling constbuffer_array_get_all_buffers_size_64. ]*/
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_021: [ If constbuffer_array_get_all_buffers_size_64 fails or the total size exceeds UINT32_MAX, constbuffer_array_get_all_buffers_size shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_get_all_buffers_size_when_overflow_happens_fails_when_array_add_back)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
+    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_back(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, TEST_CONSTBUFFER_HANDLE_1);
+    CONSTBUFFER_ARRAY_HANDLE afterAdd2 = TEST_constbuffer_array_add_back_with_fake_total_size(afterAdd1, TEST_CONSTBUFFER_HANDLE_2, (int64_t)UINT32_MAX - 1);
+    uint32_t all_buffers_size;
+    int result;
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+
+    ///act
+    result = constbuffer_array_get_all_buffers_size(afterAdd2, &all_buffers_size);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    constbuffer_array_dec_ref(afterAdd1);
+    constbuffer_array_dec_ref(afterAdd2);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_021: [ If constbuffer_array_get_all_buffers_size_64 fails or the total size exceeds UINT32_MAX, constbuffer_array_get_all_buffers_size shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_get_all_buffers_size_when_get_all_buffers_size_64_fails_fails)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create(1, 0);
+    CONSTBUFFER_ARRAY_HANDLE afterAdd = TEST_constbuffer_array_add_back_with_fake_total_size(TEST_CONSTBUFFER_ARRAY_HANDLE, TEST_CONSTBUFFER_HANDLE_2, INT64_MAX);
+    uint32_t all_buffers_size;
+    int result;
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+
+    ///act
+    result = constbuffer_array_get_all_buffers_size(afterAdd, &all_buffers_size);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    constbuffer_array_dec_ref(afterAdd);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_12_084: [ constbuffer_array_get_all_buffers_size shall obtain the total size of all buffers by calling constbuffer_array_get_all_buffers_size_64. ]*/
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_022: [ Otherwise constbuffer_array_get_all_buffers_size shall write in all_buffers_size the total size of all buffers in the array and return 0. ]*/
+TEST_FUNCTION(constbuffer_array_get_all_buffers_size_max_all_size_succeeds)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
+    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_front(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, TEST_CONSTBUFFER_HANDLE_1);
+    CONSTBUFFER_ARRAY_HANDLE afterAdd2 = TEST_constbuffer_array_add_front_with_fake_total_size(afterAdd1, TEST_CONSTBUFFER_HANDLE_2, (int64_t)UINT32_MAX - 2);
+    uint32_t all_buffers_size;
+    int result;
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+
+    ///act
+    result = constbuffer_array_get_all_buffers_size(afterAdd2, &all_buffers_size);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, UINT32_MAX, all_buffers_size);
+
+    // cleanup
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    constbuffer_array_dec_ref(afterAdd1);
+    constbuffer_array_dec_ref(afterAdd2);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_12_084: [ constbuffer_array_get_all_buffers_size shall obtain the total size of all buffers by calling constbuffer_array_get_all_buffers_size_64. ]*/
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_022: [ Otherwise constbuffer_array_get_all_buffers_size shall write in all_buffers_size the total size of all buffers in the array and return 0. ]*/
+TEST_FUNCTION(constbuffer_array_get_all_buffers_size_max_all_size_succeeds_when_array_add_back)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
+    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_back(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, TEST_CONSTBUFFER_HANDLE_1);
+    CONSTBUFFER_ARRAY_HANDLE afterAdd2 = TEST_constbuffer_array_add_back_with_fake_total_size(afterAdd1, TEST_CONSTBUFFER_HANDLE_2, (int64_t)UINT32_MAX - 2);
+    uint32_t all_buffers_size;
+    int result;
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+
+    ///act
+    result = constbuffer_array_get_all_buffers_size(afterAdd2, &all_buffers_size);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, UINT32_MAX, all_buffers_size);
+
+    // cleanup
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    constbuffer_array_dec_ref(afterAdd1);
+    constbuffer_array_dec_ref(afterAdd2);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_12_084: [ constbuffer_array_get_all_buffers_size shall obtain the total size of all buffers by calling constbuffer_array_get_all_buffers_size_64. ]*/
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_022: [ Otherwise constbuffer_array_get_all_buffers_size shall write in all_buffers_size the total size of all buffers in the array and return 0. ]*/
+TEST_FUNCTION(constbuffer_array_get_all_buffers_on_empty_const_buffer_array_succeeds)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
+    uint32_t all_buffers_size;
+    int result;
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+
+    ///act
+    result = constbuffer_array_get_all_buffers_size(TEST_CONSTBUFFER_ARRAY_HANDLE, &all_buffers_size);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 0, all_buffers_size);
+
+    // cleanup
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_12_084: [ constbuffer_array_get_all_buffers_size shall obtain the total size of all buffers by calling constbuffer_array_get_all_buffers_size_64. ]*/
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_022: [ Otherwise constbuffer_array_get_all_buffers_size shall write in all_buffers_size the total size of all buffers in the array and return 0. ]*/
+TEST_FUNCTION(constbuffer_array_get_all_buffers_size_with_1_buffer_succeeds)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
+    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_front(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, TEST_CONSTBUFFER_HANDLE_1);
+    uint32_t all_buffers_size;
+    int result;
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+
+    ///act
+    result = constbuffer_array_get_all_buffers_size(afterAdd1, &all_buffers_size);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 1, all_buffers_size);
+
+    // cleanup
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    constbuffer_array_dec_ref(afterAdd1);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_12_084: [ constbuffer_array_get_all_buffers_size shall obtain the total size of all buffers by calling constbuffer_array_get_all_buffers_size_64. ]*/
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_022: [ Otherwise constbuffer_array_get_all_buffers_size shall write in all_buffers_size the total size of all buffers in the array and return 0. ]*/
+TEST_FUNCTION(constbuffer_array_get_all_buffers_size_with_1_buffer_succeeds_when_array_add_back)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
+    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_back(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, TEST_CONSTBUFFER_HANDLE_1);
+    uint32_t all_buffers_size;
+    int result;
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+
+    ///act
+    result = constbuffer_array_get_all_buffers_size(afterAdd1, &all_buffers_size);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 1, all_buffers_size);
+
+    // cleanup
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    constbuffer_array_dec_ref(afterAdd1);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_12_084: [ constbuffer_array_get_all_buffers_size shall obtain the total size of all buffers by calling constbuffer_array_get_all_buffers_size_64. ]*/
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_022: [ Otherwise constbuffer_array_get_all_buffers_size shall write in all_buffers_size the total size of all buffers in the array and return 0. ]*/
+TEST_FUNCTION(constbuffer_array_get_all_buffers_size_with_2_buffers_succeeds)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
+    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_front(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, TEST_CONSTBUFFER_HANDLE_1);
+    CONSTBUFFER_ARRAY_HANDLE afterAdd2 = TEST_constbuffer_array_add_front(afterAdd1, 1, TEST_CONSTBUFFER_HANDLE_2);
+    uint32_t all_buffers_size;
+    int result;
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+
+    ///act
+    result = constbuffer_array_get_all_buffers_size(afterAdd2, &all_buffers_size);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 3, all_buffers_size);
+
+    // cleanup
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    constbuffer_array_dec_ref(afterAdd1);
+    constbuffer_array_dec_ref(afterAdd2);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_12_084: [ constbuffer_array_get_all_buffers_size shall obtain the total size of all buffers by calling constbuffer_array_get_all_buffers_size_64. ]*/
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_022: [ Otherwise constbuffer_array_get_all_buffers_size shall write in all_buffers_size the total size of all buffers in the array and return 0. ]*/
+TEST_FUNCTION(constbuffer_array_get_all_buffers_size_with_2_buffers_succeeds_when_array_add_back)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
+    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_back(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, TEST_CONSTBUFFER_HANDLE_1);
+    CONSTBUFFER_ARRAY_HANDLE afterAdd2 = TEST_constbuffer_array_add_back(afterAdd1, 1, TEST_CONSTBUFFER_HANDLE_2);
+    uint32_t all_buffers_size;
+    int result;
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+
+    ///act
+    result = constbuffer_array_get_all_buffers_size(afterAdd2, &all_buffers_size);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 3, all_buffers_size);
+
+    // cleanup
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    constbuffer_array_dec_ref(afterAdd1);
+    constbuffer_array_dec_ref(afterAdd2);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_12_084: [ constbuffer_array_get_all_buffers_size shall obtain the total size of all buffers by calling constbuffer_array_get_all_buffers_size_64. ]*/
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_022: [ Otherwise constbuffer_array_get_all_buffers_size shall write in all_buffers_size the total size of all buffers in the array and return 0. ]*/
+TEST_FUNCTION(constbuffer_array_get_all_buffers_size_on_array_that_does_not_know_its_size_succeeds)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_with_move_buffers(2, 0);
+    uint32_t all_buffers_size;
+    int result;
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2));
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 3));
+
+    ///act
+    result = constbuffer_array_get_all_buffers_size(TEST_CONSTBUFFER_ARRAY_HANDLE, &all_buffers_size);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 3, all_buffers_size);
+
+    // cleanup
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+}
+
+/* constbuffer_array_get_all_buffers_size_64 */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_025: [ If constbuffer_array_handle is NULL, constbuffer_array_get_all_buffers_size_64 shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_get_all_buffers_size_64_with_NULL_constbuffer_array_handle_fails)
+{
+    ///arrange
+    uint64_t all_buffers_size;
+    int result;
+
+    ///act
+    result = constbuffer_array_get_all_buffers_size_64(NULL, &all_buffers_size);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_026: [ If all_buffers_size is NULL, constbuffer_array_get_all_buffers_size_64 shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_get_all_buffers_size_64_with_NULL_all_buffers_size_fails)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create(3, 0);
+    int result;
+
+    ///act
+    result = constbuffer_array_get_all_buffers_size_64(TEST_CONSTBUFFER_ARRAY_HANDLE, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    ///clean
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_028: [ Otherwise constbuffer_array_get_all_buffers_size_64 shall sum the sizes of all buffers in the array. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_030: [ constbuffer_array_get_all_buffers_size_64 shall store the sum in constbuffer_array_handle by calling interlocked_exchange_64 (so that subsequent calls do not walk the buffers again), write it in all_buffers_size and return 0. ]*/
+TEST_FUNCTION(constbuffer_array_get_all_buffers_size_64_with_3_buffers_succeeds)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_with_move_buffers(3, 0);
+    uint64_t all_buffers_size;
+    int result;
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_3));
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 6));
+
+    ///act
+    result = constbuffer_array_get_all_buffers_size_64(TEST_CONSTBUFFER_ARRAY_HANDLE, &all_buffers_size);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint64_t, 6, all_buffers_size);
+
+    ///clean
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_027: [ If the total size of constbuffer_array_handle is already known, constbuffer_array_get_all_buffers_size_64 shall write it in all_buffers_size and return 0. ]*/
+TEST_FUNCTION(constbuffer_array_get_all_buffers_size_64_called_twice_does_not_walk_the_buffers_again)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_with_move_buffers(3, 0);
+    uint64_t all_buffers_size;
+    int result;
+
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_all_buffers_size_64(TEST_CONSTBUFFER_ARRAY_HANDLE, &all_buffers_size));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+
+    ///act
+    result = constbuffer_array_get_all_buffers_size_64(TEST_CONSTBUFFER_ARRAY_HANDLE, &all_buffers_size);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint64_t, 6, all_buffers_size);
+
+    ///clean
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_027: [ If the total size of constbuffer_array_handle is already known, constbuffer_array_get_all_buffers_size_64 shall write it in all_buffers_size and return 0. ]*/
+TEST_FUNCTION(constbuffer_array_get_all_buffers_size_64_on_empty_const_buffer_array_succeeds)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
+    uint64_t all_buffers_size;
+    int result;
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+
+    ///act
+    result = constbuffer_array_get_all_buffers_size_64(TEST_CONSTBUFFER_ARRAY_HANDLE, &all_buffers_size);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint64_t, 0, all_buffers_size);
+
+    ///clean
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_027: [ If the total size of constbuffer_array_handle is already known, constbuffer_array_get_all_buffers_size_64 shall write it in all_buffers_size and return 0. ]*/
+TEST_FUNCTION(constbuffer_array_get_all_buffers_size_64_on_1_buffer_array_from_offset_and_count_succeeds)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE original = TEST_constbuffer_array_create(4, 0);
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = constbuffer_array_create_from_buffer_offset_and_count(original, 2, 1, 1, 2);
+    ASSERT_IS_NOT_NULL(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    uint64_t all_buffers_size;
+    int result;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+
+    ///act
+    result = constbuffer_array_get_all_buffers_size_64(TEST_CONSTBUFFER_ARRAY_HANDLE, &all_buffers_size);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint64_t, 2, all_buffers_size);
+
+    ///clean
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    constbuffer_array_dec_ref(original);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_027: [ If the total size of constbuffer_array_handle is already known, constbuffer_array_get_all_buffers_size_64 shall write it in all_buffers_size and return 0. ]*/
+TEST_FUNCTION(constbuffer_array_get_all_buffers_size_64_on_array_from_remove_empty_buffers_succeeds)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE empty_buffer = real_CONSTBUFFER_Create(NULL, 0);
+    ASSERT_IS_NOT_NULL(empty_buffer);
+    CONSTBUFFER_HANDLE buffers[3];
+    buffers[0] = TEST_CONSTBUFFER_HANDLE_2;
+    buffers[1] = empty_buffer;
+    buffers[2] = TEST_CONSTBUFFER_HANDLE_3;
+    CONSTBUFFER_ARRAY_HANDLE original = constbuffer_array_create(buffers, 3);
+    ASSERT_IS_NOT_NULL(original);
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = constbuffer_array_remove_empty_buffers(original);
+    ASSERT_IS_NOT_NULL(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    uint64_t all_buffers_size;
+    int result;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+
+    ///act
+    result = constbuffer_array_get_all_buffers_size_64(TEST_CONSTBUFFER_ARRAY_HANDLE, &all_buffers_size);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint64_t, 5, all_buffers_size);
+
+    ///clean
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    constbuffer_array_dec_ref(original);
+    CONSTBUFFER_DecRef(empty_buffer);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_028: [ Otherwise constbuffer_array_get_all_buffers_size_64 shall sum the sizes of all buffers in the array. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_030: [ constbuffer_array_get_all_buffers_size_64 shall store the sum in constbuffer_array_handle by calling interlocked_exchange_64 (so that subsequent calls do not walk the buffers again), write it in all_buffers_size and return 0. ]*/
+TEST_FUNCTION(constbuffer_array_get_all_buffers_size_64_with_more_than_UINT32_MAX_bytes_succeeds)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_with_move_buffers(2, 0);
+    uint64_t all_buffers_size;
+    int result;
+    const CONSTBUFFER fake_const_buffer_1 = { (const unsigned char*)0x4242, UINT32_MAX };
+    const CONSTBUFFER fake_const_buffer_2 = { (const unsigned char*)0x4242, 1 };
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1))
+        .SetReturn(&fake_const_buffer_1);
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2))
+        .SetReturn(&fake_const_buffer_2);
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, (int64_t)UINT32_MAX + 1));
+
+    ///act
+    result = constbuffer_array_get_all_buffers_size_64(TEST_CONSTBUFFER_ARRAY_HANDLE, &all_buffers_size);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint64_t, (uint64_t)UINT32_MAX + 1, all_buffers_size);
+
+    ///clean
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_027: [ If the total size of constbuffer_array_handle is already known, constbuffer_array_get_all_buffers_size_64 shall write it in all_buffers_size and return 0. ]*/
+TEST_FUNCTION(constbuffer_array_get_all_buffers_size_64_on_array_from_create_does_not_walk_the_buffers)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create(3, 0);
+    uint64_t all_buffers_size;
+    int result;
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+
+    ///act
+    result = constbuffer_array_get_all_buffers_size_64(TEST_CONSTBUFFER_ARRAY_HANDLE, &all_buffers_size);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint64_t, 6, all_buffers_size);
+
+    ///clean
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_029: [ If the total size of constbuffer_array_handle is known to exceed INT64_MAX or the sum exceeds INT64_MAX then constbuffer_array_get_all_buffers_size_64 shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_get_all_buffers_size_64_when_overflow_happens_fails)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE original = TEST_constbuffer_array_create(1, 0);
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_add_back_with_fake_total_size(original, TEST_CONSTBUFFER_HANDLE_2, INT64_MAX);
+    uint64_t all_buffers_size;
+    int result;
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+
+    ///act
+    result = constbuffer_array_get_all_buffers_size_64(TEST_CONSTBUFFER_ARRAY_HANDLE, &all_buffers_size);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    ///clean
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    constbuffer_array_dec_ref(original);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_028: [ Otherwise constbuffer_array_get_all_buffers_size_64 shall sum the sizes of all buffers in the array. ]*/
+TEST_FUNCTION(constbuffer_array_get_all_buffers_size_64_after_removing_from_an_array_with_more_than_INT64_MAX_bytes_sums_the_sizes)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE original = TEST_constbuffer_array_create(1, 0);
+    CONSTBUFFER_ARRAY_HANDLE too_big = TEST_constbuffer_array_add_back_with_fake_total_size(original, TEST_CONSTBUFFER_HANDLE_2, INT64_MAX);
+    CONSTBUFFER_HANDLE removed;
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = constbuffer_array_remove_back(too_big, &removed);
+    ASSERT_IS_NOT_NULL(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    uint64_t all_buffers_size;
+    int result;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1));
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 1));
+
+    ///act
+    result = constbuffer_array_get_all_buffers_size_64(TEST_CONSTBUFFER_ARRAY_HANDLE, &all_buffers_size);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint64_t, 1, all_buffers_size);
+
+    ///clean
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    CONSTBUFFER_DecRef(removed);
+    constbuffer_array_dec_ref(too_big);
+    constbuffer_array_dec_ref(original);
+}
+
+/* constbuffer_array_copy_to */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_031: [ If constbuffer_array_handle is NULL then constbuffer_array_copy_to shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_copy_to_with_NULL_constbuffer_array_handle_fails)
+{
+    ///arrange
+    unsigned char destination[6];
+    int result;
+
+    ///act
+    result = constbuffer_array_copy_to(NULL, 0, sizeof(destination), destination);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_032: [ If destination is NULL and length is not 0 then constbuffer_array_copy_to shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_copy_to_with_NULL_destination_fails)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create(3, 0);
+    int result;
+
+    ///act
+    result = constbuffer_array_copy_to(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, 1, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    ///clean
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_033: [ constbuffer_array_copy_to shall call constbuffer_array_get_all_buffers_size_64 to get the total size of the buffers in constbuffer_array_handle. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_035: [ constbuffer_array_copy_to shall copy length bytes starting at offset from the buffers (as if they were one contiguous buffer, skipping the empty buffers) in destination, succeed and return 0. ]*/
+TEST_FUNCTION(constbuffer_array_copy_to_with_NULL_destination_and_0_length_succeeds)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create(3, 0);
+    int result;
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+
+    ///act
+    result = constbuffer_array_copy_to(TEST_CONSTBUFFER_ARRAY_HANDLE, 6, 0, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    ///clean
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_034: [ If offset + length is greater than the total size of the buffers then constbuffer_array_copy_to shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_copy_to_with_offset_plus_length_past_the_end_fails)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create(3, 0);
+    unsigned char destination[6];
+    int result;
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+
+    ///act
+    result = constbuffer_array_copy_to(TEST_CONSTBUFFER_ARRAY_HANDLE, 2, 5, destination);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    ///clean
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_034: [ If offset + length is greater than the total size of the buffers then constbuffer_array_copy_to shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_copy_to_with_offset_past_the_end_fails)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
+    unsigned char destination[1];
+    int result;
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+
+    ///act
+    result = constbuffer_array_copy_to(TEST_CONSTBUFFER_ARRAY_HANDLE, 1, 0, destination);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    ///clean
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_036: [ If there are any failures then constbuffer_array_copy_to shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_copy_to_when_constbuffer_array_get_all_buffers_size_64_fails_fails)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE original = TEST_constbuffer_array_create(1, 0);
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_add_back_with_fake_total_size(original, TEST_CONSTBUFFER_HANDLE_2, INT64_MAX); /*makes constbuffer_array_get_all_buffers_size_64 fail*/
+    unsigned char destination[1];
+    int result;
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+
+    ///act
+    result = constbuffer_array_copy_to(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, sizeof(destination), destination);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    ///clean
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    constbuffer_array_dec_ref(original);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_033: [ constbuffer_array_copy_to shall call constbuffer_array_get_all_buffers_size_64 to get the total size of the buffers in constbuffer_array_handle. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_035: [ constbuffer_array_copy_to shall copy length bytes starting at offset from the buffers (as if they were one contiguous buffer, skipping the empty buffers) in destination, succeed and return 0. ]*/
+TEST_FUNCTION(constbuffer_array_copy_to_copies_all_the_buffers)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create(3, 0);
+    unsigned char destination[6];
+    int result;
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_3));
+
+    ///act
+    result = constbuffer_array_copy_to(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, sizeof(destination), destination);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(int, 0, memcmp("122333", destination, sizeof(destination)));
+
+    ///clean
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_035: [ constbuffer_array_copy_to shall copy length bytes starting at offset from the buffers (as if they were one contiguous buffer, skipping the empty buffers) in destination, succeed and return 0. ]*/
+TEST_FUNCTION(constbuffer_array_copy_to_copies_a_range_that_spans_buffers)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create(4, 0);
+    uint64_t all_buffers_size;
+    unsigned char destination[3];
+    int result;
+
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_all_buffers_size_64(TEST_CONSTBUFFER_ARRAY_HANDLE, &all_buffers_size));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_3));
+
+    ///act
+    result = constbuffer_array_copy_to(TEST_CONSTBUFFER_ARRAY_HANDLE, 2, sizeof(destination), destination);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(int, 0, memcmp("233", destination, sizeof(destination)));
+
+    ///clean
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_035: [ constbuffer_array_copy_to shall copy length bytes starting at offset from the buffers (as if they were one contiguous buffer, skipping the empty buffers) in destination, succeed and return 0. ]*/
+TEST_FUNCTION(constbuffer_array_copy_to_skips_empty_buffers)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE empty_buffer = real_CONSTBUFFER_Create(NULL, 0);
+    ASSERT_IS_NOT_NULL(empty_buffer);
+    CONSTBUFFER_HANDLE buffers[4];
+    buffers[0] = empty_buffer;
+    buffers[1] = TEST_CONSTBUFFER_HANDLE_1;
+    buffers[2] = empty_buffer;
+    buffers[3] = TEST_CONSTBUFFER_HANDLE_2;
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = constbuffer_array_create(buffers, 4);
+    ASSERT_IS_NOT_NULL(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    uint64_t all_buffers_size;
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_all_buffers_size_64(TEST_CONSTBUFFER_ARRAY_HANDLE, &all_buffers_size));
+    unsigned char destination[3];
+    int result;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(empty_buffer));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(empty_buffer));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2));
+
+    ///act
+    result = constbuffer_array_copy_to(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, sizeof(destination), destination);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(int, 0, memcmp("122", destination, sizeof(destination)));
+
+    ///clean
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    CONSTBUFFER_DecRef(empty_buffer);
+}
+
+/* constbuffer_array_flatten */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_037: [ If constbuffer_array_handle is NULL then constbuffer_array_flatten shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_flatten_with_NULL_constbuffer_array_handle_fails)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE result;
+
+    ///act
+    result = constbuffer_array_flatten(NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(result);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_038: [ If constbuffer_array_handle has exactly one buffer then constbuffer_array_flatten shall increment the reference count of that buffer and return it. ]*/
+TEST_FUNCTION(constbuffer_array_flatten_with_1_buffer_returns_that_buffer)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create(1, 0);
+    CONSTBUFFER_HANDLE result;
+
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(TEST_CONSTBUFFER_HANDLE_1));
+
+    ///act
+    result = constbuffer_array_flatten(TEST_CONSTBUFFER_ARRAY_HANDLE);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_1, result);
+
+    ///clean
+    CONSTBUFFER_DecRef(result);
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_039: [ Otherwise constbuffer_array_flatten shall call constbuffer_array_get_all_buffers_size_64 to get the total size of the buffers in constbuffer_array_handle. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_041: [ If the total size is 0 then constbuffer_array_flatten shall call CONSTBUFFER_Create with NULL and 0 and return the result. ]*/
+TEST_FUNCTION(constbuffer_array_flatten_with_empty_array_returns_an_empty_buffer)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
+    CONSTBUFFER_HANDLE result;
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_Create(NULL, 0));
+
+    ///act
+    result = constbuffer_array_flatten(TEST_CONSTBUFFER_ARRAY_HANDLE);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(size_t, 0, real_CONSTBUFFER_GetContent(result)->size);
+
+    ///clean
+    CONSTBUFFER_DecRef(result);
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_039: [ Otherwise constbuffer_array_flatten shall call constbuffer_array_get_all_buffers_size_64 to get the total size of the buffers in constbuffer_array_handle. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_042: [ constbuffer_array_flatten shall allocate memory for the total size and copy all the buffers in it (skipping the empty buffers). ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_043: [ constbuffer_array_flatten shall call CONSTBUFFER_CreateWithMoveMemory with the memory and return the result. ]*/
+TEST_FUNCTION(constbuffer_array_flatten_with_3_buffers_succeeds)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create(3, 0);
+    CONSTBUFFER_HANDLE result;
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(malloc(6));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_3));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_CreateWithMoveMemory(IGNORED_ARG, 6));
+
+    ///act
+    result = constbuffer_array_flatten(TEST_CONSTBUFFER_ARRAY_HANDLE);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(size_t, 6, real_CONSTBUFFER_GetContent(result)->size);
+    ASSERT_ARE_EQUAL(int, 0, memcmp("122333", real_CONSTBUFFER_GetContent(result)->buffer, 6));
+
+    ///clean
+    CONSTBUFFER_DecRef(result);
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_040: [ If the total size is greater than UINT32_MAX then constbuffer_array_flatten shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_flatten_with_more_than_UINT32_MAX_bytes_fails)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE original = TEST_constbuffer_array_create(1, 0);
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_add_back_with_fake_total_size(original, TEST_CONSTBUFFER_HANDLE_2, UINT32_MAX); /*UINT32_MAX + 2 bytes in total*/
+    CONSTBUFFER_HANDLE result;
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+
+    ///act
+    result = constbuffer_array_flatten(TEST_CONSTBUFFER_ARRAY_HANDLE);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(result);
+
+    ///clean
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    constbuffer_array_dec_ref(original);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_044: [ If there are any failures then constbuffer_array_flatten shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_flatten_when_constbuffer_array_get_all_buffers_size_64_fails_fails)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE original = TEST_constbuffer_array_create(1, 0);
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_add_back_with_fake_total_size(original, TEST_CONSTBUFFER_HANDLE_2, INT64_MAX); /*makes constbuffer_array_get_all_buffers_size_64 fail*/
     CONSTBUFFER_HANDLE result;
 
-    test_buffers[0] = TEST_CONSTBUFFER_HANDLE_1;
-    test_buffers[1] = TEST_CONSTBUFFER_HANDLE_2;
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+
+    ///act
+    result = constbuffer_array_flatten(TEST_CONSTBUFFER_ARRAY_HANDLE);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(result);
+
+    ///clean
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    constbuffer_array_dec_ref(original);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_044: [ If there are any failures then constbuffer_array_flatten shall fail and return NULL. ]*/
+TEST_FUNCTION(when_underlying_calls_fail_constbuffer_array_flatten_fails)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create(3, 0);
+    uint64_t all_buffers_size;
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_all_buffers_size_64(TEST_CONSTBUFFER_ARRAY_HANDLE, &all_buffers_size));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(malloc(6));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_3))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(CONSTBUFFER_CreateWithMoveMemory(IGNORED_ARG, 6));
+
+    umock_c_negative_tests_snapshot();
+
+    for (size_t i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
+        if (umock_c_negative_tests_can_call_fail(i))
+        {
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(i);
+
+            ///act
+            CONSTBUFFER_HANDLE result = constbuffer_array_flatten(TEST_CONSTBUFFER_ARRAY_HANDLE);
+
+            ///assert
+            ASSERT_IS_NULL(result, "On failed call %lu", (unsigned long)i);
+        }
+    }
+
+    ///clean
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+}
+
+/* constbuffer_array_get_const_buffer_handle_array */
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_026: [ If constbuffer_array_handle is NULL, constbuffer_array_get_const_buffer_handle_array shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_get_const_buffer_handle_array_with_NULL_constbuffer_array_handle_fails)
+{
+    ///arrange
+    const CONSTBUFFER_HANDLE* result;
+
+    ///act
+    result = constbuffer_array_get_const_buffer_handle_array(NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(result);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_027: [ Otherwise constbuffer_array_get_const_buffer_handle_array shall return the array of const buffer handles backing the const buffer array. ]*/
+TEST_FUNCTION(constbuffer_array_get_const_buffer_handle_array_with_empty_array_succeeds)
+{
+    ///arrange
+    const CONSTBUFFER_HANDLE* result;
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = constbuffer_array_create_empty();
+    umock_c_reset_all_calls();
+
+    ///act
+    result = constbuffer_array_get_const_buffer_handle_array(constbuffer_array);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(result);
+
+    /// cleanup
+    constbuffer_array_dec_ref(constbuffer_array);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_027: [ Otherwise constbuffer_array_get_const_buffer_handle_array shall return the array of const buffer handles backing the const buffer array. ]*/
+TEST_FUNCTION(constbuffer_array_get_const_buffer_handle_array_with_array_with_1_buffer_succeeds_when_array_add_back)
+{
+    ///arrange
+    const CONSTBUFFER_HANDLE* result;
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = constbuffer_array_create_empty();
+    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_back(constbuffer_array, 0, TEST_CONSTBUFFER_HANDLE_1);
+    umock_c_reset_all_calls();
+
+    ///act
+    result = constbuffer_array_get_const_buffer_handle_array(afterAdd1);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_1, result[0]);
+
+    /// cleanup
+    constbuffer_array_dec_ref(constbuffer_array);
+    constbuffer_array_dec_ref(afterAdd1);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_027: [ Otherwise constbuffer_array_get_const_buffer_handle_array shall return the array of const buffer handles backing the const buffer array. ]*/
+TEST_FUNCTION(constbuffer_array_get_const_buffer_handle_array_with_array_with_1_buffer_succeeds)
+{
+    ///arrange
+    const CONSTBUFFER_HANDLE* result;
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = constbuffer_array_create_empty();
+    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_front(constbuffer_array, 0, TEST_CONSTBUFFER_HANDLE_1);
+    umock_c_reset_all_calls();
+
+    ///act
+    result = constbuffer_array_get_const_buffer_handle_array(afterAdd1);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_1, result[0]);
+
+    /// cleanup
+    constbuffer_array_dec_ref(constbuffer_array);
+    constbuffer_array_dec_ref(afterAdd1);
+}
 
-    constbuffer_array = constbuffer_array_create(test_buffers, sizeof(test_buffers) / sizeof(test_buffers[0]));
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_027: [ Otherwise constbuffer_array_get_const_buffer_handle_array shall return the array of const buffer handles backing the const buffer array. ]*/
+TEST_FUNCTION(constbuffer_array_get_const_buffer_handle_array_with_array_with_1_buffer_succeeds_with_array_add_back)
+{
+    ///arrange
+    const CONSTBUFFER_HANDLE* result;
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = constbuffer_array_create_empty();
+    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_back(constbuffer_array, 0, TEST_CONSTBUFFER_HANDLE_1);
     umock_c_reset_all_calls();
 
-    // act
-    result = constbuffer_array_get_buffer(constbuffer_array, 2);
+    ///act
+    result = constbuffer_array_get_const_buffer_handle_array(afterAdd1);
 
-    // assert
-    ASSERT_IS_NULL(result);
+    ///assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_1, result[0]);
 
-    // cleanup
+    /// cleanup
     constbuffer_array_dec_ref(constbuffer_array);
+    constbuffer_array_dec_ref(afterAdd1);
 }
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_008: [ If buffer_index is greater or equal to the number of buffers in the array, constbuffer_array_get_buffer shall fail and return NULL. ]*/
-TEST_FUNCTION(constbuffer_array_get_buffer_with_index_grater_than_number_of_buffers_fails)
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_027: [ Otherwise constbuffer_array_get_const_buffer_handle_array shall return the array of const buffer handles backing the const buffer array. ]*/
+TEST_FUNCTION(constbuffer_array_get_const_buffer_handle_array_with_array_with_2_buffers_succeeds)
 {
-    // arrange
-    CONSTBUFFER_HANDLE test_buffers[2];
-    CONSTBUFFER_ARRAY_HANDLE constbuffer_array;
-    CONSTBUFFER_HANDLE result;
+    ///arrange
+    const CONSTBUFFER_HANDLE* result;
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = constbuffer_array_create_empty();
+    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_front(constbuffer_array, 0, TEST_CONSTBUFFER_HANDLE_1);
+    CONSTBUFFER_ARRAY_HANDLE afterAdd2 = TEST_constbuffer_array_add_front(afterAdd1, 0, TEST_CONSTBUFFER_HANDLE_2);
+    umock_c_reset_all_calls();
 
-    test_buffers[0] = TEST_CONSTBUFFER_HANDLE_1;
-    test_buffers[1] = TEST_CONSTBUFFER_HANDLE_2;
+    ///act
+    result = constbuffer_array_get_const_buffer_handle_array(afterAdd2);
 
-    constbuffer_array = constbuffer_array_create(test_buffers, sizeof(test_buffers) / sizeof(test_buffers[0]));
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_2, result[0]);
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_1, result[1]);
+
+    /// cleanup
+    constbuffer_array_dec_ref(constbuffer_array);
+    constbuffer_array_dec_ref(afterAdd1);
+    constbuffer_array_dec_ref(afterAdd2);
+}
+
+/* Tests_SRS_CONSTBUFFER_ARRAY_01_027: [ Otherwise constbuffer_array_get_const_buffer_handle_array shall return the array of const buffer handles backing the const buffer array. ]*/
+TEST_FUNCTION(constbuffer_array_get_const_buffer_handle_array_with_array_with_2_buffers_succeeds_with_array_add_back)
+{
+    ///arrange
+    const CONSTBUFFER_HANDLE* result;
+    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = constbuffer_array_create_empty();
+    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_back(constbuffer_array, 0, TEST_CONSTBUFFER_HANDLE_1);
+    CONSTBUFFER_ARRAY_HANDLE afterAdd2 = TEST_constbuffer_array_add_back(afterAdd1, 0, TEST_CONSTBUFFER_HANDLE_2);
     umock_c_reset_all_calls();
 
-    // act
-    result = constbuffer_array_get_buffer(constbuffer_array, 3);
+    ///act
+    result = constbuffer_array_get_const_buffer_handle_array(afterAdd2);
 
-    // assert
-    ASSERT_IS_NULL(result);
+    ///assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_2, result[1]);
+    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_1, result[0]);
 
-    // cleanup
+    /// cleanup
     constbuffer_array_dec_ref(constbuffer_array);
+    constbuffer_array_dec_ref(afterAdd1);
+    constbuffer_array_dec_ref(afterAdd2);
 }
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_008: [ If buffer_index is greater or equal to the number of buffers in the array, constbuffer_array_get_buffer shall fail and return NULL. ]*/
-TEST_FUNCTION(constbuffer_array_get_buffer_with_index_0_on_empty_array_fails)
+/*Tests_SRS_CONSTBUFFER_ARRAY_02_050: [ If left is NULL and right is NULL then CONSTBUFFER_ARRAY_HANDLE_contain_same shall return true. ]*/
+TEST_FUNCTION(CONSTBUFFER_ARRAY_HANDLE_contain_same_with_left_NULL_and_right_NULL_returns_true)
 {
-    // arrange
-    CONSTBUFFER_ARRAY_HANDLE constbuffer_array;
-    CONSTBUFFER_HANDLE result;
+    ///arrange
+    bool result;
 
-    constbuffer_array = TEST_constbuffer_array_create_empty();
+    ///act
+    result = CONSTBUFFER_ARRAY_HANDLE_contain_same(NULL, NULL);
 
-    // act
-    result = constbuffer_array_get_buffer(constbuffer_array, 0);
+    ///assert
+    ASSERT_IS_TRUE(result);
+}
 
-    // assert
-    ASSERT_IS_NULL(result);
+/*Tests_SRS_CONSTBUFFER_ARRAY_02_051: [ If left is NULL and right is not NULL then CONSTBUFFER_ARRAY_HANDLE_contain_same shall return false. ]*/
+TEST_FUNCTION(CONSTBUFFER_ARRAY_HANDLE_contain_same_with_left_NULL_and_right_non_NULL_returns_false)
+{
+    ///arrange
+    bool result;
+    CONSTBUFFER_ARRAY_HANDLE right = constbuffer_array_create(&TEST_CONSTBUFFER_HANDLE_1, 1);
+    ASSERT_IS_NOT_NULL(right);
+    umock_c_reset_all_calls();
+
+    ///act
+    result = CONSTBUFFER_ARRAY_HANDLE_contain_same(NULL, right);
+
+    ///assert
+    ASSERT_IS_FALSE(result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
-    // cleanup
-    constbuffer_array_dec_ref(constbuffer_array);
+    ///clean
+    constbuffer_array_dec_ref(right);
 }
 
-/* constbuffer_array_get_buffer_content */
-
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_023: [ If constbuffer_array_handle is NULL, constbuffer_array_get_buffer_content shall fail and return NULL. ]*/
-TEST_FUNCTION(constbuffer_array_get_buffer_content_with_NULL_constbuffer_array_handle_fails)
+/*Tests_SRS_CONSTBUFFER_ARRAY_02_052: [ If left is not NULL and right is NULL then CONSTBUFFER_ARRAY_HANDLE_contain_same shall return false. ]*/
+TEST_FUNCTION(CONSTBUFFER_ARRAY_HANDLE_contain_same_with_left_non_NULL_and_right_NULL_returns_false)
 {
-    // arrange
-    const CONSTBUFFER* result;
+    ///arrange
+    bool result;
+    CONSTBUFFER_ARRAY_HANDLE left = constbuffer_array_create(&TEST_CONSTBUFFER_HANDLE_1, 1);
+    ASSERT_IS_NOT_NULL(left);
+    umock_c_reset_all_calls();
 
-    // act
-    result = constbuffer_array_get_buffer_content(NULL, 0);
+    ///act
+    result = CONSTBUFFER_ARRAY_HANDLE_contain_same(left, NULL);
 
-    // assert
-    ASSERT_IS_NULL(result);
+    ///assert
+    ASSERT_IS_FALSE(result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    constbuffer_array_dec_ref(left);
 }
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_025: [ Otherwise constbuffer_array_get_buffer_content shall call CONSTBUFFER_GetContent for the buffer_index-th buffer and return its result. ]*/
-TEST_FUNCTION(constbuffer_array_get_buffer_content_succeeds)
+/*Tests_SRS_CONSTBUFFER_ARRAY_02_053: [ If the number of CONSTBUFFER_HANDLEs in left is different then the number of CONSTBUFFER_HANDLEs in right then  CONSTBUFFER_ARRAY_HANDLE_contain_same shall return false. ]*/
+TEST_FUNCTION(CONSTBUFFER_ARRAY_HANDLE_contain_same_with_different_number_of_buffers_return_false)
 {
-    // arrange
-    CONSTBUFFER_HANDLE test_buffers[2];
-    CONSTBUFFER_ARRAY_HANDLE constbuffer_array;
-    const CONSTBUFFER* result;
+    ///arrange
+    bool result;
+    CONSTBUFFER_ARRAY_HANDLE left = constbuffer_array_create(&TEST_CONSTBUFFER_HANDLE_1, 1);
+    ASSERT_IS_NOT_NULL(left);
 
-    test_buffers[0] = TEST_CONSTBUFFER_HANDLE_1;
-    test_buffers[1] = TEST_CONSTBUFFER_HANDLE_2;
+    CONSTBUFFER_HANDLE twoAndThree[2];
+    twoAndThree[0] = TEST_CONSTBUFFER_HANDLE_2;
+    twoAndThree[1] = TEST_CONSTBUFFER_HANDLE_3;
+    CONSTBUFFER_ARRAY_HANDLE right = constbuffer_array_create(twoAndThree, 2);
+    ASSERT_IS_NOT_NULL(right);
+    umock_c_reset_all_calls();
 
-    constbuffer_array = constbuffer_array_create(test_buffers, sizeof(test_buffers) / sizeof(test_buffers[0]));
+    ///act
+    result = CONSTBUFFER_ARRAY_HANDLE_contain_same(left, right);
+
+    ///assert
+    ASSERT_IS_FALSE(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    constbuffer_array_dec_ref(left);
+    constbuffer_array_dec_ref(right);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_02_054: [ If left and right CONSTBUFFER_HANDLEs at same index are different (as indicated by CONSTBUFFER_HANDLE_contain_same call) then CONSTBUFFER_ARRAY_HANDLE_contain_same shall return false. ]*/
+TEST_FUNCTION(CONSTBUFFER_ARRAY_HANDLE_contain_same_with_content_of_buffers_different_return_false)
+{
+    ///arrange
+    bool result;
+    CONSTBUFFER_HANDLE twoAndOne[2];
+    twoAndOne[0] = TEST_CONSTBUFFER_HANDLE_2;
+    twoAndOne[1] = TEST_CONSTBUFFER_HANDLE_1;
+    CONSTBUFFER_ARRAY_HANDLE left = constbuffer_array_create(twoAndOne, 2);
+    ASSERT_IS_NOT_NULL(left);
+
+    CONSTBUFFER_HANDLE twoAndThree[2];
+    twoAndThree[0] = TEST_CONSTBUFFER_HANDLE_2;
+    twoAndThree[1] = TEST_CONSTBUFFER_HANDLE_3;
+    CONSTBUFFER_ARRAY_HANDLE right = constbuffer_array_create(twoAndThree, 2);
+    ASSERT_IS_NOT_NULL(right);
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_HANDLE_contain_same(TEST_CONSTBUFFER_HANDLE_2, TEST_CONSTBUFFER_HANDLE_2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_HANDLE_contain_same(TEST_CONSTBUFFER_HANDLE_1, TEST_CONSTBUFFER_HANDLE_3));
 
-    // act
-    result = constbuffer_array_get_buffer_content(constbuffer_array, 0);
+    ///act
+    result = CONSTBUFFER_ARRAY_HANDLE_contain_same(left, right);
 
-    // assert
-    ASSERT_ARE_EQUAL(size_t, 1, result->size);
-    ASSERT_ARE_EQUAL(int, 0, memcmp(&one, result->buffer, result->size));
+    ///assert
+    ASSERT_IS_FALSE(result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
-    // cleanup
-    constbuffer_array_dec_ref(constbuffer_array);
+    ///clean
+    constbuffer_array_dec_ref(left);
+    constbuffer_array_dec_ref(right);
 }
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_025: [ Otherwise constbuffer_array_get_buffer_content shall call CONSTBUFFER_GetContent for the buffer_index-th buffer and return its result. ]*/
-TEST_FUNCTION(constbuffer_array_get_buffer_content_for_the_2nd_buffer_succeeds)
+/*Tests_SRS_CONSTBUFFER_ARRAY_02_055: [ CONSTBUFFER_ARRAY_HANDLE_contain_same shall return true. ]*/
+TEST_FUNCTION(CONSTBUFFER_ARRAY_HANDLE_contain_same_with_content_of_buffers_same_return_true)
 {
-    // arrange
-    CONSTBUFFER_HANDLE test_buffers[2];
-    CONSTBUFFER_ARRAY_HANDLE constbuffer_array;
-    const CONSTBUFFER* result;
-
-    test_buffers[0] = TEST_CONSTBUFFER_HANDLE_1;
-    test_buffers[1] = TEST_CONSTBUFFER_HANDLE_2;
+    ///arrange
+    bool result;
+    CONSTBUFFER_HANDLE twoAndOne[2];
+    twoAndOne[0] = TEST_CONSTBUFFER_HANDLE_2;
+    twoAndOne[1] = TEST_CONSTBUFFER_HANDLE_1;
+    CONSTBUFFER_ARRAY_HANDLE left = constbuffer_array_create(twoAndOne, 2);
+    ASSERT_IS_NOT_NULL(left);
 
-    constbuffer_array = constbuffer_array_create(test_buffers, sizeof(test_buffers) / sizeof(test_buffers[0]));
+    CONSTBUFFER_HANDLE alsoTwoAndOne[2];
+    alsoTwoAndOne[0] = TEST_CONSTBUFFER_HANDLE_2;
+    alsoTwoAndOne[1] = TEST_CONSTBUFFER_HANDLE_1;
+    CONSTBUFFER_ARRAY_HANDLE right = constbuffer_array_create(alsoTwoAndOne, 2);
+    ASSERT_IS_NOT_NULL(right);
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_HANDLE_contain_same(TEST_CONSTBUFFER_HANDLE_2, TEST_CONSTBUFFER_HANDLE_2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_HANDLE_contain_same(TEST_CONSTBUFFER_HANDLE_1, TEST_CONSTBUFFER_HANDLE_1));
 
-    // act
-    result = constbuffer_array_get_buffer_content(constbuffer_array, 1);
+    ///act
+    result = CONSTBUFFER_ARRAY_HANDLE_contain_same(left, right);
 
-    // assert
-    ASSERT_ARE_EQUAL(size_t, 2, result->size);
-    ASSERT_ARE_EQUAL(int, 0, memcmp(two, result->buffer, result->size));
+    ///assert
+    ASSERT_IS_TRUE(result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
-    // cleanup
-    constbuffer_array_dec_ref(constbuffer_array);
+    ///clean
+    constbuffer_array_dec_ref(left);
+    constbuffer_array_dec_ref(right);
+}
+
+/* constbuffer_array_get_fingerprint */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_045: [ If constbuffer_array_handle is NULL then constbuffer_array_get_fingerprint shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_get_fingerprint_with_NULL_constbuffer_array_handle_fails)
+{
+    ///arrange
+    uint64_t fingerprint;
+
+    ///act
+    int result = constbuffer_array_get_fingerprint(NULL, &fingerprint);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
 }
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_024: [ If buffer_index is greater or equal to the number of buffers in the array, constbuffer_array_get_buffer_content shall fail and return NULL. ]*/
-TEST_FUNCTION(constbuffer_array_get_buffer_content_with_index_out_of_range_fails)
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_046: [ If fingerprint is NULL then constbuffer_array_get_fingerprint shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_get_fingerprint_with_NULL_fingerprint_fails)
 {
-    // arrange
-    CONSTBUFFER_HANDLE test_buffers[2];
-    CONSTBUFFER_ARRAY_HANDLE constbuffer_array;
-    const CONSTBUFFER* result;
-
-    test_buffers[0] = TEST_CONSTBUFFER_HANDLE_1;
-    test_buffers[1] = TEST_CONSTBUFFER_HANDLE_2;
-
-    constbuffer_array = constbuffer_array_create(test_buffers, sizeof(test_buffers) / sizeof(test_buffers[0]));
-    umock_c_reset_all_calls();
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create(2, 0);
 
-    // act
-    result = constbuffer_array_get_buffer_content(constbuffer_array, 2);
+    ///act
+    int result = constbuffer_array_get_fingerprint(TEST_CONSTBUFFER_ARRAY_HANDLE, NULL);
 
-    // assert
-    ASSERT_IS_NULL(result);
+    ///assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
 
-    // cleanup
-    constbuffer_array_dec_ref(constbuffer_array);
+    ///clean
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
 }
 
-/* constbuffer_array_inc_ref */
-
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_018: [ Otherwise constbuffer_array_inc_ref shall increment the reference count for constbuffer_array_handle. ]*/
-TEST_FUNCTION(constbuffer_array_inc_ref_increments_the_ref_count_for_empty_buffer_array)
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_048: [ Otherwise constbuffer_array_get_fingerprint shall compute the fingerprint by calling constbuffer_array_compute_hash with seed 0 (the same value as hash_compute_hash_64 of the bytes of all buffers). ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_049: [ constbuffer_array_get_fingerprint shall store the fingerprint in constbuffer_array_handle by calling interlocked_exchange_64 (so that subsequent calls and constbuffer_array_content_equal do not read the buffers again), write it in fingerprint and return 0. ]*/
+TEST_FUNCTION(constbuffer_array_get_fingerprint_with_2_buffers_succeeds)
 {
     ///arrange
-    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
-
-    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    static const unsigned char expected_bytes[] = { '1', '2', '2' };
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create(2, 0);
+    uint64_t fingerprint;
+    uint64_t expected_fingerprint;
+    ASSERT_ARE_EQUAL(int, 0, real_hash_compute_hash_64(expected_bytes, sizeof(expected_bytes), &expected_fingerprint));
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(hash_init(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1));
+    STRICT_EXPECTED_CALL(hash_update(IGNORED_ARG, IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2));
+    STRICT_EXPECTED_CALL(hash_update(IGNORED_ARG, IGNORED_ARG, 2));
+    STRICT_EXPECTED_CALL(hash_final(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, (int64_t)expected_fingerprint));
 
     ///act
-    constbuffer_array_inc_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    int result = constbuffer_array_get_fingerprint(TEST_CONSTBUFFER_ARRAY_HANDLE, &fingerprint);
 
     ///assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint64_t, expected_fingerprint, fingerprint);
 
-    ///cleanup
-    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    ///clean
     constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
 }
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_018: [ Otherwise constbuffer_array_inc_ref shall increment the reference count for constbuffer_array_handle. ]*/
-TEST_FUNCTION(constbuffer_array_inc_ref_increments_the_ref_count)
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_085: [ If constbuffer_array_compute_hash fails then constbuffer_array_get_fingerprint shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(when_underlying_calls_fail_constbuffer_array_get_fingerprint_fails)
 {
     ///arrange
-    CONSTBUFFER_HANDLE test_buffers[2];
-    CONSTBUFFER_ARRAY_HANDLE constbuffer_array;
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create(2, 0);
+    uint64_t fingerprint;
+    size_t i;
 
-    test_buffers[0] = TEST_CONSTBUFFER_HANDLE_1;
-    test_buffers[1] = TEST_CONSTBUFFER_HANDLE_2;
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(hash_init(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(hash_update(IGNORED_ARG, IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(hash_update(IGNORED_ARG, IGNORED_ARG, 2));
+    STRICT_EXPECTED_CALL(hash_final(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, IGNORED_ARG))
+        .CallCannotFail();
 
-    constbuffer_array = constbuffer_array_create(test_buffers, sizeof(test_buffers) / sizeof(test_buffers[0]));
+    umock_c_negative_tests_snapshot();
+    for (i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
+        if (umock_c_negative_tests_can_call_fail(i))
+        {
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(i);
+
+            ///act
+            int result = constbuffer_array_get_fingerprint(TEST_CONSTBUFFER_ARRAY_HANDLE, &fingerprint);
+
+            ///assert
+            ASSERT_ARE_NOT_EQUAL(int, 0, result, "On failed call %zu", i);
+        }
+    }
+
+    ///clean
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_047: [ If the fingerprint of constbuffer_array_handle is already known then constbuffer_array_get_fingerprint shall write it in fingerprint and return 0. ]*/
+TEST_FUNCTION(constbuffer_array_get_fingerprint_called_twice_does_not_read_the_buffers_again)
+{
+    ///arrange
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create(2, 0);
+    uint64_t fingerprint_1;
+    uint64_t fingerprint_2;
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_fingerprint(TEST_CONSTBUFFER_ARRAY_HANDLE, &fingerprint_1));
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
 
     ///act
-    constbuffer_array_inc_ref(constbuffer_array);
+    int result = constbuffer_array_get_fingerprint(TEST_CONSTBUFFER_ARRAY_HANDLE, &fingerprint_2);
 
     ///assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint64_t, fingerprint_1, fingerprint_2);
 
-    ///cleanup
-    constbuffer_array_dec_ref(constbuffer_array);
-    constbuffer_array_dec_ref(constbuffer_array);
+    ///clean
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
 }
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_017: [ If constbuffer_array_handle is NULL then constbuffer_array_inc_ref shall return. ]*/
-TEST_FUNCTION(constbuffer_array_inc_ref_with_NULL_constbuffer_array_handle_returns)
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_048: [ Otherwise constbuffer_array_get_fingerprint shall compute the fingerprint by calling constbuffer_array_compute_hash with seed 0 (the same value as hash_compute_hash_64 of the bytes of all buffers). ]*/
+TEST_FUNCTION(constbuffer_array_get_fingerprint_does_not_depend_on_how_the_bytes_are_split_in_buffers)
 {
     ///arrange
+    static const unsigned char content[] = { 'a', 'b', 'c', 'd', 'e', 'f', 'g' };
+    static const uint32_t split_1[] = { 7 };
+    static const uint32_t split_2[] = { 1, 0, 4, 2 };
+    static const uint32_t split_3[] = { 3, 3, 1, 0 };
+    CONSTBUFFER_ARRAY_HANDLE array_1 = TEST_constbuffer_array_create_split(content, split_1, sizeof(split_1) / sizeof(split_1[0]));
+    CONSTBUFFER_ARRAY_HANDLE array_2 = TEST_constbuffer_array_create_split(content, split_2, sizeof(split_2) / sizeof(split_2[0]));
+    CONSTBUFFER_ARRAY_HANDLE array_3 = TEST_constbuffer_array_create_split(content, split_3, sizeof(split_3) / sizeof(split_3[0]));
+    CONSTBUFFER_HANDLE flat = real_CONSTBUFFER_Create(content, sizeof(content));
+    ASSERT_IS_NOT_NULL(flat);
+    uint64_t fingerprint_1;
+    uint64_t fingerprint_2;
+    uint64_t fingerprint_3;
+    uint64_t fingerprint_flat;
 
     ///act
-    constbuffer_array_inc_ref(NULL);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_fingerprint(array_1, &fingerprint_1));
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_fingerprint(array_2, &fingerprint_2));
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_fingerprint(array_3, &fingerprint_3));
+    ASSERT_ARE_EQUAL(int, 0, real_CONSTBUFFER_GetFingerprint(flat, &fingerprint_flat));
 
     ///assert
-    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint64_t, fingerprint_1, fingerprint_2);
+    ASSERT_ARE_EQUAL(uint64_t, fingerprint_1, fingerprint_3);
+    ASSERT_ARE_EQUAL(uint64_t, fingerprint_flat, fingerprint_1);
+
+    ///clean
+    real_CONSTBUFFER_DecRef(flat);
+    constbuffer_array_dec_ref(array_1);
+    constbuffer_array_dec_ref(array_2);
+    constbuffer_array_dec_ref(array_3);
 }
 
-/* constbuffer_array_dec_ref */
+/* constbuffer_array_compute_hash */
 
-/*Tests_SRS_CONSTBUFFER_ARRAY_02_039: [ If constbuffer_array_handle is NULL then constbuffer_array_dec_ref shall return. ]*/
-TEST_FUNCTION(constbuffer_array_dec_ref_with_constbuffer_array_handle_NULL_returns)
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_069: [ If constbuffer_array_handle is NULL then constbuffer_array_compute_hash shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_compute_hash_with_NULL_constbuffer_array_handle_fails)
 {
     ///arrange
+    uint64_t hash;
 
     ///act
-    constbuffer_array_dec_ref(NULL);
+    int result = constbuffer_array_compute_hash(NULL, 0, &hash);
 
     ///assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
 }
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_016: [ Otherwise constbuffer_array_dec_ref shall decrement the reference count for constbuffer_array_handle. ]*/
-TEST_FUNCTION(constbuffer_array_dec_ref_does_not_free_when_references_are_still_held)
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_070: [ If hash is NULL then constbuffer_array_compute_hash shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_array_compute_hash_with_NULL_hash_fails)
 {
     ///arrange
-    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
-    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_front(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, TEST_CONSTBUFFER_HANDLE_1);
-    CONSTBUFFER_ARRAY_HANDLE afterAdd2 = TEST_constbuffer_array_add_front(afterAdd1, 1, TEST_CONSTBUFFER_HANDLE_2);
-    constbuffer_array_inc_ref(afterAdd2);
-    umock_c_reset_all_calls();
-
-    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create(2, 0);
 
     ///act
-    constbuffer_array_dec_ref(afterAdd2);
+    int result = constbuffer_array_compute_hash(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, NULL);
 
     ///assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
 
-    ///cleanup
-    constbuffer_array_dec_ref(afterAdd2);
-    constbuffer_array_dec_ref(afterAdd1);
+    ///clean
     constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
 }
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_016: [ Otherwise constbuffer_array_dec_ref shall decrement the reference count for constbuffer_array_handle. ]*/
-TEST_FUNCTION(constbuffer_array_dec_ref_does_not_free_when_references_are_still_held_when_array_add_back)
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_071: [ constbuffer_array_compute_hash shall call hash_init with seed. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_072: [ For each buffer of constbuffer_array_handle constbuffer_array_compute_hash shall call CONSTBUFFER_GetContent and hash_update with the content. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_073: [ constbuffer_array_compute_hash shall call hash_final to write the hash in hash and return 0. ]*/
+TEST_FUNCTION(constbuffer_array_compute_hash_with_2_buffers_succeeds)
 {
     ///arrange
-    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
-    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_back(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, TEST_CONSTBUFFER_HANDLE_1);
-    CONSTBUFFER_ARRAY_HANDLE afterAdd2 = TEST_constbuffer_array_add_back(afterAdd1, 1, TEST_CONSTBUFFER_HANDLE_2);
-    constbuffer_array_inc_ref(afterAdd2);
-    umock_c_reset_all_calls();
+    static const unsigned char expected_bytes[] = { '1', '2', '2' };
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create(2, 0);
+    uint64_t hash;
+    uint64_t expected_hash;
+    ASSERT_ARE_EQUAL(int, 0, real_hash_compute_hash_seeded(expected_bytes, sizeof(expected_bytes), 42, &expected_hash));
 
-    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(hash_init(IGNORED_ARG, 42));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1));
+    STRICT_EXPECTED_CALL(hash_update(IGNORED_ARG, IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2));
+    STRICT_EXPECTED_CALL(hash_update(IGNORED_ARG, IGNORED_ARG, 2));
+    STRICT_EXPECTED_CALL(hash_final(IGNORED_ARG, &hash));
 
     ///act
-    constbuffer_array_dec_ref(afterAdd2);
+    int result = constbuffer_array_compute_hash(TEST_CONSTBUFFER_ARRAY_HANDLE, 42, &hash);
 
     ///assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint64_t, expected_hash, hash);
 
-    ///cleanup
-    constbuffer_array_dec_ref(afterAdd2);
-    constbuffer_array_dec_ref(afterAdd1);
+    ///clean
     constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
 }
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_016: [ Otherwise constbuffer_array_dec_ref shall decrement the reference count for constbuffer_array_handle. ]*/
-/* Tests_SRS_CONSTBUFFER_ARRAY_02_038: [ If the reference count reaches 0, constbuffer_array_dec_ref shall free all used resources. ]*/
-TEST_FUNCTION(constbuffer_array_dec_ref_frees)
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_073: [ constbuffer_array_compute_hash shall call hash_final to write the hash in hash and return 0. ]*/
+TEST_FUNCTION(constbuffer_array_compute_hash_with_0_buffers_succeeds)
 {
     ///arrange
     CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
-    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_front(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, TEST_CONSTBUFFER_HANDLE_1);
-    CONSTBUFFER_ARRAY_HANDLE afterAdd2 = TEST_constbuffer_array_add_front(afterAdd1, 1, TEST_CONSTBUFFER_HANDLE_2);
-    umock_c_reset_all_calls();
+    uint64_t hash;
+    uint64_t expected_hash;
+    ASSERT_ARE_EQUAL(int, 0, real_hash_compute_hash_seeded(NULL, 0, 42, &expected_hash));
 
-    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(CONSTBUFFER_DecRef(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(CONSTBUFFER_DecRef(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(hash_init(IGNORED_ARG, 42));
+    STRICT_EXPECTED_CALL(hash_final(IGNORED_ARG, &hash));
 
     ///act
-    constbuffer_array_dec_ref(afterAdd2);
+    int result = constbuffer_array_compute_hash(TEST_CONSTBUFFER_ARRAY_HANDLE, 42, &hash);
 
     ///assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint64_t, expected_hash, hash);
 
-    ///cleanup
-    constbuffer_array_dec_ref(afterAdd1);
+    ///clean
     constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
 }
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_016: [ Otherwise constbuffer_array_dec_ref shall decrement the reference count for constbuffer_array_handle. ]*/
-/* Tests_SRS_CONSTBUFFER_ARRAY_02_038: [ If the reference count reaches 0, constbuffer_array_dec_ref shall free all used resources. ]*/
-TEST_FUNCTION(constbuffer_array_dec_ref_frees_when_array_add_back)
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_074: [ If there are any failures then constbuffer_array_compute_hash shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(when_underlying_calls_fail_constbuffer_array_compute_hash_fails)
 {
     ///arrange
-    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
-    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_back(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, TEST_CONSTBUFFER_HANDLE_1);
-    CONSTBUFFER_ARRAY_HANDLE afterAdd2 = TEST_constbuffer_array_add_back(afterAdd1, 1, TEST_CONSTBUFFER_HANDLE_2);
-    umock_c_reset_all_calls();
+    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create(2, 0);
+    uint64_t hash;
+    size_t i;
 
-    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(CONSTBUFFER_DecRef(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(CONSTBUFFER_DecRef(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(hash_init(IGNORED_ARG, 42));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(hash_update(IGNORED_ARG, IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(hash_update(IGNORED_ARG, IGNORED_ARG, 2));
+    STRICT_EXPECTED_CALL(hash_final(IGNORED_ARG, &hash));
+
+    umock_c_negative_tests_snapshot();
+    for (i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
+        if (umock_c_negative_tests_can_call_fail(i))
+        {
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(i);
+
+            ///act
+            int result = constbuffer_array_compute_hash(TEST_CONSTBUFFER_ARRAY_HANDLE, 42, &hash);
+
+            ///assert
+            ASSERT_ARE_NOT_EQUAL(int, 0, result, "On failed call %zu", i);
+        }
+    }
+
+    ///clean
+    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_072: [ For each buffer of constbuffer_array_handle constbuffer_array_compute_hash shall call CONSTBUFFER_GetContent and hash_update with the content. ]*/
+TEST_FUNCTION(constbuffer_array_compute_hash_does_not_depend_on_how_the_bytes_are_split_in_buffers)
+{
+    ///arrange
+    unsigned char content[1000];
+    for (uint32_t i = 0; i < sizeof(content); i++)
+    {
+        content[i] = (unsigned char)(i * 7 + 3);
+    }
+    /*splits inside and across the stripes and the buffer of the hash state*/
+    static const uint32_t split_1[] = { 1000 };
+    static const uint32_t split_2[] = { 1, 0, 63, 200, 300, 436 };
+    static const uint32_t split_3[] = { 256, 256, 1, 487 };
+    static const uint32_t split_4[] = { 100, 100, 100, 100, 100, 100, 100, 300 };
+    CONSTBUFFER_ARRAY_HANDLE array_1 = TEST_constbuffer_array_create_split(content, split_1, sizeof(split_1) / sizeof(split_1[0]));
+    CONSTBUFFER_ARRAY_HANDLE array_2 = TEST_constbuffer_array_create_split(content, split_2, sizeof(split_2) / sizeof(split_2[0]));
+    CONSTBUFFER_ARRAY_HANDLE array_3 = TEST_constbuffer_array_create_split(content, split_3, sizeof(split_3) / sizeof(split_3[0]));
+    CONSTBUFFER_ARRAY_HANDLE array_4 = TEST_constbuffer_array_create_split(content, split_4, sizeof(split_4) / sizeof(split_4[0]));
+    uint64_t hash_1;
+    uint64_t hash_2;
+    uint64_t hash_3;
+    uint64_t hash_4;
+    uint64_t hash_flat;
 
     ///act
-    constbuffer_array_dec_ref(afterAdd2);
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_compute_hash(array_1, 42, &hash_1));
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_compute_hash(array_2, 42, &hash_2));
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_compute_hash(array_3, 42, &hash_3));
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_compute_hash(array_4, 42, &hash_4));
+    ASSERT_ARE_EQUAL(int, 0, real_hash_compute_hash_seeded(content, sizeof(content), 42, &hash_flat));
 
     ///assert
-    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint64_t, hash_flat, hash_1);
+    ASSERT_ARE_EQUAL(uint64_t, hash_flat, hash_2);
+    ASSERT_ARE_EQUAL(uint64_t, hash_flat, hash_3);
+    ASSERT_ARE_EQUAL(uint64_t, hash_flat, hash_4);
 
-    ///cleanup
-    constbuffer_array_dec_ref(afterAdd1);
-    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    ///clean
+    constbuffer_array_dec_ref(array_1);
+    constbuffer_array_dec_ref(array_2);
+    constbuffer_array_dec_ref(array_3);
+    constbuffer_array_dec_ref(array_4);
 }
 
-/* constbuffer_array_get_all_buffers_size */
+/* constbuffer_array_content_equal */
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_019: [ If constbuffer_array_handle is NULL, constbuffer_array_get_all_buffers_size shall fail and return a non-zero value. ]*/
-TEST_FUNCTION(constbuffer_array_get_all_buffers_size_with_NULL_constbuffer_array_handle_fails)
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_050: [ If left is NULL or right is NULL then constbuffer_array_content_equal shall return true when both are NULL and false otherwise. ]*/
+TEST_FUNCTION(constbuffer_array_content_equal_with_left_NULL_and_right_NULL_returns_true)
+{
+    ///act
+    bool result = constbuffer_array_content_equal(NULL, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_TRUE(result);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_050: [ If left is NULL or right is NULL then constbuffer_array_content_equal shall return true when both are NULL and false otherwise. ]*/
+TEST_FUNCTION(constbuffer_array_content_equal_with_left_NULL_and_right_non_NULL_returns_false)
 {
     ///arrange
-    uint32_t all_buffers_size;
-    int result;
+    CONSTBUFFER_ARRAY_HANDLE right = TEST_constbuffer_array_create(2, 0);
 
     ///act
-    result = constbuffer_array_get_all_buffers_size(NULL, &all_buffers_size);
+    bool result = constbuffer_array_content_equal(NULL, right);
 
     ///assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_IS_FALSE(result);
+
+    ///clean
+    constbuffer_array_dec_ref(right);
 }
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_020: [ If all_buffers_size is NULL, constbuffer_array_get_all_buffers_size shall fail and return a non-zero value. ]*/
-TEST_FUNCTION(constbuffer_array_get_all_buffers_size_with_NULL_all_buffers_size_fails)
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_050: [ If left is NULL or right is NULL then constbuffer_array_content_equal shall return true when both are NULL and false otherwise. ]*/
+TEST_FUNCTION(constbuffer_array_content_equal_with_left_non_NULL_and_right_NULL_returns_false)
 {
     ///arrange
-    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
-    int result;
+    CONSTBUFFER_ARRAY_HANDLE left = TEST_constbuffer_array_create(2, 0);
 
     ///act
-    result = constbuffer_array_get_all_buffers_size(TEST_CONSTBUFFER_ARRAY_HANDLE, NULL);
+    bool result = constbuffer_array_content_equal(left, NULL);
 
     ///assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_IS_FALSE(result);
 
-    // cleanup
-    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    ///clean
+    constbuffer_array_dec_ref(left);
 }
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_021: [ If summing up the sizes results in an uint32_t overflow, shall fail and return a non-zero value. ]*/
-TEST_FUNCTION(constbuffer_array_get_all_buffers_size_when_overflow_happens_fails)
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_051: [ If left and right are the same array then constbuffer_array_content_equal shall return true. ]*/
+TEST_FUNCTION(constbuffer_array_content_equal_with_the_same_array_returns_true)
 {
     ///arrange
-    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
-    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_front(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, TEST_CONSTBUFFER_HANDLE_1);
-    CONSTBUFFER_ARRAY_HANDLE afterAdd2 = TEST_constbuffer_array_add_front(afterAdd1, 1, TEST_CONSTBUFFER_HANDLE_2);
-    uint32_t all_buffers_size;
-    int result;
-    const CONSTBUFFER fake_const_buffer_1 = { (const unsigned char*)0x4242, UINT32_MAX };
-    const CONSTBUFFER fake_const_buffer_2 = { (const unsigned char*)0x4242, 1 };
-
-    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2))
-        .SetReturn(&fake_const_buffer_2);
-    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1))
-        .SetReturn(&fake_const_buffer_1);
+    CONSTBUFFER_ARRAY_HANDLE array = TEST_constbuffer_array_create(2, 0);
 
     ///act
-    result = constbuffer_array_get_all_buffers_size(afterAdd2, &all_buffers_size);
+    bool result = constbuffer_array_content_equal(array, array);
 
     ///assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_IS_TRUE(result);
 
-    // cleanup
-    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
-    constbuffer_array_dec_ref(afterAdd1);
-    constbuffer_array_dec_ref(afterAdd2);
+    ///clean
+    constbuffer_array_dec_ref(array);
 }
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_021: [ If summing up the sizes results in an uint32_t overflow, shall fail and return a non-zero value. ]*/
-TEST_FUNCTION(constbuffer_array_get_all_buffers_size_when_overflow_happens_fails_when_array_add_back)
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_052: [ constbuffer_array_content_equal shall call constbuffer_array_get_all_buffers_size_64 on left and right. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_053: [ If getting the sizes fails then constbuffer_array_content_equal shall return false. ]*/
+TEST_FUNCTION(constbuffer_array_content_equal_when_getting_the_size_fails_returns_false)
 {
     ///arrange
-    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
-    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_back(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, TEST_CONSTBUFFER_HANDLE_1);
-    CONSTBUFFER_ARRAY_HANDLE afterAdd2 = TEST_constbuffer_array_add_back(afterAdd1, 1, TEST_CONSTBUFFER_HANDLE_2);
-    uint32_t all_buffers_size;
-    int result;
-    const CONSTBUFFER fake_const_buffer_1 = { (const unsigned char*)0x4242, UINT32_MAX };
-    const CONSTBUFFER fake_const_buffer_2 = { (const unsigned char*)0x4242, 1 };
+    CONSTBUFFER_ARRAY_HANDLE original = TEST_constbuffer_array_create(1, 0);
+    CONSTBUFFER_ARRAY_HANDLE left = TEST_constbuffer_array_add_back_with_fake_total_size(original, TEST_CONSTBUFFER_HANDLE_2, INT64_MAX);
+    CONSTBUFFER_ARRAY_HANDLE right = TEST_constbuffer_array_create(2, 0);
 
-    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1))
-        .SetReturn(&fake_const_buffer_2);
-    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2))
-        .SetReturn(&fake_const_buffer_1);
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
 
     ///act
-    result = constbuffer_array_get_all_buffers_size(afterAdd2, &all_buffers_size);
+    bool result = constbuffer_array_content_equal(left, right);
 
     ///assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_IS_FALSE(result);
 
-    // cleanup
-    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
-    constbuffer_array_dec_ref(afterAdd1);
-    constbuffer_array_dec_ref(afterAdd2);
+    ///clean
+    constbuffer_array_dec_ref(left);
+    constbuffer_array_dec_ref(right);
+    constbuffer_array_dec_ref(original);
 }
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_021: [ If summing up the sizes results in an uint32_t overflow, shall fail and return a non-zero value. ]*/
-TEST_FUNCTION(constbuffer_array_get_all_buffers_size_max_all_size_succeeds)
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_052: [ constbuffer_array_content_equal shall call constbuffer_array_get_all_buffers_size_64 on left and right. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_054: [ If the sizes of left and right are different then constbuffer_array_content_equal shall return false. ]*/
+TEST_FUNCTION(constbuffer_array_content_equal_with_different_sizes_returns_false)
 {
     ///arrange
-    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
-    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_front(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, TEST_CONSTBUFFER_HANDLE_1);
-    CONSTBUFFER_ARRAY_HANDLE afterAdd2 = TEST_constbuffer_array_add_front(afterAdd1, 1, TEST_CONSTBUFFER_HANDLE_2);
-    uint32_t all_buffers_size;
-    int result;
-    const CONSTBUFFER fake_const_buffer_1 = { (const unsigned char*)0x4242, UINT32_MAX - 1 };
-    const CONSTBUFFER fake_const_buffer_2 = { (const unsigned char*)0x4242, 1 };
+    CONSTBUFFER_ARRAY_HANDLE left = TEST_constbuffer_array_create(2, 0);
+    CONSTBUFFER_ARRAY_HANDLE right = TEST_constbuffer_array_create(2, 1);
 
-    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2))
-        .SetReturn(&fake_const_buffer_2);
-    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1))
-        .SetReturn(&fake_const_buffer_1);
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
 
     ///act
-    result = constbuffer_array_get_all_buffers_size(afterAdd2, &all_buffers_size);
+    bool result = constbuffer_array_content_equal(left, right);
 
     ///assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_ARE_EQUAL(int, 0, result);
-    ASSERT_ARE_EQUAL(int, UINT32_MAX, all_buffers_size);
+    ASSERT_IS_FALSE(result);
 
-    // cleanup
-    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
-    constbuffer_array_dec_ref(afterAdd1);
-    constbuffer_array_dec_ref(afterAdd2);
+    ///clean
+    constbuffer_array_dec_ref(left);
+    constbuffer_array_dec_ref(right);
 }
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_021: [ If summing up the sizes results in an uint32_t overflow, shall fail and return a non-zero value. ]*/
-TEST_FUNCTION(constbuffer_array_get_all_buffers_size_max_all_size_succeeds_when_array_add_back)
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_056: [ Otherwise constbuffer_array_content_equal shall compare the bytes of left and right as if each array was one contiguous buffer (regardless of how the bytes are split in buffers) and return true if they are the same and false otherwise. ]*/
+TEST_FUNCTION(constbuffer_array_content_equal_with_the_same_bytes_split_differently_returns_true)
 {
     ///arrange
-    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
-    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_back(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, TEST_CONSTBUFFER_HANDLE_1);
-    CONSTBUFFER_ARRAY_HANDLE afterAdd2 = TEST_constbuffer_array_add_back(afterAdd1, 1, TEST_CONSTBUFFER_HANDLE_2);
-    uint32_t all_buffers_size;
-    int result;
-    const CONSTBUFFER fake_const_buffer_1 = { (const unsigned char*)0x4242, UINT32_MAX - 1 };
-    const CONSTBUFFER fake_const_buffer_2 = { (const unsigned char*)0x4242, 1 };
+    static const unsigned char content[] = { 'a', 'b', 'c', 'd', 'e', 'f', 'g' };
+    static const uint32_t left_split[] = { 1, 0, 4, 2 };
+    static const uint32_t right_split[] = { 3, 3, 1, 0 };
+    CONSTBUFFER_ARRAY_HANDLE left = TEST_constbuffer_array_create_split(content, left_split, sizeof(left_split) / sizeof(left_split[0]));
+    CONSTBUFFER_ARRAY_HANDLE right = TEST_constbuffer_array_create_split(content, right_split, sizeof(right_split) / sizeof(right_split[0]));
+    uint64_t size;
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_all_buffers_size_64(left, &size));
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_all_buffers_size_64(right, &size));
+    umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1))
-        .SetReturn(&fake_const_buffer_2);
-    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2))
-        .SetReturn(&fake_const_buffer_1);
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+    // chunks: a | bc | de | f | g, the empty buffer at the end of right is not read
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(IGNORED_ARG));
 
     ///act
-    result = constbuffer_array_get_all_buffers_size(afterAdd2, &all_buffers_size);
+    bool result = constbuffer_array_content_equal(left, right);
 
     ///assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_ARE_EQUAL(int, 0, result);
-    ASSERT_ARE_EQUAL(int, UINT32_MAX, all_buffers_size);
+    ASSERT_IS_TRUE(result);
 
-    // cleanup
-    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
-    constbuffer_array_dec_ref(afterAdd1);
-    constbuffer_array_dec_ref(afterAdd2);
+    ///clean
+    constbuffer_array_dec_ref(left);
+    constbuffer_array_dec_ref(right);
 }
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_022: [ Otherwise constbuffer_array_get_all_buffers_size shall write in all_buffers_size the total size of all buffers in the array and return 0. ]*/
-TEST_FUNCTION(constbuffer_array_get_all_buffers_on_empty_const_buffer_array_succeeds)
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_056: [ Otherwise constbuffer_array_content_equal shall compare the bytes of left and right as if each array was one contiguous buffer (regardless of how the bytes are split in buffers) and return true if they are the same and false otherwise. ]*/
+TEST_FUNCTION(constbuffer_array_content_equal_with_different_bytes_returns_false)
 {
     ///arrange
-    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
-    uint32_t all_buffers_size;
-    int result;
+    static const unsigned char left_content[] = { 'a', 'b', 'c', 'd', 'e', 'f', 'g' };
+    static const unsigned char right_content[] = { 'a', 'b', 'c', 'd', 'e', 'f', 'h' };
+    static const uint32_t left_split[] = { 1, 0, 4, 2 };
+    static const uint32_t right_split[] = { 3, 3, 1, 0 };
+    CONSTBUFFER_ARRAY_HANDLE left = TEST_constbuffer_array_create_split(left_content, left_split, sizeof(left_split) / sizeof(left_split[0]));
+    CONSTBUFFER_ARRAY_HANDLE right = TEST_constbuffer_array_create_split(right_content, right_split, sizeof(right_split) / sizeof(right_split[0]));
 
     ///act
-    result = constbuffer_array_get_all_buffers_size(TEST_CONSTBUFFER_ARRAY_HANDLE, &all_buffers_size);
+    bool result = constbuffer_array_content_equal(left, right);
 
     ///assert
-    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_ARE_EQUAL(int, 0, result);
-    ASSERT_ARE_EQUAL(uint32_t, 0, all_buffers_size);
+    ASSERT_IS_FALSE(result);
 
-    // cleanup
-    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
+    ///clean
+    constbuffer_array_dec_ref(left);
+    constbuffer_array_dec_ref(right);
 }
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_022: [ Otherwise constbuffer_array_get_all_buffers_size shall write in all_buffers_size the total size of all buffers in the array and return 0. ]*/
-TEST_FUNCTION(constbuffer_array_get_all_buffers_size_with_1_buffer_succeeds)
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_056: [ Otherwise constbuffer_array_content_equal shall compare the bytes of left and right as if each array was one contiguous buffer (regardless of how the bytes are split in buffers) and return true if they are the same and false otherwise. ]*/
+TEST_FUNCTION(constbuffer_array_content_equal_with_big_buffers_finds_every_different_byte)
 {
     ///arrange
-    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
-    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_front(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, TEST_CONSTBUFFER_HANDLE_1);
-    uint32_t all_buffers_size;
-    int result;
+    unsigned char left_content[300];
+    unsigned char right_content[300];
+    static const uint32_t left_split[] = { 100, 200 };
+    static const uint32_t right_split[] = { 7, 130, 0, 163 };
+    for (uint32_t i = 0; i < sizeof(left_content); i++)
+    {
+        left_content[i] = (unsigned char)(i * 7);
+    }
+    (void)memcpy(right_content, left_content, sizeof(right_content));
+    CONSTBUFFER_ARRAY_HANDLE left = TEST_constbuffer_array_create_split(left_content, left_split, sizeof(left_split) / sizeof(left_split[0]));
 
-    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1));
+    for (uint32_t i = 0; i < sizeof(right_content); i++)
+    {
+        right_content[i]++;
+        CONSTBUFFER_ARRAY_HANDLE right = TEST_constbuffer_array_create_split(right_content, right_split, sizeof(right_split) / sizeof(right_split[0]));
 
-    ///act
-    result = constbuffer_array_get_all_buffers_size(afterAdd1, &all_buffers_size);
+        ///act
+        bool result = constbuffer_array_content_equal(left, right);
 
-    ///assert
-    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_ARE_EQUAL(int, 0, result);
-    ASSERT_ARE_EQUAL(uint32_t, 1, all_buffers_size);
+        ///assert
+        ASSERT_IS_FALSE(result, "byte %" PRIu32 " is different", i);
 
-    // cleanup
-    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
-    constbuffer_array_dec_ref(afterAdd1);
+        ///clean
+        constbuffer_array_dec_ref(right);
+        right_content[i]--;
+    }
+
+    CONSTBUFFER_ARRAY_HANDLE same = TEST_constbuffer_array_create_split(right_content, right_split, sizeof(right_split) / sizeof(right_split[0]));
+    ASSERT_IS_TRUE(constbuffer_array_content_equal(left, same));
+
+    ///clean
+    constbuffer_array_dec_ref(same);
+    constbuffer_array_dec_ref(left);
 }
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_022: [ Otherwise constbuffer_array_get_all_buffers_size shall write in all_buffers_size the total size of all buffers in the array and return 0. ]*/
-TEST_FUNCTION(constbuffer_array_get_all_buffers_size_with_1_buffer_succeeds_when_array_add_back)
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_055: [ If the fingerprints of left and right are both known (computed by constbuffer_array_get_fingerprint) and are different then constbuffer_array_content_equal shall return false without reading the buffers. ]*/
+TEST_FUNCTION(constbuffer_array_content_equal_with_different_known_fingerprints_returns_false_without_reading_the_buffers)
 {
     ///arrange
-    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
-    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_back(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, TEST_CONSTBUFFER_HANDLE_1);
-    uint32_t all_buffers_size;
-    int result;
+    static const unsigned char left_content[] = { 'a', 'b', 'c' };
+    static const unsigned char right_content[] = { 'a', 'b', 'd' };
+    static const uint32_t split[] = { 3 };
+    CONSTBUFFER_ARRAY_HANDLE left = TEST_constbuffer_array_create_split(left_content, split, 1);
+    CONSTBUFFER_ARRAY_HANDLE right = TEST_constbuffer_array_create_split(right_content, split, 1);
+    uint64_t size;
+    uint64_t fingerprint;
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_all_buffers_size_64(left, &size));
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_all_buffers_size_64(right, &size));
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_fingerprint(left, &fingerprint));
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_fingerprint(right, &fingerprint));
+    umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1));
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
 
     ///act
-    result = constbuffer_array_get_all_buffers_size(afterAdd1, &all_buffers_size);
+    bool result = constbuffer_array_content_equal(left, right);
 
     ///assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_ARE_EQUAL(int, 0, result);
-    ASSERT_ARE_EQUAL(uint32_t, 1, all_buffers_size);
+    ASSERT_IS_FALSE(result);
 
-    // cleanup
-    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
-    constbuffer_array_dec_ref(afterAdd1);
+    ///clean
+    constbuffer_array_dec_ref(left);
+    constbuffer_array_dec_ref(right);
 }
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_022: [ Otherwise constbuffer_array_get_all_buffers_size shall write in all_buffers_size the total size of all buffers in the array and return 0. ]*/
-TEST_FUNCTION(constbuffer_array_get_all_buffers_size_with_2_buffers_succeeds)
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_056: [ Otherwise constbuffer_array_content_equal shall compare the bytes of left and right as if each array was one contiguous buffer (regardless of how the bytes are split in buffers) and return true if they are the same and false otherwise. ]*/
+TEST_FUNCTION(constbuffer_array_content_equal_with_the_same_known_fingerprints_compares_the_bytes)
 {
     ///arrange
-    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
-    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_front(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, TEST_CONSTBUFFER_HANDLE_1);
-    CONSTBUFFER_ARRAY_HANDLE afterAdd2 = TEST_constbuffer_array_add_front(afterAdd1, 1, TEST_CONSTBUFFER_HANDLE_2);
-    uint32_t all_buffers_size;
-    int result;
-
-    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2));
-    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1));
+    static const unsigned char content[] = { 'a', 'b', 'c' };
+    static const uint32_t left_split[] = { 3 };
+    static const uint32_t right_split[] = { 1, 2 };
+    CONSTBUFFER_ARRAY_HANDLE left = TEST_constbuffer_array_create_split(content, left_split, 1);
+    CONSTBUFFER_ARRAY_HANDLE right = TEST_constbuffer_array_create_split(content, right_split, 2);
+    uint64_t fingerprint;
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_fingerprint(left, &fingerprint));
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_fingerprint(right, &fingerprint));
+    umock_c_reset_all_calls();
 
     ///act
-    result = constbuffer_array_get_all_buffers_size(afterAdd2, &all_buffers_size);
+    bool result = constbuffer_array_content_equal(left, right);
 
     ///assert
-    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_ARE_EQUAL(int, 0, result);
-    ASSERT_ARE_EQUAL(uint32_t, 3, all_buffers_size);
+    ASSERT_IS_TRUE(result);
 
-    // cleanup
-    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
-    constbuffer_array_dec_ref(afterAdd1);
-    constbuffer_array_dec_ref(afterAdd2);
+    ///clean
+    constbuffer_array_dec_ref(left);
+    constbuffer_array_dec_ref(right);
 }
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_022: [ Otherwise constbuffer_array_get_all_buffers_size shall write in all_buffers_size the total size of all buffers in the array and return 0. ]*/
-TEST_FUNCTION(constbuffer_array_get_all_buffers_size_with_2_buffers_succeeds_when_array_add_back)
+/* constbuffer_array_find */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_057: [ If constbuffer_array_handle is NULL then constbuffer_array_find shall fail and return CONSTBUFFER_ARRAY_FIND_RESULT_INVALID_ARG. ]*/
+TEST_FUNCTION(constbuffer_array_find_with_NULL_constbuffer_array_handle_fails)
 {
     ///arrange
-    CONSTBUFFER_ARRAY_HANDLE TEST_CONSTBUFFER_ARRAY_HANDLE = TEST_constbuffer_array_create_empty();
-    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_back(TEST_CONSTBUFFER_ARRAY_HANDLE, 0, TEST_CONSTBUFFER_HANDLE_1);
-    CONSTBUFFER_ARRAY_HANDLE afterAdd2 = TEST_constbuffer_array_add_back(afterAdd1, 1, TEST_CONSTBUFFER_HANDLE_2);
-    uint32_t all_buffers_size;
-    int result;
-
-    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_1));
-    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(TEST_CONSTBUFFER_HANDLE_2));
+    static const unsigned char pattern[] = { 'a', 'b' };
+    CONSTBUFFER_ARRAY_POSITION position;
 
     ///act
-    result = constbuffer_array_get_all_buffers_size(afterAdd2, &all_buffers_size);
+    CONSTBUFFER_ARRAY_FIND_RESULT result = constbuffer_array_find(NULL, pattern, sizeof(pattern), 0, &position);
 
     ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_FIND_RESULT, CONSTBUFFER_ARRAY_FIND_RESULT_INVALID_ARG, result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_ARE_EQUAL(int, 0, result);
-    ASSERT_ARE_EQUAL(uint32_t, 3, all_buffers_size);
-
-    // cleanup
-    constbuffer_array_dec_ref(TEST_CONSTBUFFER_ARRAY_HANDLE);
-    constbuffer_array_dec_ref(afterAdd1);
-    constbuffer_array_dec_ref(afterAdd2);
 }
 
-/* constbuffer_array_get_const_buffer_handle_array */
-
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_026: [ If constbuffer_array_handle is NULL, constbuffer_array_get_const_buffer_handle_array shall fail and return NULL. ]*/
-TEST_FUNCTION(constbuffer_array_get_const_buffer_handle_array_with_NULL_constbuffer_array_handle_fails)
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_058: [ If pattern is NULL then constbuffer_array_find shall fail and return CONSTBUFFER_ARRAY_FIND_RESULT_INVALID_ARG. ]*/
+TEST_FUNCTION(constbuffer_array_find_with_NULL_pattern_fails)
 {
     ///arrange
-    const CONSTBUFFER_HANDLE* result;
+    static const unsigned char content[] = { 'a', 'b', 'c' };
+    static const uint32_t split[] = { 3 };
+    CONSTBUFFER_ARRAY_HANDLE array = TEST_constbuffer_array_create_split(content, split, 1);
+    CONSTBUFFER_ARRAY_POSITION position;
 
     ///act
-    result = constbuffer_array_get_const_buffer_handle_array(NULL);
+    CONSTBUFFER_ARRAY_FIND_RESULT result = constbuffer_array_find(array, NULL, 2, 0, &position);
 
     ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_FIND_RESULT, CONSTBUFFER_ARRAY_FIND_RESULT_INVALID_ARG, result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_IS_NULL(result);
+
+    ///clean
+    constbuffer_array_dec_ref(array);
 }
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_027: [ Otherwise constbuffer_array_get_const_buffer_handle_array shall return the array of const buffer handles backing the const buffer array. ]*/
-TEST_FUNCTION(constbuffer_array_get_const_buffer_handle_array_with_empty_array_succeeds)
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_059: [ If pattern_length is 0 then constbuffer_array_find shall fail and return CONSTBUFFER_ARRAY_FIND_RESULT_INVALID_ARG. ]*/
+TEST_FUNCTION(constbuffer_array_find_with_0_pattern_length_fails)
 {
     ///arrange
-    const CONSTBUFFER_HANDLE* result;
-    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = constbuffer_array_create_empty();
-    umock_c_reset_all_calls();
+    static const unsigned char content[] = { 'a', 'b', 'c' };
+    static const uint32_t split[] = { 3 };
+    CONSTBUFFER_ARRAY_HANDLE array = TEST_constbuffer_array_create_split(content, split, 1);
+    CONSTBUFFER_ARRAY_POSITION position;
 
     ///act
-    result = constbuffer_array_get_const_buffer_handle_array(constbuffer_array);
+    CONSTBUFFER_ARRAY_FIND_RESULT result = constbuffer_array_find(array, content, 0, 0, &position);
 
     ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_FIND_RESULT, CONSTBUFFER_ARRAY_FIND_RESULT_INVALID_ARG, result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_IS_NOT_NULL(result);
 
-    /// cleanup
-    constbuffer_array_dec_ref(constbuffer_array);
+    ///clean
+    constbuffer_array_dec_ref(array);
 }
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_027: [ Otherwise constbuffer_array_get_const_buffer_handle_array shall return the array of const buffer handles backing the const buffer array. ]*/
-TEST_FUNCTION(constbuffer_array_get_const_buffer_handle_array_with_array_with_1_buffer_succeeds_when_array_add_back)
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_060: [ If position is NULL then constbuffer_array_find shall fail and return CONSTBUFFER_ARRAY_FIND_RESULT_INVALID_ARG. ]*/
+TEST_FUNCTION(constbuffer_array_find_with_NULL_position_fails)
 {
     ///arrange
-    const CONSTBUFFER_HANDLE* result;
-    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = constbuffer_array_create_empty();
-    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_back(constbuffer_array, 0, TEST_CONSTBUFFER_HANDLE_1);
-    umock_c_reset_all_calls();
+    static const unsigned char content[] = { 'a', 'b', 'c' };
+    static const uint32_t split[] = { 3 };
+    CONSTBUFFER_ARRAY_HANDLE array = TEST_constbuffer_array_create_split(content, split, 1);
 
     ///act
-    result = constbuffer_array_get_const_buffer_handle_array(afterAdd1);
+    CONSTBUFFER_ARRAY_FIND_RESULT result = constbuffer_array_find(array, content, 2, 0, NULL);
 
     ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_FIND_RESULT, CONSTBUFFER_ARRAY_FIND_RESULT_INVALID_ARG, result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_IS_NOT_NULL(result);
-    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_1, result[0]);
 
-    /// cleanup
-    constbuffer_array_dec_ref(constbuffer_array);
-    constbuffer_array_dec_ref(afterAdd1);
+    ///clean
+    constbuffer_array_dec_ref(array);
 }
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_027: [ Otherwise constbuffer_array_get_const_buffer_handle_array shall return the array of const buffer handles backing the const buffer array. ]*/
-TEST_FUNCTION(constbuffer_array_get_const_buffer_handle_array_with_array_with_1_buffer_succeeds)
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_061: [ constbuffer_array_find shall look for the first position at or after start_offset where the bytes of the array (seen as one contiguous buffer, so that a match can span several buffers) are the pattern_length bytes of pattern. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_062: [ If there is such a position then constbuffer_array_find shall write in position its offset from the start of the array, the index of the buffer where the match starts and the offset of the match in that buffer and return CONSTBUFFER_ARRAY_FIND_RESULT_OK. ]*/
+TEST_FUNCTION(constbuffer_array_find_finds_the_pattern_inside_a_buffer)
 {
     ///arrange
-    const CONSTBUFFER_HANDLE* result;
-    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = constbuffer_array_create_empty();
-    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_front(constbuffer_array, 0, TEST_CONSTBUFFER_HANDLE_1);
-    umock_c_reset_all_calls();
+    static const unsigned char content[] = { 'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h' };
+    static const uint32_t split[] = { 3, 5 };
+    static const unsigned char pattern[] = { 'e', 'f' };
+    CONSTBUFFER_ARRAY_HANDLE array = TEST_constbuffer_array_create_split(content, split, sizeof(split) / sizeof(split[0]));
+    CONSTBUFFER_ARRAY_POSITION position;
+
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(IGNORED_ARG));
 
     ///act
-    result = constbuffer_array_get_const_buffer_handle_array(afterAdd1);
+    CONSTBUFFER_ARRAY_FIND_RESULT result = constbuffer_array_find(array, pattern, sizeof(pattern), 0, &position);
 
     ///assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_IS_NOT_NULL(result);
-    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_1, result[0]);
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_FIND_RESULT, CONSTBUFFER_ARRAY_FIND_RESULT_OK, result);
+    ASSERT_ARE_EQUAL(uint64_t, 4, position.offset);
+    ASSERT_ARE_EQUAL(uint32_t, 1, position.buffer_index);
+    ASSERT_ARE_EQUAL(uint32_t, 1, position.buffer_offset);
 
-    /// cleanup
-    constbuffer_array_dec_ref(constbuffer_array);
-    constbuffer_array_dec_ref(afterAdd1);
+    ///clean
+    constbuffer_array_dec_ref(array);
 }
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_027: [ Otherwise constbuffer_array_get_const_buffer_handle_array shall return the array of const buffer handles backing the const buffer array. ]*/
-TEST_FUNCTION(constbuffer_array_get_const_buffer_handle_array_with_array_with_1_buffer_succeeds_with_array_add_back)
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_061: [ constbuffer_array_find shall look for the first position at or after start_offset where the bytes of the array (seen as one contiguous buffer, so that a match can span several buffers) are the pattern_length bytes of pattern. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_062: [ If there is such a position then constbuffer_array_find shall write in position its offset from the start of the array, the index of the buffer where the match starts and the offset of the match in that buffer and return CONSTBUFFER_ARRAY_FIND_RESULT_OK. ]*/
+TEST_FUNCTION(constbuffer_array_find_finds_a_pattern_that_spans_several_buffers)
 {
     ///arrange
-    const CONSTBUFFER_HANDLE* result;
-    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = constbuffer_array_create_empty();
-    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_back(constbuffer_array, 0, TEST_CONSTBUFFER_HANDLE_1);
-    umock_c_reset_all_calls();
+    static const unsigned char content[] = { 'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h' };
+    static const uint32_t split[] = { 3, 0, 2, 3 };
+    static const unsigned char pattern[] = { 'b', 'c', 'd', 'e', 'f' };
+    CONSTBUFFER_ARRAY_HANDLE array = TEST_constbuffer_array_create_split(content, split, sizeof(split) / sizeof(split[0]));
+    CONSTBUFFER_ARRAY_POSITION position;
+
+    // abc, then the rest of the pattern is compared with the empty buffer, de and fgh
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(IGNORED_ARG));
 
     ///act
-    result = constbuffer_array_get_const_buffer_handle_array(afterAdd1);
+    CONSTBUFFER_ARRAY_FIND_RESULT result = constbuffer_array_find(array, pattern, sizeof(pattern), 0, &position);
 
     ///assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_IS_NOT_NULL(result);
-    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_1, result[0]);
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_FIND_RESULT, CONSTBUFFER_ARRAY_FIND_RESULT_OK, result);
+    ASSERT_ARE_EQUAL(uint64_t, 1, position.offset);
+    ASSERT_ARE_EQUAL(uint32_t, 0, position.buffer_index);
+    ASSERT_ARE_EQUAL(uint32_t, 1, position.buffer_offset);
 
-    /// cleanup
-    constbuffer_array_dec_ref(constbuffer_array);
-    constbuffer_array_dec_ref(afterAdd1);
+    ///clean
+    constbuffer_array_dec_ref(array);
 }
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_027: [ Otherwise constbuffer_array_get_const_buffer_handle_array shall return the array of const buffer handles backing the const buffer array. ]*/
-TEST_FUNCTION(constbuffer_array_get_const_buffer_handle_array_with_array_with_2_buffers_succeeds)
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_061: [ constbuffer_array_find shall look for the first position at or after start_offset where the bytes of the array (seen as one contiguous buffer, so that a match can span several buffers) are the pattern_length bytes of pattern. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_063: [ Otherwise (including when start_offset is not less than the size of the array) constbuffer_array_find shall return CONSTBUFFER_ARRAY_FIND_RESULT_NOT_FOUND. ]*/
+TEST_FUNCTION(constbuffer_array_find_with_start_offset_finds_the_next_matches)
 {
     ///arrange
-    const CONSTBUFFER_HANDLE* result;
-    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = constbuffer_array_create_empty();
-    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_front(constbuffer_array, 0, TEST_CONSTBUFFER_HANDLE_1);
-    CONSTBUFFER_ARRAY_HANDLE afterAdd2 = TEST_constbuffer_array_add_front(afterAdd1, 0, TEST_CONSTBUFFER_HANDLE_2);
-    umock_c_reset_all_calls();
+    static const unsigned char content[] = { 'a', 'b', '-', 'a', 'b', '-', 'a', 'b' };
+    static const uint32_t split[] = { 1, 3, 4 };
+    static const unsigned char pattern[] = { 'a', 'b' };
+    CONSTBUFFER_ARRAY_HANDLE array = TEST_constbuffer_array_create_split(content, split, sizeof(split) / sizeof(split[0]));
+    CONSTBUFFER_ARRAY_POSITION position_1;
+    CONSTBUFFER_ARRAY_POSITION position_2;
+    CONSTBUFFER_ARRAY_POSITION position_3;
+    CONSTBUFFER_ARRAY_POSITION position_4;
 
     ///act
-    result = constbuffer_array_get_const_buffer_handle_array(afterAdd2);
+    CONSTBUFFER_ARRAY_FIND_RESULT result_1 = constbuffer_array_find(array, pattern, sizeof(pattern), 0, &position_1);
+    CONSTBUFFER_ARRAY_FIND_RESULT result_2 = constbuffer_array_find(array, pattern, sizeof(pattern), position_1.offset + 1, &position_2);
+    CONSTBUFFER_ARRAY_FIND_RESULT result_3 = constbuffer_array_find(array, pattern, sizeof(pattern), position_2.offset + 1, &position_3);
+    CONSTBUFFER_ARRAY_FIND_RESULT result_4 = constbuffer_array_find(array, pattern, sizeof(pattern), position_3.offset + 1, &position_4);
 
     ///assert
-    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_IS_NOT_NULL(result);
-    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_2, result[0]);
-    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_1, result[1]);
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_FIND_RESULT, CONSTBUFFER_ARRAY_FIND_RESULT_OK, result_1);
+    ASSERT_ARE_EQUAL(uint64_t, 0, position_1.offset);
+    ASSERT_ARE_EQUAL(uint32_t, 0, position_1.buffer_index);
+    ASSERT_ARE_EQUAL(uint32_t, 0, position_1.buffer_offset);
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_FIND_RESULT, CONSTBUFFER_ARRAY_FIND_RESULT_OK, result_2);
+    ASSERT_ARE_EQUAL(uint64_t, 3, position_2.offset);
+    ASSERT_ARE_EQUAL(uint32_t, 1, position_2.buffer_index);
+    ASSERT_ARE_EQUAL(uint32_t, 2, position_2.buffer_offset);
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_FIND_RESULT, CONSTBUFFER_ARRAY_FIND_RESULT_OK, result_3);
+    ASSERT_ARE_EQUAL(uint64_t, 6, position_3.offset);
+    ASSERT_ARE_EQUAL(uint32_t, 2, position_3.buffer_index);
+    ASSERT_ARE_EQUAL(uint32_t, 2, position_3.buffer_offset);
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_FIND_RESULT, CONSTBUFFER_ARRAY_FIND_RESULT_NOT_FOUND, result_4);
 
-    /// cleanup
-    constbuffer_array_dec_ref(constbuffer_array);
-    constbuffer_array_dec_ref(afterAdd1);
-    constbuffer_array_dec_ref(afterAdd2);
+    ///clean
+    constbuffer_array_dec_ref(array);
 }
 
-/* Tests_SRS_CONSTBUFFER_ARRAY_01_027: [ Otherwise constbuffer_array_get_const_buffer_handle_array shall return the array of const buffer handles backing the const buffer array. ]*/
-TEST_FUNCTION(constbuffer_array_get_const_buffer_handle_array_with_array_with_2_buffers_succeeds_with_array_add_back)
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_063: [ Otherwise (including when start_offset is not less than the size of the array) constbuffer_array_find shall return CONSTBUFFER_ARRAY_FIND_RESULT_NOT_FOUND. ]*/
+TEST_FUNCTION(constbuffer_array_find_when_the_array_ends_in_the_middle_of_the_pattern_returns_NOT_FOUND)
 {
     ///arrange
-    const CONSTBUFFER_HANDLE* result;
-    CONSTBUFFER_ARRAY_HANDLE constbuffer_array = constbuffer_array_create_empty();
-    CONSTBUFFER_ARRAY_HANDLE afterAdd1 = TEST_constbuffer_array_add_back(constbuffer_array, 0, TEST_CONSTBUFFER_HANDLE_1);
-    CONSTBUFFER_ARRAY_HANDLE afterAdd2 = TEST_constbuffer_array_add_back(afterAdd1, 0, TEST_CONSTBUFFER_HANDLE_2);
-    umock_c_reset_all_calls();
+    static const unsigned char content[] = { 'a', 'b', 'c', 'd', 'e' };
+    static const uint32_t split[] = { 3, 2 };
+    static const unsigned char pattern[] = { 'd', 'e', 'f' };
+    CONSTBUFFER_ARRAY_HANDLE array = TEST_constbuffer_array_create_split(content, split, sizeof(split) / sizeof(split[0]));
+    CONSTBUFFER_ARRAY_POSITION position;
 
     ///act
-    result = constbuffer_array_get_const_buffer_handle_array(afterAdd2);
+    CONSTBUFFER_ARRAY_FIND_RESULT result = constbuffer_array_find(array, pattern, sizeof(pattern), 0, &position);
 
     ///assert
-    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_IS_NOT_NULL(result);
-    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_2, result[1]);
-    ASSERT_ARE_EQUAL(void_ptr, TEST_CONSTBUFFER_HANDLE_1, result[0]);
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_FIND_RESULT, CONSTBUFFER_ARRAY_FIND_RESULT_NOT_FOUND, result);
 
-    /// cleanup
-    constbuffer_array_dec_ref(constbuffer_array);
-    constbuffer_array_dec_ref(afterAdd1);
-    constbuffer_array_dec_ref(afterAdd2);
+    ///clean
+    constbuffer_array_dec_ref(array);
 }
 
-/*Tests_SRS_CONSTBUFFER_ARRAY_02_050: [ If left is NULL and right is NULL then CONSTBUFFER_ARRAY_HANDLE_contain_same shall return true. ]*/
-TEST_FUNCTION(CONSTBUFFER_ARRAY_HANDLE_contain_same_with_left_NULL_and_right_NULL_returns_true)
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_063: [ Otherwise (including when start_offset is not less than the size of the array) constbuffer_array_find shall return CONSTBUFFER_ARRAY_FIND_RESULT_NOT_FOUND. ]*/
+TEST_FUNCTION(constbuffer_array_find_with_start_offset_at_the_end_returns_NOT_FOUND)
 {
     ///arrange
-    bool result;
+    static const unsigned char content[] = { 'a', 'b', 'c' };
+    static const uint32_t split[] = { 1, 2 };
+    CONSTBUFFER_ARRAY_HANDLE array = TEST_constbuffer_array_create_split(content, split, sizeof(split) / sizeof(split[0]));
+    CONSTBUFFER_ARRAY_POSITION position;
 
     ///act
-    result = CONSTBUFFER_ARRAY_HANDLE_contain_same(NULL, NULL);
+    CONSTBUFFER_ARRAY_FIND_RESULT result_at_the_end = constbuffer_array_find(array, content + 2, 1, 3, &position);
+    CONSTBUFFER_ARRAY_FIND_RESULT result_past_the_end = constbuffer_array_find(array, content + 2, 1, UINT64_MAX, &position);
 
     ///assert
-    ASSERT_IS_TRUE(result);
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_FIND_RESULT, CONSTBUFFER_ARRAY_FIND_RESULT_NOT_FOUND, result_at_the_end);
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_FIND_RESULT, CONSTBUFFER_ARRAY_FIND_RESULT_NOT_FOUND, result_past_the_end);
+
+    ///clean
+    constbuffer_array_dec_ref(array);
 }
 
-/*Tests_SRS_CONSTBUFFER_ARRAY_02_051: [ If left is NULL and right is not NULL then CONSTBUFFER_ARRAY_HANDLE_contain_same shall return false. ]*/
-TEST_FUNCTION(CONSTBUFFER_ARRAY_HANDLE_contain_same_with_left_NULL_and_right_non_NULL_returns_false)
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_063: [ Otherwise (including when start_offset is not less than the size of the array) constbuffer_array_find shall return CONSTBUFFER_ARRAY_FIND_RESULT_NOT_FOUND. ]*/
+TEST_FUNCTION(constbuffer_array_find_in_an_empty_array_returns_NOT_FOUND)
 {
     ///arrange
-    bool result;
-    CONSTBUFFER_ARRAY_HANDLE right = constbuffer_array_create(&TEST_CONSTBUFFER_HANDLE_1, 1);
-    ASSERT_IS_NOT_NULL(right);
+    static const unsigned char pattern[] = { 'a' };
+    CONSTBUFFER_ARRAY_HANDLE array = constbuffer_array_create_empty();
+    ASSERT_IS_NOT_NULL(array);
+    CONSTBUFFER_ARRAY_POSITION position;
     umock_c_reset_all_calls();
 
     ///act
-    result = CONSTBUFFER_ARRAY_HANDLE_contain_same(NULL, right);
+    CONSTBUFFER_ARRAY_FIND_RESULT result = constbuffer_array_find(array, pattern, sizeof(pattern), 0, &position);
 
     ///assert
-    ASSERT_IS_FALSE(result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_FIND_RESULT, CONSTBUFFER_ARRAY_FIND_RESULT_NOT_FOUND, result);
 
     ///clean
-    constbuffer_array_dec_ref(right);
+    constbuffer_array_dec_ref(array);
 }
 
-/*Tests_SRS_CONSTBUFFER_ARRAY_02_052: [ If left is not NULL and right is NULL then CONSTBUFFER_ARRAY_HANDLE_contain_same shall return false. ]*/
-TEST_FUNCTION(CONSTBUFFER_ARRAY_HANDLE_contain_same_with_left_non_NULL_and_right_NULL_returns_false)
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_061: [ constbuffer_array_find shall look for the first position at or after start_offset where the bytes of the array (seen as one contiguous buffer, so that a match can span several buffers) are the pattern_length bytes of pattern. ]*/
+TEST_FUNCTION(constbuffer_array_find_skips_positions_where_only_the_first_and_the_last_byte_match)
 {
     ///arrange
-    bool result;
-    CONSTBUFFER_ARRAY_HANDLE left = constbuffer_array_create(&TEST_CONSTBUFFER_HANDLE_1, 1);
-    ASSERT_IS_NOT_NULL(left);
-    umock_c_reset_all_calls();
+    unsigned char content[100];
+    static const uint32_t split[] = { 100 };
+    static const unsigned char pattern[] = { 'a', 'b', 'b', 'a' };
+    (void)memset(content, 'a', sizeof(content));
+    content[97] = 'b';
+    content[98] = 'b';
+    CONSTBUFFER_ARRAY_HANDLE array = TEST_constbuffer_array_create_split(content, split, 1);
+    CONSTBUFFER_ARRAY_POSITION position;
 
     ///act
-    result = CONSTBUFFER_ARRAY_HANDLE_contain_same(left, NULL);
+    CONSTBUFFER_ARRAY_FIND_RESULT result = constbuffer_array_find(array, pattern, sizeof(pattern), 0, &position);
 
     ///assert
-    ASSERT_IS_FALSE(result);
-    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_FIND_RESULT, CONSTBUFFER_ARRAY_FIND_RESULT_OK, result);
+    ASSERT_ARE_EQUAL(uint64_t, 96, position.offset);
+    ASSERT_ARE_EQUAL(uint32_t, 0, position.buffer_index);
+    ASSERT_ARE_EQUAL(uint32_t, 96, position.buffer_offset);
 
     ///clean
-    constbuffer_array_dec_ref(left);
+    constbuffer_array_dec_ref(array);
 }
 
-/*Tests_SRS_CONSTBUFFER_ARRAY_02_053: [ If the number of CONSTBUFFER_HANDLEs in left is different then the number of CONSTBUFFER_HANDLEs in right then  CONSTBUFFER_ARRAY_HANDLE_contain_same shall return false. ]*/
-TEST_FUNCTION(CONSTBUFFER_ARRAY_HANDLE_contain_same_with_different_number_of_buffers_return_false)
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_061: [ constbuffer_array_find shall look for the first position at or after start_offset where the bytes of the array (seen as one contiguous buffer, so that a match can span several buffers) are the pattern_length bytes of pattern. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_062: [ If there is such a position then constbuffer_array_find shall write in position its offset from the start of the array, the index of the buffer where the match starts and the offset of the match in that buffer and return CONSTBUFFER_ARRAY_FIND_RESULT_OK. ]*/
+TEST_FUNCTION(constbuffer_array_find_with_big_buffers_finds_every_position)
 {
     ///arrange
-    bool result;
-    CONSTBUFFER_ARRAY_HANDLE left = constbuffer_array_create(&TEST_CONSTBUFFER_HANDLE_1, 1);
-    ASSERT_IS_NOT_NULL(left);
+    unsigned char content[300];
+    static const uint32_t split[] = { 7, 130, 0, 163 };
+    static const uint32_t split_start[] = { 0, 7, 137, 137 };
+    for (uint32_t i = 0; i < sizeof(content); i++)
+    {
+        content[i] = (unsigned char)(i * 7);
+    }
+    CONSTBUFFER_ARRAY_HANDLE array = TEST_constbuffer_array_create_split(content, split, sizeof(split) / sizeof(split[0]));
 
-    CONSTBUFFER_HANDLE twoAndThree[2];
-    twoAndThree[0] = TEST_CONSTBUFFER_HANDLE_2;
-    twoAndThree[1] = TEST_CONSTBUFFER_HANDLE_3;
-    CONSTBUFFER_ARRAY_HANDLE right = constbuffer_array_create(twoAndThree, 2);
-    ASSERT_IS_NOT_NULL(right);
-    umock_c_reset_all_calls();
+    for (uint32_t i = 0; i + 8 <= sizeof(content); i++)
+    {
+        CONSTBUFFER_ARRAY_POSITION position;
 
-    ///act
-    result = CONSTBUFFER_ARRAY_HANDLE_contain_same(left, right);
+        ///act
+        CONSTBUFFER_ARRAY_FIND_RESULT result = constbuffer_array_find(array, content + i, 8, i, &position);
 
-    ///assert
-    ASSERT_IS_FALSE(result);
-    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ///assert
+        ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_FIND_RESULT, CONSTBUFFER_ARRAY_FIND_RESULT_OK, result, "pattern at %" PRIu32, i);
+        ASSERT_ARE_EQUAL(uint64_t, i, position.offset);
+        ASSERT_ARE_EQUAL(uint32_t, i, split_start[position.buffer_index] + position.buffer_offset);
+        ASSERT_IS_TRUE(position.buffer_offset < split[position.buffer_index]);
+    }
 
     ///clean
-    constbuffer_array_dec_ref(left);
-    constbuffer_array_dec_ref(right);
+    constbuffer_array_dec_ref(array);
 }
 
-/*Tests_SRS_CONSTBUFFER_ARRAY_02_054: [ If left and right CONSTBUFFER_HANDLEs at same index are different (as indicated by CONSTBUFFER_HANDLE_contain_same call) then CONSTBUFFER_ARRAY_HANDLE_contain_same shall return false. ]*/
-TEST_FUNCTION(CONSTBUFFER_ARRAY_HANDLE_contain_same_with_content_of_buffers_different_return_false)
+/* constbuffer_array_find_byte */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_064: [ If constbuffer_array_handle is NULL then constbuffer_array_find_byte shall fail and return CONSTBUFFER_ARRAY_FIND_RESULT_INVALID_ARG. ]*/
+TEST_FUNCTION(constbuffer_array_find_byte_with_NULL_constbuffer_array_handle_fails)
 {
     ///arrange
-    bool result;
-    CONSTBUFFER_HANDLE twoAndOne[2];
-    twoAndOne[0] = TEST_CONSTBUFFER_HANDLE_2;
-    twoAndOne[1] = TEST_CONSTBUFFER_HANDLE_1;
-    CONSTBUFFER_ARRAY_HANDLE left = constbuffer_array_create(twoAndOne, 2);
-    ASSERT_IS_NOT_NULL(left);
+    CONSTBUFFER_ARRAY_POSITION position;
 
-    CONSTBUFFER_HANDLE twoAndThree[2];
-    twoAndThree[0] = TEST_CONSTBUFFER_HANDLE_2;
-    twoAndThree[1] = TEST_CONSTBUFFER_HANDLE_3;
-    CONSTBUFFER_ARRAY_HANDLE right = constbuffer_array_create(twoAndThree, 2);
-    ASSERT_IS_NOT_NULL(right);
-    umock_c_reset_all_calls();
+    ///act
+    CONSTBUFFER_ARRAY_FIND_RESULT result = constbuffer_array_find_byte(NULL, ';', 0, &position);
 
-    STRICT_EXPECTED_CALL(CONSTBUFFER_HANDLE_contain_same(TEST_CONSTBUFFER_HANDLE_2, TEST_CONSTBUFFER_HANDLE_2));
-    STRICT_EXPECTED_CALL(CONSTBUFFER_HANDLE_contain_same(TEST_CONSTBUFFER_HANDLE_1, TEST_CONSTBUFFER_HANDLE_3));
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_FIND_RESULT, CONSTBUFFER_ARRAY_FIND_RESULT_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_065: [ If position is NULL then constbuffer_array_find_byte shall fail and return CONSTBUFFER_ARRAY_FIND_RESULT_INVALID_ARG. ]*/
+TEST_FUNCTION(constbuffer_array_find_byte_with_NULL_position_fails)
+{
+    ///arrange
+    static const unsigned char content[] = { 'a', ';', 'c' };
+    static const uint32_t split[] = { 3 };
+    CONSTBUFFER_ARRAY_HANDLE array = TEST_constbuffer_array_create_split(content, split, 1);
 
     ///act
-    result = CONSTBUFFER_ARRAY_HANDLE_contain_same(left, right);
+    CONSTBUFFER_ARRAY_FIND_RESULT result = constbuffer_array_find_byte(array, ';', 0, NULL);
 
     ///assert
-    ASSERT_IS_FALSE(result);
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_FIND_RESULT, CONSTBUFFER_ARRAY_FIND_RESULT_INVALID_ARG, result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
     ///clean
-    constbuffer_array_dec_ref(left);
-    constbuffer_array_dec_ref(right);
+    constbuffer_array_dec_ref(array);
 }
 
-/*Tests_SRS_CONSTBUFFER_ARRAY_02_055: [ CONSTBUFFER_ARRAY_HANDLE_contain_same shall return true. ]*/
-TEST_FUNCTION(CONSTBUFFER_ARRAY_HANDLE_contain_same_with_content_of_buffers_same_return_true)
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_066: [ constbuffer_array_find_byte shall look for the first byte at or after start_offset that is value. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_067: [ If there is such a byte then constbuffer_array_find_byte shall write in position its offset from the start of the array, the index of its buffer and its offset in that buffer and return CONSTBUFFER_ARRAY_FIND_RESULT_OK. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_068: [ Otherwise (including when start_offset is not less than the size of the array) constbuffer_array_find_byte shall return CONSTBUFFER_ARRAY_FIND_RESULT_NOT_FOUND. ]*/
+TEST_FUNCTION(constbuffer_array_find_byte_finds_the_first_byte_at_or_after_start_offset)
 {
     ///arrange
-    bool result;
-    CONSTBUFFER_HANDLE twoAndOne[2];
-    twoAndOne[0] = TEST_CONSTBUFFER_HANDLE_2;
-    twoAndOne[1] = TEST_CONSTBUFFER_HANDLE_1;
-    CONSTBUFFER_ARRAY_HANDLE left = constbuffer_array_create(twoAndOne, 2);
-    ASSERT_IS_NOT_NULL(left);
+    static const unsigned char content[] = { 'a', 'b', ';', 'c', ';' };
+    static const uint32_t split[] = { 2, 0, 3 };
+    CONSTBUFFER_ARRAY_HANDLE array = TEST_constbuffer_array_create_split(content, split, sizeof(split) / sizeof(split[0]));
+    CONSTBUFFER_ARRAY_POSITION position_1;
+    CONSTBUFFER_ARRAY_POSITION position_2;
+    CONSTBUFFER_ARRAY_POSITION position_3;
 
-    CONSTBUFFER_HANDLE alsoTwoAndOne[2];
-    alsoTwoAndOne[0] = TEST_CONSTBUFFER_HANDLE_2;
-    alsoTwoAndOne[1] = TEST_CONSTBUFFER_HANDLE_1;
-    CONSTBUFFER_ARRAY_HANDLE right = constbuffer_array_create(alsoTwoAndOne, 2);
-    ASSERT_IS_NOT_NULL(right);
-    umock_c_reset_all_calls();
+    ///act
+    CONSTBUFFER_ARRAY_FIND_RESULT result_1 = constbuffer_array_find_byte(array, ';', 0, &position_1);
+    CONSTBUFFER_ARRAY_FIND_RESULT result_2 = constbuffer_array_find_byte(array, ';', position_1.offset + 1, &position_2);
+    CONSTBUFFER_ARRAY_FIND_RESULT result_3 = constbuffer_array_find_byte(array, ';', position_2.offset + 1, &position_3);
 
-    STRICT_EXPECTED_CALL(CONSTBUFFER_HANDLE_contain_same(TEST_CONSTBUFFER_HANDLE_2, TEST_CONSTBUFFER_HANDLE_2));
-    STRICT_EXPECTED_CALL(CONSTBUFFER_HANDLE_contain_same(TEST_CONSTBUFFER_HANDLE_1, TEST_CONSTBUFFER_HANDLE_1));
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_FIND_RESULT, CONSTBUFFER_ARRAY_FIND_RESULT_OK, result_1);
+    ASSERT_ARE_EQUAL(uint64_t, 2, position_1.offset);
+    ASSERT_ARE_EQUAL(uint32_t, 2, position_1.buffer_index);
+    ASSERT_ARE_EQUAL(uint32_t, 0, position_1.buffer_offset);
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_FIND_RESULT, CONSTBUFFER_ARRAY_FIND_RESULT_OK, result_2);
+    ASSERT_ARE_EQUAL(uint64_t, 4, position_2.offset);
+    ASSERT_ARE_EQUAL(uint32_t, 2, position_2.buffer_index);
+    ASSERT_ARE_EQUAL(uint32_t, 2, position_2.buffer_offset);
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_FIND_RESULT, CONSTBUFFER_ARRAY_FIND_RESULT_NOT_FOUND, result_3);
+
+    ///clean
+    constbuffer_array_dec_ref(array);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_068: [ Otherwise (including when start_offset is not less than the size of the array) constbuffer_array_find_byte shall return CONSTBUFFER_ARRAY_FIND_RESULT_NOT_FOUND. ]*/
+TEST_FUNCTION(constbuffer_array_find_byte_when_the_byte_is_not_there_returns_NOT_FOUND)
+{
+    ///arrange
+    static const unsigned char content[] = { 'a', 'b', 'c', 'd' };
+    static const uint32_t split[] = { 2, 2 };
+    CONSTBUFFER_ARRAY_HANDLE array = TEST_constbuffer_array_create_split(content, split, sizeof(split) / sizeof(split[0]));
+    CONSTBUFFER_ARRAY_POSITION position;
+
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(IGNORED_ARG));
 
     ///act
-    result = CONSTBUFFER_ARRAY_HANDLE_contain_same(left, right);
+    CONSTBUFFER_ARRAY_FIND_RESULT result = constbuffer_array_find_byte(array, ';', 0, &position);
 
     ///assert
-    ASSERT_IS_TRUE(result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(CONSTBUFFER_ARRAY_FIND_RESULT, CONSTBUFFER_ARRAY_FIND_RESULT_NOT_FOUND, result);
 
     ///clean
-    constbuffer_array_dec_ref(left);
-    constbuffer_array_dec_ref(right);
+    constbuffer_array_dec_ref(array);
 }
 
 /* constbuffer_array_remove_empty_buffers */
@@ -3786,4 +6458,214 @@ TEST_FUNCTION(constbuffer_array_remove_empty_buffers_fails_when_malloc_fails)
     CONSTBUFFER_DecRef(empty_buffer);
 }
 
+/* constbuffer_array_create_compressed */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_001: [ If constbuffer_array_handle is NULL then constbuffer_array_create_compressed shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_create_compressed_with_NULL_handle_fails)
+{
+    ///arrange
+
+    ///act
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_create_compressed(NULL);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_002: [ constbuffer_array_create_compressed shall allocate memory for a new CONSTBUFFER_ARRAY_HANDLE that can hold as many buffers as constbuffer_array_handle. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_003: [ constbuffer_array_create_compressed shall call CONSTBUFFER_CreateCompressed for each buffer of constbuffer_array_handle and store the result in the new const buffer array. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_004: [ constbuffer_array_create_compressed shall succeed and return a non-NULL handle. ]*/
+TEST_FUNCTION(constbuffer_array_create_compressed_succeeds)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE buffers[3];
+    buffers[0] = TEST_CONSTBUFFER_HANDLE_1;
+    buffers[1] = TEST_CONSTBUFFER_HANDLE_2;
+    buffers[2] = TEST_CONSTBUFFER_HANDLE_3;
+    CONSTBUFFER_ARRAY_HANDLE original = constbuffer_array_create(buffers, 3);
+    ASSERT_IS_NOT_NULL(original);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 3, sizeof(CONSTBUFFER_HANDLE)));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(CONSTBUFFER_CreateCompressed(TEST_CONSTBUFFER_HANDLE_1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_CreateCompressed(TEST_CONSTBUFFER_HANDLE_2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_CreateCompressed(TEST_CONSTBUFFER_HANDLE_3));
+
+    ///act
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_create_compressed(original);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    uint32_t buffer_count;
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_buffer_count(result, &buffer_count));
+    ASSERT_ARE_EQUAL(uint32_t, 3, buffer_count);
+
+    ///cleanup
+    constbuffer_array_dec_ref(result);
+    constbuffer_array_dec_ref(original);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_005: [ If there are any failures then constbuffer_array_create_compressed shall release the buffers it created, fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_create_compressed_unhappy_paths)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE buffers[3];
+    buffers[0] = TEST_CONSTBUFFER_HANDLE_1;
+    buffers[1] = TEST_CONSTBUFFER_HANDLE_2;
+    buffers[2] = TEST_CONSTBUFFER_HANDLE_3;
+    CONSTBUFFER_ARRAY_HANDLE original = constbuffer_array_create(buffers, 3);
+    ASSERT_IS_NOT_NULL(original);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 3, sizeof(CONSTBUFFER_HANDLE)));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(CONSTBUFFER_CreateCompressed(TEST_CONSTBUFFER_HANDLE_1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_CreateCompressed(TEST_CONSTBUFFER_HANDLE_2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_CreateCompressed(TEST_CONSTBUFFER_HANDLE_3));
+
+    umock_c_negative_tests_snapshot();
+
+    for (size_t i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
+        if (umock_c_negative_tests_can_call_fail(i))
+        {
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(i);
+
+            ///act
+            CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_create_compressed(original);
+
+            ///assert
+            ASSERT_IS_NULL(result, "On failed call %lu", (unsigned long)i);
+        }
+    }
+
+    ///cleanup
+    constbuffer_array_dec_ref(original);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_005: [ If there are any failures then constbuffer_array_create_compressed shall release the buffers it created, fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_create_compressed_releases_the_buffers_it_created_when_CONSTBUFFER_CreateCompressed_fails)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE buffers[3];
+    buffers[0] = TEST_CONSTBUFFER_HANDLE_1;
+    buffers[1] = TEST_CONSTBUFFER_HANDLE_2;
+    buffers[2] = TEST_CONSTBUFFER_HANDLE_3;
+    CONSTBUFFER_ARRAY_HANDLE original = constbuffer_array_create(buffers, 3);
+    ASSERT_IS_NOT_NULL(original);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 3, sizeof(CONSTBUFFER_HANDLE)));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(CONSTBUFFER_CreateCompressed(TEST_CONSTBUFFER_HANDLE_1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_CreateCompressed(TEST_CONSTBUFFER_HANDLE_2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_CreateCompressed(TEST_CONSTBUFFER_HANDLE_3))
+        .SetReturn(NULL);
+    STRICT_EXPECTED_CALL(CONSTBUFFER_DecRef(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_DecRef(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    ///act
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_create_compressed(original);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    constbuffer_array_dec_ref(original);
+}
+
+/* constbuffer_array_create_decompressed */
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_006: [ If constbuffer_array_handle is NULL then constbuffer_array_create_decompressed shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_create_decompressed_with_NULL_handle_fails)
+{
+    ///arrange
+
+    ///act
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_create_decompressed(NULL);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_007: [ constbuffer_array_create_decompressed shall allocate memory for a new CONSTBUFFER_ARRAY_HANDLE that can hold as many buffers as constbuffer_array_handle. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_008: [ constbuffer_array_create_decompressed shall call CONSTBUFFER_Decompress for each buffer of constbuffer_array_handle and store the result in the new const buffer array. ]*/
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_009: [ constbuffer_array_create_decompressed shall succeed and return a non-NULL handle. ]*/
+TEST_FUNCTION(constbuffer_array_create_decompressed_reverses_constbuffer_array_create_compressed)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE buffers[3];
+    buffers[0] = TEST_CONSTBUFFER_HANDLE_1;
+    buffers[1] = TEST_CONSTBUFFER_HANDLE_2;
+    buffers[2] = TEST_CONSTBUFFER_HANDLE_3;
+    CONSTBUFFER_ARRAY_HANDLE original = constbuffer_array_create(buffers, 3);
+    ASSERT_IS_NOT_NULL(original);
+    CONSTBUFFER_ARRAY_HANDLE compressed = constbuffer_array_create_compressed(original);
+    ASSERT_IS_NOT_NULL(compressed);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 3, sizeof(CONSTBUFFER_HANDLE)));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(CONSTBUFFER_Decompress(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_Decompress(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_Decompress(IGNORED_ARG));
+
+    ///act
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_create_decompressed(compressed);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_TRUE(CONSTBUFFER_ARRAY_HANDLE_contain_same(original, result));
+
+    ///cleanup
+    constbuffer_array_dec_ref(result);
+    constbuffer_array_dec_ref(compressed);
+    constbuffer_array_dec_ref(original);
+}
+
+/*Tests_SRS_CONSTBUFFER_ARRAY_12_010: [ If there are any failures then constbuffer_array_create_decompressed shall release the buffers it created, fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_array_create_decompressed_releases_the_buffers_it_created_when_CONSTBUFFER_Decompress_fails)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE compressed_buffer = real_CONSTBUFFER_CreateCompressed(TEST_CONSTBUFFER_HANDLE_1);
+    ASSERT_IS_NOT_NULL(compressed_buffer);
+    CONSTBUFFER_HANDLE buffers[2];
+    buffers[0] = compressed_buffer;
+    buffers[1] = TEST_CONSTBUFFER_HANDLE_2; /*not compressed, CONSTBUFFER_Decompress fails on it*/
+    CONSTBUFFER_ARRAY_HANDLE compressed = constbuffer_array_create(buffers, 2);
+    ASSERT_IS_NOT_NULL(compressed);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 2, sizeof(CONSTBUFFER_HANDLE)));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(CONSTBUFFER_Decompress(compressed_buffer));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_Decompress(TEST_CONSTBUFFER_HANDLE_2));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_DecRef(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    ///act
+    CONSTBUFFER_ARRAY_HANDLE result = constbuffer_array_create_decompressed(compressed);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    constbuffer_array_dec_ref(compressed);
+    CONSTBUFFER_DecRef(compressed_buffer);
+}
+
 END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
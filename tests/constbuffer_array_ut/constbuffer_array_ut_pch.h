@@ -24,10 +24,12 @@
 #include "c_pal/gballoc_hl_redirect.h"
 #include "c_pal/interlocked.h"
 #include "c_util/constbuffer.h"
+#include "c_util/hash.h"
 #include "umock_c/umock_c_DISABLE_MOCKS.h" // ============================== DISABLE_MOCKS
 
 #include "real_interlocked.h"
 #include "real_constbuffer.h"
+#include "real_hash.h"
 #include "real_gballoc_hl.h"
 
 #include "c_util/constbuffer_array.h"
@@ -0,0 +1,729 @@
+// Copyright (c) Microsoft. All rights reserved.
+
+#include "constbuffer_dedup_store_ut_pch.h"
+
+MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    ASSERT_FAIL("umock_c reported error :%" PRI_MU_ENUM "", MU_ENUM_VALUE(UMOCK_C_ERROR_CODE, error_code));
+}
+
+static CONSTBUFFER_HANDLE generate_test_buffer(uint32_t size, unsigned char data)
+{
+    CONSTBUFFER_HANDLE result;
+
+    if (size == 0)
+    {
+        result = real_CONSTBUFFER_Create(NULL, 0);
+    }
+    else
+    {
+        unsigned char* memory = real_gballoc_hl_malloc(size);
+        ASSERT_IS_NOT_NULL(memory);
+
+        (void)memset(memory, data, size);
+
+        result = real_CONSTBUFFER_CreateWithMoveMemory(memory, size);
+    }
+    ASSERT_IS_NOT_NULL(result);
+
+    return result;
+}
+
+static CONSTBUFFER_DEDUP_STORE_HANDLE test_create_store(void)
+{
+    CONSTBUFFER_DEDUP_STORE_HANDLE store = constbuffer_dedup_store_create();
+    ASSERT_IS_NOT_NULL(store);
+    umock_c_reset_all_calls();
+    return store;
+}
+
+static void assert_statistics_are(CONSTBUFFER_DEDUP_STORE_HANDLE store, uint64_t intern_count, uint64_t hit_count, uint64_t saved_bytes, uint64_t entry_count, uint64_t stored_bytes)
+{
+    CONSTBUFFER_DEDUP_STORE_STATISTICS statistics;
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_dedup_store_get_statistics(store, &statistics));
+    ASSERT_ARE_EQUAL(uint64_t, intern_count, statistics.intern_count);
+    ASSERT_ARE_EQUAL(uint64_t, hit_count, statistics.hit_count);
+    ASSERT_ARE_EQUAL(uint64_t, saved_bytes, statistics.saved_bytes);
+    ASSERT_ARE_EQUAL(uint64_t, entry_count, statistics.entry_count);
+    ASSERT_ARE_EQUAL(uint64_t, stored_bytes, statistics.stored_bytes);
+}
+
+static void setup_intern_new_content_expectations(CONSTBUFFER_HANDLE buffer, uint32_t size)
+{
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(buffer));
+    STRICT_EXPECTED_CALL(hash_compute_hash_64(IGNORED_ARG, size, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_acquire_shared(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_release_shared(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_acquire_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_CreateWithCustomFree(IGNORED_ARG, size, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(buffer));
+}
+
+BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    ASSERT_ARE_EQUAL(int, 0, real_gballoc_hl_init(NULL, NULL));
+
+    ASSERT_ARE_EQUAL(int, 0, umock_c_init(on_umock_c_error), "umock_c_init");
+
+    ASSERT_ARE_EQUAL(int, 0, umocktypes_bool_register_types(), "umocktypes_bool_register_types");
+    ASSERT_ARE_EQUAL(int, 0, umocktypes_stdint_register_types(), "umocktypes_stdint_register_types");
+
+    REGISTER_GBALLOC_HL_GLOBAL_MOCK_HOOK();
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(malloc, NULL);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(malloc_2, NULL);
+
+    REGISTER_SRW_LOCK_GLOBAL_MOCK_HOOK();
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(srw_lock_create, NULL);
+
+    REGISTER_CONSTBUFFER_GLOBAL_MOCK_HOOK();
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(CONSTBUFFER_CreateWithCustomFree, NULL);
+
+    REGISTER_HASH_GLOBAL_MOCK_HOOK();
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(hash_compute_hash_64, MU_FAILURE);
+
+    REGISTER_UMOCK_ALIAS_TYPE(CONSTBUFFER_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(CONSTBUFFER_CUSTOM_FREE_FUNC, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(SRW_LOCK_HANDLE, void*);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    umock_c_deinit();
+
+    real_gballoc_hl_deinit();
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    umock_c_reset_all_calls();
+    int result = umock_c_negative_tests_init();
+    ASSERT_ARE_EQUAL(int, 0, result, "umock_c_negative_tests_init failed");
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    umock_c_negative_tests_deinit();
+}
+
+/* constbuffer_dedup_store_create */
+
+/*Tests_SRS_CONSTBUFFER_DEDUP_STORE_12_001: [ constbuffer_dedup_store_create shall allocate memory for the store. ]*/
+/*Tests_SRS_CONSTBUFFER_DEDUP_STORE_12_002: [ constbuffer_dedup_store_create shall call srw_lock_create. ]*/
+/*Tests_SRS_CONSTBUFFER_DEDUP_STORE_12_003: [ constbuffer_dedup_store_create shall allocate CONSTBUFFER_DEDUP_STORE_INITIAL_BUCKET_COUNT empty buckets. ]*/
+/*Tests_SRS_CONSTBUFFER_DEDUP_STORE_12_004: [ constbuffer_dedup_store_create shall succeed and return the store. ]*/
+TEST_FUNCTION(constbuffer_dedup_store_create_succeeds)
+{
+    /// arrange
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_create(false, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(malloc_2(16, sizeof(void*)));
+
+    /// act
+    CONSTBUFFER_DEDUP_STORE_HANDLE result = constbuffer_dedup_store_create();
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(result);
+    assert_statistics_are(result, 0, 0, 0, 0, 0);
+
+    /// cleanup
+    constbuffer_dedup_store_destroy(result);
+}
+
+/*Tests_SRS_CONSTBUFFER_DEDUP_STORE_12_005: [ If there are any failures then constbuffer_dedup_store_create shall fail and return NULL. ]*/
+TEST_FUNCTION(when_underlying_calls_fail_constbuffer_dedup_store_create_fails)
+{
+    /// arrange
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_create(false, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(malloc_2(16, sizeof(void*)));
+
+    umock_c_negative_tests_snapshot();
+
+    for (size_t i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
+        if (umock_c_negative_tests_can_call_fail(i))
+        {
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(i);
+
+            /// act
+            CONSTBUFFER_DEDUP_STORE_HANDLE result = constbuffer_dedup_store_create();
+
+            /// assert
+            ASSERT_IS_NULL(result, "On failed call %zu", i);
+        }
+    }
+}
+
+/* constbuffer_dedup_store_destroy */
+
+/*Tests_SRS_CONSTBUFFER_DEDUP_STORE_12_006: [ If store is NULL then constbuffer_dedup_store_destroy shall return. ]*/
+TEST_FUNCTION(constbuffer_dedup_store_destroy_with_NULL_store_returns)
+{
+    /// act
+    constbuffer_dedup_store_destroy(NULL);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_DEDUP_STORE_12_007: [ constbuffer_dedup_store_destroy shall release the reference of the owner of the store. When no interned handle of the store is alive anymore the buckets shall be freed, srw_lock_destroy shall be called and the store shall be freed. ]*/
+TEST_FUNCTION(constbuffer_dedup_store_destroy_frees_the_store)
+{
+    /// arrange
+    CONSTBUFFER_DEDUP_STORE_HANDLE store = test_create_store();
+
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_destroy(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(store));
+
+    /// act
+    constbuffer_dedup_store_destroy(store);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_DEDUP_STORE_12_007: [ constbuffer_dedup_store_destroy shall release the reference of the owner of the store. When no interned handle of the store is alive anymore the buckets shall be freed, srw_lock_destroy shall be called and the store shall be freed. ]*/
+/*Tests_SRS_CONSTBUFFER_DEDUP_STORE_12_020: [ When the last reference to an interned handle is released, the entry shall be removed from the store (with the lock acquired exclusively), CONSTBUFFER_DecRef shall be called on the buffer held by the entry, the entry shall be freed and the reference of the entry to the store shall be released. ]*/
+TEST_FUNCTION(constbuffer_dedup_store_destroy_with_an_interned_handle_alive_frees_the_store_when_the_handle_is_released)
+{
+    /// arrange
+    CONSTBUFFER_DEDUP_STORE_HANDLE store = test_create_store();
+    CONSTBUFFER_HANDLE buffer = generate_test_buffer(10, 'a');
+    CONSTBUFFER_HANDLE interned = constbuffer_dedup_store_intern(store, buffer);
+    ASSERT_IS_NOT_NULL(interned);
+    real_CONSTBUFFER_DecRef(buffer);
+    umock_c_reset_all_calls();
+
+    /// act
+    constbuffer_dedup_store_destroy(store);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 10, real_CONSTBUFFER_GetContent(interned)->size);
+    ASSERT_ARE_EQUAL(uint8_t, 'a', real_CONSTBUFFER_GetContent(interned)->buffer[9]);
+
+    STRICT_EXPECTED_CALL(CONSTBUFFER_DecRef(interned));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(buffer));
+    STRICT_EXPECTED_CALL(srw_lock_acquire_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_release_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_DecRef(buffer));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_destroy(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(store));
+
+    CONSTBUFFER_DecRef(interned);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* constbuffer_dedup_store_intern */
+
+/*Tests_SRS_CONSTBUFFER_DEDUP_STORE_12_008: [ If store is NULL then constbuffer_dedup_store_intern shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_dedup_store_intern_with_NULL_store_fails)
+{
+    /// arrange
+    CONSTBUFFER_HANDLE buffer = generate_test_buffer(10, 'a');
+
+    /// act
+    CONSTBUFFER_HANDLE result = constbuffer_dedup_store_intern(NULL, buffer);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(result);
+
+    /// cleanup
+    real_CONSTBUFFER_DecRef(buffer);
+}
+
+/*Tests_SRS_CONSTBUFFER_DEDUP_STORE_12_009: [ If buffer is NULL then constbuffer_dedup_store_intern shall fail and return NULL. ]*/
+TEST_FUNCTION(constbuffer_dedup_store_intern_with_NULL_buffer_fails)
+{
+    /// arrange
+    CONSTBUFFER_DEDUP_STORE_HANDLE store = test_create_store();
+
+    /// act
+    CONSTBUFFER_HANDLE result = constbuffer_dedup_store_intern(store, NULL);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(result);
+
+    /// cleanup
+    constbuffer_dedup_store_destroy(store);
+}
+
+/*Tests_SRS_CONSTBUFFER_DEDUP_STORE_12_010: [ constbuffer_dedup_store_intern shall get the content of buffer by calling CONSTBUFFER_GetContent. ]*/
+/*Tests_SRS_CONSTBUFFER_DEDUP_STORE_12_011: [ If the content of buffer is empty then constbuffer_dedup_store_intern shall call CONSTBUFFER_IncRef on buffer and return it (empty buffers are not stored). ]*/
+TEST_FUNCTION(constbuffer_dedup_store_intern_with_empty_buffer_returns_buffer)
+{
+    /// arrange
+    CONSTBUFFER_DEDUP_STORE_HANDLE store = test_create_store();
+    CONSTBUFFER_HANDLE buffer = generate_test_buffer(0, 0);
+
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(buffer));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(buffer));
+
+    /// act
+    CONSTBUFFER_HANDLE result = constbuffer_dedup_store_intern(store, buffer);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, buffer, result);
+    assert_statistics_are(store, 1, 0, 0, 0, 0);
+
+    /// cleanup
+    real_CONSTBUFFER_DecRef(result);
+    real_CONSTBUFFER_DecRef(buffer);
+    constbuffer_dedup_store_destroy(store);
+}
+
+/*Tests_SRS_CONSTBUFFER_DEDUP_STORE_12_010: [ constbuffer_dedup_store_intern shall get the content of buffer by calling CONSTBUFFER_GetContent. ]*/
+/*Tests_SRS_CONSTBUFFER_DEDUP_STORE_12_012: [ constbuffer_dedup_store_intern shall compute a 64-bit hash of the content by calling hash_compute_hash_64. ]*/
+/*Tests_SRS_CONSTBUFFER_DEDUP_STORE_12_013: [ constbuffer_dedup_store_intern shall call srw_lock_acquire_shared, look for an entry with the same hash whose buffer has the same size and the same bytes (memcmp) and whose interned handle can be referenced with CONSTBUFFER_TryIncRef, and call srw_lock_release_shared. ]*/
+/*Tests_SRS_CONSTBUFFER_DEDUP_STORE_12_015: [ Otherwise constbuffer_dedup_store_intern shall call srw_lock_acquire_exclusive and look for the entry again (another thread might have interned the same content). ]*/
+/*Tests_SRS_CONSTBUFFER_DEDUP_STORE_12_016: [ If there is still no entry then constbuffer_dedup_store_intern shall allocate a new entry, call CONSTBUFFER_CreateWithCustomFree with the content of buffer and the entry as context to create the interned handle, call CONSTBUFFER_IncRef on buffer (the entry keeps the bytes) and add the entry to the store. ]*/
+/*Tests_SRS_CONSTBUFFER_DEDUP_STORE_12_018: [ constbuffer_dedup_store_intern shall succeed and return the interned handle (with a reference for the caller). ]*/
+TEST_FUNCTION(constbuffer_dedup_store_intern_with_new_content_adds_it_to_the_store)
+{
+    /// arrange
+    CONSTBUFFER_DEDUP_STORE_HANDLE store = test_create_store();
+    CONSTBUFFER_HANDLE buffer = generate_test_buffer(10, 'a');
+
+    setup_intern_new_content_expectations(buffer, 10);
+    STRICT_EXPECTED_CALL(srw_lock_release_exclusive(IGNORED_ARG));
+
+    /// act
+    CONSTBUFFER_HANDLE result = constbuffer_dedup_store_intern(store, buffer);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_NOT_EQUAL(void_ptr, buffer, result);
+    // the interned handle does not copy the bytes
+    ASSERT_ARE_EQUAL(void_ptr, real_CONSTBUFFER_GetContent(buffer)->buffer, real_CONSTBUFFER_GetContent(result)->buffer);
+    ASSERT_ARE_EQUAL(uint32_t, 10, real_CONSTBUFFER_GetContent(result)->size);
+    assert_statistics_are(store, 1, 0, 0, 1, 10);
+
+    /// cleanup
+    real_CONSTBUFFER_DecRef(buffer);
+    real_CONSTBUFFER_DecRef(result);
+    constbuffer_dedup_store_destroy(store);
+}
+
+/*Tests_SRS_CONSTBUFFER_DEDUP_STORE_12_013: [ constbuffer_dedup_store_intern shall call srw_lock_acquire_shared, look for an entry with the same hash whose buffer has the same size and the same bytes (memcmp) and whose interned handle can be referenced with CONSTBUFFER_TryIncRef, and call srw_lock_release_shared. ]*/
+/*Tests_SRS_CONSTBUFFER_DEDUP_STORE_12_014: [ If an entry is found then constbuffer_dedup_store_intern shall count a hit and the size of the content as saved bytes. ]*/
+/*Tests_SRS_CONSTBUFFER_DEDUP_STORE_12_018: [ constbuffer_dedup_store_intern shall succeed and return the interned handle (with a reference for the caller). ]*/
+TEST_FUNCTION(constbuffer_dedup_store_intern_with_content_already_in_the_store_returns_the_interned_handle)
+{
+    /// arrange
+    CONSTBUFFER_DEDUP_STORE_HANDLE store = test_create_store();
+    CONSTBUFFER_HANDLE buffer_1 = generate_test_buffer(10, 'a');
+    CONSTBUFFER_HANDLE buffer_2 = generate_test_buffer(10, 'a');
+    CONSTBUFFER_HANDLE interned = constbuffer_dedup_store_intern(store, buffer_1);
+    ASSERT_IS_NOT_NULL(interned);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(buffer_2));
+    STRICT_EXPECTED_CALL(hash_compute_hash_64(IGNORED_ARG, 10, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_acquire_shared(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(buffer_1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_TryIncRef(interned));
+    STRICT_EXPECTED_CALL(srw_lock_release_shared(IGNORED_ARG));
+
+    /// act
+    CONSTBUFFER_HANDLE result = constbuffer_dedup_store_intern(store, buffer_2);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, interned, result);
+    assert_statistics_are(store, 2, 1, 10, 1, 10);
+
+    /// cleanup
+    real_CONSTBUFFER_DecRef(buffer_1);
+    real_CONSTBUFFER_DecRef(buffer_2);
+    real_CONSTBUFFER_DecRef(result);
+    real_CONSTBUFFER_DecRef(interned);
+    constbuffer_dedup_store_destroy(store);
+}
+
+/*Tests_SRS_CONSTBUFFER_DEDUP_STORE_12_013: [ constbuffer_dedup_store_intern shall call srw_lock_acquire_shared, look for an entry with the same hash whose buffer has the same size and the same bytes (memcmp) and whose interned handle can be referenced with CONSTBUFFER_TryIncRef, and call srw_lock_release_shared. ]*/
+/*Tests_SRS_CONSTBUFFER_DEDUP_STORE_12_016: [ If there is still no entry then constbuffer_dedup_store_intern shall allocate a new entry, call CONSTBUFFER_CreateWithCustomFree with the content of buffer and the entry as context to create the interned handle, call CONSTBUFFER_IncRef on buffer (the entry keeps the bytes) and add the entry to the store. ]*/
+TEST_FUNCTION(constbuffer_dedup_store_intern_with_different_content_and_the_same_hash_adds_it_to_the_store)
+{
+    /// arrange
+    uint64_t colliding_hash = 0x4300000042;
+    CONSTBUFFER_DEDUP_STORE_HANDLE store = test_create_store();
+    CONSTBUFFER_HANDLE buffer_1 = generate_test_buffer(10, 'a');
+    CONSTBUFFER_HANDLE buffer_2 = generate_test_buffer(10, 'b');
+
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(buffer_1));
+    STRICT_EXPECTED_CALL(hash_compute_hash_64(IGNORED_ARG, 10, IGNORED_ARG))
+        .CopyOutArgumentBuffer_hash(&colliding_hash, sizeof(colliding_hash))
+        .SetReturn(0);
+    CONSTBUFFER_HANDLE interned = constbuffer_dedup_store_intern(store, buffer_1);
+    ASSERT_IS_NOT_NULL(interned);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(buffer_2));
+    STRICT_EXPECTED_CALL(hash_compute_hash_64(IGNORED_ARG, 10, IGNORED_ARG))
+        .CopyOutArgumentBuffer_hash(&colliding_hash, sizeof(colliding_hash))
+        .SetReturn(0);
+    STRICT_EXPECTED_CALL(srw_lock_acquire_shared(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(buffer_1));
+    STRICT_EXPECTED_CALL(srw_lock_release_shared(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_acquire_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(buffer_1));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_CreateWithCustomFree(IGNORED_ARG, 10, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(buffer_2));
+    STRICT_EXPECTED_CALL(srw_lock_release_exclusive(IGNORED_ARG));
+
+    /// act
+    CONSTBUFFER_HANDLE result = constbuffer_dedup_store_intern(store, buffer_2);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_NOT_EQUAL(void_ptr, interned, result);
+    ASSERT_ARE_EQUAL(uint8_t, 'b', real_CONSTBUFFER_GetContent(result)->buffer[0]);
+    assert_statistics_are(store, 2, 0, 0, 2, 20);
+
+    /// cleanup
+    real_CONSTBUFFER_DecRef(buffer_1);
+    real_CONSTBUFFER_DecRef(buffer_2);
+    real_CONSTBUFFER_DecRef(result);
+    real_CONSTBUFFER_DecRef(interned);
+    constbuffer_dedup_store_destroy(store);
+}
+
+/*Tests_SRS_CONSTBUFFER_DEDUP_STORE_12_013: [ constbuffer_dedup_store_intern shall call srw_lock_acquire_shared, look for an entry with the same hash whose buffer has the same size and the same bytes (memcmp) and whose interned handle can be referenced with CONSTBUFFER_TryIncRef, and call srw_lock_release_shared. ]*/
+/*Tests_SRS_CONSTBUFFER_DEDUP_STORE_12_015: [ Otherwise constbuffer_dedup_store_intern shall call srw_lock_acquire_exclusive and look for the entry again (another thread might have interned the same content). ]*/
+TEST_FUNCTION(constbuffer_dedup_store_intern_with_the_content_of_a_handle_being_freed_adds_a_new_entry)
+{
+    /// arrange
+    CONSTBUFFER_DEDUP_STORE_HANDLE store = test_create_store();
+    CONSTBUFFER_HANDLE buffer_1 = generate_test_buffer(10, 'a');
+    CONSTBUFFER_HANDLE buffer_2 = generate_test_buffer(10, 'a');
+    CONSTBUFFER_HANDLE interned = constbuffer_dedup_store_intern(store, buffer_1);
+    ASSERT_IS_NOT_NULL(interned);
+    umock_c_reset_all_calls();
+
+    // another thread released the last reference to interned and its custom free function did not remove it from the store yet
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(buffer_2));
+    STRICT_EXPECTED_CALL(hash_compute_hash_64(IGNORED_ARG, 10, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_acquire_shared(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(buffer_1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_TryIncRef(interned))
+        .SetReturn(false);
+    STRICT_EXPECTED_CALL(srw_lock_release_shared(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_acquire_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(buffer_1));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_TryIncRef(interned))
+        .SetReturn(false);
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_CreateWithCustomFree(IGNORED_ARG, 10, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(buffer_2));
+    STRICT_EXPECTED_CALL(srw_lock_release_exclusive(IGNORED_ARG));
+
+    /// act
+    CONSTBUFFER_HANDLE result = constbuffer_dedup_store_intern(store, buffer_2);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_NOT_EQUAL(void_ptr, interned, result);
+    assert_statistics_are(store, 2, 0, 0, 2, 20);
+
+    /// cleanup
+    real_CONSTBUFFER_DecRef(buffer_1);
+    real_CONSTBUFFER_DecRef(buffer_2);
+    real_CONSTBUFFER_DecRef(result);
+    real_CONSTBUFFER_DecRef(interned);
+    constbuffer_dedup_store_destroy(store);
+}
+
+/*Tests_SRS_CONSTBUFFER_DEDUP_STORE_12_017: [ When there are more entries than buckets constbuffer_dedup_store_intern shall allocate twice as many buckets (malloc_2) and move the entries to them. If that fails the store shall keep the buckets it has. ]*/
+TEST_FUNCTION(constbuffer_dedup_store_intern_with_more_entries_than_buckets_grows_the_buckets)
+{
+    /// arrange
+    CONSTBUFFER_DEDUP_STORE_HANDLE store = test_create_store();
+    CONSTBUFFER_HANDLE buffers[17];
+    CONSTBUFFER_HANDLE interned[17];
+    for (uint32_t i = 0; i < 16; i++)
+    {
+        buffers[i] = generate_test_buffer(i + 1, 'a');
+        interned[i] = constbuffer_dedup_store_intern(store, buffers[i]);
+        ASSERT_IS_NOT_NULL(interned[i]);
+    }
+    buffers[16] = generate_test_buffer(17, 'a');
+    umock_c_reset_all_calls();
+
+    setup_intern_new_content_expectations(buffers[16], 17);
+    STRICT_EXPECTED_CALL(malloc_2(32, sizeof(void*)));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_release_exclusive(IGNORED_ARG));
+
+    /// act
+    interned[16] = constbuffer_dedup_store_intern(store, buffers[16]);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(interned[16]);
+    // all the entries are found after the buckets have grown
+    for (uint32_t i = 0; i < 17; i++)
+    {
+        CONSTBUFFER_HANDLE again = constbuffer_dedup_store_intern(store, buffers[i]);
+        ASSERT_ARE_EQUAL(void_ptr, interned[i], again);
+        real_CONSTBUFFER_DecRef(again);
+    }
+    assert_statistics_are(store, 34, 17, 153, 17, 153);
+
+    /// cleanup
+    for (uint32_t i = 0; i < 17; i++)
+    {
+        real_CONSTBUFFER_DecRef(buffers[i]);
+        real_CONSTBUFFER_DecRef(interned[i]);
+    }
+    constbuffer_dedup_store_destroy(store);
+}
+
+/*Tests_SRS_CONSTBUFFER_DEDUP_STORE_12_017: [ When there are more entries than buckets constbuffer_dedup_store_intern shall allocate twice as many buckets (malloc_2) and move the entries to them. If that fails the store shall keep the buckets it has. ]*/
+TEST_FUNCTION(constbuffer_dedup_store_intern_when_growing_the_buckets_fails_still_succeeds)
+{
+    /// arrange
+    CONSTBUFFER_DEDUP_STORE_HANDLE store = test_create_store();
+    CONSTBUFFER_HANDLE buffers[17];
+    CONSTBUFFER_HANDLE interned[17];
+    for (uint32_t i = 0; i < 16; i++)
+    {
+        buffers[i] = generate_test_buffer(i + 1, 'a');
+        interned[i] = constbuffer_dedup_store_intern(store, buffers[i]);
+        ASSERT_IS_NOT_NULL(interned[i]);
+    }
+    buffers[16] = generate_test_buffer(17, 'a');
+    umock_c_reset_all_calls();
+
+    setup_intern_new_content_expectations(buffers[16], 17);
+    STRICT_EXPECTED_CALL(malloc_2(32, sizeof(void*)))
+        .SetReturn(NULL);
+    STRICT_EXPECTED_CALL(srw_lock_release_exclusive(IGNORED_ARG));
+
+    /// act
+    interned[16] = constbuffer_dedup_store_intern(store, buffers[16]);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(interned[16]);
+    for (uint32_t i = 0; i < 17; i++)
+    {
+        CONSTBUFFER_HANDLE again = constbuffer_dedup_store_intern(store, buffers[i]);
+        ASSERT_ARE_EQUAL(void_ptr, interned[i], again);
+        real_CONSTBUFFER_DecRef(again);
+    }
+
+    /// cleanup
+    for (uint32_t i = 0; i < 17; i++)
+    {
+        real_CONSTBUFFER_DecRef(buffers[i]);
+        real_CONSTBUFFER_DecRef(interned[i]);
+    }
+    constbuffer_dedup_store_destroy(store);
+}
+
+/*Tests_SRS_CONSTBUFFER_DEDUP_STORE_12_019: [ If there are any failures then constbuffer_dedup_store_intern shall fail and return NULL. ]*/
+TEST_FUNCTION(when_underlying_calls_fail_constbuffer_dedup_store_intern_fails)
+{
+    /// arrange
+    CONSTBUFFER_DEDUP_STORE_HANDLE store = test_create_store();
+    CONSTBUFFER_HANDLE buffer = generate_test_buffer(10, 'a');
+
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(buffer))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(hash_compute_hash_64(IGNORED_ARG, 10, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_acquire_shared(IGNORED_ARG))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(srw_lock_release_shared(IGNORED_ARG))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(srw_lock_acquire_exclusive(IGNORED_ARG))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_CreateWithCustomFree(IGNORED_ARG, 10, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_IncRef(buffer))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(srw_lock_release_exclusive(IGNORED_ARG))
+        .CallCannotFail();
+
+    umock_c_negative_tests_snapshot();
+
+    for (size_t i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
+        if (umock_c_negative_tests_can_call_fail(i))
+        {
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(i);
+
+            /// act
+            CONSTBUFFER_HANDLE result = constbuffer_dedup_store_intern(store, buffer);
+
+            /// assert
+            ASSERT_IS_NULL(result, "On failed call %zu", i);
+        }
+    }
+
+    assert_statistics_are(store, 0, 0, 0, 0, 0);
+
+    /// cleanup
+    real_CONSTBUFFER_DecRef(buffer);
+    constbuffer_dedup_store_destroy(store);
+}
+
+/* on_interned_buffer_free */
+
+/*Tests_SRS_CONSTBUFFER_DEDUP_STORE_12_020: [ When the last reference to an interned handle is released, the entry shall be removed from the store (with the lock acquired exclusively), CONSTBUFFER_DecRef shall be called on the buffer held by the entry, the entry shall be freed and the reference of the entry to the store shall be released. ]*/
+TEST_FUNCTION(releasing_the_last_reference_to_an_interned_handle_removes_it_from_the_store)
+{
+    /// arrange
+    CONSTBUFFER_DEDUP_STORE_HANDLE store = test_create_store();
+    CONSTBUFFER_HANDLE buffer = generate_test_buffer(10, 'a');
+    CONSTBUFFER_HANDLE interned = constbuffer_dedup_store_intern(store, buffer);
+    ASSERT_IS_NOT_NULL(interned);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(CONSTBUFFER_DecRef(interned));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_GetContent(buffer));
+    STRICT_EXPECTED_CALL(srw_lock_acquire_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_release_exclusive(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(CONSTBUFFER_DecRef(buffer));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    /// act
+    CONSTBUFFER_DecRef(interned);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    assert_statistics_are(store, 1, 0, 0, 0, 0);
+
+    // the same content is interned again in a new handle
+    CONSTBUFFER_HANDLE interned_again = constbuffer_dedup_store_intern(store, buffer);
+    ASSERT_IS_NOT_NULL(interned_again);
+    assert_statistics_are(store, 2, 0, 0, 1, 10);
+
+    /// cleanup
+    real_CONSTBUFFER_DecRef(interned_again);
+    real_CONSTBUFFER_DecRef(buffer);
+    constbuffer_dedup_store_destroy(store);
+}
+
+/*Tests_SRS_CONSTBUFFER_DEDUP_STORE_12_020: [ When the last reference to an interned handle is released, the entry shall be removed from the store (with the lock acquired exclusively), CONSTBUFFER_DecRef shall be called on the buffer held by the entry, the entry shall be freed and the reference of the entry to the store shall be released. ]*/
+TEST_FUNCTION(releasing_one_of_many_references_to_an_interned_handle_keeps_it_in_the_store)
+{
+    /// arrange
+    CONSTBUFFER_DEDUP_STORE_HANDLE store = test_create_store();
+    CONSTBUFFER_HANDLE buffer_1 = generate_test_buffer(10, 'a');
+    CONSTBUFFER_HANDLE buffer_2 = generate_test_buffer(10, 'a');
+    CONSTBUFFER_HANDLE interned_1 = constbuffer_dedup_store_intern(store, buffer_1);
+    ASSERT_IS_NOT_NULL(interned_1);
+    CONSTBUFFER_HANDLE interned_2 = constbuffer_dedup_store_intern(store, buffer_2);
+    ASSERT_ARE_EQUAL(void_ptr, interned_1, interned_2);
+    real_CONSTBUFFER_DecRef(buffer_1);
+    real_CONSTBUFFER_DecRef(buffer_2);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(CONSTBUFFER_DecRef(interned_1));
+
+    /// act
+    CONSTBUFFER_DecRef(interned_1);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    assert_statistics_are(store, 2, 1, 10, 1, 10);
+    ASSERT_ARE_EQUAL(uint8_t, 'a', real_CONSTBUFFER_GetContent(interned_2)->buffer[0]);
+
+    /// cleanup
+    real_CONSTBUFFER_DecRef(interned_2);
+    constbuffer_dedup_store_destroy(store);
+}
+
+/* constbuffer_dedup_store_get_statistics */
+
+/*Tests_SRS_CONSTBUFFER_DEDUP_STORE_12_021: [ If store is NULL then constbuffer_dedup_store_get_statistics shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_dedup_store_get_statistics_with_NULL_store_fails)
+{
+    /// arrange
+    CONSTBUFFER_DEDUP_STORE_STATISTICS statistics;
+
+    /// act
+    int result = constbuffer_dedup_store_get_statistics(NULL, &statistics);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/*Tests_SRS_CONSTBUFFER_DEDUP_STORE_12_022: [ If statistics is NULL then constbuffer_dedup_store_get_statistics shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(constbuffer_dedup_store_get_statistics_with_NULL_statistics_fails)
+{
+    /// arrange
+    CONSTBUFFER_DEDUP_STORE_HANDLE store = test_create_store();
+
+    /// act
+    int result = constbuffer_dedup_store_get_statistics(store, NULL);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    /// cleanup
+    constbuffer_dedup_store_destroy(store);
+}
+
+/*Tests_SRS_CONSTBUFFER_DEDUP_STORE_12_023: [ constbuffer_dedup_store_get_statistics shall write in statistics the number of buffers interned, the number of hits, the saved bytes, the number of entries and the number of bytes in the store and return 0. ]*/
+TEST_FUNCTION(constbuffer_dedup_store_get_statistics_returns_the_counters)
+{
+    /// arrange
+    CONSTBUFFER_DEDUP_STORE_HANDLE store = test_create_store();
+    CONSTBUFFER_HANDLE buffers[4];
+    CONSTBUFFER_HANDLE interned[4];
+    buffers[0] = generate_test_buffer(10, 'a');
+    buffers[1] = generate_test_buffer(10, 'a');
+    buffers[2] = generate_test_buffer(20, 'b');
+    buffers[3] = generate_test_buffer(10, 'a');
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        interned[i] = constbuffer_dedup_store_intern(store, buffers[i]);
+        ASSERT_IS_NOT_NULL(interned[i]);
+    }
+    CONSTBUFFER_DEDUP_STORE_STATISTICS statistics;
+    umock_c_reset_all_calls();
+
+    /// act
+    int result = constbuffer_dedup_store_get_statistics(store, &statistics);
+
+    /// assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint64_t, 4, statistics.intern_count);
+    ASSERT_ARE_EQUAL(uint64_t, 2, statistics.hit_count);
+    ASSERT_ARE_EQUAL(uint64_t, 20, statistics.saved_bytes);
+    ASSERT_ARE_EQUAL(uint64_t, 2, statistics.entry_count);
+    ASSERT_ARE_EQUAL(uint64_t, 30, statistics.stored_bytes);
+
+    /// cleanup
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        real_CONSTBUFFER_DecRef(buffers[i]);
+        real_CONSTBUFFER_DecRef(interned[i]);
+    }
+    constbuffer_dedup_store_destroy(store);
+}
+
+END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
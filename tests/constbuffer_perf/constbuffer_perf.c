@@ -0,0 +1,105 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <inttypes.h>
+
+#include "macro_utils/macro_utils.h"
+#include "testrunnerswitcher.h"
+
+#include "c_logging/logger.h"
+
+#include "c_pal/gballoc_hl.h"
+#include "c_pal/gballoc_hl_redirect.h"
+#include "c_pal/threadapi.h"
+#include "c_pal/timer.h"
+
+#include "c_util/constbuffer.h"
+
+TEST_DEFINE_ENUM_TYPE(THREADAPI_RESULT, THREADAPI_RESULT_VALUES);
+
+#define INC_DEC_REF_PER_THREAD 2000000
+#define MAX_THREAD_COUNT 16
+#define SHARED_HOT_SLOT_COUNT 64
+
+static const unsigned char test_content[] = { 'l', 'e', ' ', 'b', 'u', 'f', 'f', 'e', 'r' };
+
+static int inc_dec_ref_thread(void* arg)
+{
+    CONSTBUFFER_HANDLE handle = arg;
+    for (uint32_t i = 0; i < INC_DEC_REF_PER_THREAD; i++)
+    {
+        CONSTBUFFER_IncRef(handle);
+        CONSTBUFFER_DecRef(handle);
+    }
+    return 0;
+}
+
+/*returns the number of CONSTBUFFER_IncRef + CONSTBUFFER_DecRef calls per second when thread_count threads hammer handle*/
+static double measure_inc_dec_ref(CONSTBUFFER_HANDLE handle, uint32_t thread_count)
+{
+    THREAD_HANDLE threads[MAX_THREAD_COUNT];
+
+    double start = timer_global_get_elapsed_ms();
+    for (uint32_t i = 0; i < thread_count; i++)
+    {
+        ASSERT_ARE_EQUAL(THREADAPI_RESULT, THREADAPI_OK, ThreadAPI_Create(&threads[i], inc_dec_ref_thread, handle));
+    }
+    for (uint32_t i = 0; i < thread_count; i++)
+    {
+        int dont_care;
+        ASSERT_ARE_EQUAL(THREADAPI_RESULT, THREADAPI_OK, ThreadAPI_Join(threads[i], &dont_care));
+    }
+    double elapsed_ms = timer_global_get_elapsed_ms() - start;
+
+    return (double)thread_count * INC_DEC_REF_PER_THREAD * 2 * 1000.0 / elapsed_ms;
+}
+
+BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    ASSERT_ARE_EQUAL(int, 0, gballoc_hl_init(NULL, NULL));
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    gballoc_hl_deinit();
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+}
+
+TEST_FUNCTION(constbuffer_perf_IncRef_DecRef_contention_single_count_vs_shared_hot)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE single_count = CONSTBUFFER_Create(test_content, sizeof(test_content));
+    ASSERT_IS_NOT_NULL(single_count);
+    CONSTBUFFER_HANDLE shared_hot = CONSTBUFFER_CreateSharedHot(single_count, SHARED_HOT_SLOT_COUNT);
+    ASSERT_IS_NOT_NULL(shared_hot);
+
+    ///act
+    for (uint32_t thread_count = 1; thread_count <= MAX_THREAD_COUNT; thread_count *= 2)
+    {
+        double single_count_ops = measure_inc_dec_ref(single_count, thread_count);
+        double shared_hot_ops = measure_inc_dec_ref(shared_hot, thread_count);
+        LogInfo("%" PRIu32 " threads: single count %.1f M IncRef/DecRef per second, shared hot (%" PRIu32 " slots) %.1f M IncRef/DecRef per second (x%.2f)",
+            thread_count, single_count_ops / 1000000.0, (uint32_t)SHARED_HOT_SLOT_COUNT, shared_hot_ops / 1000000.0, shared_hot_ops / single_count_ops);
+    }
+
+    ///assert
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(test_content), CONSTBUFFER_GetContent(shared_hot)->size);
+
+    ///clean
+    CONSTBUFFER_DecRef(shared_hot);
+    CONSTBUFFER_DecRef(single_count);
+}
+
+END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
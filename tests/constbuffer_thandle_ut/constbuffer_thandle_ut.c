@@ -9,6 +9,9 @@ IMPLEMENT_UMOCK_C_ENUM_TYPE(CONSTBUFFER_THANDLE_TO_FIXED_SIZE_BUFFER_RESULT, CON
 TEST_DEFINE_ENUM_TYPE(CONSTBUFFER_THANDLE_FROM_BUFFER_RESULT, CONSTBUFFER_THANDLE_FROM_BUFFER_RESULT_VALUES)
 IMPLEMENT_UMOCK_C_ENUM_TYPE(CONSTBUFFER_THANDLE_FROM_BUFFER_RESULT, CONSTBUFFER_THANDLE_FROM_BUFFER_RESULT_VALUES)
 
+MU_DEFINE_ENUM_STRINGS(MEMORY_MAPPED_FILE_ACCESS_HINT, MEMORY_MAPPED_FILE_ACCESS_HINT_VALUES)
+IMPLEMENT_UMOCK_C_ENUM_TYPE(MEMORY_MAPPED_FILE_ACCESS_HINT, MEMORY_MAPPED_FILE_ACCESS_HINT_VALUES)
+
 static const char* buffer1 = "le buffer no 1";
 
 #define BUFFER1_HANDLE (BUFFER_HANDLE)1
@@ -53,6 +56,22 @@ MOCK_FUNCTION_WITH_CODE(, void, test_free_func_no_free, void*, context)
     (void)context; // Mock function that does not actually free memory
 MOCK_FUNCTION_END()
 
+static const unsigned char test_mapped_content[] = { 'm', 'a', 'p', 'p', 'e', 'd' };
+#define TEST_MAPPING_BASE (void*)0x4201
+
+static int my_memory_mapped_file_map(const char* file_name, uint64_t offset, uint32_t size, MEMORY_MAPPED_FILE_ACCESS_HINT hint, MEMORY_MAPPED_FILE_VIEW* view)
+{
+    (void)file_name;
+    (void)offset;
+    (void)size;
+    (void)hint;
+    view->mapping_base = TEST_MAPPING_BASE;
+    view->mapping_size = sizeof(test_mapped_content);
+    view->content = test_mapped_content;
+    view->content_size = sizeof(test_mapped_content);
+    return 0;
+}
+
 MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
 
 static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
@@ -83,6 +102,9 @@ TEST_SUITE_INITIALIZE(suite_init)
     REGISTER_GBALLOC_HL_GLOBAL_MOCK_HOOK();
     REGISTER_GLOBAL_MOCK_HOOK(BUFFER_u_char, my_BUFFER_u_char);
     REGISTER_GLOBAL_MOCK_HOOK(BUFFER_length, my_BUFFER_length);
+    REGISTER_TYPE(MEMORY_MAPPED_FILE_ACCESS_HINT, MEMORY_MAPPED_FILE_ACCESS_HINT);
+    REGISTER_UMOCK_ALIAS_TYPE(MEMORY_MAPPED_FILE_VIEW*, void*);
+    REGISTER_GLOBAL_MOCK_HOOK(memory_mapped_file_map, my_memory_mapped_file_map);
 }
 
 TEST_SUITE_CLEANUP(suite_cleanup)
@@ -590,6 +612,94 @@ TEST_FUNCTION(CONSTBUFFER_THANDLE_CreateWithCustomFree_fails_when_malloc_fails)
     ///cleanup
 }
 
+/* CONSTBUFFER_THANDLE_CreateFromMappedFile */
+
+/*Tests_SRS_CONSTBUFFER_THANDLE_12_001: [ If file_name is NULL then CONSTBUFFER_THANDLE_CreateFromMappedFile shall fail and return NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_THANDLE_CreateFromMappedFile_with_NULL_file_name_fails)
+{
+    ///arrange
+
+    ///act
+    THANDLE(CONSTBUFFER) result = CONSTBUFFER_THANDLE_CreateFromMappedFile(NULL, 0, 0, MEMORY_MAPPED_FILE_ACCESS_HINT_NORMAL);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_THANDLE_12_002: [ CONSTBUFFER_THANDLE_CreateFromMappedFile shall allocate memory for the const buffer. ]*/
+/*Tests_SRS_CONSTBUFFER_THANDLE_12_003: [ CONSTBUFFER_THANDLE_CreateFromMappedFile shall call memory_mapped_file_map to map size bytes of file_name starting at offset with hint. ]*/
+/*Tests_SRS_CONSTBUFFER_THANDLE_12_004: [ CONSTBUFFER_THANDLE_CreateFromMappedFile shall set the content of the const buffer to the mapped bytes, succeed and return a non-NULL value. ]*/
+TEST_FUNCTION(CONSTBUFFER_THANDLE_CreateFromMappedFile_succeeds)
+{
+    ///arrange
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 1, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(memory_mapped_file_map("some_file", 4096, 3, MEMORY_MAPPED_FILE_ACCESS_HINT_RANDOM, IGNORED_ARG));
+
+    ///act
+    THANDLE(CONSTBUFFER) result = CONSTBUFFER_THANDLE_CreateFromMappedFile("some_file", 4096, 3, MEMORY_MAPPED_FILE_ACCESS_HINT_RANDOM);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    const CONSTBUFFER_CONTENT* content = CONSTBUFFER_THANDLE_GetContent(result);
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(test_mapped_content), content->size);
+    ASSERT_ARE_EQUAL(void_ptr, test_mapped_content, content->buffer);
+
+    ///cleanup
+    THANDLE_ASSIGN(CONSTBUFFER)(&result, NULL);
+}
+
+/*Tests_SRS_CONSTBUFFER_THANDLE_12_005: [ If there are any failures then CONSTBUFFER_THANDLE_CreateFromMappedFile shall fail and return NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_THANDLE_CreateFromMappedFile_fails_when_malloc_fails)
+{
+    ///arrange
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 1, IGNORED_ARG))
+        .SetReturn(NULL);
+
+    ///act
+    THANDLE(CONSTBUFFER) result = CONSTBUFFER_THANDLE_CreateFromMappedFile("some_file", 0, 0, MEMORY_MAPPED_FILE_ACCESS_HINT_NORMAL);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_THANDLE_12_005: [ If there are any failures then CONSTBUFFER_THANDLE_CreateFromMappedFile shall fail and return NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_THANDLE_CreateFromMappedFile_fails_when_memory_mapped_file_map_fails)
+{
+    ///arrange
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 1, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(memory_mapped_file_map("some_file", 0, 0, MEMORY_MAPPED_FILE_ACCESS_HINT_NORMAL, IGNORED_ARG))
+        .SetReturn(MU_FAILURE);
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    ///act
+    THANDLE(CONSTBUFFER) result = CONSTBUFFER_THANDLE_CreateFromMappedFile("some_file", 0, 0, MEMORY_MAPPED_FILE_ACCESS_HINT_NORMAL);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_THANDLE_12_006: [ If the buffer was created by calling CONSTBUFFER_THANDLE_CreateFromMappedFile, memory_mapped_file_unmap shall be called. ]*/
+TEST_FUNCTION(CONSTBUFFER_THANDLE_CreateFromMappedFile_unmaps_the_view_on_dispose)
+{
+    ///arrange
+    THANDLE(CONSTBUFFER) handle = CONSTBUFFER_THANDLE_CreateFromMappedFile("some_file", 0, 0, MEMORY_MAPPED_FILE_ACCESS_HINT_NORMAL);
+    ASSERT_IS_NOT_NULL(handle);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(memory_mapped_file_unmap(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    ///act
+    THANDLE_ASSIGN(CONSTBUFFER)(&handle, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
 /* CONSTBUFFER_THANDLE_CreateFromOffsetAndSize */
 
 /*Tests_SRS_CONSTBUFFER_THANDLE_88_035: [ If handle is NULL then CONSTBUFFER_THANDLE_CreateFromOffsetAndSize shall fail and return NULL.]*/
@@ -1841,6 +1951,171 @@ TEST_FUNCTION(CONSTBUFFER_THANDLE_from_buffer_fails_when_error_occurs)
     THANDLE_ASSIGN(CONSTBUFFER)(&destination, NULL);
 }
 
+/* CONSTBUFFER_THANDLE_from_buffer_view */
+
+/*Tests_SRS_CONSTBUFFER_THANDLE_12_007: [ If source is NULL then CONSTBUFFER_THANDLE_from_buffer_view shall fail and return CONSTBUFFER_THANDLE_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
+TEST_FUNCTION(CONSTBUFFER_THANDLE_from_buffer_view_with_source_NULL_fails)
+{
+    ///arrange
+    uint32_t consumed;
+    THANDLE(CONSTBUFFER) destination = NULL;
+
+    ///act
+    CONSTBUFFER_THANDLE_FROM_BUFFER_RESULT result = CONSTBUFFER_THANDLE_from_buffer_view(NULL, 0, &consumed, &destination);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_THANDLE_FROM_BUFFER_RESULT, CONSTBUFFER_THANDLE_FROM_BUFFER_RESULT_INVALID_ARG, result);
+    ASSERT_IS_NULL(destination);
+}
+
+/*Tests_SRS_CONSTBUFFER_THANDLE_12_008: [ If consumed is NULL then CONSTBUFFER_THANDLE_from_buffer_view shall fail and return CONSTBUFFER_THANDLE_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
+/*Tests_SRS_CONSTBUFFER_THANDLE_12_009: [ If destination is NULL then CONSTBUFFER_THANDLE_from_buffer_view shall fail and return CONSTBUFFER_THANDLE_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
+/*Tests_SRS_CONSTBUFFER_THANDLE_12_010: [ If offset is greater than or equal to the size of source then CONSTBUFFER_THANDLE_from_buffer_view shall fail and return CONSTBUFFER_THANDLE_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
+TEST_FUNCTION(CONSTBUFFER_THANDLE_from_buffer_view_with_invalid_args_fails)
+{
+    ///arrange
+    unsigned char serialized[] = { CONSTBUFFER_VERSION_V1, 0x00, 0x00, 0x00, 0x01, 0x42 };
+    THANDLE(CONSTBUFFER) source = CONSTBUFFER_THANDLE_Create(serialized, sizeof(serialized));
+    ASSERT_IS_NOT_NULL(source);
+    uint32_t consumed;
+    THANDLE(CONSTBUFFER) destination = NULL;
+
+    umock_c_reset_all_calls();
+
+    ///act
+    CONSTBUFFER_THANDLE_FROM_BUFFER_RESULT result_consumed_NULL = CONSTBUFFER_THANDLE_from_buffer_view(source, 0, NULL, &destination);
+    CONSTBUFFER_THANDLE_FROM_BUFFER_RESULT result_destination_NULL = CONSTBUFFER_THANDLE_from_buffer_view(source, 0, &consumed, NULL);
+    CONSTBUFFER_THANDLE_FROM_BUFFER_RESULT result_offset_too_big = CONSTBUFFER_THANDLE_from_buffer_view(source, sizeof(serialized), &consumed, &destination);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_THANDLE_FROM_BUFFER_RESULT, CONSTBUFFER_THANDLE_FROM_BUFFER_RESULT_INVALID_ARG, result_consumed_NULL);
+    ASSERT_ARE_EQUAL(CONSTBUFFER_THANDLE_FROM_BUFFER_RESULT, CONSTBUFFER_THANDLE_FROM_BUFFER_RESULT_INVALID_ARG, result_destination_NULL);
+    ASSERT_ARE_EQUAL(CONSTBUFFER_THANDLE_FROM_BUFFER_RESULT, CONSTBUFFER_THANDLE_FROM_BUFFER_RESULT_INVALID_ARG, result_offset_too_big);
+    ASSERT_IS_NULL(destination);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    THANDLE_ASSIGN(CONSTBUFFER)(&source, NULL);
+}
+
+/*Tests_SRS_CONSTBUFFER_THANDLE_12_011: [ If the bytes of source starting at offset are not a valid serialized const buffer (wrong version, not enough bytes for the size or for the content) then CONSTBUFFER_THANDLE_from_buffer_view shall fail and return CONSTBUFFER_THANDLE_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
+TEST_FUNCTION(CONSTBUFFER_THANDLE_from_buffer_view_with_insufficient_content_bytes_fails)
+{
+    ///arrange
+    unsigned char serialized[] = { CONSTBUFFER_VERSION_V1, 0x00, 0x00, 0x00, 0x02, 0x42 }; // Claims 2 content bytes but only has 1
+    THANDLE(CONSTBUFFER) source = CONSTBUFFER_THANDLE_Create(serialized, sizeof(serialized));
+    ASSERT_IS_NOT_NULL(source);
+    uint32_t consumed;
+    THANDLE(CONSTBUFFER) destination = NULL;
+
+    umock_c_reset_all_calls();
+
+    ///act
+    CONSTBUFFER_THANDLE_FROM_BUFFER_RESULT result = CONSTBUFFER_THANDLE_from_buffer_view(source, 0, &consumed, &destination);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_THANDLE_FROM_BUFFER_RESULT, CONSTBUFFER_THANDLE_FROM_BUFFER_RESULT_INVALID_DATA, result);
+    ASSERT_IS_NULL(destination);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    THANDLE_ASSIGN(CONSTBUFFER)(&source, NULL);
+}
+
+/*Tests_SRS_CONSTBUFFER_THANDLE_12_011: [ If the bytes of source starting at offset are not a valid serialized const buffer (wrong version, not enough bytes for the size or for the content) then CONSTBUFFER_THANDLE_from_buffer_view shall fail and return CONSTBUFFER_THANDLE_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
+TEST_FUNCTION(CONSTBUFFER_THANDLE_from_buffer_view_with_invalid_version_fails)
+{
+    ///arrange
+    unsigned char serialized[] = { 2, 0x00, 0x00, 0x00, 0x01, 0x42 }; // Invalid version
+    THANDLE(CONSTBUFFER) source = CONSTBUFFER_THANDLE_Create(serialized, sizeof(serialized));
+    ASSERT_IS_NOT_NULL(source);
+    uint32_t consumed;
+    THANDLE(CONSTBUFFER) destination = NULL;
+
+    umock_c_reset_all_calls();
+
+    ///act
+    CONSTBUFFER_THANDLE_FROM_BUFFER_RESULT result = CONSTBUFFER_THANDLE_from_buffer_view(source, 0, &consumed, &destination);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_THANDLE_FROM_BUFFER_RESULT, CONSTBUFFER_THANDLE_FROM_BUFFER_RESULT_INVALID_DATA, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    THANDLE_ASSIGN(CONSTBUFFER)(&source, NULL);
+}
+
+/*Tests_SRS_CONSTBUFFER_THANDLE_12_012: [ CONSTBUFFER_THANDLE_from_buffer_view shall call CONSTBUFFER_THANDLE_CreateFromOffsetAndSize to create a THANDLE(CONSTBUFFER) that points to the serialized content inside source (no bytes are copied). ]*/
+/*Tests_SRS_CONSTBUFFER_THANDLE_12_013: [ CONSTBUFFER_THANDLE_from_buffer_view shall succeed, write in consumed the total number of consumed bytes from source starting at offset, write in destination the constructed THANDLE(CONSTBUFFER) and return CONSTBUFFER_THANDLE_FROM_BUFFER_RESULT_OK. ]*/
+TEST_FUNCTION(CONSTBUFFER_THANDLE_from_buffer_view_succeeds)
+{
+    ///arrange
+    unsigned char serialized[] = {
+        0xFF,                                     // not part of the serialized buffer
+        CONSTBUFFER_VERSION_V1,                   // version = 1
+        0x00, 0x00, 0x00, 0x02,                   // size = 2 (big endian)
+        0x42, 0x43,                               // content = [0x42, 0x43]
+        0x44                                      // extraneous
+    };
+    THANDLE(CONSTBUFFER) source = CONSTBUFFER_THANDLE_Create(serialized, sizeof(serialized));
+    ASSERT_IS_NOT_NULL(source);
+    uint32_t consumed;
+    THANDLE(CONSTBUFFER) destination = NULL;
+
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+
+    ///act
+    CONSTBUFFER_THANDLE_FROM_BUFFER_RESULT result = CONSTBUFFER_THANDLE_from_buffer_view(source, 1, &consumed, &destination);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_THANDLE_FROM_BUFFER_RESULT, CONSTBUFFER_THANDLE_FROM_BUFFER_RESULT_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 7, consumed); // 1 + 4 + 2
+    ASSERT_IS_NOT_NULL(destination);
+
+    // Verify the content points inside source
+    const CONSTBUFFER_CONTENT* content = CONSTBUFFER_THANDLE_GetContent(destination);
+    ASSERT_ARE_EQUAL(uint32_t, 2, content->size);
+    ASSERT_ARE_EQUAL(void_ptr, CONSTBUFFER_THANDLE_GetContent(source)->buffer + 6, content->buffer);
+
+    // destination keeps source alive
+    THANDLE_ASSIGN(CONSTBUFFER)(&source, NULL);
+    ASSERT_ARE_EQUAL(char, 0x42, content->buffer[0]);
+    ASSERT_ARE_EQUAL(char, 0x43, content->buffer[1]);
+
+    ///cleanup
+    THANDLE_ASSIGN(CONSTBUFFER)(&destination, NULL);
+}
+
+/*Tests_SRS_CONSTBUFFER_THANDLE_12_014: [ If there are any failures then CONSTBUFFER_THANDLE_from_buffer_view shall fail and return CONSTBUFFER_THANDLE_FROM_BUFFER_RESULT_ERROR. ]*/
+TEST_FUNCTION(CONSTBUFFER_THANDLE_from_buffer_view_fails_when_malloc_fails)
+{
+    ///arrange
+    unsigned char serialized[] = { CONSTBUFFER_VERSION_V1, 0x00, 0x00, 0x00, 0x01, 0x42, 0x43 };
+    THANDLE(CONSTBUFFER) source = CONSTBUFFER_THANDLE_Create(serialized, sizeof(serialized));
+    ASSERT_IS_NOT_NULL(source);
+    uint32_t consumed;
+    THANDLE(CONSTBUFFER) destination = NULL;
+
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG))
+        .SetReturn(NULL);
+
+    ///act
+    CONSTBUFFER_THANDLE_FROM_BUFFER_RESULT result = CONSTBUFFER_THANDLE_from_buffer_view(source, 0, &consumed, &destination);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_THANDLE_FROM_BUFFER_RESULT, CONSTBUFFER_THANDLE_FROM_BUFFER_RESULT_ERROR, result);
+    ASSERT_IS_NULL(destination);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    THANDLE_ASSIGN(CONSTBUFFER)(&source, NULL);
+}
+
 /* CONSTBUFFER_THANDLE_CreateWritableHandle */
 
 /*Tests_SRS_CONSTBUFFER_THANDLE_88_089: [ If size is 0, then CONSTBUFFER_THANDLE_CreateWritableHandle shall fail and return NULL. ]*/
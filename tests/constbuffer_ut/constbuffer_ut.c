@@ -16,6 +16,8 @@ static void* my_gballoc_malloc_with_context(size_t size, void* context)
 }
 
 #include "c_util/memory_data.h"
+#include "c_util/crc32c.h"
+#include "c_util/lz_codec.h"
 
 #include "c_util/constbuffer_format.h"
 #include "c_util/constbuffer_version.h"
@@ -70,12 +72,44 @@ static size_t my_BUFFER_length(BUFFER_HANDLE handle)
 MOCK_FUNCTION_WITH_CODE(, void, test_free_func, void*, context)
 MOCK_FUNCTION_END()
 
+typedef struct TRY_INC_REF_ON_FREE_CONTEXT_TAG
+{
+    CONSTBUFFER_HANDLE handle;
+    bool result;
+} TRY_INC_REF_ON_FREE_CONTEXT;
+
+/*the custom free function runs after the ref count reached 0, so this is what a cache racing with the last CONSTBUFFER_DecRef observes*/
+static void try_inc_ref_on_free(void* context)
+{
+    TRY_INC_REF_ON_FREE_CONTEXT* try_inc_ref_context = context;
+    try_inc_ref_context->result = CONSTBUFFER_TryIncRef(try_inc_ref_context->handle);
+}
+
 TEST_DEFINE_ENUM_TYPE(CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT, CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_VALUES)
 IMPLEMENT_UMOCK_C_ENUM_TYPE(CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT, CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_VALUES)
 
 TEST_DEFINE_ENUM_TYPE(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_VALUES)
 IMPLEMENT_UMOCK_C_ENUM_TYPE(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_VALUES)
 
+MU_DEFINE_ENUM_STRINGS(MEMORY_MAPPED_FILE_ACCESS_HINT, MEMORY_MAPPED_FILE_ACCESS_HINT_VALUES)
+IMPLEMENT_UMOCK_C_ENUM_TYPE(MEMORY_MAPPED_FILE_ACCESS_HINT, MEMORY_MAPPED_FILE_ACCESS_HINT_VALUES)
+
+static const unsigned char test_mapped_content[] = { 'm', 'a', 'p', 'p', 'e', 'd' };
+#define TEST_MAPPING_BASE (void*)0x4201
+
+static int my_memory_mapped_file_map(const char* file_name, uint64_t offset, uint32_t size, MEMORY_MAPPED_FILE_ACCESS_HINT hint, MEMORY_MAPPED_FILE_VIEW* view)
+{
+    (void)file_name;
+    (void)offset;
+    (void)size;
+    (void)hint;
+    view->mapping_base = TEST_MAPPING_BASE;
+    view->mapping_size = sizeof(test_mapped_content);
+    view->content = test_mapped_content;
+    view->content_size = sizeof(test_mapped_content);
+    return 0;
+}
+
 #define TEST_ALLOC_CONTEXT (void*)0x9874387 /*random typing*/
 static void* test_alloc_impl(size_t size, void* context)
 {
@@ -107,7 +141,13 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
 
         REGISTER_TYPE(CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT, CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT);
         REGISTER_TYPE(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT);
+        REGISTER_TYPE(MEMORY_MAPPED_FILE_ACCESS_HINT, MEMORY_MAPPED_FILE_ACCESS_HINT);
+        REGISTER_UMOCK_ALIAS_TYPE(MEMORY_MAPPED_FILE_VIEW*, void*);
+        REGISTER_GLOBAL_MOCK_HOOK(memory_mapped_file_map, my_memory_mapped_file_map);
         REGISTER_GLOBAL_MOCK_HOOK(test_alloc, test_alloc_impl);
+
+        REGISTER_HASH_GLOBAL_MOCK_HOOK();
+        REGISTER_GLOBAL_MOCK_FAIL_RETURN(hash_compute_hash_64, MU_FAILURE);
 }
 
     TEST_SUITE_CLEANUP(TestClassCleanup)
@@ -677,6 +717,120 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
         CONSTBUFFER_DecRef(handle);
     }
 
+    /* CONSTBUFFER_CreateFromMappedFile */
+
+    /*Tests_SRS_CONSTBUFFER_12_028: [ If file_name is NULL then CONSTBUFFER_CreateFromMappedFile shall fail and return NULL. ]*/
+    TEST_FUNCTION(CONSTBUFFER_CreateFromMappedFile_with_file_name_NULL_fails)
+    {
+        ///arrange
+
+        ///act
+        CONSTBUFFER_HANDLE result = CONSTBUFFER_CreateFromMappedFile(NULL, 0, 0, MEMORY_MAPPED_FILE_ACCESS_HINT_NORMAL);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_CONSTBUFFER_12_029: [ CONSTBUFFER_CreateFromMappedFile shall allocate memory for the CONSTBUFFER_HANDLE. ]*/
+    /*Tests_SRS_CONSTBUFFER_12_030: [ CONSTBUFFER_CreateFromMappedFile shall call memory_mapped_file_map to map size bytes of file_name starting at offset with hint. ]*/
+    /*Tests_SRS_CONSTBUFFER_12_031: [ CONSTBUFFER_CreateFromMappedFile shall set the content of the const buffer to the mapped bytes, set the ref count to 1, succeed and return a non-NULL value. ]*/
+    TEST_FUNCTION(CONSTBUFFER_CreateFromMappedFile_succeeds)
+    {
+        ///arrange
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+        STRICT_EXPECTED_CALL(memory_mapped_file_map("some_file", 4096, 0, MEMORY_MAPPED_FILE_ACCESS_HINT_SEQUENTIAL, IGNORED_ARG));
+
+        ///act
+        CONSTBUFFER_HANDLE result = CONSTBUFFER_CreateFromMappedFile("some_file", 4096, 0, MEMORY_MAPPED_FILE_ACCESS_HINT_SEQUENTIAL);
+
+        ///assert
+        ASSERT_IS_NOT_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        const CONSTBUFFER* content = CONSTBUFFER_GetContent(result);
+        ASSERT_ARE_EQUAL(uint32_t, sizeof(test_mapped_content), content->size);
+        ASSERT_ARE_EQUAL(void_ptr, test_mapped_content, content->buffer);
+
+        ///cleanup
+        CONSTBUFFER_DecRef(result);
+    }
+
+    /*Tests_SRS_CONSTBUFFER_12_032: [ If there are any failures then CONSTBUFFER_CreateFromMappedFile shall fail and return NULL. ]*/
+    TEST_FUNCTION(CONSTBUFFER_CreateFromMappedFile_when_malloc_fails_it_fails)
+    {
+        ///arrange
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG))
+            .SetReturn(NULL);
+
+        ///act
+        CONSTBUFFER_HANDLE result = CONSTBUFFER_CreateFromMappedFile("some_file", 0, 0, MEMORY_MAPPED_FILE_ACCESS_HINT_NORMAL);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_CONSTBUFFER_12_032: [ If there are any failures then CONSTBUFFER_CreateFromMappedFile shall fail and return NULL. ]*/
+    TEST_FUNCTION(CONSTBUFFER_CreateFromMappedFile_when_memory_mapped_file_map_fails_it_fails)
+    {
+        ///arrange
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+        STRICT_EXPECTED_CALL(memory_mapped_file_map("some_file", 0, 0, MEMORY_MAPPED_FILE_ACCESS_HINT_NORMAL, IGNORED_ARG))
+            .SetReturn(MU_FAILURE);
+        STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+        ///act
+        CONSTBUFFER_HANDLE result = CONSTBUFFER_CreateFromMappedFile("some_file", 0, 0, MEMORY_MAPPED_FILE_ACCESS_HINT_NORMAL);
+
+        ///assert
+        ASSERT_IS_NULL(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_CONSTBUFFER_12_033: [ If the buffer was created by calling CONSTBUFFER_CreateFromMappedFile, CONSTBUFFER_DecRef shall call memory_mapped_file_unmap. ]*/
+    TEST_FUNCTION(CONSTBUFFER_DecRef_for_CONSTBUFFER_CreateFromMappedFile_unmaps_the_view)
+    {
+        ///arrange
+        CONSTBUFFER_HANDLE handle = CONSTBUFFER_CreateFromMappedFile("some_file", 0, 0, MEMORY_MAPPED_FILE_ACCESS_HINT_NORMAL);
+        ASSERT_IS_NOT_NULL(handle);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(memory_mapped_file_unmap(IGNORED_ARG));
+        STRICT_EXPECTED_CALL(free(handle));
+
+        ///act
+        CONSTBUFFER_DecRef(handle);
+
+        ///assert
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_CONSTBUFFER_02_024: [ If the constbufferHandle was created by calling CONSTBUFFER_CreateFromOffsetAndSize then CONSTBUFFER_DecRef shall decrement the ref count of the original handle passed to CONSTBUFFER_CreateFromOffsetAndSize. ]*/
+    TEST_FUNCTION(CONSTBUFFER_CreateFromOffsetAndSize_of_a_mapped_file_keeps_the_mapping_until_the_last_DecRef)
+    {
+        ///arrange
+        CONSTBUFFER_HANDLE handle = CONSTBUFFER_CreateFromMappedFile("some_file", 0, 0, MEMORY_MAPPED_FILE_ACCESS_HINT_NORMAL);
+        ASSERT_IS_NOT_NULL(handle);
+        CONSTBUFFER_HANDLE slice = CONSTBUFFER_CreateFromOffsetAndSize(handle, 1, 3);
+        ASSERT_IS_NOT_NULL(slice);
+        CONSTBUFFER_DecRef(handle);
+        umock_c_reset_all_calls();
+
+        const CONSTBUFFER* content = CONSTBUFFER_GetContent(slice);
+        ASSERT_ARE_EQUAL(uint32_t, 3, content->size);
+        ASSERT_ARE_EQUAL(void_ptr, test_mapped_content + 1, content->buffer);
+
+        STRICT_EXPECTED_CALL(memory_mapped_file_unmap(IGNORED_ARG));
+        STRICT_EXPECTED_CALL(free(handle));
+        STRICT_EXPECTED_CALL(free(slice));
+
+        ///act
+        CONSTBUFFER_DecRef(slice);
+
+        ///assert
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
     /*Tests_SRS_CONSTBUFFER_02_025: [ If handle is NULL then CONSTBUFFER_CreateFromOffsetAndSize shall fail and return NULL. ]*/
     TEST_FUNCTION(CONSTBUFFER_CreateFromOffsetAndSize_with_handle_NULL_fails)
     {
@@ -1168,6 +1322,84 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
         ///cleanup
     }
 
+    /* CONSTBUFFER_TryIncRef */
+
+    /*Tests_SRS_CONSTBUFFER_12_113: [ If constbufferHandle is NULL then CONSTBUFFER_TryIncRef shall fail and return false. ]*/
+    TEST_FUNCTION(CONSTBUFFER_TryIncRef_with_NULL_fails)
+    {
+        ///arrange
+
+        ///act
+        bool result = CONSTBUFFER_TryIncRef(NULL);
+
+        ///assert
+        ASSERT_IS_FALSE(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_CONSTBUFFER_12_116: [ Otherwise, CONSTBUFFER_TryIncRef shall increment the reference count (only if it is still not 0, atomically) and return true. ]*/
+    TEST_FUNCTION(CONSTBUFFER_TryIncRef_increments_ref_count)
+    {
+        ///arrange
+        CONSTBUFFER_HANDLE handle = CONSTBUFFER_Create(BUFFER1_u_char, BUFFER1_length);
+        ASSERT_IS_NOT_NULL(handle);
+        umock_c_reset_all_calls();
+
+        ///act
+        bool result = CONSTBUFFER_TryIncRef(handle);
+
+        ///assert
+        ASSERT_IS_TRUE(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        CONSTBUFFER_DecRef(handle); /*only a dec_Ref is expected here, so no effects*/
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        CONSTBUFFER_DecRef(handle);
+    }
+
+    /*Tests_SRS_CONSTBUFFER_12_115: [ If the reference count of constbufferHandle is 0 then CONSTBUFFER_TryIncRef shall return false. ]*/
+    TEST_FUNCTION(CONSTBUFFER_TryIncRef_after_the_last_DecRef_fails)
+    {
+        ///arrange
+        TRY_INC_REF_ON_FREE_CONTEXT context = { NULL, true };
+        context.handle = CONSTBUFFER_CreateWithCustomFree(BUFFER1_u_char, BUFFER1_length, try_inc_ref_on_free, &context);
+        ASSERT_IS_NOT_NULL(context.handle);
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(free(context.handle));
+
+        ///act
+        CONSTBUFFER_DecRef(context.handle);
+
+        ///assert
+        ASSERT_IS_FALSE(context.result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
+
+    /*Tests_SRS_CONSTBUFFER_12_114: [ If constbufferHandle was created by CONSTBUFFER_CreateSharedHot then CONSTBUFFER_TryIncRef shall fail and return false. ]*/
+    TEST_FUNCTION(CONSTBUFFER_TryIncRef_on_a_shared_hot_handle_fails)
+    {
+        ///arrange
+        CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(BUFFER1_u_char, BUFFER1_length);
+        ASSERT_IS_NOT_NULL(source);
+        CONSTBUFFER_HANDLE shared_hot = CONSTBUFFER_CreateSharedHot(source, 4);
+        ASSERT_IS_NOT_NULL(shared_hot);
+        CONSTBUFFER_DecRef(source);
+        umock_c_reset_all_calls();
+
+        ///act
+        bool result = CONSTBUFFER_TryIncRef(shared_hot);
+
+        ///assert
+        ASSERT_IS_FALSE(result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        CONSTBUFFER_DecRef(shared_hot);
+    }
+
     /* CONSTBUFFER_DecRef */
 
     /*Tests_SRS_CONSTBUFFER_02_015: [If constbufferHandle is NULL then CONSTBUFFER_DecRef shall do nothing.]*/
@@ -1396,91 +1628,304 @@ BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
         CONSTBUFFER_DecRef(right);
     }
 
+    /*Tests_SRS_CONSTBUFFER_12_117: [ If CONSTBUFFER_FINGERPRINT_CACHE is defined and the fingerprints of left and right are both known (computed by CONSTBUFFER_GetFingerprint) and are different then CONSTBUFFER_HANDLE_contain_same shall return false without comparing the bytes. ]*/
+    TEST_FUNCTION(CONSTBUFFER_HANDLE_contain_same_with_different_known_fingerprints_returns_false)
+    {
+        ///arrange
+        bool result;
+        uint64_t fingerprint;
+        unsigned char leftSource[2] = { 'l', 'l' };
+        CONSTBUFFER_HANDLE left = CONSTBUFFER_Create(leftSource, sizeof(leftSource));
+        ASSERT_IS_NOT_NULL(left);
+        ASSERT_ARE_EQUAL(int, 0, CONSTBUFFER_GetFingerprint(left, &fingerprint));
 
-/*Tests_SRS_CONSTBUFFER_02_034: [ If handle is NULL then CONSTBUFFER_CreateFromOffsetAndSizeWithCopy shall fail and return NULL. ]*/
-TEST_FUNCTION(CONSTBUFFER_CreateFromOffsetAndSizeWithCopy_with_handle_NULL_fails)
-{
-    ///arrange
-
-    ///act
-    CONSTBUFFER_HANDLE result = CONSTBUFFER_CreateFromOffsetAndSizeWithCopy(NULL, 0, 0);
+        unsigned char rightSource[2] = { 'r', 'r' };
+        CONSTBUFFER_HANDLE right = CONSTBUFFER_Create(rightSource, sizeof(rightSource));
+        ASSERT_IS_NOT_NULL(right);
+        ASSERT_ARE_EQUAL(int, 0, CONSTBUFFER_GetFingerprint(right, &fingerprint));
 
-    ///assert
-    ASSERT_IS_NULL(result);
-    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ///act
+        result = CONSTBUFFER_HANDLE_contain_same(left, right);
 
-    ///clean
-}
+        ///assert
+        ASSERT_IS_FALSE(result);
 
-/*Tests_SRS_CONSTBUFFER_02_035: [ If offset exceeds the capacity of handle then CONSTBUFFER_CreateFromOffsetAndSizeWithCopy shall fail and return NULL. ]*/
-/*Tests_SRS_CONSTBUFFER_02_036: [ If offset + size exceed the capacity of handle then CONSTBUFFER_CreateFromOffsetAndSizeWithCopy shall fail and return NULL. ]*/
-TEST_FUNCTION(CONSTBUFFER_CreateFromOffsetAndSizeWithCopy_with_offset_exceeding_capacity_fails)
-{
-    ///arrange
-    CONSTBUFFER_HANDLE origin;
-    const char source[] = "source";
-    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(source), 1));
-    origin = CONSTBUFFER_Create((const unsigned char*)source, sizeof(source));
-    ASSERT_IS_NOT_NULL(origin);
-    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    umock_c_reset_all_calls();
+        ///clean
+        CONSTBUFFER_DecRef(left);
+        CONSTBUFFER_DecRef(right);
+    }
 
-    ///act
-    CONSTBUFFER_HANDLE result;
-    result = CONSTBUFFER_CreateFromOffsetAndSizeWithCopy(origin, sizeof(source) + 1, 0);
+    /*Tests_SRS_CONSTBUFFER_12_117: [ If CONSTBUFFER_FINGERPRINT_CACHE is defined and the fingerprints of left and right are both known (computed by CONSTBUFFER_GetFingerprint) and are different then CONSTBUFFER_HANDLE_contain_same shall return false without comparing the bytes. ]*/
+    /*Tests_SRS_CONSTBUFFER_02_023: [ CONSTBUFFER_HANDLE_contain_same shall return true. ]*/
+    TEST_FUNCTION(CONSTBUFFER_HANDLE_contain_same_with_same_known_fingerprints_and_same_content_returns_true)
+    {
+        ///arrange
+        bool result;
+        uint64_t fingerprint;
+        unsigned char leftSource[2] = { '1', '2' };
+        CONSTBUFFER_HANDLE left = CONSTBUFFER_Create(leftSource, sizeof(leftSource));
+        ASSERT_IS_NOT_NULL(left);
+        ASSERT_ARE_EQUAL(int, 0, CONSTBUFFER_GetFingerprint(left, &fingerprint));
 
-    ///assert
-    ASSERT_IS_NULL(result);
-    result = CONSTBUFFER_CreateFromOffsetAndSizeWithCopy(origin, 0, sizeof(source) + 1);
-    ASSERT_IS_NULL(result);
-    result = CONSTBUFFER_CreateFromOffsetAndSizeWithCopy(origin, sizeof(source), 1);
-    ASSERT_IS_NULL(result);
-    result = CONSTBUFFER_CreateFromOffsetAndSizeWithCopy(origin, 1, sizeof(source));
-    ASSERT_IS_NULL(result);
+        unsigned char rightSource[2] = { '1', '2' };
+        CONSTBUFFER_HANDLE right = CONSTBUFFER_Create(rightSource, sizeof(rightSource));
+        ASSERT_IS_NOT_NULL(right);
+        ASSERT_ARE_EQUAL(int, 0, CONSTBUFFER_GetFingerprint(right, &fingerprint));
 
-    ///cleanup
-    CONSTBUFFER_DecRef(origin);
-}
+        ///act
+        result = CONSTBUFFER_HANDLE_contain_same(left, right);
 
-/*Tests_SRS_CONSTBUFFER_02_040: [ If there are any failures then CONSTBUFFER_CreateFromOffsetAndSizeWithCopy shall fail and return NULL. ]*/
-TEST_FUNCTION(CONSTBUFFER_CreateFromOffsetAndSizeWithCopy_with_offset_plus_size_equal_to_UINT_MAX_fail)
-{
-    ///arrange
-    CONSTBUFFER_HANDLE origin;
-    const char source[] = "source";
-    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(source), 1));
-    origin = CONSTBUFFER_Create((const unsigned char*)source, sizeof(source));
-    ASSERT_IS_NOT_NULL(origin);
-    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    umock_c_reset_all_calls();
+        ///assert
+        ASSERT_IS_TRUE(result);
 
-    ///act
-    CONSTBUFFER_HANDLE result = CONSTBUFFER_CreateFromOffsetAndSizeWithCopy(origin, sizeof(source) - 1, UINT32_MAX - sizeof(source) + 2);
+        ///clean
+        CONSTBUFFER_DecRef(left);
+        CONSTBUFFER_DecRef(right);
+    }
 
-    ///assert
-    ASSERT_IS_NULL(result);
+    /* CONSTBUFFER_GetFingerprint */
 
-    ///cleanup
-    CONSTBUFFER_DecRef(origin);
-}
+    /*Tests_SRS_CONSTBUFFER_12_118: [ If constbufferHandle is NULL then CONSTBUFFER_GetFingerprint shall fail and return a non-zero value. ]*/
+    TEST_FUNCTION(CONSTBUFFER_GetFingerprint_with_NULL_constbufferHandle_fails)
+    {
+        ///arrange
+        uint64_t fingerprint;
 
-/*Tests_SRS_CONSTBUFFER_02_037: [ CONSTBUFFER_CreateFromOffsetAndSizeWithCopy shall allocate enough memory to hold CONSTBUFFER_HANDLE and size bytes. ]*/
-/*Tests_SRS_CONSTBUFFER_02_038: [ If size is 0 then CONSTBUFFER_CreateFromOffsetAndSizeWithCopy shall set the pointed to buffer to NULL. ]*/
-TEST_FUNCTION(CONSTBUFFER_CreateFromOffsetAndSizeWithCopy_succeeds_1) /*this has size == 0*/
-{
-    ///arrange
-    CONSTBUFFER_HANDLE origin;
-    const char source[] = "source";
-    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(source), 1));
-    origin = CONSTBUFFER_Create((const unsigned char*)source, sizeof(source));
-    ASSERT_IS_NOT_NULL(origin);
-    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    umock_c_reset_all_calls();
+        ///act
+        int result = CONSTBUFFER_GetFingerprint(NULL, &fingerprint);
 
-    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 0, 1));
+        ///assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    }
 
-    ///act
-    CONSTBUFFER_HANDLE result = CONSTBUFFER_CreateFromOffsetAndSizeWithCopy(origin, 0, 0);
+    /*Tests_SRS_CONSTBUFFER_12_119: [ If fingerprint is NULL then CONSTBUFFER_GetFingerprint shall fail and return a non-zero value. ]*/
+    TEST_FUNCTION(CONSTBUFFER_GetFingerprint_with_NULL_fingerprint_fails)
+    {
+        ///arrange
+        CONSTBUFFER_HANDLE handle = CONSTBUFFER_Create(BUFFER1_u_char, BUFFER1_length);
+        ASSERT_IS_NOT_NULL(handle);
+        umock_c_reset_all_calls();
+
+        ///act
+        int result = CONSTBUFFER_GetFingerprint(handle, NULL);
+
+        ///assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///clean
+        CONSTBUFFER_DecRef(handle);
+    }
+
+    /*Tests_SRS_CONSTBUFFER_12_121: [ Otherwise CONSTBUFFER_GetFingerprint shall compute the fingerprint by calling hash_compute_hash_64 with the content. ]*/
+    /*Tests_SRS_CONSTBUFFER_12_122: [ If CONSTBUFFER_FINGERPRINT_CACHE is defined then CONSTBUFFER_GetFingerprint shall store the fingerprint in constbufferHandle (so that subsequent calls and CONSTBUFFER_HANDLE_contain_same do not read the content again). ]*/
+    /*Tests_SRS_CONSTBUFFER_12_123: [ CONSTBUFFER_GetFingerprint shall write the fingerprint in fingerprint and return 0. ]*/
+    TEST_FUNCTION(CONSTBUFFER_GetFingerprint_computes_the_fingerprint)
+    {
+        ///arrange
+        CONSTBUFFER_HANDLE handle = CONSTBUFFER_Create(BUFFER1_u_char, BUFFER1_length);
+        ASSERT_IS_NOT_NULL(handle);
+        uint64_t fingerprint;
+        uint64_t expected_fingerprint;
+        ASSERT_ARE_EQUAL(int, 0, real_hash_compute_hash_64(BUFFER1_u_char, BUFFER1_length, &expected_fingerprint));
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(hash_compute_hash_64(IGNORED_ARG, BUFFER1_length, IGNORED_ARG));
+
+        ///act
+        int result = CONSTBUFFER_GetFingerprint(handle, &fingerprint);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(uint64_t, expected_fingerprint, fingerprint);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///clean
+        CONSTBUFFER_DecRef(handle);
+    }
+
+    /*Tests_SRS_CONSTBUFFER_12_124: [ If hash_compute_hash_64 fails then CONSTBUFFER_GetFingerprint shall fail and return a non-zero value. ]*/
+    TEST_FUNCTION(CONSTBUFFER_GetFingerprint_when_hash_compute_hash_64_fails_fails)
+    {
+        ///arrange
+        CONSTBUFFER_HANDLE handle = CONSTBUFFER_Create(BUFFER1_u_char, BUFFER1_length);
+        ASSERT_IS_NOT_NULL(handle);
+        uint64_t fingerprint;
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(hash_compute_hash_64(IGNORED_ARG, BUFFER1_length, IGNORED_ARG))
+            .SetReturn(MU_FAILURE);
+
+        ///act
+        int result = CONSTBUFFER_GetFingerprint(handle, &fingerprint);
+
+        ///assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///clean
+        CONSTBUFFER_DecRef(handle);
+    }
+
+    /*Tests_SRS_CONSTBUFFER_12_120: [ If CONSTBUFFER_FINGERPRINT_CACHE is defined and the fingerprint of constbufferHandle is already known then CONSTBUFFER_GetFingerprint shall write it in fingerprint and return 0. ]*/
+    TEST_FUNCTION(CONSTBUFFER_GetFingerprint_called_twice_returns_the_same_fingerprint)
+    {
+        ///arrange
+        CONSTBUFFER_HANDLE handle = CONSTBUFFER_Create(BUFFER1_u_char, BUFFER1_length);
+        ASSERT_IS_NOT_NULL(handle);
+        uint64_t fingerprint_1;
+        uint64_t fingerprint_2;
+        ASSERT_ARE_EQUAL(int, 0, CONSTBUFFER_GetFingerprint(handle, &fingerprint_1));
+        umock_c_reset_all_calls();
+
+        ///act
+        int result = CONSTBUFFER_GetFingerprint(handle, &fingerprint_2);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(uint64_t, fingerprint_1, fingerprint_2);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///clean
+        CONSTBUFFER_DecRef(handle);
+    }
+
+    /*Tests_SRS_CONSTBUFFER_12_121: [ Otherwise CONSTBUFFER_GetFingerprint shall compute the fingerprint by calling hash_compute_hash_64 with the content. ]*/
+    TEST_FUNCTION(CONSTBUFFER_GetFingerprint_of_an_empty_buffer_is_the_hash_of_0_bytes)
+    {
+        ///arrange
+        CONSTBUFFER_HANDLE handle = CONSTBUFFER_Create(NULL, 0);
+        ASSERT_IS_NOT_NULL(handle);
+        uint64_t fingerprint;
+        uint64_t expected_fingerprint;
+        ASSERT_ARE_EQUAL(int, 0, real_hash_compute_hash_64(NULL, 0, &expected_fingerprint));
+
+        ///act
+        int result = CONSTBUFFER_GetFingerprint(handle, &fingerprint);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(uint64_t, expected_fingerprint, fingerprint);
+
+        ///clean
+        CONSTBUFFER_DecRef(handle);
+    }
+
+    /*Tests_SRS_CONSTBUFFER_12_121: [ Otherwise CONSTBUFFER_GetFingerprint shall compute the fingerprint by calling hash_compute_hash_64 with the content. ]*/
+    TEST_FUNCTION(CONSTBUFFER_GetFingerprint_of_handles_with_the_same_content_are_equal)
+    {
+        ///arrange
+        CONSTBUFFER_HANDLE handle = CONSTBUFFER_Create(BUFFER1_u_char, BUFFER1_length);
+        ASSERT_IS_NOT_NULL(handle);
+        CONSTBUFFER_HANDLE copy = CONSTBUFFER_CreateFromOffsetAndSizeWithCopy(handle, 0, BUFFER1_length);
+        ASSERT_IS_NOT_NULL(copy);
+        CONSTBUFFER_HANDLE view = CONSTBUFFER_CreateFromOffsetAndSize(handle, 0, BUFFER1_length);
+        ASSERT_IS_NOT_NULL(view);
+        uint64_t fingerprint_handle;
+        uint64_t fingerprint_copy;
+        uint64_t fingerprint_view;
+
+        ///act
+        ASSERT_ARE_EQUAL(int, 0, CONSTBUFFER_GetFingerprint(handle, &fingerprint_handle));
+        ASSERT_ARE_EQUAL(int, 0, CONSTBUFFER_GetFingerprint(copy, &fingerprint_copy));
+        ASSERT_ARE_EQUAL(int, 0, CONSTBUFFER_GetFingerprint(view, &fingerprint_view));
+
+        ///assert
+        ASSERT_ARE_EQUAL(uint64_t, fingerprint_handle, fingerprint_copy);
+        ASSERT_ARE_EQUAL(uint64_t, fingerprint_handle, fingerprint_view);
+
+        ///clean
+        CONSTBUFFER_DecRef(view);
+        CONSTBUFFER_DecRef(copy);
+        CONSTBUFFER_DecRef(handle);
+    }
+
+
+/*Tests_SRS_CONSTBUFFER_02_034: [ If handle is NULL then CONSTBUFFER_CreateFromOffsetAndSizeWithCopy shall fail and return NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_CreateFromOffsetAndSizeWithCopy_with_handle_NULL_fails)
+{
+    ///arrange
+
+    ///act
+    CONSTBUFFER_HANDLE result = CONSTBUFFER_CreateFromOffsetAndSizeWithCopy(NULL, 0, 0);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+}
+
+/*Tests_SRS_CONSTBUFFER_02_035: [ If offset exceeds the capacity of handle then CONSTBUFFER_CreateFromOffsetAndSizeWithCopy shall fail and return NULL. ]*/
+/*Tests_SRS_CONSTBUFFER_02_036: [ If offset + size exceed the capacity of handle then CONSTBUFFER_CreateFromOffsetAndSizeWithCopy shall fail and return NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_CreateFromOffsetAndSizeWithCopy_with_offset_exceeding_capacity_fails)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE origin;
+    const char source[] = "source";
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(source), 1));
+    origin = CONSTBUFFER_Create((const unsigned char*)source, sizeof(source));
+    ASSERT_IS_NOT_NULL(origin);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    umock_c_reset_all_calls();
+
+    ///act
+    CONSTBUFFER_HANDLE result;
+    result = CONSTBUFFER_CreateFromOffsetAndSizeWithCopy(origin, sizeof(source) + 1, 0);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    result = CONSTBUFFER_CreateFromOffsetAndSizeWithCopy(origin, 0, sizeof(source) + 1);
+    ASSERT_IS_NULL(result);
+    result = CONSTBUFFER_CreateFromOffsetAndSizeWithCopy(origin, sizeof(source), 1);
+    ASSERT_IS_NULL(result);
+    result = CONSTBUFFER_CreateFromOffsetAndSizeWithCopy(origin, 1, sizeof(source));
+    ASSERT_IS_NULL(result);
+
+    ///cleanup
+    CONSTBUFFER_DecRef(origin);
+}
+
+/*Tests_SRS_CONSTBUFFER_02_040: [ If there are any failures then CONSTBUFFER_CreateFromOffsetAndSizeWithCopy shall fail and return NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_CreateFromOffsetAndSizeWithCopy_with_offset_plus_size_equal_to_UINT_MAX_fail)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE origin;
+    const char source[] = "source";
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(source), 1));
+    origin = CONSTBUFFER_Create((const unsigned char*)source, sizeof(source));
+    ASSERT_IS_NOT_NULL(origin);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    umock_c_reset_all_calls();
+
+    ///act
+    CONSTBUFFER_HANDLE result = CONSTBUFFER_CreateFromOffsetAndSizeWithCopy(origin, sizeof(source) - 1, UINT32_MAX - sizeof(source) + 2);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+
+    ///cleanup
+    CONSTBUFFER_DecRef(origin);
+}
+
+/*Tests_SRS_CONSTBUFFER_02_037: [ CONSTBUFFER_CreateFromOffsetAndSizeWithCopy shall allocate enough memory to hold CONSTBUFFER_HANDLE and size bytes. ]*/
+/*Tests_SRS_CONSTBUFFER_02_038: [ If size is 0 then CONSTBUFFER_CreateFromOffsetAndSizeWithCopy shall set the pointed to buffer to NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_CreateFromOffsetAndSizeWithCopy_succeeds_1) /*this has size == 0*/
+{
+    ///arrange
+    CONSTBUFFER_HANDLE origin;
+    const char source[] = "source";
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(source), 1));
+    origin = CONSTBUFFER_Create((const unsigned char*)source, sizeof(source));
+    ASSERT_IS_NOT_NULL(origin);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 0, 1));
+
+    ///act
+    CONSTBUFFER_HANDLE result = CONSTBUFFER_CreateFromOffsetAndSizeWithCopy(origin, 0, 0);
 
     ///assert
     ASSERT_IS_NOT_NULL(result);
@@ -1555,6 +2000,7 @@ TEST_FUNCTION(CONSTBUFFER_CreateFromOffsetAndSizeWithCopy_unhappy_path) /*this f
 
 /* Tests_SRS_CONSTBUFFER_88_001: [ CONSTBUFFER_VERSION_SIZE shall be sizeof(uint8_t) (1 byte). ] */
 /* Tests_SRS_CONSTBUFFER_88_002: [ CONSTBUFFER_SIZE_SIZE shall be sizeof(uint32_t) (4 bytes). ] */
+/* Tests_SRS_CONSTBUFFER_12_055: [ CONSTBUFFER_CRC32C_SIZE shall be sizeof(uint32_t) (4 bytes). ] */
 TEST_FUNCTION(CONSBUFFER_HANDLE_serialization_constants)
 {
     ///arrange
@@ -1564,6 +2010,7 @@ TEST_FUNCTION(CONSBUFFER_HANDLE_serialization_constants)
     ///assert
     ASSERT_ARE_EQUAL(size_t, 1, CONSTBUFFER_VERSION_SIZE);
     ASSERT_ARE_EQUAL(size_t, sizeof(uint32_t), CONSTBUFFER_SIZE_SIZE);
+    ASSERT_ARE_EQUAL(size_t, sizeof(uint32_t), CONSTBUFFER_CRC32C_SIZE);
 }
 
 /* CONSTBUFFER_get_serialization_size */
@@ -2220,96 +2667,393 @@ TEST_FUNCTION(CONSTBUFFER_to_fixed_size_buffer_succeeds_3) /*in this case, an em
     CONSTBUFFER_DecRef(source);
 }
 
-/* CONSTBUFFER_from_buffer */
+/* CONSTBUFFER_get_serialization_size_v2 */
 
-/*Tests_SRS_CONSTBUFFER_02_063: [ If source is NULL then CONSTBUFFER_from_buffer shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
-TEST_FUNCTION(CONSTBUFFER_from_buffer_with_source_NULL_fails)
+/*Tests_SRS_CONSTBUFFER_12_076: [ If source is NULL then CONSTBUFFER_get_serialization_size_v2 shall fail and return 0. ]*/
+TEST_FUNCTION(CONSTBUFFER_get_serialization_size_v2_with_source_NULL_fails)
 {
     ///arrange
-    uint32_t consumed;
-    CONSTBUFFER_HANDLE destination;
-    CONSTBUFFER_FROM_BUFFER_RESULT result;
+    uint32_t result;
 
     ///act
-    result = CONSTBUFFER_from_buffer(NULL, 6, &consumed, &destination);
+    result = CONSTBUFFER_get_serialization_size_v2(NULL);
 
     ///assert
-    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(uint32_t, 0, result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
 
-/*Tests_SRS_CONSTBUFFER_02_064: [ If consumed is NULL then CONSTBUFFER_from_buffer shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
-TEST_FUNCTION(CONSTBUFFER_from_buffer_with_consumed_NULL_fails)
+/*Tests_SRS_CONSTBUFFER_12_077: [ If sizeof(uint8_t) + sizeof(uint32_t) + sizeof(uint32_t) + source's size exceed UINT32_MAX then CONSTBUFFER_get_serialization_size_v2 shall fail and return 0. ]*/
+TEST_FUNCTION(CONSTBUFFER_get_serialization_size_v2_with_too_big_size_fails)
 {
     ///arrange
-    CONSTBUFFER_HANDLE destination;
-    CONSTBUFFER_FROM_BUFFER_RESULT result;
-    unsigned char source[10] = { 0 };
+    static const unsigned char not_read = 0;
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_CreateWithCustomFree(&not_read, UINT32_MAX - CONSTBUFFER_V2_CONTENT_OFFSET + 1, test_free_func, NULL); /*1 byte too many for the serialization size to fit in a uint32_t*/
+    ASSERT_IS_NOT_NULL(source);
+    umock_c_reset_all_calls();
+    uint32_t result;
+
     ///act
-    result = CONSTBUFFER_from_buffer(source, 6, NULL, &destination);
+    result = CONSTBUFFER_get_serialization_size_v2(source);
 
     ///assert
-    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(uint32_t, 0, result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(source);
 }
 
-/*Tests_SRS_CONSTBUFFER_02_065: [ If destination is NULL then CONSTBUFFER_from_buffer shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
-TEST_FUNCTION(CONSTBUFFER_from_buffer_with_destination_NULL_fails)
+/*Tests_SRS_CONSTBUFFER_12_078: [ Otherwise CONSTBUFFER_get_serialization_size_v2 shall succeed and return sizeof(uint8_t) + sizeof(uint32_t) + sizeof(uint32_t) + source's size. ]*/
+TEST_FUNCTION(CONSTBUFFER_get_serialization_size_v2_with_2_size_succeeds)
 {
     ///arrange
-    CONSTBUFFER_FROM_BUFFER_RESULT result;
-    uint32_t consumed;
-    unsigned char source[10] = { 0 };
+    unsigned char s[] = { 1, 2 };
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(s), 1));
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(s, sizeof(s));
+    ASSERT_IS_NOT_NULL(source);
+    uint32_t result;
+
     ///act
-    result = CONSTBUFFER_from_buffer(source, 6, &consumed, NULL);
+    result = CONSTBUFFER_get_serialization_size_v2(source);
 
     ///assert
-    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(uint8_t) + sizeof(uint32_t) + sizeof(uint32_t) + sizeof(s), result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(source);
 }
 
-/*Tests_SRS_CONSTBUFFER_02_066: [ If size is 0 then CONSTBUFFER_from_buffer shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
-TEST_FUNCTION(CONSTBUFFER_from_buffer_with_size_0_fails)
+/* CONSTBUFFER_to_buffer_v2 */
+
+/*Tests_SRS_CONSTBUFFER_12_056: [ If source is NULL then CONSTBUFFER_to_buffer_v2 shall fail and return NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_to_buffer_v2_with_source_NULL_fails)
 {
     ///arrange
-    CONSTBUFFER_HANDLE destination;
-    CONSTBUFFER_FROM_BUFFER_RESULT result;
-    uint32_t consumed;
-    unsigned char source[10] = { 0 };
+    unsigned char* result;
+    uint32_t size;
+
     ///act
-    result = CONSTBUFFER_from_buffer(source, 0, &consumed, &destination);
+    result = CONSTBUFFER_to_buffer_v2(NULL, NULL, NULL, &size);
 
     ///assert
-    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG, result);
+    ASSERT_IS_NULL(result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
 
-/*Tests_SRS_CONSTBUFFER_02_067: [ If source byte at offset 0 is not 1 (current version) then CONSTBUFFER_from_buffer shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
-TEST_FUNCTION(CONSTBUFFER_from_buffer_with_version_0_fails)
+/*Tests_SRS_CONSTBUFFER_12_057: [ If serialized_size is NULL then CONSTBUFFER_to_buffer_v2 shall fail and return NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_to_buffer_v2_with_serialized_size_NULL_fails)
 {
     ///arrange
-    CONSTBUFFER_HANDLE destination;
-    CONSTBUFFER_FROM_BUFFER_RESULT result;
-    uint32_t consumed;
-    unsigned char source[10] = { 0 }; /*note first byte to be 0*/
+    unsigned char s[] = { 1 };
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(s), 1));
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(s, sizeof(s));
+    ASSERT_IS_NOT_NULL(source);
+    unsigned char* result;
+
     ///act
-    result = CONSTBUFFER_from_buffer(source, sizeof(source), &consumed, &destination);
+    result = CONSTBUFFER_to_buffer_v2(source, NULL, NULL, NULL);
 
     ///assert
-    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA, result);
+    ASSERT_IS_NULL(result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(source);
 }
 
-/*Tests_SRS_CONSTBUFFER_02_068: [ If source's size is less than sizeof(uint8_t) + sizeof(uint32_t) then CONSTBUFFER_from_buffer shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
-TEST_FUNCTION(CONSTBUFFER_from_buffer_with_insufficient_bytes_fails_1) /*in this case there are not enough bytes for version and size*/
+/*Tests_SRS_CONSTBUFFER_12_058: [ If alloc is NULL then CONSTBUFFER_to_buffer_v2 shall use malloc as provided by gballoc_hl_redirect.h. ]*/
+/*Tests_SRS_CONSTBUFFER_12_059: [ CONSTBUFFER_to_buffer_v2 shall allocate memory using alloc for holding the complete serialization. ]*/
+/*Tests_SRS_CONSTBUFFER_12_060: [ CONSTBUFFER_to_buffer_v2 shall write at offset 0 of the allocated memory the version of the serialization (2). ]*/
+/*Tests_SRS_CONSTBUFFER_12_061: [ CONSTBUFFER_to_buffer_v2 shall write at offsets 1-4 of the allocated memory the value of source->alias.size in network byte order. ]*/
+/*Tests_SRS_CONSTBUFFER_12_062: [ CONSTBUFFER_to_buffer_v2 shall call crc32c_copy to write starting at offset 9 of the allocated memory the bytes of source->alias.buffer and compute their CRC32C in the same pass. ]*/
+/*Tests_SRS_CONSTBUFFER_12_063: [ CONSTBUFFER_to_buffer_v2 shall write at offsets 5-8 of the allocated memory the CRC32C in network byte order. ]*/
+/*Tests_SRS_CONSTBUFFER_12_064: [ CONSTBUFFER_to_buffer_v2 shall succeed, write in serialized_size the size of the serialization and return the allocated memory. ]*/
+TEST_FUNCTION(CONSTBUFFER_to_buffer_v2_with_size_2_with_malloc_succeeds)
 {
     ///arrange
-    CONSTBUFFER_HANDLE destination;
-    CONSTBUFFER_FROM_BUFFER_RESULT result;
-    uint32_t consumed;
-    unsigned char source[10] = { 1 }; /*note first byte to be 1, rest are 0*/
-    ///act
-    result = CONSTBUFFER_from_buffer(source, sizeof(uint8_t) + sizeof(uint32_t) - 1, &consumed, &destination);
+    unsigned char s[] = { 0x42, 0x43 };
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(s), 1));
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(s, sizeof(s));
+    ASSERT_IS_NOT_NULL(source);
+    unsigned char* result;
+    uint32_t size;
+
+    STRICT_EXPECTED_CALL(malloc(CONSTBUFFER_V2_CONTENT_OFFSET + sizeof(s)));
+
+    ///act
+    result = CONSTBUFFER_to_buffer_v2(source, NULL, NULL, &size);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(uint32_t, CONSTBUFFER_V2_CONTENT_OFFSET + sizeof(s), size);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    /*version*/
+    uint8_t version_from_serialization;
+    read_uint8_t(result + CONSTBUFFER_VERSION_OFFSET, &version_from_serialization);
+    ASSERT_ARE_EQUAL(uint8_t, CONSTBUFFER_VERSION_V2, version_from_serialization);
+
+    /*size*/
+    uint32_t size_from_serialization;
+    read_uint32_t(result + CONSTBUFFER_SIZE_OFFSET, &size_from_serialization);
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(s), size_from_serialization);
+
+    /*crc32c*/
+    uint32_t crc32c_from_serialization;
+    read_uint32_t(result + CONSTBUFFER_CRC32C_OFFSET, &crc32c_from_serialization);
+    ASSERT_ARE_EQUAL(uint32_t, crc32c_compute(0, s, sizeof(s)), crc32c_from_serialization);
+
+    /*content*/
+    ASSERT_IS_TRUE(memcmp(s, result + CONSTBUFFER_V2_CONTENT_OFFSET, sizeof(s)) == 0);
+
+    ///clean
+    CONSTBUFFER_DecRef(source);
+    free(result);
+}
+
+/*Tests_SRS_CONSTBUFFER_12_065: [ If there are any failures then CONSTBUFFER_to_buffer_v2 shall fail and return NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_to_buffer_v2_with_size_2_with_custom_alloc_unhappy_path)
+{
+    ///arrange
+    unsigned char s[] = { 1, 2 };
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(s), 1));
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(s, sizeof(s));
+    ASSERT_IS_NOT_NULL(source);
+    unsigned char* result;
+    uint32_t size;
+
+    STRICT_EXPECTED_CALL(test_alloc(CONSTBUFFER_V2_CONTENT_OFFSET + sizeof(s), TEST_ALLOC_CONTEXT))
+        .SetReturn(NULL);
+
+    ///act
+    result = CONSTBUFFER_to_buffer_v2(source, test_alloc, TEST_ALLOC_CONTEXT, &size);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(source);
+}
+
+/* CONSTBUFFER_to_fixed_size_buffer_v2 */
+
+/*Tests_SRS_CONSTBUFFER_12_066: [ If source is NULL then CONSTBUFFER_to_fixed_size_buffer_v2 shall fail and return CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INVALID_ARG. ]*/
+/*Tests_SRS_CONSTBUFFER_12_067: [ If destination is NULL then CONSTBUFFER_to_fixed_size_buffer_v2 shall fail and return CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INVALID_ARG. ]*/
+/*Tests_SRS_CONSTBUFFER_12_068: [ If serialized_size is NULL then CONSTBUFFER_to_fixed_size_buffer_v2 shall fail and return CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INVALID_ARG. ]*/
+TEST_FUNCTION(CONSTBUFFER_to_fixed_size_buffer_v2_with_invalid_arguments_fails)
+{
+    ///arrange
+    unsigned char source_bytes[1] = { 1 };
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(source_bytes), 1));
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(source_bytes, sizeof(source_bytes));
+    ASSERT_IS_NOT_NULL(source);
+    unsigned char destination[100];
+    uint32_t serialized_size;
+
+    ///act
+    CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT result_1 = CONSTBUFFER_to_fixed_size_buffer_v2(NULL, destination, sizeof(destination), &serialized_size);
+    CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT result_2 = CONSTBUFFER_to_fixed_size_buffer_v2(source, NULL, sizeof(destination), &serialized_size);
+    CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT result_3 = CONSTBUFFER_to_fixed_size_buffer_v2(source, destination, sizeof(destination), NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT, CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INVALID_ARG, result_1);
+    ASSERT_ARE_EQUAL(CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT, CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INVALID_ARG, result_2);
+    ASSERT_ARE_EQUAL(CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT, CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INVALID_ARG, result_3);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(source);
+}
+
+/*Tests_SRS_CONSTBUFFER_12_069: [ If the size of serialization exceeds destination_size then CONSTBUFFER_to_fixed_size_buffer_v2 shall fail, write in serialized_size how much it would need and return CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INSUFFICIENT_BUFFER. ]*/
+TEST_FUNCTION(CONSTBUFFER_to_fixed_size_buffer_v2_that_would_overflow_destination_fails)
+{
+    ///arrange
+    unsigned char source_bytes[1] = { 1 };
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(source_bytes), 1));
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(source_bytes, sizeof(source_bytes));
+    ASSERT_IS_NOT_NULL(source);
+
+    unsigned char destination[9]; /*the above CONSTBUFFER_HANDLE requires 10 bytes...*/
+    uint32_t serialized_size;
+    CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT result;
+
+    ///act
+    result = CONSTBUFFER_to_fixed_size_buffer_v2(source, destination, sizeof(destination), &serialized_size);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT, CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_INSUFFICIENT_BUFFER, result);
+    ASSERT_ARE_EQUAL(uint32_t, 10, serialized_size);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(source);
+}
+
+/*Tests_SRS_CONSTBUFFER_12_075: [ If there are any failures then CONSTBUFFER_to_fixed_size_buffer_v2 shall fail and return CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_ERROR. ]*/
+TEST_FUNCTION(CONSTBUFFER_to_fixed_size_buffer_v2_when_serialized_size_overflows_fails)
+{
+    ///arrange
+    static const unsigned char not_read = 0;
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_CreateWithCustomFree(&not_read, UINT32_MAX - CONSTBUFFER_V2_CONTENT_OFFSET + 1, test_free_func, NULL); /*1 byte too many for the serialization size to fit in a uint32_t*/
+    ASSERT_IS_NOT_NULL(source);
+    umock_c_reset_all_calls();
+
+    unsigned char destination[1]; /*never written, the overflow is detected before destination_size is looked at*/
+    uint32_t serialized_size;
+    CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT result;
+
+    ///act
+    result = CONSTBUFFER_to_fixed_size_buffer_v2(source, destination, UINT32_MAX, &serialized_size);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT, CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(source);
+}
+
+/*Tests_SRS_CONSTBUFFER_12_070: [ CONSTBUFFER_to_fixed_size_buffer_v2 shall write at offset 0 of destination the version of serialization (2). ]*/
+/*Tests_SRS_CONSTBUFFER_12_071: [ CONSTBUFFER_to_fixed_size_buffer_v2 shall write at offset 1 of destination the value of source->alias.size in network byte order. ]*/
+/*Tests_SRS_CONSTBUFFER_12_072: [ CONSTBUFFER_to_fixed_size_buffer_v2 shall call crc32c_copy to copy all the bytes of source->alias.buffer in destination starting at offset 9 and compute their CRC32C in the same pass. ]*/
+/*Tests_SRS_CONSTBUFFER_12_073: [ CONSTBUFFER_to_fixed_size_buffer_v2 shall write at offset 5 of destination the CRC32C in network byte order. ]*/
+/*Tests_SRS_CONSTBUFFER_12_074: [ CONSTBUFFER_to_fixed_size_buffer_v2 shall succeed, write in serialized_size how much it used and return CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_OK. ]*/
+TEST_FUNCTION(CONSTBUFFER_to_fixed_size_buffer_v2_succeeds)
+{
+    ///arrange
+    unsigned char source_bytes[3] = { 1, 2, 3 };
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(source_bytes), 1));
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(source_bytes, sizeof(source_bytes));
+    ASSERT_IS_NOT_NULL(source);
+
+    unsigned char destination[20];
+    uint32_t serialized_size;
+    CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT result;
+
+    ///act
+    result = CONSTBUFFER_to_fixed_size_buffer_v2(source, destination, sizeof(destination), &serialized_size);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT, CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT_OK, result);
+    ASSERT_ARE_EQUAL(uint32_t, CONSTBUFFER_V2_CONTENT_OFFSET + sizeof(source_bytes), serialized_size);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    /*version*/
+    uint8_t serialized_version;
+    read_uint8_t(destination + CONSTBUFFER_VERSION_OFFSET, &serialized_version);
+    ASSERT_ARE_EQUAL(uint8_t, CONSTBUFFER_VERSION_V2, serialized_version);
+
+    /*size*/
+    uint32_t size;
+    read_uint32_t(destination + CONSTBUFFER_SIZE_OFFSET, &size);
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(source_bytes), size);
+
+    /*crc32c*/
+    uint32_t serialized_crc32c;
+    read_uint32_t(destination + CONSTBUFFER_CRC32C_OFFSET, &serialized_crc32c);
+    ASSERT_ARE_EQUAL(uint32_t, crc32c_compute(0, source_bytes, sizeof(source_bytes)), serialized_crc32c);
+
+    /*content*/
+    ASSERT_IS_TRUE(memcmp(source_bytes, destination + CONSTBUFFER_V2_CONTENT_OFFSET, sizeof(source_bytes)) == 0);
+
+    ///clean
+    CONSTBUFFER_DecRef(source);
+}
+
+/* CONSTBUFFER_from_buffer */
+
+/*Tests_SRS_CONSTBUFFER_02_063: [ If source is NULL then CONSTBUFFER_from_buffer shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_with_source_NULL_fails)
+{
+    ///arrange
+    uint32_t consumed;
+    CONSTBUFFER_HANDLE destination;
+    CONSTBUFFER_FROM_BUFFER_RESULT result;
+
+    ///act
+    result = CONSTBUFFER_from_buffer(NULL, 6, &consumed, &destination);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_02_064: [ If consumed is NULL then CONSTBUFFER_from_buffer shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_with_consumed_NULL_fails)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE destination;
+    CONSTBUFFER_FROM_BUFFER_RESULT result;
+    unsigned char source[10] = { 0 };
+    ///act
+    result = CONSTBUFFER_from_buffer(source, 6, NULL, &destination);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_02_065: [ If destination is NULL then CONSTBUFFER_from_buffer shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_with_destination_NULL_fails)
+{
+    ///arrange
+    CONSTBUFFER_FROM_BUFFER_RESULT result;
+    uint32_t consumed;
+    unsigned char source[10] = { 0 };
+    ///act
+    result = CONSTBUFFER_from_buffer(source, 6, &consumed, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_02_066: [ If size is 0 then CONSTBUFFER_from_buffer shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_with_size_0_fails)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE destination;
+    CONSTBUFFER_FROM_BUFFER_RESULT result;
+    uint32_t consumed;
+    unsigned char source[10] = { 0 };
+    ///act
+    result = CONSTBUFFER_from_buffer(source, 0, &consumed, &destination);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_02_067: [ If source byte at offset 0 is not 1 or 2 (the known versions) then CONSTBUFFER_from_buffer shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_with_version_0_fails)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE destination;
+    CONSTBUFFER_FROM_BUFFER_RESULT result;
+    uint32_t consumed;
+    unsigned char source[10] = { 0 }; /*note first byte to be 0*/
+    ///act
+    result = CONSTBUFFER_from_buffer(source, sizeof(source), &consumed, &destination);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_02_068: [ If source's size is less than sizeof(uint8_t) + sizeof(uint32_t) then CONSTBUFFER_from_buffer shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_with_insufficient_bytes_fails_1) /*in this case there are not enough bytes for version and size*/
+{
+    ///arrange
+    CONSTBUFFER_HANDLE destination;
+    CONSTBUFFER_FROM_BUFFER_RESULT result;
+    uint32_t consumed;
+    unsigned char source[10] = { 1 }; /*note first byte to be 1, rest are 0*/
+    ///act
+    result = CONSTBUFFER_from_buffer(source, sizeof(uint8_t) + sizeof(uint32_t) - 1, &consumed, &destination);
 
     ///assert
     ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA, result);
@@ -2544,267 +3288,2160 @@ TEST_FUNCTION(CONSTBUFFER_from_buffer_with_2_size_unhappy_path)
     ///clean
 }
 
-/*CONSTBUFFER_CreateWritableHandle*/
-
-/*Tests_SRS_CONSTBUFFER_51_001: [ If size is 0, then CONSTBUFFER_CreateWritableHandle shall fail and return NULL. ]*/
-TEST_FUNCTION(CONSTBUFFER_CreateWritableHandle_invalid_args_fails)
+/*Tests_SRS_CONSTBUFFER_12_079: [ If the version is 2 and source's size is less than sizeof(uint8_t) + sizeof(uint32_t) + sizeof(uint32_t) then CONSTBUFFER_from_buffer shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_v2_with_insufficient_bytes_for_header_fails)
 {
     ///arrange
+    CONSTBUFFER_HANDLE destination = NULL;
+    CONSTBUFFER_FROM_BUFFER_RESULT result;
+    uint32_t consumed;
+    unsigned char source[] = {
+        2, /*version*/
+        0,0,0,0,/*size = 0*/
+        0,0,0 /*crc32c is missing 1 byte*/
+    };
 
     ///act
-    CONSTBUFFER_WRITABLE_HANDLE handle = CONSTBUFFER_CreateWritableHandle(0);
+    result = CONSTBUFFER_from_buffer(source, sizeof(source), &consumed, &destination);
 
     ///assert
-    ASSERT_IS_NULL(handle);
-
-    ///cleanup
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA, result);
+    ASSERT_IS_NULL(destination);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
 
-/*Tests_SRS_CONSTBUFFER_51_003: [ If any error occurs, CONSTBUFFER_CreateWritableHandle shall fail and return NULL. ]*/
-TEST_FUNCTION(CONSTBUFFER_CreateWritableHandle_fails_when_malloc_fails)
+/*Tests_SRS_CONSTBUFFER_12_081: [ If the version is 2 and source's size is less than sizeof(uint8_t) + sizeof(uint32_t) + sizeof(uint32_t) + number of content bytes then CONSTBUFFER_from_buffer shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_v2_with_insufficient_bytes_for_content_fails)
 {
     ///arrange
-    CONSTBUFFER_WRITABLE_HANDLE handle;
-    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, BUFFER1_length, 1))
-        .SetReturn(NULL);
+    CONSTBUFFER_HANDLE destination = NULL;
+    CONSTBUFFER_FROM_BUFFER_RESULT result;
+    uint32_t consumed;
+    unsigned char source[] = {
+        2, /*version*/
+        0,0,0,2,/*size = 2*/
+        0,0,0,0,/*crc32c*/
+        0x42 /*only 1 byte of content*/
+    };
 
     ///act
-    handle = CONSTBUFFER_CreateWritableHandle(BUFFER1_length);
+    result = CONSTBUFFER_from_buffer(source, sizeof(source), &consumed, &destination);
 
     ///assert
-    ASSERT_IS_NULL(handle);
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA, result);
+    ASSERT_IS_NULL(destination);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-
-    ///cleanup
+}
+
+/*Tests_SRS_CONSTBUFFER_12_080: [ If the version is 2 then CONSTBUFFER_from_buffer shall read the CRC32C of the content from offset 5 of source. ]*/
+/*Tests_SRS_CONSTBUFFER_12_082: [ If the version is 2 then CONSTBUFFER_from_buffer shall create a CONSTBUFFER_HANDLE from the bytes at offset 9 of source, computing their CRC32C with crc32c_copy in the same pass as the copy. ]*/
+/*Tests_SRS_CONSTBUFFER_02_072: [ CONSTBUFFER_from_buffer shall succeed, write in consumed the total number of consumed bytes from source, write in destination the constructed CONSTBUFFER_HANDLE and return CONSTBUFFER_FROM_BUFFER_RESULT_OK. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_v2_with_2_size_succeeds)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE destination = NULL;
+    CONSTBUFFER_FROM_BUFFER_RESULT result;
+    uint32_t consumed;
+    unsigned char content_bytes[] = { 0x42, 0x43 };
+    unsigned char source[CONSTBUFFER_V2_CONTENT_OFFSET + sizeof(content_bytes) + 1];
+    write_uint8_t(source + CONSTBUFFER_VERSION_OFFSET, CONSTBUFFER_VERSION_V2);
+    write_uint32_t(source + CONSTBUFFER_SIZE_OFFSET, sizeof(content_bytes));
+    write_uint32_t(source + CONSTBUFFER_CRC32C_OFFSET, crc32c_compute(0, content_bytes, sizeof(content_bytes)));
+    (void)memcpy(source + CONSTBUFFER_V2_CONTENT_OFFSET, content_bytes, sizeof(content_bytes));
+    source[sizeof(source) - 1] = 0x44; /*extraneous*/
+
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(content_bytes), 1));
+
+    ///act
+    result = CONSTBUFFER_from_buffer(source, sizeof(source), &consumed, &destination);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_OK, result);
+    ASSERT_IS_NOT_NULL(destination);
+    ASSERT_ARE_EQUAL(uint32_t, CONSTBUFFER_V2_CONTENT_OFFSET + sizeof(content_bytes), consumed);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    const CONSTBUFFER* content = CONSTBUFFER_GetContent(destination);
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(content_bytes), content->size);
+    ASSERT_IS_TRUE(memcmp(content_bytes, content->buffer, content->size) == 0);
+
+    ///clean
+    CONSTBUFFER_DecRef(destination);
+}
+
+/*Tests_SRS_CONSTBUFFER_12_083: [ If the version is 2 and the computed CRC32C is different than the serialized CRC32C then CONSTBUFFER_from_buffer shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_v2_with_corrupted_content_fails)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE destination = NULL;
+    CONSTBUFFER_FROM_BUFFER_RESULT result;
+    uint32_t consumed;
+    unsigned char content_bytes[] = { 0x42, 0x43 };
+    unsigned char source[CONSTBUFFER_V2_CONTENT_OFFSET + sizeof(content_bytes)];
+    write_uint8_t(source + CONSTBUFFER_VERSION_OFFSET, CONSTBUFFER_VERSION_V2);
+    write_uint32_t(source + CONSTBUFFER_SIZE_OFFSET, sizeof(content_bytes));
+    write_uint32_t(source + CONSTBUFFER_CRC32C_OFFSET, crc32c_compute(0, content_bytes, sizeof(content_bytes)));
+    (void)memcpy(source + CONSTBUFFER_V2_CONTENT_OFFSET, content_bytes, sizeof(content_bytes));
+    source[CONSTBUFFER_V2_CONTENT_OFFSET + 1] ^= 0x01; /*flip 1 bit*/
+
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(content_bytes), 1));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    ///act
+    result = CONSTBUFFER_from_buffer(source, sizeof(source), &consumed, &destination);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA, result);
+    ASSERT_IS_NULL(destination);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_02_073: [ If there are any failures then shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_ERROR. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_v2_unhappy_path)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE destination = NULL;
+    CONSTBUFFER_FROM_BUFFER_RESULT result;
+    uint32_t consumed;
+    unsigned char content_bytes[] = { 0x42, 0x43 };
+    unsigned char source[CONSTBUFFER_V2_CONTENT_OFFSET + sizeof(content_bytes)];
+    write_uint8_t(source + CONSTBUFFER_VERSION_OFFSET, CONSTBUFFER_VERSION_V2);
+    write_uint32_t(source + CONSTBUFFER_SIZE_OFFSET, sizeof(content_bytes));
+    write_uint32_t(source + CONSTBUFFER_CRC32C_OFFSET, crc32c_compute(0, content_bytes, sizeof(content_bytes)));
+    (void)memcpy(source + CONSTBUFFER_V2_CONTENT_OFFSET, content_bytes, sizeof(content_bytes));
+
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(content_bytes), 1))
+        .SetReturn(NULL);
+
+    ///act
+    result = CONSTBUFFER_from_buffer(source, sizeof(source), &consumed, &destination);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_ERROR, result);
+    ASSERT_IS_NULL(destination);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_12_060: [ CONSTBUFFER_to_buffer_v2 shall write at offset 0 of the allocated memory the version of the serialization (2). ]*/
+/*Tests_SRS_CONSTBUFFER_12_082: [ If the version is 2 then CONSTBUFFER_from_buffer shall create a CONSTBUFFER_HANDLE from the bytes at offset 9 of source, computing their CRC32C with crc32c_copy in the same pass as the copy. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_reads_what_CONSTBUFFER_to_buffer_v2_wrote)
+{
+    ///arrange
+    unsigned char s[100];
+    for (uint32_t i = 0; i < sizeof(s); i++)
+    {
+        s[i] = (unsigned char)(i * 7 + 3);
+    }
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(s, sizeof(s));
+    ASSERT_IS_NOT_NULL(source);
+    uint32_t serialized_size;
+    unsigned char* serialized = CONSTBUFFER_to_buffer_v2(source, NULL, NULL, &serialized_size);
+    ASSERT_IS_NOT_NULL(serialized);
+    CONSTBUFFER_HANDLE destination = NULL;
+    uint32_t consumed;
+
+    ///act
+    CONSTBUFFER_FROM_BUFFER_RESULT result = CONSTBUFFER_from_buffer(serialized, serialized_size, &consumed, &destination);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_OK, result);
+    ASSERT_ARE_EQUAL(uint32_t, serialized_size, consumed);
+    const CONSTBUFFER* content = CONSTBUFFER_GetContent(destination);
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(s), content->size);
+    ASSERT_IS_TRUE(memcmp(s, content->buffer, sizeof(s)) == 0);
+
+    ///clean
+    CONSTBUFFER_DecRef(destination);
+    CONSTBUFFER_DecRef(source);
+    free(serialized);
+}
+
+/*CONSTBUFFER_from_buffer_view*/
+
+/*Tests_SRS_CONSTBUFFER_12_034: [ If source is NULL then CONSTBUFFER_from_buffer_view shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_view_with_source_NULL_fails)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE destination = NULL;
+    uint32_t consumed;
+
+    ///act
+    CONSTBUFFER_FROM_BUFFER_RESULT result = CONSTBUFFER_from_buffer_view(NULL, 0, &consumed, &destination);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG, result);
+    ASSERT_IS_NULL(destination);
+}
+
+/*Tests_SRS_CONSTBUFFER_12_035: [ If consumed is NULL then CONSTBUFFER_from_buffer_view shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_view_with_consumed_NULL_fails)
+{
+    ///arrange
+    unsigned char serialized[] = { 1, 0, 0, 0, 1, 0x42 };
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(serialized, sizeof(serialized));
+    ASSERT_IS_NOT_NULL(source);
+    CONSTBUFFER_HANDLE destination = NULL;
+    umock_c_reset_all_calls();
+
+    ///act
+    CONSTBUFFER_FROM_BUFFER_RESULT result = CONSTBUFFER_from_buffer_view(source, 0, NULL, &destination);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG, result);
+    ASSERT_IS_NULL(destination);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(source);
+}
+
+/*Tests_SRS_CONSTBUFFER_12_036: [ If destination is NULL then CONSTBUFFER_from_buffer_view shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_view_with_destination_NULL_fails)
+{
+    ///arrange
+    unsigned char serialized[] = { 1, 0, 0, 0, 1, 0x42 };
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(serialized, sizeof(serialized));
+    ASSERT_IS_NOT_NULL(source);
+    uint32_t consumed;
+    umock_c_reset_all_calls();
+
+    ///act
+    CONSTBUFFER_FROM_BUFFER_RESULT result = CONSTBUFFER_from_buffer_view(source, 0, &consumed, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(source);
+}
+
+/*Tests_SRS_CONSTBUFFER_12_037: [ If offset is greater than or equal to the size of source then CONSTBUFFER_from_buffer_view shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_view_with_offset_at_the_end_of_source_fails)
+{
+    ///arrange
+    unsigned char serialized[] = { 1, 0, 0, 0, 1, 0x42 };
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(serialized, sizeof(serialized));
+    ASSERT_IS_NOT_NULL(source);
+    CONSTBUFFER_HANDLE destination = NULL;
+    uint32_t consumed;
+    umock_c_reset_all_calls();
+
+    ///act
+    CONSTBUFFER_FROM_BUFFER_RESULT result = CONSTBUFFER_from_buffer_view(source, sizeof(serialized), &consumed, &destination);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG, result);
+    ASSERT_IS_NULL(destination);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(source);
+}
+
+/*Tests_SRS_CONSTBUFFER_12_038: [ If the bytes of source starting at offset are not a valid serialized const buffer (unknown version, not enough bytes for the header or for the content, CRC32C mismatch for version 2) then CONSTBUFFER_from_buffer_view shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_view_with_invalid_data_fails)
+{
+    ///arrange
+    unsigned char wrong_version[] = { 3, 0, 0, 0, 1, 0x42 };
+    unsigned char no_size[] = { 1, 0, 0, 0 };
+    unsigned char short_content[] = { 1, 0, 0, 0, 2, 0x42 };
+    CONSTBUFFER_HANDLE sources[3];
+    sources[0] = CONSTBUFFER_Create(wrong_version, sizeof(wrong_version));
+    sources[1] = CONSTBUFFER_Create(no_size, sizeof(no_size));
+    sources[2] = CONSTBUFFER_Create(short_content, sizeof(short_content));
+    umock_c_reset_all_calls();
+
+    for (uint32_t i = 0; i < sizeof(sources) / sizeof(sources[0]); i++)
+    {
+        ASSERT_IS_NOT_NULL(sources[i]);
+        CONSTBUFFER_HANDLE destination = NULL;
+        uint32_t consumed;
+
+        ///act
+        CONSTBUFFER_FROM_BUFFER_RESULT result = CONSTBUFFER_from_buffer_view(sources[i], 0, &consumed, &destination);
+
+        ///assert
+        ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA, result);
+        ASSERT_IS_NULL(destination);
+    }
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    for (uint32_t i = 0; i < sizeof(sources) / sizeof(sources[0]); i++)
+    {
+        CONSTBUFFER_DecRef(sources[i]);
+    }
+}
+
+/*Tests_SRS_CONSTBUFFER_12_039: [ CONSTBUFFER_from_buffer_view shall allocate a CONSTBUFFER_HANDLE whose content is the serialized content inside source (no bytes are copied) and shall increment the reference count of source. ]*/
+/*Tests_SRS_CONSTBUFFER_12_040: [ CONSTBUFFER_from_buffer_view shall succeed, write in consumed the total number of consumed bytes from source starting at offset, write in destination the constructed CONSTBUFFER_HANDLE and return CONSTBUFFER_FROM_BUFFER_RESULT_OK. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_view_succeeds)
+{
+    ///arrange
+    unsigned char serialized[] = {
+        0xFF, /*not part of the serialized const buffer*/
+        1, /*version*/
+        0,0,0,2,/*size = 2*/
+        0x42, 0x43,
+        0x44 /*extraneous*/
+    };
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(serialized, sizeof(serialized));
+    ASSERT_IS_NOT_NULL(source);
+    CONSTBUFFER_HANDLE destination = NULL;
+    uint32_t consumed;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+
+    ///act
+    CONSTBUFFER_FROM_BUFFER_RESULT result = CONSTBUFFER_from_buffer_view(source, 1, &consumed, &destination);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, CONSTBUFFER_CONTENT_OFFSET + 2, consumed);
+    const CONSTBUFFER* content = CONSTBUFFER_GetContent(destination);
+    ASSERT_ARE_EQUAL(uint32_t, 2, content->size);
+    ASSERT_ARE_EQUAL(void_ptr, CONSTBUFFER_GetContent(source)->buffer + 1 + CONSTBUFFER_CONTENT_OFFSET, content->buffer, "no bytes are copied");
+
+    /*source is kept alive by destination*/
+    CONSTBUFFER_DecRef(source);
+    ASSERT_ARE_EQUAL(uint8_t, 0x42, content->buffer[0]);
+    ASSERT_ARE_EQUAL(uint8_t, 0x43, content->buffer[1]);
+
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(free(source));
+    STRICT_EXPECTED_CALL(free(destination));
+    CONSTBUFFER_DecRef(destination);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_12_041: [ If there are any failures then CONSTBUFFER_from_buffer_view shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_ERROR. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_view_when_malloc_fails_it_fails)
+{
+    ///arrange
+    unsigned char serialized[] = { 1, 0, 0, 0, 1, 0x42 };
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(serialized, sizeof(serialized));
+    ASSERT_IS_NOT_NULL(source);
+    CONSTBUFFER_HANDLE destination = NULL;
+    uint32_t consumed;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG))
+        .SetReturn(NULL);
+
+    ///act
+    CONSTBUFFER_FROM_BUFFER_RESULT result = CONSTBUFFER_from_buffer_view(source, 0, &consumed, &destination);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_ERROR, result);
+    ASSERT_IS_NULL(destination);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(source);
+}
+
+/*Tests_SRS_CONSTBUFFER_12_038: [ If the bytes of source starting at offset are not a valid serialized const buffer (unknown version, not enough bytes for the header or for the content, CRC32C mismatch for version 2) then CONSTBUFFER_from_buffer_view shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_view_with_v2_corrupted_content_fails)
+{
+    ///arrange
+    unsigned char content_bytes[] = { 0x42, 0x43 };
+    unsigned char serialized[CONSTBUFFER_V2_CONTENT_OFFSET + sizeof(content_bytes)];
+    write_uint8_t(serialized + CONSTBUFFER_VERSION_OFFSET, CONSTBUFFER_VERSION_V2);
+    write_uint32_t(serialized + CONSTBUFFER_SIZE_OFFSET, sizeof(content_bytes));
+    write_uint32_t(serialized + CONSTBUFFER_CRC32C_OFFSET, crc32c_compute(0, content_bytes, sizeof(content_bytes)) ^ 0x80000000);
+    (void)memcpy(serialized + CONSTBUFFER_V2_CONTENT_OFFSET, content_bytes, sizeof(content_bytes));
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(serialized, sizeof(serialized));
+    ASSERT_IS_NOT_NULL(source);
+    CONSTBUFFER_HANDLE destination = NULL;
+    uint32_t consumed;
+    umock_c_reset_all_calls();
+
+    ///act
+    CONSTBUFFER_FROM_BUFFER_RESULT result = CONSTBUFFER_from_buffer_view(source, 0, &consumed, &destination);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA, result);
+    ASSERT_IS_NULL(destination);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(source);
+}
+
+/*Tests_SRS_CONSTBUFFER_12_039: [ CONSTBUFFER_from_buffer_view shall allocate a CONSTBUFFER_HANDLE whose content is the serialized content inside source (no bytes are copied) and shall increment the reference count of source. ]*/
+/*Tests_SRS_CONSTBUFFER_12_040: [ CONSTBUFFER_from_buffer_view shall succeed, write in consumed the total number of consumed bytes from source starting at offset, write in destination the constructed CONSTBUFFER_HANDLE and return CONSTBUFFER_FROM_BUFFER_RESULT_OK. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_view_with_v2_succeeds)
+{
+    ///arrange
+    unsigned char content_bytes[] = { 0x42, 0x43 };
+    unsigned char serialized[CONSTBUFFER_V2_CONTENT_OFFSET + sizeof(content_bytes)];
+    write_uint8_t(serialized + CONSTBUFFER_VERSION_OFFSET, CONSTBUFFER_VERSION_V2);
+    write_uint32_t(serialized + CONSTBUFFER_SIZE_OFFSET, sizeof(content_bytes));
+    write_uint32_t(serialized + CONSTBUFFER_CRC32C_OFFSET, crc32c_compute(0, content_bytes, sizeof(content_bytes)));
+    (void)memcpy(serialized + CONSTBUFFER_V2_CONTENT_OFFSET, content_bytes, sizeof(content_bytes));
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(serialized, sizeof(serialized));
+    ASSERT_IS_NOT_NULL(source);
+    CONSTBUFFER_HANDLE destination = NULL;
+    uint32_t consumed;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+
+    ///act
+    CONSTBUFFER_FROM_BUFFER_RESULT result = CONSTBUFFER_from_buffer_view(source, 0, &consumed, &destination);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(serialized), consumed);
+    const CONSTBUFFER* content = CONSTBUFFER_GetContent(destination);
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(content_bytes), content->size);
+    ASSERT_ARE_EQUAL(void_ptr, CONSTBUFFER_GetContent(source)->buffer + CONSTBUFFER_V2_CONTENT_OFFSET, content->buffer, "no bytes are copied");
+
+    ///clean
+    CONSTBUFFER_DecRef(destination);
+    CONSTBUFFER_DecRef(source);
+}
+
+/*CONSTBUFFER_from_buffer_view_bulk*/
+
+/*Tests_SRS_CONSTBUFFER_12_042: [ If source is NULL then CONSTBUFFER_from_buffer_view_bulk shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_view_bulk_with_source_NULL_fails)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE destinations[2];
+    uint32_t consumed;
+
+    ///act
+    CONSTBUFFER_FROM_BUFFER_RESULT result = CONSTBUFFER_from_buffer_view_bulk(NULL, 0, 2, &consumed, destinations);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG, result);
+}
+
+/*Tests_SRS_CONSTBUFFER_12_043: [ If count is 0 then CONSTBUFFER_from_buffer_view_bulk shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
+/*Tests_SRS_CONSTBUFFER_12_044: [ If consumed is NULL then CONSTBUFFER_from_buffer_view_bulk shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
+/*Tests_SRS_CONSTBUFFER_12_045: [ If destinations is NULL then CONSTBUFFER_from_buffer_view_bulk shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
+/*Tests_SRS_CONSTBUFFER_12_046: [ If offset is greater than or equal to the size of source then CONSTBUFFER_from_buffer_view_bulk shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_view_bulk_with_invalid_args_fails)
+{
+    ///arrange
+    unsigned char serialized[] = { 1, 0, 0, 0, 1, 0x42 };
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(serialized, sizeof(serialized));
+    ASSERT_IS_NOT_NULL(source);
+    CONSTBUFFER_HANDLE destinations[1];
+    uint32_t consumed;
+    umock_c_reset_all_calls();
+
+    ///act
+    CONSTBUFFER_FROM_BUFFER_RESULT result_count_0 = CONSTBUFFER_from_buffer_view_bulk(source, 0, 0, &consumed, destinations);
+    CONSTBUFFER_FROM_BUFFER_RESULT result_consumed_NULL = CONSTBUFFER_from_buffer_view_bulk(source, 0, 1, NULL, destinations);
+    CONSTBUFFER_FROM_BUFFER_RESULT result_destinations_NULL = CONSTBUFFER_from_buffer_view_bulk(source, 0, 1, &consumed, NULL);
+    CONSTBUFFER_FROM_BUFFER_RESULT result_offset_too_big = CONSTBUFFER_from_buffer_view_bulk(source, sizeof(serialized), 1, &consumed, destinations);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG, result_count_0);
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG, result_consumed_NULL);
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG, result_destinations_NULL);
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_ARG, result_offset_too_big);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(source);
+}
+
+/*Tests_SRS_CONSTBUFFER_12_047: [ CONSTBUFFER_from_buffer_view_bulk shall validate count serialized const buffers that follow each other in source starting at offset. If any of them is not valid then CONSTBUFFER_from_buffer_view_bulk shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_view_bulk_with_not_enough_serialized_buffers_fails)
+{
+    ///arrange
+    unsigned char serialized[] = {
+        1, 0, 0, 0, 1, 0x42,
+        1, 0, 0, 0, 0
+    };
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(serialized, sizeof(serialized));
+    ASSERT_IS_NOT_NULL(source);
+    CONSTBUFFER_HANDLE destinations[3];
+    uint32_t consumed;
+    umock_c_reset_all_calls();
+
+    ///act
+    CONSTBUFFER_FROM_BUFFER_RESULT result = CONSTBUFFER_from_buffer_view_bulk(source, 0, 3, &consumed, destinations);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(source);
+}
+
+/*Tests_SRS_CONSTBUFFER_12_047: [ CONSTBUFFER_from_buffer_view_bulk shall validate count serialized const buffers that follow each other in source starting at offset. If any of them is not valid then CONSTBUFFER_from_buffer_view_bulk shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_view_bulk_with_invalid_second_buffer_fails)
+{
+    ///arrange
+    unsigned char serialized[] = {
+        1, 0, 0, 0, 1, 0x42,
+        7, 0, 0, 0, 1, 0x43 /*wrong version*/
+    };
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(serialized, sizeof(serialized));
+    ASSERT_IS_NOT_NULL(source);
+    CONSTBUFFER_HANDLE destinations[2];
+    uint32_t consumed;
+    umock_c_reset_all_calls();
+
+    ///act
+    CONSTBUFFER_FROM_BUFFER_RESULT result = CONSTBUFFER_from_buffer_view_bulk(source, 0, 2, &consumed, destinations);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_INVALID_DATA, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(source);
+}
+
+/*Tests_SRS_CONSTBUFFER_12_048: [ CONSTBUFFER_from_buffer_view_bulk shall allocate one block of memory for all the count views. ]*/
+/*Tests_SRS_CONSTBUFFER_12_049: [ CONSTBUFFER_from_buffer_view_bulk shall increment the reference count of source once for all the views. ]*/
+/*Tests_SRS_CONSTBUFFER_12_050: [ CONSTBUFFER_from_buffer_view_bulk shall write in destinations[i] a CONSTBUFFER_HANDLE (with the ref count set to 1) whose content is the content of the i-th serialized const buffer inside source (no bytes are copied). ]*/
+/*Tests_SRS_CONSTBUFFER_12_051: [ CONSTBUFFER_from_buffer_view_bulk shall succeed, write in consumed the total number of consumed bytes from source starting at offset and return CONSTBUFFER_FROM_BUFFER_RESULT_OK. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_view_bulk_succeeds)
+{
+    ///arrange
+    unsigned char serialized[] = {
+        0xFF, 0xFF, /*not part of the serialized const buffers*/
+        1, 0, 0, 0, 2, 0x42, 0x43,
+        1, 0, 0, 0, 0,
+        1, 0, 0, 0, 1, 0x44,
+        0xFF /*extraneous*/
+    };
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(serialized, sizeof(serialized));
+    ASSERT_IS_NOT_NULL(source);
+    const unsigned char* source_bytes = CONSTBUFFER_GetContent(source)->buffer;
+    CONSTBUFFER_HANDLE destinations[3];
+    uint32_t consumed;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 3, IGNORED_ARG));
+
+    ///act
+    CONSTBUFFER_FROM_BUFFER_RESULT result = CONSTBUFFER_from_buffer_view_bulk(source, 2, 3, &consumed, destinations);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(serialized) - 3, consumed);
+
+    ASSERT_ARE_EQUAL(uint32_t, 2, CONSTBUFFER_GetContent(destinations[0])->size);
+    ASSERT_ARE_EQUAL(void_ptr, source_bytes + 7, CONSTBUFFER_GetContent(destinations[0])->buffer);
+    ASSERT_ARE_EQUAL(uint32_t, 0, CONSTBUFFER_GetContent(destinations[1])->size);
+    ASSERT_ARE_EQUAL(uint32_t, 1, CONSTBUFFER_GetContent(destinations[2])->size);
+    ASSERT_ARE_EQUAL(void_ptr, source_bytes + 19, CONSTBUFFER_GetContent(destinations[2])->buffer);
+
+    ///clean
+    CONSTBUFFER_DecRef(source);
+    CONSTBUFFER_DecRef(destinations[0]);
+    CONSTBUFFER_DecRef(destinations[1]);
+    CONSTBUFFER_DecRef(destinations[2]);
+}
+
+/*Tests_SRS_CONSTBUFFER_12_052: [ If there are any failures then CONSTBUFFER_from_buffer_view_bulk shall fail and return CONSTBUFFER_FROM_BUFFER_RESULT_ERROR. ]*/
+TEST_FUNCTION(CONSTBUFFER_from_buffer_view_bulk_when_malloc_flex_fails_it_fails)
+{
+    ///arrange
+    unsigned char serialized[] = {
+        1, 0, 0, 0, 1, 0x42,
+        1, 0, 0, 0, 1, 0x43
+    };
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(serialized, sizeof(serialized));
+    ASSERT_IS_NOT_NULL(source);
+    CONSTBUFFER_HANDLE destinations[2];
+    uint32_t consumed;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 2, IGNORED_ARG))
+        .SetReturn(NULL);
+
+    ///act
+    CONSTBUFFER_FROM_BUFFER_RESULT result = CONSTBUFFER_from_buffer_view_bulk(source, 0, 2, &consumed, destinations);
+
+    ///assert
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(source);
+}
+
+/*Tests_SRS_CONSTBUFFER_12_053: [ If the constbufferHandle was created by calling CONSTBUFFER_from_buffer_view_bulk then CONSTBUFFER_DecRef shall decrement the number of views alive in the block that holds constbufferHandle. ]*/
+/*Tests_SRS_CONSTBUFFER_12_054: [ When the last view of a block is released, CONSTBUFFER_DecRef shall decrement the ref count of the source passed to CONSTBUFFER_from_buffer_view_bulk and free the block. ]*/
+TEST_FUNCTION(CONSTBUFFER_DecRef_for_CONSTBUFFER_from_buffer_view_bulk_frees_the_block_with_the_last_view)
+{
+    ///arrange
+    unsigned char serialized[] = {
+        1, 0, 0, 0, 1, 0x42,
+        1, 0, 0, 0, 1, 0x43
+    };
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(serialized, sizeof(serialized));
+    ASSERT_IS_NOT_NULL(source);
+    CONSTBUFFER_HANDLE destinations[2];
+    uint32_t consumed;
+    ASSERT_ARE_EQUAL(CONSTBUFFER_FROM_BUFFER_RESULT, CONSTBUFFER_FROM_BUFFER_RESULT_OK, CONSTBUFFER_from_buffer_view_bulk(source, 0, 2, &consumed, destinations));
+    CONSTBUFFER_DecRef(source);
+    CONSTBUFFER_IncRef(destinations[1]);
+    umock_c_reset_all_calls();
+
+    ///act
+    CONSTBUFFER_DecRef(destinations[1]); /*still referenced*/
+    CONSTBUFFER_DecRef(destinations[0]); /*block still has destinations[1]*/
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint8_t, 0x43, CONSTBUFFER_GetContent(destinations[1])->buffer[0]);
+
+    STRICT_EXPECTED_CALL(free(source));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG)); /*the block*/
+    CONSTBUFFER_DecRef(destinations[1]);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*CONSTBUFFER_CreateCompressed*/
+
+static void fill_compressible_bytes(unsigned char* bytes, uint32_t size)
+{
+    static const char pattern[] = "{\"id\":12, \"name\":\"le buffer\", \"status\":\"ok\"}, ";
+    for (uint32_t i = 0; i < size; i++)
+    {
+        bytes[i] = (unsigned char)pattern[i % (sizeof(pattern) - 1)];
+    }
+}
+
+static void fill_incompressible_bytes(unsigned char* bytes, uint32_t size)
+{
+    uint32_t seed = 42;
+    for (uint32_t i = 0; i < size; i++)
+    {
+        seed = seed * 1103515245 + 12345;
+        bytes[i] = (unsigned char)(seed >> 16);
+    }
+}
+
+/*Tests_SRS_CONSTBUFFER_12_084: [ If source is NULL then CONSTBUFFER_CreateCompressed shall fail and return NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_CreateCompressed_with_NULL_source_fails)
+{
+    ///act
+    CONSTBUFFER_HANDLE result = CONSTBUFFER_CreateCompressed(NULL);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_12_085: [ If CONSTBUFFER_COMPRESSION_HEADER_SIZE + lz_codec_compress_bound(size of source) exceeds UINT32_MAX then CONSTBUFFER_CreateCompressed shall fail and return NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_CreateCompressed_with_source_too_big_fails)
+{
+    ///arrange
+    static const unsigned char not_read = 0;
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_CreateWithCustomFree(&not_read, UINT32_MAX, test_free_func, NULL);
+    ASSERT_IS_NOT_NULL(source);
+    umock_c_reset_all_calls();
+
+    ///act
+    CONSTBUFFER_HANDLE result = CONSTBUFFER_CreateCompressed(source);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(source);
+}
+
+/*Tests_SRS_CONSTBUFFER_12_086: [ CONSTBUFFER_CreateCompressed shall allocate memory for the CONSTBUFFER_HANDLE and CONSTBUFFER_COMPRESSION_HEADER_SIZE + lz_codec_compress_bound(size of source) bytes. ]*/
+/*Tests_SRS_CONSTBUFFER_12_087: [ CONSTBUFFER_CreateCompressed shall call lz_codec_compress to compress the content of source after the header. ]*/
+/*Tests_SRS_CONSTBUFFER_12_089: [ CONSTBUFFER_CreateCompressed shall write at offset 0 the compression method and at offsets 1-4 the size of the content of source in network byte order. ]*/
+/*Tests_SRS_CONSTBUFFER_12_090: [ CONSTBUFFER_CreateCompressed shall call realloc_flex to give back the memory that was not used. If realloc_flex fails then CONSTBUFFER_CreateCompressed shall keep the memory allocated initially. ]*/
+/*Tests_SRS_CONSTBUFFER_12_091: [ CONSTBUFFER_CreateCompressed shall set the ref count of the produced CONSTBUFFER_HANDLE to 1, succeed and return it. ]*/
+TEST_FUNCTION(CONSTBUFFER_CreateCompressed_compresses_the_content)
+{
+    ///arrange
+    unsigned char source_bytes[1000];
+    fill_compressible_bytes(source_bytes, sizeof(source_bytes));
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(source_bytes, sizeof(source_bytes));
+    ASSERT_IS_NOT_NULL(source);
+    uint32_t bound = lz_codec_compress_bound(sizeof(source_bytes));
+    unsigned char* expected_payload = real_gballoc_hl_malloc(bound);
+    ASSERT_IS_NOT_NULL(expected_payload);
+    uint32_t expected_payload_size;
+    ASSERT_ARE_EQUAL(int, 0, lz_codec_compress(source_bytes, sizeof(source_bytes), expected_payload, bound, &expected_payload_size));
+    ASSERT_IS_TRUE(expected_payload_size < sizeof(source_bytes));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, CONSTBUFFER_COMPRESSION_HEADER_SIZE + bound, 1));
+    STRICT_EXPECTED_CALL(realloc_flex(IGNORED_ARG, IGNORED_ARG, CONSTBUFFER_COMPRESSION_HEADER_SIZE + expected_payload_size, 1));
+
+    ///act
+    CONSTBUFFER_HANDLE result = CONSTBUFFER_CreateCompressed(source);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    const CONSTBUFFER* content = CONSTBUFFER_GetContent(result);
+    ASSERT_ARE_EQUAL(uint32_t, CONSTBUFFER_COMPRESSION_HEADER_SIZE + expected_payload_size, content->size);
+    uint8_t method;
+    read_uint8_t(content->buffer + CONSTBUFFER_COMPRESSION_METHOD_OFFSET, &method);
+    ASSERT_ARE_EQUAL(uint8_t, CONSTBUFFER_COMPRESSION_METHOD_LZ, method);
+    uint32_t uncompressed_size;
+    read_uint32_t(content->buffer + CONSTBUFFER_UNCOMPRESSED_SIZE_OFFSET, &uncompressed_size);
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(source_bytes), uncompressed_size);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(expected_payload, content->buffer + CONSTBUFFER_COMPRESSED_PAYLOAD_OFFSET, expected_payload_size));
+
+    ///clean
+    real_gballoc_hl_free(expected_payload);
+    CONSTBUFFER_DecRef(result);
+    CONSTBUFFER_DecRef(source);
+}
+
+/*Tests_SRS_CONSTBUFFER_12_088: [ If the compressed content is not smaller than the content of source then CONSTBUFFER_CreateCompressed shall copy the content of source after the header instead and use CONSTBUFFER_COMPRESSION_METHOD_STORED as compression method. ]*/
+TEST_FUNCTION(CONSTBUFFER_CreateCompressed_stores_incompressible_content)
+{
+    ///arrange
+    unsigned char source_bytes[1000];
+    fill_incompressible_bytes(source_bytes, sizeof(source_bytes));
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(source_bytes, sizeof(source_bytes));
+    ASSERT_IS_NOT_NULL(source);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, CONSTBUFFER_COMPRESSION_HEADER_SIZE + lz_codec_compress_bound(sizeof(source_bytes)), 1));
+    STRICT_EXPECTED_CALL(realloc_flex(IGNORED_ARG, IGNORED_ARG, CONSTBUFFER_COMPRESSION_HEADER_SIZE + sizeof(source_bytes), 1));
+
+    ///act
+    CONSTBUFFER_HANDLE result = CONSTBUFFER_CreateCompressed(source);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    const CONSTBUFFER* content = CONSTBUFFER_GetContent(result);
+    ASSERT_ARE_EQUAL(uint32_t, CONSTBUFFER_COMPRESSION_HEADER_SIZE + sizeof(source_bytes), content->size);
+    ASSERT_ARE_EQUAL(uint8_t, CONSTBUFFER_COMPRESSION_METHOD_STORED, content->buffer[CONSTBUFFER_COMPRESSION_METHOD_OFFSET]);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(source_bytes, content->buffer + CONSTBUFFER_COMPRESSED_PAYLOAD_OFFSET, sizeof(source_bytes)));
+
+    ///clean
+    CONSTBUFFER_DecRef(result);
+    CONSTBUFFER_DecRef(source);
+}
+
+/*Tests_SRS_CONSTBUFFER_12_088: [ If the compressed content is not smaller than the content of source then CONSTBUFFER_CreateCompressed shall copy the content of source after the header instead and use CONSTBUFFER_COMPRESSION_METHOD_STORED as compression method. ]*/
+TEST_FUNCTION(CONSTBUFFER_CreateCompressed_with_empty_source_produces_only_the_header)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(NULL, 0);
+    ASSERT_IS_NOT_NULL(source);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, CONSTBUFFER_COMPRESSION_HEADER_SIZE + lz_codec_compress_bound(0), 1));
+    STRICT_EXPECTED_CALL(realloc_flex(IGNORED_ARG, IGNORED_ARG, CONSTBUFFER_COMPRESSION_HEADER_SIZE, 1));
+
+    ///act
+    CONSTBUFFER_HANDLE result = CONSTBUFFER_CreateCompressed(source);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    const CONSTBUFFER* content = CONSTBUFFER_GetContent(result);
+    ASSERT_ARE_EQUAL(uint32_t, CONSTBUFFER_COMPRESSION_HEADER_SIZE, content->size);
+    ASSERT_ARE_EQUAL(uint8_t, CONSTBUFFER_COMPRESSION_METHOD_STORED, content->buffer[CONSTBUFFER_COMPRESSION_METHOD_OFFSET]);
+
+    ///clean
+    CONSTBUFFER_DecRef(result);
+    CONSTBUFFER_DecRef(source);
+}
+
+/*Tests_SRS_CONSTBUFFER_12_090: [ CONSTBUFFER_CreateCompressed shall call realloc_flex to give back the memory that was not used. If realloc_flex fails then CONSTBUFFER_CreateCompressed shall keep the memory allocated initially. ]*/
+TEST_FUNCTION(CONSTBUFFER_CreateCompressed_when_realloc_flex_fails_succeeds)
+{
+    ///arrange
+    unsigned char source_bytes[1000];
+    fill_compressible_bytes(source_bytes, sizeof(source_bytes));
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(source_bytes, sizeof(source_bytes));
+    ASSERT_IS_NOT_NULL(source);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, CONSTBUFFER_COMPRESSION_HEADER_SIZE + lz_codec_compress_bound(sizeof(source_bytes)), 1));
+    STRICT_EXPECTED_CALL(realloc_flex(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, 1))
+        .SetReturn(NULL);
+
+    ///act
+    CONSTBUFFER_HANDLE result = CONSTBUFFER_CreateCompressed(source);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    CONSTBUFFER_HANDLE decompressed = CONSTBUFFER_Decompress(result);
+    ASSERT_IS_NOT_NULL(decompressed);
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(source_bytes), CONSTBUFFER_GetContent(decompressed)->size);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(source_bytes, CONSTBUFFER_GetContent(decompressed)->buffer, sizeof(source_bytes)));
+
+    ///clean
+    CONSTBUFFER_DecRef(decompressed);
+    CONSTBUFFER_DecRef(result);
+    CONSTBUFFER_DecRef(source);
+}
+
+/*Tests_SRS_CONSTBUFFER_12_092: [ If there are any failures then CONSTBUFFER_CreateCompressed shall fail and return NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_CreateCompressed_when_malloc_flex_fails_fails)
+{
+    ///arrange
+    unsigned char source_bytes[1000];
+    fill_compressible_bytes(source_bytes, sizeof(source_bytes));
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(source_bytes, sizeof(source_bytes));
+    ASSERT_IS_NOT_NULL(source);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, CONSTBUFFER_COMPRESSION_HEADER_SIZE + lz_codec_compress_bound(sizeof(source_bytes)), 1))
+        .SetReturn(NULL);
+
+    ///act
+    CONSTBUFFER_HANDLE result = CONSTBUFFER_CreateCompressed(source);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(source);
+}
+
+/*CONSTBUFFER_Decompress*/
+
+/*Tests_SRS_CONSTBUFFER_12_093: [ If compressed is NULL then CONSTBUFFER_Decompress shall fail and return NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_Decompress_with_NULL_compressed_fails)
+{
+    ///act
+    CONSTBUFFER_HANDLE result = CONSTBUFFER_Decompress(NULL);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_12_094: [ If the size of compressed is less than CONSTBUFFER_COMPRESSION_HEADER_SIZE then CONSTBUFFER_Decompress shall fail and return NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_Decompress_with_compressed_too_small_fails)
+{
+    ///arrange
+    static const unsigned char too_small[] = { CONSTBUFFER_COMPRESSION_METHOD_STORED, 0, 0, 0 };
+    CONSTBUFFER_HANDLE compressed = CONSTBUFFER_Create(too_small, sizeof(too_small));
+    ASSERT_IS_NOT_NULL(compressed);
+    umock_c_reset_all_calls();
+
+    ///act
+    CONSTBUFFER_HANDLE result = CONSTBUFFER_Decompress(compressed);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(compressed);
+}
+
+/*Tests_SRS_CONSTBUFFER_12_097: [ If the compression method is CONSTBUFFER_COMPRESSION_METHOD_LZ then CONSTBUFFER_Decompress shall allocate memory for the CONSTBUFFER_HANDLE and the uncompressed size bytes. ]*/
+/*Tests_SRS_CONSTBUFFER_12_098: [ CONSTBUFFER_Decompress shall call lz_codec_decompress to decompress the payload. ]*/
+/*Tests_SRS_CONSTBUFFER_12_099: [ CONSTBUFFER_Decompress shall set the ref count of the produced CONSTBUFFER_HANDLE to 1, succeed and return it. ]*/
+TEST_FUNCTION(CONSTBUFFER_Decompress_decompresses_what_CONSTBUFFER_CreateCompressed_produced)
+{
+    ///arrange
+    unsigned char source_bytes[1000];
+    fill_compressible_bytes(source_bytes, sizeof(source_bytes));
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(source_bytes, sizeof(source_bytes));
+    ASSERT_IS_NOT_NULL(source);
+    CONSTBUFFER_HANDLE compressed = CONSTBUFFER_CreateCompressed(source);
+    ASSERT_IS_NOT_NULL(compressed);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(source_bytes), 1));
+
+    ///act
+    CONSTBUFFER_HANDLE result = CONSTBUFFER_Decompress(compressed);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(source_bytes), CONSTBUFFER_GetContent(result)->size);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(source_bytes, CONSTBUFFER_GetContent(result)->buffer, sizeof(source_bytes)));
+
+    ///clean
+    CONSTBUFFER_DecRef(result);
+    CONSTBUFFER_DecRef(compressed);
+    CONSTBUFFER_DecRef(source);
+}
+
+/*Tests_SRS_CONSTBUFFER_12_096: [ If the compression method is CONSTBUFFER_COMPRESSION_METHOD_STORED then CONSTBUFFER_Decompress shall call CONSTBUFFER_CreateFromOffsetAndSize to produce a CONSTBUFFER_HANDLE that points to the payload of compressed (no bytes are copied). ]*/
+TEST_FUNCTION(CONSTBUFFER_Decompress_with_stored_payload_does_not_copy)
+{
+    ///arrange
+    unsigned char source_bytes[1000];
+    fill_incompressible_bytes(source_bytes, sizeof(source_bytes));
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(source_bytes, sizeof(source_bytes));
+    ASSERT_IS_NOT_NULL(source);
+    CONSTBUFFER_HANDLE compressed = CONSTBUFFER_CreateCompressed(source);
+    ASSERT_IS_NOT_NULL(compressed);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+
+    ///act
+    CONSTBUFFER_HANDLE result = CONSTBUFFER_Decompress(compressed);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(source_bytes), CONSTBUFFER_GetContent(result)->size);
+    ASSERT_ARE_EQUAL(void_ptr, CONSTBUFFER_GetContent(compressed)->buffer + CONSTBUFFER_COMPRESSED_PAYLOAD_OFFSET, CONSTBUFFER_GetContent(result)->buffer);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(source_bytes, CONSTBUFFER_GetContent(result)->buffer, sizeof(source_bytes)));
+
+    ///clean
+    CONSTBUFFER_DecRef(compressed);
+    CONSTBUFFER_DecRef(result); /*releases compressed*/
+    CONSTBUFFER_DecRef(source);
+}
+
+/*Tests_SRS_CONSTBUFFER_12_096: [ If the compression method is CONSTBUFFER_COMPRESSION_METHOD_STORED then CONSTBUFFER_Decompress shall call CONSTBUFFER_CreateFromOffsetAndSize to produce a CONSTBUFFER_HANDLE that points to the payload of compressed (no bytes are copied). ]*/
+TEST_FUNCTION(CONSTBUFFER_Decompress_with_only_the_header_produces_an_empty_buffer)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(NULL, 0);
+    ASSERT_IS_NOT_NULL(source);
+    CONSTBUFFER_HANDLE compressed = CONSTBUFFER_CreateCompressed(source);
+    ASSERT_IS_NOT_NULL(compressed);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+
+    ///act
+    CONSTBUFFER_HANDLE result = CONSTBUFFER_Decompress(compressed);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 0, CONSTBUFFER_GetContent(result)->size);
+
+    ///clean
+    CONSTBUFFER_DecRef(result);
+    CONSTBUFFER_DecRef(compressed);
+    CONSTBUFFER_DecRef(source);
+}
+
+/*Tests_SRS_CONSTBUFFER_12_095: [ If the compression method is CONSTBUFFER_COMPRESSION_METHOD_STORED and the size of the payload is not the uncompressed size then CONSTBUFFER_Decompress shall fail and return NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_Decompress_with_stored_payload_of_wrong_size_fails)
+{
+    ///arrange
+    static const unsigned char stored[] = { CONSTBUFFER_COMPRESSION_METHOD_STORED, 0, 0, 0, 3, 'a', 'b' };
+    CONSTBUFFER_HANDLE compressed = CONSTBUFFER_Create(stored, sizeof(stored));
+    ASSERT_IS_NOT_NULL(compressed);
+    umock_c_reset_all_calls();
+
+    ///act
+    CONSTBUFFER_HANDLE result = CONSTBUFFER_Decompress(compressed);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(compressed);
+}
+
+/*Tests_SRS_CONSTBUFFER_12_101: [ If the compression method is unknown then CONSTBUFFER_Decompress shall fail and return NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_Decompress_with_unknown_method_fails)
+{
+    ///arrange
+    static const unsigned char unknown[] = { 2, 0, 0, 0, 1, 'a' };
+    CONSTBUFFER_HANDLE compressed = CONSTBUFFER_Create(unknown, sizeof(unknown));
+    ASSERT_IS_NOT_NULL(compressed);
+    umock_c_reset_all_calls();
+
+    ///act
+    CONSTBUFFER_HANDLE result = CONSTBUFFER_Decompress(compressed);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(compressed);
+}
+
+/*Tests_SRS_CONSTBUFFER_12_098: [ CONSTBUFFER_Decompress shall call lz_codec_decompress to decompress the payload. ]*/
+/*Tests_SRS_CONSTBUFFER_12_100: [ If there are any failures then CONSTBUFFER_Decompress shall fail and return NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_Decompress_with_wrong_uncompressed_size_fails)
+{
+    ///arrange
+    unsigned char source_bytes[1000];
+    fill_compressible_bytes(source_bytes, sizeof(source_bytes));
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(source_bytes, sizeof(source_bytes));
+    ASSERT_IS_NOT_NULL(source);
+    CONSTBUFFER_HANDLE compressed = CONSTBUFFER_CreateCompressed(source);
+    ASSERT_IS_NOT_NULL(compressed);
+    const CONSTBUFFER* compressed_content = CONSTBUFFER_GetContent(compressed);
+    unsigned char* corrupted_bytes = real_gballoc_hl_malloc(compressed_content->size);
+    ASSERT_IS_NOT_NULL(corrupted_bytes);
+    (void)memcpy(corrupted_bytes, compressed_content->buffer, compressed_content->size);
+    write_uint32_t(corrupted_bytes + CONSTBUFFER_UNCOMPRESSED_SIZE_OFFSET, sizeof(source_bytes) + 1);
+    CONSTBUFFER_HANDLE corrupted = CONSTBUFFER_Create(corrupted_bytes, compressed_content->size);
+    ASSERT_IS_NOT_NULL(corrupted);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(source_bytes) + 1, 1));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    ///act
+    CONSTBUFFER_HANDLE result = CONSTBUFFER_Decompress(corrupted);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(corrupted);
+    real_gballoc_hl_free(corrupted_bytes);
+    CONSTBUFFER_DecRef(compressed);
+    CONSTBUFFER_DecRef(source);
+}
+
+/*Tests_SRS_CONSTBUFFER_12_100: [ If there are any failures then CONSTBUFFER_Decompress shall fail and return NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_Decompress_when_malloc_flex_fails_fails)
+{
+    ///arrange
+    unsigned char source_bytes[1000];
+    fill_compressible_bytes(source_bytes, sizeof(source_bytes));
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(source_bytes, sizeof(source_bytes));
+    ASSERT_IS_NOT_NULL(source);
+    CONSTBUFFER_HANDLE compressed = CONSTBUFFER_CreateCompressed(source);
+    ASSERT_IS_NOT_NULL(compressed);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, sizeof(source_bytes), 1))
+        .SetReturn(NULL);
+
+    ///act
+    CONSTBUFFER_HANDLE result = CONSTBUFFER_Decompress(compressed);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(compressed);
+    CONSTBUFFER_DecRef(source);
+}
+
+/*Tests_SRS_CONSTBUFFER_12_100: [ If there are any failures then CONSTBUFFER_Decompress shall fail and return NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_Decompress_with_stored_payload_when_malloc_fails_fails)
+{
+    ///arrange
+    unsigned char source_bytes[100];
+    fill_incompressible_bytes(source_bytes, sizeof(source_bytes));
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(source_bytes, sizeof(source_bytes));
+    ASSERT_IS_NOT_NULL(source);
+    CONSTBUFFER_HANDLE compressed = CONSTBUFFER_CreateCompressed(source);
+    ASSERT_IS_NOT_NULL(compressed);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG))
+        .SetReturn(NULL);
+
+    ///act
+    CONSTBUFFER_HANDLE result = CONSTBUFFER_Decompress(compressed);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(compressed);
+    CONSTBUFFER_DecRef(source);
+}
+
+/*CONSTBUFFER_CreateSharedHot*/
+
+/*Tests_SRS_CONSTBUFFER_12_102: [ If source is NULL then CONSTBUFFER_CreateSharedHot shall fail and return NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_CreateSharedHot_with_NULL_source_fails)
+{
+    ///act
+    CONSTBUFFER_HANDLE result = CONSTBUFFER_CreateSharedHot(NULL, 4);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_12_103: [ If slot_count is 0 or greater than CONSTBUFFER_SHARED_HOT_MAX_SLOT_COUNT then CONSTBUFFER_CreateSharedHot shall fail and return NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_CreateSharedHot_with_0_slot_count_fails)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(BUFFER1_u_char, BUFFER1_length);
+    ASSERT_IS_NOT_NULL(source);
+    umock_c_reset_all_calls();
+
+    ///act
+    CONSTBUFFER_HANDLE result = CONSTBUFFER_CreateSharedHot(source, 0);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(source);
+}
+
+/*Tests_SRS_CONSTBUFFER_12_103: [ If slot_count is 0 or greater than CONSTBUFFER_SHARED_HOT_MAX_SLOT_COUNT then CONSTBUFFER_CreateSharedHot shall fail and return NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_CreateSharedHot_with_too_many_slots_fails)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(BUFFER1_u_char, BUFFER1_length);
+    ASSERT_IS_NOT_NULL(source);
+    umock_c_reset_all_calls();
+
+    ///act
+    CONSTBUFFER_HANDLE result = CONSTBUFFER_CreateSharedHot(source, CONSTBUFFER_SHARED_HOT_MAX_SLOT_COUNT + 1);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(source);
+}
+
+/*Tests_SRS_CONSTBUFFER_12_104: [ CONSTBUFFER_CreateSharedHot shall allocate memory for the CONSTBUFFER_HANDLE and slot_count reference count slots, each in its own cache line. ]*/
+/*Tests_SRS_CONSTBUFFER_12_105: [ CONSTBUFFER_CreateSharedHot shall increment the reference count of source and produce a CONSTBUFFER_HANDLE with the same content as source (no bytes are copied), with the ref count set to 1. ]*/
+TEST_FUNCTION(CONSTBUFFER_CreateSharedHot_succeeds)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(BUFFER1_u_char, BUFFER1_length);
+    ASSERT_IS_NOT_NULL(source);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 4, IGNORED_ARG));
+
+    ///act
+    CONSTBUFFER_HANDLE result = CONSTBUFFER_CreateSharedHot(source, 4);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, CONSTBUFFER_GetContent(source)->buffer, CONSTBUFFER_GetContent(result)->buffer);
+    ASSERT_ARE_EQUAL(uint32_t, BUFFER1_length, CONSTBUFFER_GetContent(result)->size);
+
+    ///clean
+    CONSTBUFFER_DecRef(source);
+    CONSTBUFFER_DecRef(result);
+}
+
+/*Tests_SRS_CONSTBUFFER_12_106: [ If there are any failures then CONSTBUFFER_CreateSharedHot shall fail and return NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_CreateSharedHot_when_malloc_flex_fails_fails)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(BUFFER1_u_char, BUFFER1_length);
+    ASSERT_IS_NOT_NULL(source);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 4, IGNORED_ARG))
+        .SetReturn(NULL);
+
+    ///act
+    CONSTBUFFER_HANDLE result = CONSTBUFFER_CreateSharedHot(source, 4);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    CONSTBUFFER_DecRef(source);
+}
+
+/*Tests_SRS_CONSTBUFFER_12_107: [ If constbufferHandle was created by CONSTBUFFER_CreateSharedHot then CONSTBUFFER_IncRef shall increment the reference count in the slot picked by the id of the calling thread. ]*/
+/*Tests_SRS_CONSTBUFFER_12_108: [ If constbufferHandle was created by CONSTBUFFER_CreateSharedHot then CONSTBUFFER_DecRef shall decrement the reference count in the slot picked by the id of the calling thread if that slot is greater than 0, otherwise the reference count not held in slots. ]*/
+TEST_FUNCTION(CONSTBUFFER_IncRef_and_CONSTBUFFER_DecRef_on_a_shared_hot_handle_use_the_slot_of_the_calling_thread)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(BUFFER1_u_char, BUFFER1_length);
+    ASSERT_IS_NOT_NULL(source);
+    CONSTBUFFER_HANDLE shared_hot = CONSTBUFFER_CreateSharedHot(source, 4);
+    ASSERT_IS_NOT_NULL(shared_hot);
+    CONSTBUFFER_DecRef(source);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(ThreadAPI_GetCurrentId());
+    STRICT_EXPECTED_CALL(ThreadAPI_GetCurrentId());
+    STRICT_EXPECTED_CALL(ThreadAPI_GetCurrentId());
+    STRICT_EXPECTED_CALL(ThreadAPI_GetCurrentId());
+
+    ///act
+    CONSTBUFFER_IncRef(shared_hot);
+    CONSTBUFFER_IncRef(shared_hot);
+    CONSTBUFFER_DecRef(shared_hot);
+    CONSTBUFFER_DecRef(shared_hot);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, BUFFER1_length, CONSTBUFFER_GetContent(shared_hot)->size);
+
+    ///clean
+    CONSTBUFFER_DecRef(shared_hot);
+}
+
+/*Tests_SRS_CONSTBUFFER_12_108: [ If constbufferHandle was created by CONSTBUFFER_CreateSharedHot then CONSTBUFFER_DecRef shall decrement the reference count in the slot picked by the id of the calling thread if that slot is greater than 0, otherwise the reference count not held in slots. ]*/
+/*Tests_SRS_CONSTBUFFER_12_110: [ When the last reference of a handle created by CONSTBUFFER_CreateSharedHot is released, CONSTBUFFER_DecRef shall decrement the ref count of the source passed to CONSTBUFFER_CreateSharedHot. ]*/
+TEST_FUNCTION(CONSTBUFFER_DecRef_on_a_shared_hot_handle_releases_the_last_reference)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(BUFFER1_u_char, BUFFER1_length);
+    ASSERT_IS_NOT_NULL(source);
+    CONSTBUFFER_HANDLE shared_hot = CONSTBUFFER_CreateSharedHot(source, 4);
+    ASSERT_IS_NOT_NULL(shared_hot);
+    CONSTBUFFER_DecRef(source);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(ThreadAPI_GetCurrentId());
+    STRICT_EXPECTED_CALL(free(source));
+    STRICT_EXPECTED_CALL(free(shared_hot));
+
+    ///act
+    CONSTBUFFER_DecRef(shared_hot);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_12_109: [ When the reference count not held in slots reaches 0 for the first time, CONSTBUFFER_DecRef shall close the slots and add their reference counts to it. ]*/
+TEST_FUNCTION(CONSTBUFFER_DecRef_on_a_shared_hot_handle_merges_the_references_taken_by_other_threads)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(BUFFER1_u_char, BUFFER1_length);
+    ASSERT_IS_NOT_NULL(source);
+    CONSTBUFFER_HANDLE shared_hot = CONSTBUFFER_CreateSharedHot(source, 4);
+    ASSERT_IS_NOT_NULL(shared_hot);
+    CONSTBUFFER_DecRef(source);
+
+    /*thread 1 takes a reference (in its slot), thread 0 releases the reference that CONSTBUFFER_CreateSharedHot gave and then the one of thread 1*/
+    STRICT_EXPECTED_CALL(ThreadAPI_GetCurrentId())
+        .SetReturn(1);
+    CONSTBUFFER_IncRef(shared_hot);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(ThreadAPI_GetCurrentId())
+        .SetReturn(0);
+
+    ///act
+    CONSTBUFFER_DecRef(shared_hot);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, BUFFER1_length, CONSTBUFFER_GetContent(shared_hot)->size);
+
+    ///clean
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(ThreadAPI_GetCurrentId())
+        .SetReturn(0);
+    STRICT_EXPECTED_CALL(free(source));
+    STRICT_EXPECTED_CALL(free(shared_hot));
+    CONSTBUFFER_DecRef(shared_hot);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_CONSTBUFFER_12_107: [ If constbufferHandle was created by CONSTBUFFER_CreateSharedHot then CONSTBUFFER_IncRef shall increment the reference count in the slot picked by the id of the calling thread. ]*/
+TEST_FUNCTION(CONSTBUFFER_CreateFromOffsetAndSize_over_a_shared_hot_handle_keeps_it_alive)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE source = CONSTBUFFER_Create(BUFFER1_u_char, BUFFER1_length);
+    ASSERT_IS_NOT_NULL(source);
+    CONSTBUFFER_HANDLE shared_hot = CONSTBUFFER_CreateSharedHot(source, 4);
+    ASSERT_IS_NOT_NULL(shared_hot);
+    CONSTBUFFER_DecRef(source);
+    CONSTBUFFER_HANDLE view = CONSTBUFFER_CreateFromOffsetAndSize(shared_hot, 1, BUFFER1_length - 1);
+    ASSERT_IS_NOT_NULL(view);
+    CONSTBUFFER_DecRef(shared_hot);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(ThreadAPI_GetCurrentId());
+    STRICT_EXPECTED_CALL(free(source));
+    STRICT_EXPECTED_CALL(free(shared_hot));
+    STRICT_EXPECTED_CALL(free(view));
+
+    ///act
+    CONSTBUFFER_DecRef(view);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*CONSTBUFFER_CreateWritableHandle*/
+
+/*Tests_SRS_CONSTBUFFER_51_001: [ If size is 0, then CONSTBUFFER_CreateWritableHandle shall fail and return NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_CreateWritableHandle_invalid_args_fails)
+{
+    ///arrange
+
+    ///act
+    CONSTBUFFER_WRITABLE_HANDLE handle = CONSTBUFFER_CreateWritableHandle(0);
+
+    ///assert
+    ASSERT_IS_NULL(handle);
+
+    ///cleanup
+}
+
+/*Tests_SRS_CONSTBUFFER_51_003: [ If any error occurs, CONSTBUFFER_CreateWritableHandle shall fail and return NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_CreateWritableHandle_fails_when_malloc_fails)
+{
+    ///arrange
+    CONSTBUFFER_WRITABLE_HANDLE handle;
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, BUFFER1_length, 1))
+        .SetReturn(NULL);
+
+    ///act
+    handle = CONSTBUFFER_CreateWritableHandle(BUFFER1_length);
+
+    ///assert
+    ASSERT_IS_NULL(handle);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
 }
 
 /*Tests_SRS_CONSTBUFFER_51_004: [ CONSTBUFFER_CreateWritableHandle shall set the ref count of the newly created CONSTBUFFER_WRITABLE_HANDLE to 1. ]*/
 TEST_FUNCTION(CONSTBUFFER_CreateWritableHandle_is_ref_counted_1)
 {
     ///arrange
-    CONSTBUFFER_WRITABLE_HANDLE handle = CONSTBUFFER_CreateWritableHandle(BUFFER1_length);
-    umock_c_reset_all_calls();
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    CONSTBUFFER_WRITABLE_HANDLE handle = CONSTBUFFER_CreateWritableHandle(BUFFER1_length);
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    ///act
+    CONSTBUFFER_WritableHandleDecRef(handle);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+}
+
+/*Tests_SRS_CONSTBUFFER_51_002: [ CONSTBUFFER_CreateWritableHandle shall allocate memory for the CONSTBUFFER_WRITABLE_HANDLE ]*/
+/*Tests_SRS_CONSTBUFFER_51_005: [ CONSTBUFFER_CreateWritableHandle shall succeed and return a non-NULL CONSTBUFFER_WRITABLE_HANDLE. ]*/
+TEST_FUNCTION(CONSTBUFFER_CreateWritableHandle_succeeds)
+{
+    ///arrange
+    CONSTBUFFER_WRITABLE_HANDLE handle;
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, BUFFER1_length, 1));
+
+    ///act
+    handle = CONSTBUFFER_CreateWritableHandle(BUFFER1_length);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(handle);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    CONSTBUFFER_WritableHandleDecRef(handle);
+}
+
+/*CONSTBUFFER_getWritableBuffer*/
+
+/*Tests_SRS_CONSTBUFFER_51_006: [ If constbufferWritableHandle is NULL, then CONSTBUFFER_GetWritableBuffer shall fail and return NULL. ] */
+TEST_FUNCTION(CONSTBUFFER_GetWritableBuffer_invalid_args_fails)
+{
+    ///arrange
+    unsigned char* buffer;
+
+    ///act
+    buffer = CONSTBUFFER_GetWritableBuffer(NULL);
+
+    ///assert
+    ASSERT_IS_NULL(buffer);
+
+    ///cleanup
+}
+
+/*Tests_SRS_CONSTBUFFER_51_007: [ CONSTBUFFER_GetWritableBuffer shall succeed and returns a pointer to the non-CONST buffer of constbufferWritableHandle. ]*/
+TEST_FUNCTION(CONSTBUFFER_GetWritableBuffer_succeeds)
+{
+    ///arrange
+    CONSTBUFFER_WRITABLE_HANDLE constbufferWritableHandle;
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, BUFFER1_length, 1));
+
+    ///act
+    constbufferWritableHandle = CONSTBUFFER_CreateWritableHandle(BUFFER1_length); 
+    unsigned char* buffer = CONSTBUFFER_GetWritableBuffer(constbufferWritableHandle);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(buffer);   
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    CONSTBUFFER_WritableHandleDecRef(constbufferWritableHandle);
+}
+
+/*CONSTBUFFER_sealWritableHandle*/
+
+/*Tests_SRS_CONSTBUFFER_51_008: [ If constbufferWritableHandle is NULL then CONSTBUFFER_SealWritableHandle shall fail and return NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_SealWritableHandle_invalid_args_fails)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE handle;
+
+    ///act
+    handle = CONSTBUFFER_SealWritableHandle(NULL);
+
+    ///assert
+    ASSERT_IS_NULL(handle);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+}
+
+/*Tests_SRS_CONSTBUFFER_51_009: [CONSTBUFFER_SealWritableHandle shall succeed and return a non-NULL CONSTBUFFER_HANDLE.]*/
+TEST_FUNCTION(CONSTBUFFER_SealWritableHandle_succeeds)
+{
+    ///arrange
+    CONSTBUFFER_WRITABLE_HANDLE constbufferWritableHandle;
+    CONSTBUFFER_HANDLE handle;
+    uint32_t writableBufferSize;
+    unsigned char* writableBuffer;  
+    const CONSTBUFFER * content;
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, BUFFER1_length, 1));
+       
+    ///act
+    constbufferWritableHandle = CONSTBUFFER_CreateWritableHandle(BUFFER1_length);
+    writableBufferSize = CONSTBUFFER_GetWritableBufferSize(constbufferWritableHandle);
+    writableBuffer = CONSTBUFFER_GetWritableBuffer(constbufferWritableHandle);
+
+    /*filling data*/
+    (void)memcpy(writableBuffer, buffer1, writableBufferSize);
+
+    /*sealing*/
+    handle = CONSTBUFFER_SealWritableHandle(constbufferWritableHandle);
+    content = CONSTBUFFER_GetContent(handle);
+    
+    ///assert
+    ASSERT_IS_NOT_NULL(content);
+    ASSERT_ARE_EQUAL(uint32_t, content->size, writableBufferSize);
+    /*content*/
+    ASSERT_IS_TRUE(memcmp(buffer1, content->buffer, content->size) == 0);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    CONSTBUFFER_DecRef(handle);
+}
+
+/*CONSTBUFFER_WritableHandleIncRef*/
+
+/*Tests_SRS_CONSTBUFFER_51_010: [ If constbufferWritableHandle is NULL then CONSTBUFFER_WritableHandleIncRef shall return. ]*/
+TEST_FUNCTION(CONSTBUFFER_WritableHandleIncRef_invalid_args_fails)
+{
+    ///arrange
+
+    ///act
+    CONSTBUFFER_WritableHandleIncRef(NULL);
+
+    ///assert
+   
+    ///cleanup
+}
+
+/*Tests_SRS_CONSTBUFFER_51_011: [ Otherwise, CONSTBUFFER_WritableHandleIncRef shall increment the reference count of constbufferWritableHandle ]*/
+TEST_FUNCTION(CONSTBUFFER_WritableHandleIncRef_succeeds)
+{
+    ///arrange
+    CONSTBUFFER_WRITABLE_HANDLE handle = CONSTBUFFER_CreateWritableHandle(BUFFER1_length);
+    umock_c_reset_all_calls();
+
+    ///act
+    CONSTBUFFER_WritableHandleIncRef(handle);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    CONSTBUFFER_WritableHandleDecRef(handle);
+    CONSTBUFFER_WritableHandleDecRef(handle);
+}
+
+/*CONSTBUFFER_WritableHandleDecRef*/
+
+/*Tests_SRS_CONSTBUFFER_51_012: [ If constbufferWritableHandle is NULL then CONSTBUFFER_WritableHandleDecRef shall do nothing. ]*/
+TEST_FUNCTION(CONSTBUFFER_WritableHandleDecReff_invalid_args_fails)
+{
+    ///arrange
+
+    ///act
+    CONSTBUFFER_WritableHandleDecRef(NULL);
+
+    ///assert
+
+    ///cleanup
+}
+
+/*Tests_SRS_CONSTBUFFER_51_013: [ Otherwise, CONSTBUFFER_WritableHandleDecRef shall decrement the refcount of constbufferWritableHandle. ]*/
+/*Tests_SRS_CONSTBUFFER_51_014: [ If the refcount reaches zero, then CONSTBUFFER_WritableHandleDecRef shall deallocate all resources used by the CONSTBUFFER_HANDLE. ]*/
+TEST_FUNCTION(CONSTBUFFER_WritableHandleDecReff_succeeds)
+{
+    ///arrange
+    CONSTBUFFER_WRITABLE_HANDLE handle = CONSTBUFFER_CreateWritableHandle(BUFFER1_length);
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    ///act
+    CONSTBUFFER_WritableHandleDecRef(handle);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+}
+
+/*CONSTBUFFER_getWritableBufferSize*/
+
+/*Tests_SRS_CONSTBUFFER_51_015: [ If constbufferWritableHandle is NULL, then CONSTBUFFER_GetWritableBufferSize return 0. ] */
+TEST_FUNCTION(CONSTBUFFER_GetWritableBufferSize_invalid_args_fails)
+{
+    ///arrange
+    uint32_t bufferSize;
+
+    ///act
+    bufferSize = CONSTBUFFER_GetWritableBufferSize(NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(uint32_t, bufferSize, 0);
+
+    ///cleanup
+}
+
+/*Tests_SRS_CONSTBUFFER_51_016: [ CONSTBUFFER_GetWritableBufferSize shall succeed and returns the size of the writable buffer of constbufferWritableHandle. ]*/
+TEST_FUNCTION(CONSTBUFFER_GetWritableBufferSize_succeeds)
+{
+    ///arrange
+    CONSTBUFFER_WRITABLE_HANDLE constbufferWritableHandle;
+    uint32_t bufferSize;
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, BUFFER1_length, 1));
+
+    ///act
+    constbufferWritableHandle = CONSTBUFFER_CreateWritableHandle(BUFFER1_length);
+
+
+    bufferSize = CONSTBUFFER_GetWritableBufferSize(constbufferWritableHandle);
+
+    ///assert
+    ASSERT_ARE_EQUAL(uint32_t, bufferSize, BUFFER1_length);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    CONSTBUFFER_WritableHandleDecRef(constbufferWritableHandle);
+}
+
+/*CONSTBUFFER_POOL_Create*/
+
+/*Tests_SRS_CONSTBUFFER_12_001: [ If max_buffer_size is 0 or greater than 2^31 then CONSTBUFFER_POOL_Create shall fail and return NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_POOL_Create_with_max_buffer_size_0_fails)
+{
+    ///arrange
+
+    ///act
+    CONSTBUFFER_POOL_HANDLE pool = CONSTBUFFER_POOL_Create(0, 4);
+
+    ///assert
+    ASSERT_IS_NULL(pool);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+}
+
+/*Tests_SRS_CONSTBUFFER_12_001: [ If max_buffer_size is 0 or greater than 2^31 then CONSTBUFFER_POOL_Create shall fail and return NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_POOL_Create_with_max_buffer_size_too_big_fails)
+{
+    ///arrange
+
+    ///act
+    CONSTBUFFER_POOL_HANDLE pool = CONSTBUFFER_POOL_Create(((uint32_t)1 << 31) + 1, 4);
+
+    ///assert
+    ASSERT_IS_NULL(pool);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+}
+
+/*Tests_SRS_CONSTBUFFER_12_002: [ If max_retained_per_class is 0 then CONSTBUFFER_POOL_Create shall fail and return NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_POOL_Create_with_max_retained_per_class_0_fails)
+{
+    ///arrange
 
     ///act
-    CONSTBUFFER_WritableHandleDecRef(handle);
+    CONSTBUFFER_POOL_HANDLE pool = CONSTBUFFER_POOL_Create(1024, 0);
 
     ///assert
+    ASSERT_IS_NULL(pool);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
     ///cleanup
 }
 
-/*Tests_SRS_CONSTBUFFER_51_002: [ CONSTBUFFER_CreateWritableHandle shall allocate memory for the CONSTBUFFER_WRITABLE_HANDLE ]*/
-/*Tests_SRS_CONSTBUFFER_51_005: [ CONSTBUFFER_CreateWritableHandle shall succeed and return a non-NULL CONSTBUFFER_WRITABLE_HANDLE. ]*/
-TEST_FUNCTION(CONSTBUFFER_CreateWritableHandle_succeeds)
+/*Tests_SRS_CONSTBUFFER_12_003: [ CONSTBUFFER_POOL_Create shall compute the number of power of 2 size classes needed to cover sizes from 64 bytes up to max_buffer_size. ]*/
+/*Tests_SRS_CONSTBUFFER_12_004: [ CONSTBUFFER_POOL_Create shall allocate memory for the pool and for max_retained_per_class slots for every size class. ]*/
+/*Tests_SRS_CONSTBUFFER_12_005: [ CONSTBUFFER_POOL_Create shall set all slots to empty, all statistics to 0 and succeed and return a non-NULL value. ]*/
+TEST_FUNCTION(CONSTBUFFER_POOL_Create_succeeds)
 {
     ///arrange
-    CONSTBUFFER_WRITABLE_HANDLE handle;
-    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, BUFFER1_length, 1));
+    CONSTBUFFER_POOL_STATISTICS statistics;
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 5 * 4, IGNORED_ARG)); /*64, 128, 256, 512 and 1024 bytes classes*/
 
     ///act
-    handle = CONSTBUFFER_CreateWritableHandle(BUFFER1_length);
+    CONSTBUFFER_POOL_HANDLE pool = CONSTBUFFER_POOL_Create(1000, 4);
 
     ///assert
-    ASSERT_IS_NOT_NULL(handle);
+    ASSERT_IS_NOT_NULL(pool);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, CONSTBUFFER_POOL_GetStatistics(pool, &statistics));
+    ASSERT_ARE_EQUAL(uint64_t, 0, statistics.hits);
+    ASSERT_ARE_EQUAL(uint64_t, 0, statistics.misses);
+    ASSERT_ARE_EQUAL(uint64_t, 0, statistics.retained_buffers);
+    ASSERT_ARE_EQUAL(uint64_t, 0, statistics.retained_bytes);
 
     ///cleanup
-    CONSTBUFFER_WritableHandleDecRef(handle);
+    CONSTBUFFER_POOL_Destroy(pool);
 }
 
-/*CONSTBUFFER_getWritableBuffer*/
-
-/*Tests_SRS_CONSTBUFFER_51_006: [ If constbufferWritableHandle is NULL, then CONSTBUFFER_GetWritableBuffer shall fail and return NULL. ] */
-TEST_FUNCTION(CONSTBUFFER_GetWritableBuffer_invalid_args_fails)
+/*Tests_SRS_CONSTBUFFER_12_006: [ If there are any failures then CONSTBUFFER_POOL_Create shall fail and return NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_POOL_Create_fails_when_malloc_flex_fails)
 {
     ///arrange
-    unsigned char* buffer;
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 1 * 4, IGNORED_ARG))
+        .SetReturn(NULL);
 
     ///act
-    buffer = CONSTBUFFER_GetWritableBuffer(NULL);
+    CONSTBUFFER_POOL_HANDLE pool = CONSTBUFFER_POOL_Create(64, 4);
 
     ///assert
-    ASSERT_IS_NULL(buffer);
+    ASSERT_IS_NULL(pool);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
     ///cleanup
 }
 
-/*Tests_SRS_CONSTBUFFER_51_007: [ CONSTBUFFER_GetWritableBuffer shall succeed and returns a pointer to the non-CONST buffer of constbufferWritableHandle. ]*/
-TEST_FUNCTION(CONSTBUFFER_GetWritableBuffer_succeeds)
+/*Tests_SRS_CONSTBUFFER_12_006: [ If there are any failures then CONSTBUFFER_POOL_Create shall fail and return NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_POOL_Create_with_too_many_slots_fails)
 {
     ///arrange
-    CONSTBUFFER_WRITABLE_HANDLE constbufferWritableHandle;
-    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, BUFFER1_length, 1));
 
     ///act
-    constbufferWritableHandle = CONSTBUFFER_CreateWritableHandle(BUFFER1_length); 
-    unsigned char* buffer = CONSTBUFFER_GetWritableBuffer(constbufferWritableHandle);
+    CONSTBUFFER_POOL_HANDLE pool = CONSTBUFFER_POOL_Create((uint32_t)1 << 31, UINT32_MAX);
 
     ///assert
-    ASSERT_IS_NOT_NULL(buffer);   
+    ASSERT_IS_NULL(pool);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
     ///cleanup
-    CONSTBUFFER_WritableHandleDecRef(constbufferWritableHandle);
 }
 
-/*CONSTBUFFER_sealWritableHandle*/
+/*CONSTBUFFER_POOL_Destroy*/
 
-/*Tests_SRS_CONSTBUFFER_51_008: [ If constbufferWritableHandle is NULL then CONSTBUFFER_SealWritableHandle shall fail and return NULL. ]*/
-TEST_FUNCTION(CONSTBUFFER_SealWritableHandle_invalid_args_fails)
+/*Tests_SRS_CONSTBUFFER_12_007: [ If pool is NULL then CONSTBUFFER_POOL_Destroy shall return. ]*/
+TEST_FUNCTION(CONSTBUFFER_POOL_Destroy_with_NULL_pool_returns)
 {
     ///arrange
-    CONSTBUFFER_HANDLE handle;
 
     ///act
-    handle = CONSTBUFFER_SealWritableHandle(NULL);
+    CONSTBUFFER_POOL_Destroy(NULL);
 
     ///assert
-    ASSERT_IS_NULL(handle);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
     ///cleanup
 }
 
-/*Tests_SRS_CONSTBUFFER_51_009: [CONSTBUFFER_SealWritableHandle shall succeed and return a non-NULL CONSTBUFFER_HANDLE.]*/
-TEST_FUNCTION(CONSTBUFFER_SealWritableHandle_succeeds)
+/*Tests_SRS_CONSTBUFFER_12_009: [ CONSTBUFFER_POOL_Destroy shall free all the retained buffers. ]*/
+/*Tests_SRS_CONSTBUFFER_12_010: [ CONSTBUFFER_POOL_Destroy shall release the reference of the owner. The pool memory shall be freed when all the buffers created from it have been released. ]*/
+TEST_FUNCTION(CONSTBUFFER_POOL_Destroy_frees_retained_buffers_and_the_pool)
 {
     ///arrange
-    CONSTBUFFER_WRITABLE_HANDLE constbufferWritableHandle;
-    CONSTBUFFER_HANDLE handle;
-    uint32_t writableBufferSize;
-    unsigned char* writableBuffer;  
-    const CONSTBUFFER * content;
-    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, BUFFER1_length, 1));
-       
+    CONSTBUFFER_POOL_HANDLE pool = CONSTBUFFER_POOL_Create(1024, 4);
+    ASSERT_IS_NOT_NULL(pool);
+    CONSTBUFFER_WRITABLE_HANDLE handle = CONSTBUFFER_POOL_CreateWritableHandle(pool, 100);
+    ASSERT_IS_NOT_NULL(handle);
+    CONSTBUFFER_WritableHandleDecRef(handle);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(free(handle));
+    STRICT_EXPECTED_CALL(free(pool));
+
     ///act
-    constbufferWritableHandle = CONSTBUFFER_CreateWritableHandle(BUFFER1_length);
-    writableBufferSize = CONSTBUFFER_GetWritableBufferSize(constbufferWritableHandle);
-    writableBuffer = CONSTBUFFER_GetWritableBuffer(constbufferWritableHandle);
+    CONSTBUFFER_POOL_Destroy(pool);
 
-    /*filling data*/
-    (void)memcpy(writableBuffer, buffer1, writableBufferSize);
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+}
+
+/*Tests_SRS_CONSTBUFFER_12_008: [ CONSTBUFFER_POOL_Destroy shall mark the pool as destroyed so that buffers returned afterwards are freed instead of retained. ]*/
+/*Tests_SRS_CONSTBUFFER_12_010: [ CONSTBUFFER_POOL_Destroy shall release the reference of the owner. The pool memory shall be freed when all the buffers created from it have been released. ]*/
+TEST_FUNCTION(CONSTBUFFER_POOL_Destroy_with_buffer_in_use_frees_the_pool_when_the_buffer_is_released)
+{
+    ///arrange
+    CONSTBUFFER_POOL_HANDLE pool = CONSTBUFFER_POOL_Create(1024, 4);
+    ASSERT_IS_NOT_NULL(pool);
+    CONSTBUFFER_HANDLE handle = CONSTBUFFER_SealWritableHandle(CONSTBUFFER_POOL_CreateWritableHandle(pool, 100));
+    ASSERT_IS_NOT_NULL(handle);
+    umock_c_reset_all_calls();
+
+    ///act
+    CONSTBUFFER_POOL_Destroy(pool);
 
-    /*sealing*/
-    handle = CONSTBUFFER_SealWritableHandle(constbufferWritableHandle);
-    content = CONSTBUFFER_GetContent(handle);
-    
     ///assert
-    ASSERT_IS_NOT_NULL(content);
-    ASSERT_ARE_EQUAL(uint32_t, content->size, writableBufferSize);
-    /*content*/
-    ASSERT_IS_TRUE(memcmp(buffer1, content->buffer, content->size) == 0);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
     ///cleanup
+    STRICT_EXPECTED_CALL(free(handle));
+    STRICT_EXPECTED_CALL(free(pool));
     CONSTBUFFER_DecRef(handle);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
 
-/*CONSTBUFFER_WritableHandleIncRef*/
+/*CONSTBUFFER_POOL_CreateWritableHandle*/
 
-/*Tests_SRS_CONSTBUFFER_51_010: [ If constbufferWritableHandle is NULL then CONSTBUFFER_WritableHandleIncRef shall return. ]*/
-TEST_FUNCTION(CONSTBUFFER_WritableHandleIncRef_invalid_args_fails)
+/*Tests_SRS_CONSTBUFFER_12_011: [ If pool is NULL then CONSTBUFFER_POOL_CreateWritableHandle shall fail and return NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_POOL_CreateWritableHandle_with_NULL_pool_fails)
 {
     ///arrange
 
     ///act
-    CONSTBUFFER_WritableHandleIncRef(NULL);
+    CONSTBUFFER_WRITABLE_HANDLE handle = CONSTBUFFER_POOL_CreateWritableHandle(NULL, 100);
 
     ///assert
-   
+    ASSERT_IS_NULL(handle);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
     ///cleanup
 }
 
-/*Tests_SRS_CONSTBUFFER_51_011: [ Otherwise, CONSTBUFFER_WritableHandleIncRef shall increment the reference count of constbufferWritableHandle ]*/
-TEST_FUNCTION(CONSTBUFFER_WritableHandleIncRef_succeeds)
+/*Tests_SRS_CONSTBUFFER_12_012: [ If size is 0 then CONSTBUFFER_POOL_CreateWritableHandle shall fail and return NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_POOL_CreateWritableHandle_with_size_0_fails)
 {
     ///arrange
-    CONSTBUFFER_WRITABLE_HANDLE handle = CONSTBUFFER_CreateWritableHandle(BUFFER1_length);
+    CONSTBUFFER_POOL_HANDLE pool = CONSTBUFFER_POOL_Create(1024, 4);
+    ASSERT_IS_NOT_NULL(pool);
     umock_c_reset_all_calls();
 
     ///act
-    CONSTBUFFER_WritableHandleIncRef(handle);
+    CONSTBUFFER_WRITABLE_HANDLE handle = CONSTBUFFER_POOL_CreateWritableHandle(pool, 0);
+
+    ///assert
+    ASSERT_IS_NULL(handle);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    CONSTBUFFER_POOL_Destroy(pool);
+}
+
+/*Tests_SRS_CONSTBUFFER_12_014: [ CONSTBUFFER_POOL_CreateWritableHandle shall compute the size class as the smallest power of 2 that is at least 64 and at least size. ]*/
+/*Tests_SRS_CONSTBUFFER_12_017: [ Otherwise CONSTBUFFER_POOL_CreateWritableHandle shall count a miss and allocate memory for a buffer of the size class. ]*/
+/*Tests_SRS_CONSTBUFFER_12_018: [ CONSTBUFFER_POOL_CreateWritableHandle shall take a reference on the pool, set the ref count of the writable handle to 1, set its size to size and succeed and return a non-NULL value. ]*/
+TEST_FUNCTION(CONSTBUFFER_POOL_CreateWritableHandle_allocates_the_size_class)
+{
+    ///arrange
+    CONSTBUFFER_POOL_STATISTICS statistics;
+    CONSTBUFFER_POOL_HANDLE pool = CONSTBUFFER_POOL_Create(1024, 4);
+    ASSERT_IS_NOT_NULL(pool);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 128, 1));
+
+    ///act
+    CONSTBUFFER_WRITABLE_HANDLE handle = CONSTBUFFER_POOL_CreateWritableHandle(pool, 100);
 
     ///assert
+    ASSERT_IS_NOT_NULL(handle);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 100, CONSTBUFFER_GetWritableBufferSize(handle));
+    ASSERT_IS_NOT_NULL(CONSTBUFFER_GetWritableBuffer(handle));
+    ASSERT_ARE_EQUAL(int, 0, CONSTBUFFER_POOL_GetStatistics(pool, &statistics));
+    ASSERT_ARE_EQUAL(uint64_t, 0, statistics.hits);
+    ASSERT_ARE_EQUAL(uint64_t, 1, statistics.misses);
 
     ///cleanup
     CONSTBUFFER_WritableHandleDecRef(handle);
+    CONSTBUFFER_POOL_Destroy(pool);
+}
+
+/*Tests_SRS_CONSTBUFFER_12_014: [ CONSTBUFFER_POOL_CreateWritableHandle shall compute the size class as the smallest power of 2 that is at least 64 and at least size. ]*/
+TEST_FUNCTION(CONSTBUFFER_POOL_CreateWritableHandle_with_small_size_allocates_64_bytes)
+{
+    ///arrange
+    CONSTBUFFER_POOL_HANDLE pool = CONSTBUFFER_POOL_Create(1024, 4);
+    ASSERT_IS_NOT_NULL(pool);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 64, 1));
+
+    ///act
+    CONSTBUFFER_WRITABLE_HANDLE handle = CONSTBUFFER_POOL_CreateWritableHandle(pool, 1);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(handle);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 1, CONSTBUFFER_GetWritableBufferSize(handle));
+
+    ///cleanup
     CONSTBUFFER_WritableHandleDecRef(handle);
+    CONSTBUFFER_POOL_Destroy(pool);
 }
 
-/*CONSTBUFFER_WritableHandleDecRef*/
+/*Tests_SRS_CONSTBUFFER_12_013: [ If size is greater than the biggest size class of the pool then CONSTBUFFER_POOL_CreateWritableHandle shall count a miss and return the result of CONSTBUFFER_CreateWritableHandle(size). ]*/
+TEST_FUNCTION(CONSTBUFFER_POOL_CreateWritableHandle_with_size_bigger_than_the_biggest_class_is_not_pooled)
+{
+    ///arrange
+    CONSTBUFFER_POOL_STATISTICS statistics;
+    CONSTBUFFER_POOL_HANDLE pool = CONSTBUFFER_POOL_Create(1024, 4);
+    ASSERT_IS_NOT_NULL(pool);
+    umock_c_reset_all_calls();
 
-/*Tests_SRS_CONSTBUFFER_51_012: [ If constbufferWritableHandle is NULL then CONSTBUFFER_WritableHandleDecRef shall do nothing. ]*/
-TEST_FUNCTION(CONSTBUFFER_WritableHandleDecReff_invalid_args_fails)
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 1025, 1));
+
+    ///act
+    CONSTBUFFER_WRITABLE_HANDLE handle = CONSTBUFFER_POOL_CreateWritableHandle(pool, 1025);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(handle);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, CONSTBUFFER_POOL_GetStatistics(pool, &statistics));
+    ASSERT_ARE_EQUAL(uint64_t, 1, statistics.misses);
+
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(free(handle));
+    CONSTBUFFER_WritableHandleDecRef(handle);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, CONSTBUFFER_POOL_GetStatistics(pool, &statistics));
+    ASSERT_ARE_EQUAL(uint64_t, 0, statistics.retained_buffers);
+
+    ///cleanup
+    CONSTBUFFER_POOL_Destroy(pool);
+}
+
+/*Tests_SRS_CONSTBUFFER_12_019: [ If there are any failures then CONSTBUFFER_POOL_CreateWritableHandle shall fail and return NULL. ]*/
+TEST_FUNCTION(CONSTBUFFER_POOL_CreateWritableHandle_fails_when_malloc_flex_fails)
 {
     ///arrange
+    CONSTBUFFER_POOL_HANDLE pool = CONSTBUFFER_POOL_Create(1024, 4);
+    ASSERT_IS_NOT_NULL(pool);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, 128, 1))
+        .SetReturn(NULL);
 
     ///act
-    CONSTBUFFER_WritableHandleDecRef(NULL);
+    CONSTBUFFER_WRITABLE_HANDLE handle = CONSTBUFFER_POOL_CreateWritableHandle(pool, 100);
 
     ///assert
+    ASSERT_IS_NULL(handle);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
     ///cleanup
+    STRICT_EXPECTED_CALL(free(pool)); /*no buffer holds a reference on the pool*/
+    CONSTBUFFER_POOL_Destroy(pool);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
 
-/*Tests_SRS_CONSTBUFFER_51_013: [ Otherwise, CONSTBUFFER_WritableHandleDecRef shall decrement the refcount of constbufferWritableHandle. ]*/
-/*Tests_SRS_CONSTBUFFER_51_014: [ If the refcount reaches zero, then CONSTBUFFER_WritableHandleDecRef shall deallocate all resources used by the CONSTBUFFER_HANDLE. ]*/
-TEST_FUNCTION(CONSTBUFFER_WritableHandleDecReff_succeeds)
+/*Tests_SRS_CONSTBUFFER_12_015: [ CONSTBUFFER_POOL_CreateWritableHandle shall take a retained buffer from the slots of the size class, if any. ]*/
+/*Tests_SRS_CONSTBUFFER_12_016: [ If a retained buffer is found then CONSTBUFFER_POOL_CreateWritableHandle shall count a hit. ]*/
+/*Tests_SRS_CONSTBUFFER_12_023: [ If the refcount of a buffer created by CONSTBUFFER_POOL_CreateWritableHandle reaches zero and the pool has a free slot in the buffer's size class, then the buffer shall be stored in the slot instead of being freed. ]*/
+TEST_FUNCTION(CONSTBUFFER_POOL_CreateWritableHandle_reuses_a_retained_buffer)
 {
     ///arrange
-    CONSTBUFFER_WRITABLE_HANDLE handle = CONSTBUFFER_CreateWritableHandle(BUFFER1_length);
+    CONSTBUFFER_POOL_STATISTICS statistics;
+    CONSTBUFFER_POOL_HANDLE pool = CONSTBUFFER_POOL_Create(1024, 4);
+    ASSERT_IS_NOT_NULL(pool);
+    CONSTBUFFER_WRITABLE_HANDLE first = CONSTBUFFER_POOL_CreateWritableHandle(pool, 100);
+    ASSERT_IS_NOT_NULL(first);
     umock_c_reset_all_calls();
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    CONSTBUFFER_WritableHandleDecRef(first);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls()); /*no free*/
 
     ///act
-    CONSTBUFFER_WritableHandleDecRef(handle);
+    CONSTBUFFER_WRITABLE_HANDLE second = CONSTBUFFER_POOL_CreateWritableHandle(pool, 120);
+
+    ///assert
+    ASSERT_ARE_EQUAL(void_ptr, first, second);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls()); /*no malloc*/
+    ASSERT_ARE_EQUAL(uint32_t, 120, CONSTBUFFER_GetWritableBufferSize(second));
+    ASSERT_ARE_EQUAL(int, 0, CONSTBUFFER_POOL_GetStatistics(pool, &statistics));
+    ASSERT_ARE_EQUAL(uint64_t, 1, statistics.hits);
+    ASSERT_ARE_EQUAL(uint64_t, 1, statistics.misses);
+    ASSERT_ARE_EQUAL(uint64_t, 0, statistics.retained_buffers);
+    ASSERT_ARE_EQUAL(uint64_t, 0, statistics.retained_bytes);
+
+    ///cleanup
+    CONSTBUFFER_WritableHandleDecRef(second);
+    CONSTBUFFER_POOL_Destroy(pool);
+}
+
+/*Tests_SRS_CONSTBUFFER_12_015: [ CONSTBUFFER_POOL_CreateWritableHandle shall take a retained buffer from the slots of the size class, if any. ]*/
+/*Tests_SRS_CONSTBUFFER_12_023: [ If the refcount of a buffer created by CONSTBUFFER_POOL_CreateWritableHandle reaches zero and the pool has a free slot in the buffer's size class, then the buffer shall be stored in the slot instead of being freed. ]*/
+/*Tests_SRS_CONSTBUFFER_12_024: [ Otherwise the buffer shall be freed. ]*/
+TEST_FUNCTION(CONSTBUFFER_POOL_slots_are_reused_after_the_retained_buffers_are_taken)
+{
+    ///arrange
+    CONSTBUFFER_POOL_STATISTICS statistics;
+    CONSTBUFFER_POOL_HANDLE pool = CONSTBUFFER_POOL_Create(1024, 3);
+    ASSERT_IS_NOT_NULL(pool);
+    CONSTBUFFER_WRITABLE_HANDLE handles[4];
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        handles[i] = CONSTBUFFER_POOL_CreateWritableHandle(pool, 100);
+        ASSERT_IS_NOT_NULL(handles[i]);
+    }
+    CONSTBUFFER_WritableHandleDecRef(handles[0]);
+    CONSTBUFFER_WritableHandleDecRef(handles[1]);
+    CONSTBUFFER_WritableHandleDecRef(handles[2]);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(free(handles[3])); /*the 3 slots of the size class are full*/
+
+    ///act
+    CONSTBUFFER_WritableHandleDecRef(handles[3]);
+    CONSTBUFFER_WRITABLE_HANDLE taken_1 = CONSTBUFFER_POOL_CreateWritableHandle(pool, 100);
+    CONSTBUFFER_WRITABLE_HANDLE taken_2 = CONSTBUFFER_POOL_CreateWritableHandle(pool, 100);
+    CONSTBUFFER_WRITABLE_HANDLE taken_3 = CONSTBUFFER_POOL_CreateWritableHandle(pool, 100);
+    CONSTBUFFER_WritableHandleDecRef(taken_3);
+    CONSTBUFFER_WritableHandleDecRef(taken_2);
+    CONSTBUFFER_WritableHandleDecRef(taken_1);
 
     ///assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    /*the last buffer returned is the first one taken (it is the most likely to be in the cache)*/
+    ASSERT_ARE_EQUAL(void_ptr, handles[2], taken_1);
+    ASSERT_ARE_EQUAL(void_ptr, handles[1], taken_2);
+    ASSERT_ARE_EQUAL(void_ptr, handles[0], taken_3);
+    /*the slots freed by the takes hold the buffers again*/
+    ASSERT_ARE_EQUAL(int, 0, CONSTBUFFER_POOL_GetStatistics(pool, &statistics));
+    ASSERT_ARE_EQUAL(uint64_t, 3, statistics.hits);
+    ASSERT_ARE_EQUAL(uint64_t, 4, statistics.misses);
+    ASSERT_ARE_EQUAL(uint64_t, 3, statistics.retained_buffers);
+    ASSERT_ARE_EQUAL(uint64_t, 3 * 128, statistics.retained_bytes);
 
     ///cleanup
+    CONSTBUFFER_POOL_Destroy(pool);
 }
 
-/*CONSTBUFFER_getWritableBufferSize*/
+/*Tests_SRS_CONSTBUFFER_12_023: [ If the refcount of a buffer created by CONSTBUFFER_POOL_CreateWritableHandle reaches zero and the pool has a free slot in the buffer's size class, then the buffer shall be stored in the slot instead of being freed. ]*/
+/*Tests_SRS_CONSTBUFFER_12_025: [ The reference that the buffer holds on the pool shall be released. ]*/
+TEST_FUNCTION(CONSTBUFFER_DecRef_of_a_sealed_pooled_buffer_retains_it)
+{
+    ///arrange
+    CONSTBUFFER_POOL_STATISTICS statistics;
+    CONSTBUFFER_POOL_HANDLE pool = CONSTBUFFER_POOL_Create(1024, 4);
+    ASSERT_IS_NOT_NULL(pool);
+    CONSTBUFFER_WRITABLE_HANDLE writable = CONSTBUFFER_POOL_CreateWritableHandle(pool, BUFFER1_length);
+    ASSERT_IS_NOT_NULL(writable);
+    (void)memcpy(CONSTBUFFER_GetWritableBuffer(writable), buffer1, BUFFER1_length);
+    CONSTBUFFER_HANDLE handle = CONSTBUFFER_SealWritableHandle(writable);
+    const CONSTBUFFER* content = CONSTBUFFER_GetContent(handle);
+    ASSERT_ARE_EQUAL(uint32_t, BUFFER1_length, content->size);
+    ASSERT_IS_TRUE(memcmp(buffer1, content->buffer, content->size) == 0);
+    umock_c_reset_all_calls();
 
-/*Tests_SRS_CONSTBUFFER_51_015: [ If constbufferWritableHandle is NULL, then CONSTBUFFER_GetWritableBufferSize return 0. ] */
-TEST_FUNCTION(CONSTBUFFER_GetWritableBufferSize_invalid_args_fails)
+    ///act
+    CONSTBUFFER_DecRef(handle);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, CONSTBUFFER_POOL_GetStatistics(pool, &statistics));
+    ASSERT_ARE_EQUAL(uint64_t, 1, statistics.retained_buffers);
+    ASSERT_ARE_EQUAL(uint64_t, 64, statistics.retained_bytes);
+
+    ///cleanup
+    CONSTBUFFER_POOL_Destroy(pool);
+}
+
+/*Tests_SRS_CONSTBUFFER_12_024: [ Otherwise the buffer shall be freed. ]*/
+TEST_FUNCTION(CONSTBUFFER_WritableHandleDecRef_frees_a_pooled_buffer_when_the_size_class_is_full)
 {
     ///arrange
-    uint32_t bufferSize;
+    CONSTBUFFER_POOL_STATISTICS statistics;
+    CONSTBUFFER_POOL_HANDLE pool = CONSTBUFFER_POOL_Create(1024, 1);
+    ASSERT_IS_NOT_NULL(pool);
+    CONSTBUFFER_WRITABLE_HANDLE first = CONSTBUFFER_POOL_CreateWritableHandle(pool, 100);
+    ASSERT_IS_NOT_NULL(first);
+    CONSTBUFFER_WRITABLE_HANDLE second = CONSTBUFFER_POOL_CreateWritableHandle(pool, 100);
+    ASSERT_IS_NOT_NULL(second);
+    CONSTBUFFER_WritableHandleDecRef(first);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(free(second));
 
     ///act
-    bufferSize = CONSTBUFFER_GetWritableBufferSize(NULL);
+    CONSTBUFFER_WritableHandleDecRef(second);
 
     ///assert
-    ASSERT_ARE_EQUAL(uint32_t, bufferSize, 0);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, CONSTBUFFER_POOL_GetStatistics(pool, &statistics));
+    ASSERT_ARE_EQUAL(uint64_t, 1, statistics.retained_buffers);
+    ASSERT_ARE_EQUAL(uint64_t, 128, statistics.retained_bytes);
 
     ///cleanup
+    CONSTBUFFER_POOL_Destroy(pool);
 }
 
-/*Tests_SRS_CONSTBUFFER_51_016: [ CONSTBUFFER_GetWritableBufferSize shall succeed and returns the size of the writable buffer of constbufferWritableHandle. ]*/
-TEST_FUNCTION(CONSTBUFFER_GetWritableBufferSize_succeeds)
+/*Tests_SRS_CONSTBUFFER_12_023: [ If the refcount of a buffer created by CONSTBUFFER_POOL_CreateWritableHandle reaches zero and the pool has a free slot in the buffer's size class, then the buffer shall be stored in the slot instead of being freed. ]*/
+TEST_FUNCTION(CONSTBUFFER_DecRef_of_a_slice_of_a_pooled_buffer_retains_the_pooled_buffer)
 {
     ///arrange
-    CONSTBUFFER_WRITABLE_HANDLE constbufferWritableHandle;
-    uint32_t bufferSize;
-    STRICT_EXPECTED_CALL(malloc_flex(IGNORED_ARG, BUFFER1_length, 1));
+    CONSTBUFFER_POOL_STATISTICS statistics;
+    CONSTBUFFER_POOL_HANDLE pool = CONSTBUFFER_POOL_Create(1024, 4);
+    ASSERT_IS_NOT_NULL(pool);
+    CONSTBUFFER_HANDLE handle = CONSTBUFFER_SealWritableHandle(CONSTBUFFER_POOL_CreateWritableHandle(pool, 10));
+    ASSERT_IS_NOT_NULL(handle);
+    CONSTBUFFER_HANDLE slice = CONSTBUFFER_CreateFromOffsetAndSize(handle, 1, 2);
+    ASSERT_IS_NOT_NULL(slice);
+    CONSTBUFFER_DecRef(handle);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(free(slice));
 
     ///act
-    constbufferWritableHandle = CONSTBUFFER_CreateWritableHandle(BUFFER1_length);
+    CONSTBUFFER_DecRef(slice);
 
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, CONSTBUFFER_POOL_GetStatistics(pool, &statistics));
+    ASSERT_ARE_EQUAL(uint64_t, 1, statistics.retained_buffers);
 
-    bufferSize = CONSTBUFFER_GetWritableBufferSize(constbufferWritableHandle);
+    ///cleanup
+    CONSTBUFFER_POOL_Destroy(pool);
+}
+
+/*CONSTBUFFER_POOL_GetStatistics*/
+
+/*Tests_SRS_CONSTBUFFER_12_020: [ If pool is NULL then CONSTBUFFER_POOL_GetStatistics shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(CONSTBUFFER_POOL_GetStatistics_with_NULL_pool_fails)
+{
+    ///arrange
+    CONSTBUFFER_POOL_STATISTICS statistics;
+
+    ///act
+    int result = CONSTBUFFER_POOL_GetStatistics(NULL, &statistics);
 
     ///assert
-    ASSERT_ARE_EQUAL(uint32_t, bufferSize, BUFFER1_length);
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    ///cleanup
+}
+
+/*Tests_SRS_CONSTBUFFER_12_021: [ If statistics is NULL then CONSTBUFFER_POOL_GetStatistics shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(CONSTBUFFER_POOL_GetStatistics_with_NULL_statistics_fails)
+{
+    ///arrange
+    CONSTBUFFER_POOL_HANDLE pool = CONSTBUFFER_POOL_Create(1024, 4);
+    ASSERT_IS_NOT_NULL(pool);
+
+    ///act
+    int result = CONSTBUFFER_POOL_GetStatistics(pool, NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    ///cleanup
+    CONSTBUFFER_POOL_Destroy(pool);
+}
+
+/*Tests_SRS_CONSTBUFFER_12_022: [ CONSTBUFFER_POOL_GetStatistics shall write in statistics the number of hits, misses, retained buffers and retained bytes of the pool and return 0. ]*/
+TEST_FUNCTION(CONSTBUFFER_POOL_GetStatistics_returns_the_counters_of_the_pool)
+{
+    ///arrange
+    CONSTBUFFER_POOL_STATISTICS statistics;
+    CONSTBUFFER_POOL_HANDLE pool = CONSTBUFFER_POOL_Create(1024, 4);
+    ASSERT_IS_NOT_NULL(pool);
+    CONSTBUFFER_WRITABLE_HANDLE small = CONSTBUFFER_POOL_CreateWritableHandle(pool, 10); /*miss, size class of 64 bytes*/
+    ASSERT_IS_NOT_NULL(small);
+    CONSTBUFFER_WRITABLE_HANDLE big = CONSTBUFFER_POOL_CreateWritableHandle(pool, 1000); /*miss, size class of 1024 bytes*/
+    ASSERT_IS_NOT_NULL(big);
+    CONSTBUFFER_WritableHandleDecRef(small); /*retained*/
+    CONSTBUFFER_WritableHandleDecRef(big); /*retained*/
+    CONSTBUFFER_WRITABLE_HANDLE reused = CONSTBUFFER_POOL_CreateWritableHandle(pool, 20); /*hit, takes small*/
+    ASSERT_ARE_EQUAL(void_ptr, small, reused);
+    umock_c_reset_all_calls();
+
+    ///act
+    int result = CONSTBUFFER_POOL_GetStatistics(pool, &statistics);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint64_t, 1, statistics.hits);
+    ASSERT_ARE_EQUAL(uint64_t, 2, statistics.misses);
+    ASSERT_ARE_EQUAL(uint64_t, 1, statistics.retained_buffers);
+    ASSERT_ARE_EQUAL(uint64_t, 1024, statistics.retained_bytes);
+
+    /*trimming drops the retained buffers but keeps the hits and the misses*/
+    CONSTBUFFER_POOL_Trim(pool);
+    ASSERT_ARE_EQUAL(int, 0, CONSTBUFFER_POOL_GetStatistics(pool, &statistics));
+    ASSERT_ARE_EQUAL(uint64_t, 1, statistics.hits);
+    ASSERT_ARE_EQUAL(uint64_t, 2, statistics.misses);
+    ASSERT_ARE_EQUAL(uint64_t, 0, statistics.retained_buffers);
+    ASSERT_ARE_EQUAL(uint64_t, 0, statistics.retained_bytes);
 
     ///cleanup
-    CONSTBUFFER_WritableHandleDecRef(constbufferWritableHandle);
+    CONSTBUFFER_WritableHandleDecRef(reused);
+    CONSTBUFFER_POOL_Destroy(pool);
+}
+
+/*CONSTBUFFER_POOL_Trim*/
+
+/*Tests_SRS_CONSTBUFFER_12_026: [ If pool is NULL then CONSTBUFFER_POOL_Trim shall return. ]*/
+TEST_FUNCTION(CONSTBUFFER_POOL_Trim_with_NULL_pool_returns)
+{
+    ///arrange
+
+    ///act
+    CONSTBUFFER_POOL_Trim(NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+}
+
+/*Tests_SRS_CONSTBUFFER_12_027: [ CONSTBUFFER_POOL_Trim shall free all the buffers retained by the pool. ]*/
+TEST_FUNCTION(CONSTBUFFER_POOL_Trim_frees_the_retained_buffers)
+{
+    ///arrange
+    CONSTBUFFER_POOL_STATISTICS statistics;
+    CONSTBUFFER_POOL_HANDLE pool = CONSTBUFFER_POOL_Create(1024, 4);
+    ASSERT_IS_NOT_NULL(pool);
+    CONSTBUFFER_WRITABLE_HANDLE small = CONSTBUFFER_POOL_CreateWritableHandle(pool, 10);
+    ASSERT_IS_NOT_NULL(small);
+    CONSTBUFFER_WRITABLE_HANDLE big = CONSTBUFFER_POOL_CreateWritableHandle(pool, 1000);
+    ASSERT_IS_NOT_NULL(big);
+    CONSTBUFFER_WritableHandleDecRef(small);
+    CONSTBUFFER_WritableHandleDecRef(big);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(free(small));
+    STRICT_EXPECTED_CALL(free(big));
+
+    ///act
+    CONSTBUFFER_POOL_Trim(pool);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, CONSTBUFFER_POOL_GetStatistics(pool, &statistics));
+    ASSERT_ARE_EQUAL(uint64_t, 0, statistics.retained_buffers);
+    ASSERT_ARE_EQUAL(uint64_t, 0, statistics.retained_bytes);
+
+    ///cleanup
+    CONSTBUFFER_POOL_Destroy(pool);
 }
 
 END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
@@ -21,11 +21,15 @@
 #include "c_util/buffer_.h"
 #include "c_pal/gballoc_hl.h"
 #include "c_pal/gballoc_hl_redirect.h"
+#include "c_pal/threadapi.h"
+#include "c_util/memory_mapped_file.h"
+#include "c_util/hash.h"
 
 #include "umock_c/umock_c_prod.h"
 
 #include "umock_c/umock_c_DISABLE_MOCKS.h" // ============================== DISABLE_MOCKS
 
 #include "real_gballoc_hl.h"
+#include "real_hash.h"
 
 #endif // CONSTBUFFER_UT_PCH_H
@@ -0,0 +1,229 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "crc32c_ut_pch.h"
+
+MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    ASSERT_FAIL("umock_c reported error :%" PRI_MU_ENUM "", MU_ENUM_VALUE(UMOCK_C_ERROR_CODE, error_code));
+}
+
+/*bit at a time CRC-32C, used to check whatever implementation crc32c picked on this machine*/
+static uint32_t reference_crc32c(uint32_t crc, const unsigned char* buffer, size_t size)
+{
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++)
+    {
+        crc ^= buffer[i];
+        for (int bit = 0; bit < 8; bit++)
+        {
+            crc = (crc >> 1) ^ ((crc & 1) ? 0x82F63B78 : 0);
+        }
+    }
+    return ~crc;
+}
+
+static unsigned char test_bytes[300];
+
+BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
+
+TEST_SUITE_INITIALIZE(a)
+{
+    umock_c_init(on_umock_c_error);
+
+    (void)umocktypes_stdint_register_types();
+
+    for (size_t i = 0; i < sizeof(test_bytes); i++)
+    {
+        test_bytes[i] = (unsigned char)(i * 7 + 3);
+    }
+}
+
+TEST_SUITE_CLEANUP(b)
+{
+    umock_c_deinit();
+}
+
+TEST_FUNCTION_INITIALIZE(c)
+{
+    umock_c_reset_all_calls();
+}
+
+TEST_FUNCTION_CLEANUP(d)
+{
+}
+
+/* crc32c_compute */
+
+/*Tests_SRS_CRC32C_12_001: [ If buffer is NULL and size is not 0 then crc32c_compute shall fail and return crc. ]*/
+TEST_FUNCTION(crc32c_compute_with_NULL_buffer_returns_crc)
+{
+    ///act
+    uint32_t result = crc32c_compute(0x12345678, NULL, 1);
+
+    ///assert
+    ASSERT_ARE_EQUAL(uint32_t, 0x12345678, result);
+}
+
+/*Tests_SRS_CRC32C_12_002: [ If size is 0 then crc32c_compute shall return crc. ]*/
+TEST_FUNCTION(crc32c_compute_with_size_0_returns_crc)
+{
+    ///act
+    uint32_t result_0 = crc32c_compute(0, test_bytes, 0);
+    uint32_t result_1 = crc32c_compute(0xABCDEF01, test_bytes, 0);
+
+    ///assert
+    ASSERT_ARE_EQUAL(uint32_t, 0, result_0);
+    ASSERT_ARE_EQUAL(uint32_t, 0xABCDEF01, result_1);
+}
+
+/*Tests_SRS_CRC32C_12_005: [ crc32c_compute shall return the CRC-32C of the size bytes at buffer continuing from crc. ]*/
+TEST_FUNCTION(crc32c_compute_of_check_string_succeeds)
+{
+    ///act
+    uint32_t result = crc32c_compute(0, "123456789", 9);
+
+    ///assert
+    ASSERT_ARE_EQUAL(uint32_t, 0xE3069283, result);
+}
+
+/*Tests_SRS_CRC32C_12_005: [ crc32c_compute shall return the CRC-32C of the size bytes at buffer continuing from crc. ]*/
+TEST_FUNCTION(crc32c_compute_of_RFC_3720_vectors_succeeds)
+{
+    ///arrange
+    unsigned char zeroes[32];
+    unsigned char ones[32];
+    unsigned char incrementing[32];
+    unsigned char decrementing[32];
+    for (uint8_t i = 0; i < 32; i++)
+    {
+        zeroes[i] = 0;
+        ones[i] = 0xFF;
+        incrementing[i] = i;
+        decrementing[i] = (uint8_t)(31 - i);
+    }
+
+    ///act
+    uint32_t result_zeroes = crc32c_compute(0, zeroes, sizeof(zeroes));
+    uint32_t result_ones = crc32c_compute(0, ones, sizeof(ones));
+    uint32_t result_incrementing = crc32c_compute(0, incrementing, sizeof(incrementing));
+    uint32_t result_decrementing = crc32c_compute(0, decrementing, sizeof(decrementing));
+
+    ///assert
+    ASSERT_ARE_EQUAL(uint32_t, 0x8A9136AA, result_zeroes);
+    ASSERT_ARE_EQUAL(uint32_t, 0x62A8AB43, result_ones);
+    ASSERT_ARE_EQUAL(uint32_t, 0x46DD794E, result_incrementing);
+    ASSERT_ARE_EQUAL(uint32_t, 0x113FDB5C, result_decrementing);
+}
+
+/*Tests_SRS_CRC32C_12_003: [ If the CPU has CRC-32C instructions then crc32c_compute shall use them. ]*/
+/*Tests_SRS_CRC32C_12_004: [ Otherwise crc32c_compute shall use slicing-by-8 tables. ]*/
+/*Tests_SRS_CRC32C_12_005: [ crc32c_compute shall return the CRC-32C of the size bytes at buffer continuing from crc. ]*/
+TEST_FUNCTION(crc32c_compute_for_all_alignments_and_sizes_matches_reference)
+{
+    for (size_t offset = 0; offset < 8; offset++)
+    {
+        for (size_t size = 1; size < sizeof(test_bytes) - offset; size++)
+        {
+            ///act
+            uint32_t result = crc32c_compute(0, test_bytes + offset, size);
+
+            ///assert
+            ASSERT_ARE_EQUAL(uint32_t, reference_crc32c(0, test_bytes + offset, size), result, "offset=%zu, size=%zu", offset, size);
+        }
+    }
+}
+
+/*Tests_SRS_CRC32C_12_005: [ crc32c_compute shall return the CRC-32C of the size bytes at buffer continuing from crc. ]*/
+TEST_FUNCTION(crc32c_compute_in_pieces_is_the_same_as_in_one_call)
+{
+    ///arrange
+    uint32_t expected = crc32c_compute(0, test_bytes, sizeof(test_bytes));
+
+    ///act
+    uint32_t result = crc32c_compute(0, test_bytes, 13);
+    result = crc32c_compute(result, test_bytes + 13, 100);
+    result = crc32c_compute(result, test_bytes + 113, sizeof(test_bytes) - 113);
+
+    ///assert
+    ASSERT_ARE_EQUAL(uint32_t, expected, result);
+}
+
+/* crc32c_copy */
+
+/*Tests_SRS_CRC32C_12_006: [ If destination is NULL and size is not 0 then crc32c_copy shall fail and return crc. ]*/
+TEST_FUNCTION(crc32c_copy_with_NULL_destination_returns_crc)
+{
+    ///act
+    uint32_t result = crc32c_copy(0x12345678, NULL, test_bytes, 1);
+
+    ///assert
+    ASSERT_ARE_EQUAL(uint32_t, 0x12345678, result);
+}
+
+/*Tests_SRS_CRC32C_12_007: [ If source is NULL and size is not 0 then crc32c_copy shall fail and return crc. ]*/
+TEST_FUNCTION(crc32c_copy_with_NULL_source_returns_crc)
+{
+    ///arrange
+    unsigned char destination[1];
+
+    ///act
+    uint32_t result = crc32c_copy(0x12345678, destination, NULL, 1);
+
+    ///assert
+    ASSERT_ARE_EQUAL(uint32_t, 0x12345678, result);
+}
+
+/*Tests_SRS_CRC32C_12_008: [ If size is 0 then crc32c_copy shall return crc. ]*/
+TEST_FUNCTION(crc32c_copy_with_size_0_returns_crc)
+{
+    ///act
+    uint32_t result = crc32c_copy(0xABCDEF01, NULL, NULL, 0);
+
+    ///assert
+    ASSERT_ARE_EQUAL(uint32_t, 0xABCDEF01, result);
+}
+
+/*Tests_SRS_CRC32C_12_009: [ crc32c_copy shall copy the size bytes of source to destination and compute their CRC-32C in the same pass, using the same implementation as crc32c_compute. ]*/
+/*Tests_SRS_CRC32C_12_010: [ crc32c_copy shall return the CRC-32C of the copied bytes continuing from crc. ]*/
+TEST_FUNCTION(crc32c_copy_for_all_alignments_and_sizes_copies_and_matches_reference)
+{
+    for (size_t offset = 0; offset < 8; offset++)
+    {
+        for (size_t size = 1; size < sizeof(test_bytes) - offset; size++)
+        {
+            ///arrange
+            unsigned char destination[sizeof(test_bytes) + 1];
+            (void)memset(destination, 0, sizeof(destination));
+
+            ///act
+            uint32_t result = crc32c_copy(0, destination + 1, test_bytes + offset, size);
+
+            ///assert
+            ASSERT_ARE_EQUAL(uint32_t, reference_crc32c(0, test_bytes + offset, size), result, "offset=%zu, size=%zu", offset, size);
+            ASSERT_ARE_EQUAL(int, 0, memcmp(destination + 1, test_bytes + offset, size), "offset=%zu, size=%zu", offset, size);
+            ASSERT_ARE_EQUAL(uint8_t, 0, destination[0], "nothing is written before destination");
+            if (size + 1 < sizeof(destination))
+            {
+                ASSERT_ARE_EQUAL(uint8_t, 0, destination[size + 1], "nothing is written after destination + size");
+            }
+        }
+    }
+}
+
+/*Tests_SRS_CRC32C_12_010: [ crc32c_copy shall return the CRC-32C of the copied bytes continuing from crc. ]*/
+TEST_FUNCTION(crc32c_copy_continues_from_crc)
+{
+    ///arrange
+    unsigned char destination[sizeof(test_bytes)];
+    uint32_t crc = crc32c_compute(0, test_bytes, 10);
+
+    ///act
+    uint32_t result = crc32c_copy(crc, destination, test_bytes + 10, sizeof(test_bytes) - 10);
+
+    ///assert
+    ASSERT_ARE_EQUAL(uint32_t, crc32c_compute(0, test_bytes, sizeof(test_bytes)), result);
+}
+
+END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
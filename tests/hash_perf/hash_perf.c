@@ -0,0 +1,141 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <inttypes.h>
+
+#include "macro_utils/macro_utils.h"
+#include "testrunnerswitcher.h"
+
+#include "c_logging/logger.h"
+
+#include "c_pal/gballoc_hl.h"
+#include "c_pal/gballoc_hl_redirect.h"
+#include "c_pal/timer.h"
+
+#include "c_util/hash.h"
+
+#define KEY_COUNT (1024 * 1024)
+#define KEY_AREA_SIZE (4 * 1024 * 1024)
+#define ITERATIONS 10
+
+static void fill_random(unsigned char* destination, uint32_t size)
+{
+    uint32_t seed = 0x12345678;
+    for (uint32_t i = 0; i < size; i++)
+    {
+        seed = seed * 1103515245 + 12345;
+        destination[i] = (unsigned char)(seed >> 16);
+    }
+}
+
+/*KEY_COUNT keys of min_length to max_length bytes, one after the other in the key area (wrapping around), like the keys of an index*/
+static void measure_hash_compute_hash_batch(uint32_t min_length, uint32_t max_length)
+{
+    unsigned char* key_area = malloc(KEY_AREA_SIZE);
+    ASSERT_IS_NOT_NULL(key_area);
+    const void** keys = malloc_2(KEY_COUNT, sizeof(const void*));
+    ASSERT_IS_NOT_NULL(keys);
+    size_t* lengths = malloc_2(KEY_COUNT, sizeof(size_t));
+    ASSERT_IS_NOT_NULL(lengths);
+    uint32_t* hashes = malloc_2(KEY_COUNT, sizeof(uint32_t));
+    ASSERT_IS_NOT_NULL(hashes);
+    uint32_t* batch_hashes = malloc_2(KEY_COUNT, sizeof(uint32_t));
+    ASSERT_IS_NOT_NULL(batch_hashes);
+
+    fill_random(key_area, KEY_AREA_SIZE);
+    uint32_t offset = 0;
+    uint32_t length_seed = 42;
+    for (uint32_t i = 0; i < KEY_COUNT; i++)
+    {
+        length_seed = length_seed * 1103515245 + 12345;
+        lengths[i] = min_length + (length_seed >> 16) % (max_length - min_length + 1);
+        if (offset + lengths[i] > KEY_AREA_SIZE)
+        {
+            offset = 0;
+        }
+        keys[i] = key_area + offset;
+        offset += (uint32_t)lengths[i];
+    }
+
+    double start = timer_global_get_elapsed_ms();
+    for (uint32_t j = 0; j < ITERATIONS; j++)
+    {
+        for (uint32_t i = 0; i < KEY_COUNT; i++)
+        {
+            ASSERT_ARE_EQUAL(int, 0, hash_compute_hash(keys[i], lengths[i], &hashes[i]));
+        }
+    }
+    double single_ms = timer_global_get_elapsed_ms() - start;
+
+    start = timer_global_get_elapsed_ms();
+    for (uint32_t j = 0; j < ITERATIONS; j++)
+    {
+        ASSERT_ARE_EQUAL(int, 0, hash_compute_hash_batch(keys, lengths, KEY_COUNT, batch_hashes));
+    }
+    double batch_ms = timer_global_get_elapsed_ms() - start;
+
+    for (uint32_t i = 0; i < KEY_COUNT; i++)
+    {
+        ASSERT_ARE_EQUAL(uint32_t, hashes[i], batch_hashes[i], "key %" PRIu32 " of %zu bytes", i, lengths[i]);
+    }
+
+    double key_count = (double)KEY_COUNT * ITERATIONS;
+    LogInfo("hash_compute_hash_batch %" PRIu32 "-%" PRIu32 " byte keys: hash_compute_hash %.1f ns/key, hash_compute_hash_batch %.1f ns/key (x%.2f)",
+        min_length, max_length, single_ms * 1000000.0 / key_count, batch_ms * 1000000.0 / key_count, single_ms / batch_ms);
+
+    free(batch_hashes);
+    free(hashes);
+    free(lengths);
+    free((void*)keys);
+    free(key_area);
+}
+
+BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    ASSERT_ARE_EQUAL(int, 0, gballoc_hl_init(NULL, NULL));
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    gballoc_hl_deinit();
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+}
+
+TEST_FUNCTION(hash_perf_batch_of_8_byte_keys)
+{
+    measure_hash_compute_hash_batch(8, 8);
+}
+
+TEST_FUNCTION(hash_perf_batch_of_16_byte_keys)
+{
+    measure_hash_compute_hash_batch(16, 16);
+}
+
+TEST_FUNCTION(hash_perf_batch_of_32_byte_keys)
+{
+    measure_hash_compute_hash_batch(32, 32);
+}
+
+TEST_FUNCTION(hash_perf_batch_of_64_byte_keys)
+{
+    measure_hash_compute_hash_batch(64, 64);
+}
+
+TEST_FUNCTION(hash_perf_batch_of_16_to_64_byte_keys)
+{
+    measure_hash_compute_hash_batch(16, 64);
+}
+
+END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
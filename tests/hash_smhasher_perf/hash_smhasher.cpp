@@ -0,0 +1,454 @@
+// Copyright (C) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdarg>
+#include <cstring>
+#include <cfloat>
+#include <cinttypes>
+#include <vector>
+
+#include "macro_utils/macro_utils.h"
+
+#include "c_util/hash.h"
+#include "MurmurHash2.h"
+
+/*smhasher*/
+#include "Platform.h"
+#include "Types.h"
+#include "Random.h"
+#include "KeysetTest.h"
+#include "AvalancheTest.h"
+#include "DifferentialTest.h"
+
+#include "hash_smhasher.h"
+
+#define HASH_SMHASHER_SPEED_TRIALS 16
+#define HASH_SMHASHER_SPEED_BYTES_PER_TRIAL (1024 * 1024)
+#define HASH_SMHASHER_LATENCY_KEY_SIZE_MAX 32
+#define HASH_SMHASHER_LATENCY_HASHES_PER_TRIAL 100000
+#define HASH_SMHASHER_BATCH_KEY_COUNT 64
+#define HASH_SMHASHER_BATCH_CHECK_KEY_COUNT 100000
+#define HASH_SMHASHER_BATCH_CHECK_KEY_SIZE_MAX 300
+#define HASH_SMHASHER_BATCH_CHECK_AREA_SIZE (1024 * 1024)
+
+static const size_t hash_smhasher_speed_key_sizes[] = { 4, 8, 16, 32, 64, 128, 256, 512, 1024, 4096, 16384, 65536, 262144, 1048576 };
+
+/*calls of the functions of hash.h that failed while smhasher was running (they should all succeed)*/
+static uint32_t hash_smhasher_failed_calls;
+
+/*the hashes computed while measuring speed end up here, so the calls cannot be optimized away*/
+static volatile uint64_t hash_smhasher_sink;
+
+static void smhasher_hash_compute_hash(const void* blob, const int len, const uint32_t seed, void* out)
+{
+    /*hash_compute_hash has no seed. It rejects empty keys, those get the value MurmurHash2 has for them*/
+    (void)seed;
+    uint32_t hash;
+    if (len == 0)
+    {
+        hash = MurmurHash2(blob, 0, 0);
+    }
+    else if (hash_compute_hash(blob, (size_t)len, &hash) != 0)
+    {
+        hash_smhasher_failed_calls++;
+        hash = 0;
+    }
+    (void)memcpy(out, &hash, sizeof(hash));
+}
+
+static void smhasher_hash_compute_hash_64(const void* blob, const int len, const uint32_t seed, void* out)
+{
+    (void)seed;
+    uint64_t hash;
+    if (hash_compute_hash_64(blob, (size_t)len, &hash) != 0)
+    {
+        hash_smhasher_failed_calls++;
+        hash = 0;
+    }
+    (void)memcpy(out, &hash, sizeof(hash));
+}
+
+static void smhasher_hash_compute_hash_seeded(const void* blob, const int len, const uint32_t seed, void* out)
+{
+    uint64_t hash;
+    if (hash_compute_hash_seeded(blob, (size_t)len, seed, &hash) != 0)
+    {
+        hash_smhasher_failed_calls++;
+        hash = 0;
+    }
+    (void)memcpy(out, &hash, sizeof(hash));
+}
+
+static void smhasher_hash_streaming(const void* blob, const int len, const uint32_t seed, void* out)
+{
+    /*the key is passed to hash_update in 3 pieces, so the suites also go through the buffering of HASH_STATE*/
+    const unsigned char* bytes = (const unsigned char*)blob;
+    size_t first = (size_t)len / 3;
+    size_t second = (size_t)len / 2;
+    HASH_STATE state;
+    uint64_t hash;
+    if (
+        (hash_init(&state, seed) != 0) ||
+        (hash_update(&state, bytes, first) != 0) ||
+        (hash_update(&state, bytes + first, second - first) != 0) ||
+        (hash_update(&state, bytes + second, (size_t)len - second) != 0) ||
+        (hash_final(&state, &hash) != 0)
+        )
+    {
+        hash_smhasher_failed_calls++;
+        hash = 0;
+    }
+    (void)memcpy(out, &hash, sizeof(hash));
+}
+
+typedef struct HASH_SMHASHER_HASH_TAG
+{
+    const char* name;
+    int bits;
+    bool seeded;
+    pfHash hash;
+} HASH_SMHASHER_HASH;
+
+/*in the order of HASH_SMHASHER_FUNCTION*/
+static const HASH_SMHASHER_HASH hash_smhasher_hashes[] =
+{
+    { "hash_compute_hash", 32, false, smhasher_hash_compute_hash },
+    { "hash_compute_hash_64", 64, false, smhasher_hash_compute_hash_64 },
+    { "hash_compute_hash_seeded", 64, true, smhasher_hash_compute_hash_seeded },
+    { "hash_init/hash_update/hash_final", 64, true, smhasher_hash_streaming }
+};
+
+static void hash_smhasher_write_result(FILE* results, const char* format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    va_list stdout_args;
+    va_copy(stdout_args, args);
+    (void)vfprintf(results, format, args);
+    (void)fputc('\n', results);
+    (void)vprintf(format, stdout_args);
+    (void)putchar('\n');
+    va_end(stdout_args);
+    va_end(args);
+    (void)fflush(results);
+}
+
+static void hash_smhasher_write_suite_result(FILE* results, const HASH_SMHASHER_HASH* hash, const char* suite, bool passed, uint32_t* failed_count)
+{
+    hash_smhasher_write_result(results, "{\"hash\":\"%s\",\"bits\":%d,\"test\":\"quality\",\"suite\":\"%s\",\"result\":\"%s\"}",
+        hash->name, hash->bits, suite, passed ? "passed" : "failed");
+    if (!passed)
+    {
+        (*failed_count)++;
+    }
+}
+
+/*the verification value of smhasher: the hash of the hashes of the keys {}, {0}, {0, 1}, ... {0, ..., 254} (seeded with 256 - length). It changes
+whenever any value of the hash changes*/
+static uint32_t hash_smhasher_compute_verification_value(pfHash hash, int hashbits)
+{
+    const int hashbytes = hashbits / 8;
+    std::vector<uint8_t> key(256, 0);
+    std::vector<uint8_t> hashes((size_t)hashbytes * 256, 0);
+    std::vector<uint8_t> final_hash((size_t)hashbytes, 0);
+
+    for (int i = 0; i < 256; i++)
+    {
+        key[i] = (uint8_t)i;
+        hash(key.data(), i, 256 - i, &hashes[(size_t)i * hashbytes]);
+    }
+    hash(hashes.data(), hashbytes * 256, 0, final_hash.data());
+
+    return (uint32_t)final_hash[0] | ((uint32_t)final_hash[1] << 8) | ((uint32_t)final_hash[2] << 16) | ((uint32_t)final_hash[3] << 24);
+}
+
+/*the suites of smhasher's main, with its parameters*/
+template < typename hashtype >
+static uint32_t hash_smhasher_run_suites(const HASH_SMHASHER_HASH* smhasher_hash, FILE* results)
+{
+    hashfunc<hashtype> hash(smhasher_hash->hash);
+    const int hashbits = sizeof(hashtype) * 8;
+    const bool drawDiagram = false;
+    uint32_t failed_count = 0;
+
+    hash_smhasher_failed_calls = 0;
+
+    hash_smhasher_write_result(results, "{\"hash\":\"%s\",\"bits\":%d,\"test\":\"quality\",\"suite\":\"Verification\",\"value\":\"0x%08" PRIX32 "\"}",
+        smhasher_hash->name, hashbits, hash_smhasher_compute_verification_value(hash, hashbits));
+
+    {
+        bool result = SanityTest(hash, hashbits);
+        AppendedZeroesTest(hash, hashbits);
+        hash_smhasher_write_suite_result(results, smhasher_hash, "Sanity", result, &failed_count);
+    }
+
+    {
+        bool result = true;
+        result &= DiffTest< Blob<64>, hashtype >(hash, 5, 1000, false);
+        result &= DiffTest< Blob<128>, hashtype >(hash, 4, 1000, false);
+        result &= DiffTest< Blob<256>, hashtype >(hash, 3, 1000, false);
+        hash_smhasher_write_suite_result(results, smhasher_hash, "Differential", result, &failed_count);
+    }
+
+    {
+        bool result = true;
+        result &= AvalancheTest< Blob< 32>, hashtype >(hash, 300000);
+        result &= AvalancheTest< Blob< 40>, hashtype >(hash, 300000);
+        result &= AvalancheTest< Blob< 48>, hashtype >(hash, 300000);
+        result &= AvalancheTest< Blob< 56>, hashtype >(hash, 300000);
+        result &= AvalancheTest< Blob< 64>, hashtype >(hash, 300000);
+        result &= AvalancheTest< Blob< 72>, hashtype >(hash, 300000);
+        result &= AvalancheTest< Blob< 80>, hashtype >(hash, 300000);
+        result &= AvalancheTest< Blob< 88>, hashtype >(hash, 300000);
+        result &= AvalancheTest< Blob< 96>, hashtype >(hash, 300000);
+        result &= AvalancheTest< Blob<104>, hashtype >(hash, 300000);
+        result &= AvalancheTest< Blob<112>, hashtype >(hash, 300000);
+        result &= AvalancheTest< Blob<120>, hashtype >(hash, 300000);
+        result &= AvalancheTest< Blob<128>, hashtype >(hash, 300000);
+        result &= AvalancheTest< Blob<136>, hashtype >(hash, 300000);
+        result &= AvalancheTest< Blob<144>, hashtype >(hash, 300000);
+        result &= AvalancheTest< Blob<152>, hashtype >(hash, 300000);
+        result &= AvalancheTest< Blob<160>, hashtype >(hash, 300000);
+        hash_smhasher_write_suite_result(results, smhasher_hash, "Avalanche", result, &failed_count);
+    }
+
+    {
+        bool result = true;
+        result &= CyclicKeyTest<hashtype>(hash, sizeof(hashtype) + 0, 8, 10000000, drawDiagram);
+        result &= CyclicKeyTest<hashtype>(hash, sizeof(hashtype) + 1, 8, 10000000, drawDiagram);
+        result &= CyclicKeyTest<hashtype>(hash, sizeof(hashtype) + 2, 8, 10000000, drawDiagram);
+        result &= CyclicKeyTest<hashtype>(hash, sizeof(hashtype) + 3, 8, 10000000, drawDiagram);
+        result &= CyclicKeyTest<hashtype>(hash, sizeof(hashtype) + 4, 8, 10000000, drawDiagram);
+        hash_smhasher_write_suite_result(results, smhasher_hash, "Cyclic", result, &failed_count);
+    }
+
+    {
+        bool result = true;
+        for (int i = 4; i <= 20; i += 4)
+        {
+            result &= TwoBytesTest2<hashtype>(hash, i, drawDiagram);
+        }
+        hash_smhasher_write_suite_result(results, smhasher_hash, "TwoBytes", result, &failed_count);
+    }
+
+    {
+        bool result = true;
+        result &= SparseKeyTest<  32, hashtype>(hash, 6, true, true, true, drawDiagram);
+        result &= SparseKeyTest<  40, hashtype>(hash, 6, true, true, true, drawDiagram);
+        result &= SparseKeyTest<  48, hashtype>(hash, 5, true, true, true, drawDiagram);
+        result &= SparseKeyTest<  56, hashtype>(hash, 5, true, true, true, drawDiagram);
+        result &= SparseKeyTest<  64, hashtype>(hash, 5, true, true, true, drawDiagram);
+        result &= SparseKeyTest<  96, hashtype>(hash, 4, true, true, true, drawDiagram);
+        result &= SparseKeyTest< 256, hashtype>(hash, 3, true, true, true, drawDiagram);
+        result &= SparseKeyTest<2048, hashtype>(hash, 2, true, true, true, drawDiagram);
+        hash_smhasher_write_suite_result(results, smhasher_hash, "Sparse", result, &failed_count);
+    }
+
+    {
+        bool result = true;
+        uint32_t low_blocks[] = { 0x00000000, 0x00000001, 0x00000002, 0x00000003, 0x00000004, 0x00000005, 0x00000006, 0x00000007 };
+        uint32_t high_blocks[] = { 0x00000000, 0x20000000, 0x40000000, 0x60000000, 0x80000000, 0xA0000000, 0xC0000000, 0xE0000000 };
+        result &= CombinationKeyTest<hashtype>(hash, 8, low_blocks, sizeof(low_blocks) / sizeof(low_blocks[0]), true, true, drawDiagram);
+        result &= CombinationKeyTest<hashtype>(hash, 8, high_blocks, sizeof(high_blocks) / sizeof(high_blocks[0]), true, true, drawDiagram);
+        hash_smhasher_write_suite_result(results, smhasher_hash, "Permutation", result, &failed_count);
+    }
+
+    {
+        bool result = WindowedKeyTest< Blob<sizeof(hashtype) * 8 * 2>, hashtype >(hash, 20, true, true, drawDiagram);
+        hash_smhasher_write_suite_result(results, smhasher_hash, "Window", result, &failed_count);
+    }
+
+    {
+        const char* alnum = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+        bool result = true;
+        result &= TextKeyTest(hash, "Foo", alnum, 4, "Bar", drawDiagram);
+        result &= TextKeyTest(hash, "FooBar", alnum, 4, "", drawDiagram);
+        result &= TextKeyTest(hash, "", alnum, 4, "FooBar", drawDiagram);
+        hash_smhasher_write_suite_result(results, smhasher_hash, "Text", result, &failed_count);
+    }
+
+    {
+        bool result = ZeroKeyTest<hashtype>(hash, drawDiagram);
+        hash_smhasher_write_suite_result(results, smhasher_hash, "Zeroes", result, &failed_count);
+    }
+
+    if (smhasher_hash->seeded)
+    {
+        /*smhasher seeds are 32 bits, the seed of the 64-bit hash is tested in its low 32 bits*/
+        bool result = SeedTest<hashtype>(hash, 1000000, drawDiagram);
+        hash_smhasher_write_suite_result(results, smhasher_hash, "Seed", result, &failed_count);
+    }
+    else
+    {
+        /*all the seeds give the same value, that would be a collision for every key*/
+        hash_smhasher_write_result(results, "{\"hash\":\"%s\",\"bits\":%d,\"test\":\"quality\",\"suite\":\"Seed\",\"result\":\"skipped\"}",
+            smhasher_hash->name, hashbits);
+    }
+
+    hash_smhasher_write_suite_result(results, smhasher_hash, "Calls", (hash_smhasher_failed_calls == 0), &failed_count);
+
+    return failed_count;
+}
+
+uint32_t hash_smhasher_run_quality_suites(HASH_SMHASHER_FUNCTION function, FILE* results)
+{
+    const HASH_SMHASHER_HASH* smhasher_hash = &hash_smhasher_hashes[function];
+    uint32_t result;
+
+    (void)printf("[[[ smhasher quality suites ]]] - %s\n\n", smhasher_hash->name);
+    if (smhasher_hash->bits == 32)
+    {
+        result = hash_smhasher_run_suites<uint32_t>(smhasher_hash, results);
+    }
+    else
+    {
+        result = hash_smhasher_run_suites<uint64_t>(smhasher_hash, results);
+    }
+    return result;
+}
+
+/*the fewest cycles per hash of HASH_SMHASHER_SPEED_TRIALS trials (the other trials were interrupted or ran on a cold cache). When dependent is true
+every key depends on the hash of the previous key, which measures the latency of a hash instead of its throughput*/
+static double hash_smhasher_measure_cycles_per_hash(pfHash hash, uint8_t* key, int length, uint32_t hashes_per_trial, bool dependent)
+{
+    double best = DBL_MAX;
+    uint64_t out = 0;
+
+    for (uint32_t trial = 0; trial < HASH_SMHASHER_SPEED_TRIALS; trial++)
+    {
+        uint64_t start = rdtsc();
+        for (uint32_t i = 0; i < hashes_per_trial; i++)
+        {
+            if (dependent)
+            {
+                key[0] = (uint8_t)(key[0] ^ out);
+            }
+            hash(key, length, 0, &out);
+        }
+        uint64_t cycles = rdtsc() - start;
+        double cycles_per_hash = (double)cycles / hashes_per_trial;
+        if (cycles_per_hash < best)
+        {
+            best = cycles_per_hash;
+        }
+    }
+    hash_smhasher_sink = hash_smhasher_sink ^ out;
+    return best;
+}
+
+void hash_smhasher_measure_speed(HASH_SMHASHER_FUNCTION function, FILE* results)
+{
+    const HASH_SMHASHER_HASH* smhasher_hash = &hash_smhasher_hashes[function];
+    const size_t largest_key_size = hash_smhasher_speed_key_sizes[sizeof(hash_smhasher_speed_key_sizes) / sizeof(hash_smhasher_speed_key_sizes[0]) - 1];
+    std::vector<uint8_t> key(largest_key_size);
+    Rand r(42);
+    r.rand_p(key.data(), (int)key.size());
+
+    for (size_t i = 0; i < sizeof(hash_smhasher_speed_key_sizes) / sizeof(hash_smhasher_speed_key_sizes[0]); i++)
+    {
+        size_t key_size = hash_smhasher_speed_key_sizes[i];
+        uint32_t hashes_per_trial = (key_size < HASH_SMHASHER_SPEED_BYTES_PER_TRIAL) ? (uint32_t)(HASH_SMHASHER_SPEED_BYTES_PER_TRIAL / key_size) : 1;
+        double cycles_per_hash = hash_smhasher_measure_cycles_per_hash(smhasher_hash->hash, key.data(), (int)key_size, hashes_per_trial, false);
+        hash_smhasher_write_result(results, "{\"hash\":\"%s\",\"bits\":%d,\"test\":\"speed\",\"key_size\":%zu,\"cycles_per_hash\":%.2f,\"bytes_per_cycle\":%.3f}",
+            smhasher_hash->name, smhasher_hash->bits, key_size, cycles_per_hash, (cycles_per_hash > 0) ? key_size / cycles_per_hash : 0.0);
+    }
+
+    for (int key_size = 1; key_size <= HASH_SMHASHER_LATENCY_KEY_SIZE_MAX; key_size++)
+    {
+        double cycles_per_hash = hash_smhasher_measure_cycles_per_hash(smhasher_hash->hash, key.data(), key_size, HASH_SMHASHER_LATENCY_HASHES_PER_TRIAL, true);
+        hash_smhasher_write_result(results, "{\"hash\":\"%s\",\"bits\":%d,\"test\":\"latency\",\"key_size\":%d,\"cycles_per_hash\":%.2f}",
+            smhasher_hash->name, smhasher_hash->bits, key_size, cycles_per_hash);
+    }
+}
+
+void hash_smhasher_measure_batch_speed(FILE* results)
+{
+    const size_t largest_key_size = hash_smhasher_speed_key_sizes[sizeof(hash_smhasher_speed_key_sizes) / sizeof(hash_smhasher_speed_key_sizes[0]) - 1];
+    std::vector<uint8_t> key(largest_key_size);
+    Rand r(42);
+    r.rand_p(key.data(), (int)key.size());
+
+    /*all the keys of a batch are the same key, so a batch of 1 MB keys fits in the cache like a 1 MB key does for the other hashes*/
+    const void* keys[HASH_SMHASHER_BATCH_KEY_COUNT];
+    size_t lengths[HASH_SMHASHER_BATCH_KEY_COUNT];
+    uint32_t hashes[HASH_SMHASHER_BATCH_KEY_COUNT];
+
+    for (size_t i = 0; i < sizeof(hash_smhasher_speed_key_sizes) / sizeof(hash_smhasher_speed_key_sizes[0]); i++)
+    {
+        size_t key_size = hash_smhasher_speed_key_sizes[i];
+        for (size_t j = 0; j < HASH_SMHASHER_BATCH_KEY_COUNT; j++)
+        {
+            keys[j] = key.data();
+            lengths[j] = key_size;
+        }
+
+        uint32_t failed_calls = 0;
+        size_t batch_size = key_size * HASH_SMHASHER_BATCH_KEY_COUNT;
+        uint32_t batches_per_trial = (batch_size < HASH_SMHASHER_SPEED_BYTES_PER_TRIAL) ? (uint32_t)(HASH_SMHASHER_SPEED_BYTES_PER_TRIAL / batch_size) : 1;
+        double best = DBL_MAX;
+        for (uint32_t trial = 0; trial < HASH_SMHASHER_SPEED_TRIALS; trial++)
+        {
+            uint64_t start = rdtsc();
+            for (uint32_t j = 0; j < batches_per_trial; j++)
+            {
+                if (hash_compute_hash_batch(keys, lengths, HASH_SMHASHER_BATCH_KEY_COUNT, hashes) != 0)
+                {
+                    failed_calls++;
+                }
+            }
+            uint64_t cycles = rdtsc() - start;
+            double cycles_per_hash = (double)cycles / ((double)batches_per_trial * HASH_SMHASHER_BATCH_KEY_COUNT);
+            if (cycles_per_hash < best)
+            {
+                best = cycles_per_hash;
+            }
+        }
+        hash_smhasher_sink = hash_smhasher_sink ^ hashes[0];
+
+        hash_smhasher_write_result(results, "{\"hash\":\"hash_compute_hash_batch\",\"bits\":32,\"test\":\"speed\",\"key_size\":%zu,\"cycles_per_hash\":%.2f,\"bytes_per_cycle\":%.3f,\"failed_calls\":%" PRIu32 "}",
+            key_size, best, (best > 0) ? key_size / best : 0.0, failed_calls);
+    }
+}
+
+uint32_t hash_smhasher_check_batch_values(FILE* results)
+{
+    uint32_t different_count = 0;
+    std::vector<uint8_t> area(HASH_SMHASHER_BATCH_CHECK_AREA_SIZE);
+    std::vector<const void*> keys(HASH_SMHASHER_BATCH_CHECK_KEY_COUNT);
+    std::vector<size_t> lengths(HASH_SMHASHER_BATCH_CHECK_KEY_COUNT);
+    std::vector<uint32_t> hashes(HASH_SMHASHER_BATCH_CHECK_KEY_COUNT);
+    Rand r(4242);
+    r.rand_p(area.data(), (int)area.size());
+
+    /*keys of any length (up to a few blocks past the batch chunks) at any alignment*/
+    for (size_t i = 0; i < keys.size(); i++)
+    {
+        lengths[i] = 1 + r.rand_u32() % HASH_SMHASHER_BATCH_CHECK_KEY_SIZE_MAX;
+        keys[i] = &area[r.rand_u32() % (area.size() - lengths[i])];
+    }
+
+    if (hash_compute_hash_batch(keys.data(), lengths.data(), keys.size(), hashes.data()) != 0)
+    {
+        different_count = (uint32_t)keys.size();
+    }
+    else
+    {
+        for (size_t i = 0; i < keys.size(); i++)
+        {
+            uint32_t hash;
+            if (
+                (hash_compute_hash(keys[i], lengths[i], &hash) != 0) ||
+                (hash != hashes[i])
+                )
+            {
+                different_count++;
+            }
+        }
+    }
+
+    hash_smhasher_write_result(results, "{\"hash\":\"hash_compute_hash_batch\",\"bits\":32,\"test\":\"values\",\"reference\":\"hash_compute_hash\",\"key_count\":%zu,\"different_count\":%" PRIu32 "}",
+        keys.size(), different_count);
+    return different_count;
+}
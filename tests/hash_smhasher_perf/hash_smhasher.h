@@ -0,0 +1,48 @@
+// Copyright (C) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef HASH_SMHASHER_H
+#define HASH_SMHASHER_H
+
+#ifdef __cplusplus
+#include <cstdint>
+#include <cstdio>
+#else
+#include <stdint.h>
+#include <stdio.h>
+#endif
+
+#include "macro_utils/macro_utils.h"
+
+/*the hashes of hash.h, as smhasher sees them (a function of key, length and 32-bit seed)*/
+#define HASH_SMHASHER_FUNCTION_VALUES \
+    HASH_SMHASHER_FUNCTION_COMPUTE_HASH, \
+    HASH_SMHASHER_FUNCTION_COMPUTE_HASH_64, \
+    HASH_SMHASHER_FUNCTION_COMPUTE_HASH_SEEDED, \
+    HASH_SMHASHER_FUNCTION_STREAMING
+
+MU_DEFINE_ENUM(HASH_SMHASHER_FUNCTION, HASH_SMHASHER_FUNCTION_VALUES)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*every result is written to results as a line of JSON (and to stdout), so the results of 2 builds can be compared line by line*/
+
+/*runs the smhasher quality suites on function, returns the number of suites that failed*/
+uint32_t hash_smhasher_run_quality_suites(HASH_SMHASHER_FUNCTION function, FILE* results);
+
+/*bytes/cycle for keys of 4 B to 1 MB and latency (cycles per hash when every key depends on the previous hash) for keys of 1 to 32 bytes*/
+void hash_smhasher_measure_speed(HASH_SMHASHER_FUNCTION function, FILE* results);
+
+/*bytes/cycle of hash_compute_hash_batch for keys of 4 B to 1 MB*/
+void hash_smhasher_measure_batch_speed(FILE* results);
+
+/*hash_compute_hash_batch has the values of hash_compute_hash (so the quality suites of hash_compute_hash cover it), returns the number of keys that have a different value*/
+uint32_t hash_smhasher_check_batch_values(FILE* results);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HASH_SMHASHER_H */
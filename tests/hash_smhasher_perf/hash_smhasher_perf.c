@@ -0,0 +1,108 @@
+// Copyright (C) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <inttypes.h>
+
+#include "macro_utils/macro_utils.h"
+#include "testrunnerswitcher.h"
+
+#include "c_logging/logger.h"
+
+#include "c_pal/gballoc_hl.h"
+#include "c_pal/gballoc_hl_redirect.h"
+
+#include "hash_smhasher.h"
+
+/*one JSON object per line (in the working directory of the test), compare the files of 2 builds to see what changed*/
+#define HASH_SMHASHER_PERF_RESULTS_FILE_NAME "hash_smhasher_perf_results.jsonl"
+
+MU_DEFINE_ENUM_STRINGS(HASH_SMHASHER_FUNCTION, HASH_SMHASHER_FUNCTION_VALUES)
+
+static FILE* results;
+
+/*the constants of hash.cpp are only as good as these suites say, so a failed suite fails the test (and the build that changed them)*/
+static void run_quality_suites(HASH_SMHASHER_FUNCTION function)
+{
+    uint32_t failed_count = hash_smhasher_run_quality_suites(function, results);
+    ASSERT_ARE_EQUAL(uint32_t, 0, failed_count, "%" PRI_MU_ENUM " failed %" PRIu32 " smhasher suites, see %s", MU_ENUM_VALUE(HASH_SMHASHER_FUNCTION, function), failed_count, HASH_SMHASHER_PERF_RESULTS_FILE_NAME);
+}
+
+BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    ASSERT_ARE_EQUAL(int, 0, gballoc_hl_init(NULL, NULL));
+    results = fopen(HASH_SMHASHER_PERF_RESULTS_FILE_NAME, "w");
+    ASSERT_IS_NOT_NULL(results);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    (void)fclose(results);
+    LogInfo("hash_smhasher_perf results are in %s", HASH_SMHASHER_PERF_RESULTS_FILE_NAME);
+    gballoc_hl_deinit();
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+}
+
+TEST_FUNCTION(hash_smhasher_perf_speed_of_hash_compute_hash)
+{
+    hash_smhasher_measure_speed(HASH_SMHASHER_FUNCTION_COMPUTE_HASH, results);
+}
+
+TEST_FUNCTION(hash_smhasher_perf_speed_of_hash_compute_hash_batch)
+{
+    hash_smhasher_measure_batch_speed(results);
+}
+
+TEST_FUNCTION(hash_smhasher_perf_speed_of_hash_compute_hash_64)
+{
+    hash_smhasher_measure_speed(HASH_SMHASHER_FUNCTION_COMPUTE_HASH_64, results);
+}
+
+TEST_FUNCTION(hash_smhasher_perf_speed_of_hash_compute_hash_seeded)
+{
+    hash_smhasher_measure_speed(HASH_SMHASHER_FUNCTION_COMPUTE_HASH_SEEDED, results);
+}
+
+TEST_FUNCTION(hash_smhasher_perf_speed_of_hash_update)
+{
+    hash_smhasher_measure_speed(HASH_SMHASHER_FUNCTION_STREAMING, results);
+}
+
+TEST_FUNCTION(hash_smhasher_perf_quality_of_hash_compute_hash)
+{
+    run_quality_suites(HASH_SMHASHER_FUNCTION_COMPUTE_HASH);
+}
+
+/*hash_compute_hash_batch is not a function of a single key, it is checked to have the values of hash_compute_hash*/
+TEST_FUNCTION(hash_smhasher_perf_quality_of_hash_compute_hash_batch)
+{
+    ASSERT_ARE_EQUAL(uint32_t, 0, hash_smhasher_check_batch_values(results));
+}
+
+TEST_FUNCTION(hash_smhasher_perf_quality_of_hash_compute_hash_64)
+{
+    run_quality_suites(HASH_SMHASHER_FUNCTION_COMPUTE_HASH_64);
+}
+
+TEST_FUNCTION(hash_smhasher_perf_quality_of_hash_compute_hash_seeded)
+{
+    run_quality_suites(HASH_SMHASHER_FUNCTION_COMPUTE_HASH_SEEDED);
+}
+
+TEST_FUNCTION(hash_smhasher_perf_quality_of_hash_update)
+{
+    run_quality_suites(HASH_SMHASHER_FUNCTION_STREAMING);
+}
+
+END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
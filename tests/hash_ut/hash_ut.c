@@ -15,6 +15,78 @@ static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
 MOCK_FUNCTION_WITH_CODE(, uint32_t, MurmurHash2, const void*, key, int, len, uint32_t, seed)
 MOCK_FUNCTION_END(0x42)
 
+#define TEST_SEED 0x0123456789ABCDEFULL
+
+/*the 64-bit hashes of the first length bytes of the test content (byte i is i * 31 + 7), with seed 0 and with TEST_SEED. These values must never
+change: hashes are persisted*/
+static const struct
+{
+    size_t length;
+    uint64_t hash;
+    uint64_t seeded_hash;
+} expected_hashes[] =
+{
+    { 0, 0x0409638EE2BDE459ULL, 0x2B4E3DF129B1F482ULL },
+    { 1, 0xFDDEEEEA8CC2709CULL, 0x9238C26D4F1ABAE8ULL },
+    { 3, 0xAA4DADA6D17EEBB0ULL, 0xA1AEA1C588AAADBBULL },
+    { 4, 0x8D9D4657E96CC294ULL, 0x0F7AFA8710DA7E08ULL },
+    { 8, 0x9654832F28858268ULL, 0x261D186451A89FADULL },
+    { 16, 0x36B53F8551944DB0ULL, 0x5EEF37151B6C191CULL },
+    { 17, 0x904849BDD1E93C7CULL, 0x3666B60A397C36CFULL },
+    { 48, 0x3EC1B034DBE02BD7ULL, 0x01D882DD10C0F235ULL },
+    { 49, 0x30161CB91C8DF53EULL, 0xDCFEDFFA0F32435FULL },
+    { 128, 0x4329D1A474B869F6ULL, 0x4019BB0550939145ULL },
+    { 256, 0xE4E465A228B2D552ULL, 0x0A69D252EF011D5FULL },
+    { 257, 0x88AEC6715C6A6EF7ULL, 0x463F1D7B69DCFD29ULL },
+    { 1024, 0xF36523A1E7733C43ULL, 0x86CF26740D62920DULL },
+    { 1025, 0x8F083AD657513A26ULL, 0x25B380E44A6E4A61ULL },
+    { 4096, 0x4579BB34A64BDDD1ULL, 0x5FF8E84C15FCD238ULL }
+};
+
+/*MurmurHash2 with seed 0 (the value of hash_compute_hash) of the first length bytes of the test content. The lengths are around the 4 byte blocks and
+the 16 byte chunks hash_compute_hash_batch loads*/
+static const struct
+{
+    size_t length;
+    uint32_t hash;
+} expected_murmur_hashes[] =
+{
+    { 1, 0xDAB59DE1U },
+    { 2, 0x9028A547U },
+    { 3, 0xD7DD2A23U },
+    { 4, 0xB63C0CE1U },
+    { 5, 0x236B7AE7U },
+    { 7, 0x147815A4U },
+    { 8, 0x6644E460U },
+    { 9, 0x654BEF2BU },
+    { 15, 0x4AD194FFU },
+    { 16, 0x48F97BBBU },
+    { 17, 0x31FA9218U },
+    { 20, 0xB9D37829U },
+    { 31, 0x6D8ADEABU },
+    { 32, 0x35A3C076U },
+    { 33, 0xA72B1870U },
+    { 47, 0x2A2FB5EEU },
+    { 63, 0x0C1FA855U },
+    { 64, 0xED320E27U },
+    { 65, 0x7E239269U },
+    { 100, 0x35D771A3U },
+    { 257, 0x498A2122U },
+    { 1000, 0x21A0DE41U }
+};
+
+#define EXPECTED_MURMUR_HASH_COUNT (sizeof(expected_murmur_hashes) / sizeof(expected_murmur_hashes[0]))
+
+static unsigned char test_content[4096 + 8];
+
+static void fill_test_content(unsigned char* destination, size_t size)
+{
+    for (size_t i = 0; i < size; i++)
+    {
+        destination[i] = (unsigned char)(i * 31 + 7);
+    }
+}
+
 BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
 
 TEST_SUITE_INITIALIZE(suite_init)
@@ -22,6 +94,8 @@ TEST_SUITE_INITIALIZE(suite_init)
     ASSERT_ARE_EQUAL(int, 0, umock_c_init(on_umock_c_error), "umock_c_init");
 
     ASSERT_ARE_EQUAL(int, 0, umocktypes_stdint_register_types(), "umocktypes_stdint_register_types");
+
+    fill_test_content(test_content, sizeof(test_content));
 }
 
 TEST_SUITE_CLEANUP(suite_cleanup)
@@ -139,4 +213,652 @@ TEST_FUNCTION(hash_compute_hash_with_INT_MAX_plus_1_fails)
 }
 #endif
 
+/* hash_compute_hash_batch */
+
+/* Tests_SRS_HASH_12_018: [ If keys is NULL, hash_compute_hash_batch shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(hash_compute_hash_batch_with_NULL_keys_fails)
+{
+    // arrange
+    size_t length = 1;
+    uint32_t hash;
+    int result;
+
+    // act
+    result = hash_compute_hash_batch(NULL, &length, 1, &hash);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/* Tests_SRS_HASH_12_019: [ If lengths is NULL, hash_compute_hash_batch shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(hash_compute_hash_batch_with_NULL_lengths_fails)
+{
+    // arrange
+    const void* key = test_content;
+    uint32_t hash;
+    int result;
+
+    // act
+    result = hash_compute_hash_batch(&key, NULL, 1, &hash);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/* Tests_SRS_HASH_12_020: [ If hashes is NULL, hash_compute_hash_batch shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(hash_compute_hash_batch_with_NULL_hashes_fails)
+{
+    // arrange
+    const void* key = test_content;
+    size_t length = 1;
+    int result;
+
+    // act
+    result = hash_compute_hash_batch(&key, &length, 1, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/* Tests_SRS_HASH_12_021: [ If any of the keys is NULL or any of the lengths is 0 or greater than or equal to INT_MAX, hash_compute_hash_batch shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(hash_compute_hash_batch_with_a_NULL_key_fails)
+{
+    // arrange
+    const void* keys[3] = { test_content, NULL, test_content };
+    size_t lengths[3] = { 1, 1, 1 };
+    uint32_t hashes[3];
+    int result;
+
+    // act
+    result = hash_compute_hash_batch(keys, lengths, 3, hashes);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/* Tests_SRS_HASH_12_021: [ If any of the keys is NULL or any of the lengths is 0 or greater than or equal to INT_MAX, hash_compute_hash_batch shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(hash_compute_hash_batch_with_a_0_length_fails)
+{
+    // arrange
+    const void* keys[3] = { test_content, test_content, test_content };
+    size_t lengths[3] = { 1, 1, 0 };
+    uint32_t hashes[3];
+    int result;
+
+    // act
+    result = hash_compute_hash_batch(keys, lengths, 3, hashes);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/* Tests_SRS_HASH_12_021: [ If any of the keys is NULL or any of the lengths is 0 or greater than or equal to INT_MAX, hash_compute_hash_batch shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(hash_compute_hash_batch_with_an_INT_MAX_length_fails)
+{
+    // arrange
+    const void* keys[3] = { test_content, test_content, test_content };
+    size_t lengths[3] = { (size_t)INT_MAX, 1, 1 };
+    uint32_t hashes[3];
+    int result;
+
+    // act
+    result = hash_compute_hash_batch(keys, lengths, 3, hashes);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/* Tests_SRS_HASH_12_023: [ On success hash_compute_hash_batch shall return 0. ]*/
+TEST_FUNCTION(hash_compute_hash_batch_with_0_keys_succeeds)
+{
+    // arrange
+    const void* key = test_content;
+    size_t length = 1;
+    uint32_t hash = 0x42;
+    int result;
+
+    // act
+    result = hash_compute_hash_batch(&key, &length, 0, &hash);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 0x42, hash);
+}
+
+/* Tests_SRS_HASH_12_022: [ hash_compute_hash_batch shall fill in hashes[i] the value that hash_compute_hash computes for keys[i] and lengths[i] (MurmurHash2 with seed 0), for every i less than count, mixing several keys at once in SIMD lanes when the CPU supports it. ]*/
+/* Tests_SRS_HASH_12_023: [ On success hash_compute_hash_batch shall return 0. ]*/
+TEST_FUNCTION(hash_compute_hash_batch_returns_the_MurmurHash2_values)
+{
+    // arrange
+    const void* keys[EXPECTED_MURMUR_HASH_COUNT];
+    size_t lengths[EXPECTED_MURMUR_HASH_COUNT];
+    uint32_t hashes[EXPECTED_MURMUR_HASH_COUNT];
+    int result;
+    for (size_t i = 0; i < EXPECTED_MURMUR_HASH_COUNT; i++)
+    {
+        keys[i] = test_content;
+        lengths[i] = expected_murmur_hashes[i].length;
+    }
+
+    // act
+    result = hash_compute_hash_batch(keys, lengths, EXPECTED_MURMUR_HASH_COUNT, hashes);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    for (size_t i = 0; i < EXPECTED_MURMUR_HASH_COUNT; i++)
+    {
+        ASSERT_ARE_EQUAL(uint32_t, expected_murmur_hashes[i].hash, hashes[i], "length=%zu", lengths[i]);
+    }
+}
+
+/* Tests_SRS_HASH_12_022: [ hash_compute_hash_batch shall fill in hashes[i] the value that hash_compute_hash computes for keys[i] and lengths[i] (MurmurHash2 with seed 0), for every i less than count, mixing several keys at once in SIMD lanes when the CPU supports it. ]*/
+TEST_FUNCTION(hash_compute_hash_batch_returns_the_MurmurHash2_values_in_any_order_and_count)
+{
+    for (size_t count = 1; count <= EXPECTED_MURMUR_HASH_COUNT; count++)
+    {
+        for (size_t first = 0; first < EXPECTED_MURMUR_HASH_COUNT; first++)
+        {
+            // arrange
+            /*each length next to different lengths and in every lane*/
+            const void* keys[EXPECTED_MURMUR_HASH_COUNT];
+            size_t lengths[EXPECTED_MURMUR_HASH_COUNT];
+            uint32_t hashes[EXPECTED_MURMUR_HASH_COUNT];
+            for (size_t i = 0; i < count; i++)
+            {
+                keys[i] = test_content;
+                lengths[i] = expected_murmur_hashes[(first + i * 7) % EXPECTED_MURMUR_HASH_COUNT].length;
+            }
+
+            // act
+            int result = hash_compute_hash_batch(keys, lengths, count, hashes);
+
+            // assert
+            ASSERT_ARE_EQUAL(int, 0, result);
+            for (size_t i = 0; i < count; i++)
+            {
+                ASSERT_ARE_EQUAL(uint32_t, expected_murmur_hashes[(first + i * 7) % EXPECTED_MURMUR_HASH_COUNT].hash, hashes[i], "count=%zu, first=%zu, i=%zu", count, first, i);
+            }
+        }
+    }
+}
+
+/* Tests_SRS_HASH_12_022: [ hash_compute_hash_batch shall fill in hashes[i] the value that hash_compute_hash computes for keys[i] and lengths[i] (MurmurHash2 with seed 0), for every i less than count, mixing several keys at once in SIMD lanes when the CPU supports it. ]*/
+TEST_FUNCTION(hash_compute_hash_batch_with_keys_of_the_same_length_returns_the_MurmurHash2_values)
+{
+    for (size_t j = 0; j < EXPECTED_MURMUR_HASH_COUNT; j++)
+    {
+        // arrange
+        const void* keys[17];
+        size_t lengths[17];
+        uint32_t hashes[17];
+        for (size_t i = 0; i < 17; i++)
+        {
+            keys[i] = test_content;
+            lengths[i] = expected_murmur_hashes[j].length;
+        }
+
+        // act
+        int result = hash_compute_hash_batch(keys, lengths, 17, hashes);
+
+        // assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        for (size_t i = 0; i < 17; i++)
+        {
+            ASSERT_ARE_EQUAL(uint32_t, expected_murmur_hashes[j].hash, hashes[i], "length=%zu, i=%zu", lengths[i], i);
+        }
+    }
+}
+
+/* Tests_SRS_HASH_12_022: [ hash_compute_hash_batch shall fill in hashes[i] the value that hash_compute_hash computes for keys[i] and lengths[i] (MurmurHash2 with seed 0), for every i less than count, mixing several keys at once in SIMD lanes when the CPU supports it. ]*/
+TEST_FUNCTION(hash_compute_hash_batch_does_not_read_outside_of_the_keys)
+{
+    // arrange
+    /*every key in its own allocation of exactly its length, so that a read past its end (or before its start) is caught by the memory checkers*/
+    const void* keys[EXPECTED_MURMUR_HASH_COUNT];
+    size_t lengths[EXPECTED_MURMUR_HASH_COUNT];
+    uint32_t hashes[EXPECTED_MURMUR_HASH_COUNT];
+    for (size_t i = 0; i < EXPECTED_MURMUR_HASH_COUNT; i++)
+    {
+        unsigned char* key = malloc(expected_murmur_hashes[i].length);
+        ASSERT_IS_NOT_NULL(key);
+        (void)memcpy(key, test_content, expected_murmur_hashes[i].length);
+        keys[i] = key;
+        lengths[i] = expected_murmur_hashes[i].length;
+    }
+
+    // act
+    int result = hash_compute_hash_batch(keys, lengths, EXPECTED_MURMUR_HASH_COUNT, hashes);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    for (size_t i = 0; i < EXPECTED_MURMUR_HASH_COUNT; i++)
+    {
+        ASSERT_ARE_EQUAL(uint32_t, expected_murmur_hashes[i].hash, hashes[i], "length=%zu", lengths[i]);
+    }
+
+    // clean
+    for (size_t i = 0; i < EXPECTED_MURMUR_HASH_COUNT; i++)
+    {
+        free((void*)keys[i]);
+    }
+}
+
+/* hash_compute_hash_64 */
+
+/* Tests_SRS_HASH_12_001: [ If buffer is NULL and length is not 0, hash_compute_hash_64 shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(hash_compute_hash_64_with_NULL_buffer_fails)
+{
+    // arrange
+    uint64_t hash;
+    int result;
+
+    // act
+    result = hash_compute_hash_64(NULL, 1, &hash);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/* Tests_SRS_HASH_12_002: [ If hash is NULL, hash_compute_hash_64 shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(hash_compute_hash_64_with_NULL_hash_pointer_fails)
+{
+    // arrange
+    int result;
+
+    // act
+    result = hash_compute_hash_64(test_content, 1, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/* Tests_SRS_HASH_12_003: [ hash_compute_hash_64 shall fill in hash the 64-bit hash of the length bytes at buffer with seed 0 (the same value as hash_compute_hash_seeded with seed 0). ]*/
+/* Tests_SRS_HASH_12_004: [ On success hash_compute_hash_64 shall return 0. ]*/
+TEST_FUNCTION(hash_compute_hash_64_with_NULL_buffer_and_0_length_succeeds)
+{
+    // arrange
+    uint64_t hash;
+    int result;
+
+    // act
+    result = hash_compute_hash_64(NULL, 0, &hash);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint64_t, expected_hashes[0].hash, hash);
+}
+
+/* Tests_SRS_HASH_12_003: [ hash_compute_hash_64 shall fill in hash the 64-bit hash of the length bytes at buffer with seed 0 (the same value as hash_compute_hash_seeded with seed 0). ]*/
+/* Tests_SRS_HASH_12_004: [ On success hash_compute_hash_64 shall return 0. ]*/
+TEST_FUNCTION(hash_compute_hash_64_returns_the_expected_values)
+{
+    for (size_t i = 0; i < sizeof(expected_hashes) / sizeof(expected_hashes[0]); i++)
+    {
+        // arrange
+        uint64_t hash;
+        int result;
+
+        // act
+        result = hash_compute_hash_64(test_content, expected_hashes[i].length, &hash);
+
+        // assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(uint64_t, expected_hashes[i].hash, hash, "length=%zu", expected_hashes[i].length);
+    }
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_HASH_12_003: [ hash_compute_hash_64 shall fill in hash the 64-bit hash of the length bytes at buffer with seed 0 (the same value as hash_compute_hash_seeded with seed 0). ]*/
+TEST_FUNCTION(hash_compute_hash_64_does_not_depend_on_the_alignment_of_the_buffer)
+{
+    for (size_t i = 0; i < sizeof(expected_hashes) / sizeof(expected_hashes[0]); i++)
+    {
+        for (size_t offset = 1; offset < 8; offset++)
+        {
+            // arrange
+            unsigned char buffer[4096 + 8];
+            uint64_t hash;
+            fill_test_content(buffer + offset, expected_hashes[i].length);
+
+            // act
+            int result = hash_compute_hash_64(buffer + offset, expected_hashes[i].length, &hash);
+
+            // assert
+            ASSERT_ARE_EQUAL(int, 0, result);
+            ASSERT_ARE_EQUAL(uint64_t, expected_hashes[i].hash, hash, "length=%zu, offset=%zu", expected_hashes[i].length, offset);
+        }
+    }
+}
+
+/* Tests_SRS_HASH_12_003: [ hash_compute_hash_64 shall fill in hash the 64-bit hash of the length bytes at buffer with seed 0 (the same value as hash_compute_hash_seeded with seed 0). ]*/
+TEST_FUNCTION(hash_compute_hash_64_changes_when_any_byte_changes)
+{
+    static const size_t lengths[] = { 3, 16, 100, 1025 };
+    for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++)
+    {
+        // arrange
+        uint64_t original_hash;
+        ASSERT_ARE_EQUAL(int, 0, hash_compute_hash_64(test_content, lengths[i], &original_hash));
+
+        for (size_t position = 0; position < lengths[i]; position++)
+        {
+            uint64_t hash;
+            test_content[position] ^= 0x01;
+
+            // act
+            int result = hash_compute_hash_64(test_content, lengths[i], &hash);
+
+            // assert
+            test_content[position] ^= 0x01;
+            ASSERT_ARE_EQUAL(int, 0, result);
+            ASSERT_ARE_NOT_EQUAL(uint64_t, original_hash, hash, "length=%zu, position=%zu", lengths[i], position);
+        }
+    }
+}
+
+/* hash_compute_hash_seeded */
+
+/* Tests_SRS_HASH_12_005: [ If buffer is NULL and length is not 0, hash_compute_hash_seeded shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(hash_compute_hash_seeded_with_NULL_buffer_fails)
+{
+    // arrange
+    uint64_t hash;
+    int result;
+
+    // act
+    result = hash_compute_hash_seeded(NULL, 1, TEST_SEED, &hash);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/* Tests_SRS_HASH_12_006: [ If hash is NULL, hash_compute_hash_seeded shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(hash_compute_hash_seeded_with_NULL_hash_pointer_fails)
+{
+    // arrange
+    int result;
+
+    // act
+    result = hash_compute_hash_seeded(test_content, 1, TEST_SEED, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/* Tests_SRS_HASH_12_007: [ hash_compute_hash_seeded shall fill in hash the 64-bit hash of the length bytes at buffer with seed. ]*/
+/* Tests_SRS_HASH_12_008: [ On success hash_compute_hash_seeded shall return 0. ]*/
+TEST_FUNCTION(hash_compute_hash_seeded_returns_the_expected_values)
+{
+    for (size_t i = 0; i < sizeof(expected_hashes) / sizeof(expected_hashes[0]); i++)
+    {
+        // arrange
+        uint64_t hash;
+        int result;
+
+        // act
+        result = hash_compute_hash_seeded(test_content, expected_hashes[i].length, TEST_SEED, &hash);
+
+        // assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(uint64_t, expected_hashes[i].seeded_hash, hash, "length=%zu", expected_hashes[i].length);
+    }
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_HASH_12_003: [ hash_compute_hash_64 shall fill in hash the 64-bit hash of the length bytes at buffer with seed 0 (the same value as hash_compute_hash_seeded with seed 0). ]*/
+/* Tests_SRS_HASH_12_007: [ hash_compute_hash_seeded shall fill in hash the 64-bit hash of the length bytes at buffer with seed. ]*/
+TEST_FUNCTION(hash_compute_hash_seeded_with_seed_0_is_hash_compute_hash_64)
+{
+    for (size_t i = 0; i < sizeof(expected_hashes) / sizeof(expected_hashes[0]); i++)
+    {
+        // arrange
+        uint64_t hash;
+        int result;
+
+        // act
+        result = hash_compute_hash_seeded(test_content, expected_hashes[i].length, 0, &hash);
+
+        // assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(uint64_t, expected_hashes[i].hash, hash, "length=%zu", expected_hashes[i].length);
+    }
+}
+
+/* Tests_SRS_HASH_12_007: [ hash_compute_hash_seeded shall fill in hash the 64-bit hash of the length bytes at buffer with seed. ]*/
+TEST_FUNCTION(hash_compute_hash_seeded_with_different_seeds_returns_different_values)
+{
+    static const size_t lengths[] = { 0, 8, 100, 1025 };
+    for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++)
+    {
+        // arrange
+        uint64_t hash_1;
+        uint64_t hash_2;
+
+        // act
+        ASSERT_ARE_EQUAL(int, 0, hash_compute_hash_seeded(test_content, lengths[i], 1, &hash_1));
+        ASSERT_ARE_EQUAL(int, 0, hash_compute_hash_seeded(test_content, lengths[i], 2, &hash_2));
+
+        // assert
+        ASSERT_ARE_NOT_EQUAL(uint64_t, hash_1, hash_2, "length=%zu", lengths[i]);
+    }
+}
+
+/* hash_init */
+
+/* Tests_SRS_HASH_12_009: [ If state is NULL, hash_init shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(hash_init_with_NULL_state_fails)
+{
+    // arrange
+    int result;
+
+    // act
+    result = hash_init(NULL, TEST_SEED);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/* Tests_SRS_HASH_12_010: [ hash_init shall initialize state for hashing 0 bytes with seed and return 0. ]*/
+/* Tests_SRS_HASH_12_016: [ hash_final shall fill in hash the value that hash_compute_hash_seeded returns for all the bytes added to state (in order, regardless of how they were split in calls to hash_update) and the seed of state, and return 0. ]*/
+TEST_FUNCTION(hash_init_succeeds)
+{
+    // arrange
+    HASH_STATE state;
+    uint64_t hash;
+    int result;
+
+    // act
+    result = hash_init(&state, TEST_SEED);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(int, 0, hash_final(&state, &hash));
+    ASSERT_ARE_EQUAL(uint64_t, expected_hashes[0].seeded_hash, hash);
+}
+
+/* hash_update */
+
+/* Tests_SRS_HASH_12_011: [ If state is NULL, hash_update shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(hash_update_with_NULL_state_fails)
+{
+    // arrange
+    int result;
+
+    // act
+    result = hash_update(NULL, test_content, 1);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/* Tests_SRS_HASH_12_012: [ If buffer is NULL and length is not 0, hash_update shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(hash_update_with_NULL_buffer_fails)
+{
+    // arrange
+    HASH_STATE state;
+    int result;
+    ASSERT_ARE_EQUAL(int, 0, hash_init(&state, 0));
+
+    // act
+    result = hash_update(&state, NULL, 1);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/* Tests_SRS_HASH_12_013: [ hash_update shall add the length bytes at buffer to the bytes hashed by state and return 0. ]*/
+TEST_FUNCTION(hash_update_with_NULL_buffer_and_0_length_succeeds)
+{
+    // arrange
+    HASH_STATE state;
+    uint64_t hash;
+    int result;
+    ASSERT_ARE_EQUAL(int, 0, hash_init(&state, 0));
+
+    // act
+    result = hash_update(&state, NULL, 0);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(int, 0, hash_final(&state, &hash));
+    ASSERT_ARE_EQUAL(uint64_t, expected_hashes[0].hash, hash);
+}
+
+/* Tests_SRS_HASH_12_013: [ hash_update shall add the length bytes at buffer to the bytes hashed by state and return 0. ]*/
+/* Tests_SRS_HASH_12_016: [ hash_final shall fill in hash the value that hash_compute_hash_seeded returns for all the bytes added to state (in order, regardless of how they were split in calls to hash_update) and the seed of state, and return 0. ]*/
+TEST_FUNCTION(hash_update_in_chunks_of_any_size_gives_the_expected_values)
+{
+    /*around the stripe size and the size of the buffer of the state*/
+    static const size_t chunk_sizes[] = { 1, 3, 63, 64, 65, 255, 256, 257, 1000, 5000 };
+    for (size_t i = 0; i < sizeof(expected_hashes) / sizeof(expected_hashes[0]); i++)
+    {
+        for (size_t j = 0; j < sizeof(chunk_sizes) / sizeof(chunk_sizes[0]); j++)
+        {
+            // arrange
+            HASH_STATE state;
+            HASH_STATE seeded_state;
+            uint64_t hash;
+            uint64_t seeded_hash;
+            ASSERT_ARE_EQUAL(int, 0, hash_init(&state, 0));
+            ASSERT_ARE_EQUAL(int, 0, hash_init(&seeded_state, TEST_SEED));
+
+            // act
+            for (size_t offset = 0; offset < expected_hashes[i].length; offset += chunk_sizes[j])
+            {
+                size_t chunk_size = (expected_hashes[i].length - offset < chunk_sizes[j]) ? expected_hashes[i].length - offset : chunk_sizes[j];
+                ASSERT_ARE_EQUAL(int, 0, hash_update(&state, test_content + offset, chunk_size));
+                ASSERT_ARE_EQUAL(int, 0, hash_update(&seeded_state, test_content + offset, chunk_size));
+            }
+
+            // assert
+            ASSERT_ARE_EQUAL(int, 0, hash_final(&state, &hash));
+            ASSERT_ARE_EQUAL(int, 0, hash_final(&seeded_state, &seeded_hash));
+            ASSERT_ARE_EQUAL(uint64_t, expected_hashes[i].hash, hash, "length=%zu, chunk_size=%zu", expected_hashes[i].length, chunk_sizes[j]);
+            ASSERT_ARE_EQUAL(uint64_t, expected_hashes[i].seeded_hash, seeded_hash, "length=%zu, chunk_size=%zu", expected_hashes[i].length, chunk_sizes[j]);
+        }
+    }
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_HASH_12_013: [ hash_update shall add the length bytes at buffer to the bytes hashed by state and return 0. ]*/
+/* Tests_SRS_HASH_12_016: [ hash_final shall fill in hash the value that hash_compute_hash_seeded returns for all the bytes added to state (in order, regardless of how they were split in calls to hash_update) and the seed of state, and return 0. ]*/
+TEST_FUNCTION(hash_update_in_chunks_of_different_sizes_gives_the_expected_value)
+{
+    // arrange
+    static const size_t chunk_sizes[] = { 10, 300, 1, 64, 700, 2, 128, 1000, 255, 1 };
+    size_t length = 0;
+    HASH_STATE state;
+    uint64_t hash;
+    uint64_t expected_hash;
+    ASSERT_ARE_EQUAL(int, 0, hash_init(&state, TEST_SEED));
+
+    // act
+    for (size_t i = 0; i < sizeof(chunk_sizes) / sizeof(chunk_sizes[0]); i++)
+    {
+        ASSERT_ARE_EQUAL(int, 0, hash_update(&state, test_content + length, chunk_sizes[i]));
+        length += chunk_sizes[i];
+    }
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, hash_final(&state, &hash));
+    ASSERT_ARE_EQUAL(int, 0, hash_compute_hash_seeded(test_content, length, TEST_SEED, &expected_hash));
+    ASSERT_ARE_EQUAL(uint64_t, expected_hash, hash);
+}
+
+/* hash_final */
+
+/* Tests_SRS_HASH_12_014: [ If state is NULL, hash_final shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(hash_final_with_NULL_state_fails)
+{
+    // arrange
+    uint64_t hash;
+    int result;
+
+    // act
+    result = hash_final(NULL, &hash);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/* Tests_SRS_HASH_12_015: [ If hash is NULL, hash_final shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(hash_final_with_NULL_hash_pointer_fails)
+{
+    // arrange
+    HASH_STATE state;
+    int result;
+    ASSERT_ARE_EQUAL(int, 0, hash_init(&state, 0));
+
+    // act
+    result = hash_final(&state, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/* Tests_SRS_HASH_12_017: [ hash_final shall not change state. ]*/
+TEST_FUNCTION(hash_final_does_not_change_the_state)
+{
+    // arrange
+    static const size_t lengths[] = { 100, 200, 1000, 1030 };
+    size_t length = 0;
+    HASH_STATE state;
+    ASSERT_ARE_EQUAL(int, 0, hash_init(&state, TEST_SEED));
+
+    for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++)
+    {
+        uint64_t hash;
+        uint64_t expected_hash;
+        ASSERT_ARE_EQUAL(int, 0, hash_update(&state, test_content + length, lengths[i] - length));
+        length = lengths[i];
+
+        // act
+        ASSERT_ARE_EQUAL(int, 0, hash_final(&state, &hash));
+
+        // assert
+        ASSERT_ARE_EQUAL(int, 0, hash_compute_hash_seeded(test_content, length, TEST_SEED, &expected_hash));
+        ASSERT_ARE_EQUAL(uint64_t, expected_hash, hash, "length=%zu", length);
+    }
+}
+
 END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
@@ -9,6 +9,7 @@
 #include <stdlib.h>
 #include <stdint.h>
 #include <limits.h>
+#include <string.h>
 
 #include "macro_utils/macro_utils.h"
 #include "testrunnerswitcher.h"
@@ -0,0 +1,210 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "macro_utils/macro_utils.h"
+#include "testrunnerswitcher.h"
+
+#include "c_logging/logger.h"
+
+#include "c_pal/gballoc_hl.h"
+#include "c_pal/gballoc_hl_redirect.h"
+#include "c_pal/timer.h"
+
+#include "c_util/lz_codec.h"
+#include "c_util/constbuffer.h"
+#include "c_util/constbuffer_array.h"
+
+#define PAYLOAD_SIZE (4 * 1024 * 1024)
+#define SEGMENT_SIZE (64 * 1024)
+#define ITERATIONS 20
+
+static void fill_json_like(unsigned char* destination, uint32_t size)
+{
+    uint32_t written = 0;
+    uint32_t record = 0;
+    while (written < size)
+    {
+        char line[256];
+        int line_length = snprintf(line, sizeof(line), "{\"id\":%" PRIu32 ",\"partition\":\"p-%" PRIu32 "\",\"status\":\"%s\",\"sequence_number\":%" PRIu32 ",\"properties\":{\"source\":\"device-%" PRIu32 "\"}}\n",
+            record, record % 16, ((record % 3) == 0) ? "committed" : "pending", record * 7, record % 1000);
+        ASSERT_IS_TRUE(line_length > 0);
+        uint32_t to_copy = ((uint32_t)line_length < size - written) ? (uint32_t)line_length : size - written;
+        (void)memcpy(destination + written, line, to_copy);
+        written += to_copy;
+        record++;
+    }
+}
+
+static void fill_records(unsigned char* destination, uint32_t size)
+{
+    /*fixed size binary records where only a counter and a small field change*/
+    for (uint32_t i = 0; i < size; i++)
+    {
+        uint32_t record = i / 32;
+        uint32_t field = i % 32;
+        destination[i] = (field < 4) ? (unsigned char)(record >> (8 * field)) : (field < 8) ? (unsigned char)(record % 7) : (unsigned char)field;
+    }
+}
+
+static void fill_random(unsigned char* destination, uint32_t size)
+{
+    uint32_t seed = 0x12345678;
+    for (uint32_t i = 0; i < size; i++)
+    {
+        seed = seed * 1103515245 + 12345;
+        destination[i] = (unsigned char)(seed >> 16);
+    }
+}
+
+static void measure_lz_codec(const char* payload_name, void(*fill)(unsigned char*, uint32_t))
+{
+    unsigned char* source = malloc(PAYLOAD_SIZE);
+    ASSERT_IS_NOT_NULL(source);
+    uint32_t bound = lz_codec_compress_bound(PAYLOAD_SIZE);
+    unsigned char* compressed = malloc(bound);
+    ASSERT_IS_NOT_NULL(compressed);
+    unsigned char* decompressed = malloc(PAYLOAD_SIZE);
+    ASSERT_IS_NOT_NULL(decompressed);
+    fill(source, PAYLOAD_SIZE);
+
+    uint32_t compressed_size = 0;
+    double start = timer_global_get_elapsed_ms();
+    for (uint32_t i = 0; i < ITERATIONS; i++)
+    {
+        ASSERT_ARE_EQUAL(int, 0, lz_codec_compress(source, PAYLOAD_SIZE, compressed, bound, &compressed_size));
+    }
+    double compress_ms = timer_global_get_elapsed_ms() - start;
+
+    start = timer_global_get_elapsed_ms();
+    for (uint32_t i = 0; i < ITERATIONS; i++)
+    {
+        ASSERT_ARE_EQUAL(int, 0, lz_codec_decompress(compressed, compressed_size, decompressed, PAYLOAD_SIZE));
+    }
+    double decompress_ms = timer_global_get_elapsed_ms() - start;
+
+    ASSERT_ARE_EQUAL(int, 0, memcmp(source, decompressed, PAYLOAD_SIZE));
+
+    double megabytes = (double)PAYLOAD_SIZE * ITERATIONS / (1024.0 * 1024.0);
+    LogInfo("lz_codec %s: %" PRIu32 " bytes -> %" PRIu32 " bytes (ratio %.2f), compress %.1f MB/s, decompress %.1f MB/s",
+        payload_name, (uint32_t)PAYLOAD_SIZE, compressed_size, (double)PAYLOAD_SIZE / compressed_size,
+        megabytes * 1000.0 / compress_ms, megabytes * 1000.0 / decompress_ms);
+
+    free(decompressed);
+    free(compressed);
+    free(source);
+}
+
+static void measure_constbuffer_array(const char* payload_name, void(*fill)(unsigned char*, uint32_t))
+{
+    unsigned char* source = malloc(PAYLOAD_SIZE);
+    ASSERT_IS_NOT_NULL(source);
+    fill(source, PAYLOAD_SIZE);
+
+    CONSTBUFFER_HANDLE buffers[PAYLOAD_SIZE / SEGMENT_SIZE];
+    for (uint32_t i = 0; i < PAYLOAD_SIZE / SEGMENT_SIZE; i++)
+    {
+        buffers[i] = CONSTBUFFER_Create(source + i * SEGMENT_SIZE, SEGMENT_SIZE);
+        ASSERT_IS_NOT_NULL(buffers[i]);
+    }
+    CONSTBUFFER_ARRAY_HANDLE original = constbuffer_array_create(buffers, PAYLOAD_SIZE / SEGMENT_SIZE);
+    ASSERT_IS_NOT_NULL(original);
+    for (uint32_t i = 0; i < PAYLOAD_SIZE / SEGMENT_SIZE; i++)
+    {
+        CONSTBUFFER_DecRef(buffers[i]);
+    }
+
+    CONSTBUFFER_ARRAY_HANDLE compressed = NULL;
+    double start = timer_global_get_elapsed_ms();
+    for (uint32_t i = 0; i < ITERATIONS; i++)
+    {
+        if (compressed != NULL)
+        {
+            constbuffer_array_dec_ref(compressed);
+        }
+        compressed = constbuffer_array_create_compressed(original);
+        ASSERT_IS_NOT_NULL(compressed);
+    }
+    double compress_ms = timer_global_get_elapsed_ms() - start;
+
+    CONSTBUFFER_ARRAY_HANDLE decompressed = NULL;
+    start = timer_global_get_elapsed_ms();
+    for (uint32_t i = 0; i < ITERATIONS; i++)
+    {
+        if (decompressed != NULL)
+        {
+            constbuffer_array_dec_ref(decompressed);
+        }
+        decompressed = constbuffer_array_create_decompressed(compressed);
+        ASSERT_IS_NOT_NULL(decompressed);
+    }
+    double decompress_ms = timer_global_get_elapsed_ms() - start;
+
+    ASSERT_IS_TRUE(CONSTBUFFER_ARRAY_HANDLE_contain_same(original, decompressed));
+
+    uint32_t compressed_size;
+    ASSERT_ARE_EQUAL(int, 0, constbuffer_array_get_all_buffers_size(compressed, &compressed_size));
+
+    double megabytes = (double)PAYLOAD_SIZE * ITERATIONS / (1024.0 * 1024.0);
+    LogInfo("constbuffer_array %s (%" PRIu32 " byte segments): %" PRIu32 " bytes -> %" PRIu32 " bytes (ratio %.2f), compress %.1f MB/s, decompress %.1f MB/s",
+        payload_name, (uint32_t)SEGMENT_SIZE, (uint32_t)PAYLOAD_SIZE, compressed_size, (double)PAYLOAD_SIZE / compressed_size,
+        megabytes * 1000.0 / compress_ms, megabytes * 1000.0 / decompress_ms);
+
+    constbuffer_array_dec_ref(decompressed);
+    constbuffer_array_dec_ref(compressed);
+    constbuffer_array_dec_ref(original);
+    free(source);
+}
+
+BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    ASSERT_ARE_EQUAL(int, 0, gballoc_hl_init(NULL, NULL));
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    gballoc_hl_deinit();
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+}
+
+TEST_FUNCTION(lz_codec_perf_json_like_payload)
+{
+    measure_lz_codec("json-like", fill_json_like);
+}
+
+TEST_FUNCTION(lz_codec_perf_record_payload)
+{
+    measure_lz_codec("records", fill_records);
+}
+
+TEST_FUNCTION(lz_codec_perf_random_payload)
+{
+    measure_lz_codec("random", fill_random);
+}
+
+TEST_FUNCTION(lz_codec_perf_constbuffer_array_json_like_payload)
+{
+    measure_constbuffer_array("json-like", fill_json_like);
+}
+
+TEST_FUNCTION(lz_codec_perf_constbuffer_array_random_payload)
+{
+    measure_constbuffer_array("random", fill_random);
+}
+
+END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
@@ -0,0 +1,624 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "lz_codec_ut_pch.h"
+
+MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    ASSERT_FAIL("umock_c reported error :%" PRI_MU_ENUM "", MU_ENUM_VALUE(UMOCK_C_ERROR_CODE, error_code));
+}
+
+/*20 times 'a' is 1 literal + a match of 14 bytes at offset 1 followed by the 5 last literals*/
+static const unsigned char twenty_a[] = "aaaaaaaaaaaaaaaaaaaa";
+static const unsigned char twenty_a_compressed[] = { 0x1A, 'a', 0x01, 0x00, 0x50, 'a', 'a', 'a', 'a', 'a' };
+
+static unsigned char text_bytes[10000]; /*repeated words, compressible*/
+static unsigned char random_bytes[10000]; /*not compressible*/
+
+static void fill_test_bytes(void)
+{
+    static const char* words[] = { "{\"id\":", "\"name\":\"", "value", "}, ", "timestamp", "\"status\":\"ok\"", "12345", "abc" };
+    uint32_t seed = 42;
+    size_t i = 0;
+    while (i < sizeof(text_bytes))
+    {
+        seed = seed * 1103515245 + 12345;
+        for (const char* word = words[(seed >> 16) % (sizeof(words) / sizeof(words[0]))]; (*word != '\0') && (i < sizeof(text_bytes)); word++)
+        {
+            text_bytes[i++] = (unsigned char)*word;
+        }
+    }
+    for (i = 0; i < sizeof(random_bytes); i++)
+    {
+        seed = seed * 1103515245 + 12345;
+        random_bytes[i] = (unsigned char)(seed >> 16);
+    }
+}
+
+/*compresses source_size bytes, decompresses them back and checks they are the same. Returns the compressed size*/
+static uint32_t roundtrip(const unsigned char* source, uint32_t source_size)
+{
+    uint32_t destination_size = lz_codec_compress_bound(source_size);
+    unsigned char* compressed = malloc(destination_size);
+    ASSERT_IS_NOT_NULL(compressed);
+    unsigned char* decompressed = malloc(source_size + 1);
+    ASSERT_IS_NOT_NULL(decompressed);
+    uint32_t compressed_size = 0;
+
+    ASSERT_ARE_EQUAL(int, 0, lz_codec_compress(source, source_size, compressed, destination_size, &compressed_size));
+    ASSERT_IS_TRUE(compressed_size <= destination_size);
+    ASSERT_ARE_EQUAL(int, 0, lz_codec_decompress(compressed, compressed_size, decompressed, source_size));
+    ASSERT_IS_TRUE(source_size == 0 || memcmp(source, decompressed, source_size) == 0);
+
+    free(decompressed);
+    free(compressed);
+    return compressed_size;
+}
+
+BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
+
+TEST_SUITE_INITIALIZE(a)
+{
+    umock_c_init(on_umock_c_error);
+
+    (void)umocktypes_stdint_register_types();
+
+    fill_test_bytes();
+}
+
+TEST_SUITE_CLEANUP(b)
+{
+    umock_c_deinit();
+}
+
+TEST_FUNCTION_INITIALIZE(c)
+{
+    umock_c_reset_all_calls();
+}
+
+TEST_FUNCTION_CLEANUP(d)
+{
+}
+
+/* lz_codec_compress_bound */
+
+/*Tests_SRS_LZ_CODEC_12_001: [ If source_size is greater than LZ_CODEC_MAX_INPUT_SIZE then lz_codec_compress_bound shall fail and return 0. ]*/
+TEST_FUNCTION(lz_codec_compress_bound_with_source_size_too_big_fails)
+{
+    ///act
+    uint32_t result_1 = lz_codec_compress_bound(LZ_CODEC_MAX_INPUT_SIZE + 1);
+    uint32_t result_2 = lz_codec_compress_bound(UINT32_MAX);
+
+    ///assert
+    ASSERT_ARE_EQUAL(uint32_t, 0, result_1);
+    ASSERT_ARE_EQUAL(uint32_t, 0, result_2);
+}
+
+/*Tests_SRS_LZ_CODEC_12_002: [ Otherwise lz_codec_compress_bound shall return source_size + source_size / 255 + 16. ]*/
+TEST_FUNCTION(lz_codec_compress_bound_succeeds)
+{
+    ///act
+    uint32_t result_0 = lz_codec_compress_bound(0);
+    uint32_t result_255 = lz_codec_compress_bound(255);
+    uint32_t result_max = lz_codec_compress_bound(LZ_CODEC_MAX_INPUT_SIZE);
+
+    ///assert
+    ASSERT_ARE_EQUAL(uint32_t, 16, result_0);
+    ASSERT_ARE_EQUAL(uint32_t, 272, result_255);
+    ASSERT_IS_TRUE(result_max >= LZ_CODEC_MAX_INPUT_SIZE);
+}
+
+/* lz_codec_compress */
+
+/*Tests_SRS_LZ_CODEC_12_003: [ If source is NULL and source_size is not 0 then lz_codec_compress shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(lz_codec_compress_with_NULL_source_fails)
+{
+    ///arrange
+    unsigned char destination[32];
+    uint32_t compressed_size;
+
+    ///act
+    int result = lz_codec_compress(NULL, 1, destination, sizeof(destination), &compressed_size);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/*Tests_SRS_LZ_CODEC_12_004: [ If destination is NULL then lz_codec_compress shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(lz_codec_compress_with_NULL_destination_fails)
+{
+    ///arrange
+    uint32_t compressed_size;
+
+    ///act
+    int result = lz_codec_compress(twenty_a, 20, NULL, 100, &compressed_size);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/*Tests_SRS_LZ_CODEC_12_005: [ If compressed_size is NULL then lz_codec_compress shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(lz_codec_compress_with_NULL_compressed_size_fails)
+{
+    ///arrange
+    unsigned char destination[32];
+
+    ///act
+    int result = lz_codec_compress(twenty_a, 20, destination, sizeof(destination), NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/*Tests_SRS_LZ_CODEC_12_006: [ lz_codec_compress shall encode source as a sequence of literals and matches, finding the matches by looking up the previous occurrence of each 4 byte sequence (within the last 65535 bytes) in a hash table. ]*/
+/*Tests_SRS_LZ_CODEC_12_009: [ lz_codec_compress shall succeed, write in compressed_size the number of bytes written in destination and return 0. ]*/
+TEST_FUNCTION(lz_codec_compress_encodes_a_match)
+{
+    ///arrange
+    unsigned char destination[32];
+    uint32_t compressed_size;
+
+    ///act
+    int result = lz_codec_compress(twenty_a, 20, destination, sizeof(destination), &compressed_size);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(twenty_a_compressed), compressed_size);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(twenty_a_compressed, destination, sizeof(twenty_a_compressed)));
+}
+
+/*Tests_SRS_LZ_CODEC_12_009: [ lz_codec_compress shall succeed, write in compressed_size the number of bytes written in destination and return 0. ]*/
+TEST_FUNCTION(lz_codec_compress_with_source_size_0_succeeds)
+{
+    ///arrange
+    unsigned char destination[16];
+    uint32_t compressed_size;
+
+    ///act
+    int result = lz_codec_compress(NULL, 0, destination, sizeof(destination), &compressed_size);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 1, compressed_size);
+    ASSERT_ARE_EQUAL(uint8_t, 0x00, destination[0]);
+}
+
+/*Tests_SRS_LZ_CODEC_12_007: [ lz_codec_compress shall write the last 5 bytes of source as literals and shall not start a match in the last 12 bytes of source. ]*/
+TEST_FUNCTION(lz_codec_compress_with_12_bytes_writes_only_literals)
+{
+    ///arrange
+    unsigned char destination[32];
+    uint32_t compressed_size;
+
+    ///act
+    int result = lz_codec_compress(twenty_a, 12, destination, sizeof(destination), &compressed_size);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 13, compressed_size);
+    ASSERT_ARE_EQUAL(uint8_t, 0xC0, destination[0]);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(twenty_a, destination + 1, 12));
+}
+
+/*Tests_SRS_LZ_CODEC_12_007: [ lz_codec_compress shall write the last 5 bytes of source as literals and shall not start a match in the last 12 bytes of source. ]*/
+TEST_FUNCTION(lz_codec_compress_ends_with_the_last_5_bytes_as_literals)
+{
+    ///arrange
+    uint32_t destination_size = lz_codec_compress_bound(sizeof(text_bytes));
+    unsigned char* destination = malloc(destination_size);
+    ASSERT_IS_NOT_NULL(destination);
+    uint32_t compressed_size;
+
+    ///act
+    int result = lz_codec_compress(text_bytes, sizeof(text_bytes), destination, destination_size, &compressed_size);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(text_bytes + sizeof(text_bytes) - 5, destination + compressed_size - 5, 5));
+
+    ///clean
+    free(destination);
+}
+
+/*Tests_SRS_LZ_CODEC_12_008: [ If destination_size is not enough to hold the compressed bytes then lz_codec_compress shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(lz_codec_compress_with_destination_too_small_fails)
+{
+    ///arrange
+    unsigned char destination[32];
+    uint32_t compressed_size;
+
+    for (uint32_t destination_size = 0; destination_size < sizeof(twenty_a_compressed); destination_size++)
+    {
+        ///act
+        int result = lz_codec_compress(twenty_a, 20, destination, destination_size, &compressed_size);
+
+        ///assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, result, "destination_size=%" PRIu32 "", destination_size);
+    }
+}
+
+/*Tests_SRS_LZ_CODEC_12_008: [ If destination_size is not enough to hold the compressed bytes then lz_codec_compress shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(lz_codec_compress_with_destination_1_byte_too_small_fails_for_random_bytes)
+{
+    ///arrange
+    uint32_t destination_size = lz_codec_compress_bound(sizeof(random_bytes));
+    unsigned char* destination = malloc(destination_size);
+    ASSERT_IS_NOT_NULL(destination);
+    uint32_t compressed_size;
+    ASSERT_ARE_EQUAL(int, 0, lz_codec_compress(random_bytes, sizeof(random_bytes), destination, destination_size, &compressed_size));
+
+    ///act
+    int result = lz_codec_compress(random_bytes, sizeof(random_bytes), destination, compressed_size - 1, &compressed_size);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    ///clean
+    free(destination);
+}
+
+/*Tests_SRS_LZ_CODEC_12_006: [ lz_codec_compress shall encode source as a sequence of literals and matches, finding the matches by looking up the previous occurrence of each 4 byte sequence (within the last 65535 bytes) in a hash table. ]*/
+/*Tests_SRS_LZ_CODEC_12_009: [ lz_codec_compress shall succeed, write in compressed_size the number of bytes written in destination and return 0. ]*/
+TEST_FUNCTION(lz_codec_compress_and_decompress_roundtrip_for_all_sizes)
+{
+    ///act
+    ///assert
+    for (uint32_t source_size = 0; source_size < 600; source_size++)
+    {
+        (void)roundtrip(text_bytes, source_size);
+        (void)roundtrip(random_bytes, source_size);
+        (void)roundtrip(twenty_a, source_size < 20 ? source_size : 20);
+    }
+}
+
+/*Tests_SRS_LZ_CODEC_12_006: [ lz_codec_compress shall encode source as a sequence of literals and matches, finding the matches by looking up the previous occurrence of each 4 byte sequence (within the last 65535 bytes) in a hash table. ]*/
+TEST_FUNCTION(lz_codec_compress_compresses_text)
+{
+    ///act
+    uint32_t compressed_size = roundtrip(text_bytes, sizeof(text_bytes));
+
+    ///assert
+    ASSERT_IS_TRUE(compressed_size < sizeof(text_bytes) / 2, "compressed_size=%" PRIu32 "", compressed_size);
+}
+
+/*Tests_SRS_LZ_CODEC_12_006: [ lz_codec_compress shall encode source as a sequence of literals and matches, finding the matches by looking up the previous occurrence of each 4 byte sequence (within the last 65535 bytes) in a hash table. ]*/
+TEST_FUNCTION(lz_codec_compress_compresses_long_runs_and_long_distances)
+{
+    ///arrange
+    /*a run of zeroes (long match length), then text, then the same text again 70000 bytes later (too far for a match)*/
+    uint32_t source_size = 100000;
+    unsigned char* source = calloc(1, source_size);
+    ASSERT_IS_NOT_NULL(source);
+    (void)memcpy(source + 10000, text_bytes, sizeof(text_bytes));
+    (void)memcpy(source + 80000, text_bytes, sizeof(text_bytes));
+
+    ///act
+    uint32_t compressed_size = roundtrip(source, source_size);
+
+    ///assert
+    ASSERT_IS_TRUE(compressed_size < source_size / 10, "compressed_size=%" PRIu32 "", compressed_size);
+
+    ///clean
+    free(source);
+}
+
+/*Tests_SRS_LZ_CODEC_12_009: [ lz_codec_compress shall succeed, write in compressed_size the number of bytes written in destination and return 0. ]*/
+TEST_FUNCTION(lz_codec_compress_with_random_bytes_stays_within_bound)
+{
+    ///act
+    uint32_t compressed_size = roundtrip(random_bytes, sizeof(random_bytes));
+
+    ///assert
+    ASSERT_IS_TRUE(compressed_size <= lz_codec_compress_bound(sizeof(random_bytes)));
+}
+
+/* lz_codec_decompress */
+
+/*Tests_SRS_LZ_CODEC_12_010: [ If source is NULL then lz_codec_decompress shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(lz_codec_decompress_with_NULL_source_fails)
+{
+    ///arrange
+    unsigned char destination[20];
+
+    ///act
+    int result = lz_codec_decompress(NULL, sizeof(twenty_a_compressed), destination, sizeof(destination));
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/*Tests_SRS_LZ_CODEC_12_011: [ If destination is NULL and destination_size is not 0 then lz_codec_decompress shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(lz_codec_decompress_with_NULL_destination_fails)
+{
+    ///act
+    int result = lz_codec_decompress(twenty_a_compressed, sizeof(twenty_a_compressed), NULL, 20);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/*Tests_SRS_LZ_CODEC_12_012: [ lz_codec_decompress shall decode the sequences in source, copying the literals and the matches in destination. ]*/
+/*Tests_SRS_LZ_CODEC_12_015: [ lz_codec_decompress shall succeed and return 0. ]*/
+TEST_FUNCTION(lz_codec_decompress_decodes_an_overlapping_match)
+{
+    ///arrange
+    unsigned char destination[20];
+
+    ///act
+    int result = lz_codec_decompress(twenty_a_compressed, sizeof(twenty_a_compressed), destination, sizeof(destination));
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(twenty_a, destination, sizeof(destination)));
+}
+
+/*decodes 1000 bytes that repeat the first period bytes: period literals, an overlapping match of 995 - period bytes at offset period and the 5 last literals*/
+static void decompress_a_long_overlapping_match(uint32_t period)
+{
+    ///arrange
+    unsigned char expected[1000];
+    for (uint32_t i = 0; i < sizeof(expected); i++)
+    {
+        expected[i] = (unsigned char)('a' + i % period);
+    }
+    uint32_t match_code = (uint32_t)sizeof(expected) - 5 - period - 4; /*the match length is stored minus the minimum match of 4*/
+    unsigned char source[1 + 8 + 2 + 8 + 1 + 5];
+    unsigned char destination[1000];
+    unsigned char* p = source;
+    *p++ = (unsigned char)((period << 4) | 0x0F);
+    (void)memcpy(p, expected, period);
+    p += period;
+    *p++ = (unsigned char)period;
+    *p++ = 0;
+    for (match_code -= 15; match_code >= 255; match_code -= 255)
+    {
+        *p++ = 255;
+    }
+    *p++ = (unsigned char)match_code;
+    *p++ = 0x50;
+    (void)memcpy(p, expected + sizeof(expected) - 5, 5);
+    p += 5;
+
+    ///act
+    int result = lz_codec_decompress(source, (uint32_t)(p - source), destination, sizeof(destination));
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result, "period=%" PRIu32 "", period);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(expected, destination, sizeof(destination)), "period=%" PRIu32 "", period);
+}
+
+/*Tests_SRS_LZ_CODEC_12_012: [ lz_codec_decompress shall decode the sequences in source, copying the literals and the matches in destination. ]*/
+/*Tests_SRS_LZ_CODEC_12_015: [ lz_codec_decompress shall succeed and return 0. ]*/
+TEST_FUNCTION(lz_codec_decompress_decodes_a_long_overlapping_match_at_offset_1)
+{
+    decompress_a_long_overlapping_match(1);
+}
+
+/*Tests_SRS_LZ_CODEC_12_012: [ lz_codec_decompress shall decode the sequences in source, copying the literals and the matches in destination. ]*/
+/*Tests_SRS_LZ_CODEC_12_015: [ lz_codec_decompress shall succeed and return 0. ]*/
+TEST_FUNCTION(lz_codec_decompress_decodes_long_overlapping_matches_at_small_offsets)
+{
+    for (uint32_t period = 2; period <= 8; period++)
+    {
+        decompress_a_long_overlapping_match(period);
+    }
+}
+
+/*Tests_SRS_LZ_CODEC_12_012: [ lz_codec_decompress shall decode the sequences in source, copying the literals and the matches in destination. ]*/
+/*Tests_SRS_LZ_CODEC_12_015: [ lz_codec_decompress shall succeed and return 0. ]*/
+TEST_FUNCTION(lz_codec_decompress_with_destination_size_0_succeeds)
+{
+    ///arrange
+    static const unsigned char empty_compressed[] = { 0x00 };
+
+    ///act
+    int result = lz_codec_decompress(empty_compressed, sizeof(empty_compressed), NULL, 0);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+}
+
+/*Tests_SRS_LZ_CODEC_12_012: [ lz_codec_decompress shall decode the sequences in source, copying the literals and the matches in destination. ]*/
+TEST_FUNCTION(lz_codec_decompress_decodes_extra_length_bytes)
+{
+    ///arrange
+    /*300 literals (15 + 255 + 30), a match of 4 + 15 + 255 + 1 = 275 bytes at offset 300 and 5 last literals*/
+    unsigned char source[1 + 2 + 300 + 2 + 2 + 1 + 5];
+    unsigned char destination[300 + 275 + 5];
+    unsigned char* p = source;
+    *p++ = 0xFF;
+    *p++ = 255;
+    *p++ = 30;
+    (void)memcpy(p, random_bytes, 300);
+    p += 300;
+    *p++ = (unsigned char)(300 & 0xFF);
+    *p++ = (unsigned char)(300 >> 8);
+    *p++ = 255;
+    *p++ = 1;
+    *p++ = 0x50;
+    (void)memcpy(p, random_bytes + 300, 5);
+
+    ///act
+    int result = lz_codec_decompress(source, sizeof(source), destination, sizeof(destination));
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(random_bytes, destination, 300));
+    ASSERT_ARE_EQUAL(int, 0, memcmp(random_bytes, destination + 300, 275));
+    ASSERT_ARE_EQUAL(int, 0, memcmp(random_bytes + 300, destination + 575, 5));
+}
+
+/*Tests_SRS_LZ_CODEC_12_013: [ If a sequence is truncated, has literals or a match that do not fit in destination_size bytes or has an offset of 0 or before the start of destination then lz_codec_decompress shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(lz_codec_decompress_with_source_size_0_fails)
+{
+    ///arrange
+    unsigned char destination[1];
+
+    ///act
+    int result = lz_codec_decompress(twenty_a_compressed, 0, destination, 0);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/*Tests_SRS_LZ_CODEC_12_013: [ If a sequence is truncated, has literals or a match that do not fit in destination_size bytes or has an offset of 0 or before the start of destination then lz_codec_decompress shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(lz_codec_decompress_with_truncated_source_fails)
+{
+    ///arrange
+    unsigned char destination[20];
+
+    for (uint32_t source_size = 1; source_size < sizeof(twenty_a_compressed); source_size++)
+    {
+        ///act
+        int result = lz_codec_decompress(twenty_a_compressed, source_size, destination, sizeof(destination));
+
+        ///assert
+        ASSERT_ARE_NOT_EQUAL(int, 0, result, "source_size=%" PRIu32 "", source_size);
+    }
+}
+
+/*Tests_SRS_LZ_CODEC_12_013: [ If a sequence is truncated, has literals or a match that do not fit in destination_size bytes or has an offset of 0 or before the start of destination then lz_codec_decompress shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(lz_codec_decompress_with_offset_0_fails)
+{
+    ///arrange
+    static const unsigned char source[] = { 0x1A, 'a', 0x00, 0x00, 0x50, 'a', 'a', 'a', 'a', 'a' };
+    unsigned char destination[20];
+
+    ///act
+    int result = lz_codec_decompress(source, sizeof(source), destination, sizeof(destination));
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/*Tests_SRS_LZ_CODEC_12_013: [ If a sequence is truncated, has literals or a match that do not fit in destination_size bytes or has an offset of 0 or before the start of destination then lz_codec_decompress shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(lz_codec_decompress_with_offset_before_destination_fails)
+{
+    ///arrange
+    static const unsigned char source[] = { 0x1A, 'a', 0x02, 0x00, 0x50, 'a', 'a', 'a', 'a', 'a' };
+    unsigned char destination[20];
+
+    ///act
+    int result = lz_codec_decompress(source, sizeof(source), destination, sizeof(destination));
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/*Tests_SRS_LZ_CODEC_12_013: [ If a sequence is truncated, has literals or a match that do not fit in destination_size bytes or has an offset of 0 or before the start of destination then lz_codec_decompress shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(lz_codec_decompress_with_match_too_long_for_destination_fails)
+{
+    ///arrange
+    unsigned char destination[32];
+    (void)memset(destination, 0xEE, sizeof(destination));
+
+    ///act
+    int result = lz_codec_decompress(twenty_a_compressed, sizeof(twenty_a_compressed), destination, 10);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    for (size_t i = 10; i < sizeof(destination); i++)
+    {
+        ASSERT_ARE_EQUAL(uint8_t, 0xEE, destination[i]);
+    }
+}
+
+/*Tests_SRS_LZ_CODEC_12_013: [ If a sequence is truncated, has literals or a match that do not fit in destination_size bytes or has an offset of 0 or before the start of destination then lz_codec_decompress shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(lz_codec_decompress_with_match_length_that_wraps_fails)
+{
+    ///arrange
+    /*1 literal and a match of 4 + UINT32_MAX bytes at offset 1: 15 + 16843008 * 255 + 240 = UINT32_MAX, + 4 wraps to 3*/
+    uint32_t source_size = 1 + 1 + 2 + 16843008 + 1;
+    unsigned char* source = malloc(source_size);
+    ASSERT_IS_NOT_NULL(source);
+    unsigned char* p = source;
+    *p++ = 0x1F;
+    *p++ = 'a';
+    *p++ = 0x01;
+    *p++ = 0x00;
+    (void)memset(p, 255, 16843008);
+    p += 16843008;
+    *p++ = 240;
+    unsigned char destination[32];
+    (void)memset(destination, 0xEE, sizeof(destination));
+
+    ///act
+    int result = lz_codec_decompress(source, source_size, destination, UINT32_MAX);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint8_t, 'a', destination[0]);
+    for (size_t i = 1; i < sizeof(destination); i++)
+    {
+        ASSERT_ARE_EQUAL(uint8_t, 0xEE, destination[i]);
+    }
+
+    ///clean
+    free(source);
+}
+
+/*Tests_SRS_LZ_CODEC_12_013: [ If a sequence is truncated, has literals or a match that do not fit in destination_size bytes or has an offset of 0 or before the start of destination then lz_codec_decompress shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(lz_codec_decompress_with_literal_length_past_source_fails)
+{
+    ///arrange
+    /*15 + 255 + 255 + ... literals announced, but only a few bytes follow*/
+    static const unsigned char source[] = { 0xF0, 255, 255, 255, 10, 'a', 'b', 'c' };
+    unsigned char destination[2000];
+
+    ///act
+    int result = lz_codec_decompress(source, sizeof(source), destination, sizeof(destination));
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/*Tests_SRS_LZ_CODEC_12_013: [ If a sequence is truncated, has literals or a match that do not fit in destination_size bytes or has an offset of 0 or before the start of destination then lz_codec_decompress shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(lz_codec_decompress_with_corrupted_bytes_does_not_write_past_destination)
+{
+    ///arrange
+    uint32_t compressed_buffer_size = lz_codec_compress_bound(sizeof(text_bytes));
+    unsigned char* compressed = malloc(compressed_buffer_size);
+    ASSERT_IS_NOT_NULL(compressed);
+    unsigned char* destination = malloc(sizeof(text_bytes) + 64);
+    ASSERT_IS_NOT_NULL(destination);
+    uint32_t compressed_size;
+    ASSERT_ARE_EQUAL(int, 0, lz_codec_compress(text_bytes, sizeof(text_bytes), compressed, compressed_buffer_size, &compressed_size));
+
+    for (uint32_t i = 0; i < compressed_size; i += 7)
+    {
+        unsigned char saved = compressed[i];
+        compressed[i] ^= 0x5A;
+        (void)memset(destination + sizeof(text_bytes), 0xEE, 64);
+
+        ///act
+        (void)lz_codec_decompress(compressed, compressed_size, destination, sizeof(text_bytes));
+
+        ///assert
+        for (size_t j = sizeof(text_bytes); j < sizeof(text_bytes) + 64; j++)
+        {
+            ASSERT_ARE_EQUAL(uint8_t, 0xEE, destination[j]);
+        }
+
+        compressed[i] = saved;
+    }
+
+    ///clean
+    free(destination);
+    free(compressed);
+}
+
+/*Tests_SRS_LZ_CODEC_12_014: [ If the number of decoded bytes is not destination_size then lz_codec_decompress shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(lz_codec_decompress_with_destination_size_too_big_fails)
+{
+    ///arrange
+    unsigned char destination[21];
+
+    ///act
+    int result = lz_codec_decompress(twenty_a_compressed, sizeof(twenty_a_compressed), destination, sizeof(destination));
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
@@ -0,0 +1,188 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "macro_utils/macro_utils.h"
+#include "testrunnerswitcher.h"
+
+#include "c_pal/gballoc_hl.h"
+#include "c_pal/gballoc_hl_redirect.h"
+#include "c_pal/thandle.h"
+
+#include "c_util/memory_mapped_file.h"
+#include "c_util/constbuffer.h"
+#include "c_util/constbuffer_thandle.h"
+
+#define TEST_FILE_NAME "memory_mapped_file_int.bin"
+#define TEST_FILE_SIZE (3 * 65536 + 123) /*spans several pages and several allocation granularities*/
+
+static unsigned char test_file_content[TEST_FILE_SIZE];
+
+BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    ASSERT_ARE_EQUAL(int, 0, gballoc_hl_init(NULL, NULL));
+
+    for (uint32_t i = 0; i < TEST_FILE_SIZE; i++)
+    {
+        test_file_content[i] = (unsigned char)((i * 31) ^ (i >> 8));
+    }
+
+    FILE* f = fopen(TEST_FILE_NAME, "wb");
+    ASSERT_IS_NOT_NULL(f);
+    ASSERT_ARE_EQUAL(size_t, TEST_FILE_SIZE, fwrite(test_file_content, 1, TEST_FILE_SIZE, f));
+    ASSERT_ARE_EQUAL(int, 0, fclose(f));
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    (void)remove(TEST_FILE_NAME);
+
+    gballoc_hl_deinit();
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+}
+
+TEST_FUNCTION(memory_mapped_file_map_maps_the_whole_file)
+{
+    ///arrange
+    MEMORY_MAPPED_FILE_VIEW view;
+
+    ///act
+    int result = memory_mapped_file_map(TEST_FILE_NAME, 0, 0, MEMORY_MAPPED_FILE_ACCESS_HINT_SEQUENTIAL, &view);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, TEST_FILE_SIZE, view.content_size);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(test_file_content, view.content, TEST_FILE_SIZE));
+
+    ///cleanup
+    memory_mapped_file_unmap(&view);
+}
+
+TEST_FUNCTION(memory_mapped_file_map_maps_an_unaligned_range)
+{
+    ///arrange
+    MEMORY_MAPPED_FILE_VIEW view;
+
+    ///act
+    int result = memory_mapped_file_map(TEST_FILE_NAME, 65536 + 17, 70000, MEMORY_MAPPED_FILE_ACCESS_HINT_RANDOM, &view);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 70000, view.content_size);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(test_file_content + 65536 + 17, view.content, 70000));
+
+    ///cleanup
+    memory_mapped_file_unmap(&view);
+}
+
+TEST_FUNCTION(memory_mapped_file_map_with_size_0_maps_until_the_end_of_the_file)
+{
+    ///arrange
+    MEMORY_MAPPED_FILE_VIEW view;
+
+    ///act
+    int result = memory_mapped_file_map(TEST_FILE_NAME, 5000, 0, MEMORY_MAPPED_FILE_ACCESS_HINT_WILLNEED, &view);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, TEST_FILE_SIZE - 5000, view.content_size);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(test_file_content + 5000, view.content, TEST_FILE_SIZE - 5000));
+
+    ///cleanup
+    memory_mapped_file_unmap(&view);
+}
+
+TEST_FUNCTION(memory_mapped_file_map_at_the_end_of_the_file_returns_an_empty_view)
+{
+    ///arrange
+    MEMORY_MAPPED_FILE_VIEW view;
+
+    ///act
+    int result = memory_mapped_file_map(TEST_FILE_NAME, TEST_FILE_SIZE, 0, MEMORY_MAPPED_FILE_ACCESS_HINT_NORMAL, &view);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 0, view.content_size);
+
+    ///cleanup
+    memory_mapped_file_unmap(&view);
+}
+
+TEST_FUNCTION(memory_mapped_file_map_past_the_end_of_the_file_fails)
+{
+    ///arrange
+    MEMORY_MAPPED_FILE_VIEW view;
+
+    ///act
+    int result_1 = memory_mapped_file_map(TEST_FILE_NAME, TEST_FILE_SIZE + 1, 0, MEMORY_MAPPED_FILE_ACCESS_HINT_NORMAL, &view);
+    int result_2 = memory_mapped_file_map(TEST_FILE_NAME, TEST_FILE_SIZE - 1, 2, MEMORY_MAPPED_FILE_ACCESS_HINT_NORMAL, &view);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result_1);
+    ASSERT_ARE_NOT_EQUAL(int, 0, result_2);
+}
+
+TEST_FUNCTION(memory_mapped_file_map_with_a_file_that_does_not_exist_fails)
+{
+    ///arrange
+    MEMORY_MAPPED_FILE_VIEW view;
+
+    ///act
+    int result = memory_mapped_file_map("this_file_does_not_exist.bin", 0, 0, MEMORY_MAPPED_FILE_ACCESS_HINT_NORMAL, &view);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+TEST_FUNCTION(CONSTBUFFER_CreateFromMappedFile_slices_share_the_mapping)
+{
+    ///arrange
+    CONSTBUFFER_HANDLE whole = CONSTBUFFER_CreateFromMappedFile(TEST_FILE_NAME, 0, 0, MEMORY_MAPPED_FILE_ACCESS_HINT_NORMAL);
+    ASSERT_IS_NOT_NULL(whole);
+
+    ///act
+    CONSTBUFFER_HANDLE slice = CONSTBUFFER_CreateFromOffsetAndSize(whole, 100000, 1000);
+    CONSTBUFFER_DecRef(whole);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(slice);
+    const CONSTBUFFER* content = CONSTBUFFER_GetContent(slice);
+    ASSERT_ARE_EQUAL(uint32_t, 1000, content->size);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(test_file_content + 100000, content->buffer, 1000));
+
+    ///cleanup
+    CONSTBUFFER_DecRef(slice);
+}
+
+TEST_FUNCTION(CONSTBUFFER_THANDLE_CreateFromMappedFile_maps_the_requested_range)
+{
+    ///arrange
+
+    ///act
+    THANDLE(CONSTBUFFER) handle = CONSTBUFFER_THANDLE_CreateFromMappedFile(TEST_FILE_NAME, 12345, 4321, MEMORY_MAPPED_FILE_ACCESS_HINT_SEQUENTIAL);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(handle);
+    const CONSTBUFFER_CONTENT* content = CONSTBUFFER_THANDLE_GetContent(handle);
+    ASSERT_ARE_EQUAL(uint32_t, 4321, content->size);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(test_file_content + 12345, content->buffer, 4321));
+
+    ///cleanup
+    THANDLE_ASSIGN(CONSTBUFFER)(&handle, NULL);
+}
+
+END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
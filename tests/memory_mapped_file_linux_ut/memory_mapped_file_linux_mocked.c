@@ -0,0 +1,27 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stddef.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define open mocked_open
+#define fstat mocked_fstat
+#define sysconf mocked_sysconf
+#define mmap mocked_mmap
+#define madvise mocked_madvise
+#define munmap mocked_munmap
+#define close mocked_close
+
+extern int mocked_open(const char* pathname, int flags);
+extern int mocked_fstat(int fd, struct stat* statbuf);
+extern long mocked_sysconf(int name);
+extern void* mocked_mmap(void* addr, size_t length, int prot, int flags, int fd, off_t offset);
+extern int mocked_madvise(void* addr, size_t length, int advice);
+extern int mocked_munmap(void* addr, size_t length);
+extern int mocked_close(int fd);
+
+#include "../../src/memory_mapped_file_linux.c"
@@ -0,0 +1,524 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "memory_mapped_file_linux_ut_pch.h"
+
+#include "umock_c/umock_c_ENABLE_MOCKS.h" // ============================== ENABLE_MOCKS
+#undef ENABLE_MOCKS_DECL
+#include "umock_c/umock_c_prod.h"
+    MOCKABLE_FUNCTION(, int, mocked_open, const char*, pathname, int, flags);
+    MOCKABLE_FUNCTION(, int, mocked_fstat, int, fd, struct stat*, statbuf);
+    MOCKABLE_FUNCTION(, long, mocked_sysconf, int, name);
+    MOCKABLE_FUNCTION(, void*, mocked_mmap, void*, addr, size_t, length, int, prot, int, flags, int, fd, off_t, offset);
+    MOCKABLE_FUNCTION(, int, mocked_madvise, void*, addr, size_t, length, int, advice);
+    MOCKABLE_FUNCTION(, int, mocked_munmap, void*, addr, size_t, length);
+    MOCKABLE_FUNCTION(, int, mocked_close, int, fd);
+#include "umock_c/umock_c_DISABLE_MOCKS.h" // ============================== DISABLE_MOCKS
+
+#define TEST_FILE_NAME "memory_mapped_file_linux_ut.bin"
+#define TEST_FD 42
+#define TEST_PAGE_SIZE 4096
+#define TEST_MAPPING_BASE ((void*)0x4242000)
+
+static uint64_t test_file_size;
+
+static int hook_mocked_fstat(int fd, struct stat* statbuf)
+{
+    (void)fd;
+    (void)memset(statbuf, 0, sizeof(*statbuf));
+    statbuf->st_size = (off_t)test_file_size;
+    return 0;
+}
+
+static void setup_open_and_fstat(void)
+{
+    STRICT_EXPECTED_CALL(mocked_open(TEST_FILE_NAME, O_RDONLY | O_CLOEXEC));
+    STRICT_EXPECTED_CALL(mocked_fstat(TEST_FD, IGNORED_ARG));
+}
+
+static void map_test_view(MEMORY_MAPPED_FILE_VIEW* view)
+{
+    test_file_size = 10000;
+    setup_open_and_fstat();
+    STRICT_EXPECTED_CALL(mocked_sysconf(_SC_PAGESIZE));
+    STRICT_EXPECTED_CALL(mocked_mmap(NULL, 5000 - TEST_PAGE_SIZE + 100, PROT_READ, MAP_SHARED, TEST_FD, TEST_PAGE_SIZE));
+    STRICT_EXPECTED_CALL(mocked_close(TEST_FD));
+    ASSERT_ARE_EQUAL(int, 0, memory_mapped_file_map(TEST_FILE_NAME, 5000, 100, MEMORY_MAPPED_FILE_ACCESS_HINT_NORMAL, view));
+    umock_c_reset_all_calls();
+}
+
+MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    ASSERT_FAIL("umock_c reported error :%" PRI_MU_ENUM "", MU_ENUM_VALUE(UMOCK_C_ERROR_CODE, error_code));
+}
+
+BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    ASSERT_ARE_EQUAL(int, 0, umock_c_init(on_umock_c_error), "umock_c_init");
+
+    ASSERT_ARE_EQUAL(int, 0, umocktypes_stdint_register_types(), "umocktypes_stdint_register_types");
+
+    ASSERT_ARE_EQUAL(int, 0, umocktypes_charptr_register_types(), "umocktypes_charptr_register_types");
+
+    REGISTER_UMOCK_ALIAS_TYPE(struct stat*, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(off_t, int64_t);
+
+    REGISTER_GLOBAL_MOCK_RETURNS(mocked_open, TEST_FD, -1);
+    REGISTER_GLOBAL_MOCK_HOOK(mocked_fstat, hook_mocked_fstat);
+    REGISTER_GLOBAL_MOCK_RETURNS(mocked_sysconf, TEST_PAGE_SIZE, -1);
+    REGISTER_GLOBAL_MOCK_RETURNS(mocked_mmap, TEST_MAPPING_BASE, MAP_FAILED);
+    REGISTER_GLOBAL_MOCK_RETURNS(mocked_madvise, 0, -1);
+    REGISTER_GLOBAL_MOCK_RETURNS(mocked_munmap, 0, -1);
+    REGISTER_GLOBAL_MOCK_RETURNS(mocked_close, 0, -1);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    umock_c_deinit();
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    umock_c_reset_all_calls();
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+}
+
+/* memory_mapped_file_map */
+
+/*Tests_SRS_MEMORY_MAPPED_FILE_12_001: [ If file_name is NULL then memory_mapped_file_map shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(memory_mapped_file_map_with_file_name_NULL_fails)
+{
+    ///arrange
+    MEMORY_MAPPED_FILE_VIEW view;
+
+    ///act
+    int result = memory_mapped_file_map(NULL, 0, 0, MEMORY_MAPPED_FILE_ACCESS_HINT_NORMAL, &view);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_MEMORY_MAPPED_FILE_12_002: [ If hint is not a valid MEMORY_MAPPED_FILE_ACCESS_HINT then memory_mapped_file_map shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(memory_mapped_file_map_with_invalid_hint_fails)
+{
+    ///arrange
+    MEMORY_MAPPED_FILE_VIEW view;
+
+    ///act
+    int result = memory_mapped_file_map(TEST_FILE_NAME, 0, 0, (MEMORY_MAPPED_FILE_ACCESS_HINT)(MEMORY_MAPPED_FILE_ACCESS_HINT_WILLNEED + 1), &view);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_MEMORY_MAPPED_FILE_12_003: [ If view is NULL then memory_mapped_file_map shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(memory_mapped_file_map_with_view_NULL_fails)
+{
+    ///act
+    int result = memory_mapped_file_map(TEST_FILE_NAME, 0, 0, MEMORY_MAPPED_FILE_ACCESS_HINT_NORMAL, NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_MEMORY_MAPPED_FILE_12_004: [ memory_mapped_file_map shall open file_name for reading. ]*/
+/*Tests_SRS_MEMORY_MAPPED_FILE_12_005: [ memory_mapped_file_map shall get the size of the file. ]*/
+/*Tests_SRS_MEMORY_MAPPED_FILE_12_010: [ memory_mapped_file_map shall map the file read-only and shared starting from offset rounded down to the OS mapping granularity. ]*/
+/*Tests_SRS_MEMORY_MAPPED_FILE_12_011: [ memory_mapped_file_map shall pass hint to the OS (madvise on Linux, file flags and PrefetchVirtualMemory on Windows). A failure to apply the hint shall not fail memory_mapped_file_map. ]*/
+/*Tests_SRS_MEMORY_MAPPED_FILE_12_012: [ memory_mapped_file_map shall fill view with the mapping and the address and size of the requested range, succeed and return 0. ]*/
+/*Tests_SRS_MEMORY_MAPPED_FILE_12_013: [ memory_mapped_file_map shall close the file. ]*/
+TEST_FUNCTION(memory_mapped_file_map_with_hint_NORMAL_succeeds)
+{
+    ///arrange
+    MEMORY_MAPPED_FILE_VIEW view;
+    test_file_size = 10000;
+    setup_open_and_fstat();
+    STRICT_EXPECTED_CALL(mocked_sysconf(_SC_PAGESIZE));
+    STRICT_EXPECTED_CALL(mocked_mmap(NULL, 5000 - TEST_PAGE_SIZE + 100, PROT_READ, MAP_SHARED, TEST_FD, TEST_PAGE_SIZE));
+    STRICT_EXPECTED_CALL(mocked_close(TEST_FD));
+
+    ///act
+    int result = memory_mapped_file_map(TEST_FILE_NAME, 5000, 100, MEMORY_MAPPED_FILE_ACCESS_HINT_NORMAL, &view);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, TEST_MAPPING_BASE, view.mapping_base);
+    ASSERT_ARE_EQUAL(size_t, 5000 - TEST_PAGE_SIZE + 100, view.mapping_size);
+    ASSERT_ARE_EQUAL(void_ptr, (const unsigned char*)TEST_MAPPING_BASE + 5000 - TEST_PAGE_SIZE, view.content);
+    ASSERT_ARE_EQUAL(uint32_t, 100, view.content_size);
+}
+
+/*Tests_SRS_MEMORY_MAPPED_FILE_12_011: [ memory_mapped_file_map shall pass hint to the OS (madvise on Linux, file flags and PrefetchVirtualMemory on Windows). A failure to apply the hint shall not fail memory_mapped_file_map. ]*/
+TEST_FUNCTION(memory_mapped_file_map_with_hint_SEQUENTIAL_calls_madvise_with_MADV_SEQUENTIAL)
+{
+    ///arrange
+    MEMORY_MAPPED_FILE_VIEW view;
+    test_file_size = 10000;
+    setup_open_and_fstat();
+    STRICT_EXPECTED_CALL(mocked_sysconf(_SC_PAGESIZE));
+    STRICT_EXPECTED_CALL(mocked_mmap(NULL, 10000, PROT_READ, MAP_SHARED, TEST_FD, 0));
+    STRICT_EXPECTED_CALL(mocked_madvise(TEST_MAPPING_BASE, 10000, MADV_SEQUENTIAL));
+    STRICT_EXPECTED_CALL(mocked_close(TEST_FD));
+
+    ///act
+    int result = memory_mapped_file_map(TEST_FILE_NAME, 0, 10000, MEMORY_MAPPED_FILE_ACCESS_HINT_SEQUENTIAL, &view);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, TEST_MAPPING_BASE, view.mapping_base);
+    ASSERT_ARE_EQUAL(void_ptr, TEST_MAPPING_BASE, view.content);
+    ASSERT_ARE_EQUAL(uint32_t, 10000, view.content_size);
+}
+
+/*Tests_SRS_MEMORY_MAPPED_FILE_12_011: [ memory_mapped_file_map shall pass hint to the OS (madvise on Linux, file flags and PrefetchVirtualMemory on Windows). A failure to apply the hint shall not fail memory_mapped_file_map. ]*/
+TEST_FUNCTION(memory_mapped_file_map_with_hint_RANDOM_calls_madvise_with_MADV_RANDOM)
+{
+    ///arrange
+    MEMORY_MAPPED_FILE_VIEW view;
+    test_file_size = 10000;
+    setup_open_and_fstat();
+    STRICT_EXPECTED_CALL(mocked_sysconf(_SC_PAGESIZE));
+    STRICT_EXPECTED_CALL(mocked_mmap(NULL, 10000, PROT_READ, MAP_SHARED, TEST_FD, 0));
+    STRICT_EXPECTED_CALL(mocked_madvise(TEST_MAPPING_BASE, 10000, MADV_RANDOM));
+    STRICT_EXPECTED_CALL(mocked_close(TEST_FD));
+
+    ///act
+    int result = memory_mapped_file_map(TEST_FILE_NAME, 0, 10000, MEMORY_MAPPED_FILE_ACCESS_HINT_RANDOM, &view);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_MEMORY_MAPPED_FILE_12_011: [ memory_mapped_file_map shall pass hint to the OS (madvise on Linux, file flags and PrefetchVirtualMemory on Windows). A failure to apply the hint shall not fail memory_mapped_file_map. ]*/
+TEST_FUNCTION(memory_mapped_file_map_with_hint_WILLNEED_calls_madvise_with_MADV_WILLNEED)
+{
+    ///arrange
+    MEMORY_MAPPED_FILE_VIEW view;
+    test_file_size = 10000;
+    setup_open_and_fstat();
+    STRICT_EXPECTED_CALL(mocked_sysconf(_SC_PAGESIZE));
+    STRICT_EXPECTED_CALL(mocked_mmap(NULL, 10000, PROT_READ, MAP_SHARED, TEST_FD, 0));
+    STRICT_EXPECTED_CALL(mocked_madvise(TEST_MAPPING_BASE, 10000, MADV_WILLNEED));
+    STRICT_EXPECTED_CALL(mocked_close(TEST_FD));
+
+    ///act
+    int result = memory_mapped_file_map(TEST_FILE_NAME, 0, 10000, MEMORY_MAPPED_FILE_ACCESS_HINT_WILLNEED, &view);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_MEMORY_MAPPED_FILE_12_011: [ memory_mapped_file_map shall pass hint to the OS (madvise on Linux, file flags and PrefetchVirtualMemory on Windows). A failure to apply the hint shall not fail memory_mapped_file_map. ]*/
+TEST_FUNCTION(memory_mapped_file_map_when_madvise_fails_succeeds)
+{
+    ///arrange
+    MEMORY_MAPPED_FILE_VIEW view;
+    test_file_size = 10000;
+    setup_open_and_fstat();
+    STRICT_EXPECTED_CALL(mocked_sysconf(_SC_PAGESIZE));
+    STRICT_EXPECTED_CALL(mocked_mmap(NULL, 10000, PROT_READ, MAP_SHARED, TEST_FD, 0));
+    STRICT_EXPECTED_CALL(mocked_madvise(TEST_MAPPING_BASE, 10000, MADV_SEQUENTIAL))
+        .SetReturn(-1);
+    STRICT_EXPECTED_CALL(mocked_close(TEST_FD));
+
+    ///act
+    int result = memory_mapped_file_map(TEST_FILE_NAME, 0, 10000, MEMORY_MAPPED_FILE_ACCESS_HINT_SEQUENTIAL, &view);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, TEST_MAPPING_BASE, view.mapping_base);
+    ASSERT_ARE_EQUAL(uint32_t, 10000, view.content_size);
+}
+
+/*Tests_SRS_MEMORY_MAPPED_FILE_12_013: [ memory_mapped_file_map shall close the file. ]*/
+TEST_FUNCTION(memory_mapped_file_map_when_close_fails_succeeds)
+{
+    ///arrange
+    MEMORY_MAPPED_FILE_VIEW view;
+    test_file_size = 10000;
+    setup_open_and_fstat();
+    STRICT_EXPECTED_CALL(mocked_sysconf(_SC_PAGESIZE));
+    STRICT_EXPECTED_CALL(mocked_mmap(NULL, 10000, PROT_READ, MAP_SHARED, TEST_FD, 0));
+    STRICT_EXPECTED_CALL(mocked_close(TEST_FD))
+        .SetReturn(-1);
+
+    ///act
+    int result = memory_mapped_file_map(TEST_FILE_NAME, 0, 10000, MEMORY_MAPPED_FILE_ACCESS_HINT_NORMAL, &view);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, TEST_MAPPING_BASE, view.mapping_base);
+}
+
+/*Tests_SRS_MEMORY_MAPPED_FILE_12_012: [ memory_mapped_file_map shall fill view with the mapping and the address and size of the requested range, succeed and return 0. ]*/
+TEST_FUNCTION(memory_mapped_file_map_with_size_0_maps_until_the_end_of_the_file)
+{
+    ///arrange
+    MEMORY_MAPPED_FILE_VIEW view;
+    test_file_size = 10000;
+    setup_open_and_fstat();
+    STRICT_EXPECTED_CALL(mocked_sysconf(_SC_PAGESIZE));
+    STRICT_EXPECTED_CALL(mocked_mmap(NULL, 10000 - 2 * TEST_PAGE_SIZE, PROT_READ, MAP_SHARED, TEST_FD, 2 * TEST_PAGE_SIZE));
+    STRICT_EXPECTED_CALL(mocked_close(TEST_FD));
+
+    ///act
+    int result = memory_mapped_file_map(TEST_FILE_NAME, 2 * TEST_PAGE_SIZE, 0, MEMORY_MAPPED_FILE_ACCESS_HINT_NORMAL, &view);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, TEST_MAPPING_BASE, view.mapping_base);
+    ASSERT_ARE_EQUAL(size_t, 10000 - 2 * TEST_PAGE_SIZE, view.mapping_size);
+    ASSERT_ARE_EQUAL(void_ptr, TEST_MAPPING_BASE, view.content);
+    ASSERT_ARE_EQUAL(uint32_t, 10000 - 2 * TEST_PAGE_SIZE, view.content_size);
+}
+
+/*Tests_SRS_MEMORY_MAPPED_FILE_12_006: [ If offset is greater than the size of the file then memory_mapped_file_map shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(memory_mapped_file_map_with_offset_greater_than_the_file_size_fails)
+{
+    ///arrange
+    MEMORY_MAPPED_FILE_VIEW view;
+    test_file_size = 10000;
+    setup_open_and_fstat();
+    STRICT_EXPECTED_CALL(mocked_close(TEST_FD));
+
+    ///act
+    int result = memory_mapped_file_map(TEST_FILE_NAME, 10001, 0, MEMORY_MAPPED_FILE_ACCESS_HINT_NORMAL, &view);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_MEMORY_MAPPED_FILE_12_007: [ If offset + size exceeds the size of the file then memory_mapped_file_map shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(memory_mapped_file_map_with_offset_plus_size_exceeding_the_file_size_fails)
+{
+    ///arrange
+    MEMORY_MAPPED_FILE_VIEW view;
+    test_file_size = 10000;
+    setup_open_and_fstat();
+    STRICT_EXPECTED_CALL(mocked_close(TEST_FD));
+
+    ///act
+    int result = memory_mapped_file_map(TEST_FILE_NAME, 9000, 1001, MEMORY_MAPPED_FILE_ACCESS_HINT_NORMAL, &view);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_MEMORY_MAPPED_FILE_12_008: [ If size is 0 and the number of bytes from offset to the end of the file exceeds UINT32_MAX then memory_mapped_file_map shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(memory_mapped_file_map_with_size_0_and_more_than_UINT32_MAX_bytes_until_the_end_of_the_file_fails)
+{
+    ///arrange
+    MEMORY_MAPPED_FILE_VIEW view;
+    test_file_size = (uint64_t)UINT32_MAX + 2;
+    setup_open_and_fstat();
+    STRICT_EXPECTED_CALL(mocked_close(TEST_FD));
+
+    ///act
+    int result = memory_mapped_file_map(TEST_FILE_NAME, 1, 0, MEMORY_MAPPED_FILE_ACCESS_HINT_NORMAL, &view);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_MEMORY_MAPPED_FILE_12_008: [ If size is 0 and the number of bytes from offset to the end of the file exceeds UINT32_MAX then memory_mapped_file_map shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(memory_mapped_file_map_with_size_0_and_UINT32_MAX_bytes_until_the_end_of_the_file_succeeds)
+{
+    ///arrange
+    MEMORY_MAPPED_FILE_VIEW view;
+    test_file_size = (uint64_t)UINT32_MAX + TEST_PAGE_SIZE;
+    setup_open_and_fstat();
+    STRICT_EXPECTED_CALL(mocked_sysconf(_SC_PAGESIZE));
+    STRICT_EXPECTED_CALL(mocked_mmap(NULL, UINT32_MAX, PROT_READ, MAP_SHARED, TEST_FD, TEST_PAGE_SIZE));
+    STRICT_EXPECTED_CALL(mocked_close(TEST_FD));
+
+    ///act
+    int result = memory_mapped_file_map(TEST_FILE_NAME, TEST_PAGE_SIZE, 0, MEMORY_MAPPED_FILE_ACCESS_HINT_NORMAL, &view);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, UINT32_MAX, view.content_size);
+}
+
+/*Tests_SRS_MEMORY_MAPPED_FILE_12_009: [ If the range to map has 0 bytes then memory_mapped_file_map shall set view to an empty view, succeed and return 0. ]*/
+TEST_FUNCTION(memory_mapped_file_map_with_offset_at_the_end_of_the_file_returns_an_empty_view)
+{
+    ///arrange
+    MEMORY_MAPPED_FILE_VIEW view;
+    (void)memset(&view, 0xFF, sizeof(view));
+    test_file_size = 10000;
+    setup_open_and_fstat();
+    STRICT_EXPECTED_CALL(mocked_close(TEST_FD));
+
+    ///act
+    int result = memory_mapped_file_map(TEST_FILE_NAME, 10000, 0, MEMORY_MAPPED_FILE_ACCESS_HINT_WILLNEED, &view);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(view.mapping_base);
+    ASSERT_ARE_EQUAL(size_t, 0, view.mapping_size);
+    ASSERT_IS_NULL(view.content);
+    ASSERT_ARE_EQUAL(uint32_t, 0, view.content_size);
+}
+
+/*Tests_SRS_MEMORY_MAPPED_FILE_12_009: [ If the range to map has 0 bytes then memory_mapped_file_map shall set view to an empty view, succeed and return 0. ]*/
+TEST_FUNCTION(memory_mapped_file_map_of_an_empty_file_returns_an_empty_view)
+{
+    ///arrange
+    MEMORY_MAPPED_FILE_VIEW view;
+    (void)memset(&view, 0xFF, sizeof(view));
+    test_file_size = 0;
+    setup_open_and_fstat();
+    STRICT_EXPECTED_CALL(mocked_close(TEST_FD));
+
+    ///act
+    int result = memory_mapped_file_map(TEST_FILE_NAME, 0, 0, MEMORY_MAPPED_FILE_ACCESS_HINT_NORMAL, &view);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(view.mapping_base);
+    ASSERT_ARE_EQUAL(uint32_t, 0, view.content_size);
+}
+
+/*Tests_SRS_MEMORY_MAPPED_FILE_12_014: [ If there are any failures then memory_mapped_file_map shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(memory_mapped_file_map_when_open_fails_fails)
+{
+    ///arrange
+    MEMORY_MAPPED_FILE_VIEW view;
+    STRICT_EXPECTED_CALL(mocked_open(TEST_FILE_NAME, O_RDONLY | O_CLOEXEC))
+        .SetReturn(-1);
+
+    ///act
+    int result = memory_mapped_file_map(TEST_FILE_NAME, 0, 0, MEMORY_MAPPED_FILE_ACCESS_HINT_NORMAL, &view);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_MEMORY_MAPPED_FILE_12_014: [ If there are any failures then memory_mapped_file_map shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(memory_mapped_file_map_when_fstat_fails_fails)
+{
+    ///arrange
+    MEMORY_MAPPED_FILE_VIEW view;
+    STRICT_EXPECTED_CALL(mocked_open(TEST_FILE_NAME, O_RDONLY | O_CLOEXEC));
+    STRICT_EXPECTED_CALL(mocked_fstat(TEST_FD, IGNORED_ARG))
+        .SetReturn(-1);
+    STRICT_EXPECTED_CALL(mocked_close(TEST_FD));
+
+    ///act
+    int result = memory_mapped_file_map(TEST_FILE_NAME, 0, 0, MEMORY_MAPPED_FILE_ACCESS_HINT_NORMAL, &view);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_MEMORY_MAPPED_FILE_12_014: [ If there are any failures then memory_mapped_file_map shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(memory_mapped_file_map_when_mmap_fails_fails)
+{
+    ///arrange
+    MEMORY_MAPPED_FILE_VIEW view;
+    test_file_size = 10000;
+    setup_open_and_fstat();
+    STRICT_EXPECTED_CALL(mocked_sysconf(_SC_PAGESIZE));
+    STRICT_EXPECTED_CALL(mocked_mmap(NULL, 10000, PROT_READ, MAP_SHARED, TEST_FD, 0))
+        .SetReturn(MAP_FAILED);
+    STRICT_EXPECTED_CALL(mocked_close(TEST_FD));
+
+    ///act
+    int result = memory_mapped_file_map(TEST_FILE_NAME, 0, 0, MEMORY_MAPPED_FILE_ACCESS_HINT_SEQUENTIAL, &view);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* memory_mapped_file_unmap */
+
+/*Tests_SRS_MEMORY_MAPPED_FILE_12_015: [ If view is NULL then memory_mapped_file_unmap shall return. ]*/
+TEST_FUNCTION(memory_mapped_file_unmap_with_view_NULL_returns)
+{
+    ///act
+    memory_mapped_file_unmap(NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_MEMORY_MAPPED_FILE_12_016: [ If view is empty then memory_mapped_file_unmap shall return. ]*/
+TEST_FUNCTION(memory_mapped_file_unmap_with_an_empty_view_returns)
+{
+    ///arrange
+    MEMORY_MAPPED_FILE_VIEW view = { 0 };
+
+    ///act
+    memory_mapped_file_unmap(&view);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(view.mapping_base);
+}
+
+/*Tests_SRS_MEMORY_MAPPED_FILE_12_017: [ memory_mapped_file_unmap shall unmap the view. ]*/
+TEST_FUNCTION(memory_mapped_file_unmap_calls_munmap)
+{
+    ///arrange
+    MEMORY_MAPPED_FILE_VIEW view;
+    map_test_view(&view);
+
+    STRICT_EXPECTED_CALL(mocked_munmap(TEST_MAPPING_BASE, 5000 - TEST_PAGE_SIZE + 100));
+
+    ///act
+    memory_mapped_file_unmap(&view);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(view.mapping_base);
+    ASSERT_ARE_EQUAL(size_t, 0, view.mapping_size);
+    ASSERT_IS_NULL(view.content);
+    ASSERT_ARE_EQUAL(uint32_t, 0, view.content_size);
+}
+
+/*Tests_SRS_MEMORY_MAPPED_FILE_12_017: [ memory_mapped_file_unmap shall unmap the view. ]*/
+TEST_FUNCTION(memory_mapped_file_unmap_when_munmap_fails_still_empties_the_view)
+{
+    ///arrange
+    MEMORY_MAPPED_FILE_VIEW view;
+    map_test_view(&view);
+
+    STRICT_EXPECTED_CALL(mocked_munmap(TEST_MAPPING_BASE, 5000 - TEST_PAGE_SIZE + 100))
+        .SetReturn(-1);
+
+    ///act
+    memory_mapped_file_unmap(&view);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(view.mapping_base);
+    ASSERT_ARE_EQUAL(uint32_t, 0, view.content_size);
+}
+
+END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
@@ -0,0 +1,66 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "windows.h"
+
+#define CreateFileA mocked_CreateFileA
+#define GetFileSizeEx mocked_GetFileSizeEx
+#define CreateFileMappingA mocked_CreateFileMappingA
+#define GetSystemInfo mocked_GetSystemInfo
+#define MapViewOfFile mocked_MapViewOfFile
+#define PrefetchVirtualMemory mocked_PrefetchVirtualMemory
+#define UnmapViewOfFile mocked_UnmapViewOfFile
+#define CloseHandle mocked_CloseHandle
+
+extern HANDLE mocked_CreateFileA(
+    LPCSTR                lpFileName,
+    DWORD                 dwDesiredAccess,
+    DWORD                 dwShareMode,
+    LPSECURITY_ATTRIBUTES lpSecurityAttributes,
+    DWORD                 dwCreationDisposition,
+    DWORD                 dwFlagsAndAttributes,
+    HANDLE                hTemplateFile
+);
+
+extern BOOL mocked_GetFileSizeEx(
+    HANDLE         hFile,
+    PLARGE_INTEGER lpFileSize
+);
+
+extern HANDLE mocked_CreateFileMappingA(
+    HANDLE                hFile,
+    LPSECURITY_ATTRIBUTES lpFileMappingAttributes,
+    DWORD                 flProtect,
+    DWORD                 dwMaximumSizeHigh,
+    DWORD                 dwMaximumSizeLow,
+    LPCSTR                lpName
+);
+
+extern void mocked_GetSystemInfo(
+    LPSYSTEM_INFO lpSystemInfo
+);
+
+extern LPVOID mocked_MapViewOfFile(
+    HANDLE hFileMappingObject,
+    DWORD  dwDesiredAccess,
+    DWORD  dwFileOffsetHigh,
+    DWORD  dwFileOffsetLow,
+    SIZE_T dwNumberOfBytesToMap
+);
+
+extern BOOL mocked_PrefetchVirtualMemory(
+    HANDLE                    hProcess,
+    ULONG_PTR                 NumberOfEntries,
+    PWIN32_MEMORY_RANGE_ENTRY VirtualAddresses,
+    ULONG                     Flags
+);
+
+extern BOOL mocked_UnmapViewOfFile(
+    LPCVOID lpBaseAddress
+);
+
+extern BOOL mocked_CloseHandle(
+    HANDLE hObject
+);
+
+#include "../../src/memory_mapped_file_win32.c"
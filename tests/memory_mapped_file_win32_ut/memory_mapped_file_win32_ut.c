@@ -0,0 +1,601 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "memory_mapped_file_win32_ut_pch.h"
+
+#include "umock_c/umock_c_ENABLE_MOCKS.h" // ============================== ENABLE_MOCKS
+#undef ENABLE_MOCKS_DECL
+#include "umock_c/umock_c_prod.h"
+    MOCKABLE_FUNCTION(, HANDLE, mocked_CreateFileA,
+        LPCSTR                , lpFileName,
+        DWORD                 , dwDesiredAccess,
+        DWORD                 , dwShareMode,
+        LPSECURITY_ATTRIBUTES , lpSecurityAttributes,
+        DWORD                 , dwCreationDisposition,
+        DWORD                 , dwFlagsAndAttributes,
+        HANDLE                , hTemplateFile
+    );
+
+    MOCKABLE_FUNCTION(, BOOL, mocked_GetFileSizeEx,
+        HANDLE         , hFile,
+        PLARGE_INTEGER , lpFileSize
+    );
+
+    MOCKABLE_FUNCTION(, HANDLE, mocked_CreateFileMappingA,
+        HANDLE                , hFile,
+        LPSECURITY_ATTRIBUTES , lpFileMappingAttributes,
+        DWORD                 , flProtect,
+        DWORD                 , dwMaximumSizeHigh,
+        DWORD                 , dwMaximumSizeLow,
+        LPCSTR                , lpName
+    );
+
+    MOCKABLE_FUNCTION(, void, mocked_GetSystemInfo,
+        LPSYSTEM_INFO , lpSystemInfo
+    );
+
+    MOCKABLE_FUNCTION(, LPVOID, mocked_MapViewOfFile,
+        HANDLE , hFileMappingObject,
+        DWORD  , dwDesiredAccess,
+        DWORD  , dwFileOffsetHigh,
+        DWORD  , dwFileOffsetLow,
+        SIZE_T , dwNumberOfBytesToMap
+    );
+
+    MOCKABLE_FUNCTION(, BOOL, mocked_PrefetchVirtualMemory,
+        HANDLE                    , hProcess,
+        ULONG_PTR                 , NumberOfEntries,
+        PWIN32_MEMORY_RANGE_ENTRY , VirtualAddresses,
+        ULONG                     , Flags
+    );
+
+    MOCKABLE_FUNCTION(, BOOL, mocked_UnmapViewOfFile,
+        LPCVOID , lpBaseAddress
+    );
+
+    MOCKABLE_FUNCTION(, BOOL, mocked_CloseHandle,
+        HANDLE , hObject
+    );
+#include "umock_c/umock_c_DISABLE_MOCKS.h" // ============================== DISABLE_MOCKS
+
+#define TEST_FILE_NAME "memory_mapped_file_win32_ut.bin"
+#define TEST_FILE_HANDLE ((HANDLE)0x4201)
+#define TEST_MAPPING_HANDLE ((HANDLE)0x4202)
+#define TEST_ALLOCATION_GRANULARITY 65536
+#define TEST_MAPPING_BASE ((void*)0x42420000)
+
+static uint64_t test_file_size;
+
+static BOOL hook_mocked_GetFileSizeEx(HANDLE hFile, PLARGE_INTEGER lpFileSize)
+{
+    (void)hFile;
+    lpFileSize->QuadPart = (LONGLONG)test_file_size;
+    return TRUE;
+}
+
+static void hook_mocked_GetSystemInfo(LPSYSTEM_INFO lpSystemInfo)
+{
+    (void)memset(lpSystemInfo, 0, sizeof(*lpSystemInfo));
+    lpSystemInfo->dwAllocationGranularity = TEST_ALLOCATION_GRANULARITY;
+}
+
+static void setup_CreateFileA_and_GetFileSizeEx(DWORD flags_and_attributes)
+{
+    STRICT_EXPECTED_CALL(mocked_CreateFileA(TEST_FILE_NAME, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, flags_and_attributes, NULL));
+    STRICT_EXPECTED_CALL(mocked_GetFileSizeEx(TEST_FILE_HANDLE, IGNORED_ARG));
+}
+
+static void setup_CreateFileMappingA_and_GetSystemInfo(void)
+{
+    STRICT_EXPECTED_CALL(mocked_CreateFileMappingA(TEST_FILE_HANDLE, NULL, PAGE_READONLY, 0, 0, NULL));
+    STRICT_EXPECTED_CALL(mocked_GetSystemInfo(IGNORED_ARG));
+}
+
+static void map_test_view(MEMORY_MAPPED_FILE_VIEW* view)
+{
+    test_file_size = 100000;
+    setup_CreateFileA_and_GetFileSizeEx(FILE_ATTRIBUTE_NORMAL);
+    setup_CreateFileMappingA_and_GetSystemInfo();
+    STRICT_EXPECTED_CALL(mocked_MapViewOfFile(TEST_MAPPING_HANDLE, FILE_MAP_READ, 0, TEST_ALLOCATION_GRANULARITY, 70000 - TEST_ALLOCATION_GRANULARITY + 100));
+    STRICT_EXPECTED_CALL(mocked_CloseHandle(TEST_MAPPING_HANDLE));
+    STRICT_EXPECTED_CALL(mocked_CloseHandle(TEST_FILE_HANDLE));
+    ASSERT_ARE_EQUAL(int, 0, memory_mapped_file_map(TEST_FILE_NAME, 70000, 100, MEMORY_MAPPED_FILE_ACCESS_HINT_NORMAL, view));
+    umock_c_reset_all_calls();
+}
+
+MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    ASSERT_FAIL("umock_c reported error :%" PRI_MU_ENUM "", MU_ENUM_VALUE(UMOCK_C_ERROR_CODE, error_code));
+}
+
+BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    ASSERT_ARE_EQUAL(int, 0, umock_c_init(on_umock_c_error), "umock_c_init");
+
+    ASSERT_ARE_EQUAL(int, 0, umocktypes_stdint_register_types(), "umocktypes_stdint_register_types");
+
+    ASSERT_ARE_EQUAL(int, 0, umocktypes_charptr_register_types(), "umocktypes_charptr_register_types");
+
+    ASSERT_ARE_EQUAL(int, 0, umocktypes_bool_register_types(), "umocktypes_bool_register_types");
+
+    REGISTER_UMOCK_ALIAS_TYPE(LPCSTR, const char*);
+    REGISTER_UMOCK_ALIAS_TYPE(DWORD, uint32_t);
+    REGISTER_UMOCK_ALIAS_TYPE(ULONG, uint32_t);
+    REGISTER_UMOCK_ALIAS_TYPE(ULONG_PTR, size_t);
+    REGISTER_UMOCK_ALIAS_TYPE(SIZE_T, size_t);
+    REGISTER_UMOCK_ALIAS_TYPE(LPSECURITY_ATTRIBUTES, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(LPVOID, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(LPCVOID, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(PLARGE_INTEGER, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(LPSYSTEM_INFO, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(PWIN32_MEMORY_RANGE_ENTRY, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(BOOL, int);
+
+    REGISTER_GLOBAL_MOCK_RETURNS(mocked_CreateFileA, TEST_FILE_HANDLE, INVALID_HANDLE_VALUE);
+    REGISTER_GLOBAL_MOCK_HOOK(mocked_GetFileSizeEx, hook_mocked_GetFileSizeEx);
+    REGISTER_GLOBAL_MOCK_RETURNS(mocked_CreateFileMappingA, TEST_MAPPING_HANDLE, NULL);
+    REGISTER_GLOBAL_MOCK_HOOK(mocked_GetSystemInfo, hook_mocked_GetSystemInfo);
+    REGISTER_GLOBAL_MOCK_RETURNS(mocked_MapViewOfFile, TEST_MAPPING_BASE, NULL);
+    REGISTER_GLOBAL_MOCK_RETURNS(mocked_PrefetchVirtualMemory, TRUE, FALSE);
+    REGISTER_GLOBAL_MOCK_RETURNS(mocked_UnmapViewOfFile, TRUE, FALSE);
+    REGISTER_GLOBAL_MOCK_RETURNS(mocked_CloseHandle, TRUE, FALSE);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    umock_c_deinit();
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    umock_c_reset_all_calls();
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+}
+
+/* memory_mapped_file_map */
+
+/*Tests_SRS_MEMORY_MAPPED_FILE_12_001: [ If file_name is NULL then memory_mapped_file_map shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(memory_mapped_file_map_with_file_name_NULL_fails)
+{
+    ///arrange
+    MEMORY_MAPPED_FILE_VIEW view;
+
+    ///act
+    int result = memory_mapped_file_map(NULL, 0, 0, MEMORY_MAPPED_FILE_ACCESS_HINT_NORMAL, &view);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_MEMORY_MAPPED_FILE_12_002: [ If hint is not a valid MEMORY_MAPPED_FILE_ACCESS_HINT then memory_mapped_file_map shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(memory_mapped_file_map_with_invalid_hint_fails)
+{
+    ///arrange
+    MEMORY_MAPPED_FILE_VIEW view;
+
+    ///act
+    int result = memory_mapped_file_map(TEST_FILE_NAME, 0, 0, (MEMORY_MAPPED_FILE_ACCESS_HINT)(MEMORY_MAPPED_FILE_ACCESS_HINT_WILLNEED + 1), &view);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_MEMORY_MAPPED_FILE_12_003: [ If view is NULL then memory_mapped_file_map shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(memory_mapped_file_map_with_view_NULL_fails)
+{
+    ///act
+    int result = memory_mapped_file_map(TEST_FILE_NAME, 0, 0, MEMORY_MAPPED_FILE_ACCESS_HINT_NORMAL, NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_MEMORY_MAPPED_FILE_12_004: [ memory_mapped_file_map shall open file_name for reading. ]*/
+/*Tests_SRS_MEMORY_MAPPED_FILE_12_005: [ memory_mapped_file_map shall get the size of the file. ]*/
+/*Tests_SRS_MEMORY_MAPPED_FILE_12_010: [ memory_mapped_file_map shall map the file read-only and shared starting from offset rounded down to the OS mapping granularity. ]*/
+/*Tests_SRS_MEMORY_MAPPED_FILE_12_012: [ memory_mapped_file_map shall fill view with the mapping and the address and size of the requested range, succeed and return 0. ]*/
+/*Tests_SRS_MEMORY_MAPPED_FILE_12_013: [ memory_mapped_file_map shall close the file. ]*/
+TEST_FUNCTION(memory_mapped_file_map_with_hint_NORMAL_succeeds)
+{
+    ///arrange
+    MEMORY_MAPPED_FILE_VIEW view;
+    test_file_size = 100000;
+    setup_CreateFileA_and_GetFileSizeEx(FILE_ATTRIBUTE_NORMAL);
+    setup_CreateFileMappingA_and_GetSystemInfo();
+    STRICT_EXPECTED_CALL(mocked_MapViewOfFile(TEST_MAPPING_HANDLE, FILE_MAP_READ, 0, TEST_ALLOCATION_GRANULARITY, 70000 - TEST_ALLOCATION_GRANULARITY + 100));
+    STRICT_EXPECTED_CALL(mocked_CloseHandle(TEST_MAPPING_HANDLE));
+    STRICT_EXPECTED_CALL(mocked_CloseHandle(TEST_FILE_HANDLE));
+
+    ///act
+    int result = memory_mapped_file_map(TEST_FILE_NAME, 70000, 100, MEMORY_MAPPED_FILE_ACCESS_HINT_NORMAL, &view);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, TEST_MAPPING_BASE, view.mapping_base);
+    ASSERT_ARE_EQUAL(size_t, 70000 - TEST_ALLOCATION_GRANULARITY + 100, view.mapping_size);
+    ASSERT_ARE_EQUAL(void_ptr, (const unsigned char*)TEST_MAPPING_BASE + 70000 - TEST_ALLOCATION_GRANULARITY, view.content);
+    ASSERT_ARE_EQUAL(uint32_t, 100, view.content_size);
+}
+
+/*Tests_SRS_MEMORY_MAPPED_FILE_12_010: [ memory_mapped_file_map shall map the file read-only and shared starting from offset rounded down to the OS mapping granularity. ]*/
+TEST_FUNCTION(memory_mapped_file_map_passes_the_high_32_bits_of_the_offset_to_MapViewOfFile)
+{
+    ///arrange
+    MEMORY_MAPPED_FILE_VIEW view;
+    test_file_size = 0x500000000;
+    setup_CreateFileA_and_GetFileSizeEx(FILE_ATTRIBUTE_NORMAL);
+    setup_CreateFileMappingA_and_GetSystemInfo();
+    STRICT_EXPECTED_CALL(mocked_MapViewOfFile(TEST_MAPPING_HANDLE, FILE_MAP_READ, 4, 2 * TEST_ALLOCATION_GRANULARITY, 10));
+    STRICT_EXPECTED_CALL(mocked_CloseHandle(TEST_MAPPING_HANDLE));
+    STRICT_EXPECTED_CALL(mocked_CloseHandle(TEST_FILE_HANDLE));
+
+    ///act
+    int result = memory_mapped_file_map(TEST_FILE_NAME, 0x400000000 + 2 * TEST_ALLOCATION_GRANULARITY, 10, MEMORY_MAPPED_FILE_ACCESS_HINT_NORMAL, &view);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, TEST_MAPPING_BASE, view.content);
+    ASSERT_ARE_EQUAL(uint32_t, 10, view.content_size);
+}
+
+/*Tests_SRS_MEMORY_MAPPED_FILE_12_011: [ memory_mapped_file_map shall pass hint to the OS (madvise on Linux, file flags and PrefetchVirtualMemory on Windows). A failure to apply the hint shall not fail memory_mapped_file_map. ]*/
+TEST_FUNCTION(memory_mapped_file_map_with_hint_SEQUENTIAL_opens_the_file_with_FILE_FLAG_SEQUENTIAL_SCAN)
+{
+    ///arrange
+    MEMORY_MAPPED_FILE_VIEW view;
+    test_file_size = 10000;
+    setup_CreateFileA_and_GetFileSizeEx(FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN);
+    setup_CreateFileMappingA_and_GetSystemInfo();
+    STRICT_EXPECTED_CALL(mocked_MapViewOfFile(TEST_MAPPING_HANDLE, FILE_MAP_READ, 0, 0, 10000));
+    STRICT_EXPECTED_CALL(mocked_CloseHandle(TEST_MAPPING_HANDLE));
+    STRICT_EXPECTED_CALL(mocked_CloseHandle(TEST_FILE_HANDLE));
+
+    ///act
+    int result = memory_mapped_file_map(TEST_FILE_NAME, 0, 10000, MEMORY_MAPPED_FILE_ACCESS_HINT_SEQUENTIAL, &view);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, TEST_MAPPING_BASE, view.mapping_base);
+    ASSERT_ARE_EQUAL(uint32_t, 10000, view.content_size);
+}
+
+/*Tests_SRS_MEMORY_MAPPED_FILE_12_011: [ memory_mapped_file_map shall pass hint to the OS (madvise on Linux, file flags and PrefetchVirtualMemory on Windows). A failure to apply the hint shall not fail memory_mapped_file_map. ]*/
+TEST_FUNCTION(memory_mapped_file_map_with_hint_RANDOM_opens_the_file_with_FILE_FLAG_RANDOM_ACCESS)
+{
+    ///arrange
+    MEMORY_MAPPED_FILE_VIEW view;
+    test_file_size = 10000;
+    setup_CreateFileA_and_GetFileSizeEx(FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS);
+    setup_CreateFileMappingA_and_GetSystemInfo();
+    STRICT_EXPECTED_CALL(mocked_MapViewOfFile(TEST_MAPPING_HANDLE, FILE_MAP_READ, 0, 0, 10000));
+    STRICT_EXPECTED_CALL(mocked_CloseHandle(TEST_MAPPING_HANDLE));
+    STRICT_EXPECTED_CALL(mocked_CloseHandle(TEST_FILE_HANDLE));
+
+    ///act
+    int result = memory_mapped_file_map(TEST_FILE_NAME, 0, 10000, MEMORY_MAPPED_FILE_ACCESS_HINT_RANDOM, &view);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_MEMORY_MAPPED_FILE_12_011: [ memory_mapped_file_map shall pass hint to the OS (madvise on Linux, file flags and PrefetchVirtualMemory on Windows). A failure to apply the hint shall not fail memory_mapped_file_map. ]*/
+TEST_FUNCTION(memory_mapped_file_map_with_hint_WILLNEED_calls_PrefetchVirtualMemory)
+{
+    ///arrange
+    MEMORY_MAPPED_FILE_VIEW view;
+    test_file_size = 10000;
+    setup_CreateFileA_and_GetFileSizeEx(FILE_ATTRIBUTE_NORMAL);
+    setup_CreateFileMappingA_and_GetSystemInfo();
+    STRICT_EXPECTED_CALL(mocked_MapViewOfFile(TEST_MAPPING_HANDLE, FILE_MAP_READ, 0, 0, 10000));
+    STRICT_EXPECTED_CALL(mocked_PrefetchVirtualMemory(GetCurrentProcess(), 1, IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(mocked_CloseHandle(TEST_MAPPING_HANDLE));
+    STRICT_EXPECTED_CALL(mocked_CloseHandle(TEST_FILE_HANDLE));
+
+    ///act
+    int result = memory_mapped_file_map(TEST_FILE_NAME, 0, 10000, MEMORY_MAPPED_FILE_ACCESS_HINT_WILLNEED, &view);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, TEST_MAPPING_BASE, view.mapping_base);
+}
+
+/*Tests_SRS_MEMORY_MAPPED_FILE_12_011: [ memory_mapped_file_map shall pass hint to the OS (madvise on Linux, file flags and PrefetchVirtualMemory on Windows). A failure to apply the hint shall not fail memory_mapped_file_map. ]*/
+TEST_FUNCTION(memory_mapped_file_map_when_PrefetchVirtualMemory_fails_succeeds)
+{
+    ///arrange
+    MEMORY_MAPPED_FILE_VIEW view;
+    test_file_size = 10000;
+    setup_CreateFileA_and_GetFileSizeEx(FILE_ATTRIBUTE_NORMAL);
+    setup_CreateFileMappingA_and_GetSystemInfo();
+    STRICT_EXPECTED_CALL(mocked_MapViewOfFile(TEST_MAPPING_HANDLE, FILE_MAP_READ, 0, 0, 10000));
+    STRICT_EXPECTED_CALL(mocked_PrefetchVirtualMemory(GetCurrentProcess(), 1, IGNORED_ARG, 0))
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mocked_CloseHandle(TEST_MAPPING_HANDLE));
+    STRICT_EXPECTED_CALL(mocked_CloseHandle(TEST_FILE_HANDLE));
+
+    ///act
+    int result = memory_mapped_file_map(TEST_FILE_NAME, 0, 10000, MEMORY_MAPPED_FILE_ACCESS_HINT_WILLNEED, &view);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, TEST_MAPPING_BASE, view.mapping_base);
+    ASSERT_ARE_EQUAL(uint32_t, 10000, view.content_size);
+}
+
+/*Tests_SRS_MEMORY_MAPPED_FILE_12_013: [ memory_mapped_file_map shall close the file. ]*/
+TEST_FUNCTION(memory_mapped_file_map_when_CloseHandle_fails_succeeds)
+{
+    ///arrange
+    MEMORY_MAPPED_FILE_VIEW view;
+    test_file_size = 10000;
+    setup_CreateFileA_and_GetFileSizeEx(FILE_ATTRIBUTE_NORMAL);
+    setup_CreateFileMappingA_and_GetSystemInfo();
+    STRICT_EXPECTED_CALL(mocked_MapViewOfFile(TEST_MAPPING_HANDLE, FILE_MAP_READ, 0, 0, 10000));
+    STRICT_EXPECTED_CALL(mocked_CloseHandle(TEST_MAPPING_HANDLE))
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mocked_CloseHandle(TEST_FILE_HANDLE))
+        .SetReturn(FALSE);
+
+    ///act
+    int result = memory_mapped_file_map(TEST_FILE_NAME, 0, 10000, MEMORY_MAPPED_FILE_ACCESS_HINT_NORMAL, &view);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, TEST_MAPPING_BASE, view.mapping_base);
+}
+
+/*Tests_SRS_MEMORY_MAPPED_FILE_12_012: [ memory_mapped_file_map shall fill view with the mapping and the address and size of the requested range, succeed and return 0. ]*/
+TEST_FUNCTION(memory_mapped_file_map_with_size_0_maps_until_the_end_of_the_file)
+{
+    ///arrange
+    MEMORY_MAPPED_FILE_VIEW view;
+    test_file_size = 100000;
+    setup_CreateFileA_and_GetFileSizeEx(FILE_ATTRIBUTE_NORMAL);
+    setup_CreateFileMappingA_and_GetSystemInfo();
+    STRICT_EXPECTED_CALL(mocked_MapViewOfFile(TEST_MAPPING_HANDLE, FILE_MAP_READ, 0, TEST_ALLOCATION_GRANULARITY, 100000 - TEST_ALLOCATION_GRANULARITY));
+    STRICT_EXPECTED_CALL(mocked_CloseHandle(TEST_MAPPING_HANDLE));
+    STRICT_EXPECTED_CALL(mocked_CloseHandle(TEST_FILE_HANDLE));
+
+    ///act
+    int result = memory_mapped_file_map(TEST_FILE_NAME, TEST_ALLOCATION_GRANULARITY, 0, MEMORY_MAPPED_FILE_ACCESS_HINT_NORMAL, &view);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, TEST_MAPPING_BASE, view.mapping_base);
+    ASSERT_ARE_EQUAL(size_t, 100000 - TEST_ALLOCATION_GRANULARITY, view.mapping_size);
+    ASSERT_ARE_EQUAL(void_ptr, TEST_MAPPING_BASE, view.content);
+    ASSERT_ARE_EQUAL(uint32_t, 100000 - TEST_ALLOCATION_GRANULARITY, view.content_size);
+}
+
+/*Tests_SRS_MEMORY_MAPPED_FILE_12_006: [ If offset is greater than the size of the file then memory_mapped_file_map shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(memory_mapped_file_map_with_offset_greater_than_the_file_size_fails)
+{
+    ///arrange
+    MEMORY_MAPPED_FILE_VIEW view;
+    test_file_size = 10000;
+    setup_CreateFileA_and_GetFileSizeEx(FILE_ATTRIBUTE_NORMAL);
+    STRICT_EXPECTED_CALL(mocked_CloseHandle(TEST_FILE_HANDLE));
+
+    ///act
+    int result = memory_mapped_file_map(TEST_FILE_NAME, 10001, 0, MEMORY_MAPPED_FILE_ACCESS_HINT_NORMAL, &view);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_MEMORY_MAPPED_FILE_12_007: [ If offset + size exceeds the size of the file then memory_mapped_file_map shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(memory_mapped_file_map_with_offset_plus_size_exceeding_the_file_size_fails)
+{
+    ///arrange
+    MEMORY_MAPPED_FILE_VIEW view;
+    test_file_size = 10000;
+    setup_CreateFileA_and_GetFileSizeEx(FILE_ATTRIBUTE_NORMAL);
+    STRICT_EXPECTED_CALL(mocked_CloseHandle(TEST_FILE_HANDLE));
+
+    ///act
+    int result = memory_mapped_file_map(TEST_FILE_NAME, 9000, 1001, MEMORY_MAPPED_FILE_ACCESS_HINT_NORMAL, &view);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_MEMORY_MAPPED_FILE_12_008: [ If size is 0 and the number of bytes from offset to the end of the file exceeds UINT32_MAX then memory_mapped_file_map shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(memory_mapped_file_map_with_size_0_and_more_than_UINT32_MAX_bytes_until_the_end_of_the_file_fails)
+{
+    ///arrange
+    MEMORY_MAPPED_FILE_VIEW view;
+    test_file_size = (uint64_t)UINT32_MAX + 2;
+    setup_CreateFileA_and_GetFileSizeEx(FILE_ATTRIBUTE_NORMAL);
+    STRICT_EXPECTED_CALL(mocked_CloseHandle(TEST_FILE_HANDLE));
+
+    ///act
+    int result = memory_mapped_file_map(TEST_FILE_NAME, 1, 0, MEMORY_MAPPED_FILE_ACCESS_HINT_NORMAL, &view);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_MEMORY_MAPPED_FILE_12_009: [ If the range to map has 0 bytes then memory_mapped_file_map shall set view to an empty view, succeed and return 0. ]*/
+TEST_FUNCTION(memory_mapped_file_map_with_offset_at_the_end_of_the_file_returns_an_empty_view)
+{
+    ///arrange
+    MEMORY_MAPPED_FILE_VIEW view;
+    (void)memset(&view, 0xFF, sizeof(view));
+    test_file_size = 10000;
+    setup_CreateFileA_and_GetFileSizeEx(FILE_ATTRIBUTE_NORMAL);
+    STRICT_EXPECTED_CALL(mocked_CloseHandle(TEST_FILE_HANDLE));
+
+    ///act
+    int result = memory_mapped_file_map(TEST_FILE_NAME, 10000, 0, MEMORY_MAPPED_FILE_ACCESS_HINT_WILLNEED, &view);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(view.mapping_base);
+    ASSERT_ARE_EQUAL(size_t, 0, view.mapping_size);
+    ASSERT_IS_NULL(view.content);
+    ASSERT_ARE_EQUAL(uint32_t, 0, view.content_size);
+}
+
+/*Tests_SRS_MEMORY_MAPPED_FILE_12_014: [ If there are any failures then memory_mapped_file_map shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(memory_mapped_file_map_when_CreateFileA_fails_fails)
+{
+    ///arrange
+    MEMORY_MAPPED_FILE_VIEW view;
+    STRICT_EXPECTED_CALL(mocked_CreateFileA(TEST_FILE_NAME, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL))
+        .SetReturn(INVALID_HANDLE_VALUE);
+
+    ///act
+    int result = memory_mapped_file_map(TEST_FILE_NAME, 0, 0, MEMORY_MAPPED_FILE_ACCESS_HINT_NORMAL, &view);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_MEMORY_MAPPED_FILE_12_014: [ If there are any failures then memory_mapped_file_map shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(memory_mapped_file_map_when_GetFileSizeEx_fails_fails)
+{
+    ///arrange
+    MEMORY_MAPPED_FILE_VIEW view;
+    STRICT_EXPECTED_CALL(mocked_CreateFileA(TEST_FILE_NAME, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL));
+    STRICT_EXPECTED_CALL(mocked_GetFileSizeEx(TEST_FILE_HANDLE, IGNORED_ARG))
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mocked_CloseHandle(TEST_FILE_HANDLE));
+
+    ///act
+    int result = memory_mapped_file_map(TEST_FILE_NAME, 0, 0, MEMORY_MAPPED_FILE_ACCESS_HINT_NORMAL, &view);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_MEMORY_MAPPED_FILE_12_014: [ If there are any failures then memory_mapped_file_map shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(memory_mapped_file_map_when_CreateFileMappingA_fails_fails)
+{
+    ///arrange
+    MEMORY_MAPPED_FILE_VIEW view;
+    test_file_size = 10000;
+    setup_CreateFileA_and_GetFileSizeEx(FILE_ATTRIBUTE_NORMAL);
+    STRICT_EXPECTED_CALL(mocked_CreateFileMappingA(TEST_FILE_HANDLE, NULL, PAGE_READONLY, 0, 0, NULL))
+        .SetReturn(NULL);
+    STRICT_EXPECTED_CALL(mocked_CloseHandle(TEST_FILE_HANDLE));
+
+    ///act
+    int result = memory_mapped_file_map(TEST_FILE_NAME, 0, 0, MEMORY_MAPPED_FILE_ACCESS_HINT_NORMAL, &view);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_MEMORY_MAPPED_FILE_12_014: [ If there are any failures then memory_mapped_file_map shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(memory_mapped_file_map_when_MapViewOfFile_fails_fails)
+{
+    ///arrange
+    MEMORY_MAPPED_FILE_VIEW view;
+    test_file_size = 10000;
+    setup_CreateFileA_and_GetFileSizeEx(FILE_ATTRIBUTE_NORMAL);
+    setup_CreateFileMappingA_and_GetSystemInfo();
+    STRICT_EXPECTED_CALL(mocked_MapViewOfFile(TEST_MAPPING_HANDLE, FILE_MAP_READ, 0, 0, 10000))
+        .SetReturn(NULL);
+    STRICT_EXPECTED_CALL(mocked_CloseHandle(TEST_MAPPING_HANDLE));
+    STRICT_EXPECTED_CALL(mocked_CloseHandle(TEST_FILE_HANDLE));
+
+    ///act
+    int result = memory_mapped_file_map(TEST_FILE_NAME, 0, 0, MEMORY_MAPPED_FILE_ACCESS_HINT_WILLNEED, &view);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* memory_mapped_file_unmap */
+
+/*Tests_SRS_MEMORY_MAPPED_FILE_12_015: [ If view is NULL then memory_mapped_file_unmap shall return. ]*/
+TEST_FUNCTION(memory_mapped_file_unmap_with_view_NULL_returns)
+{
+    ///act
+    memory_mapped_file_unmap(NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_MEMORY_MAPPED_FILE_12_016: [ If view is empty then memory_mapped_file_unmap shall return. ]*/
+TEST_FUNCTION(memory_mapped_file_unmap_with_an_empty_view_returns)
+{
+    ///arrange
+    MEMORY_MAPPED_FILE_VIEW view = { 0 };
+
+    ///act
+    memory_mapped_file_unmap(&view);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(view.mapping_base);
+}
+
+/*Tests_SRS_MEMORY_MAPPED_FILE_12_017: [ memory_mapped_file_unmap shall unmap the view. ]*/
+TEST_FUNCTION(memory_mapped_file_unmap_calls_UnmapViewOfFile)
+{
+    ///arrange
+    MEMORY_MAPPED_FILE_VIEW view;
+    map_test_view(&view);
+
+    STRICT_EXPECTED_CALL(mocked_UnmapViewOfFile(TEST_MAPPING_BASE));
+
+    ///act
+    memory_mapped_file_unmap(&view);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(view.mapping_base);
+    ASSERT_ARE_EQUAL(size_t, 0, view.mapping_size);
+    ASSERT_IS_NULL(view.content);
+    ASSERT_ARE_EQUAL(uint32_t, 0, view.content_size);
+}
+
+/*Tests_SRS_MEMORY_MAPPED_FILE_12_017: [ memory_mapped_file_unmap shall unmap the view. ]*/
+TEST_FUNCTION(memory_mapped_file_unmap_when_UnmapViewOfFile_fails_still_empties_the_view)
+{
+    ///arrange
+    MEMORY_MAPPED_FILE_VIEW view;
+    map_test_view(&view);
+
+    STRICT_EXPECTED_CALL(mocked_UnmapViewOfFile(TEST_MAPPING_BASE))
+        .SetReturn(FALSE);
+
+    ///act
+    memory_mapped_file_unmap(&view);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(view.mapping_base);
+    ASSERT_ARE_EQUAL(uint32_t, 0, view.content_size);
+}
+
+END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
@@ -0,0 +1,28 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+// Precompiled header for memory_mapped_file_win32_ut
+
+#ifndef MEMORY_MAPPED_FILE_WIN32_UT_PCH_H
+#define MEMORY_MAPPED_FILE_WIN32_UT_PCH_H
+
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "windows.h"
+
+#include "macro_utils/macro_utils.h"
+#include "testrunnerswitcher.h"
+
+#include "umock_c/umock_c.h"
+#include "umock_c/umocktypes.h"
+#include "umock_c/umocktypes_stdint.h"
+#include "umock_c/umocktypes_charptr.h"
+#include "umock_c/umocktypes_bool.h"
+
+#include "c_util/memory_mapped_file.h"
+
+#endif // MEMORY_MAPPED_FILE_WIN32_UT_PCH_H
@@ -3,7 +3,12 @@
 
 #include "real_interlocked_renames.h" // IWYU pragma: keep
 #include "real_gballoc_hl_renames.h" // IWYU pragma: keep
+#include "real_constbuffer_accounting_renames.h" // IWYU pragma: keep
+#include "real_crc32c_renames.h" // IWYU pragma: keep
+#include "real_hash_renames.h" // IWYU pragma: keep
+#include "real_lz_codec_renames.h" // IWYU pragma: keep
 #include "real_memory_data_renames.h" // IWYU pragma: keep
+#include "real_memory_mapped_file_renames.h" // IWYU pragma: keep
 
 #include "real_constbuffer_renames.h" // IWYU pragma: keep
 
@@ -21,20 +21,36 @@
         CONSTBUFFER_CreateWithCustomFree, \
         CONSTBUFFER_CreateFromOffsetAndSizeWithCopy, \
         CONSTBUFFER_IncRef, \
+        CONSTBUFFER_TryIncRef, \
         CONSTBUFFER_GetContent, \
         CONSTBUFFER_DecRef, \
         CONSTBUFFER_HANDLE_contain_same, \
+        CONSTBUFFER_GetFingerprint, \
         CONSTBUFFER_CreateFromOffsetAndSize, \
+        CONSTBUFFER_CreateFromMappedFile, \
         CONSTBUFFER_get_serialization_size, \
         CONSTBUFFER_to_buffer, \
         CONSTBUFFER_to_fixed_size_buffer, \
+        CONSTBUFFER_get_serialization_size_v2, \
+        CONSTBUFFER_to_buffer_v2, \
+        CONSTBUFFER_to_fixed_size_buffer_v2, \
         CONSTBUFFER_from_buffer, \
+        CONSTBUFFER_from_buffer_view, \
+        CONSTBUFFER_from_buffer_view_bulk, \
+        CONSTBUFFER_CreateCompressed, \
+        CONSTBUFFER_Decompress, \
+        CONSTBUFFER_CreateSharedHot, \
         CONSTBUFFER_CreateWritableHandle, \
         CONSTBUFFER_GetWritableBuffer, \
         CONSTBUFFER_SealWritableHandle, \
         CONSTBUFFER_WritableHandleIncRef, \
         CONSTBUFFER_WritableHandleDecRef, \
-        CONSTBUFFER_GetWritableBufferSize \
+        CONSTBUFFER_GetWritableBufferSize, \
+        CONSTBUFFER_POOL_Create, \
+        CONSTBUFFER_POOL_Destroy, \
+        CONSTBUFFER_POOL_CreateWritableHandle, \
+        CONSTBUFFER_POOL_GetStatistics, \
+        CONSTBUFFER_POOL_Trim \
 )
 
 
@@ -58,22 +74,44 @@ CONSTBUFFER_HANDLE real_CONSTBUFFER_CreateFromOffsetAndSizeWithCopy(CONSTBUFFER_
 
 void real_CONSTBUFFER_IncRef(CONSTBUFFER_HANDLE constbufferHandle);
 
+bool real_CONSTBUFFER_TryIncRef(CONSTBUFFER_HANDLE constbufferHandle);
+
 const CONSTBUFFER* real_CONSTBUFFER_GetContent(CONSTBUFFER_HANDLE constbufferHandle);
 
 void real_CONSTBUFFER_DecRef(CONSTBUFFER_HANDLE constbufferHandle);
 
 bool real_CONSTBUFFER_HANDLE_contain_same(CONSTBUFFER_HANDLE left, CONSTBUFFER_HANDLE right);
 
+int real_CONSTBUFFER_GetFingerprint(CONSTBUFFER_HANDLE constbufferHandle, uint64_t* fingerprint);
+
 CONSTBUFFER_HANDLE real_CONSTBUFFER_CreateFromOffsetAndSize(CONSTBUFFER_HANDLE handle, uint32_t offset, uint32_t size);
 
+CONSTBUFFER_HANDLE real_CONSTBUFFER_CreateFromMappedFile(const char* file_name, uint64_t offset, uint32_t size, MEMORY_MAPPED_FILE_ACCESS_HINT hint);
+
 uint32_t real_CONSTBUFFER_get_serialization_size(CONSTBUFFER_HANDLE source);
 
 unsigned char* real_CONSTBUFFER_to_buffer(CONSTBUFFER_HANDLE source, CONSTBUFFER_to_buffer_alloc alloc, void* alloc_context, uint32_t* serialized_size);
 
 CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT real_CONSTBUFFER_to_fixed_size_buffer(CONSTBUFFER_HANDLE source, unsigned char* destination, uint32_t destination_size, uint32_t* serialized_size);
 
+uint32_t real_CONSTBUFFER_get_serialization_size_v2(CONSTBUFFER_HANDLE source);
+
+unsigned char* real_CONSTBUFFER_to_buffer_v2(CONSTBUFFER_HANDLE source, CONSTBUFFER_to_buffer_alloc alloc, void* alloc_context, uint32_t* serialized_size);
+
+CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT real_CONSTBUFFER_to_fixed_size_buffer_v2(CONSTBUFFER_HANDLE source, unsigned char* destination, uint32_t destination_size, uint32_t* serialized_size);
+
 CONSTBUFFER_FROM_BUFFER_RESULT real_CONSTBUFFER_from_buffer(const unsigned char* source, uint32_t size, uint32_t* consumed, CONSTBUFFER_HANDLE* destination);
 
+CONSTBUFFER_FROM_BUFFER_RESULT real_CONSTBUFFER_from_buffer_view(CONSTBUFFER_HANDLE source, uint32_t offset, uint32_t* consumed, CONSTBUFFER_HANDLE* destination);
+
+CONSTBUFFER_FROM_BUFFER_RESULT real_CONSTBUFFER_from_buffer_view_bulk(CONSTBUFFER_HANDLE source, uint32_t offset, uint32_t count, uint32_t* consumed, CONSTBUFFER_HANDLE* destinations);
+
+CONSTBUFFER_HANDLE real_CONSTBUFFER_CreateCompressed(CONSTBUFFER_HANDLE source);
+
+CONSTBUFFER_HANDLE real_CONSTBUFFER_Decompress(CONSTBUFFER_HANDLE compressed);
+
+CONSTBUFFER_HANDLE real_CONSTBUFFER_CreateSharedHot(CONSTBUFFER_HANDLE source, uint32_t slot_count);
+
 CONSTBUFFER_WRITABLE_HANDLE real_CONSTBUFFER_CreateWritableHandle(uint32_t size);
 
 unsigned char * real_CONSTBUFFER_GetWritableBuffer(CONSTBUFFER_WRITABLE_HANDLE constbufferWritableHandle);
@@ -86,4 +124,14 @@ void real_CONSTBUFFER_WritableHandleDecRef(CONSTBUFFER_WRITABLE_HANDLE constbuff
 
 uint32_t real_CONSTBUFFER_GetWritableBufferSize(CONSTBUFFER_WRITABLE_HANDLE constbufferWritableHandle);
 
+CONSTBUFFER_POOL_HANDLE real_CONSTBUFFER_POOL_Create(uint32_t max_buffer_size, uint32_t max_retained_per_class);
+
+void real_CONSTBUFFER_POOL_Destroy(CONSTBUFFER_POOL_HANDLE pool);
+
+CONSTBUFFER_WRITABLE_HANDLE real_CONSTBUFFER_POOL_CreateWritableHandle(CONSTBUFFER_POOL_HANDLE pool, uint32_t size);
+
+int real_CONSTBUFFER_POOL_GetStatistics(CONSTBUFFER_POOL_HANDLE pool, CONSTBUFFER_POOL_STATISTICS* statistics);
+
+void real_CONSTBUFFER_POOL_Trim(CONSTBUFFER_POOL_HANDLE pool);
+
 #endif //REAL_CONSTBUFFER_H
@@ -0,0 +1,8 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "real_interlocked_renames.h" // IWYU pragma: keep
+
+#include "real_constbuffer_accounting_renames.h" // IWYU pragma: keep
+
+#include "../../src/constbuffer_accounting.c"
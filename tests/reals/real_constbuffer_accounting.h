@@ -0,0 +1,20 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef REAL_CONSTBUFFER_ACCOUNTING_H
+#define REAL_CONSTBUFFER_ACCOUNTING_H
+
+#include "macro_utils/macro_utils.h"
+
+#include "c_util/constbuffer_accounting.h"
+
+#define R2(X) REGISTER_GLOBAL_MOCK_HOOK(X, real_##X);
+
+#define REGISTER_CONSTBUFFER_ACCOUNTING_GLOBAL_MOCK_HOOK() \
+    MU_FOR_EACH_1(R2, \
+        constbuffer_accounting_get_snapshot \
+    )
+
+int real_constbuffer_accounting_get_snapshot(CONSTBUFFER_ACCOUNTING_SNAPSHOT* snapshot);
+
+#endif //REAL_CONSTBUFFER_ACCOUNTING_H
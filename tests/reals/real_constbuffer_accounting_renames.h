@@ -0,0 +1,11 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef REAL_CONSTBUFFER_ACCOUNTING_RENAMES_H
+#define REAL_CONSTBUFFER_ACCOUNTING_RENAMES_H
+
+#define constbuffer_accounting_add real_constbuffer_accounting_add
+#define constbuffer_accounting_remove real_constbuffer_accounting_remove
+#define constbuffer_accounting_get_snapshot real_constbuffer_accounting_get_snapshot
+
+#endif // REAL_CONSTBUFFER_ACCOUNTING_RENAMES_H
@@ -4,6 +4,8 @@
 #include "real_interlocked_renames.h" // IWYU pragma: keep
 #include "real_constbuffer_renames.h" // IWYU pragma: keep
 #include "real_gballoc_hl_renames.h" // IWYU pragma: keep
+#include "real_constbuffer_accounting_renames.h" // IWYU pragma: keep
+#include "real_hash_renames.h" // IWYU pragma: keep
 
 #include "real_constbuffer_array_renames.h" // IWYU pragma: keep
 
@@ -26,13 +26,27 @@
         constbuffer_array_remove_front, \
         constbuffer_array_add_back, \
         constbuffer_array_remove_back, \
+        constbuffer_array_add_front_shared, \
+        constbuffer_array_remove_front_shared, \
+        constbuffer_array_add_back_shared, \
+        constbuffer_array_remove_back_shared, \
         constbuffer_array_get_buffer_count, \
         constbuffer_array_get_buffer, \
         constbuffer_array_get_buffer_content, \
         constbuffer_array_get_all_buffers_size, \
+        constbuffer_array_get_all_buffers_size_64, \
         constbuffer_array_get_const_buffer_handle_array, \
         constbuffer_array_remove_empty_buffers, \
-        CONSTBUFFER_ARRAY_HANDLE_contain_same \
+        constbuffer_array_create_compressed, \
+        constbuffer_array_create_decompressed, \
+        constbuffer_array_copy_to, \
+        constbuffer_array_flatten, \
+        CONSTBUFFER_ARRAY_HANDLE_contain_same, \
+        constbuffer_array_content_equal, \
+        constbuffer_array_get_fingerprint, \
+        constbuffer_array_compute_hash, \
+        constbuffer_array_find, \
+        constbuffer_array_find_byte \
 )
 
 #include "c_util/constbuffer.h"
@@ -62,16 +76,38 @@ CONSTBUFFER_ARRAY_HANDLE real_constbuffer_array_add_back(CONSTBUFFER_ARRAY_HANDL
 /*remove back*/
 CONSTBUFFER_ARRAY_HANDLE real_constbuffer_array_remove_back(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle, CONSTBUFFER_HANDLE* constbuffer_handle);
 
+/*add/remove shared*/
+CONSTBUFFER_ARRAY_HANDLE real_constbuffer_array_add_front_shared(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle, CONSTBUFFER_HANDLE constbuffer_handle);
+CONSTBUFFER_ARRAY_HANDLE real_constbuffer_array_remove_front_shared(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle, CONSTBUFFER_HANDLE* constbuffer_handle);
+CONSTBUFFER_ARRAY_HANDLE real_constbuffer_array_add_back_shared(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle, CONSTBUFFER_HANDLE constbuffer_handle);
+CONSTBUFFER_ARRAY_HANDLE real_constbuffer_array_remove_back_shared(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle, CONSTBUFFER_HANDLE* constbuffer_handle);
+
 /*remove empty buffers*/
 CONSTBUFFER_ARRAY_HANDLE real_constbuffer_array_remove_empty_buffers(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle);
 
+/*compression*/
+CONSTBUFFER_ARRAY_HANDLE real_constbuffer_array_create_compressed(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle);
+CONSTBUFFER_ARRAY_HANDLE real_constbuffer_array_create_decompressed(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle);
+
 /* getters */
 int real_constbuffer_array_get_buffer_count(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle, uint32_t* buffer_count);
 CONSTBUFFER_HANDLE real_constbuffer_array_get_buffer(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle, uint32_t buffer_index);
 const CONSTBUFFER* real_constbuffer_array_get_buffer_content(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle, uint32_t buffer_index);
 int real_constbuffer_array_get_all_buffers_size(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle, uint32_t* all_buffers_size);
+int real_constbuffer_array_get_all_buffers_size_64(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle, uint64_t* all_buffers_size);
 const CONSTBUFFER_HANDLE* real_constbuffer_array_get_const_buffer_handle_array(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle);
+
+/*copy out*/
+int real_constbuffer_array_copy_to(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle, uint64_t offset, uint64_t length, unsigned char* destination);
+CONSTBUFFER_HANDLE real_constbuffer_array_flatten(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle);
+
 bool real_CONSTBUFFER_ARRAY_HANDLE_contain_same(CONSTBUFFER_ARRAY_HANDLE left, CONSTBUFFER_ARRAY_HANDLE right);
+bool real_constbuffer_array_content_equal(CONSTBUFFER_ARRAY_HANDLE left, CONSTBUFFER_ARRAY_HANDLE right);
+int real_constbuffer_array_get_fingerprint(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle, uint64_t* fingerprint);
+int real_constbuffer_array_compute_hash(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle, uint64_t seed, uint64_t* hash);
+
+CONSTBUFFER_ARRAY_FIND_RESULT real_constbuffer_array_find(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle, const unsigned char* pattern, uint32_t pattern_length, uint64_t start_offset, CONSTBUFFER_ARRAY_POSITION* position);
+CONSTBUFFER_ARRAY_FIND_RESULT real_constbuffer_array_find_byte(CONSTBUFFER_ARRAY_HANDLE constbuffer_array_handle, unsigned char value, uint64_t start_offset, CONSTBUFFER_ARRAY_POSITION* position);
 
 
 
@@ -11,7 +11,20 @@
 #define REGISTER_CONSTBUFFER_ARRAY_BATCHER_GLOBAL_MOCK_HOOK() \
     MU_FOR_EACH_1(R2, \
         constbuffer_array_batcher_nv_batch, \
-        constbuffer_array_batcher_nv_unbatch \
+        constbuffer_array_batcher_nv_unbatch, \
+        constbuffer_array_batcher_nv_builder_create, \
+        constbuffer_array_batcher_nv_builder_destroy, \
+        constbuffer_array_batcher_nv_builder_append, \
+        constbuffer_array_batcher_nv_builder_can_append, \
+        constbuffer_array_batcher_nv_builder_get_size, \
+        constbuffer_array_batcher_nv_builder_seal, \
+        constbuffer_array_batcher_nv_view_create, \
+        constbuffer_array_batcher_nv_view_destroy, \
+        constbuffer_array_batcher_nv_view_get_payload_count, \
+        constbuffer_array_batcher_nv_view_get_payload_buffer_count, \
+        constbuffer_array_batcher_nv_view_get_payload_buffer_content, \
+        constbuffer_array_batcher_nv_view_get_payload, \
+        constbuffer_array_batcher_nv_view_get_all_payloads \
 )
 
 
@@ -21,11 +34,27 @@
 
 
 #include "c_util/constbuffer_array.h"
+#include "c_util/constbuffer_array_batcher_nv.h"
 
 
 CONSTBUFFER_ARRAY_HANDLE real_constbuffer_array_batcher_nv_batch(CONSTBUFFER_ARRAY_HANDLE* payloads, uint32_t count);
 CONSTBUFFER_ARRAY_HANDLE* real_constbuffer_array_batcher_nv_unbatch(CONSTBUFFER_ARRAY_HANDLE batch, uint32_t* payload_count);
 
+CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_HANDLE real_constbuffer_array_batcher_nv_builder_create(uint32_t max_payload_count, uint64_t max_batch_size);
+void real_constbuffer_array_batcher_nv_builder_destroy(CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_HANDLE builder);
+CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_RESULT real_constbuffer_array_batcher_nv_builder_append(CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_HANDLE builder, CONSTBUFFER_ARRAY_HANDLE payload);
+int real_constbuffer_array_batcher_nv_builder_can_append(CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_HANDLE builder, CONSTBUFFER_ARRAY_HANDLE payload, bool* fits);
+int real_constbuffer_array_batcher_nv_builder_get_size(CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_HANDLE builder, uint32_t* payload_count, uint64_t* batch_size);
+CONSTBUFFER_ARRAY_HANDLE real_constbuffer_array_batcher_nv_builder_seal(CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_HANDLE builder);
+
+CONSTBUFFER_ARRAY_BATCHER_NV_VIEW_HANDLE real_constbuffer_array_batcher_nv_view_create(CONSTBUFFER_ARRAY_HANDLE batch);
+void real_constbuffer_array_batcher_nv_view_destroy(CONSTBUFFER_ARRAY_BATCHER_NV_VIEW_HANDLE view);
+int real_constbuffer_array_batcher_nv_view_get_payload_count(CONSTBUFFER_ARRAY_BATCHER_NV_VIEW_HANDLE view, uint32_t* payload_count);
+int real_constbuffer_array_batcher_nv_view_get_payload_buffer_count(CONSTBUFFER_ARRAY_BATCHER_NV_VIEW_HANDLE view, uint32_t payload_index, uint32_t* buffer_count);
+const CONSTBUFFER* real_constbuffer_array_batcher_nv_view_get_payload_buffer_content(CONSTBUFFER_ARRAY_BATCHER_NV_VIEW_HANDLE view, uint32_t payload_index, uint32_t buffer_index);
+CONSTBUFFER_ARRAY_HANDLE real_constbuffer_array_batcher_nv_view_get_payload(CONSTBUFFER_ARRAY_BATCHER_NV_VIEW_HANDLE view, uint32_t payload_index);
+CONSTBUFFER_ARRAY_HANDLE* real_constbuffer_array_batcher_nv_view_get_all_payloads(CONSTBUFFER_ARRAY_BATCHER_NV_VIEW_HANDLE view, uint32_t* payload_count);
+
 
 
 
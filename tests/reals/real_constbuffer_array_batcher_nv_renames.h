@@ -3,3 +3,18 @@
 
 #define constbuffer_array_batcher_nv_batch real_constbuffer_array_batcher_nv_batch
 #define constbuffer_array_batcher_nv_unbatch real_constbuffer_array_batcher_nv_unbatch
+#define constbuffer_array_batcher_nv_builder_create real_constbuffer_array_batcher_nv_builder_create
+#define constbuffer_array_batcher_nv_builder_destroy real_constbuffer_array_batcher_nv_builder_destroy
+#define constbuffer_array_batcher_nv_builder_append real_constbuffer_array_batcher_nv_builder_append
+#define constbuffer_array_batcher_nv_builder_can_append real_constbuffer_array_batcher_nv_builder_can_append
+#define constbuffer_array_batcher_nv_builder_get_size real_constbuffer_array_batcher_nv_builder_get_size
+#define constbuffer_array_batcher_nv_builder_seal real_constbuffer_array_batcher_nv_builder_seal
+#define constbuffer_array_batcher_nv_view_create real_constbuffer_array_batcher_nv_view_create
+#define constbuffer_array_batcher_nv_view_destroy real_constbuffer_array_batcher_nv_view_destroy
+#define constbuffer_array_batcher_nv_view_get_payload_count real_constbuffer_array_batcher_nv_view_get_payload_count
+#define constbuffer_array_batcher_nv_view_get_payload_buffer_count real_constbuffer_array_batcher_nv_view_get_payload_buffer_count
+#define constbuffer_array_batcher_nv_view_get_payload_buffer_content real_constbuffer_array_batcher_nv_view_get_payload_buffer_content
+#define constbuffer_array_batcher_nv_view_get_payload real_constbuffer_array_batcher_nv_view_get_payload
+#define constbuffer_array_batcher_nv_view_get_all_payloads real_constbuffer_array_batcher_nv_view_get_all_payloads
+
+#define CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_RESULT real_CONSTBUFFER_ARRAY_BATCHER_NV_BUILDER_APPEND_RESULT
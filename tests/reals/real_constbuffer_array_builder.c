@@ -0,0 +1,10 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "real_gballoc_hl_renames.h" // IWYU pragma: keep
+#include "real_constbuffer_array_renames.h" // IWYU pragma: keep
+#include "real_constbuffer_renames.h" // IWYU pragma: keep
+
+#include "real_constbuffer_array_builder_renames.h" // IWYU pragma: keep
+
+#include "../../src/constbuffer_array_builder.c"
@@ -0,0 +1,34 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef REAL_CONSTBUFFER_ARRAY_BUILDER_H
+#define REAL_CONSTBUFFER_ARRAY_BUILDER_H
+
+#include "macro_utils/macro_utils.h"
+
+#define R2(X) REGISTER_GLOBAL_MOCK_HOOK(X, real_##X);
+
+#define REGISTER_CONSTBUFFER_ARRAY_BUILDER_GLOBAL_MOCK_HOOK() \
+    MU_FOR_EACH_1(R2, \
+        constbuffer_array_builder_create, \
+        constbuffer_array_builder_destroy, \
+        constbuffer_array_builder_append, \
+        constbuffer_array_builder_append_move, \
+        constbuffer_array_builder_get_buffer_count, \
+        constbuffer_array_builder_seal \
+)
+
+#include <stdint.h>
+
+#include "c_util/constbuffer.h"
+#include "c_util/constbuffer_array.h"
+#include "c_util/constbuffer_array_builder.h"
+
+CONSTBUFFER_ARRAY_BUILDER_HANDLE real_constbuffer_array_builder_create(uint32_t initial_capacity);
+void real_constbuffer_array_builder_destroy(CONSTBUFFER_ARRAY_BUILDER_HANDLE builder);
+int real_constbuffer_array_builder_append(CONSTBUFFER_ARRAY_BUILDER_HANDLE builder, CONSTBUFFER_HANDLE buffer);
+int real_constbuffer_array_builder_append_move(CONSTBUFFER_ARRAY_BUILDER_HANDLE builder, CONSTBUFFER_HANDLE buffer);
+int real_constbuffer_array_builder_get_buffer_count(CONSTBUFFER_ARRAY_BUILDER_HANDLE builder, uint32_t* buffer_count);
+CONSTBUFFER_ARRAY_HANDLE real_constbuffer_array_builder_seal(CONSTBUFFER_ARRAY_BUILDER_HANDLE builder);
+
+#endif // REAL_CONSTBUFFER_ARRAY_BUILDER_H
@@ -0,0 +1,9 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#define constbuffer_array_builder_create real_constbuffer_array_builder_create
+#define constbuffer_array_builder_destroy real_constbuffer_array_builder_destroy
+#define constbuffer_array_builder_append real_constbuffer_array_builder_append
+#define constbuffer_array_builder_append_move real_constbuffer_array_builder_append_move
+#define constbuffer_array_builder_get_buffer_count real_constbuffer_array_builder_get_buffer_count
+#define constbuffer_array_builder_seal real_constbuffer_array_builder_seal
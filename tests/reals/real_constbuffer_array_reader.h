@@ -0,0 +1,44 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef REAL_CONSTBUFFER_ARRAY_READER_H
+#define REAL_CONSTBUFFER_ARRAY_READER_H
+
+#include "macro_utils/macro_utils.h"
+
+#define R2(X) REGISTER_GLOBAL_MOCK_HOOK(X, real_##X);
+
+#define REGISTER_CONSTBUFFER_ARRAY_READER_GLOBAL_MOCK_HOOK() \
+    MU_FOR_EACH_1(R2, \
+        constbuffer_array_reader_create, \
+        constbuffer_array_reader_destroy, \
+        constbuffer_array_reader_get_remaining, \
+        constbuffer_array_reader_read_uint8, \
+        constbuffer_array_reader_read_uint16, \
+        constbuffer_array_reader_read_uint32, \
+        constbuffer_array_reader_read_uint64, \
+        constbuffer_array_reader_read_uuid, \
+        constbuffer_array_reader_skip, \
+        constbuffer_array_reader_peek, \
+        constbuffer_array_reader_read_array \
+)
+
+#include <stdint.h>
+
+#include "c_util/constbuffer_array.h"
+#include "c_util/uuid_string.h"
+#include "c_util/constbuffer_array_reader.h"
+
+CONSTBUFFER_ARRAY_READER_HANDLE real_constbuffer_array_reader_create(CONSTBUFFER_ARRAY_HANDLE array);
+void real_constbuffer_array_reader_destroy(CONSTBUFFER_ARRAY_READER_HANDLE reader);
+int real_constbuffer_array_reader_get_remaining(CONSTBUFFER_ARRAY_READER_HANDLE reader, uint64_t* remaining);
+int real_constbuffer_array_reader_read_uint8(CONSTBUFFER_ARRAY_READER_HANDLE reader, uint8_t* value);
+int real_constbuffer_array_reader_read_uint16(CONSTBUFFER_ARRAY_READER_HANDLE reader, uint16_t* value);
+int real_constbuffer_array_reader_read_uint32(CONSTBUFFER_ARRAY_READER_HANDLE reader, uint32_t* value);
+int real_constbuffer_array_reader_read_uint64(CONSTBUFFER_ARRAY_READER_HANDLE reader, uint64_t* value);
+int real_constbuffer_array_reader_read_uuid(CONSTBUFFER_ARRAY_READER_HANDLE reader, UUID_T* value);
+int real_constbuffer_array_reader_skip(CONSTBUFFER_ARRAY_READER_HANDLE reader, uint64_t size);
+int real_constbuffer_array_reader_peek(CONSTBUFFER_ARRAY_READER_HANDLE reader, uint32_t size, unsigned char* destination);
+CONSTBUFFER_ARRAY_HANDLE real_constbuffer_array_reader_read_array(CONSTBUFFER_ARRAY_READER_HANDLE reader, uint64_t size);
+
+#endif // REAL_CONSTBUFFER_ARRAY_READER_H
@@ -0,0 +1,14 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#define constbuffer_array_reader_create real_constbuffer_array_reader_create
+#define constbuffer_array_reader_destroy real_constbuffer_array_reader_destroy
+#define constbuffer_array_reader_get_remaining real_constbuffer_array_reader_get_remaining
+#define constbuffer_array_reader_read_uint8 real_constbuffer_array_reader_read_uint8
+#define constbuffer_array_reader_read_uint16 real_constbuffer_array_reader_read_uint16
+#define constbuffer_array_reader_read_uint32 real_constbuffer_array_reader_read_uint32
+#define constbuffer_array_reader_read_uint64 real_constbuffer_array_reader_read_uint64
+#define constbuffer_array_reader_read_uuid real_constbuffer_array_reader_read_uuid
+#define constbuffer_array_reader_skip real_constbuffer_array_reader_skip
+#define constbuffer_array_reader_peek real_constbuffer_array_reader_peek
+#define constbuffer_array_reader_read_array real_constbuffer_array_reader_read_array
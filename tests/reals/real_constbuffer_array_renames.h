@@ -13,10 +13,26 @@
 #define constbuffer_array_remove_front real_constbuffer_array_remove_front
 #define constbuffer_array_add_back real_constbuffer_array_add_back
 #define constbuffer_array_remove_back real_constbuffer_array_remove_back
+#define constbuffer_array_add_front_shared real_constbuffer_array_add_front_shared
+#define constbuffer_array_remove_front_shared real_constbuffer_array_remove_front_shared
+#define constbuffer_array_add_back_shared real_constbuffer_array_add_back_shared
+#define constbuffer_array_remove_back_shared real_constbuffer_array_remove_back_shared
 #define constbuffer_array_get_buffer_count real_constbuffer_array_get_buffer_count
 #define constbuffer_array_get_buffer real_constbuffer_array_get_buffer
 #define constbuffer_array_get_buffer_content real_constbuffer_array_get_buffer_content
 #define constbuffer_array_get_all_buffers_size real_constbuffer_array_get_all_buffers_size
+#define constbuffer_array_get_all_buffers_size_64 real_constbuffer_array_get_all_buffers_size_64
 #define constbuffer_array_get_const_buffer_handle_array real_constbuffer_array_get_const_buffer_handle_array
 #define constbuffer_array_remove_empty_buffers real_constbuffer_array_remove_empty_buffers
+#define constbuffer_array_create_compressed real_constbuffer_array_create_compressed
+#define constbuffer_array_create_decompressed real_constbuffer_array_create_decompressed
+#define constbuffer_array_copy_to real_constbuffer_array_copy_to
+#define constbuffer_array_flatten real_constbuffer_array_flatten
 #define CONSTBUFFER_ARRAY_HANDLE_contain_same real_CONSTBUFFER_ARRAY_HANDLE_contain_same
+#define constbuffer_array_content_equal real_constbuffer_array_content_equal
+#define constbuffer_array_get_fingerprint real_constbuffer_array_get_fingerprint
+#define constbuffer_array_compute_hash real_constbuffer_array_compute_hash
+#define constbuffer_array_find real_constbuffer_array_find
+#define constbuffer_array_find_byte real_constbuffer_array_find_byte
+
+#define CONSTBUFFER_ARRAY_FIND_RESULT real_CONSTBUFFER_ARRAY_FIND_RESULT
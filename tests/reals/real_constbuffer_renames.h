@@ -10,14 +10,25 @@
 #define CONSTBUFFER_CreateWithCustomFree real_CONSTBUFFER_CreateWithCustomFree
 #define CONSTBUFFER_CreateFromOffsetAndSizeWithCopy real_CONSTBUFFER_CreateFromOffsetAndSizeWithCopy
 #define CONSTBUFFER_IncRef real_CONSTBUFFER_IncRef
+#define CONSTBUFFER_TryIncRef real_CONSTBUFFER_TryIncRef
 #define CONSTBUFFER_GetContent real_CONSTBUFFER_GetContent
 #define CONSTBUFFER_DecRef real_CONSTBUFFER_DecRef
 #define CONSTBUFFER_HANDLE_contain_same real_CONSTBUFFER_HANDLE_contain_same
+#define CONSTBUFFER_GetFingerprint real_CONSTBUFFER_GetFingerprint
 #define CONSTBUFFER_CreateFromOffsetAndSize real_CONSTBUFFER_CreateFromOffsetAndSize
+#define CONSTBUFFER_CreateFromMappedFile real_CONSTBUFFER_CreateFromMappedFile
 #define CONSTBUFFER_get_serialization_size real_CONSTBUFFER_get_serialization_size
 #define CONSTBUFFER_to_buffer real_CONSTBUFFER_to_buffer
 #define CONSTBUFFER_to_fixed_size_buffer real_CONSTBUFFER_to_fixed_size_buffer
+#define CONSTBUFFER_get_serialization_size_v2 real_CONSTBUFFER_get_serialization_size_v2
+#define CONSTBUFFER_to_buffer_v2 real_CONSTBUFFER_to_buffer_v2
+#define CONSTBUFFER_to_fixed_size_buffer_v2 real_CONSTBUFFER_to_fixed_size_buffer_v2
 #define CONSTBUFFER_from_buffer real_CONSTBUFFER_from_buffer
+#define CONSTBUFFER_from_buffer_view real_CONSTBUFFER_from_buffer_view
+#define CONSTBUFFER_from_buffer_view_bulk real_CONSTBUFFER_from_buffer_view_bulk
+#define CONSTBUFFER_CreateCompressed real_CONSTBUFFER_CreateCompressed
+#define CONSTBUFFER_Decompress real_CONSTBUFFER_Decompress
+#define CONSTBUFFER_CreateSharedHot real_CONSTBUFFER_CreateSharedHot
 
 #define CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT real_CONSTBUFFER_TO_FIXED_SIZE_BUFFER_RESULT
 #define CONSTBUFFER_FROM_BUFFER_RESULT real_CONSTBUFFER_FROM_BUFFER_RESULT
@@ -29,4 +40,10 @@
 #define CONSTBUFFER_WritableHandleDecRef real_CONSTBUFFER_WritableHandleDecRef
 #define CONSTBUFFER_GetWritableBufferSize real_CONSTBUFFER_GetWritableBufferSize
 
+#define CONSTBUFFER_POOL_Create real_CONSTBUFFER_POOL_Create
+#define CONSTBUFFER_POOL_Destroy real_CONSTBUFFER_POOL_Destroy
+#define CONSTBUFFER_POOL_CreateWritableHandle real_CONSTBUFFER_POOL_CreateWritableHandle
+#define CONSTBUFFER_POOL_GetStatistics real_CONSTBUFFER_POOL_GetStatistics
+#define CONSTBUFFER_POOL_Trim real_CONSTBUFFER_POOL_Trim
+
 #endif // REAL_CONSTBUFFER_RENAMES_H
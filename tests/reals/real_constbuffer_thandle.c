@@ -4,6 +4,7 @@
 #include "real_gballoc_hl_renames.h" // IWYU pragma: keep
 #include "real_interlocked_renames.h" // IWYU pragma: keep
 #include "real_memory_data_renames.h" // IWYU pragma: keep
+#include "real_memory_mapped_file_renames.h" // IWYU pragma: keep
 
 #include "real_constbuffer_thandle_renames.h" // IWYU pragma: keep
 
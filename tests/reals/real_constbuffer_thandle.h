@@ -20,12 +20,14 @@
         CONSTBUFFER_THANDLE_CreateWithCustomFree, \
         CONSTBUFFER_THANDLE_CreateFromOffsetAndSize, \
         CONSTBUFFER_THANDLE_CreateFromOffsetAndSizeWithCopy, \
+        CONSTBUFFER_THANDLE_CreateFromMappedFile, \
         CONSTBUFFER_THANDLE_GetContent, \
         CONSTBUFFER_THANDLE_contain_same, \
         CONSTBUFFER_THANDLE_get_serialization_size, \
         CONSTBUFFER_THANDLE_to_buffer, \
         CONSTBUFFER_THANDLE_to_fixed_size_buffer, \
         CONSTBUFFER_THANDLE_from_buffer, \
+        CONSTBUFFER_THANDLE_from_buffer_view, \
         CONSTBUFFER_THANDLE_CreateWritableHandle, \
         CONSTBUFFER_THANDLE_GetWritableBuffer, \
         CONSTBUFFER_THANDLE_SealWritableHandle, \
@@ -46,6 +48,8 @@ THANDLE(CONSTBUFFER) real_CONSTBUFFER_THANDLE_CreateFromOffsetAndSize(THANDLE(CO
 
 THANDLE(CONSTBUFFER) real_CONSTBUFFER_THANDLE_CreateFromOffsetAndSizeWithCopy(THANDLE(CONSTBUFFER) handle, uint32_t offset, uint32_t size);
 
+THANDLE(CONSTBUFFER) real_CONSTBUFFER_THANDLE_CreateFromMappedFile(const char* file_name, uint64_t offset, uint32_t size, MEMORY_MAPPED_FILE_ACCESS_HINT hint);
+
 const CONSTBUFFER_CONTENT* real_CONSTBUFFER_THANDLE_GetContent(THANDLE(CONSTBUFFER) constbufferHandle);
 
 bool real_CONSTBUFFER_THANDLE_contain_same(THANDLE(CONSTBUFFER) left, THANDLE(CONSTBUFFER) right);
@@ -58,6 +62,8 @@ CONSTBUFFER_THANDLE_TO_FIXED_SIZE_BUFFER_RESULT real_CONSTBUFFER_THANDLE_to_fixe
 
 CONSTBUFFER_THANDLE_FROM_BUFFER_RESULT real_CONSTBUFFER_THANDLE_from_buffer(const unsigned char* source, uint32_t size, uint32_t* consumed, THANDLE(CONSTBUFFER)* destination);
 
+CONSTBUFFER_THANDLE_FROM_BUFFER_RESULT real_CONSTBUFFER_THANDLE_from_buffer_view(THANDLE(CONSTBUFFER) source, uint32_t offset, uint32_t* consumed, THANDLE(CONSTBUFFER)* destination);
+
 THANDLE(CONSTBUFFER_THANDLE_WRITABLE_HANDLE_DATA) real_CONSTBUFFER_THANDLE_CreateWritableHandle(uint32_t size);
 
 unsigned char* real_CONSTBUFFER_THANDLE_GetWritableBuffer(THANDLE(CONSTBUFFER_THANDLE_WRITABLE_HANDLE_DATA) constbufferWritableHandle);
@@ -10,12 +10,14 @@
 #define CONSTBUFFER_THANDLE_CreateWithCustomFree real_CONSTBUFFER_THANDLE_CreateWithCustomFree
 #define CONSTBUFFER_THANDLE_CreateFromOffsetAndSize real_CONSTBUFFER_THANDLE_CreateFromOffsetAndSize
 #define CONSTBUFFER_THANDLE_CreateFromOffsetAndSizeWithCopy real_CONSTBUFFER_THANDLE_CreateFromOffsetAndSizeWithCopy
+#define CONSTBUFFER_THANDLE_CreateFromMappedFile real_CONSTBUFFER_THANDLE_CreateFromMappedFile
 #define CONSTBUFFER_THANDLE_GetContent real_CONSTBUFFER_THANDLE_GetContent
 #define CONSTBUFFER_THANDLE_contain_same real_CONSTBUFFER_THANDLE_contain_same
 #define CONSTBUFFER_THANDLE_get_serialization_size real_CONSTBUFFER_THANDLE_get_serialization_size
 #define CONSTBUFFER_THANDLE_to_buffer real_CONSTBUFFER_THANDLE_to_buffer
 #define CONSTBUFFER_THANDLE_to_fixed_size_buffer real_CONSTBUFFER_THANDLE_to_fixed_size_buffer
 #define CONSTBUFFER_THANDLE_from_buffer real_CONSTBUFFER_THANDLE_from_buffer
+#define CONSTBUFFER_THANDLE_from_buffer_view real_CONSTBUFFER_THANDLE_from_buffer_view
 
 #define CONSTBUFFER_THANDLE_TO_FIXED_SIZE_BUFFER_RESULT real_CONSTBUFFER_THANDLE_TO_FIXED_SIZE_BUFFER_RESULT
 #define CONSTBUFFER_THANDLE_FROM_BUFFER_RESULT real_CONSTBUFFER_THANDLE_FROM_BUFFER_RESULT
@@ -0,0 +1,8 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "real_interlocked_renames.h" // IWYU pragma: keep
+
+#include "real_crc32c_renames.h" // IWYU pragma: keep
+
+#include "../../src/crc32c.c"
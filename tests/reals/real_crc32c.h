@@ -0,0 +1,24 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef REAL_CRC32C_H
+#define REAL_CRC32C_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "macro_utils/macro_utils.h"
+
+#define R2(X) REGISTER_GLOBAL_MOCK_HOOK(X, real_##X);
+
+#define REGISTER_CRC32C_GLOBAL_MOCK_HOOK() \
+    MU_FOR_EACH_1(R2, \
+        crc32c_compute, \
+        crc32c_copy \
+    )
+
+uint32_t real_crc32c_compute(uint32_t crc, const void* buffer, size_t size);
+
+uint32_t real_crc32c_copy(uint32_t crc, void* destination, const void* source, size_t size);
+
+#endif //REAL_CRC32C_H
@@ -0,0 +1,10 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef REAL_CRC32C_RENAMES_H
+#define REAL_CRC32C_RENAMES_H
+
+#define crc32c_compute real_crc32c_compute
+#define crc32c_copy real_crc32c_copy
+
+#endif // REAL_CRC32C_RENAMES_H
@@ -11,7 +11,13 @@
 
 #define REGISTER_HASH_GLOBAL_MOCK_HOOK() \
     MU_FOR_EACH_1(R2, \
-        hash_compute_hash \
+        hash_compute_hash, \
+        hash_compute_hash_batch, \
+        hash_compute_hash_64, \
+        hash_compute_hash_seeded, \
+        hash_init, \
+        hash_update, \
+        hash_final \
     )
 
 #ifdef __cplusplus
@@ -19,6 +25,13 @@ extern "C" {
 #endif
 
 int real_hash_compute_hash(const void* buffer, size_t length, uint32_t* hash);
+int real_hash_compute_hash_batch(const void* const* keys, const size_t* lengths, size_t count, uint32_t* hashes);
+int real_hash_compute_hash_64(const void* buffer, size_t length, uint64_t* hash);
+int real_hash_compute_hash_seeded(const void* buffer, size_t length, uint64_t seed, uint64_t* hash);
+
+int real_hash_init(HASH_STATE* state, uint64_t seed);
+int real_hash_update(HASH_STATE* state, const void* buffer, size_t length);
+int real_hash_final(const HASH_STATE* state, uint64_t* hash);
 
 #ifdef __cplusplus
 }
@@ -2,3 +2,9 @@
 // Licensed under the MIT license. See LICENSE file in the project root for full license information.
 
 #define hash_compute_hash real_hash_compute_hash
+#define hash_compute_hash_batch real_hash_compute_hash_batch
+#define hash_compute_hash_64 real_hash_compute_hash_64
+#define hash_compute_hash_seeded real_hash_compute_hash_seeded
+#define hash_init real_hash_init
+#define hash_update real_hash_update
+#define hash_final real_hash_final
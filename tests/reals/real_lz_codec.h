@@ -0,0 +1,26 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef REAL_LZ_CODEC_H
+#define REAL_LZ_CODEC_H
+
+#include <stdint.h>
+
+#include "macro_utils/macro_utils.h"
+
+#define R2(X) REGISTER_GLOBAL_MOCK_HOOK(X, real_##X);
+
+#define REGISTER_LZ_CODEC_GLOBAL_MOCK_HOOK() \
+    MU_FOR_EACH_1(R2, \
+        lz_codec_compress_bound, \
+        lz_codec_compress, \
+        lz_codec_decompress \
+    )
+
+uint32_t real_lz_codec_compress_bound(uint32_t source_size);
+
+int real_lz_codec_compress(const unsigned char* source, uint32_t source_size, unsigned char* destination, uint32_t destination_size, uint32_t* compressed_size);
+
+int real_lz_codec_decompress(const unsigned char* source, uint32_t source_size, unsigned char* destination, uint32_t destination_size);
+
+#endif //REAL_LZ_CODEC_H
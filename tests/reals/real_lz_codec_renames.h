@@ -0,0 +1,11 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef REAL_LZ_CODEC_RENAMES_H
+#define REAL_LZ_CODEC_RENAMES_H
+
+#define lz_codec_compress_bound real_lz_codec_compress_bound
+#define lz_codec_compress real_lz_codec_compress
+#define lz_codec_decompress real_lz_codec_decompress
+
+#endif // REAL_LZ_CODEC_RENAMES_H
@@ -0,0 +1,10 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "real_memory_mapped_file_renames.h" // IWYU pragma: keep
+
+#ifdef WIN32
+#include "../../src/memory_mapped_file_win32.c"
+#else
+#include "../../src/memory_mapped_file_linux.c"
+#endif
@@ -0,0 +1,25 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef REAL_MEMORY_MAPPED_FILE_H
+#define REAL_MEMORY_MAPPED_FILE_H
+
+#include <stdint.h>
+
+#include "macro_utils/macro_utils.h"
+
+#define R2(X) REGISTER_GLOBAL_MOCK_HOOK(X, real_##X);
+
+#define REGISTER_MEMORY_MAPPED_FILE_GLOBAL_MOCK_HOOK() \
+    MU_FOR_EACH_1(R2, \
+        memory_mapped_file_map, \
+        memory_mapped_file_unmap \
+    )
+
+#include "c_util/memory_mapped_file.h"
+
+int real_memory_mapped_file_map(const char* file_name, uint64_t offset, uint32_t size, MEMORY_MAPPED_FILE_ACCESS_HINT hint, MEMORY_MAPPED_FILE_VIEW* view);
+
+void real_memory_mapped_file_unmap(MEMORY_MAPPED_FILE_VIEW* view);
+
+#endif //REAL_MEMORY_MAPPED_FILE_H
@@ -0,0 +1,12 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef REAL_MEMORY_MAPPED_FILE_RENAMES_H
+#define REAL_MEMORY_MAPPED_FILE_RENAMES_H
+
+#define memory_mapped_file_map real_memory_mapped_file_map
+#define memory_mapped_file_unmap real_memory_mapped_file_unmap
+
+#define MEMORY_MAPPED_FILE_ACCESS_HINT real_MEMORY_MAPPED_FILE_ACCESS_HINT
+
+#endif // REAL_MEMORY_MAPPED_FILE_RENAMES_H
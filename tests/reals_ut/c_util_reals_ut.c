@@ -19,16 +19,19 @@ TEST_FUNCTION(check_all_c_util_reals) // no-srs
     REGISTER_CONSTBUFFER_ARRAY_GLOBAL_MOCK_HOOK();
     REGISTER_CONSTBUFFER_ARRAY_SYNC_WRAPPER_GLOBAL_MOCK_HOOK();
     REGISTER_CONSTBUFFER_ARRAY_BATCHER_GLOBAL_MOCK_HOOK();
+    REGISTER_CRC32C_GLOBAL_MOCK_HOOK();
     REGISTER_CRITICAL_SECTION_GLOBAL_MOCK_HOOKS();
     REGISTER_DOUBLYLINKEDLIST_GLOBAL_MOCK_HOOKS();
     REGISTER_EXTERNAL_COMMAND_HELPER_GLOBAL_MOCK_HOOKS();
     REGISTER_MEMORY_DATA_GLOBAL_MOCK_HOOK();
+    REGISTER_MEMORY_MAPPED_FILE_GLOBAL_MOCK_HOOK();
     REGISTER_RC_PTR_GLOBAL_MOCK_HOOKS();
     REGISTER_RC_STRING_GLOBAL_MOCK_HOOKS();
     REGISTER_RC_STRING_UTILS_GLOBAL_MOCK_HOOKS();
     REGISTER_SINGLYLINKEDLIST_GLOBAL_MOCK_HOOKS();
     REGISTER_UUID_STRING_GLOBAL_MOCK_HOOK();
     REGISTER_HASH_GLOBAL_MOCK_HOOK();
+    REGISTER_LZ_CODEC_GLOBAL_MOCK_HOOK();
     REGISTER_TCALL_DISPATCHER_CANCELLATION_TOKEN_CANCEL_CALL_GLOBAL_MOCK_HOOK();
     REGISTER_CANCELLATION_TOKEN_GLOBAL_MOCK_HOOKS();
 
@@ -18,11 +18,14 @@
 #include "../reals/real_constbuffer_array.h"
 #include "../reals/real_constbuffer_array_sync_wrapper.h"
 #include "../reals/real_constbuffer_array_batcher_nv.h"
+#include "../reals/real_crc32c.h"
 #include "../reals/real_critical_section.h"
 #include "../reals/real_doublylinkedlist.h"
 #include "../reals/real_external_command_helper.h"
 #include "../reals/real_hash.h"
+#include "../reals/real_lz_codec.h"
 #include "../reals/real_memory_data.h"
+#include "../reals/real_memory_mapped_file.h"
 #include "../reals/real_rc_ptr.h"
 #include "../reals/real_rc_string.h"
 #include "../reals/real_rc_string_array.h"
@@ -38,11 +41,14 @@
 #include "c_util/constbuffer_array.h"
 #include "c_util/constbuffer_array_sync_wrapper.h"
 #include "c_util/constbuffer_array_batcher_nv.h"
+#include "c_util/crc32c.h"
 #include "c_util/critical_section.h"
 #include "c_util/doublylinkedlist.h"
 #include "c_util/external_command_helper.h"
 #include "c_util/hash.h"
+#include "c_util/lz_codec.h"
 #include "c_util/memory_data.h"
+#include "c_util/memory_mapped_file.h"
 #include "c_util/rc_ptr.h"
 #include "c_util/rc_string.h"
 #include "c_util/rc_string_array.h"